@@ -28,15 +28,31 @@ typedef struct _MessagesCounter {
     uint32_t sentMessages;
     uint32_t smallMessages;
     uint32_t failedMessages;
+    uint32_t sentBytes;
+    uint32_t billedBytes;   // the sent bytes rounded up to the billing unit of each message
+    uint32_t reconnectAttempts;
+    uint32_t disconnectedTime;  // in milliseconds, counted once the connection is back
 
 } MessageCounter;
 
+/**
+ * A struct which represents the number of items evicted from the queues, per priority
+ **/
+typedef struct _EvictionCounter {
+
+    uint32_t lowPriority;
+    uint32_t aggregated;
+    uint32_t highPriority;
+
+} EvictionCounter;
+
 /**
  * A union which represents a counter
  **/
 typedef union _Counter {
     MessageCounter messageCounter;
     QueueCounter queueCounter;
+    EvictionCounter evictionCounter;
 } Counter;
 
 /**
@@ -8,6 +8,8 @@
 #include "macro_utils.h"
 
 #include "agent_telemetry_counters.h"
+#include "collectors/collector_execution.h"
+#include "tracked_allocator.h"
 
 /**
  * All the result types of the agent telemetry provider functions
@@ -25,16 +27,25 @@ typedef enum _AgentQueueMeter {
     LOW_PRIORITY
 } AgentQueueMeter;
 
+/**
+ * The memory charged to the memory limit, per subsystem
+ */
+typedef struct _MemoryConsumption {
+    uint32_t queues;
+    uint32_t subsystems[ALLOCATION_TAG_COUNT];
+} MemoryConsumption;
+
 /**
  * @brief initialize the agent telemetry provider.
  * 
  * @param lowPriorityQueueCounter   the counter for low priority queue
  * @param highPriorityQueueCounter  the counter for high priority queue
  * @param iotHubCounter             the counter for iot hub sent messages
+ * @param evictionCounter           the counter for items evicted from the queues
  * 
  * @return TELEMETRY_PROVIDER_OK on success, TELEMETRY_PROVIDER_EXCEPTION otherwise.
  */
-MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_Init, SyncedCounter*, lowPriorityQueueCounter, SyncedCounter*, highPriorityQueueCounter, SyncedCounter*, iotHubCounter);
+MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_Init, SyncedCounter*, lowPriorityQueueCounter, SyncedCounter*, highPriorityQueueCounter, SyncedCounter*, iotHubCounter, SyncedCounter*, evictionCounter);
 
 /**
  * @brief deinitialize the agent telemetry provider.
@@ -60,5 +71,32 @@ MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetQueu
  */
 MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetMessageCounterData, MessageCounter*, counterData);
 
+/**
+ * @brief returns the number of items evicted from the queues per priority
+ * 
+ * @param   counterData         Out param, the eviction counter data
+ * 
+ * @return TELEMETRY_PROVIDER_OK on success, TELEMETRY_PROVIDER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetEvictionCounterData, EvictionCounter*, counterData);
+
+/**
+ * @brief returns the memory currently charged to the memory limit, broken down by subsystem
+ * 
+ * @param   consumption         Out param, the memory consumption
+ * 
+ * @return TELEMETRY_PROVIDER_OK on success, TELEMETRY_PROVIDER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetMemoryConsumption, MemoryConsumption*, consumption);
+
+/**
+ * @brief returns the execution statistics of the collectors since they were last read, and resets them
+ * 
+ * @param   statistics          Out param, the statistics of each collector, an array of COLLECTOR_COUNT entries indexed by the collector id
+ * 
+ * @return TELEMETRY_PROVIDER_OK on success, TELEMETRY_PROVIDER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetCollectorStatistics, CollectorStatistics*, statistics);
+
 
 #endif // AGENT_TELEMETRY_PROVIDER_H
\ No newline at end of file
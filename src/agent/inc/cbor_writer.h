@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CBOR_WRITER_H
+#define CBOR_WRITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "json/json_defs.h"
+
+// most single events fit in the inline buffer, so encoding them does not allocate until the output is handed over
+#define CBOR_WRITER_INLINE_SIZE 512
+
+/**
+ * A writer of CBOR (RFC 7049) data items, which encodes them directly into a byte buffer.
+ */
+typedef struct _CborWriter {
+
+    uint8_t inlineData[CBOR_WRITER_INLINE_SIZE];
+    uint8_t* heapData;      // used once the encoded data outgrows the inline buffer
+    uint32_t size;
+    uint32_t capacity;
+    bool failed;
+
+} CborWriter;
+
+/**
+ * @brief Initiates an empty writer.
+ *
+ * @param   writer      The writer to initiate.
+ */
+MOCKABLE_FUNCTION(, void, CborWriter_Init, CborWriter*, writer);
+
+/**
+ * @brief Deinitiates the writer.
+ *
+ * @param   writer      The writer to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, CborWriter_Deinit, CborWriter*, writer);
+
+/**
+ * @brief Writes the header of a map of the given number of pairs, each pair is written as a key followed by its value.
+ *
+ * @param   writer      The writer.
+ * @param   count       The number of pairs in the map.
+ *
+ * @return true on success, false otherwise. A failed writer stays failed.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteMapHeader, CborWriter*, writer, uint32_t, count);
+
+/**
+ * @brief Writes the header of an array of the given number of items.
+ *
+ * @param   writer      The writer.
+ * @param   count       The number of items in the array.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteArrayHeader, CborWriter*, writer, uint32_t, count);
+
+/**
+ * @brief Opens an array of unknown length, CborWriter_WriteBreak closes it.
+ *
+ * @param   writer      The writer.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_BeginIndefiniteArray, CborWriter*, writer);
+
+/**
+ * @brief Closes the innermost item of unknown length.
+ *
+ * @param   writer      The writer.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteBreak, CborWriter*, writer);
+
+/**
+ * @brief Writes a text string.
+ *
+ * @param   writer      The writer.
+ * @param   value       The null terminated utf8 string.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteString, CborWriter*, writer, const char*, value);
+
+/**
+ * @brief Writes an integer in its shortest form.
+ *
+ * @param   writer      The writer.
+ * @param   value       The value.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteInt, CborWriter*, writer, int64_t, value);
+
+/**
+ * @brief Writes a number in its shortest exact form, integral numbers are written as integers.
+ *
+ * @param   writer      The writer.
+ * @param   value       The value.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteDouble, CborWriter*, writer, double, value);
+
+/**
+ * @brief Writes a boolean.
+ *
+ * @param   writer      The writer.
+ * @param   value       The value.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteBool, CborWriter*, writer, bool, value);
+
+/**
+ * @brief Writes a null.
+ *
+ * @param   writer      The writer.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_WriteNull, CborWriter*, writer);
+
+/**
+ * @brief Copies the encoded data into a buffer of its exact size.
+ *
+ * @param   writer      The writer.
+ * @param   allocate    The allocation function of the output.
+ * @param   output      Out param. The encoded data, the caller is responsible to free it with the matching free function.
+ * @param   size        Out param. The size of the encoded data.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CborWriter_Finish, CborWriter*, writer, JsonBufferAllocateFunc, allocate, char**, output, uint32_t*, size);
+
+#endif //CBOR_WRITER_H
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef COLLECTOR_EXECUTION_H
+#define COLLECTOR_EXECUTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "collectors/collector.h"
+#include "macro_utils.h"
+#include "synchronized_queue.h"
+#include "umock_c_prod.h"
+
+/**
+ * The collectors which run under a time budget.
+ */
+typedef enum _CollectorId {
+
+    COLLECTOR_AGENT_TELEMETRY,
+    COLLECTOR_LOCAL_USERS,
+    COLLECTOR_SYSTEM_INFORMATION,
+    COLLECTOR_LISTENING_PORTS,
+    COLLECTOR_FIREWALL,
+    COLLECTOR_BASELINE,
+    COLLECTOR_AGENT_CONFIGURATION_ERROR,
+    COLLECTOR_PROCESS_CREATION,
+    COLLECTOR_USER_LOGIN,
+    COLLECTOR_CONNECTION_CREATE,
+    COLLECTOR_DIAGNOSTIC,
+    COLLECTOR_COUNT
+
+} CollectorId;
+
+/**
+ * The execution statistics of a single collector since they were last read.
+ */
+typedef struct _CollectorStatistics {
+
+    uint32_t runs;
+    // runs which did not finish within their budget
+    uint32_t overruns;
+    // runs which were skipped since the previous run did not finish
+    uint32_t skipped;
+    // in milliseconds
+    uint64_t totalDuration;
+    uint32_t maxDuration;
+
+} CollectorStatistics;
+
+/**
+ * @brief Returns the name of the collector, which is also its key in the configuration.
+ *
+ * @param   id  The collector.
+ *
+ * @return the name of the collector.
+ */
+MOCKABLE_FUNCTION(, const char*, CollectorExecution_GetName, CollectorId, id);
+
+/**
+ * @brief Runs the collector on the calling thread under the given budget.
+ *        A collector which runs past its budget is canceled, the long loops of the collectors stop once they see the cancellation.
+ *
+ * @param   id                  The collector.
+ * @param   collectFunction     The collection function of the collector.
+ * @param   queue               The queue to pass to the collection function.
+ * @param   budget              The budget of the run in milliseconds, 0 for no budget.
+ *
+ * @return the result of the collection function.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, CollectorExecution_Run, CollectorId, id, EventCollectorFunc, collectFunction, SyncQueue*, queue, uint32_t, budget);
+
+/**
+ * @brief Returns whether the collector which runs on the calling thread was canceled. Long loops of the collectors call it between iterations.
+ *
+ * @return true if the collector of the calling thread was canceled or ran out of its budget, false otherwise or if no collector runs on the calling thread.
+ */
+MOCKABLE_FUNCTION(, bool, CollectorExecution_IsCanceled);
+
+/**
+ * @brief Returns the collector which runs on the calling thread.
+ *
+ * @param   id  Out param. The collector of the calling thread.
+ *
+ * @return true if a collector runs on the calling thread, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, CollectorExecution_GetCurrent, CollectorId*, id);
+
+/**
+ * @brief Cancels every running collector which is past its budget and reports it as an overrun, so a collector which is stuck is reported while it is stuck.
+ */
+MOCKABLE_FUNCTION(, void, CollectorExecution_Watchdog);
+
+/**
+ * @brief Reports a run of the collector which was skipped.
+ *
+ * @param   id  The collector.
+ */
+MOCKABLE_FUNCTION(, void, CollectorExecution_ReportSkipped, CollectorId, id);
+
+/**
+ * @brief Returns the statistics of the collector and resets them.
+ *
+ * @param   id              The collector.
+ * @param   statistics      Out param. The statistics of the collector since they were last read.
+ */
+MOCKABLE_FUNCTION(, void, CollectorExecution_GetStatistics, CollectorId, id, CollectorStatistics*, statistics);
+
+#endif //COLLECTOR_EXECUTION_H
@@ -5,6 +5,7 @@
 #define GENERIC_EVENT_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
 #include "macro_utils.h"
@@ -59,4 +60,28 @@ MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_AddMetadataWithTimes, Jso
  */
 MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_AddPayload, JsonObjectWriterHandle, eventWriter, JsonArrayWriterHandle, payloadWriter);
 
+/**
+ * @brief Encodes the event with the event encoding of the agent (see event_encoder.h).
+ * 
+ * @param   eventWriter             A handle to the writer of the event object.
+ * @param   output                  Out param. The encoded event, the caller is responsible to free it.
+ * @param   size                    Out param. The size of the encoded event.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_Serialize, JsonObjectWriterHandle, eventWriter, char**, output, uint32_t*, size);
+
+/**
+ * @brief Encodes the event with the event encoding of the agent into a buffer of the given allocator.
+ * 
+ * @param   eventWriter             A handle to the writer of the event object.
+ * @param   allocate                The allocation function of the output.
+ * @param   release                 The free function of the output.
+ * @param   output                  Out param. The encoded event, the caller is responsible to free it with the release function.
+ * @param   size                    Out param. The size of the encoded event.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_SerializeWithAllocator, JsonObjectWriterHandle, eventWriter, JsonBufferAllocateFunc, allocate, JsonBufferFreeFunc, release, char**, output, uint32_t*, size);
+
 #endif //GENERIC_EVENT_H
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SNAPSHOT_EVENT_H
+#define SNAPSHOT_EVENT_H
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "collectors/generic_event.h"
+#include "json/json_array_writer.h"
+#include "json/json_object_writer.h"
+#include "synchronized_queue.h"
+
+/**
+ * @brief Adds the payload to a snapshot event, encodes it and pushes it to the queue.
+ *        A snapshot which does not fit in a single message is split into continuation events instead, each of
+ *        them sized to fit in a message of the current max message size. A part holds a run of the payload items,
+ *        in order, and the metadata of the event with a fresh id. The parts share a snapshot id, and carry their
+ *        index and the number of parts, so the snapshot can be reassembled.
+ *        A single item which does not fit in a message is sent in a part of its own.
+ *
+ * @param   queue           The queue to push the events to.
+ * @param   eventWriter     A handle to the writer of the event, with the metadata of the event.
+ * @param   payloadWriter   A handle to the writer of the payload array.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise. On failure the parts which were
+ *         already pushed are left in the queue.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, SnapshotEvent_PushBack, SyncQueue*, queue, JsonObjectWriterHandle, eventWriter, JsonArrayWriterHandle, payloadWriter);
+
+#endif //SNAPSHOT_EVENT_H
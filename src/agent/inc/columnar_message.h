@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef COLUMNAR_MESSAGE_H
+#define COLUMNAR_MESSAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * @brief Transcodes a json security message into the columnar layout. The events are grouped by their
+ *        category, type, name and payload schema version, so the metadata of a group is written once, and the
+ *        rest of the event is written column-wise:
+ *          - the ids, in order.
+ *          - the utc timestamps as a base time followed by the delta in seconds from the previous event.
+ *          - the local timestamps as their offset from the utc timestamps, a single offset if it never changes.
+ *          - the number of payload items of each event, the items of all the events of a group are one table.
+ *          - the payload fields, a column per field. A field which is missing from an item is null.
+ *        A string which repeats in the string columns of the payload is written once, to the string table of
+ *        the message, and is referred to by its index.
+ *
+ * @param   message         The json security message.
+ * @param   output          Out param. The columnar message, the caller is responsible to free it.
+ * @param   outputSize      Out param. The size of the columnar message, without the null terminator.
+ *
+ * @return true on success, false if the message can not be represented in the columnar layout or on failure.
+ */
+MOCKABLE_FUNCTION(, bool, ColumnarMessage_Transcode, const char*, message, char**, output, uint32_t*, outputSize);
+
+#endif //COLUMNAR_MESSAGE_H
@@ -62,6 +62,21 @@ extern const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_PATH;
  */
 extern const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH;
 
+/**
+ * Message compression enabled, the backend must support the compressed messages
+ */
+extern const bool DEFAULT_MESSAGE_COMPRESSION_ENABLED;
+
+/**
+ * Columnar messages enabled, the backend must support the columnar layout
+ */
+extern const bool DEFAULT_COLUMNAR_MESSAGES_ENABLED;
+
+/**
+ * The max number of messages which are sent to the hub and were not confirmed yet
+ */
+extern uint32_t DEFAULT_MAX_IN_FLIGHT_MESSAGES;
+
 /**
  * The scheduler interval
  */
@@ -72,16 +87,138 @@ extern const uint32_t SCHEDULER_INTERVAL;
  */
 extern const uint32_t TWIN_UPDATE_SCHEDULER_INTERVAL;
 
+/**
+ * The longest time the event publisher waits for its next deadline, so configuration changes are picked up
+ */
+extern const uint32_t PUBLISHER_MAX_WAIT_INTERVAL;
+
+/**
+ * The interval the low level module client is driven in, while it is connected it needs to be driven often to keep up with the hub
+ */
+extern const uint32_t IOTHUB_DO_WORK_INTERVAL;
+
+/**
+ * The time before a message which failed is sent again, doubled on each failure of the message
+ */
+extern const uint32_t SEND_RETRY_INITIAL_INTERVAL;
+
+/**
+ * The longest time before a message which failed is sent again
+ */
+extern const uint32_t SEND_RETRY_MAX_INTERVAL;
+
+/**
+ * The number of times a message is sent before it is dropped
+ */
+extern const uint32_t SEND_MAX_ATTEMPTS;
+
+/**
+ * The backoff before the first reconnect to the hub, doubled on each failed attempt and jittered
+ */
+extern const uint32_t RECONNECT_INITIAL_INTERVAL;
+
+/**
+ * The longest backoff between two reconnects to the hub
+ */
+extern const uint32_t RECONNECT_MAX_INTERVAL;
+
+/**
+ * The number of threads which run the periodic collectors
+ */
+extern const uint32_t SNAPSHOT_COLLECTOR_WORKERS;
+
+/**
+ * The number of threads which run the triggered collectors, apart from the periodic ones
+ */
+extern const uint32_t TRIGGERED_COLLECTOR_WORKERS;
+
+/**
+ * The time budget in milliseconds of a periodic collector run, unless the collector has a budget of its own
+ */
+extern const uint32_t SNAPSHOT_COLLECTOR_DEFAULT_BUDGET;
+
+/**
+ * The time budget in milliseconds of a triggered collector run, unless the collector has a budget of its own
+ */
+extern const uint32_t TRIGGERED_COLLECTOR_DEFAULT_BUDGET;
+
+/**
+ * The maximal number of events an audit search reads in a single run, the rest is read on the next run
+ */
+extern const uint32_t AUDIT_SEARCH_MAX_EVENTS_PER_RUN;
+
+/**
+ * The time in milliseconds an audit search may spend reading events in a single run, the rest is read on the next run
+ */
+extern const uint32_t AUDIT_SEARCH_MAX_DURATION_PER_RUN;
+
+/**
+ * The socket of the audispd af_unix plugin, the audit stream reads the events from it as they are logged
+ */
+extern const char AUDIT_STREAM_SOCKET_PATH[];
+
+/**
+ * The interval in milliseconds between two attempts to connect to the audit stream
+ */
+extern const uint32_t AUDIT_STREAM_RECONNECT_INTERVAL;
+
+/**
+ * The maximal size in bytes of the events the audit stream buffers for a single collector, the collector searches the logs once it is exceeded
+ */
+extern const uint32_t AUDIT_STREAM_MAX_BUFFER_SIZE;
+
+/**
+ * The active audit log of auditd, its rotated files are next to it
+ */
+extern const char AUDIT_LOG_FILE_PATH[];
+
+/**
+ * The size in bytes of the chunks an audit search reads from the audit log when it resumes from its position in the log
+ */
+extern const uint32_t AUDIT_LOG_CHUNK_SIZE;
+
+/**
+ * The maximal number of rotated audit log files the reader looks for
+ */
+extern const uint32_t AUDIT_LOG_MAX_ROTATED_FILES;
+
 /**
  * The configuration file to load from
  */
 extern const char CONFIGURATION_FILE[];
 
+/**
+ * The capacity of the diagnostic events ring queue
+ */
+extern const uint32_t DIAGNOSTIC_EVENT_QUEUE_CAPACITY;
+
+/**
+ * The share of the max local cache size reserved for the high and low priority event queues, in percents,
+ * the rest of the cache is shared by all the queues
+ */
+extern const uint32_t HIGH_PRIORITY_QUEUE_RESERVED_MEMORY_PERCENT;
+extern const uint32_t LOW_PRIORITY_QUEUE_RESERVED_MEMORY_PERCENT;
+
+/**
+ * The default directory of the queues spill logs
+ */
+extern const char DEFAULT_SPILL_LOG_DIRECTORY[];
+
+/**
+ * The default disk quota in bytes of all the queues spill logs together
+ */
+extern const uint32_t DEFAULT_SPILL_LOG_DISK_QUOTA;
+
 /**
  * message billing multiple as denoted by Azure IoT hub
  */
 extern const uint32_t MESSAGE_BILLING_MULTIPLE;
 
+/**
+ * The size which is kept for the envelope of a security message when a snapshot is split to fit in messages
+ */
+extern const uint32_t MESSAGE_ENVELOPE_RESERVED_SIZE;
+
 /**
  * Protocols name
  */
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef EVENT_ENCODER_H
+#define EVENT_ENCODER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "json/json_defs.h"
+
+/**
+ * The wire encodings of the events and of the security message which carries them.
+ * The encoding is set once at startup, so the queues never hold events of different encodings.
+ */
+typedef enum _EventEncoding {
+
+    EVENT_ENCODING_JSON,
+    EVENT_ENCODING_CBOR
+
+} EventEncoding;
+
+/**
+ * The bytes the serializer frames the already encoded events with.
+ */
+typedef struct _EventFraming {
+
+    const char* separator;      // between two events in the events array
+    uint32_t separatorSize;
+    const char* closing;        // closes the events array and the message
+    uint32_t closingSize;
+
+} EventFraming;
+
+/**
+ * @brief Encodes the given object, usually an event.
+ *
+ * @param   encoding    The encoding to use.
+ * @param   object      The object to encode.
+ * @param   allocate    The allocation function of the output.
+ * @param   release     The free function of the output.
+ * @param   output      Out param. The encoded object, json is null terminated.
+ * @param   size        Out param. The size of the encoded object, without the null terminator.
+ *
+ * @return JSON_WRITER_OK on success, JSON_WRITER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, EventEncoder_EncodeObject, EventEncoding, encoding, JsonObjectWriterHandle, object, JsonBufferAllocateFunc, allocate, JsonBufferFreeFunc, release, char**, output, uint32_t*, size);
+
+/**
+ * @brief Encodes the envelope of a security message, the given string members followed by the opening of the events array.
+ *        The events are appended to it as is, with the framing of the encoding.
+ *
+ * @param   encoding    The encoding to use.
+ * @param   keys        The keys of the envelope members.
+ * @param   values      The values of the envelope members.
+ * @param   count       The number of envelope members.
+ * @param   eventsKey   The key of the events array.
+ * @param   output      Out param. The encoded envelope, the caller is responsible to free it.
+ * @param   size        Out param. The size of the encoded envelope.
+ *
+ * @return JSON_WRITER_OK on success, JSON_WRITER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, EventEncoder_EncodeEnvelope, EventEncoding, encoding, const char**, keys, const char**, values, uint32_t, count, const char*, eventsKey, char**, output, uint32_t*, size);
+
+/**
+ * @brief Checks that the given data is an object of the given encoding, so an event of another encoding is never spliced into a message.
+ *
+ * @param   encoding    The encoding.
+ * @param   data        The encoded event.
+ * @param   size        The size of the encoded event.
+ *
+ * @return true if the data starts an object of the encoding, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EventEncoder_IsObject, EventEncoding, encoding, const void*, data, uint32_t, size);
+
+/**
+ * @brief Returns the framing of the events in a message of the given encoding.
+ *
+ * @param   encoding    The encoding.
+ *
+ * @return the framing.
+ */
+MOCKABLE_FUNCTION(, const EventFraming*, EventEncoder_GetFraming, EventEncoding, encoding);
+
+#endif //EVENT_ENCODER_H
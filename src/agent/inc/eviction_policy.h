@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef EVICTION_POLICY_H
+#define EVICTION_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "agent_telemetry_counters.h"
+#include "macro_utils.h"
+#include "queue.h"
+#include "synchronized_queue.h"
+#include "umock_c_prod.h"
+
+/**
+ * The maximal number of queues a single policy spans
+ */
+#define EVICTION_POLICY_MAX_QUEUES 8
+
+/**
+ * Reclaims memory budget across several queues when it is exhausted.
+ * An item pushed with a given priority evicts the oldest item with the lowest priority held by any of the queues,
+ * first the low priority items, then the aggregated ones and then the high priority ones.
+ * To avoid a deadlock between two pushers, a queue is evicted from only if its own priority is lower than the pushing queue.
+ */
+typedef struct _EvictionPolicy {
+
+    SyncQueue* queues[EVICTION_POLICY_MAX_QUEUES];
+    uint32_t numberOfQueues;
+    SyncedCounter counter;      // the number of evicted items per priority
+
+} EvictionPolicy;
+
+/**
+ * @brief Initiate the policy.
+ *
+ * @param   policy  The instance to initiate.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EvictionPolicy_Init, EvictionPolicy*, policy);
+
+/**
+ * @brief Deinitiate the policy. The queues must not be pushed to once the policy is deinitiated.
+ *
+ * @param   policy  The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, EvictionPolicy_Deinit, EvictionPolicy*, policy);
+
+/**
+ * @brief Adds a list backed queue to the policy and sets the priority of the items pushed to it.
+ *
+ * @param   policy      The policy.
+ * @param   syncQueue   The queue to add.
+ * @param   priority    The priority of the items pushed to the queue with SyncQueue_PushBack.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EvictionPolicy_AddQueue, EvictionPolicy*, policy, SyncQueue*, syncQueue, QueuePriority, priority);
+
+/**
+ * @brief The QueueEvictFunction of the policy, evicts a single item with a lower priority than the given one.
+ *        Other queues are evicted only while they consume the shared memory, an item within the reserved
+ *        budget of a queue frees that budget alone and never makes room for the new item.
+ *
+ * @param   policy      The policy.
+ * @param   queue       The queue the new item is pushed to, its lock is held by the caller.
+ * @param   priority    The priority of the new item.
+ *
+ * @return true if an item was evicted, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EvictionPolicy_Evict, void*, policy, Queue*, queue, QueuePriority, priority);
+
+/**
+ * @brief Returns the counter of the evicted items.
+ *
+ * @param   policy  The policy.
+ *
+ * @return the counter.
+ */
+MOCKABLE_FUNCTION(, SyncedCounter*, EvictionPolicy_GetCounter, EvictionPolicy*, policy);
+
+#endif //EVICTION_POLICY_H
@@ -19,6 +19,17 @@ typedef enum _MemoryMonitorResultValues {
     
 } MemoryMonitorResultValues;
 
+/**
+ * A sub budget of the memory limit. The reservation is a share of the current limit and can only be consumed through the budget,
+ * consumption beyond it is taken from the pool shared by everyone else.
+ */
+typedef struct _MemoryBudget {
+
+    uint32_t reservedPercent;
+    uint64_t usage;         // updated atomically, the consumed bytes and the part of them charged to the shared pool
+
+} MemoryBudget;
+
 /**
  * @brief An internal mermoy monitor which should limit the cache size. This is used in the regular\synced memory monitor.
  */
@@ -48,6 +59,14 @@ MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_Consume, ui
  */
 MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_Release, uint32_t, sizeInBytes);
 
+/**
+ * @brief Consumes the given amount of bytes even if the limit would be exceeded.
+ *        Used for memory which was already allocated and must be accounted for, it leaves less room for the rest.
+ * 
+ * @param   sizeInBytes    The size which was allocated.
+ */
+MOCKABLE_FUNCTION(, void, InternalMemoryMonitor_ForceConsume, uint32_t, sizeInBytes);
+
 /**
  * @brief Returns the current memory consumption.
  * 
@@ -57,4 +76,59 @@ MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_Release, ui
  */
 MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_CurrentConsumption, uint32_t*, sizeInBytes);
 
+/**
+ * @brief Publishes a new memory limit. Memory which is already consumed is not affected, only new consumption is limited.
+ *        The reservations of the budgets follow the new limit.
+ * 
+ * @param   limitInBytes    The new limit.
+ */
+MOCKABLE_FUNCTION(, void, InternalMemoryMonitor_SetLimit, uint32_t, limitInBytes);
+
+/**
+ * @brief Initiate a sub budget and reserve a share of the memory limit for it.
+ *        The reservation is recomputed whenever the limit changes, so the budgets never hold more than the limit.
+ * 
+ * @param   budget                  The budget to initiate.
+ * @param   reservedPercentOfLimit  The share of the limit reserved for the budget, in percents.
+ * 
+ * @return MEMORY_MONITOR_OK on success or MEMORY_MONITOR_MEMORY_EXCEEDED if the reservations would exceed the whole limit.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_InitBudget, MemoryBudget*, budget, uint32_t, reservedPercentOfLimit);
+
+/**
+ * @brief Deinitiate a sub budget and return its reservation to the shared pool. Everything consumed through it must be released first.
+ * 
+ * @param   budget          The budget to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, InternalMemoryMonitor_DeinitBudget, MemoryBudget*, budget);
+
+/**
+ * @brief Consume the given amount of bytes through a sub budget, from its reservation first and then from the shared pool.
+ * 
+ * @param   budget          The budget.
+ * @param   sizeInBytes     The size one wants to allocate.
+ * 
+ * @return MEMORY_MONITOR_OK in case there is enough memory, MEMORY_MONITOR_MEMORY_EXCEEDED otherwise.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_ConsumeFromBudget, MemoryBudget*, budget, uint32_t, sizeInBytes);
+
+/**
+ * @brief Releases the given amount of bytes which were consumed through a sub budget.
+ * 
+ * @param   budget          The budget.
+ * @param   sizeInBytes     The size that is now cleared from the limitation.
+ * 
+ * @return MEMORY_MONITOR_OK in case the size was released or MEMORY_MONITOR_INVALID_RELEASE_SIZE.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_ReleaseToBudget, MemoryBudget*, budget, uint32_t, sizeInBytes);
+
+/**
+ * @brief Checks whether a sub budget consumes more than its reservation, so releasing from it returns memory to the shared pool.
+ * 
+ * @param   budget          The budget.
+ * 
+ * @return true if the budget consumes from the shared pool, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, InternalMemoryMonitor_IsBeyondReservation, MemoryBudget*, budget);
+
 #endif //INTERNAL_MEMORY_MONITOR_H
\ No newline at end of file
@@ -5,6 +5,8 @@
 #define IOTHUB_ADAPTER_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 
 #include "iothub_module_client.h"
 
@@ -12,22 +14,37 @@
 #include "umock_c_prod.h"
 
 #include "agent_telemetry_counters.h"
+#include "reconnect_worker.h"
 #include "synchronized_queue.h"
+#include "transport/transport.h"
 
 typedef struct _IoTHubAdapter {
 
-    IOTHUB_MODULE_CLIENT_HANDLE moduleHandle;
+    const TransportInterface* transport;
+    TRANSPORT_HANDLE transportHandle;
     bool hasTwinConfiguration;
     bool connected;
     IOTHUB_CLIENT_CONNECTION_STATUS_REASON connectionStatusReason;
     bool hubInitiated;
     SyncQueue* twinUpdatesQueue;
     SyncedCounter messageCounter;
+    ReconnectWorker reconnectWorker;
+    // the reconnects start once the first connect succeeded
+    bool reconnectEnabled;
+    time_t disconnectedTime;
 
 } IoTHubAdapter;
 
 /**
- * @brief Initiate a new IoT hub module client
+ * @brief Called once the hub confirms a message, or fails to deliver it.
+ * 
+ * @param   confirmed   Whether the hub received the message.
+ * @param   context     The context which was passed with the message.
+ */
+typedef void (*IoTHubAdapterSendConfirmation)(bool confirmed, void* context);
+
+/**
+ * @brief Initiate a new IoT hub module client, or the low level module client or the local transport if it was configured.
  * 
  * @param   iotHubAdapter       The adapter to initiate.
  * @param   twinUpdatesQueue    The queue which will contain all the twin updates
@@ -52,6 +69,25 @@ MOCKABLE_FUNCTION(, void, IoTHubAdapter_Deinit, IoTHubAdapter*, iotHubAdapter);
  */
 MOCKABLE_FUNCTION(, bool, IoTHubAdapter_Connect, IoTHubAdapter*, iotHubAdapter);
 
+/**
+ * @brief Returns whether the module client is connected to the hub. While it is not, the client is reconnected in the background.
+ * 
+ * @param   iotHubAdapter   The adapter.
+ * 
+ * @return  true if connected, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, IoTHubAdapter_IsConnected, IoTHubAdapter*, iotHubAdapter);
+
+/**
+ * @brief Drives the transport of the adapter if it has no thread of its own, the low level module client.
+ *        The messages which were sent since the last call are delivered, and the callbacks are called on the calling thread.
+ * 
+ * @param   iotHubAdapter   The adapter to drive.
+ * 
+ * @return  the time in milliseconds until the next call is due, UINT32_MAX if the transport does not need it.
+ */
+MOCKABLE_FUNCTION(, uint32_t, IoTHubAdapter_DoWork, IoTHubAdapter*, iotHubAdapter);
+
 /**
  * @brief Send message a-sync to the hub.
  * 
@@ -63,6 +99,36 @@ MOCKABLE_FUNCTION(, bool, IoTHubAdapter_Connect, IoTHubAdapter*, iotHubAdapter);
  */
 MOCKABLE_FUNCTION(, bool, IoTHubAdapter_SendMessageAsync, IoTHubAdapter*, iotHubAdapter, const void*, data, size_t, dataSize);
 
+/**
+ * @brief Send an encoded message a-sync to the hub, the encoding is set as the content type and content encoding of the message.
+ * 
+ * @param   iotHubAdapter   The adapter to send data with.
+ * @param   data            The data to send.
+ * @param   dataSize        The size of the data we want to send.
+ * @param   contentType     The content type of the data, e.g. MESSAGE_CONTENT_TYPE_CBOR. NULL for json.
+ * @param   contentEncoding The content encoding of the data, e.g. MESSAGE_CONTENT_ENCODING_DEFLATE. NULL for plain data.
+ * 
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, IoTHubAdapter_SendEncodedMessageAsync, IoTHubAdapter*, iotHubAdapter, const void*, data, size_t, dataSize, const char*, contentType, const char*, contentEncoding);
+
+/**
+ * @brief Send an encoded message a-sync to the hub, and report its confirmation to the given callback.
+ *        The callback is called exactly once if the message was handed to the hub, possibly on another thread and before this function returns.
+ *        It is not called if the function fails.
+ * 
+ * @param   iotHubAdapter           The adapter to send data with.
+ * @param   data                    The data to send.
+ * @param   dataSize                The size of the data we want to send.
+ * @param   contentType             The content type of the data, e.g. MESSAGE_CONTENT_TYPE_CBOR. NULL for json.
+ * @param   contentEncoding         The content encoding of the data, e.g. MESSAGE_CONTENT_ENCODING_DEFLATE. NULL for plain data.
+ * @param   confirmationCallback    The callback to report the confirmation of the message to.
+ * @param   context                 The context to pass to the callback.
+ * 
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, IoTHubAdapter_SendMessageWithConfirmationAsync, IoTHubAdapter*, iotHubAdapter, const void*, data, size_t, dataSize, const char*, contentType, const char*, contentEncoding, IoTHubAdapterSendConfirmation, confirmationCallback, void*, context);
+
 /**
  * @brief Set reported properties to device twin module/
  * 
@@ -42,7 +42,7 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonArrayWriter_AddObject, JsonArrayWriter
  * @brief Serialize the given array to char*.
  * 
  * @param   writer  The json writer instance.
- * @param   output  Out param. The serialized object.
+ * @param   output  Out param. The serialized object, should be freed with free.
  * @param   size    Out param. The size of the serialized output.
  * 
  * @return JSON_WRITER_OK on success, an indicative error in failure. 
@@ -59,4 +59,16 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonArrayWriter_Serialize, JsonArrayWriter
  */
 MOCKABLE_FUNCTION(, JsonWriterResult, JsonArrayWriter_GetSize, JsonArrayWriterHandle, handle, uint32_t*, numOfelements);
 
+/**
+ * @brief Returns a writer of an item of this array. The item is owned by the array, deinitiating the returned
+ *        writer releases only the writer itself.
+ * 
+ * @param   handle  The writer instance.
+ * @param   index   The index of the item.
+ * @param   item    Out param. The writer of the item.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonArrayWriter_GetObject, JsonArrayWriterHandle, handle, uint32_t, index, JsonObjectWriterHandle*, item);
+
 #endif //JSON_ARRAY_WRITER_H
\ No newline at end of file
@@ -4,6 +4,8 @@
 #ifndef JSON_DEFS_H
 #define JSON_DEFS_H
 
+#include <stdint.h>
+
 typedef enum _JsonWriterResult {
     JSON_WRITER_OK,
     JSON_WRITER_EXCEPTION
@@ -12,6 +14,12 @@ typedef enum _JsonWriterResult {
 typedef struct JsonObjectWriter* JsonObjectWriterHandle;
 typedef struct JsonArrayWriter* JsonArrayWriterHandle;
 
+/**
+ * Allocation functions for serialization output which is not owned by the writer
+ */
+typedef void* (*JsonBufferAllocateFunc)(uint32_t size);
+typedef void (*JsonBufferFreeFunc)(void* buffer);
+
 typedef enum _JsonReaderResult {
     JSON_READER_OK,
     JSON_READER_KEY_MISSING,
@@ -85,13 +85,26 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_WriteArray, JsonObjectWri
  * @brief Serialize the given object to char*.
  * 
  * @param   writer  The json writer instance.
- * @param   output  Out param. The serialized object.
+ * @param   output  Out param. The serialized object, should be freed with free.
  * @param   size    Out param. The size of the serialized output.
  * 
  * @return JSON_WRITER_OK on success, an indicative error in failure. 
  */
 MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_Serialize, JsonObjectWriterHandle, writer, char**, output, uint32_t*, size);
 
+/**
+ * @brief Serialize the given object into a buffer taken from the given allocator, e.g. directly into queue data.
+ * 
+ * @param   writer      The json writer instance.
+ * @param   allocate    The function which allocates the output buffer.
+ * @param   release     The function which frees the output buffer in case of failure.
+ * @param   output      Out param. The serialized object, a null terminated string allocated with allocate.
+ * @param   size        Out param. The size of the serialized output, without the null terminator.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure. 
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_SerializeWithAllocator, JsonObjectWriterHandle, writer, JsonBufferAllocateFunc, allocate, JsonBufferFreeFunc, release, char**, output, uint32_t*, size);
+
 /**
  * @brief Write the given object to this json object.
  * 
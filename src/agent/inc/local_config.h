@@ -9,7 +9,9 @@
 #include "umock_c_prod.h"
 #include "macro_utils.h"
 
+#include "collectors/collector_execution.h"
 #include "consts.h"
+#include "event_encoder.h"
 
 typedef enum _LocalConfigurationResultValues {
 
@@ -18,6 +20,14 @@ typedef enum _LocalConfigurationResultValues {
     
 } LocalConfigurationResultValues;
 
+typedef enum _TransportType {
+
+    TRANSPORT_TYPE_HUB,     // the module client of the IoT hub
+    TRANSPORT_TYPE_HUB_LL,  // the low level module client of the IoT hub, driven by the event publisher
+    TRANSPORT_TYPE_LOCAL    // a local sink, for offline throughput and soak runs
+
+} TransportType;
+
 /**
  * @brief initialize the local configuration.
  * 
@@ -93,4 +103,69 @@ MOCKABLE_FUNCTION(, int32_t, LocalConfiguration_GetDiagnosticEventMinimumSeverit
  */
 MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetRemoteConfigurationObjectName);
 
+/**
+ * @brief returns the directory of the queues spill logs.
+ * 
+ * @return the spill log directory.
+ */
+MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetSpillLogDirectory);
+
+/**
+ * @brief returns the disk quota in bytes of all the queues spill logs together.
+ * 
+ * @return the spill log disk quota.
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetSpillLogDiskQuota);
+
+/**
+ * @brief returns the encoding of the events and of the security messages, json unless cbor was configured.
+ * 
+ * @return the event encoding.
+ */
+MOCKABLE_FUNCTION(, EventEncoding, LocalConfiguration_GetEventEncoding);
+
+/**
+ * @brief returns the transport of the messages, the IoT hub unless the local sink was configured.
+ * 
+ * @return the transport type.
+ */
+MOCKABLE_FUNCTION(, TransportType, LocalConfiguration_GetTransportType);
+
+/**
+ * @brief returns the path of the file or UNIX socket the local transport writes the messages to.
+ * 
+ * @return the sink path, NULL unless the local transport was configured.
+ */
+MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetLocalTransportSinkPath);
+
+/**
+ * @brief returns the path of the twin json file the local transport delivers to the agent.
+ * 
+ * @return the twin file path, NULL unless the local transport was configured.
+ */
+MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetLocalTransportTwinFilePath);
+
+/**
+ * @brief returns the latency in milliseconds the local transport adds to every message until it is confirmed.
+ * 
+ * @return the local transport latency.
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetLocalTransportLatency);
+
+/**
+ * @brief returns the percentage of the messages the local transport fails to deliver.
+ * 
+ * @return the local transport failure rate, between 0 and 100.
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetLocalTransportFailureRate);
+
+/**
+ * @brief returns the time budget of a single run of the given collector.
+ * 
+ * @param   id  the collector.
+ * 
+ * @return the budget in milliseconds, 0 if it was not configured.
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetCollectorBudget, CollectorId, id);
+
 #endif // LOCAL_CONFiG_H
\ No newline at end of file
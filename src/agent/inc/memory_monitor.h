@@ -38,6 +38,14 @@ MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_Consume, uint32_t,
  */
 MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_Release, uint32_t, sizeInBytes);
 
+/**
+ * @brief Consumes the given amount of bytes even if the limit would be exceeded.
+ *        Used for memory which was already allocated and must be accounted for, it leaves less room for the rest.
+ * 
+ * @param   sizeInBytes    The size which was allocated. Should be freed with MemoryMonitor_Release.
+ */
+MOCKABLE_FUNCTION(, void, MemoryMonitor_ForceConsume, uint32_t, sizeInBytes);
+
 /**
  * @brief Returns the current memory consumption.
  * 
@@ -47,4 +55,57 @@ MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_Release, uint32_t,
  */
 MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_CurrentConsumption, uint32_t*, sizeInBytes);
 
+/**
+ * @brief Publishes a new memory limit, e.g. after the twin configuration was updated.
+ * 
+ * @param   limitInBytes    The new limit.
+ */
+MOCKABLE_FUNCTION(, void, MemoryMonitor_SetLimit, uint32_t, limitInBytes);
+
+/**
+ * @brief Initiate a sub budget which reserves a share of the memory limit, the reservation follows the limit when it changes.
+ * 
+ * @param   budget                  The budget to initiate.
+ * @param   reservedPercentOfLimit  The share of the limit reserved for the budget, in percents.
+ * 
+ * @return MEMORY_MONITOR_OK on success or MEMORY_MONITOR_MEMORY_EXCEEDED if the reservations would exceed the whole limit.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_InitBudget, MemoryBudget*, budget, uint32_t, reservedPercentOfLimit);
+
+/**
+ * @brief Deinitiate a sub budget and return its reservation.
+ * 
+ * @param   budget          The budget to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, MemoryMonitor_DeinitBudget, MemoryBudget*, budget);
+
+/**
+ * @brief Consume the given amount of bytes through a sub budget.
+ * 
+ * @param   budget          The budget.
+ * @param   sizeInBytes     The size one wants to allocate.
+ * 
+ * @return MEMORY_MONITOR_OK in case there is enough memory, MEMORY_MONITOR_MEMORY_EXCEEDED otherwise.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_ConsumeFromBudget, MemoryBudget*, budget, uint32_t, sizeInBytes);
+
+/**
+ * @brief Frees the given amount of bytes which were consumed through a sub budget.
+ * 
+ * @param   budget          The budget.
+ * @param   sizeInBytes     The size that is now cleared from the limitation.
+ * 
+ * @return MEMORY_MONITOR_OK in case the size was released or error in case of failure.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_ReleaseToBudget, MemoryBudget*, budget, uint32_t, sizeInBytes);
+
+/**
+ * @brief Checks whether a sub budget consumes more than its reservation, so releasing from it returns memory to the shared pool.
+ * 
+ * @param   budget          The budget.
+ * 
+ * @return true if the budget consumes from the shared pool, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, MemoryMonitor_IsBeyondReservation, MemoryBudget*, budget);
+
 #endif //INTERNAL_MEMORY_MONITOR_H
\ No newline at end of file
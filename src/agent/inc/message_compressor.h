@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MESSAGE_COMPRESSOR_H
+#define MESSAGE_COMPRESSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zlib.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+// the deflate window is 4KB, the dictionary takes a part of it
+#define MESSAGE_COMPRESSOR_MAX_DICTIONARY_SIZE 2048
+
+/**
+ * A deflate stream (zlib format) which a security message is written into.
+ * The stream is primed with a dictionary of the message schema, the dictionary id in the zlib header identifies it.
+ */
+typedef struct _MessageCompressor {
+
+    z_stream stream;
+    char* data;
+    uint32_t size;          // the compressed bytes written so far
+    uint32_t capacity;
+    uint32_t pendingSize;   // the bytes written since the last flush, deflate may still hold some of them back
+    bool failed;
+
+} MessageCompressor;
+
+/**
+ * @brief Initiates a new compressed stream.
+ *
+ * @param   compressor      The compressor to initiate.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, MessageCompressor_Init, MessageCompressor*, compressor);
+
+/**
+ * @brief Deinitiates the compressor, the compressed data is freed unless it was handed over by MessageCompressor_Finish.
+ *
+ * @param   compressor      The compressor to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, MessageCompressor_Deinit, MessageCompressor*, compressor);
+
+/**
+ * @brief Compresses the given bytes into the stream.
+ *
+ * @param   compressor      The compressor.
+ * @param   data            The bytes to compress.
+ * @param   size            The number of bytes.
+ *
+ * @return true on success, false otherwise. A failed stream stays failed.
+ */
+MOCKABLE_FUNCTION(, bool, MessageCompressor_Write, MessageCompressor*, compressor, const void*, data, uint32_t, size);
+
+/**
+ * @brief Flushes everything that was written so far, so the size of the stream becomes exact.
+ *        Every flush ends a deflate block, which costs a few bytes of the compressed size.
+ *
+ * @param   compressor      The compressor.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, MessageCompressor_Flush, MessageCompressor*, compressor);
+
+/**
+ * @brief Ends the stream and hands the compressed data over to the caller.
+ *
+ * @param   compressor      The compressor.
+ * @param   data            Out param. The compressed data, the caller is responsible to free it.
+ * @param   size            Out param. The size of the compressed data.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, MessageCompressor_Finish, MessageCompressor*, compressor, void**, data, uint32_t*, size);
+
+/**
+ * @brief Returns the largest number of bytes which are guaranteed to fit in the given room once compressed, including the
+ *        end of the stream. Data which does not compress at all is stored, so the bound is only a few bytes under the room.
+ *
+ * @param   room    The room left in the compressed stream.
+ *
+ * @return the max number of bytes to write.
+ */
+MOCKABLE_FUNCTION(, uint32_t, MessageCompressor_GetMaxInputSize, uint32_t, room);
+
+/**
+ * @brief Builds the preset dictionary the stream is primed with, a decompressor must use the same one.
+ *
+ * @param   buffer          The buffer to build the dictionary into.
+ * @param   bufferSize      The size of the buffer, MESSAGE_COMPRESSOR_MAX_DICTIONARY_SIZE is always enough.
+ *
+ * @return the size of the dictionary.
+ */
+MOCKABLE_FUNCTION(, uint32_t, MessageCompressor_GetDictionary, char*, buffer, uint32_t, bufferSize);
+
+#endif //MESSAGE_COMPRESSOR_H
@@ -15,6 +15,21 @@ extern const char* AGENT_ID_KEY;
 extern const char* MESSAGE_SCHEMA_VERSION_KEY;
 extern const char* HUB_RESOURCE_ID_PROPERTY_KEY;
 extern const char* EXTRA_DETAILS_KEY;
+extern const char* MESSAGE_CONTENT_ENCODING_DEFLATE;
+extern const char* MESSAGE_CONTENT_TYPE_CBOR;
+
+/* ===== Columnar Security Message Schema =====*/
+
+extern const char* MESSAGE_LAYOUT_KEY;
+extern const char* MESSAGE_LAYOUT_COLUMNAR;
+extern const char* COLUMNAR_STRINGS_KEY;
+extern const char* COLUMNAR_EVENT_GROUPS_KEY;
+extern const char* COLUMNAR_TIMESTAMP_BASE_KEY;
+extern const char* COLUMNAR_TIMESTAMP_DELTAS_KEY;
+extern const char* COLUMNAR_OFFSET_FROM_UTC_KEY;
+extern const char* COLUMNAR_OFFSETS_FROM_UTC_KEY;
+extern const char* COLUMNAR_PAYLOAD_COUNTS_KEY;
+extern const char* COLUMNAR_PAYLOAD_STRINGS_KEY;
 
 /* ===== Generic Event Message Schema =====*/
 
@@ -29,6 +44,9 @@ extern const char* EVENT_PAYLOAD_SCHEMA_VERSION_KEY;
 extern const char* EVENT_ID_KEY;
 extern const char* EVENT_LOCAL_TIMESTAMP_KEY;
 extern const char* EVENT_UTC_TIMESTAMP_KEY;
+extern const char* EVENT_SNAPSHOT_ID_KEY;
+extern const char* EVENT_SNAPSHOT_PART_KEY;
+extern const char* EVENT_SNAPSHOT_PARTS_KEY;
 extern const char* EVENT_TYPE_SECURITY_VALUE;
 extern const char* EVENT_TYPE_OPERATIONAL_VALUE;
 extern const char* EVENT_TYPE_DIAGNOSTIC_VALUE;
@@ -111,6 +129,25 @@ extern const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION;
 extern const char* AGENT_TELEMETRY_MESSAGES_SENT_KEY;
 extern const char* AGENT_TELEMETRY_MESSAGES_FAILED_KEY;
 extern const char* AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY;
+extern const char* AGENT_TELEMETRY_MESSAGES_FILL_RATIO_KEY;
+extern const char* AGENT_TELEMETRY_RECONNECT_ATTEMPTS_KEY;
+extern const char* AGENT_TELEMETRY_DISCONNECTED_TIME_KEY;
+extern const char* AGENT_TELEMETRY_EVICTED_EVENTS_NAME;
+extern const char* AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION;
+extern const char* AGENT_TELEMETRY_PRIORITY_KEY;
+extern const char* AGENT_TELEMETRY_EVICTED_EVENTS_KEY;
+extern const char* AGENT_TELEMETRY_MEMORY_CONSUMPTION_NAME;
+extern const char* AGENT_TELEMETRY_MEMORY_CONSUMPTION_SCHEMA_VERSION;
+extern const char* AGENT_TELEMETRY_SUBSYSTEM_KEY;
+extern const char* AGENT_TELEMETRY_ALLOCATED_BYTES_KEY;
+extern const char* AGENT_TELEMETRY_COLLECTOR_STATISTICS_NAME;
+extern const char* AGENT_TELEMETRY_COLLECTOR_STATISTICS_SCHEMA_VERSION;
+extern const char* AGENT_TELEMETRY_COLLECTOR_KEY;
+extern const char* AGENT_TELEMETRY_COLLECTOR_RUNS_KEY;
+extern const char* AGENT_TELEMETRY_COLLECTOR_OVERRUNS_KEY;
+extern const char* AGENT_TELEMETRY_COLLECTOR_SKIPPED_KEY;
+extern const char* AGENT_TELEMETRY_COLLECTOR_AVERAGE_DURATION_KEY;
+extern const char* AGENT_TELEMETRY_COLLECTOR_MAX_DURATION_KEY;
 
 /* ===== Configuration Error Message Schema ====*/
 
@@ -7,6 +7,7 @@
 #include "macro_utils.h"
 #include "umock_c_prod.h"
 
+#include "event_encoder.h"
 #include "synchronized_queue.h"
 
 typedef enum _MessageSerializerResultValues {
@@ -15,6 +16,8 @@ typedef enum _MessageSerializerResultValues {
     MESSAGE_SERIALIZER_MEMORY_EXCEEDED,
     MESSAGE_SERIALIZER_EMPTY,
     MESSAGE_SERIALIZER_PARTIAL,
+    // the message was filled up, the queues may hold more events for the next message
+    MESSAGE_SERIALIZER_FULL,
     MESSAGE_SERIALIZER_EXCEPTION
     
 } MessageSerializerResultValues;
@@ -31,4 +34,23 @@ typedef enum _MessageSerializerResultValues {
  */
 MOCKABLE_FUNCTION(, MessageSerializerResultValues, MessageSerializer_CreateSecurityMessage, SyncQueue**, queues, uint32_t, len, void**, buffer);
 
+/**
+ * @brief Serialize messages from the given queues into a security message of the given encoding (see event_encoder.h),
+ *        optionally deflate compressed (see message_compressor.h). The max message size applies to the size on the wire,
+ *        so a message takes as many more events as the encoding and the compression allow.
+ * 
+ * @param   queues          array of queues to serialize events from, the method empties the queues in an orderd way
+ * @param   len             The length of the queues array
+ * @param   encoding        The encoding of the message, the events in the queues must have the same encoding.
+ * @param   compressed      Whether to compress the message.
+ * @param   columnar        Whether to lay the message out in columns (see columnar_message.h). Applies to json messages only,
+ *                          which are packed by the size of their rows and sent in columns when the layout is smaller.
+ * @param   buffer          Out param. The buffer that will contain the encoded data on success.
+ * @param   bufferSize      Out param. The size of the encoded data.
+ *  
+ * @return MESSAGE_SERIALIZER_OK on success, MESSAGE_SERIALIZER_FULL if the message has no room for the events left in the queues,
+ *         otherwise the specific error. The queues are left intact if the compressor could not be initialized.
+ */
+MOCKABLE_FUNCTION(, MessageSerializerResultValues, MessageSerializer_CreateEncodedSecurityMessage, SyncQueue**, queues, uint32_t, len, EventEncoding, encoding, bool, compressed, bool, columnar, void**, buffer, uint32_t*, bufferSize);
+
 #endif //MESSAGE_SERIALIZER_H
\ No newline at end of file
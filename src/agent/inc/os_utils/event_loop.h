@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * The maximal number of timers and file descriptors a single loop handles.
+ */
+#define EVENT_LOOP_MAX_SOURCES 8
+
+/**
+ * @brief Called on the thread of the loop when a timer expires, or when a file descriptor is readable.
+ *
+ * @param   context     The context which was registered with the handler.
+ */
+typedef void (*EventLoopHandler)(void* context);
+
+/**
+ * A timer or a file descriptor which is watched by the loop.
+ */
+typedef struct _EventLoopSource {
+
+    int fd;
+    // timers are owned by the loop, file descriptors by the caller
+    bool isTimer;
+    EventLoopHandler handler;
+    void* context;
+
+} EventLoopSource;
+
+/**
+ * Runs the handlers of several periodic tasks and file descriptors on a single thread, and returns once it is stopped.
+ * The timers expire on fixed deadlines, so the time a handler takes does not delay the next execution.
+ * The sources are added before the loop is run, only the stop is safe to call from other threads.
+ */
+typedef struct _EventLoop {
+
+    int epollFd;
+    // an eventfd which is signaled by the stop, it stays signaled so a stop before the run is not lost
+    int stopFd;
+    EventLoopSource sources[EVENT_LOOP_MAX_SOURCES];
+    uint32_t numberOfSources;
+
+} EventLoop;
+
+/**
+ * @brief Initiate a new loop without sources.
+ *
+ * @param   loop    The instance to initiate.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EventLoop_Init, EventLoop*, loop);
+
+/**
+ * @brief Deinitiate the loop and close its timers. The loop must not be running.
+ *
+ * @param   loop    The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, EventLoop_Deinit, EventLoop*, loop);
+
+/**
+ * @brief Adds a periodic timer to the loop. The timer first expires once the loop runs, and then every interval.
+ *        Expirations which were missed while a handler ran are coalesced into a single call.
+ *
+ * @param   loop        The loop.
+ * @param   interval    The interval of the timer in milliseconds.
+ * @param   handler     The handler to call on every expiration.
+ * @param   context     The context to pass to the handler.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EventLoop_AddTimer, EventLoop*, loop, uint32_t, interval, EventLoopHandler, handler, void*, context);
+
+/**
+ * @brief Adds a file descriptor to the loop. The handler is called while the descriptor is readable, and should read it.
+ *
+ * @param   loop        The loop.
+ * @param   fd          The file descriptor, it stays owned by the caller and must outlive the loop.
+ * @param   handler     The handler to call when the descriptor is readable.
+ * @param   context     The context to pass to the handler.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, EventLoop_AddFd, EventLoop*, loop, int, fd, EventLoopHandler, handler, void*, context);
+
+/**
+ * @brief Runs the handlers of the loop on the calling thread until the loop is stopped.
+ *
+ * @param   loop    The loop.
+ *
+ * @return true if the loop was stopped, false if it failed.
+ */
+MOCKABLE_FUNCTION(, bool, EventLoop_Run, EventLoop*, loop);
+
+/**
+ * @brief Stops the loop, a running loop returns as soon as the handler it runs returns. Safe to call from any thread.
+ *
+ * @param   loop    The loop.
+ */
+MOCKABLE_FUNCTION(, void, EventLoop_Stop, EventLoop*, loop);
+
+#endif //EVENT_LOOP_H
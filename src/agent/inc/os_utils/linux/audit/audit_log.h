@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ *
+ * The audit log reader reads the audit log files of auditd from a byte offset, instead of parsing them from their start.
+ *
+ * The active log is rotated by auditd into numbered files, the log "audit.log" is renamed to "audit.log.1",
+ * "audit.log.1" to "audit.log.2" and so on. The names of the files change on every rotation, so a position in the log
+ * is kept by the inode of its file. The reader follows the rotations from the file of the position to the active log.
+ *
+ */
+
+typedef enum _AuditLogResult {
+
+    AUDIT_LOG_OK,
+    // the reader read the active log to its end
+    AUDIT_LOG_END,
+    // the file of the position was rotated away, or was truncated
+    AUDIT_LOG_NOT_FOUND,
+    AUDIT_LOG_EXCEPTION
+
+} AuditLogResult;
+
+/**
+ * A position in the audit log, an inode of 0 is an unknown position.
+ */
+typedef struct _AuditLogPosition {
+
+    uint64_t inode;
+    uint64_t offset;
+
+} AuditLogPosition;
+
+typedef struct _AuditLogReader {
+
+    char* path;
+    int fd;
+    // the position right after the last chunk which was read
+    AuditLogPosition position;
+    char* chunk;
+
+} AuditLogReader;
+
+/**
+ * @brief Returns the end of the active log, right after its last complete line.
+ *
+ * @param   path    The path of the active log.
+ * @param   end     Out param. The end of the log.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, AuditLog_GetEnd, const char*, path, AuditLogPosition*, end);
+
+/**
+ * @brief Opens the file of the given position for reading from it.
+ *
+ * @param   reader      The reader to initiate.
+ * @param   path        The path of the active log, the rotated files are next to it.
+ * @param   position    The position to read from.
+ *
+ * @return AUDIT_LOG_OK on success, AUDIT_LOG_NOT_FOUND in case the position is no longer in the log or AUDIT_LOG_EXCEPTION.
+ */
+MOCKABLE_FUNCTION(, AuditLogResult, AuditLog_Open, AuditLogReader*, reader, const char*, path, const AuditLogPosition*, position);
+
+/**
+ * @brief Reads the next chunk of the log, moving on to the next file once a rotated file was read to its end.
+ *        A chunk holds complete lines only. The last event of a full chunk is left for the next chunk, so an event is never split between two chunks.
+ *
+ * @param   reader  The reader.
+ * @param   chunk   Out param. The chunk, valid until the next call.
+ *
+ * @return AUDIT_LOG_OK on success, AUDIT_LOG_END in case the active log was read to its end or AUDIT_LOG_EXCEPTION.
+ */
+MOCKABLE_FUNCTION(, AuditLogResult, AuditLog_ReadChunk, AuditLogReader*, reader, const char**, chunk);
+
+/**
+ * @brief Closes the reader.
+ *
+ * @param   reader  The reader to close.
+ */
+MOCKABLE_FUNCTION(, void, AuditLog_Close, AuditLogReader*, reader);
+
+#endif //AUDIT_LOG_H
@@ -75,6 +75,10 @@ MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_Init, AuditSearch*, aud
 
 /**
  * @brief Initiates a new instance of audit search with multiple search types.
+ *        A search with a checkpoint which runs in a collector that is caught up with the audit stream searches the events
+ *        the stream buffered for the collector, instead of the audit logs.
+ *        Otherwise a search with a checkpoint reads the audit log from the position of its checkpoint, and searches all the logs
+ *        by the time of its checkpoint only if the position is unknown or was rotated away.
  * 
  * @param   auditSearch         The audit instance we want to initiate.
  * @param   searchCriteria      The search criteria to aply.
@@ -98,7 +102,9 @@ MOCKABLE_FUNCTION(, void, AuditSearch_Deinit, AuditSearch*, auditSearch);
  * 
  * @param   auditSearch     The search instance.
  * 
- * @return AUDIT_SEARCH_HAS_MORE_DATA in case there is anoteher item, AUDIT_SEARCH_NO_MORE_DATA in case the search has finished or appropriate error. 
+ * @return AUDIT_SEARCH_HAS_MORE_DATA in case there is anoteher item, AUDIT_SEARCH_NO_MORE_DATA in case the search has finished
+ *         or read as many events as a single run may read (the rest is read by the next search, after the checkpoint is set),
+ *         AUDIT_SEARCH_CANCELED in case the collector which runs the search was canceled or appropriate error. 
  */
 MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_GetNext, AuditSearch*, auditSearch);
 
@@ -146,7 +152,10 @@ MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_ReadString, AuditSearch
 MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_InterpretString, AuditSearch*, auditSearch, const char*, fieldName, const char**, output);
 
 /**
- * @brief Sets the checkoint to the search time.
+ * @brief Sets the checkoint to the last event the search returned, so the next search resumes right after it.
+ *        A search which returned no event keeps the previous checkpoint, or sets it to the search time if there was none.
+ *        The checkpoint holds the position in the audit log the next search reads from as well.
+ *        A search which read the audit stream reports to it whether it read all of its events.
  * 
  * @param   auditSearch     The search instance.
  *
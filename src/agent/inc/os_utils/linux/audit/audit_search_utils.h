@@ -11,8 +11,27 @@
 #include "macro_utils.h"
 #include "umock_c_prod.h"
 
+#include "os_utils/linux/audit/audit_log.h"
 #include "os_utils/process_info_handler.h"
 
+typedef enum _AuditSearchCriteria {
+    AUDIT_SEARCH_CRITERIA_TYPE,
+    AUDIT_SEARCH_CRITERIA_SYSCALL
+} AuditSearchCriteria;
+
+/**
+ * The position of an event in the audit log. Events are ordered by their time, and events of the same millisecond by their serial.
+ */
+typedef struct _AuditSearchCheckpoint {
+
+    time_t sec;
+    uint32_t milli;
+    unsigned long serial;
+    // the offset in the log files the next search reads from, all the events before it were consumed
+    AuditLogPosition position;
+
+} AuditSearchCheckpoint;
+
 typedef struct _AuditSearch {
 
     auparse_state_t* audit;
@@ -20,6 +39,31 @@ typedef struct _AuditSearch {
     time_t searchTime;
     bool firstSearch;
     ProcessInfo processInfo;
+    // the last event the previous search consumed, this search resumes right after it
+    AuditSearchCheckpoint checkpoint;
+    bool hasCheckpoint;
+    // the last event this search returned
+    AuditSearchCheckpoint lastEvent;
+    uint32_t eventsRead;
+    // in milliseconds of a monotonic clock
+    uint64_t deadline;
+    // the search read all of its events
+    bool finished;
+    // the collector which runs the search reads the audit stream, and reports the end of its search to it
+    bool streamSubscribed;
+    // the events the stream buffered for the collector, searched instead of the logs
+    char* streamEvents;
+    // the search is initiated again on each chunk of the log it reads
+    AuditSearchCriteria searchCriteria;
+    const char** messageTypes;
+    uint32_t messageTypesCount;
+    // the search reads the log in chunks from the position of its checkpoint
+    AuditLogReader log;
+    bool readsLog;
+    // all the events before the position were consumed
+    AuditLogPosition position;
+    // the end of the log when a search of all the logs started, the position once it read all of them
+    AuditLogPosition logEnd;
 
 } AuditSearch;
 
@@ -31,15 +75,12 @@ typedef enum _AuditSearchResultValues {
     AUDIT_SEARCH_NO_DATA,
     AUDIT_SEARCH_FIELD_DOES_NOT_EXIST,
     AUDIT_SEARCH_RECORD_DOES_NOT_EXIST,
+    // the collector which runs the search ran out of its budget
+    AUDIT_SEARCH_CANCELED,
     AUDIT_SEARCH_EXCEPTION
     
 } AuditSearchResultValues;
 
-typedef enum _AuditSearchCriteria {
-    AUDIT_SEARCH_CRITERIA_TYPE,
-    AUDIT_SEARCH_CRITERIA_SYSCALL
-} AuditSearchCriteria;
-
 /**
  * @brief Reads the givn field from the current search record as integer.
  * 
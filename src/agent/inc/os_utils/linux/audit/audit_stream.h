@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef AUDIT_STREAM_H
+#define AUDIT_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "collectors/collector_execution.h"
+#include "os_utils/linux/audit/audit_search_utils.h"
+
+/**
+ *
+ * The audit stream reads the audit events from the af_unix plugin of audispd as they are logged, and buffers the events
+ * of each collector which searches the audit. A collector which is caught up searches its buffer instead of the audit logs.
+ *
+ * The logs are still searched, from the checkpoint of the collector, whenever the buffer may miss events:
+ * on the first search of the collector, after the stream was disconnected, after the buffer overflowed,
+ * or after a search which did not read all of its events.
+ *
+ * Threading: the socket, the reconnect timer and the auparse state of the stream are used only on the thread of the event loop,
+ * from AuditStream_OnReadable, and the listener is called there too, without the lock held. The triggered collectors run on
+ * the threads of their worker pool, each search with an auparse state of its own, and reach the stream only through
+ * AuditStream_TakeEvents and AuditStream_ReportSearchEnd. The lock of the stream guards the channels and the connection
+ * state between the two sides, and the events a collector took are its own. auparse keeps its field interpretation caches
+ * process wide, so the stream does not interpret fields, it looks syscall names up in the tables of libaudit instead.
+ *
+ */
+
+typedef enum _AuditStreamResult {
+
+    // the stream is not connected, the logs are searched
+    AUDIT_STREAM_UNAVAILABLE,
+    // the buffer may miss events, the logs are searched and the events which arrive from now on are buffered
+    AUDIT_STREAM_CATCH_UP,
+    AUDIT_STREAM_EVENTS,
+    AUDIT_STREAM_NO_EVENTS
+
+} AuditStreamResult;
+
+/**
+ * @brief Called on the thread of the event loop when events were buffered for a collector.
+ *
+ * @param   context     The context which was registered with the listener.
+ * @param   id          The collector.
+ */
+typedef void (*AuditStreamListener)(void* context, CollectorId id);
+
+/**
+ * @brief Initiates the stream. The stream is connected once the loop runs, and reconnected whenever it is disconnected.
+ *
+ * @param   listener    The listener to notify when events arrive.
+ * @param   context     The context to pass to the listener.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, AuditStream_Init, AuditStreamListener, listener, void*, context);
+
+/**
+ * @brief Deinitiates the stream and drops the events it holds. The loop must not be running.
+ */
+MOCKABLE_FUNCTION(, void, AuditStream_Deinit);
+
+/**
+ * @brief Returns the file descriptor the event loop watches for the stream, it is readable while the stream has work to do.
+ *
+ * @return the file descriptor of the stream.
+ */
+MOCKABLE_FUNCTION(, int, AuditStream_GetFd);
+
+/**
+ * @brief Reads the stream, or connects it if it is disconnected. Called by the event loop when the descriptor of the stream is readable.
+ *
+ * @param   context     Unused.
+ */
+MOCKABLE_FUNCTION(, void, AuditStream_OnReadable, void*, context);
+
+/**
+ * @brief Subscribes the collector to the stream on its first call, and takes the events which were buffered for the collector.
+ *        The events which arrive from now on are buffered for the next search, which reads them only if this search reports that it read all of its events.
+ *
+ * @param   id                  The collector.
+ * @param   searchCriteria      The search criteria of the collector.
+ * @param   messageTypes        The types the collector searches for, they are copied on its first call.
+ * @param   messageTypesCount   Number of elements in the messageTypes array.
+ * @param   events              Out param. The text of the buffered events, set on AUDIT_STREAM_EVENTS only. Should be freed with AuditStream_FreeEvents.
+ *
+ * @return AUDIT_STREAM_EVENTS if the collector is caught up and has events, AUDIT_STREAM_NO_EVENTS if it is caught up and no event arrived,
+ *         otherwise the logs should be searched.
+ */
+MOCKABLE_FUNCTION(, AuditStreamResult, AuditStream_TakeEvents, CollectorId, id, AuditSearchCriteria, searchCriteria, const char**, messageTypes, uint32_t, messageTypesCount, char**, events);
+
+/**
+ * @brief Frees the events which were taken from the stream.
+ *
+ * @param   events  The events, may be NULL.
+ */
+MOCKABLE_FUNCTION(, void, AuditStream_FreeEvents, char*, events);
+
+/**
+ * @brief Reports the end of a search of the collector, after its checkpoint was set.
+ *
+ * @param   id          The collector.
+ * @param   finished    Whether the search read all of its events.
+ */
+MOCKABLE_FUNCTION(, void, AuditStream_ReportSearchEnd, CollectorId, id, bool, finished);
+
+#endif //AUDIT_STREAM_H
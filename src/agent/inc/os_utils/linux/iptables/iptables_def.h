@@ -40,6 +40,8 @@ typedef enum _IptablesResults {
     IPTABLES_NO_DATA,
     IPTABLES_ITERATOR_HAS_NEXT,
     IPTABLES_ITERATOR_NO_MORE_ITEMS,
+    // the collector which iterates ran out of its budget
+    IPTABLES_CANCELED,
     IPTABLES_EXCEPTION
 
 } IptablesResults;
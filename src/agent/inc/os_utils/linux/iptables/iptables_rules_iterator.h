@@ -34,7 +34,8 @@ MOCKABLE_FUNCTION(, void, IptablesRulesIterator_Deinit, IptablesRulesIteratorHan
  * 
  * @param   iterator    The iterator instance.
  * 
- * @return IPTABLES_ITERATOR_HAS_NEXT if the there is an item, IPTABLES_ITERATOR_NO_MORE_ITEMS if we reached the end of the iterator.
+ * @return IPTABLES_ITERATOR_HAS_NEXT if the there is an item, IPTABLES_ITERATOR_NO_MORE_ITEMS if we reached the end of the iterator,
+ *         IPTABLES_CANCELED if the collector which iterates was canceled.
  */
 MOCKABLE_FUNCTION(, IptablesResults, IptablesRulesIterator_GetNext, IptablesRulesIteratorHandle, iterator);
 
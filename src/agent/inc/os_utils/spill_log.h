@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SPILL_LOG_H
+#define SPILL_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+typedef enum _SpillLogResultValues {
+
+    SPILL_LOG_OK,
+    SPILL_LOG_IS_EMPTY,
+    SPILL_LOG_QUOTA_EXCEEDED,   // the record does not fit in the disk quota
+    SPILL_LOG_EXCEPTION
+
+} SpillLogResultValues;
+
+/**
+ * The size of a single segment file, records never span two segments
+ */
+#define SPILL_LOG_SEGMENT_SIZE (1024 * 1024)
+
+/**
+ * A single memory mapped segment file
+ */
+typedef struct _SpillLogSegment {
+
+    uint32_t id;
+    char* base;
+    uint32_t readOffset;    // the offset of the oldest record which was not consumed yet
+    uint32_t writeOffset;   // the offset right after the last record
+
+} SpillLogSegment;
+
+/**
+ * An append only log of records, split into memory mapped segment files in a single directory.
+ * Each record is checked with a CRC when the log is reloaded, a torn record ends its segment.
+ * Consumed records are marked in place, and a segment file is deleted once all of its records were consumed.
+ * The log is not synchronized, the owner of the log must serialize the calls.
+ */
+typedef struct _SpillLog {
+
+    char* directory;
+    uint32_t maxSegments;
+    SpillLogSegment* segments;      // ordered from the oldest segment to the one which is appended to
+    uint32_t numberOfSegments;
+    uint32_t numberOfRecords;
+    uint32_t nextSegmentId;
+
+} SpillLog;
+
+/**
+ * @brief Initiate the log and reload the records which were not consumed yet from the given directory.
+ *
+ * @param   spillLog    The instance to initiate.
+ * @param   directory   The directory which holds the segment files, created if missing.
+ * @param   diskQuota   The maximal size in bytes of all the segment files together.
+ *
+ * @return SPILL_LOG_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Init, SpillLog*, spillLog, const char*, directory, uint32_t, diskQuota);
+
+/**
+ * @brief Deinitiate the log. The segment files are kept so the records are reloaded on the next init.
+ *
+ * @param   spillLog    The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, SpillLog_Deinit, SpillLog*, spillLog);
+
+/**
+ * @brief Appends a record to the end of the log.
+ *
+ * @param   spillLog    The log.
+ * @param   data        The data of the record.
+ * @param   dataSize    The size of the data.
+ *
+ * @return SPILL_LOG_OK on success, SPILL_LOG_QUOTA_EXCEEDED if the record does not fit or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Append, SpillLog*, spillLog, const void*, data, uint32_t, dataSize);
+
+/**
+ * @brief Returns the oldest record of the log without consuming it.
+ *
+ * @param   spillLog    The log.
+ * @param   data        Out param. The data of the record, valid until the record is consumed.
+ * @param   dataSize    Out param. The size of the data.
+ *
+ * @return SPILL_LOG_OK on success or SPILL_LOG_IS_EMPTY.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Peek, SpillLog*, spillLog, const void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Consumes the oldest record of the log.
+ *
+ * @param   spillLog    The log.
+ *
+ * @return SPILL_LOG_OK on success or SPILL_LOG_IS_EMPTY.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Consume, SpillLog*, spillLog);
+
+/**
+ * @brief Returns the number of records which were not consumed yet.
+ *
+ * @param   spillLog    The log.
+ *
+ * @return the number of records.
+ */
+MOCKABLE_FUNCTION(, uint32_t, SpillLog_GetSize, SpillLog*, spillLog);
+
+#endif //SPILL_LOG_H
@@ -11,6 +11,7 @@
 #include "umock_c_prod.h"
 
 #include "agent_telemetry_counters.h"
+#include "os_utils/spill_log.h"
 
 /**
  * All the result types of the queue functions
@@ -25,6 +26,29 @@ typedef enum _QueueResultValues {
     
 } QueueResultValues;
 
+/**
+ * The eviction priority of an item, when the memory budget is exhausted items are evicted 
+ * from the lowest priority up to admit an item with a higher priority
+ */
+typedef enum _QueuePriority {
+
+    QUEUE_PRIORITY_LOW,             // periodic snapshots
+    QUEUE_PRIORITY_AGGREGATED,      // aggregated triggered events
+    QUEUE_PRIORITY_HIGH,            // triggered events
+    QUEUE_PRIORITY_PROTECTED        // never evicted
+
+} QueuePriority;
+
+/**
+ * The number of priorities whose items may be evicted
+ */
+#define QUEUE_NUMBER_OF_EVICTABLE_PRIORITIES QUEUE_PRIORITY_PROTECTED
+
+/**
+ * The number of items from the front of the queue which Queue_PopBestFit looks at, bounds the time the queue is held
+ */
+#define QUEUE_BEST_FIT_MAX_LOOK_AHEAD 32
+
 /**
  * A struct which represents an item in the queue
  */
@@ -34,9 +58,28 @@ typedef struct _QueueItem
     uint32_t dataSize;
     void* nextItem;
     void* prevItem; 
+    uint32_t accountedSize;     // the bytes consumed from the memory monitor for this item
+    bool pooledItem;            // the item was allocated by the slab allocator
+    bool inlineData;            // the data lives in the same block, right after the item
+    QueuePriority priority;
     
 } QueueItem;
 
+struct _Queue;
+struct _MemoryBudget;
+
+/**
+ * @brief Evicts a single item with a lower priority than the given one, to make room in the memory budget for a new item.
+ *        Called while the caller holds the queue, so the queue itself must not be locked again.
+ * 
+ * @param   evictParams     Extra user defined parameters for this function.
+ * @param   queue           The queue the new item is pushed to.
+ * @param   priority        The priority of the new item.
+ * 
+ * @return true if an item was evicted, false otherwise.
+ */
+typedef bool (*QueueEvictFunction)(void* evictParams, struct _Queue* queue, QueuePriority priority);
+
 /**
  * A queue struct
  */
@@ -47,8 +90,27 @@ typedef struct _Queue
     uint32_t numberOfElements;
     bool shouldSendLogs;
     SyncedCounter counter;
+    // optional, holds the items which did not fit in the memory budget
+    SpillLog* spillLog;
+    // the priority of the items pushed with Queue_PushBack
+    QueuePriority priority;
+    // optional, makes room for new items when the memory budget and the spill log are exhausted
+    QueueEvictFunction evict;
+    void* evictParams;
+    // optional, the memory budget the items are consumed from instead of the shared memory
+    struct _MemoryBudget* budget;
 } Queue;
 
+/**
+ * A prefix of a queue which was detached in one step, its items are owned by the batch
+ */
+typedef struct _QueueBatch
+{
+    QueueItem* firstItem;
+    uint32_t numberOfElements;
+    uint32_t dataSize;      // the total size of the data held by the batch
+} QueueBatch;
+
 /**
  * @brief A condition function for poping elements from the queue.
  * 
@@ -88,6 +150,18 @@ MOCKABLE_FUNCTION(, void, Queue_Deinit, Queue*, queue);
  */
 MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBack, Queue*, queue, void*, data, uint32_t, dataSize);
 
+/**
+ * @brief push an item with the given eviction priority to the end of the queue
+ * 
+ * @param   queue       The queue to push to
+ * @param   data        The data to push to the queue
+ * @param   dataSize    The size of the data we push into the queue
+ * @param   priority    The eviction priority of the item
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBackWithPriority, Queue*, queue, void*, data, uint32_t, dataSize, QueuePriority, priority);
+
 /**
  * Pops an item from the beginning of the queue
  * 
@@ -113,13 +187,123 @@ MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBack, Queue*, queue, void*, dat
 MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopFrontIf, Queue*, queue, QueuePopCondition, condition, void*, conditionParams, void**, data, uint32_t*, dataSize);
 
 /**
- * @brief returns the queue size
+ * @brief Attaches a spill log to the queue.
+ *        Once attached, items which exceed the memory budget are appended to the log instead of being dropped, 
+ *        and the queue is refilled from the log as items are poped. Records already in the log are loaded right away.
+ *        On deinit the items left in memory are appended to the log, after the records which were already spilled.
+ * 
+ * @param   queue       The queue.
+ * @param   spillLog    The spill log, must outlive the queue. NULL detaches the current log.
+ */
+MOCKABLE_FUNCTION(, void, Queue_SetSpillLog, Queue*, queue, SpillLog*, spillLog);
+
+/**
+ * @brief Consumes the memory of the items from the given budget instead of the shared memory.
+ *        The budget is set while the queue is empty, before a spill log is attached.
+ * 
+ * @param   queue       The queue.
+ * @param   budget      The memory budget, must outlive the queue. NULL uses the shared memory.
+ */
+MOCKABLE_FUNCTION(, void, Queue_SetMemoryBudget, Queue*, queue, struct _MemoryBudget*, budget);
+
+/**
+ * @brief Checks whether the items of the queue consume the shared memory, so evicting them makes room for any other queue.
+ *        An item of a queue within the reservation of its budget frees only the budget of that queue.
+ *        Safe to call without holding the queue, the budget is set once before the queue is used.
+ * 
+ * @param   queue       The queue.
+ * 
+ * @return true if the queue has no budget or consumes beyond its reservation, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, Queue_ConsumesSharedMemory, Queue*, queue);
+
+/**
+ * @brief Sets the eviction policy of the queue. The queue is initiated with QUEUE_PRIORITY_PROTECTED and no eviction.
+ * 
+ * @param   queue           The queue.
+ * @param   priority        The priority of the items pushed with Queue_PushBack.
+ * @param   evict           Optional. Called when an item does not fit in the memory budget nor in the spill log.
+ * @param   evictParams     Extra parameters for the evict function.
+ */
+MOCKABLE_FUNCTION(, void, Queue_SetEvictionPolicy, Queue*, queue, QueuePriority, priority, QueueEvictFunction, evict, void*, evictParams);
+
+/**
+ * @brief Evicts the oldest item with the given priority from the queue and frees it. The item is counted as dropped.
+ * 
+ * @param   queue       The queue.
+ * @param   priority    The priority of the item to evict.
+ * 
+ * @return QUEUE_OK if an item was evicted or QUEUE_IS_EMPTY if the queue holds no item with this priority.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_EvictOldest, Queue*, queue, QueuePriority, priority);
+
+/**
+ * @brief Pops the largest item whose data fits in the given size, out of the first QUEUE_BEST_FIT_MAX_LOOK_AHEAD items of the queue.
+ *        The oldest item wins among items of the same size. Used to pack the items which fit behind an item which does not.
+ * 
+ * @param   queue           The queue.
+ * @param   maxDataSize     The max size of the data of the poped item.
+ * @param   data            Out param. The data of the item, owned by the caller.
+ * @param   dataSize        Out param. The size of the data.
+ * 
+ * @return QUEUE_OK on success, QUEUE_IS_EMPTY if the queue is empty or QUEUE_CONDITION_FAILED if no item fits.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopBestFit, Queue*, queue, uint32_t, maxDataSize, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief returns the queue size, including the items which were spilled to the disk
  * 
  * @param   queue   The queue whom size we want to get
- * @param   size    Out param. The size of the queue in bytes.
+ * @param   size    Out param. The number of items in the queue.
  * 
  * @return always returns QUEUE_OK.
  */
 MOCKABLE_FUNCTION(, QueueResultValues, Queue_GetSize, Queue*, queue, uint32_t*, size);
 
+/**
+ * @brief Detaches the longest prefix of the queue whose items all satisfy the condition 
+ *        and whose total data size stays below the given limit.
+ *        The memory of the detached items is released from the memory monitor right away.
+ * 
+ * @param   queue               The queue to pop from.
+ * @param   condition           Optional. A condition each item in the batch must satisfy, NULL means no condition.
+ * @param   conditionParams     Extra parameters for the condition function.
+ * @param   maxBatchSize        The total data size of the batch is kept below this value.
+ * @param   batch               Out param. The detached items, should be drained with Queue_BatchPopFront.
+ * 
+ * @return QUEUE_OK on success, QUEUE_IS_EMPTY if the queue is empty or QUEUE_CONDITION_FAILED if the first item does not fit.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopBatchIf, Queue*, queue, QueuePopCondition, condition, void*, conditionParams, uint32_t, maxBatchSize, QueueBatch*, batch);
+
+/**
+ * @brief Pops the next item of a detached batch.
+ * 
+ * @param   batch       The batch.
+ * @param   data        Out param. The data of the item, owned by the caller.
+ * @param   dataSize    Out param. The size of the data.
+ * 
+ * @return QUEUE_OK on success or QUEUE_IS_EMPTY when the batch was drained.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_BatchPopFront, QueueBatch*, batch, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Allocates a buffer for data which is about to be pushed to a queue.
+ *        When possible the buffer is carved from a pooled block which also holds the queue item, 
+ *        so pushing it and poping it does not touch the general purpose allocator.
+ *        Data allocated here must be released with Queue_FreeData.
+ * 
+ * @param   dataSize    The size of the buffer.
+ * 
+ * @return the buffer or NULL upon failure.
+ */
+MOCKABLE_FUNCTION(, void*, Queue_AllocateData, uint32_t, dataSize);
+
+/**
+ * @brief Frees data that was poped from a queue, or allocated with Queue_AllocateData and never pushed.
+ *        Data which was not allocated by Queue_AllocateData is released with free.
+ * 
+ * @param   data    The data to free.
+ */
+MOCKABLE_FUNCTION(, void, Queue_FreeData, void*, data);
+
 #endif //QUEUE_H
\ No newline at end of file
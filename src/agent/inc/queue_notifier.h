@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef QUEUE_NOTIFIER_H
+#define QUEUE_NOTIFIER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+typedef enum _QueueNotifierWaitResult {
+
+    QUEUE_NOTIFIER_TIMEOUT,     // nothing happened until the timeout
+    QUEUE_NOTIFIER_SIGNALED,    // the size pushed since the last wait crossed the watermark, or the notifier was signaled
+    QUEUE_NOTIFIER_URGENT,      // an urgent item was pushed since the last wait
+    QUEUE_NOTIFIER_EXCEPTION
+
+} QueueNotifierWaitResult;
+
+/**
+ * Wakes up a consumer which waits for items to be pushed to one or more queues.
+ * The consumer is woken when an urgent item is pushed or when the size pushed since its last wait crosses the watermark.
+ */
+typedef struct _QueueNotifier {
+
+    LOCK_HANDLE lock;
+    COND_HANDLE condition;
+    uint32_t watermark;
+    uint32_t pendingSize;
+    bool urgent;
+    bool signaled;
+
+} QueueNotifier;
+
+/**
+ * @brief Initiate the notifier
+ *
+ * @param   notifier    The instance to initiate.
+ * @param   watermark   The size in bytes which wakes up the consumer once pushed.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, QueueNotifier_Init, QueueNotifier*, notifier, uint32_t, watermark);
+
+/**
+ * @brief Deinitiate the notifier
+ *
+ * @param   notifier    The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, QueueNotifier_Deinit, QueueNotifier*, notifier);
+
+/**
+ * @brief Updates the watermark of the notifier.
+ *
+ * @param   notifier    The notifier.
+ * @param   watermark   The size in bytes which wakes up the consumer once pushed.
+ */
+MOCKABLE_FUNCTION(, void, QueueNotifier_SetWatermark, QueueNotifier*, notifier, uint32_t, watermark);
+
+/**
+ * @brief Notifies that an item was pushed to one of the queues, wakes up the consumer if needed.
+ *
+ * @param   notifier    The notifier.
+ * @param   dataSize    The size of the pushed item.
+ * @param   urgent      Whether the item should wake up the consumer regardless of the watermark.
+ */
+MOCKABLE_FUNCTION(, void, QueueNotifier_NotifyPush, QueueNotifier*, notifier, uint32_t, dataSize, bool, urgent);
+
+/**
+ * @brief Wakes up the consumer unconditionally.
+ *
+ * @param   notifier    The notifier.
+ */
+MOCKABLE_FUNCTION(, void, QueueNotifier_Signal, QueueNotifier*, notifier);
+
+/**
+ * @brief Blocks until the consumer is woken up or until the timeout. Resets the pending size and urgency.
+ *
+ * @param   notifier    The notifier.
+ * @param   timeout     The maximal time to wait in milliseconds, must be positive.
+ *
+ * @return the reason the wait ended.
+ */
+MOCKABLE_FUNCTION(, QueueNotifierWaitResult, QueueNotifier_Wait, QueueNotifier*, notifier, uint32_t, timeout);
+
+#endif //QUEUE_NOTIFIER_H
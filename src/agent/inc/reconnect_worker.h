@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef RECONNECT_WORKER_H
+#define RECONNECT_WORKER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * @brief Reconnects to the hub, called on the thread of the worker.
+ *
+ * @param   context     The context which was passed to the worker.
+ *
+ * @return true if the reconnect was started, false if it should be attempted again.
+ */
+typedef bool (*ReconnectWorkerReconnect)(void* context);
+
+/**
+ * Reconnects in the background after the connection was lost, so no sender blocks on the reconnect.
+ * Each attempt waits an exponential backoff with jitter, so a fleet which lost the connection together does not reconnect together.
+ * The thread of the worker is started on the first reconnect.
+ */
+typedef struct _ReconnectWorker {
+
+    LOCK_HANDLE lock;
+    COND_HANDLE condition;
+    THREAD_HANDLE thread;
+    bool stop;
+    // a reconnect is due at dueTime, in milliseconds of the monotonic clock
+    bool pending;
+    uint64_t dueTime;
+    // the attempts since the connection was lost
+    uint32_t attempts;
+    unsigned int seed;
+    ReconnectWorkerReconnect reconnect;
+    void* context;
+
+} ReconnectWorker;
+
+/**
+ * @brief Initiate the worker
+ *
+ * @param   worker      The instance to initiate.
+ * @param   reconnect   The function which reconnects.
+ * @param   context     The context to pass to the reconnect function.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, ReconnectWorker_Init, ReconnectWorker*, worker, ReconnectWorkerReconnect, reconnect, void*, context);
+
+/**
+ * @brief Stops the thread of the worker, waiting for an attempt in progress, and deinitiates the worker.
+ *
+ * @param   worker      The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, ReconnectWorker_Deinit, ReconnectWorker*, worker);
+
+/**
+ * @brief Schedules a reconnect after the backoff of the attempts so far. Does nothing if a reconnect is already scheduled.
+ *
+ * @param   worker      The worker.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, ReconnectWorker_Schedule, ReconnectWorker*, worker);
+
+/**
+ * @brief Cancels the scheduled reconnect and resets the backoff, called once the connection is back.
+ *
+ * @param   worker      The worker.
+ */
+MOCKABLE_FUNCTION(, void, ReconnectWorker_Reset, ReconnectWorker*, worker);
+
+/**
+ * @brief Returns the time to wait before the next attempt: half of the exponential backoff, plus a random share of the other half.
+ *
+ * @param   attempts    The attempts since the connection was lost.
+ * @param   seed        The seed of the random share.
+ *
+ * @return the time to wait in milliseconds.
+ */
+MOCKABLE_FUNCTION(, uint32_t, ReconnectWorker_GetBackoff, uint32_t, attempts, unsigned int*, seed);
+
+#endif //RECONNECT_WORKER_H
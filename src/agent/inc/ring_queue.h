@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "agent_telemetry_counters.h"
+#include "queue.h"
+
+/**
+ * The cache line size used to keep the producers and consumer positions apart
+ */
+#define RING_QUEUE_CACHE_LINE_SIZE 64
+
+/**
+ * A single slot of the ring.
+ * The sequence number tells both sides who owns the slot:
+ *  sequence == position        the slot is free for the producer which claimed position
+ *  sequence == position + 1    the slot holds data the consumer can take
+ */
+typedef struct _RingQueueSlot {
+
+    uint32_t sequence;
+    void* data;
+    uint32_t dataSize;
+
+} RingQueueSlot;
+
+/**
+ * A bounded lock free multi producer single consumer queue.
+ * Any number of threads may push concurrently, only a single thread may pop at a time.
+ */
+typedef struct _RingQueue {
+
+    RingQueueSlot* slots;
+    uint32_t mask;
+    bool shouldSendLogs;
+    SyncedCounter counter;
+
+    uint32_t enqueuePosition __attribute__((aligned(RING_QUEUE_CACHE_LINE_SIZE)));
+    uint32_t dequeuePosition __attribute__((aligned(RING_QUEUE_CACHE_LINE_SIZE)));
+    uint32_t numberOfElements __attribute__((aligned(RING_QUEUE_CACHE_LINE_SIZE)));
+
+} RingQueue;
+
+/**
+ * @brief initiates the given ring queue
+ *
+ * @param   queue               The queue to initiate
+ * @param   capacity            The maximal number of elements in the queue, rounded up to a power of two
+ * @param   shouldSendLogs      whther the queue should send out logs
+ *
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingQueue_Init, RingQueue*, queue, uint32_t, capacity, bool, shouldSendLogs);
+
+/**
+ * @brief deinitiate the given queue (free its memory and the data of the remaining elements)
+ *
+ * @param   queue   The queue to deinitiate
+ */
+MOCKABLE_FUNCTION(, void, RingQueue_Deinit, RingQueue*, queue);
+
+/**
+ * @brief Push an item to the end of the queue. Safe to call from several threads concurrently.
+ *
+ * @param   queue       The queue to push to
+ * @param   data        The data to push to the end of the queue.
+ * @param   dataSize    The size of the data we want ot push to the queue.
+ *
+ * @return QUEUE_OK on success, QUEUE_MAX_MEMORY_EXCEEDED if the memory limit or the ring capacity was reached, or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingQueue_PushBack, RingQueue*, queue, void*, data, uint32_t, dataSize);
+
+/**
+ * @brief Pops an item from the beginning of the queue. Must only be called by the consumer thread.
+ *
+ * @param   queue       The queue to pop from
+ * @param   data        Out param. The data we poped from the queue.
+ * @param   dataSize    Out param. The size of the data we poped from the queue.
+ *
+ * @return QUEUE_OK on success or QUEUE_IS_EMPTY if there is no item ready to be poped.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingQueue_PopFront, RingQueue*, queue, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Pops an item from the beginning of the queue only if the condition returns true on this item.
+ *        Must only be called by the consumer thread.
+ *
+ * @param   queue               The queue to pop from
+ * @param   condition           A condition for poping the elements from the queue.
+ * @param   conditionParams     Extra parameters for the condition function.
+ * @param   data                out param containing the data of the item that was poped from the queue
+ * @param   dataSize            out param containing the size of the data that was poped from the queue
+ *
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingQueue_PopFrontIf, RingQueue*, queue, QueuePopCondition, condition, void*, conditionParams, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Returns the number of elements which are ready to be poped
+ *
+ * @param   queue   The queue whom size we want to get.
+ * @param   size    Out param. The size of the queue.
+ *
+ * @return always return QUEUE_OK.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingQueue_GetSize, RingQueue*, queue, uint32_t*, size);
+
+#endif //RING_QUEUE_H
@@ -11,6 +11,11 @@
 
 typedef void (*SchedulerTask)(void* params);
 
+/**
+ * Blocks the scheduler between two executions of its task, instead of sleeping for the scheduler interval.
+ */
+typedef void (*SchedulerWait)(void* params, uint32_t schedulerInterval);
+
 typedef enum _SchedulerThreadState {
     SCHEDULER_THREAD_CREATED,
     SCHEDULER_THREAD_STARTED,
@@ -22,6 +27,7 @@ typedef struct _SchedulerThread {
     THREAD_HANDLE threadHandle;
     uint32_t schedulerInterval;
     SchedulerTask task;
+    SchedulerWait wait;
     void* taskParam;
     bool continueRunning;
     SchedulerThreadState state;
@@ -40,6 +46,21 @@ typedef struct _SchedulerThread {
  */
 bool SchedulerThread_Init(SchedulerThread* scheduler, uint32_t schedulerInterval, SchedulerTask task, void* taskParam);
 
+/**
+ * @brief Initiates a new scheduler instance which blocks in the given wait function between the task executions.
+ *
+ * @param   scheduler           Out param. The instance to initiate.
+ * @param   schedulerInterval   The interval between the task executions, passed to the wait function.
+ * @param   task                The task to execute.
+ * @param   wait                Called with the task parameters after each execution, the task runs again once it returns.
+ *                              It may return before the interval passed, e.g. when there is new work for the task.
+ *                              NULL makes the scheduler sleep for the interval, as SchedulerThread_Init does.
+ * @param   taskParam           The parameters to the task and to the wait function.
+ *
+ * @return true on success, false otherwise.  The value of the out params is undefined in case of failure.
+ */
+bool SchedulerThread_InitWithWait(SchedulerThread* scheduler, uint32_t schedulerInterval, SchedulerTask task, SchedulerWait wait, void* taskParam);
+
 /**
  * @brief Deinitiates the scheduler instance.
  * 
@@ -6,7 +6,11 @@
 
 #include <stdbool.h>
 
+#include "eviction_policy.h"
 #include "iothub_adapter.h"
+#include "memory_monitor.h"
+#include "os_utils/event_loop.h"
+#include "os_utils/spill_log.h"
 #include "scheduler_thread.h"
 #include "synchronized_queue.h"
 #include "tasks/event_monitor_task.h"
@@ -37,6 +41,24 @@ typedef struct _SecurityAgentQueues {
     SyncQueue twinUpdatesQueue;
     bool twinUpdatesQueueInitiated;
 
+    // the memory reserved for the security events, so the other queues can not take all of it
+    MemoryBudget highPriorityMemoryBudget;
+    bool highPriorityMemoryBudgetInitiated;
+
+    MemoryBudget lowPriorityMemoryBudget;
+    bool lowPriorityMemoryBudgetInitiated;
+
+    // hold the events which exceed the memory budget, must outlive their queues
+    SpillLog highPrioritySpillLog;
+    bool highPrioritySpillLogInitiated;
+
+    SpillLog lowPrioritySpillLog;
+    bool lowPrioritySpillLogInitiated;
+
+    // evicts lower priority events across the queues once the memory budget and the spill logs are exhausted
+    EvictionPolicy evictionPolicy;
+    bool evictionPolicyInitiated;
+
 } SecurityAgentQueues;
 
 
@@ -45,13 +67,22 @@ typedef struct _SecurityAgent {
     SecurityAgentQueues queues;
 
     EventMonitorTask monitorTask;
-    SecurityAgentAsyncTask asyncMonitorTask;
+    bool monitorTaskInitiated;
 
+    // the publisher blocks on its queues between the deadlines of the messages, so it keeps a thread of its own
     EventPublisherTask publisherTask;
     SecurityAgentAsyncTask asyncPublisherTask;
 
     UpdateTwinTask updateTwinTask;
-    SecurityAgentAsyncTask asyncUpdateTwinTask;
+    bool updateTwinTaskInitiated;
+
+    // runs the monitor and the twin updater on timers of a single thread
+    EventLoop eventLoop;
+    bool eventLoopInitiated;
+    THREAD_HANDLE eventLoopThread;
+
+    // feeds the triggered collectors with the audit events as they are logged, the collectors search the audit logs without it
+    bool auditStreamInitiated;
 
     IoTHubAdapter iothubAdapter;
     bool iothubAdapterInitiated;
@@ -59,6 +90,7 @@ typedef struct _SecurityAgent {
     bool loggerInitiated;
     bool iothubInitiated;
     bool memoryMonitorInitiated;
+    bool slabAllocatorInitiated;
     bool twinConfigurationInitiated;
     bool localConfigurationInitiated;
     bool diagnosticEventCollectorInitiated;
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SEND_PIPELINE_H
+#define SEND_PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "azure_c_shared_utility/lock.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "iothub_adapter.h"
+
+/**
+ * The max number of messages the pipeline can hold, the in flight window is capped to it
+ */
+#define SEND_PIPELINE_MAX_WINDOW 16
+
+typedef enum _SendPipelineResult {
+
+    SEND_PIPELINE_OK,           // the message was handed to the hub
+    SEND_PIPELINE_DEFERRED,     // the pipeline owns the message, but could not hand it to the hub and will retry later
+    SEND_PIPELINE_FULL,         // the in flight window is full, the message was not taken
+    SEND_PIPELINE_EXCEPTION     // the message was not taken
+
+} SendPipelineResult;
+
+typedef enum _SendPipelineSlotState {
+
+    SEND_PIPELINE_SLOT_FREE,
+    SEND_PIPELINE_SLOT_IN_FLIGHT,   // handed to the hub, waiting for its confirmation
+    SEND_PIPELINE_SLOT_RETRY        // failed, waiting for its retry time
+
+} SendPipelineSlotState;
+
+struct _SendPipeline;
+
+/**
+ * A message which was taken by the pipeline and was not confirmed yet.
+ */
+typedef struct _SendPipelineSlot {
+
+    struct _SendPipeline* pipeline;
+    void* buffer;
+    uint32_t size;
+    const char* contentType;
+    const char* contentEncoding;
+    SendPipelineSlotState state;
+    uint32_t attempts;
+    time_t retryTime;
+
+} SendPipelineSlot;
+
+/**
+ * Keeps the messages sent to the hub until the hub confirms them, and sends the failed ones again with
+ * an exponential backoff. A message is dropped once it fails SEND_MAX_ATTEMPTS times.
+ * The confirmations arrive on the thread of the module client, the slots are guarded by the lock of the pipeline.
+ */
+typedef struct _SendPipeline {
+
+    IoTHubAdapter* iothubAdapter;
+    LOCK_HANDLE lock;
+    SendPipelineSlot slots[SEND_PIPELINE_MAX_WINDOW];
+
+} SendPipeline;
+
+/**
+ * @brief Initiate the pipeline
+ *
+ * @param   pipeline        The pipeline to initiate.
+ * @param   iothubAdapter   The adapter to send the messages with.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, SendPipeline_Init, SendPipeline*, pipeline, IoTHubAdapter*, iothubAdapter);
+
+/**
+ * @brief Deinitiate the pipeline and drop the messages it holds.
+ *        The module client must be destroyed first, so no confirmation arrives after the pipeline is gone.
+ *
+ * @param   pipeline    The pipeline to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, SendPipeline_Deinit, SendPipeline*, pipeline);
+
+/**
+ * @brief Returns whether the pipeline can take another message.
+ *
+ * @param   pipeline    The pipeline.
+ * @param   window      The max number of messages which are in flight or wait for a retry, capped to SEND_PIPELINE_MAX_WINDOW.
+ *
+ * @return true if a message can be sent, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, SendPipeline_HasRoom, SendPipeline*, pipeline, uint32_t, window);
+
+/**
+ * @brief Sends a message to the hub and keeps it until the hub confirms it.
+ *
+ * @param   pipeline        The pipeline.
+ * @param   buffer          The message, allocated with malloc. The pipeline owns it on SEND_PIPELINE_OK and SEND_PIPELINE_DEFERRED.
+ * @param   size            The size of the message.
+ * @param   contentType     The content type of the message, a static string. NULL for json.
+ * @param   contentEncoding The content encoding of the message, a static string. NULL for plain data.
+ *
+ * @return SEND_PIPELINE_OK if the message was handed to the hub, SEND_PIPELINE_DEFERRED if it will be sent again later,
+ *         SEND_PIPELINE_FULL or SEND_PIPELINE_EXCEPTION if the message was not taken.
+ */
+MOCKABLE_FUNCTION(, SendPipelineResult, SendPipeline_Send, SendPipeline*, pipeline, void*, buffer, uint32_t, size, const char*, contentType, const char*, contentEncoding);
+
+/**
+ * @brief Sends again the failed messages whose retry time has come.
+ *
+ * @param   pipeline        The pipeline.
+ * @param   currentTime     The current time.
+ */
+MOCKABLE_FUNCTION(, void, SendPipeline_Retry, SendPipeline*, pipeline, time_t, currentTime);
+
+/**
+ * @brief Returns the time left until the next retry, in milliseconds.
+ *
+ * @param   pipeline        The pipeline.
+ * @param   currentTime     The current time.
+ *
+ * @return The time left until the next retry, 0 if a retry is due, UINT32_MAX if no message waits for a retry.
+ */
+MOCKABLE_FUNCTION(, uint32_t, SendPipeline_GetRetryTimeout, SendPipeline*, pipeline, time_t, currentTime);
+
+#endif //SEND_PIPELINE_H
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * The size of a single slab. Blocks of one size class are carved out of slabs of this size.
+ */
+#define SLAB_ALLOCATOR_SLAB_SIZE (32 * 1024)
+
+/**
+ * The number of slabs the allocator reserves address space for, allocations beyond them should go to the general purpose allocator
+ */
+#define SLAB_ALLOCATOR_MAX_SLABS 1024
+
+/**
+ * The number of block size classes, the classes are 64, 128, ... up to SLAB_ALLOCATOR_MAX_BLOCK_SIZE bytes
+ */
+#define SLAB_ALLOCATOR_NUMBER_OF_CLASSES 8
+
+/**
+ * The largest block the allocator serves, larger requests should go to the general purpose allocator
+ */
+#define SLAB_ALLOCATOR_MAX_BLOCK_SIZE (8 * 1024)
+
+/**
+ * @brief Initiate the slab allocator. The address space of all slabs is reserved up front, the memory of a slab
+ *        is committed as its blocks are handed out and returned to the system once all of its blocks are free.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, SlabAllocator_Init);
+
+/**
+ * @brief Deinitiate the slab allocator and free all of its slabs.
+ *        All blocks which were handed out are invalid after this call.
+ */
+MOCKABLE_FUNCTION(, void, SlabAllocator_Deinit);
+
+/**
+ * @brief Allocates a block from the smallest size class which fits the given size.
+ *
+ * @param   size    The requested size in bytes.
+ *
+ * @return the block, or NULL if the allocator is not initiated, the size is bigger than SLAB_ALLOCATOR_MAX_BLOCK_SIZE or all slabs are used.
+ */
+MOCKABLE_FUNCTION(, void*, SlabAllocator_Allocate, uint32_t, size);
+
+/**
+ * @brief Returns a block to its size class.
+ *
+ * @param   block   A block returned by SlabAllocator_Allocate.
+ */
+MOCKABLE_FUNCTION(, void, SlabAllocator_Free, void*, block);
+
+/**
+ * @brief Finds the block which contains the given address.
+ *        The block is derived from the address without locking the allocator, so an address inside the slabs must lie in a block which was not freed.
+ *
+ * @param   address     Any address.
+ * @param   block       Out param. The start of the block which contains the address.
+ * @param   blockSize   Out param. The size of the block.
+ *
+ * @return true if the address lies inside one of the slabs, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, SlabAllocator_GetBlock, const void*, address, void**, block, uint32_t*, blockSize);
+
+/**
+ * @brief Returns the size of the block which would be used for an allocation of the given size.
+ *
+ * @param   size    The requested size in bytes.
+ *
+ * @return the block size, or 0 if the size is bigger than SLAB_ALLOCATOR_MAX_BLOCK_SIZE.
+ */
+MOCKABLE_FUNCTION(, uint32_t, SlabAllocator_GetBlockSize, uint32_t, size);
+
+#endif //SLAB_ALLOCATOR_H
@@ -11,6 +11,8 @@
 #include "umock_c_prod.h"
 
 #include "queue.h"
+#include "queue_notifier.h"
+#include "ring_queue.h"
 
 typedef enum _SyncQueueResultValues {
 
@@ -18,13 +20,44 @@ typedef enum _SyncQueueResultValues {
     
 } SyncQueueResultValues;
 
+/**
+ * The data structure backing a synchronized queue
+ */
+typedef enum _SyncQueueBackend {
+
+    SYNC_QUEUE_BACKEND_LIST,    // an unbounded linked list guarded by a lock
+    SYNC_QUEUE_BACKEND_RING     // a bounded lock free ring, multiple producers and a single consumer
+
+} SyncQueueBackend;
+
 typedef struct _SyncQueue {
 
+    SyncQueueBackend backend;
     Queue queue; 
+    RingQueue ring;
     LOCK_HANDLE lock;
+    // optional, notified on each successful push
+    QueueNotifier* notifier;
+    bool urgent;
 
 } SyncQueue;
 
+/**
+ * A batch of items poped from a synchronized queue with SyncQueue_PopBatchIf
+ */
+typedef struct _SyncQueueBatch {
+
+    SyncQueueBackend backend;
+    QueueBatch batch;               // the items detached from a list backed queue
+    // a ring has a single consumer and no lock to amortize, so its batch is poped lazily
+    RingQueue* ring;
+    QueuePopCondition condition;
+    void* conditionParams;
+    uint32_t remainingElements;
+    uint32_t remainingSize;
+
+} SyncQueueBatch;
+
 /**
  * @brief Initiate the queue
  * 
@@ -35,6 +68,18 @@ typedef struct _SyncQueue {
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_Init, SyncQueue*, syncQueue, bool, shouldSendLogs);
 
+/**
+ * @brief Initiate the queue on top of a bounded lock free ring.
+ *        Pushing is safe from any thread, poping must be done by a single consumer thread.
+ * 
+ * @param   syncQueue           The instance to initiate.
+ * @param   shouldSendLogs      Whether this instance should send out logs.
+ * @param   capacity            The maximal number of elements the queue holds.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_InitRing, SyncQueue*, syncQueue, bool, shouldSendLogs, uint32_t, capacity);
+
 /**
  * @brief Deinitiate the given queue and free it memory
  * 
@@ -53,6 +98,18 @@ MOCKABLE_FUNCTION(, void, SyncQueue_Deinit, SyncQueue*, syncQueue);
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_PushBack, SyncQueue*, syncQueue, void*, data, uint32_t, dataSize);
 
+/**
+ * @brief Push an item with the given eviction priority to the end of the queue. A ring backed queue ignores the priority.
+ * 
+ * @param   syncQueue   The instance to push the item to.
+ * @param   data        The data to push to the end of the queue.
+ * @param   dataSize    The size of the data we want ot push to the queue.
+ * @param   priority    The eviction priority of the item.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_PushBackWithPriority, SyncQueue*, syncQueue, void*, data, uint32_t, dataSize, QueuePriority, priority);
+
 /**
  * @brief Pops an item from the beginning of the queue
  * 
@@ -77,6 +134,53 @@ MOCKABLE_FUNCTION(, int, SyncQueue_PopFront, SyncQueue*, syncQueue, void**, data
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_PopFrontIf, SyncQueue*, syncQueue, QueuePopCondition, condition, void*, conditionParams, void**, data, uint32_t*, dataSize);
 
+/**
+ * @brief Pops a batch of items from the beginning of the queue in a single critical section.
+ *        The batch is the longest prefix of the queue whose items satisfy the condition and whose total data size stays below maxBatchSize.
+ *        For a ring backed queue the batch is bounded by the number of elements at the time of the call and its items are poped 
+ *        as the batch is drained, so a first item which does not fit shows up as an empty batch.
+ * 
+ * @param   syncQueue           The queue to pop from.
+ * @param   condition           Optional. A condition each item in the batch must satisfy, NULL means no condition.
+ * @param   conditionParams     Extra parameters for the condition function.
+ * @param   maxBatchSize        The total data size of the batch is kept below this value.
+ * @param   batch               Out param. The batch, must be drained with SyncQueue_BatchPopFront.
+ * 
+ * @return QUEUE_OK on success, QUEUE_IS_EMPTY or QUEUE_CONDITION_FAILED if nothing was poped, or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_PopBatchIf, SyncQueue*, syncQueue, QueuePopCondition, condition, void*, conditionParams, uint32_t, maxBatchSize, SyncQueueBatch*, batch);
+
+/**
+ * @brief Pops the next item of a batch. Does not take the queue lock.
+ * 
+ * @param   batch       The batch.
+ * @param   data        Out param. The data of the item, owned by the caller.
+ * @param   dataSize    Out param. The size of the data.
+ * 
+ * @return QUEUE_OK on success or QUEUE_IS_EMPTY when the batch was drained.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_BatchPopFront, SyncQueueBatch*, batch, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Attaches a notifier to the queue. The notifier is notified on each successful push.
+ *        Must be called before the queue is shared between threads.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   notifier    The notifier, or NULL to detach the current notifier.
+ * @param   urgent      Whether every push to this queue should wake up the consumer regardless of the notifier watermark.
+ */
+MOCKABLE_FUNCTION(, void, SyncQueue_SetNotifier, SyncQueue*, syncQueue, QueueNotifier*, notifier, bool, urgent);
+
+/**
+ * @brief Attaches a spill log to a list backed queue, see Queue_SetSpillLog.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   spillLog    The spill log, must outlive the queue. NULL detaches the current log.
+ * 
+ * @return true on success, false if the queue is ring backed or the lock failed.
+ */
+MOCKABLE_FUNCTION(, bool, SyncQueue_SetSpillLog, SyncQueue*, syncQueue, SpillLog*, spillLog);
+
 /**
  * @brief Returns the queue size
  * 
@@ -87,4 +191,59 @@ MOCKABLE_FUNCTION(, int, SyncQueue_PopFrontIf, SyncQueue*, syncQueue, QueuePopCo
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_GetSize, SyncQueue*, syncQueue, uint32_t*, size);
 
+/**
+ * @brief Sets the memory budget of a list backed queue, see Queue_SetMemoryBudget.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   budget      The memory budget, must outlive the queue. NULL uses the shared memory.
+ * 
+ * @return true on success, false if the queue is ring backed or the lock failed.
+ */
+MOCKABLE_FUNCTION(, bool, SyncQueue_SetMemoryBudget, SyncQueue*, syncQueue, struct _MemoryBudget*, budget);
+
+/**
+ * @brief Sets the eviction policy of a list backed queue, see Queue_SetEvictionPolicy.
+ *        The ring is bounded by its capacity and has no eviction policy.
+ * 
+ * @param   syncQueue       The queue.
+ * @param   priority        The priority of the items pushed with SyncQueue_PushBack.
+ * @param   evict           Optional. Called under the queue lock when an item does not fit in the memory budget.
+ * @param   evictParams     Extra parameters for the evict function.
+ * 
+ * @return true if the policy was set, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, SyncQueue_SetEvictionPolicy, SyncQueue*, syncQueue, QueuePriority, priority, QueueEvictFunction, evict, void*, evictParams);
+
+/**
+ * @brief Pops the largest item whose data fits in the given size, see Queue_PopBestFit.
+ *        Only the first item of a ring backed queue can be poped, so it is poped if it fits.
+ * 
+ * @param   syncQueue       The queue.
+ * @param   maxDataSize     The max size of the data of the poped item.
+ * @param   data            Out param. The data of the item, owned by the caller.
+ * @param   dataSize        Out param. The size of the data.
+ * 
+ * @return QUEUE_OK on success, QUEUE_IS_EMPTY if the queue is empty, QUEUE_CONDITION_FAILED if no item fits or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_PopBestFit, SyncQueue*, syncQueue, uint32_t, maxDataSize, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Evicts the oldest item with the given priority from a list backed queue, see Queue_EvictOldest.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   priority    The priority of the item to evict.
+ * 
+ * @return QUEUE_OK if an item was evicted, QUEUE_IS_EMPTY if there is no such item or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_EvictOldest, SyncQueue*, syncQueue, QueuePriority, priority);
+
+/**
+ * @brief Returns the collected/dropped telemetry counter of the queue
+ * 
+ * @param   syncQueue   The queue whom counter we want to get.
+ * 
+ * @return the counter of the underlying queue.
+ */
+MOCKABLE_FUNCTION(, SyncedCounter*, SyncQueue_GetCounter, SyncQueue*, syncQueue);
+
 #endif //SYNCHRONIZED_QUEUE_H
\ No newline at end of file
@@ -7,7 +7,53 @@
 #include <stdbool.h>
 #include <time.h>
 
+#include "collectors/collector.h"
+#include "collectors/collector_execution.h"
 #include "synchronized_queue.h"
+#include "timer_wheel.h"
+#include "twin_configuration_defs.h"
+#include "worker_pool.h"
+
+/**
+ * The number of periodic collectors, each one runs on its own schedule.
+ */
+#define EVENT_MONITOR_PERIODIC_COLLECTORS 6
+
+/**
+ * The number of triggered collectors, they all run on every triggered interval.
+ */
+#define EVENT_MONITOR_TRIGGERED_COLLECTORS 5
+
+struct _EventMonitorTask;
+
+/**
+ * A collector which runs as a job of a worker pool. The job is busy while the collector runs, so a collector never runs twice at the same time.
+ */
+typedef struct _EventMonitorCollector {
+
+    struct _EventMonitorTask* task;
+    CollectorId id;
+    TwinConfigurationEventType eventType;
+    EventCollectorFunc collectFunction;
+    // the time budget of a single run in milliseconds
+    uint32_t budget;
+    WorkerPoolJob job;
+    // events arrived while the collector was running, it is submitted again on the next execution
+    bool pending;
+
+} EventMonitorCollector;
+
+/**
+ * The schedule of a single periodic collector.
+ */
+typedef struct _EventMonitorSchedule {
+
+    TimerWheelTimer timer;
+    EventMonitorCollector collector;
+    // the position of the collector, which spreads the collectors over their interval
+    uint32_t index;
+
+} EventMonitorSchedule;
 
 typedef struct _EventMonitorTask {
     
@@ -16,6 +62,15 @@ typedef struct _EventMonitorTask {
     SyncQueue* lowPriorityQueue;
     time_t lastPeriodicExecution;
     time_t lastTriggeredExecution;
+    // the periodic collectors run on a wheel which ticks in seconds, it is started on the first execution
+    TimerWheel wheel;
+    bool wheelStarted;
+    uint32_t snapshotFrequency;
+    EventMonitorSchedule schedules[EVENT_MONITOR_PERIODIC_COLLECTORS];
+    EventMonitorCollector triggeredCollectors[EVENT_MONITOR_TRIGGERED_COLLECTORS];
+    // the triggered collectors have their own pool, so a slow snapshot never delays them
+    WorkerPool triggeredPool;
+    WorkerPool snapshotPool;
 
 } EventMonitorTask;
 
@@ -38,6 +93,15 @@ bool EventMonitorTask_Init(EventMonitorTask* task, SyncQueue* highPriorityQueue,
  */
 void EventMonitorTask_Execute(EventMonitorTask* task);
 
+/**
+ * @brief Submits the triggered collector which received events from the audit stream, instead of waiting for the triggered interval.
+ *        Called on the thread which executes the task.
+ * 
+ * @param   context     The instance of the task.
+ * @param   id          The collector which received events.
+ */
+void EventMonitorTask_OnAuditEvents(void* context, CollectorId id);
+
 /**
  * @brief Deinitiates the task
  * 
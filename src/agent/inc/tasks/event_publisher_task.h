@@ -8,6 +8,8 @@
 #include <time.h>
 
 #include "iothub_adapter.h"
+#include "queue_notifier.h"
+#include "send_pipeline.h"
 #include "synchronized_queue.h"
 
 typedef struct _EventPublisherTask {
@@ -18,6 +20,13 @@ typedef struct _EventPublisherTask {
     time_t highPriorityQueueLastExecution;
     time_t lowPriorityQueueLastExecution;
     IoTHubAdapter* iothubAdapter;
+    // wakes the task up when events are pushed to its queues
+    QueueNotifier notifier;
+    bool urgentEventsPending;
+    // keeps the sent messages until the hub confirms them
+    SendPipeline sendPipeline;
+    // the time until the adapter should be driven again, UINT32_MAX if its transport has a thread of its own
+    uint32_t doWorkTimeout;
 
 } EventPublisherTask;
 
@@ -42,10 +51,26 @@ typedef struct _EventPublisherTask {
 void EventPublisherTask_Deinit(EventPublisherTask* task);
 
 /**
- * @brief Executes the given task.
+ * @brief Executes the given task. The messages are sent, and then the adapter is driven once for all of them.
  * 
  * @param   task    The instance of the task to execute.
  */
 void EventPublisherTask_Execute(EventPublisherTask* task);
 
+/**
+ * @brief Blocks until the next send deadline of the task, or until its queues wake it up.
+ *        Operational and high priority events wake the task immediately, other events wake it once their size crosses the max message size.
+ * 
+ * @param   task                The instance of the task.
+ * @param   schedulerInterval   The shortest time to wait when no event wakes the task up, in milliseconds.
+ */
+void EventPublisherTask_Wait(EventPublisherTask* task, uint32_t schedulerInterval);
+
+/**
+ * @brief Wakes up the task if it is waiting, used in order to stop it.
+ * 
+ * @param   task    The instance of the task.
+ */
+void EventPublisherTask_Wake(EventPublisherTask* task);
+
 #endif //EVENT_PUBLISHER_TASK_H
\ No newline at end of file
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+
+/**
+ * @brief Called from the advance of the wheel when a timer expires.
+ *
+ * @param   context     The context which was set on the timer.
+ */
+typedef void (*TimerWheelCallback)(void* context);
+
+/**
+ * A timer of the wheel. The timer is linked into the slots of the wheel, so it must outlive its schedule.
+ */
+typedef struct _TimerWheelTimer {
+
+    uint64_t expiry;
+    TimerWheelCallback callback;
+    void* context;
+    struct _TimerWheelTimer* next;
+    // points at the link which points at this timer, NULL while the timer is not scheduled
+    struct _TimerWheelTimer** pprev;
+
+} TimerWheelTimer;
+
+/**
+ * A hierarchical timer wheel, the times are in ticks of the caller.
+ * Level 0 holds the timers which expire within the current 64 ticks, each higher level covers 64 times the range of the level below it.
+ * The timers of a higher level slot are cascaded down once the wheel reaches the slot, so scheduling and canceling are O(1).
+ * Timers beyond the range of the top level are kept aside until the top level wraps.
+ */
+typedef struct _TimerWheel {
+
+    // the last tick which was advanced
+    uint64_t now;
+    uint32_t numberOfTimers;
+    TimerWheelTimer* slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    TimerWheelTimer* overflow;
+
+} TimerWheel;
+
+/**
+ * @brief Initiate an empty wheel.
+ *
+ * @param   wheel   The instance to initiate.
+ * @param   now     The current tick.
+ */
+MOCKABLE_FUNCTION(, void, TimerWheel_Init, TimerWheel*, wheel, uint64_t, now);
+
+/**
+ * @brief Initiate a timer which is not scheduled.
+ *
+ * @param   timer       The instance to initiate.
+ * @param   callback    The function to call when the timer expires.
+ * @param   context     The context to pass to the callback.
+ */
+MOCKABLE_FUNCTION(, void, TimerWheel_InitTimer, TimerWheelTimer*, timer, TimerWheelCallback, callback, void*, context);
+
+/**
+ * @brief Schedules the timer, a timer which is already scheduled is moved. Expiries which are not in the future expire on the next tick.
+ *
+ * @param   wheel   The wheel.
+ * @param   timer   The timer.
+ * @param   expiry  The tick on which the timer expires.
+ */
+MOCKABLE_FUNCTION(, void, TimerWheel_Schedule, TimerWheel*, wheel, TimerWheelTimer*, timer, uint64_t, expiry);
+
+/**
+ * @brief Cancels the timer, does nothing if the timer is not scheduled.
+ *
+ * @param   wheel   The wheel.
+ * @param   timer   The timer.
+ */
+MOCKABLE_FUNCTION(, void, TimerWheel_Cancel, TimerWheel*, wheel, TimerWheelTimer*, timer);
+
+/**
+ * @brief Returns whether the timer is scheduled.
+ *
+ * @param   timer   The timer.
+ */
+MOCKABLE_FUNCTION(, bool, TimerWheel_IsScheduled, TimerWheelTimer*, timer);
+
+/**
+ * @brief Advances the wheel up to the given tick and calls the callbacks of the expired timers, in the order of their expiries.
+ *        The callbacks may schedule and cancel timers. Does nothing if the tick is in the past.
+ *
+ * @param   wheel   The wheel.
+ * @param   now     The current tick.
+ */
+MOCKABLE_FUNCTION(, void, TimerWheel_Advance, TimerWheel*, wheel, uint64_t, now);
+
+#endif //TIMER_WHEEL_H
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef TRACKED_ALLOCATOR_H
+#define TRACKED_ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * The subsystems whose heap memory is accounted for by the memory monitor, on top of the queued events.
+ */
+typedef enum _AllocationTag {
+    ALLOCATION_TAG_JSON,
+    ALLOCATION_TAG_PROCESS_HASHES,
+    ALLOCATION_TAG_BASELINE,
+    ALLOCATION_TAG_AUDIT_STREAM,
+    ALLOCATION_TAG_COUNT
+} AllocationTag;
+
+/**
+ * @brief Allocates memory on behalf of the given subsystem and charges the memory monitor for it.
+ *        The charged size is the usable size of the allocation plus the allocator's chunk header.
+ *        Bounded subsystems (the baseline, the process hash cache and the audit stream) fail if the memory limit is exhausted, the JSON documents are
+ *        always charged since they can not recover from a failed allocation, which leaves less room for the queues.
+ *
+ * @param   tag     The subsystem which owns the allocation.
+ * @param   size    The requested size in bytes.
+ *
+ * @return the allocated memory, or NULL if memory ran out or the subsystem exceeded the limit.
+ */
+MOCKABLE_FUNCTION(, void*, TrackedAllocator_Malloc, AllocationTag, tag, size_t, size);
+
+/**
+ * @brief Frees memory which was allocated by TrackedAllocator_Malloc and releases its charge.
+ *
+ * @param   tag     The subsystem which owns the allocation, must be the one it was allocated with.
+ * @param   ptr     The allocation to free, may be NULL.
+ */
+MOCKABLE_FUNCTION(, void, TrackedAllocator_Free, AllocationTag, tag, void*, ptr);
+
+/**
+ * @brief Charges the given subsystem for memory which was allocated elsewhere, e.g. by a third party container.
+ *        Use TrackedAllocator_EstimateSize to account for the allocator overhead.
+ *
+ * @param   tag     The subsystem which owns the memory.
+ * @param   size    The size in bytes.
+ *
+ * @return true if the memory was charged, false if a bounded subsystem exceeded the limit.
+ */
+MOCKABLE_FUNCTION(, bool, TrackedAllocator_Charge, AllocationTag, tag, uint32_t, size);
+
+/**
+ * @brief Releases a charge which was taken by TrackedAllocator_Charge.
+ *
+ * @param   tag     The subsystem which owns the memory.
+ * @param   size    The size in bytes.
+ */
+MOCKABLE_FUNCTION(, void, TrackedAllocator_Discharge, AllocationTag, tag, uint32_t, size);
+
+/**
+ * @brief Estimates how much heap memory an allocation of the given size really takes, including the chunk header and alignment.
+ *
+ * @param   size    The requested size in bytes.
+ *
+ * @return the estimated size in bytes.
+ */
+MOCKABLE_FUNCTION(, uint32_t, TrackedAllocator_EstimateSize, size_t, size);
+
+/**
+ * @brief Returns the amount of memory the given subsystem is currently charged for.
+ *
+ * @param   tag     The subsystem.
+ *
+ * @return the charged size in bytes.
+ */
+MOCKABLE_FUNCTION(, uint32_t, TrackedAllocator_GetUsage, AllocationTag, tag);
+
+/**
+ * @brief Returns the memory monitor consumption which is not charged to any subsystem, i.e. the memory held by the queued events.
+ *
+ * @param   sizeInBytes     Out param, the untracked consumption in bytes.
+ *
+ * @return true on success, false if the memory monitor could not be read.
+ */
+MOCKABLE_FUNCTION(, bool, TrackedAllocator_GetUntrackedConsumption, uint32_t*, sizeInBytes);
+
+#endif //TRACKED_ALLOCATOR_H
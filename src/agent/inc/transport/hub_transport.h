@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef HUB_TRANSPORT_H
+#define HUB_TRANSPORT_H
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "transport/transport.h"
+
+/**
+ * @brief Returns the transport of the IoT hub module client, over MQTT or AMQP as the agent was built with.
+ *
+ * @return the interface of the transport.
+ */
+MOCKABLE_FUNCTION(, const TransportInterface*, HubTransport_GetInterface);
+
+/**
+ * @brief Returns the transport of the low level IoT hub module client, which has no thread of its own.
+ *        The owner of the transport drives it with DoWork, and serializes the calls to it.
+ *
+ * @return the interface of the transport.
+ */
+MOCKABLE_FUNCTION(, const TransportInterface*, HubTransport_GetLowLevelInterface);
+
+#endif //HUB_TRANSPORT_H
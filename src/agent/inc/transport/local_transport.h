@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef LOCAL_TRANSPORT_H
+#define LOCAL_TRANSPORT_H
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "transport/transport.h"
+
+/**
+ * The interval in milliseconds the local transport checks the twin file for changes.
+ */
+#define LOCAL_TRANSPORT_TWIN_POLL_INTERVAL 1000
+
+/**
+ * @brief Returns the local transport, which runs the agent without a hub, to measure the throughput of the agent and to soak test it.
+ *        The transport writes the delivered messages to the configured sink, a UNIX stream socket if the sink path is one, or a file
+ *        it appends to otherwise. Every record is a header line "<kind> <content type> <content encoding> <size>", with "-" for
+ *        a missing property, followed by the data and a new line. The kind is "message" or "reported".
+ *        The twin file is delivered to the agent as a complete twin once connected, and again whenever it changes, it should be
+ *        replaced with a rename so a half written twin is never delivered.
+ *        Every message is confirmed after the configured latency, and fails with the configured failure rate.
+ *
+ * @return the interface of the transport.
+ */
+MOCKABLE_FUNCTION(, const TransportInterface*, LocalTransport_GetInterface);
+
+#endif //LOCAL_TRANSPORT_H
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stddef.h>
+
+#include "iothub_module_client.h"
+
+/**
+ * A handle to a transport instance, the module client handle for the hub transports.
+ */
+typedef void* TRANSPORT_HANDLE;
+
+/**
+ * The operations the IoTHubAdapter uses to talk to the hub, modeled on the module client API.
+ * The callbacks may be called on a thread of the transport, and a message confirmation may be called before SendEventAsync returns.
+ * Every message which was handed to the transport is confirmed exactly once, with IOTHUB_CLIENT_CONFIRMATION_BECAUSE_DESTROY
+ * if the transport is destroyed before the message is delivered.
+ */
+typedef struct _TransportInterface {
+
+    /**
+     * @brief Creates a transport instance.
+     *
+     * @param   connectionString    The connection string of the module.
+     *
+     * @return a handle to the instance on success, NULL otherwise.
+     */
+    TRANSPORT_HANDLE (*Create)(const char* connectionString);
+
+    /**
+     * @brief Destroys a transport instance and confirms the messages which were not delivered yet.
+     */
+    void (*Destroy)(TRANSPORT_HANDLE handle);
+
+    IOTHUB_CLIENT_RESULT (*SetOption)(TRANSPORT_HANDLE handle, const char* optionName, const void* value);
+    IOTHUB_CLIENT_RESULT (*SetConnectionStatusCallback)(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK connectionStatusCallback, void* context);
+    IOTHUB_CLIENT_RESULT (*SetModuleTwinCallback)(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK moduleTwinCallback, void* context);
+
+    /**
+     * @brief Hands a message to the transport. The message is copied, the caller keeps its ownership.
+     */
+    IOTHUB_CLIENT_RESULT (*SendEventAsync)(TRANSPORT_HANDLE handle, IOTHUB_MESSAGE_HANDLE message, IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK confirmationCallback, void* context);
+
+    IOTHUB_CLIENT_RESULT (*SendReportedState)(TRANSPORT_HANDLE handle, const unsigned char* reportedState, size_t size, IOTHUB_CLIENT_REPORTED_STATE_CALLBACK reportedStateCallback, void* context);
+
+    /**
+     * @brief Sends the pending messages, receives the twin updates and calls the callbacks on the calling thread.
+     *        NULL for a transport which does its work on a thread of its own. Otherwise it is not thread safe,
+     *        and should be called periodically with the calls to the other operations serialized around it.
+     */
+    void (*DoWork)(TRANSPORT_HANDLE handle);
+
+} TransportInterface;
+
+#endif //TRANSPORT_H
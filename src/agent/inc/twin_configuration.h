@@ -114,6 +114,33 @@ MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetBaselineCustom
  */
 MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetBaselineCustomChecksFileHash, char**, baselineCustomChecksFileHash);
 
+/**
+ * @brief   gets messageCompressionEnabled from the twin configuration, thread safe
+ * 
+ * @param   messageCompressionEnabled   out param
+ * 
+ * @return  TWIN_OK                     on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetMessageCompressionEnabled, bool*, messageCompressionEnabled);
+
+/**
+ * @brief   gets columnarMessagesEnabled from the twin configuration, thread safe
+ * 
+ * @param   columnarMessagesEnabled     out param
+ * 
+ * @return  TWIN_OK                     on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetColumnarMessagesEnabled, bool*, columnarMessagesEnabled);
+
+/**
+ * @brief   gets maxInFlightMessages from the twin configuration, thread safe
+ * 
+ * @param   maxInFlightMessages     out param
+ * 
+ * @return  TWIN_OK                 on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetMaxInFlightMessages, uint32_t*, maxInFlightMessages);
+
 /**
  * @brief   gets serialized twin configuration
  * 
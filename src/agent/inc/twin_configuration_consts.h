@@ -10,6 +10,9 @@ extern const char* HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY;
 extern const char* MAX_LOCAL_CACHE_SIZE_KEY;
 extern const char* MAX_MESSAGE_SIZE_KEY;
 extern const char* SNAPSHOT_FREQUENCY_KEY;
+extern const char* MESSAGE_COMPRESSION_ENABLED_KEY;
+extern const char* COLUMNAR_MESSAGES_ENABLED_KEY;
+extern const char* MAX_IN_FLIGHT_MESSAGES_KEY;
 extern const char* HUB_RESOURCE_ID_KEY;
 extern const char* EVENT_PROPERTIES_KEY;
 
@@ -31,6 +34,18 @@ extern const char* PROCESS_CREATE_AGGREGATION_INTERVAL_KEY;
 extern const char* CONNECTION_CREATE_AGGREGATION_ENABLED_KEY;
 extern const char* CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY;
 
+/* ===== Snapshot Schedule Schema =====*/
+extern const char* LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY;
+extern const char* LISTENING_PORTS_SNAPSHOT_OFFSET_KEY;
+extern const char* FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY;
+extern const char* FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY;
+extern const char* BASELINE_SNAPSHOT_INTERVAL_KEY;
+extern const char* BASELINE_SNAPSHOT_OFFSET_KEY;
+extern const char* LOCAL_USERS_SNAPSHOT_INTERVAL_KEY;
+extern const char* LOCAL_USERS_SNAPSHOT_OFFSET_KEY;
+extern const char* SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY;
+extern const char* SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY;
+
 /* ===== Baseline custom checks configuration =====*/
 extern const char* BASELINE_CUSTOM_CHECKS_ENABLED_KEY;
 extern const char* BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY;
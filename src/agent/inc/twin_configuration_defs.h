@@ -37,6 +37,9 @@ typedef struct _TwinConfigurationBundleStatus {
     TwinConfigurationStatus baselineCustomChecksEnabled;
     TwinConfigurationStatus baselineCustomChecksFilePath;
     TwinConfigurationStatus baselineCustomChecksFileHash;
+    TwinConfigurationStatus messageCompressionEnabled;
+    TwinConfigurationStatus columnarMessagesEnabled;
+    TwinConfigurationStatus maxInFlightMessages;
  } TwinConfigurationBundleStatus;
 
  typedef enum _TwinConfigurationEventType {
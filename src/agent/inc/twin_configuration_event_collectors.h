@@ -11,6 +11,7 @@
 #include "twin_configuration_defs.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "json/json_object_reader.h"
 #include "json/json_object_writer.h"
@@ -24,6 +25,18 @@ typedef enum _TwinConfigurationEventPriority {
 
 } TwinConfigurationEventPriority;
 
+/**
+ * The schedule of a periodic collector, in milliseconds.
+ */
+typedef struct _TwinConfigurationSnapshotSchedule {
+
+    // 0 means the collector follows the snapshot frequency
+    uint32_t interval;
+    // the delay of the first collection after the agent starts, 0 means the collectors are spread over the interval
+    uint32_t offset;
+
+} TwinConfigurationSnapshotSchedule;
+
 /**
  * @brief initialize the global event priorities configuration with default values
  * 
@@ -84,4 +97,14 @@ MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_Ge
  */
 MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_GetAggregationInterval, TwinConfigurationEventType, eventType, uint32_t*, interval);
 
+/**
+ * @brief Returns the snapshot schedule of the wanted event type. Event types without a configurable schedule follow the snapshot frequency.
+ * 
+ * @param   eventType   The wanted event type.
+ * @param   schedule    Out param. The wanted schedule.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_GetSnapshotSchedule, TwinConfigurationEventType, eventType, TwinConfigurationSnapshotSchedule*, schedule);
+
 #endif //TWIN_CONFIGURATION_EVENT_COLLECTORS_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * The maximal number of threads of a single pool.
+ */
+#define WORKER_POOL_MAX_THREADS 4
+
+typedef enum _WorkerPoolResult {
+
+    WORKER_POOL_OK,
+    // the job is still queued or running from a previous submit
+    WORKER_POOL_JOB_BUSY,
+    WORKER_POOL_EXCEPTION
+
+} WorkerPoolResult;
+
+/**
+ * @brief Runs a job, called on a thread of the pool.
+ *
+ * @param   context     The context of the job.
+ */
+typedef void (*WorkerPoolJobFunc)(void* context);
+
+/**
+ * A job which is run by a pool. The job is linked into the queue of the pool, so it must outlive the pool.
+ */
+typedef struct _WorkerPoolJob {
+
+    WorkerPoolJobFunc function;
+    void* context;
+    // the job is queued or running, protected by the lock of the pool
+    bool busy;
+    struct _WorkerPoolJob* next;
+
+} WorkerPoolJob;
+
+/**
+ * Runs jobs on a fixed number of threads.
+ * A job is never queued or run twice at the same time, so a job which runs longer than the interval it is submitted on does not pile up,
+ * and the queue is bounded by the number of jobs.
+ */
+typedef struct _WorkerPool {
+
+    LOCK_HANDLE lock;
+    COND_HANDLE condition;
+    THREAD_HANDLE threads[WORKER_POOL_MAX_THREADS];
+    uint32_t numberOfThreads;
+    bool stop;
+    WorkerPoolJob* head;
+    WorkerPoolJob* tail;
+
+} WorkerPool;
+
+/**
+ * @brief Initiate a job.
+ *
+ * @param   job         The instance to initiate.
+ * @param   function    The function of the job.
+ * @param   context     The context to pass to the function.
+ */
+MOCKABLE_FUNCTION(, void, WorkerPool_InitJob, WorkerPoolJob*, job, WorkerPoolJobFunc, function, void*, context);
+
+/**
+ * @brief Initiate the pool and start its threads.
+ *
+ * @param   pool                The instance to initiate.
+ * @param   numberOfThreads     The number of threads, at most WORKER_POOL_MAX_THREADS.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, WorkerPool_Init, WorkerPool*, pool, uint32_t, numberOfThreads);
+
+/**
+ * @brief Stops the threads of the pool, waiting for the jobs which are running. Jobs which are still queued are dropped.
+ *
+ * @param   pool    The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, WorkerPool_Deinit, WorkerPool*, pool);
+
+/**
+ * @brief Queues the job to run on one of the threads of the pool.
+ *
+ * @param   pool    The pool.
+ * @param   job     The job.
+ *
+ * @return WORKER_POOL_OK if the job was queued, WORKER_POOL_JOB_BUSY if it is already queued or running, WORKER_POOL_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, WorkerPoolResult, WorkerPool_Submit, WorkerPool*, pool, WorkerPoolJob*, job);
+
+#endif //WORKER_POOL_H
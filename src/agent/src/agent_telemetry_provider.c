@@ -4,6 +4,8 @@
 
 #include "agent_telemetry_provider.h"
 
+#include "memory_monitor.h"
+
 /*
  * Agent telemetry provider object definition
  */
@@ -11,6 +13,7 @@ typedef struct _AgentTelemetryProvider {
     SyncedCounter* lowPriorityQueueCounter;
     SyncedCounter* highPriorityQueueCounter;
     SyncedCounter* iotHubCounter;
+    SyncedCounter* evictionCounter;
 } AgentTelemetryProvider;
 
 /*
@@ -18,10 +21,11 @@ typedef struct _AgentTelemetryProvider {
  */
 static AgentTelemetryProvider agentTelemetryProvider = { 0 };
 
-AgentTelemetryProviderResult AgentTelemetryProvider_Init(SyncedCounter* lowPriorityQueueCounter, SyncedCounter* highPriorityQueueCounter, SyncedCounter* iotHubCounter) {
+AgentTelemetryProviderResult AgentTelemetryProvider_Init(SyncedCounter* lowPriorityQueueCounter, SyncedCounter* highPriorityQueueCounter, SyncedCounter* iotHubCounter, SyncedCounter* evictionCounter) {
     agentTelemetryProvider.lowPriorityQueueCounter = lowPriorityQueueCounter;
     agentTelemetryProvider.highPriorityQueueCounter = highPriorityQueueCounter;
     agentTelemetryProvider.iotHubCounter = iotHubCounter;
+    agentTelemetryProvider.evictionCounter = evictionCounter;
     
     return TELEMETRY_PROVIDER_OK;
 }
@@ -30,6 +34,7 @@ void AgentTelemetryProvider_Deinit() {
     agentTelemetryProvider.lowPriorityQueueCounter = NULL;
     agentTelemetryProvider.highPriorityQueueCounter = NULL;;
     agentTelemetryProvider.iotHubCounter = NULL;
+    agentTelemetryProvider.evictionCounter = NULL;
 }
 
 AgentTelemetryProviderResult AgentTelemetryProvider_GetQueueCounterData(AgentQueueMeter queue, QueueCounter* counterData) {
@@ -64,6 +69,49 @@ AgentTelemetryProviderResult AgentTelemetryProvider_GetMessageCounterData(Messag
     counterData->failedMessages = data.messageCounter.failedMessages;
     counterData->smallMessages = data.messageCounter.smallMessages;
     counterData->sentMessages = data.messageCounter.sentMessages;
+    counterData->sentBytes = data.messageCounter.sentBytes;
+    counterData->billedBytes = data.messageCounter.billedBytes;
+    counterData->reconnectAttempts = data.messageCounter.reconnectAttempts;
+    counterData->disconnectedTime = data.messageCounter.disconnectedTime;
 cleanup:
     return result;
+}
+
+AgentTelemetryProviderResult AgentTelemetryProvider_GetEvictionCounterData(EvictionCounter* counterData) {
+    AgentTelemetryProviderResult result = TELEMETRY_PROVIDER_OK;
+    Counter data;
+    if (AgentTelemetryCounter_SnapshotAndReset(agentTelemetryProvider.evictionCounter, &data) == false) {
+        result = TELEMETRY_PROVIDER_EXCEPTION;
+        goto cleanup;
+    }
+
+    *counterData = data.evictionCounter;
+cleanup:
+    return result;
+}
+
+AgentTelemetryProviderResult AgentTelemetryProvider_GetMemoryConsumption(MemoryConsumption* consumption) {
+    AgentTelemetryProviderResult result = TELEMETRY_PROVIDER_OK;
+    uint32_t totalConsumption = 0;
+    if (MemoryMonitor_CurrentConsumption(&totalConsumption) != MEMORY_MONITOR_OK) {
+        result = TELEMETRY_PROVIDER_EXCEPTION;
+        goto cleanup;
+    }
+
+    // whatever is not charged to a subsystem was consumed by the queued events
+    uint32_t trackedConsumption = 0;
+    for (uint32_t tag = 0; tag < ALLOCATION_TAG_COUNT; ++tag) {
+        consumption->subsystems[tag] = TrackedAllocator_GetUsage(tag);
+        trackedConsumption += consumption->subsystems[tag];
+    }
+    consumption->queues = totalConsumption > trackedConsumption ? totalConsumption - trackedConsumption : 0;
+cleanup:
+    return result;
+}
+
+AgentTelemetryProviderResult AgentTelemetryProvider_GetCollectorStatistics(CollectorStatistics* statistics) {
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        CollectorExecution_GetStatistics(id, &statistics[id]);
+    }
+    return TELEMETRY_PROVIDER_OK;
 }
\ No newline at end of file
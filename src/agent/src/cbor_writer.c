@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "cbor_writer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CBOR_MAJOR_TYPE_UNSIGNED 0x00
+#define CBOR_MAJOR_TYPE_NEGATIVE 0x20
+#define CBOR_MAJOR_TYPE_TEXT 0x60
+#define CBOR_MAJOR_TYPE_ARRAY 0x80
+#define CBOR_MAJOR_TYPE_MAP 0xA0
+#define CBOR_FALSE 0xF4
+#define CBOR_TRUE 0xF5
+#define CBOR_NULL 0xF6
+#define CBOR_FLOAT32 0xFA
+#define CBOR_FLOAT64 0xFB
+#define CBOR_BREAK 0xFF
+#define CBOR_INDEFINITE_LENGTH 0x1F
+
+// the integral doubles which an int64 holds exactly, [-2^63, 2^63)
+#define CBOR_INT64_LIMIT 9223372036854775808.0
+
+/**
+ * @brief Makes room for the given number of bytes, moving the data to the heap once it outgrows the inline buffer.
+ *
+ * @param   writer      The writer.
+ * @param   size        The number of bytes to make room for.
+ *
+ * @return the position to write the bytes to, or NULL if memory ran out.
+ */
+static uint8_t* CborWriter_Reserve(CborWriter* writer, uint32_t size);
+
+/**
+ * @brief Writes the head of a data item, the major type with its argument in the shortest form.
+ */
+static bool CborWriter_WriteHead(CborWriter* writer, uint8_t majorType, uint64_t argument);
+
+/**
+ * @brief Writes the given bytes.
+ */
+static bool CborWriter_WriteBytes(CborWriter* writer, const void* data, uint32_t size);
+
+void CborWriter_Init(CborWriter* writer) {
+    writer->heapData = NULL;
+    writer->size = 0;
+    writer->capacity = CBOR_WRITER_INLINE_SIZE;
+    writer->failed = false;
+}
+
+void CborWriter_Deinit(CborWriter* writer) {
+    if (writer->heapData != NULL) {
+        free(writer->heapData);
+        writer->heapData = NULL;
+    }
+    writer->size = 0;
+    writer->capacity = CBOR_WRITER_INLINE_SIZE;
+}
+
+bool CborWriter_WriteMapHeader(CborWriter* writer, uint32_t count) {
+    return CborWriter_WriteHead(writer, CBOR_MAJOR_TYPE_MAP, count);
+}
+
+bool CborWriter_WriteArrayHeader(CborWriter* writer, uint32_t count) {
+    return CborWriter_WriteHead(writer, CBOR_MAJOR_TYPE_ARRAY, count);
+}
+
+bool CborWriter_BeginIndefiniteArray(CborWriter* writer) {
+    uint8_t head = CBOR_MAJOR_TYPE_ARRAY | CBOR_INDEFINITE_LENGTH;
+    return CborWriter_WriteBytes(writer, &head, 1);
+}
+
+bool CborWriter_WriteBreak(CborWriter* writer) {
+    uint8_t value = CBOR_BREAK;
+    return CborWriter_WriteBytes(writer, &value, 1);
+}
+
+bool CborWriter_WriteString(CborWriter* writer, const char* value) {
+    size_t length = strlen(value);
+    if (length > UINT32_MAX) {
+        writer->failed = true;
+        return false;
+    }
+
+    return CborWriter_WriteHead(writer, CBOR_MAJOR_TYPE_TEXT, length) && CborWriter_WriteBytes(writer, value, (uint32_t)length);
+}
+
+bool CborWriter_WriteInt(CborWriter* writer, int64_t value) {
+    if (value >= 0) {
+        return CborWriter_WriteHead(writer, CBOR_MAJOR_TYPE_UNSIGNED, (uint64_t)value);
+    }
+    // a negative integer n is encoded as -1 - n
+    return CborWriter_WriteHead(writer, CBOR_MAJOR_TYPE_NEGATIVE, (uint64_t)(-1 - value));
+}
+
+bool CborWriter_WriteDouble(CborWriter* writer, double value) {
+    if (value >= -CBOR_INT64_LIMIT && value < CBOR_INT64_LIMIT && value == (double)(int64_t)value) {
+        return CborWriter_WriteInt(writer, (int64_t)value);
+    }
+
+    uint8_t* position = NULL;
+    float singleValue = (float)value;
+    if ((double)singleValue == value) {
+        uint32_t bits = 0;
+        memcpy(&bits, &singleValue, sizeof(bits));
+        position = CborWriter_Reserve(writer, 1 + sizeof(bits));
+        if (position == NULL) {
+            return false;
+        }
+        position[0] = CBOR_FLOAT32;
+        for (uint32_t i = 0; i < sizeof(bits); ++i) {
+            position[1 + i] = (uint8_t)(bits >> (8 * (sizeof(bits) - 1 - i)));
+        }
+        return true;
+    }
+
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    position = CborWriter_Reserve(writer, 1 + sizeof(bits));
+    if (position == NULL) {
+        return false;
+    }
+    position[0] = CBOR_FLOAT64;
+    for (uint32_t i = 0; i < sizeof(bits); ++i) {
+        position[1 + i] = (uint8_t)(bits >> (8 * (sizeof(bits) - 1 - i)));
+    }
+    return true;
+}
+
+bool CborWriter_WriteBool(CborWriter* writer, bool value) {
+    uint8_t simpleValue = value ? CBOR_TRUE : CBOR_FALSE;
+    return CborWriter_WriteBytes(writer, &simpleValue, 1);
+}
+
+bool CborWriter_WriteNull(CborWriter* writer) {
+    uint8_t simpleValue = CBOR_NULL;
+    return CborWriter_WriteBytes(writer, &simpleValue, 1);
+}
+
+bool CborWriter_Finish(CborWriter* writer, JsonBufferAllocateFunc allocate, char** output, uint32_t* size) {
+    if (writer->failed || writer->size == 0) {
+        return false;
+    }
+
+    char* buffer = allocate(writer->size);
+    if (buffer == NULL) {
+        return false;
+    }
+
+    memcpy(buffer, writer->heapData != NULL ? writer->heapData : writer->inlineData, writer->size);
+    *output = buffer;
+    *size = writer->size;
+    return true;
+}
+
+static uint8_t* CborWriter_Reserve(CborWriter* writer, uint32_t size) {
+    if (writer->failed) {
+        return NULL;
+    }
+
+    if (size > UINT32_MAX / 2 - writer->size) {
+        writer->failed = true;
+        return NULL;
+    }
+
+    if (writer->size + size > writer->capacity) {
+        uint32_t capacity = writer->capacity * 2;
+        while (writer->size + size > capacity) {
+            capacity *= 2;
+        }
+
+        uint8_t* newData = realloc(writer->heapData, capacity);
+        if (newData == NULL) {
+            writer->failed = true;
+            return NULL;
+        }
+        if (writer->heapData == NULL) {
+            memcpy(newData, writer->inlineData, writer->size);
+        }
+        writer->heapData = newData;
+        writer->capacity = capacity;
+    }
+
+    uint8_t* position = (writer->heapData != NULL ? writer->heapData : writer->inlineData) + writer->size;
+    writer->size += size;
+    return position;
+}
+
+static bool CborWriter_WriteHead(CborWriter* writer, uint8_t majorType, uint64_t argument) {
+    // arguments below 24 are stored in the initial byte, larger ones follow it in 1, 2, 4 or 8 bytes
+    uint32_t argumentSize = 0;
+    uint8_t additionalInfo = 0;
+    if (argument < 24) {
+        additionalInfo = (uint8_t)argument;
+    } else if (argument <= UINT8_MAX) {
+        additionalInfo = 24;
+        argumentSize = 1;
+    } else if (argument <= UINT16_MAX) {
+        additionalInfo = 25;
+        argumentSize = 2;
+    } else if (argument <= UINT32_MAX) {
+        additionalInfo = 26;
+        argumentSize = 4;
+    } else {
+        additionalInfo = 27;
+        argumentSize = 8;
+    }
+
+    uint8_t* position = CborWriter_Reserve(writer, 1 + argumentSize);
+    if (position == NULL) {
+        return false;
+    }
+
+    position[0] = majorType | additionalInfo;
+    for (uint32_t i = 0; i < argumentSize; ++i) {
+        position[1 + i] = (uint8_t)(argument >> (8 * (argumentSize - 1 - i)));
+    }
+    return true;
+}
+
+static bool CborWriter_WriteBytes(CborWriter* writer, const void* data, uint32_t size) {
+    uint8_t* position = CborWriter_Reserve(writer, size);
+    if (position == NULL) {
+        return false;
+    }
+
+    memcpy(position, data, size);
+    return true;
+}
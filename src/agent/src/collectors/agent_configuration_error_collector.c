@@ -357,7 +357,7 @@ EventCollectorResult AgentConfigurationErrorCollector_PushEvent(SyncQueue* queue
     char* buffer = NULL;
     uint32_t bufferSize = 0;
 
-    if (JsonObjectWriter_Serialize(eventHandle, &buffer, &bufferSize) != JSON_WRITER_OK) {
+    if (GenericEvent_Serialize(eventHandle, &buffer, &bufferSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
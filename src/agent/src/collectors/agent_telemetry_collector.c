@@ -12,6 +12,14 @@
 
 const char* HIGH_PRIO_QUEUE_NAME = "High";
 const char* LOW_PRIO_QUEUE_NAME = "Low";
+const char* AGGREGATED_PRIORITY_NAME = "Aggregated";
+const char* QUEUES_SUBSYSTEM_NAME = "Queues";
+static const char* ALLOCATION_TAG_NAMES[ALLOCATION_TAG_COUNT] = {
+    [ALLOCATION_TAG_JSON] = "Json",
+    [ALLOCATION_TAG_PROCESS_HASHES] = "ProcessHashes",
+    [ALLOCATION_TAG_BASELINE] = "Baseline",
+    [ALLOCATION_TAG_AUDIT_STREAM] = "AuditStream"
+};
 
 /*
  * @brief serializes the event and push it to the queue
@@ -62,6 +70,66 @@ EventCollectorResult AgentTelemetryCollector_AddDroppedEventsEvent(SyncQueue* qu
  */
 EventCollectorResult AgentTelemetryCollector_AddMessageStatisticsEvent(SyncQueue* queue);
 
+/*
+ * @brief creates new evicted events payload
+ * 
+ * @param   priorityName           the priority of the evicted events
+ * @param   evictedEvents          the number of evicted events
+ * @param   JsonArrayWriterHandle  payload handle, the payload will be written in this payload object
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsPayload(const char* priorityName, uint32_t evictedEvents, JsonArrayWriterHandle payloadHandle);
+
+/*
+ * @brief creates new evicted events event and push it to the queue, nothing is pushed if no event was evicted
+ * 
+ * @param   queue       the queue to push the event to.
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsEvent(SyncQueue* queue);
+
+/*
+ * @brief creates new memory consumption payload
+ * 
+ * @param   subsystemName          the subsystem which consumed the memory
+ * @param   allocatedBytes         the memory the subsystem is charged for
+ * @param   JsonArrayWriterHandle  payload handle, the payload will be written in this payload object
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddMemoryConsumptionPayload(const char* subsystemName, uint32_t allocatedBytes, JsonArrayWriterHandle payloadHandle);
+
+/*
+ * @brief creates new memory consumption event and push it to the queue
+ * 
+ * @param   queue       the queue to push the event to.
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddMemoryConsumptionEvent(SyncQueue* queue);
+
+/*
+ * @brief creates new collector statistics payload
+ * 
+ * @param   id                     the collector
+ * @param   statistics             the execution statistics of the collector
+ * @param   JsonArrayWriterHandle  payload handle, the payload will be written in this payload object
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddCollectorStatisticsPayload(CollectorId id, CollectorStatistics* statistics, JsonArrayWriterHandle payloadHandle);
+
+/*
+ * @brief creates new collector statistics event and push it to the queue, nothing is pushed if no collector was scheduled
+ * 
+ * @param   queue       the queue to push the event to.
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddCollectorStatisticsEvent(SyncQueue* queue);
+
 EventCollectorResult AgentTelemetryCollector_GetEvents(SyncQueue* priorityQueue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
 
@@ -75,6 +143,21 @@ EventCollectorResult AgentTelemetryCollector_GetEvents(SyncQueue* priorityQueue)
         goto cleanup;
     }
 
+    result = AgentTelemetryCollector_AddEvictedEventsEvent(priorityQueue);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_AddMemoryConsumptionEvent(priorityQueue);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_AddCollectorStatisticsEvent(priorityQueue);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
 cleanup:
     return result;
 }
@@ -201,12 +284,207 @@ cleanup:
     return result;
 }
 
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsEvent(SyncQueue* queue){
+    JsonObjectWriterHandle eventHandle = NULL;
+    JsonArrayWriterHandle payloadHandle = NULL;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    EvictionCounter counterData = {0};
+    if (AgentTelemetryProvider_GetEvictionCounterData(&counterData) != TELEMETRY_PROVIDER_OK){
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (counterData.lowPriority == 0 && counterData.aggregated == 0 && counterData.highPriority == 0) {
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_Init(&eventHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddMetadata(eventHandle, EVENT_PERIODIC_CATEGORY, AGENT_TELEMETRY_EVICTED_EVENTS_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&payloadHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_AddEvictedEventsPayload(LOW_PRIO_QUEUE_NAME, counterData.lowPriority, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_AddEvictedEventsPayload(AGGREGATED_PRIORITY_NAME, counterData.aggregated, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_AddEvictedEventsPayload(HIGH_PRIO_QUEUE_NAME, counterData.highPriority, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddPayload(eventHandle, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_PushEvent(queue, eventHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadHandle != NULL){
+        JsonArrayWriter_Deinit(payloadHandle);
+    }
+
+    if (eventHandle != NULL){
+        JsonObjectWriter_Deinit(eventHandle);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddMemoryConsumptionEvent(SyncQueue* queue){
+    JsonObjectWriterHandle eventHandle = NULL;
+    JsonArrayWriterHandle payloadHandle = NULL;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    MemoryConsumption consumption = {0};
+    if (AgentTelemetryProvider_GetMemoryConsumption(&consumption) != TELEMETRY_PROVIDER_OK){
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_Init(&eventHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddMetadata(eventHandle, EVENT_PERIODIC_CATEGORY, AGENT_TELEMETRY_MEMORY_CONSUMPTION_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_MEMORY_CONSUMPTION_SCHEMA_VERSION);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&payloadHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_AddMemoryConsumptionPayload(QUEUES_SUBSYSTEM_NAME, consumption.queues, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    for (uint32_t tag = 0; tag < ALLOCATION_TAG_COUNT; ++tag) {
+        result = AgentTelemetryCollector_AddMemoryConsumptionPayload(ALLOCATION_TAG_NAMES[tag], consumption.subsystems[tag], payloadHandle);
+        if (result != EVENT_COLLECTOR_OK){
+            goto cleanup;
+        }
+    }
+
+    result = GenericEvent_AddPayload(eventHandle, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_PushEvent(queue, eventHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadHandle != NULL){
+        JsonArrayWriter_Deinit(payloadHandle);
+    }
+
+    if (eventHandle != NULL){
+        JsonObjectWriter_Deinit(eventHandle);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddCollectorStatisticsEvent(SyncQueue* queue){
+    JsonObjectWriterHandle eventHandle = NULL;
+    JsonArrayWriterHandle payloadHandle = NULL;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    CollectorStatistics statistics[COLLECTOR_COUNT] = {{0}};
+    if (AgentTelemetryProvider_GetCollectorStatistics(statistics) != TELEMETRY_PROVIDER_OK){
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    bool active = false;
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        active = active || statistics[id].runs > 0 || statistics[id].skipped > 0;
+    }
+    if (!active) {
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_Init(&eventHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddMetadata(eventHandle, EVENT_PERIODIC_CATEGORY, AGENT_TELEMETRY_COLLECTOR_STATISTICS_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_COLLECTOR_STATISTICS_SCHEMA_VERSION);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&payloadHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    // only the collectors which were scheduled since the previous event are reported
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        if (statistics[id].runs == 0 && statistics[id].skipped == 0) {
+            continue;
+        }
+
+        result = AgentTelemetryCollector_AddCollectorStatisticsPayload(id, &statistics[id], payloadHandle);
+        if (result != EVENT_COLLECTOR_OK){
+            goto cleanup;
+        }
+    }
+
+    result = GenericEvent_AddPayload(eventHandle, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_PushEvent(queue, eventHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadHandle != NULL){
+        JsonArrayWriter_Deinit(payloadHandle);
+    }
+
+    if (eventHandle != NULL){
+        JsonObjectWriter_Deinit(eventHandle);
+    }
+
+    return result;
+}
+
 EventCollectorResult AgentTelemetryCollector_PushEvent(SyncQueue* queue, JsonObjectWriterHandle eventHandle){
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     char* buffer = NULL;
     uint32_t bufferSize = 0;
 
-    if (JsonObjectWriter_Serialize(eventHandle, &buffer, &bufferSize) != JSON_WRITER_OK) {
+    if (GenericEvent_Serialize(eventHandle, &buffer, &bufferSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
@@ -280,12 +558,146 @@ EventCollectorResult AgentTelemetryCollector_AddMessageStatisticsPayload(Message
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+
+    // the share of the billed bytes which carried data
+    uint32_t fillRatio = counterData->billedBytes == 0 ? 0 : (uint32_t)((uint64_t)counterData->sentBytes * 100 / counterData->billedBytes);
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_MESSAGES_FILL_RATIO_KEY, fillRatio) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_RECONNECT_ATTEMPTS_KEY, counterData->reconnectAttempts) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_DISCONNECTED_TIME_KEY, counterData->disconnectedTime) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
     
     if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
+cleanup:
+    if (payloadObject != NULL) {
+        JsonObjectWriter_Deinit(payloadObject);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsPayload(const char* priorityName, uint32_t evictedEvents, JsonArrayWriterHandle payloadHandle){
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle payloadObject = NULL;
+
+    if (JsonObjectWriter_Init(&payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteString(payloadObject, AGENT_TELEMETRY_PRIORITY_KEY, priorityName) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_EVICTED_EVENTS_KEY, evictedEvents) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadObject != NULL) {
+        JsonObjectWriter_Deinit(payloadObject);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddMemoryConsumptionPayload(const char* subsystemName, uint32_t allocatedBytes, JsonArrayWriterHandle payloadHandle){
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle payloadObject = NULL;
+
+    if (JsonObjectWriter_Init(&payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteString(payloadObject, AGENT_TELEMETRY_SUBSYSTEM_KEY, subsystemName) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, allocatedBytes) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadObject != NULL) {
+        JsonObjectWriter_Deinit(payloadObject);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddCollectorStatisticsPayload(CollectorId id, CollectorStatistics* statistics, JsonArrayWriterHandle payloadHandle){
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle payloadObject = NULL;
+
+    if (JsonObjectWriter_Init(&payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteString(payloadObject, AGENT_TELEMETRY_COLLECTOR_KEY, CollectorExecution_GetName(id)) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_COLLECTOR_RUNS_KEY, statistics->runs) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_COLLECTOR_OVERRUNS_KEY, statistics->overruns) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_COLLECTOR_SKIPPED_KEY, statistics->skipped) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    uint32_t averageDuration = statistics->runs == 0 ? 0 : (uint32_t)(statistics->totalDuration / statistics->runs);
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_COLLECTOR_AVERAGE_DURATION_KEY, averageDuration) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_COLLECTOR_MAX_DURATION_KEY, statistics->maxDuration) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
 cleanup:
     if (payloadObject != NULL) {
         JsonObjectWriter_Deinit(payloadObject);
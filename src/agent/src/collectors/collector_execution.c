@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "collectors/collector_execution.h"
+
+#include <time.h>
+
+#include "logger.h"
+
+/**
+ * The state of a collector, shared between the thread which runs it and the watchdog.
+ * A collector runs on a single thread at a time, so only the statistics and the cancellation are updated concurrently.
+ */
+typedef struct _CollectorExecution {
+
+    bool running;
+    // set once per run, by whoever noticed the overrun first
+    bool canceled;
+    uint32_t budget;
+    // 0 for no budget
+    uint64_t deadline;
+    CollectorStatistics statistics;
+
+} CollectorExecution;
+
+static const char* COLLECTOR_NAMES[COLLECTOR_COUNT] = {
+    [COLLECTOR_AGENT_TELEMETRY] = "AgentTelemetry",
+    [COLLECTOR_LOCAL_USERS] = "LocalUsers",
+    [COLLECTOR_SYSTEM_INFORMATION] = "SystemInformation",
+    [COLLECTOR_LISTENING_PORTS] = "ListeningPorts",
+    [COLLECTOR_FIREWALL] = "FirewallConfiguration",
+    [COLLECTOR_BASELINE] = "Baseline",
+    [COLLECTOR_AGENT_CONFIGURATION_ERROR] = "AgentConfigurationError",
+    [COLLECTOR_PROCESS_CREATION] = "ProcessCreate",
+    [COLLECTOR_USER_LOGIN] = "UserLogin",
+    [COLLECTOR_CONNECTION_CREATE] = "ConnectionCreate",
+    [COLLECTOR_DIAGNOSTIC] = "Diagnostic"
+};
+
+static CollectorExecution executions[COLLECTOR_COUNT];
+
+// the collector which runs on the calling thread, so the loops of the collectors do not need to pass it around
+static __thread CollectorExecution* currentExecution = NULL;
+
+/**
+ * @brief Returns the current time of a monotonic clock in milliseconds.
+ */
+static uint64_t CollectorExecution_GetTime();
+
+/**
+ * @brief Cancels the execution if it is past its deadline. The overrun is counted once per run.
+ *
+ * @param   execution   The execution.
+ * @param   now         The current time.
+ *
+ * @return true if the execution is canceled, false otherwise.
+ */
+static bool CollectorExecution_CancelIfOverrun(CollectorExecution* execution, uint64_t now);
+
+const char* CollectorExecution_GetName(CollectorId id) {
+    return id < COLLECTOR_COUNT ? COLLECTOR_NAMES[id] : "Unknown";
+}
+
+EventCollectorResult CollectorExecution_Run(CollectorId id, EventCollectorFunc collectFunction, SyncQueue* queue, uint32_t budget) {
+    CollectorExecution* execution = &executions[id];
+    uint64_t start = CollectorExecution_GetTime();
+
+    __atomic_store_n(&execution->canceled, false, __ATOMIC_RELAXED);
+    __atomic_store_n(&execution->budget, budget, __ATOMIC_RELAXED);
+    __atomic_store_n(&execution->deadline, budget > 0 ? start + budget : 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&execution->running, true, __ATOMIC_RELEASE);
+    currentExecution = execution;
+
+    EventCollectorResult result = collectFunction(queue);
+
+    currentExecution = NULL;
+    __atomic_store_n(&execution->running, false, __ATOMIC_RELEASE);
+
+    uint64_t end = CollectorExecution_GetTime();
+    // a collector which does not check its cancellation still counts as an overrun
+    CollectorExecution_CancelIfOverrun(execution, end);
+
+    uint32_t duration = (uint32_t)(end - start);
+    __atomic_add_fetch(&execution->statistics.runs, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&execution->statistics.totalDuration, duration, __ATOMIC_RELAXED);
+    uint32_t maxDuration = __atomic_load_n(&execution->statistics.maxDuration, __ATOMIC_RELAXED);
+    while (duration > maxDuration &&
+        !__atomic_compare_exchange_n(&execution->statistics.maxDuration, &maxDuration, duration, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return result;
+}
+
+bool CollectorExecution_IsCanceled() {
+    CollectorExecution* execution = currentExecution;
+    if (execution == NULL) {
+        return false;
+    }
+
+    if (__atomic_load_n(&execution->canceled, __ATOMIC_RELAXED)) {
+        return true;
+    }
+
+    return CollectorExecution_CancelIfOverrun(execution, CollectorExecution_GetTime());
+}
+
+bool CollectorExecution_GetCurrent(CollectorId* id) {
+    CollectorExecution* execution = currentExecution;
+    if (execution == NULL) {
+        return false;
+    }
+
+    *id = (CollectorId)(execution - executions);
+    return true;
+}
+
+void CollectorExecution_Watchdog() {
+    uint64_t now = CollectorExecution_GetTime();
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        CollectorExecution* execution = &executions[id];
+        if (__atomic_load_n(&execution->running, __ATOMIC_ACQUIRE)) {
+            CollectorExecution_CancelIfOverrun(execution, now);
+        }
+    }
+}
+
+void CollectorExecution_ReportSkipped(CollectorId id) {
+    __atomic_add_fetch(&executions[id].statistics.skipped, 1, __ATOMIC_RELAXED);
+}
+
+void CollectorExecution_GetStatistics(CollectorId id, CollectorStatistics* statistics) {
+    CollectorStatistics* current = &executions[id].statistics;
+    statistics->runs = __atomic_exchange_n(&current->runs, 0, __ATOMIC_RELAXED);
+    statistics->overruns = __atomic_exchange_n(&current->overruns, 0, __ATOMIC_RELAXED);
+    statistics->skipped = __atomic_exchange_n(&current->skipped, 0, __ATOMIC_RELAXED);
+    statistics->totalDuration = __atomic_exchange_n(&current->totalDuration, 0, __ATOMIC_RELAXED);
+    statistics->maxDuration = __atomic_exchange_n(&current->maxDuration, 0, __ATOMIC_RELAXED);
+}
+
+static bool CollectorExecution_CancelIfOverrun(CollectorExecution* execution, uint64_t now) {
+    uint64_t deadline = __atomic_load_n(&execution->deadline, __ATOMIC_RELAXED);
+    if (deadline == 0 || now <= deadline) {
+        return false;
+    }
+
+    if (!__atomic_exchange_n(&execution->canceled, true, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&execution->statistics.overruns, 1, __ATOMIC_RELAXED);
+        Logger_Warning("The %s collector ran past its budget of %u milliseconds, it is canceled",
+            COLLECTOR_NAMES[execution - executions], __atomic_load_n(&execution->budget, __ATOMIC_RELAXED));
+    }
+    return true;
+}
+
+static uint64_t CollectorExecution_GetTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
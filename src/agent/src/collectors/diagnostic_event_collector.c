@@ -129,35 +129,28 @@ cleanup:
 }
 
 EventCollectorResult DiagnosticEventCollector_GetEvents(SyncQueue* priorityQueue) {
-    uint32_t eventQueueSize;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    SyncQueueBatch batch;
     DiagnosticEvent* event = NULL;
     uint32_t eventSize;
 
-    if (SyncQueue_GetSize(diagnosticEventCollector.eventsQueue, &eventQueueSize) != QUEUE_OK) {
+    int queueResult = SyncQueue_PopBatchIf(diagnosticEventCollector.eventsQueue, NULL, NULL, UINT32_MAX, &batch);
+    if (queueResult == QUEUE_IS_EMPTY) {
+        return EVENT_COLLECTOR_OK;
+    } else if (queueResult != QUEUE_OK) {
         return EVENT_COLLECTOR_EXCEPTION;
     }
 
-    for (int counter = eventQueueSize; counter > 0; counter--) {
-        event = NULL;
-        int queueResult = SyncQueue_PopFront(diagnosticEventCollector.eventsQueue, (void**)&event, &eventSize);
-
-        // this case can only happen if the queue had been popped by another thread, this shouldn't happen in the current implementation
-        if (queueResult == QUEUE_IS_EMPTY) {
-            return EVENT_COLLECTOR_OK;
-        } else if (queueResult != QUEUE_OK) {
-            return EVENT_COLLECTOR_EXCEPTION;
+    // the batch owns the events, so it is drained even if one of them fails
+    while (SyncQueue_BatchPopFront(&batch, (void**)&event, &eventSize) == QUEUE_OK) {
+        if (DiagnosticEventCollector_GetSingleEvent(event, priorityQueue) != EVENT_COLLECTOR_OK) {
+            result = EVENT_COLLECTOR_EXCEPTION;
         }
 
-        EventCollectorResult result = DiagnosticEventCollector_GetSingleEvent(event, priorityQueue);
-
         DiagnosticEventCollector_DeinitDiagnosticEvent(event);
-
-        if (result != EVENT_COLLECTOR_OK) {
-            return EVENT_COLLECTOR_EXCEPTION;
-        }
     }
 
-    return EVENT_COLLECTOR_OK;
+    return result;
 }
 
 EventCollectorResult DiagnosticEventCollector_AddPayload(DiagnosticEvent* event, JsonArrayWriterHandle diagnosticEventsArray) {
@@ -239,14 +232,14 @@ EventCollectorResult DiagnosticEventCollector_GetSingleEvent(DiagnosticEvent* ev
         goto cleanup;
     }
 
-    if (JsonObjectWriter_Serialize(rootObject, &buffer, &bufferSize) != JSON_WRITER_OK) {
+    if (GenericEvent_SerializeWithAllocator(rootObject, Queue_AllocateData, Queue_FreeData, &buffer, &bufferSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
     if (SyncQueue_PushBack(priorityQueue, buffer, bufferSize) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
-        free(buffer);
+        Queue_FreeData(buffer);
         goto cleanup;
     }
 
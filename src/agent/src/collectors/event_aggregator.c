@@ -380,14 +380,15 @@ EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregato
     }
     
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(event, &output, &outputSize) != JSON_WRITER_OK) {
+    if (GenericEvent_SerializeWithAllocator(event, Queue_AllocateData, Queue_FreeData, &output, &outputSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
     }
     
-    QueueResultValues qResult = SyncQueue_PushBack(queue, output, outputSize);
+    QueueResultValues qResult = SyncQueue_PushBackWithPriority(queue, output, outputSize, QUEUE_PRIORITY_AGGREGATED);
     if (qResult == QUEUE_MAX_MEMORY_EXCEEDED) {
         Logger_Warning("Memory limit exceeded, dropping event");
+        Queue_FreeData(output);
         result = EVENT_AGGREGATOR_OK;
         goto cleanup;
     } else if (qResult != QUEUE_OK){
@@ -398,7 +399,7 @@ EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregato
 cleanup:
     if (result != EVENT_AGGREGATOR_OK) {
         if (output != NULL) {
-            free(output);
+            Queue_FreeData(output);
         }
     }
 
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 
 #include "collectors/linux/baseline_collector.h"
+#include "collectors/snapshot_event.h"
 #include "json/json_array_reader.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_reader.h"
@@ -12,6 +13,7 @@
 #include "message_schema_consts.h"
 #include "os_utils/process_info_handler.h"
 #include "os_utils/process_utils.h"
+#include "tracked_allocator.h"
 #include "utils.h"
 #include "logger.h"
 #include "twin_configuration.h"
@@ -102,7 +104,6 @@ EventCollectorResult BaselineCollector_GetEvents(SyncQueue* queue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     JsonObjectWriterHandle baselineEventWriter = NULL;
     JsonArrayWriterHandle baselinePayloadArray = NULL;
-    char* messageBuffer = NULL;
     BaselineCustomChecksConfiguration baselineCustomChecksConfiguration = { 0 };
 
     if (JsonObjectWriter_Init(&baselineEventWriter) != JSON_WRITER_OK) {
@@ -129,29 +130,9 @@ EventCollectorResult BaselineCollector_GetEvents(SyncQueue* queue) {
         BaselineCollector_AddBaselineCustomChecksPayload(baselinePayloadArray, baselineCustomChecksConfiguration);
     }
 
-    result = GenericEvent_AddPayload(baselineEventWriter, baselinePayloadArray);
-    if (result != EVENT_COLLECTOR_OK) {
-        goto cleanup;
-    }
-
-    uint32_t messageBufferSize = 0;
-    if (JsonObjectWriter_Serialize(baselineEventWriter, &messageBuffer, &messageBufferSize) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
-    }
-
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
-    }
+    result = SnapshotEvent_PushBack(queue, baselineEventWriter, baselinePayloadArray);
 
 cleanup:
-    if (result != EVENT_COLLECTOR_OK) {
-        if (messageBuffer !=  NULL) {
-            free(messageBuffer);
-        }
-    }
-
     if (baselinePayloadArray != NULL) {
         JsonArrayWriter_Deinit(baselinePayloadArray);
     }
@@ -168,14 +149,14 @@ EventCollectorResult BaselineCollector_AddPayloads(JsonArrayWriterHandle baselin
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     JsonObjectReaderHandle baselineResultHandle = NULL;
     JsonArrayReaderHandle resultsListHandle = NULL;
+    uint32_t chargedSize = 0;
 
-    char* buffer = malloc(OMS_BASELINE_MAX_OUTPUT_SIZE);
+    // the output is read to a scratch buffer which is not charged to the memory limit, it is shrunk to the actual output before it is charged
+    char* buffer = malloc(OMS_BASELINE_MAX_OUTPUT_SIZE + 1);
     if (buffer == NULL) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
-    // empty string
-    buffer[0] = '\0';
 
     uint32_t bufferSize = 0;
     result = BaselineCollector_RunOmsbaseline(baselineCommand, buffer, &bufferSize);
@@ -187,6 +168,22 @@ EventCollectorResult BaselineCollector_AddPayloads(JsonArrayWriterHandle baselin
         goto cleanup;
     }
 
+    char* output = realloc(buffer, bufferSize + 1);
+    if (output == NULL) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+    buffer = output;
+    buffer[bufferSize] = '\0';
+
+    // the baseline is skipped if its output does not fit in the memory limit
+    uint32_t outputSize = TrackedAllocator_EstimateSize(bufferSize + 1);
+    if (!TrackedAllocator_Charge(ALLOCATION_TAG_BASELINE, outputSize)) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+    chargedSize = outputSize;
+
     if (JsonObjectReader_InitFromString(&baselineResultHandle, buffer) != JSON_READER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
@@ -225,6 +222,10 @@ cleanup:
         JsonObjectReader_Deinit(baselineResultHandle);
     }
 
+    if (chargedSize > 0) {
+        TrackedAllocator_Discharge(ALLOCATION_TAG_BASELINE, chargedSize);
+    }
+
     if (buffer != NULL) {
         free(buffer);
     }
@@ -288,7 +288,7 @@ EventCollectorResult ConnectionCreateEventCollector_CreateSingleEvent(AuditSearc
     }
 
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(connectionCreationEvent, &output, &outputSize) != JSON_WRITER_OK) {
+    if (GenericEvent_SerializeWithAllocator(connectionCreationEvent, Queue_AllocateData, Queue_FreeData, &output, &outputSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_OK;
         goto cleanup;
     }
@@ -307,7 +307,7 @@ EventCollectorResult ConnectionCreateEventCollector_CreateSingleEvent(AuditSearc
 cleanup:
     if (result != EVENT_COLLECTOR_OK) {
         if (output != NULL) {
-            free(output);
+            Queue_FreeData(output);
         }
     }
 
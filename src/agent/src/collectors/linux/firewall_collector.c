@@ -5,6 +5,7 @@
 
 #include <stdlib.h>
 
+#include "collectors/snapshot_event.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
 #include "logger.h"
@@ -114,7 +115,6 @@ EventCollectorResult FirewallCollector_GetEvents(SyncQueue* queue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     JsonObjectWriterHandle firewallRulesWriter = NULL;
     JsonArrayWriterHandle rulesPayloadArray = NULL;
-    char* messageBuffer = NULL;
 
     if (JsonObjectWriter_Init(&firewallRulesWriter) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
@@ -136,30 +136,10 @@ EventCollectorResult FirewallCollector_GetEvents(SyncQueue* queue) {
         goto cleanup;
     }
 
-    result = GenericEvent_AddPayload(firewallRulesWriter, rulesPayloadArray); 
-    if (result != EVENT_COLLECTOR_OK) {
-        goto cleanup;
-    }
-
-    uint32_t messageBufferSize = 0;
-    if (JsonObjectWriter_Serialize(firewallRulesWriter, &messageBuffer, &messageBufferSize) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
-    }
-
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
-    }
+    result = SnapshotEvent_PushBack(queue, firewallRulesWriter, rulesPayloadArray);
 
 cleanup:
 
-    if (result != EVENT_COLLECTOR_OK) {
-        if (messageBuffer !=  NULL) {
-            free(messageBuffer);
-        }
-    }
-
     if (rulesPayloadArray != NULL) {
         JsonArrayWriter_Deinit(rulesPayloadArray);
     }
@@ -3,14 +3,25 @@
 
 #include "collectors/generic_event.h"
 
+#include <stdlib.h>
+
 #include "azure_c_shared_utility/uniqueid.h"
 
+#include "event_encoder.h"
 #include "internal/time_utils.h"
+#include "local_config.h"
 #include "message_schema_consts.h"
 
 static const int MAX_TIME_AS_STRING_LENGTH = 25;
 #define EVENT_ID_SIZE 37
 
+/**
+ * @brief The allocation function of GenericEvent_Serialize.
+ */
+static void* GenericEvent_Allocate(uint32_t size) {
+    return malloc(size);
+}
+
 EventCollectorResult GenericEvent_AddMetadata(JsonObjectWriterHandle eventWriter, const char* eventCategory, const char* eventName, const char* eventType, const char* eventPayloadVersion) {
     time_t currentTime = TimeUtils_GetCurrentTime();
     return GenericEvent_AddMetadataWithTimes(eventWriter, eventCategory, eventName, eventType, eventPayloadVersion, &currentTime);
@@ -82,5 +93,17 @@ EventCollectorResult GenericEvent_AddPayload(JsonObjectWriterHandle eventWriter,
         return EVENT_COLLECTOR_EXCEPTION;
     }
 
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult GenericEvent_Serialize(JsonObjectWriterHandle eventWriter, char** output, uint32_t* size) {
+    return GenericEvent_SerializeWithAllocator(eventWriter, GenericEvent_Allocate, free, output, size);
+}
+
+EventCollectorResult GenericEvent_SerializeWithAllocator(JsonObjectWriterHandle eventWriter, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size) {
+    if (EventEncoder_EncodeObject(LocalConfiguration_GetEventEncoding(), eventWriter, allocate, release, output, size) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
     return EVENT_COLLECTOR_OK;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <ctype.h>
 #include <regex.h>
 
+#include "collectors/collector_execution.h"
 #include "collectors/generic_event.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
@@ -327,6 +328,12 @@ EventCollectorResult ListeningPortCollector_PopulateInodesMap(MAP_HANDLE inodesM
     }
 
     while ((entry = readdir(dir)) != NULL) {
+        // every process is listed by a command of its own, so a host with many processes may take longer than the budget
+        if (CollectorExecution_IsCanceled()) {
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        }
+
         if (Utils_IsStringNumeric(entry->d_name)){
             if (!ListeningPortCollector_PopulateProcessToInodesMap(inodesMap, entry->d_name)){
                 result = EVENT_COLLECTOR_EXCEPTION;
@@ -406,7 +413,7 @@ EventCollectorResult ListeningPortCollector_GetEvents(SyncQueue* queue) {
     }
 
     uint32_t messageBufferSize = 0;
-    if (JsonObjectWriter_Serialize(listeningPortsEventWriter, &messageBuffer, &messageBufferSize) != JSON_WRITER_OK) {
+    if (GenericEvent_Serialize(listeningPortsEventWriter, &messageBuffer, &messageBufferSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
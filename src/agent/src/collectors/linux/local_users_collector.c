@@ -292,7 +292,7 @@ EventCollectorResult LocalUsersCollector_GetEvents(SyncQueue* queue) {
     }
 
     uint32_t messageBufferSize = 0;
-    if (JsonObjectWriter_Serialize(usersEventWriter, &messageBuffer, &messageBufferSize) != JSON_WRITER_OK) {
+    if (GenericEvent_Serialize(usersEventWriter, &messageBuffer, &messageBufferSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
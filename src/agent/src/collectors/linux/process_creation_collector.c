@@ -6,6 +6,7 @@
 #include <libaudit.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "collectors/event_aggregator.h"
 #include "collectors/generic_event.h"
@@ -17,6 +18,7 @@
 #include "os_utils/linux/audit/audit_control.h"
 #include "os_utils/linux/audit/audit_search_record.h"
 #include "os_utils/linux/audit/audit_search.h"
+#include "tracked_allocator.h"
 #include "twin_configuration_defs.h"
 #include "utils.h"
 #include "azure_c_shared_utility/map.h"
@@ -38,6 +40,8 @@ static const char AUDIT_ARGC[] = "argc";
 
 #define AUDIT_MAX_PARAM_LEN 10
 static MAP_HANDLE executableHashMap = NULL;
+// the memory the entries of the executable hash map were charged for
+static uint32_t executableHashMapSize = 0;
 static EventAggregatorHandle aggregator = NULL;
 static bool aggregatorInitialized = false;
 
@@ -319,7 +323,7 @@ EventCollectorResult ProcessCreationCollector_CreateSingleEvent(AuditSearch* aud
     }
     
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(processEvent, &output, &outputSize) != JSON_WRITER_OK) {
+    if (GenericEvent_SerializeWithAllocator(processEvent, Queue_AllocateData, Queue_FreeData, &output, &outputSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
@@ -336,7 +340,7 @@ EventCollectorResult ProcessCreationCollector_CreateSingleEvent(AuditSearch* aud
 cleanup:
     if (result != EVENT_COLLECTOR_OK) {
         if (output != NULL) {
-            free(output);
+            Queue_FreeData(output);
         }
     }
 
@@ -463,12 +467,26 @@ EventCollectorResult ProcessCreationCollector_AddEntryToExecutableHashMap(AuditS
         }
         result = AuditSearch_InterpretString(auditSearch, AUDIT_PROCESS_CREATION_EXECUTEABLE_PATH, &executable);
         if (result != AUDIT_SEARCH_OK && result != AUDIT_SEARCH_FIELD_DOES_NOT_EXIST) {
+            free(Hash);
             return EVENT_COLLECTOR_EXCEPTION;
         }
+
+        if (executable != NULL && Map_GetValueFromKey(executableHashMap, executable) == NULL) {
+            // the map copies the key and the value and keeps a pointer to each of them
+            uint32_t entrySize = TrackedAllocator_EstimateSize(strlen(executable) + 1) + TrackedAllocator_EstimateSize(strlen(Hash) + 1) + 2 * sizeof(char*);
+            if (!TrackedAllocator_Charge(ALLOCATION_TAG_PROCESS_HASHES, entrySize)) {
+                // the map is only a cache, the hash is left out once it reaches the memory limit
+                free(Hash);
+                return EVENT_COLLECTOR_OK;
+            }
+            executableHashMapSize += entrySize;
+        }
+
         MAP_RESULT mapResult = Map_AddOrUpdate(executableHashMap, executable, Hash);
         if (mapResult != MAP_OK && mapResult != MAP_KEYEXISTS){
             result = EVENT_COLLECTOR_EXCEPTION;
         }
+        free(Hash);
     }
 
     return EVENT_COLLECTOR_OK;
@@ -531,5 +549,10 @@ void ProcessCreationCollector_Deinit() {
     }
     if (executableHashMap != NULL){
         Map_Destroy(executableHashMap);
+        executableHashMap = NULL;
+    }
+    if (executableHashMapSize > 0) {
+        TrackedAllocator_Discharge(ALLOCATION_TAG_PROCESS_HASHES, executableHashMapSize);
+        executableHashMapSize = 0;
     }
 }
\ No newline at end of file
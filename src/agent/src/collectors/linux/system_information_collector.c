@@ -184,7 +184,7 @@ EventCollectorResult SystemInformationCollector_GetEvents(SyncQueue* queue) {
     }
 
     uint32_t messageBufferSize = 0;
-    if (JsonObjectWriter_Serialize(sysinfoEventWriter, &messageBuffer, &messageBufferSize) != JSON_WRITER_OK) {
+    if (GenericEvent_Serialize(sysinfoEventWriter, &messageBuffer, &messageBufferSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
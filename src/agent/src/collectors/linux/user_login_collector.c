@@ -209,7 +209,7 @@ EventCollectorResult UserLoginEvent_CreateSingleEvent(AuditSearch* auditSearch,
     }
     
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(userLoginEvent, &output, &outputSize) != JSON_WRITER_OK) {
+    if (GenericEvent_SerializeWithAllocator(userLoginEvent, Queue_AllocateData, Queue_FreeData, &output, &outputSize) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
@@ -226,7 +226,7 @@ EventCollectorResult UserLoginEvent_CreateSingleEvent(AuditSearch* auditSearch,
 cleanup:
     if (result != EVENT_COLLECTOR_OK) {
         if (output != NULL) {
-            free(output);
+            Queue_FreeData(output);
         }
     }
 
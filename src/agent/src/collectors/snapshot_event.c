@@ -0,0 +1,385 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "collectors/snapshot_event.h"
+
+#include <stdlib.h>
+
+#include "azure_c_shared_utility/uniqueid.h"
+
+#include "consts.h"
+#include "event_encoder.h"
+#include "local_config.h"
+#include "logger.h"
+#include "message_schema_consts.h"
+#include "twin_configuration.h"
+
+#define SNAPSHOT_ID_SIZE 37
+
+// the base of a part is measured with single digit part numbers, the reserve covers their widest encoding
+// and the longer header of a non empty payload array
+#define SNAPSHOT_PART_NUMBERS_RESERVE 24
+
+/**
+ * @brief Writes the snapshot members of a part.
+ *
+ * @param   partWriter      The writer of the part.
+ * @param   snapshotId      The id of the snapshot.
+ * @param   part            The index of the part.
+ * @param   partsCount      The number of parts of the snapshot.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+static EventCollectorResult SnapshotEvent_WriteSnapshotMembers(JsonObjectWriterHandle partWriter, const char* snapshotId, uint32_t part, uint32_t partsCount);
+
+/**
+ * @brief Returns the encoded size of a part without payload items.
+ *
+ * @param   partTemplate    The metadata of the event.
+ * @param   snapshotId      The id of the snapshot.
+ * @param   size            Out param. The size of the part.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+static EventCollectorResult SnapshotEvent_GetPartBaseSize(JsonObjectWriterHandle partTemplate, const char* snapshotId, uint32_t* size);
+
+/**
+ * @brief Returns the encoded size of a payload item.
+ *
+ * @param   payloadWriter   The payload array.
+ * @param   index           The index of the item.
+ * @param   size            Out param. The size of the item.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+static EventCollectorResult SnapshotEvent_GetItemSize(JsonArrayWriterHandle payloadWriter, uint32_t index, uint32_t* size);
+
+/**
+ * @brief Encodes an event and pushes it to the queue.
+ *
+ * @param   queue           The queue.
+ * @param   eventWriter     The event.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+static EventCollectorResult SnapshotEvent_Push(SyncQueue* queue, JsonObjectWriterHandle eventWriter);
+
+/**
+ * @brief Builds a part of the payload items in [first, end) and pushes it to the queue.
+ *
+ * @param   queue           The queue.
+ * @param   partTemplate    The metadata of the event.
+ * @param   snapshotId      The id of the snapshot.
+ * @param   part            The index of the part.
+ * @param   partsCount      The number of parts of the snapshot.
+ * @param   payloadWriter   The payload array of the snapshot.
+ * @param   first           The index of the first item of the part.
+ * @param   end             The index after the last item of the part.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+static EventCollectorResult SnapshotEvent_PushPart(SyncQueue* queue, JsonObjectWriterHandle partTemplate, const char* snapshotId, uint32_t part, uint32_t partsCount, JsonArrayWriterHandle payloadWriter, uint32_t first, uint32_t end);
+
+/**
+ * @brief Splits the payload into parts which fit in the given size and pushes them to the queue.
+ *
+ * @param   queue           The queue.
+ * @param   partTemplate    The metadata of the event.
+ * @param   payloadWriter   The payload array of the snapshot.
+ * @param   itemsCount      The number of payload items.
+ * @param   maxEventSize    The max size of a part.
+ *
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+static EventCollectorResult SnapshotEvent_PushParts(SyncQueue* queue, JsonObjectWriterHandle partTemplate, JsonArrayWriterHandle payloadWriter, uint32_t itemsCount, uint32_t maxEventSize);
+
+static EventCollectorResult SnapshotEvent_WriteSnapshotMembers(JsonObjectWriterHandle partWriter, const char* snapshotId, uint32_t part, uint32_t partsCount) {
+    // every part is an event of its own
+    char eventId[SNAPSHOT_ID_SIZE] = "";
+    if (UniqueId_Generate(eventId, sizeof(eventId)) != UNIQUEID_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonObjectWriter_WriteString(partWriter, EVENT_ID_KEY, eventId) != JSON_WRITER_OK ||
+        JsonObjectWriter_WriteString(partWriter, EVENT_SNAPSHOT_ID_KEY, snapshotId) != JSON_WRITER_OK ||
+        JsonObjectWriter_WriteInt(partWriter, EVENT_SNAPSHOT_PART_KEY, part) != JSON_WRITER_OK ||
+        JsonObjectWriter_WriteInt(partWriter, EVENT_SNAPSHOT_PARTS_KEY, partsCount) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+static EventCollectorResult SnapshotEvent_GetPartBaseSize(JsonObjectWriterHandle partTemplate, const char* snapshotId, uint32_t* size) {
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle partWriter = NULL;
+    JsonArrayWriterHandle emptyPayload = NULL;
+    char* buffer = NULL;
+
+    if (JsonObjectWriter_Copy(&partWriter, partTemplate) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&emptyPayload) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = SnapshotEvent_WriteSnapshotMembers(partWriter, snapshotId, 0, 0);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddPayload(partWriter, emptyPayload);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    result = GenericEvent_Serialize(partWriter, &buffer, size);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    *size += SNAPSHOT_PART_NUMBERS_RESERVE;
+
+cleanup:
+    if (buffer != NULL) {
+        free(buffer);
+    }
+
+    if (emptyPayload != NULL) {
+        JsonArrayWriter_Deinit(emptyPayload);
+    }
+
+    if (partWriter != NULL) {
+        JsonObjectWriter_Deinit(partWriter);
+    }
+
+    return result;
+}
+
+static EventCollectorResult SnapshotEvent_GetItemSize(JsonArrayWriterHandle payloadWriter, uint32_t index, uint32_t* size) {
+    JsonObjectWriterHandle itemWriter = NULL;
+    if (JsonArrayWriter_GetObject(payloadWriter, index, &itemWriter) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    char* buffer = NULL;
+    EventCollectorResult result = GenericEvent_Serialize(itemWriter, &buffer, size);
+    if (buffer != NULL) {
+        free(buffer);
+    }
+
+    JsonObjectWriter_Deinit(itemWriter);
+    return result;
+}
+
+static EventCollectorResult SnapshotEvent_Push(SyncQueue* queue, JsonObjectWriterHandle eventWriter) {
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    if (GenericEvent_Serialize(eventWriter, &buffer, &bufferSize) != EVENT_COLLECTOR_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (SyncQueue_PushBack(queue, buffer, bufferSize) != QUEUE_OK) {
+        free(buffer);
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+static EventCollectorResult SnapshotEvent_PushPart(SyncQueue* queue, JsonObjectWriterHandle partTemplate, const char* snapshotId, uint32_t part, uint32_t partsCount, JsonArrayWriterHandle payloadWriter, uint32_t first, uint32_t end) {
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle partWriter = NULL;
+    JsonArrayWriterHandle partPayload = NULL;
+
+    if (JsonObjectWriter_Copy(&partWriter, partTemplate) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = SnapshotEvent_WriteSnapshotMembers(partWriter, snapshotId, part, partsCount);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&partPayload) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    for (uint32_t i = first; i < end; i++) {
+        JsonObjectWriterHandle itemWriter = NULL;
+        JsonObjectWriterHandle itemCopy = NULL;
+        if (JsonArrayWriter_GetObject(payloadWriter, i, &itemWriter) != JSON_WRITER_OK) {
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        }
+
+        JsonWriterResult copyResult = JsonObjectWriter_Copy(&itemCopy, itemWriter);
+        JsonObjectWriter_Deinit(itemWriter);
+        if (copyResult != JSON_WRITER_OK) {
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        }
+
+        // the copy is owned by the part payload once it is added
+        JsonWriterResult addResult = JsonArrayWriter_AddObject(partPayload, itemCopy);
+        JsonObjectWriter_Deinit(itemCopy);
+        if (addResult != JSON_WRITER_OK) {
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    result = GenericEvent_AddPayload(partWriter, partPayload);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    result = SnapshotEvent_Push(queue, partWriter);
+
+cleanup:
+    if (partPayload != NULL) {
+        JsonArrayWriter_Deinit(partPayload);
+    }
+
+    if (partWriter != NULL) {
+        JsonObjectWriter_Deinit(partWriter);
+    }
+
+    return result;
+}
+
+static EventCollectorResult SnapshotEvent_PushParts(SyncQueue* queue, JsonObjectWriterHandle partTemplate, JsonArrayWriterHandle payloadWriter, uint32_t itemsCount, uint32_t maxEventSize) {
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    // the end of every part, there are at most as many parts as items
+    uint32_t* partEnds = malloc(itemsCount * sizeof(uint32_t));
+    if (partEnds == NULL) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    char snapshotId[SNAPSHOT_ID_SIZE] = "";
+    if (UniqueId_Generate(snapshotId, sizeof(snapshotId)) != UNIQUEID_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    uint32_t partBaseSize = 0;
+    result = SnapshotEvent_GetPartBaseSize(partTemplate, snapshotId, &partBaseSize);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    // the items are separated in the payload array as the events are in the events array
+    uint32_t separatorSize = EventEncoder_GetFraming(LocalConfiguration_GetEventEncoding())->separatorSize;
+
+    uint32_t partsCount = 0;
+    uint32_t partSize = partBaseSize;
+    uint32_t partItems = 0;
+    for (uint32_t i = 0; i < itemsCount; i++) {
+        uint32_t itemSize = 0;
+        result = SnapshotEvent_GetItemSize(payloadWriter, i, &itemSize);
+        if (result != EVENT_COLLECTOR_OK) {
+            goto cleanup;
+        }
+
+        if (partItems > 0 && partSize + separatorSize + itemSize > maxEventSize) {
+            partEnds[partsCount++] = i;
+            partSize = partBaseSize;
+            partItems = 0;
+        }
+
+        if (partItems > 0) {
+            partSize += separatorSize;
+        } else if (partSize + itemSize > maxEventSize) {
+            Logger_Warning("A snapshot item of %u bytes does not fit in a message", itemSize);
+        }
+        partSize += itemSize;
+        partItems++;
+    }
+    partEnds[partsCount++] = itemsCount;
+
+    Logger_Information("The snapshot %s is split into %u parts", snapshotId, partsCount);
+
+    for (uint32_t part = 0; part < partsCount; part++) {
+        uint32_t first = part == 0 ? 0 : partEnds[part - 1];
+        result = SnapshotEvent_PushPart(queue, partTemplate, snapshotId, part, partsCount, payloadWriter, first, partEnds[part]);
+        if (result != EVENT_COLLECTOR_OK) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    if (partEnds != NULL) {
+        free(partEnds);
+    }
+
+    return result;
+}
+
+EventCollectorResult SnapshotEvent_PushBack(SyncQueue* queue, JsonObjectWriterHandle eventWriter, JsonArrayWriterHandle payloadWriter) {
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle partTemplate = NULL;
+    char* buffer = NULL;
+
+    uint32_t maxMessageSize = 0;
+    if (TwinConfiguration_GetMaxMessageSize(&maxMessageSize) != TWIN_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+    uint32_t maxEventSize = maxMessageSize > MESSAGE_ENVELOPE_RESERVED_SIZE ? maxMessageSize - MESSAGE_ENVELOPE_RESERVED_SIZE : 0;
+
+    uint32_t itemsCount = 0;
+    if (JsonArrayWriter_GetSize(payloadWriter, &itemsCount) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    // the metadata is kept aside before the payload is added, the parts are made of it
+    if (itemsCount > 1 && JsonObjectWriter_Copy(&partTemplate, eventWriter) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddPayload(eventWriter, payloadWriter);
+    if (result != EVENT_COLLECTOR_OK) {
+        goto cleanup;
+    }
+
+    uint32_t bufferSize = 0;
+    if (GenericEvent_Serialize(eventWriter, &buffer, &bufferSize) != EVENT_COLLECTOR_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    // a snapshot which fits in a message is sent as is
+    if (bufferSize <= maxEventSize || itemsCount <= 1) {
+        if (SyncQueue_PushBack(queue, buffer, bufferSize) != QUEUE_OK) {
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        }
+        buffer = NULL;
+        goto cleanup;
+    }
+
+    free(buffer);
+    buffer = NULL;
+
+    result = SnapshotEvent_PushParts(queue, partTemplate, payloadWriter, itemsCount, maxEventSize);
+
+cleanup:
+    if (buffer != NULL) {
+        free(buffer);
+    }
+
+    if (partTemplate != NULL) {
+        JsonObjectWriter_Deinit(partTemplate);
+    }
+
+    return result;
+}
@@ -0,0 +1,701 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "columnar_message.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logger.h"
+#include "message_schema_consts.h"
+#include "parson.h"
+
+#define COLUMNAR_MESSAGE_EVENT_KEYS_COUNT 9
+#define COLUMNAR_MESSAGE_NO_INDEX UINT32_MAX
+#define COLUMNAR_MESSAGE_SECONDS_IN_A_DAY 86400
+#define COLUMNAR_MESSAGE_TIMESTAMP_LENGTH 20
+
+/**
+ * A string of the payload and the number of times it appears in the string columns of the message.
+ */
+typedef struct _ColumnarStringEntry {
+
+    const char* value;
+    uint32_t count;
+    uint32_t index;     // the index in the string table, once the string is written to it
+
+} ColumnarStringEntry;
+
+/**
+ * An open addressing hash set of the payload strings, keyed by the strings of the parsed message.
+ */
+typedef struct _ColumnarStringTable {
+
+    ColumnarStringEntry* entries;
+    uint32_t capacity;
+    JSON_Array* strings;
+
+} ColumnarStringTable;
+
+/**
+ * The metadata and the payload of a single event, as parsed from the message.
+ */
+typedef struct _ColumnarEvent {
+
+    const char* category;
+    const char* eventType;
+    const char* name;
+    const char* payloadSchemaVersion;
+    const char* id;
+    const char* utcTimestamp;
+    int64_t localTime;
+    int64_t utcTime;
+    JSON_Array* payload;
+    uint32_t group;
+
+} ColumnarEvent;
+
+/**
+ * A payload field of an event group.
+ */
+typedef struct _ColumnarColumn {
+
+    const char* key;
+    bool isString;      // every value of the column is a string or is missing
+
+} ColumnarColumn;
+
+/**
+ * @brief Converts a date to the number of days since the epoch.
+ */
+static int64_t ColumnarMessage_DaysFromCivil(int64_t year, int64_t month, int64_t day);
+
+/**
+ * @brief Converts the number of days since the epoch to a date.
+ */
+static void ColumnarMessage_CivilFromDays(int64_t days, int64_t* year, int64_t* month, int64_t* day);
+
+/**
+ * @brief Parses a timestamp of the events (see time_utils.h), seconds are the finest resolution of the events.
+ *        The timestamp is formatted back and compared, so only a timestamp which the backend restores exactly is taken.
+ *
+ * @param   value       The timestamp.
+ * @param   seconds     Out param. The seconds since the epoch.
+ *
+ * @return true on success, false if the timestamp is not in its canonical form.
+ */
+static bool ColumnarMessage_ParseTimestamp(const char* value, int64_t* seconds);
+
+/**
+ * @brief Reads the metadata of an event, an event with any other member does not fit the columnar layout.
+ *
+ * @param   value       The event.
+ * @param   event       Out param. The event.
+ *
+ * @return true on success, false if the event does not fit the columnar layout.
+ */
+static bool ColumnarMessage_ReadEvent(const JSON_Value* value, ColumnarEvent* event);
+
+/**
+ * @brief Checks whether two events belong to the same group.
+ */
+static bool ColumnarMessage_IsSameGroup(const ColumnarEvent* first, const ColumnarEvent* second);
+
+/**
+ * @brief Returns the entry of the given string, or the empty entry it is to be set in.
+ */
+static ColumnarStringEntry* ColumnarMessage_FindString(ColumnarStringTable* table, const char* value);
+
+/**
+ * @brief Counts the strings of the payloads of the events, so only strings which repeat are written to the string table.
+ *
+ * @param   table       The string table, allocated by this function.
+ * @param   events      The events.
+ * @param   count       The number of events.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool ColumnarMessage_CountStrings(ColumnarStringTable* table, const ColumnarEvent* events, uint32_t count);
+
+/**
+ * @brief Returns the value of a cell of a string column, the index of a string in the string table if it repeats,
+ *        the string itself otherwise.
+ */
+static JSON_Value* ColumnarMessage_GetStringCell(ColumnarStringTable* table, const char* value);
+
+/**
+ * @brief Writes the ids and the timestamps of the events of the group.
+ *
+ * @param   group       The group object to write to.
+ * @param   events      The events.
+ * @param   count       The number of events.
+ * @param   groupIndex  The index of the group.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool ColumnarMessage_WriteMetadataColumns(JSON_Object* group, const ColumnarEvent* events, uint32_t count, uint32_t groupIndex);
+
+/**
+ * @brief Writes the payload of the events of the group, the number of items of each event and a column per field.
+ *
+ * @param   group       The group object to write to.
+ * @param   events      The events.
+ * @param   count       The number of events.
+ * @param   groupIndex  The index of the group.
+ * @param   table       The string table of the message.
+ *
+ * @return true on success, false if the payload does not fit the columnar layout or on failure.
+ */
+static bool ColumnarMessage_WritePayloadColumns(JSON_Object* group, const ColumnarEvent* events, uint32_t count, uint32_t groupIndex, ColumnarStringTable* table);
+
+/**
+ * @brief Writes a group of events.
+ *
+ * @param   groups      The groups array to write to.
+ * @param   events      The events.
+ * @param   count       The number of events.
+ * @param   groupIndex  The index of the group.
+ * @param   table       The string table of the message.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool ColumnarMessage_WriteGroup(JSON_Array* groups, const ColumnarEvent* events, uint32_t count, uint32_t groupIndex, ColumnarStringTable* table);
+
+static int64_t ColumnarMessage_DaysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static void ColumnarMessage_CivilFromDays(int64_t days, int64_t* year, int64_t* month, int64_t* day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    *day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    *month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    *year = yearOfEra + era * 400 + (*month <= 2);
+}
+
+static bool ColumnarMessage_ParseTimestamp(const char* value, int64_t* seconds) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0, length = 0;
+    if (value == NULL || strlen(value) != COLUMNAR_MESSAGE_TIMESTAMP_LENGTH ||
+        sscanf(value, "%4d-%2d-%2dT%2d:%2d:%2dZ%n", &year, &month, &day, &hour, &minute, &second, &length) != 6 ||
+        length != COLUMNAR_MESSAGE_TIMESTAMP_LENGTH) {
+        return false;
+    }
+
+    int64_t days = ColumnarMessage_DaysFromCivil(year, month, day);
+    *seconds = days * COLUMNAR_MESSAGE_SECONDS_IN_A_DAY + hour * 3600 + minute * 60 + second;
+
+    int64_t canonicalYear = 0, canonicalMonth = 0, canonicalDay = 0;
+    int64_t secondOfDay = *seconds - days * COLUMNAR_MESSAGE_SECONDS_IN_A_DAY;
+    ColumnarMessage_CivilFromDays(days, &canonicalYear, &canonicalMonth, &canonicalDay);
+    if (secondOfDay < 0 || secondOfDay >= COLUMNAR_MESSAGE_SECONDS_IN_A_DAY) {
+        return false;
+    }
+
+    char canonical[COLUMNAR_MESSAGE_TIMESTAMP_LENGTH + 1];
+    int written = snprintf(canonical, sizeof(canonical), "%04d-%02d-%02dT%02d:%02d:%02dZ",
+        (int)canonicalYear, (int)canonicalMonth, (int)canonicalDay,
+        (int)(secondOfDay / 3600), (int)(secondOfDay / 60 % 60), (int)(secondOfDay % 60));
+    return written == COLUMNAR_MESSAGE_TIMESTAMP_LENGTH && strcmp(canonical, value) == 0;
+}
+
+static bool ColumnarMessage_ReadEvent(const JSON_Value* value, ColumnarEvent* event) {
+    const JSON_Object* object = json_value_get_object(value);
+    if (object == NULL || json_object_get_count(object) != COLUMNAR_MESSAGE_EVENT_KEYS_COUNT) {
+        return false;
+    }
+
+    event->category = json_object_get_string(object, EVENT_CATEGORY_KEY);
+    event->eventType = json_object_get_string(object, EVENT_TYPE_KEY);
+    event->name = json_object_get_string(object, EVENT_NAME_KEY);
+    event->payloadSchemaVersion = json_object_get_string(object, EVENT_PAYLOAD_SCHEMA_VERSION_KEY);
+    event->id = json_object_get_string(object, EVENT_ID_KEY);
+    event->payload = json_object_get_array(object, PAYLOAD_KEY);
+    if (event->category == NULL || event->eventType == NULL || event->name == NULL || event->payloadSchemaVersion == NULL ||
+        event->id == NULL || event->payload == NULL) {
+        return false;
+    }
+
+    // the backend restores IsEmpty from the number of payload items, the way the collectors set it
+    int isEmpty = json_object_get_boolean(object, EVENT_IS_EMPTY_KEY);
+    if (isEmpty == -1 || (isEmpty == 1) != (json_array_get_count(event->payload) == 0)) {
+        return false;
+    }
+
+    event->utcTimestamp = json_object_get_string(object, EVENT_UTC_TIMESTAMP_KEY);
+    return ColumnarMessage_ParseTimestamp(json_object_get_string(object, EVENT_LOCAL_TIMESTAMP_KEY), &event->localTime) &&
+        ColumnarMessage_ParseTimestamp(event->utcTimestamp, &event->utcTime);
+}
+
+static bool ColumnarMessage_IsSameGroup(const ColumnarEvent* first, const ColumnarEvent* second) {
+    return strcmp(first->name, second->name) == 0 &&
+        strcmp(first->payloadSchemaVersion, second->payloadSchemaVersion) == 0 &&
+        strcmp(first->category, second->category) == 0 &&
+        strcmp(first->eventType, second->eventType) == 0;
+}
+
+static ColumnarStringEntry* ColumnarMessage_FindString(ColumnarStringTable* table, const char* value) {
+    uint32_t hash = 5381;
+    for (const char* current = value; *current != '\0'; ++current) {
+        hash = hash * 33 + (uint8_t)*current;
+    }
+
+    // the capacity is a power of two which is never more than half full, so the probing always ends
+    uint32_t position = hash & (table->capacity - 1);
+    while (table->entries[position].value != NULL && strcmp(table->entries[position].value, value) != 0) {
+        position = (position + 1) & (table->capacity - 1);
+    }
+    return &table->entries[position];
+}
+
+static bool ColumnarMessage_CountStrings(ColumnarStringTable* table, const ColumnarEvent* events, uint32_t count) {
+    uint32_t numberOfStrings = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        size_t items = json_array_get_count(events[i].payload);
+        for (size_t j = 0; j < items; ++j) {
+            const JSON_Object* item = json_array_get_object(events[i].payload, j);
+            numberOfStrings += item != NULL ? json_object_get_count(item) : 0;
+        }
+    }
+
+    table->capacity = 16;
+    while (table->capacity < numberOfStrings * 2) {
+        table->capacity *= 2;
+    }
+    table->entries = calloc(table->capacity, sizeof(ColumnarStringEntry));
+    if (table->entries == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        size_t items = json_array_get_count(events[i].payload);
+        for (size_t j = 0; j < items; ++j) {
+            const JSON_Object* item = json_array_get_object(events[i].payload, j);
+            size_t fields = item != NULL ? json_object_get_count(item) : 0;
+            for (size_t k = 0; k < fields; ++k) {
+                const char* value = json_value_get_string(json_object_get_value_at(item, k));
+                if (value == NULL) {
+                    continue;
+                }
+                ColumnarStringEntry* entry = ColumnarMessage_FindString(table, value);
+                if (entry->value == NULL) {
+                    entry->value = value;
+                    entry->index = COLUMNAR_MESSAGE_NO_INDEX;
+                }
+                entry->count++;
+            }
+        }
+    }
+
+    return true;
+}
+
+static JSON_Value* ColumnarMessage_GetStringCell(ColumnarStringTable* table, const char* value) {
+    ColumnarStringEntry* entry = ColumnarMessage_FindString(table, value);
+    if (entry->value == NULL || entry->count < 2) {
+        return json_value_init_string(value);
+    }
+
+    if (entry->index == COLUMNAR_MESSAGE_NO_INDEX) {
+        if (json_array_append_string(table->strings, value) != JSONSuccess) {
+            return NULL;
+        }
+        entry->index = (uint32_t)json_array_get_count(table->strings) - 1;
+    }
+    return json_value_init_number(entry->index);
+}
+
+static bool ColumnarMessage_WriteMetadataColumns(JSON_Object* group, const ColumnarEvent* events, uint32_t count, uint32_t groupIndex) {
+    bool success = false;
+    JSON_Value* ids = json_value_init_array();
+    JSON_Value* utcTimes = json_value_init_object();
+    JSON_Value* deltas = json_value_init_array();
+    JSON_Value* localTimes = json_value_init_object();
+    JSON_Value* offsets = json_value_init_array();
+    if (ids == NULL || utcTimes == NULL || deltas == NULL || localTimes == NULL || offsets == NULL) {
+        goto cleanup;
+    }
+
+    const ColumnarEvent* previous = NULL;
+    bool fixedOffset = true;
+    for (uint32_t i = 0; i < count; ++i) {
+        const ColumnarEvent* event = &events[i];
+        if (event->group != groupIndex) {
+            continue;
+        }
+
+        int64_t offset = event->localTime - event->utcTime;
+        if (previous == NULL) {
+            if (json_object_set_string(json_value_get_object(utcTimes), COLUMNAR_TIMESTAMP_BASE_KEY, event->utcTimestamp) != JSONSuccess) {
+                goto cleanup;
+            }
+        } else if (json_array_append_number(json_value_get_array(deltas), (double)(event->utcTime - previous->utcTime)) != JSONSuccess) {
+            goto cleanup;
+        }
+        fixedOffset = fixedOffset && (previous == NULL || offset == previous->localTime - previous->utcTime);
+
+        if (json_array_append_string(json_value_get_array(ids), event->id) != JSONSuccess ||
+            json_array_append_number(json_value_get_array(offsets), (double)offset) != JSONSuccess) {
+            goto cleanup;
+        }
+        previous = event;
+    }
+
+    if (json_object_set_value(json_value_get_object(utcTimes), COLUMNAR_TIMESTAMP_DELTAS_KEY, deltas) != JSONSuccess) {
+        goto cleanup;
+    }
+    deltas = NULL;
+
+    // the offset of the local time is that of the time zone of the device, which rarely changes within a message
+    if (fixedOffset) {
+        if (json_object_set_value(json_value_get_object(localTimes), COLUMNAR_OFFSET_FROM_UTC_KEY, json_value_deep_copy(json_array_get_value(json_value_get_array(offsets), 0))) != JSONSuccess) {
+            goto cleanup;
+        }
+    } else {
+        if (json_object_set_value(json_value_get_object(localTimes), COLUMNAR_OFFSETS_FROM_UTC_KEY, offsets) != JSONSuccess) {
+            goto cleanup;
+        }
+        offsets = NULL;
+    }
+
+    if (json_object_set_value(group, EVENT_ID_KEY, ids) != JSONSuccess) {
+        goto cleanup;
+    }
+    ids = NULL;
+
+    if (json_object_set_value(group, EVENT_UTC_TIMESTAMP_KEY, utcTimes) != JSONSuccess) {
+        goto cleanup;
+    }
+    utcTimes = NULL;
+
+    if (json_object_set_value(group, EVENT_LOCAL_TIMESTAMP_KEY, localTimes) != JSONSuccess) {
+        goto cleanup;
+    }
+    localTimes = NULL;
+
+    success = true;
+
+cleanup:
+    if (ids != NULL) {
+        json_value_free(ids);
+    }
+    if (utcTimes != NULL) {
+        json_value_free(utcTimes);
+    }
+    if (deltas != NULL) {
+        json_value_free(deltas);
+    }
+    if (localTimes != NULL) {
+        json_value_free(localTimes);
+    }
+    if (offsets != NULL) {
+        json_value_free(offsets);
+    }
+
+    return success;
+}
+
+static bool ColumnarMessage_WritePayloadColumns(JSON_Object* group, const ColumnarEvent* events, uint32_t count, uint32_t groupIndex, ColumnarStringTable* table) {
+    bool success = false;
+    ColumnarColumn* columns = NULL;
+    uint32_t numberOfColumns = 0;
+    uint32_t columnsCapacity = 0;
+    JSON_Value* counts = json_value_init_array();
+    JSON_Value* payload = json_value_init_object();
+    JSON_Value* payloadStrings = json_value_init_object();
+    JSON_Value* column = NULL;
+    if (counts == NULL || payload == NULL || payloadStrings == NULL) {
+        goto cleanup;
+    }
+
+    // the items of all the events of the group are a single table, its columns are the fields in the order they first appear
+    for (uint32_t i = 0; i < count; ++i) {
+        if (events[i].group != groupIndex) {
+            continue;
+        }
+
+        size_t items = json_array_get_count(events[i].payload);
+        if (json_array_append_number(json_value_get_array(counts), (double)items) != JSONSuccess) {
+            goto cleanup;
+        }
+
+        for (size_t j = 0; j < items; ++j) {
+            const JSON_Object* item = json_array_get_object(events[i].payload, j);
+            if (item == NULL) {
+                goto cleanup;
+            }
+
+            size_t fields = json_object_get_count(item);
+            for (size_t k = 0; k < fields; ++k) {
+                const char* key = json_object_get_name(item, k);
+                JSON_Value_Type type = json_value_get_type(json_object_get_value_at(item, k));
+                // a missing field is written as null, so a null field could not be told apart from it
+                if (type == JSONNull) {
+                    goto cleanup;
+                }
+
+                uint32_t c = 0;
+                while (c < numberOfColumns && strcmp(columns[c].key, key) != 0) {
+                    ++c;
+                }
+                if (c == numberOfColumns) {
+                    if (numberOfColumns == columnsCapacity) {
+                        uint32_t capacity = columnsCapacity == 0 ? 8 : columnsCapacity * 2;
+                        ColumnarColumn* newColumns = realloc(columns, capacity * sizeof(ColumnarColumn));
+                        if (newColumns == NULL) {
+                            goto cleanup;
+                        }
+                        columns = newColumns;
+                        columnsCapacity = capacity;
+                    }
+                    columns[c].key = key;
+                    columns[c].isString = true;
+                    numberOfColumns++;
+                }
+                columns[c].isString = columns[c].isString && type == JSONString;
+            }
+        }
+    }
+
+    for (uint32_t c = 0; c < numberOfColumns; ++c) {
+        column = json_value_init_array();
+        if (column == NULL) {
+            goto cleanup;
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (events[i].group != groupIndex) {
+                continue;
+            }
+
+            size_t items = json_array_get_count(events[i].payload);
+            for (size_t j = 0; j < items; ++j) {
+                const JSON_Value* value = json_object_get_value(json_array_get_object(events[i].payload, j), columns[c].key);
+                JSON_Value* cell = NULL;
+                if (value == NULL) {
+                    cell = json_value_init_null();
+                } else if (columns[c].isString) {
+                    cell = ColumnarMessage_GetStringCell(table, json_value_get_string(value));
+                } else {
+                    cell = json_value_deep_copy(value);
+                }
+
+                if (cell == NULL || json_array_append_value(json_value_get_array(column), cell) != JSONSuccess) {
+                    if (cell != NULL) {
+                        json_value_free(cell);
+                    }
+                    goto cleanup;
+                }
+            }
+        }
+
+        if (json_object_set_value(json_value_get_object(columns[c].isString ? payloadStrings : payload), columns[c].key, column) != JSONSuccess) {
+            goto cleanup;
+        }
+        column = NULL;
+    }
+
+    if (json_object_set_value(group, COLUMNAR_PAYLOAD_COUNTS_KEY, counts) != JSONSuccess) {
+        goto cleanup;
+    }
+    counts = NULL;
+
+    if (json_object_get_count(json_value_get_object(payload)) > 0) {
+        if (json_object_set_value(group, PAYLOAD_KEY, payload) != JSONSuccess) {
+            goto cleanup;
+        }
+        payload = NULL;
+    }
+
+    if (json_object_get_count(json_value_get_object(payloadStrings)) > 0) {
+        if (json_object_set_value(group, COLUMNAR_PAYLOAD_STRINGS_KEY, payloadStrings) != JSONSuccess) {
+            goto cleanup;
+        }
+        payloadStrings = NULL;
+    }
+
+    success = true;
+
+cleanup:
+    if (columns != NULL) {
+        free(columns);
+    }
+    if (column != NULL) {
+        json_value_free(column);
+    }
+    if (counts != NULL) {
+        json_value_free(counts);
+    }
+    if (payload != NULL) {
+        json_value_free(payload);
+    }
+    if (payloadStrings != NULL) {
+        json_value_free(payloadStrings);
+    }
+
+    return success;
+}
+
+static bool ColumnarMessage_WriteGroup(JSON_Array* groups, const ColumnarEvent* events, uint32_t count, uint32_t groupIndex, ColumnarStringTable* table) {
+    JSON_Value* groupValue = json_value_init_object();
+    if (groupValue == NULL) {
+        return false;
+    }
+    JSON_Object* group = json_value_get_object(groupValue);
+
+    uint32_t first = 0;
+    while (events[first].group != groupIndex) {
+        ++first;
+    }
+
+    bool success =
+        json_object_set_string(group, EVENT_CATEGORY_KEY, events[first].category) == JSONSuccess &&
+        json_object_set_string(group, EVENT_TYPE_KEY, events[first].eventType) == JSONSuccess &&
+        json_object_set_string(group, EVENT_NAME_KEY, events[first].name) == JSONSuccess &&
+        json_object_set_string(group, EVENT_PAYLOAD_SCHEMA_VERSION_KEY, events[first].payloadSchemaVersion) == JSONSuccess &&
+        ColumnarMessage_WriteMetadataColumns(group, events, count, groupIndex) &&
+        ColumnarMessage_WritePayloadColumns(group, events, count, groupIndex, table) &&
+        json_array_append_value(groups, groupValue) == JSONSuccess;
+
+    if (!success) {
+        json_value_free(groupValue);
+    }
+    return success;
+}
+
+bool ColumnarMessage_Transcode(const char* message, char** output, uint32_t* outputSize) {
+    bool success = false;
+    ColumnarEvent* events = NULL;
+    uint32_t* groupFirstEvents = NULL;
+    ColumnarStringTable table = { 0 };
+    JSON_Value* columnarValue = NULL;
+    char* buffer = NULL;
+
+    JSON_Value* messageValue = json_parse_string(message);
+    const JSON_Object* messageObject = json_value_get_object(messageValue);
+    const JSON_Array* eventsArray = json_object_get_array(messageObject, EVENTS_KEY);
+    size_t count = json_array_get_count(eventsArray);
+    if (eventsArray == NULL || count == 0 || count >= UINT32_MAX) {
+        goto cleanup;
+    }
+
+    events = calloc(count, sizeof(ColumnarEvent));
+    groupFirstEvents = calloc(count, sizeof(uint32_t));
+    if (events == NULL || groupFirstEvents == NULL) {
+        Logger_Error("Error allocating the columnar message");
+        goto cleanup;
+    }
+
+    uint32_t numberOfGroups = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!ColumnarMessage_ReadEvent(json_array_get_value(eventsArray, i), &events[i])) {
+            goto cleanup;
+        }
+
+        uint32_t group = 0;
+        while (group < numberOfGroups && !ColumnarMessage_IsSameGroup(&events[groupFirstEvents[group]], &events[i])) {
+            ++group;
+        }
+        if (group == numberOfGroups) {
+            groupFirstEvents[numberOfGroups++] = i;
+        }
+        events[i].group = group;
+    }
+
+    if (!ColumnarMessage_CountStrings(&table, events, count)) {
+        Logger_Error("Error allocating the string table of the columnar message");
+        goto cleanup;
+    }
+
+    columnarValue = json_value_init_object();
+    if (columnarValue == NULL) {
+        goto cleanup;
+    }
+    JSON_Object* columnar = json_value_get_object(columnarValue);
+
+    // the envelope is kept as is, the events array is replaced by the groups
+    size_t members = json_object_get_count(messageObject);
+    for (size_t i = 0; i < members; ++i) {
+        const char* key = json_object_get_name(messageObject, i);
+        if (strcmp(key, EVENTS_KEY) == 0) {
+            continue;
+        }
+        JSON_Value* member = json_value_deep_copy(json_object_get_value_at(messageObject, i));
+        if (member == NULL || json_object_set_value(columnar, key, member) != JSONSuccess) {
+            if (member != NULL) {
+                json_value_free(member);
+            }
+            goto cleanup;
+        }
+    }
+
+    JSON_Value* strings = json_value_init_array();
+    if (json_object_set_string(columnar, MESSAGE_LAYOUT_KEY, MESSAGE_LAYOUT_COLUMNAR) != JSONSuccess ||
+        strings == NULL || json_object_set_value(columnar, COLUMNAR_STRINGS_KEY, strings) != JSONSuccess) {
+        if (strings != NULL) {
+            json_value_free(strings);
+        }
+        goto cleanup;
+    }
+    table.strings = json_value_get_array(strings);
+
+    JSON_Value* groups = json_value_init_array();
+    if (groups == NULL || json_object_set_value(columnar, COLUMNAR_EVENT_GROUPS_KEY, groups) != JSONSuccess) {
+        if (groups != NULL) {
+            json_value_free(groups);
+        }
+        goto cleanup;
+    }
+
+    for (uint32_t group = 0; group < numberOfGroups; ++group) {
+        if (!ColumnarMessage_WriteGroup(json_value_get_array(groups), events, count, group, &table)) {
+            goto cleanup;
+        }
+    }
+
+    size_t size = json_serialization_size(columnarValue);
+    if (size == 0 || size > UINT32_MAX) {
+        goto cleanup;
+    }
+    buffer = malloc(size);
+    if (buffer == NULL || json_serialize_to_buffer(columnarValue, buffer, size) != JSONSuccess) {
+        Logger_Error("Error serializing the columnar message");
+        goto cleanup;
+    }
+
+    *output = buffer;
+    *outputSize = (uint32_t)size - 1;
+    buffer = NULL;
+    success = true;
+
+cleanup:
+    if (buffer != NULL) {
+        free(buffer);
+    }
+    if (columnarValue != NULL) {
+        json_value_free(columnarValue);
+    }
+    if (table.entries != NULL) {
+        free(table.entries);
+    }
+    if (groupFirstEvents != NULL) {
+        free(groupFirstEvents);
+    }
+    if (events != NULL) {
+        free(events);
+    }
+    if (messageValue != NULL) {
+        json_value_free(messageValue);
+    }
+
+    return success;
+}
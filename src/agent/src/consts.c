@@ -27,12 +27,64 @@ const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_PATH = NULL;
 
 const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH = NULL;
 
+const bool DEFAULT_MESSAGE_COMPRESSION_ENABLED = false;
+
+const bool DEFAULT_COLUMNAR_MESSAGES_ENABLED = false;
+
+uint32_t DEFAULT_MAX_IN_FLIGHT_MESSAGES = 4;
+
 const uint32_t SCHEDULER_INTERVAL = 1 * 1000;
 
 const uint32_t TWIN_UPDATE_SCHEDULER_INTERVAL = 10 * 1000;
 
+const uint32_t PUBLISHER_MAX_WAIT_INTERVAL = 60 * 1000;
+
+const uint32_t IOTHUB_DO_WORK_INTERVAL = 100;
+
+const uint32_t SEND_RETRY_INITIAL_INTERVAL = 2 * 1000;
+
+const uint32_t SEND_RETRY_MAX_INTERVAL = 2 * 60 * 1000;
+
+const uint32_t SEND_MAX_ATTEMPTS = 8;
+
+const uint32_t RECONNECT_INITIAL_INTERVAL = 5 * 1000;
+
+const uint32_t RECONNECT_MAX_INTERVAL = 5 * 60 * 1000;
+
+const uint32_t SNAPSHOT_COLLECTOR_WORKERS = 2;
+
+const uint32_t TRIGGERED_COLLECTOR_WORKERS = 1;
+
+const uint32_t SNAPSHOT_COLLECTOR_DEFAULT_BUDGET = 2 * 60 * 1000;
+
+const uint32_t TRIGGERED_COLLECTOR_DEFAULT_BUDGET = 30 * 1000;
+
+const uint32_t AUDIT_SEARCH_MAX_EVENTS_PER_RUN = 20000;
+
+const uint32_t AUDIT_SEARCH_MAX_DURATION_PER_RUN = 10 * 1000;
+
+const char AUDIT_STREAM_SOCKET_PATH[] = "/var/run/audispd_events";
+
+const uint32_t AUDIT_STREAM_RECONNECT_INTERVAL = 30 * 1000;
+
+const uint32_t AUDIT_STREAM_MAX_BUFFER_SIZE = 1024 * 1024;
+
+const char AUDIT_LOG_FILE_PATH[] = "/var/log/audit/audit.log";
+
+const uint32_t AUDIT_LOG_CHUNK_SIZE = 256 * 1024;
+
+const uint32_t AUDIT_LOG_MAX_ROTATED_FILES = 999;
+
+const uint32_t DIAGNOSTIC_EVENT_QUEUE_CAPACITY = 1024;
+const uint32_t HIGH_PRIORITY_QUEUE_RESERVED_MEMORY_PERCENT = 20;
+const uint32_t LOW_PRIORITY_QUEUE_RESERVED_MEMORY_PERCENT = 10;
+const char DEFAULT_SPILL_LOG_DIRECTORY[] = "/var/lib/ASCIoTAgent/spill";
+const uint32_t DEFAULT_SPILL_LOG_DISK_QUOTA = 16 * 1024 * 1024;
+
 const uint32_t MESSAGE_BILLING_MULTIPLE = 4 * 1024;
 
+const uint32_t MESSAGE_ENVELOPE_RESERVED_SIZE = 1024;
+
 const char CONFIGURATION_FILE[] = "/LocalConfiguration.json";
 
 const char* TCP_PROTOCOL = "tcp";
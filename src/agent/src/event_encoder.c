@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "event_encoder.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cbor_writer.h"
+#include "json/json_object_writer.h"
+#include "json/json_writer.h"
+#include "logger.h"
+#include "parson.h"
+
+// a map of this major type starts every cbor encoded object
+#define EVENT_ENCODER_CBOR_MAP_MASK 0xE0
+#define EVENT_ENCODER_CBOR_MAP_TYPE 0xA0
+
+/**
+ * An encoding of the events and of the security message.
+ */
+typedef struct _EventEncoderOps {
+
+    JsonWriterResult (*encodeObject)(JsonObjectWriterHandle object, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size);
+    JsonWriterResult (*encodeEnvelope)(const char** keys, const char** values, uint32_t count, const char* eventsKey, char** output, uint32_t* size);
+    bool (*isObject)(const void* data, uint32_t size);
+    EventFraming framing;
+
+} EventEncoderOps;
+
+/**
+ * @brief Encodes the object with parson, the original wire format of the agent.
+ */
+static JsonWriterResult EventEncoder_EncodeJsonObject(JsonObjectWriterHandle object, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size);
+
+/**
+ * @brief Encodes the json envelope, the members are escaped by parson and the closing brace is replaced by the events array.
+ */
+static JsonWriterResult EventEncoder_EncodeJsonEnvelope(const char** keys, const char** values, uint32_t count, const char* eventsKey, char** output, uint32_t* size);
+
+/**
+ * @brief Checks that the data is a json object.
+ */
+static bool EventEncoder_IsJsonObject(const void* data, uint32_t size);
+
+/**
+ * @brief Encodes the object as cbor, walking the parson tree directly into the byte buffer of the writer.
+ */
+static JsonWriterResult EventEncoder_EncodeCborObject(JsonObjectWriterHandle object, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size);
+
+/**
+ * @brief Encodes the cbor envelope, a map of the members and the events array, which is left open until its break.
+ */
+static JsonWriterResult EventEncoder_EncodeCborEnvelope(const char** keys, const char** values, uint32_t count, const char* eventsKey, char** output, uint32_t* size);
+
+/**
+ * @brief Checks that the data is a cbor map.
+ */
+static bool EventEncoder_IsCborObject(const void* data, uint32_t size);
+
+/**
+ * @brief Writes the given json value, and everything it contains, to the cbor writer.
+ *
+ * @param   writer      The cbor writer.
+ * @param   value       The json value.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool EventEncoder_WriteCborValue(CborWriter* writer, const JSON_Value* value);
+
+/**
+ * @brief The allocation function of the envelope, the serializer frees it.
+ */
+static void* EventEncoder_Allocate(uint32_t size);
+
+static const EventEncoderOps JSON_ENCODER = {
+    EventEncoder_EncodeJsonObject,
+    EventEncoder_EncodeJsonEnvelope,
+    EventEncoder_IsJsonObject,
+    { ",", 1, "]}", 2 }
+};
+
+// the envelope map has a definite length, so the break of the events array closes the message as well
+static const EventEncoderOps CBOR_ENCODER = {
+    EventEncoder_EncodeCborObject,
+    EventEncoder_EncodeCborEnvelope,
+    EventEncoder_IsCborObject,
+    { "", 0, "\xFF", 1 }
+};
+
+/**
+ * @brief Returns the operations of the given encoding, unknown encodings fall back to json.
+ */
+static const EventEncoderOps* EventEncoder_GetOps(EventEncoding encoding) {
+    return encoding == EVENT_ENCODING_CBOR ? &CBOR_ENCODER : &JSON_ENCODER;
+}
+
+JsonWriterResult EventEncoder_EncodeObject(EventEncoding encoding, JsonObjectWriterHandle object, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size) {
+    return EventEncoder_GetOps(encoding)->encodeObject(object, allocate, release, output, size);
+}
+
+JsonWriterResult EventEncoder_EncodeEnvelope(EventEncoding encoding, const char** keys, const char** values, uint32_t count, const char* eventsKey, char** output, uint32_t* size) {
+    return EventEncoder_GetOps(encoding)->encodeEnvelope(keys, values, count, eventsKey, output, size);
+}
+
+bool EventEncoder_IsObject(EventEncoding encoding, const void* data, uint32_t size) {
+    return EventEncoder_GetOps(encoding)->isObject(data, size);
+}
+
+const EventFraming* EventEncoder_GetFraming(EventEncoding encoding) {
+    return &EventEncoder_GetOps(encoding)->framing;
+}
+
+static void* EventEncoder_Allocate(uint32_t size) {
+    return malloc(size);
+}
+
+static JsonWriterResult EventEncoder_EncodeJsonObject(JsonObjectWriterHandle object, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size) {
+    return JsonObjectWriter_SerializeWithAllocator(object, allocate, release, output, size);
+}
+
+static JsonWriterResult EventEncoder_EncodeJsonEnvelope(const char** keys, const char** values, uint32_t count, const char* eventsKey, char** output, uint32_t* size) {
+    JsonWriterResult result = JSON_WRITER_OK;
+    char* envelope = NULL;
+    uint32_t envelopeSize = 0;
+
+    JsonObjectWriterHandle envelopeWriter = NULL;
+    if (JsonObjectWriter_Init(&envelopeWriter) != JSON_WRITER_OK) {
+        Logger_Error("Error initializing the security message writer");
+        result = JSON_WRITER_EXCEPTION;
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (JsonObjectWriter_WriteString(envelopeWriter, keys[i], values[i]) != JSON_WRITER_OK) {
+            Logger_Error("Error setting %s of the security message", keys[i]);
+            result = JSON_WRITER_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    // the envelope is small and serialized once per message, so parson still takes care of escaping the agent details
+    if (JsonObjectWriter_Serialize(envelopeWriter, &envelope, &envelopeSize) != JSON_WRITER_OK || envelopeSize < 2 || envelope[envelopeSize - 1] != '}') {
+        Logger_Error("Error serialing the security message");
+        result = JSON_WRITER_EXCEPTION;
+        goto cleanup;
+    }
+
+    // the closing brace is dropped, the events array is the last member of the message
+    uint32_t eventsKeySize = strlen(eventsKey);
+    uint32_t outputSize = envelopeSize - 1 + 2 + eventsKeySize + 3;
+    char* buffer = malloc(outputSize + 1);
+    if (buffer == NULL) {
+        Logger_Error("Error allocating the security message");
+        result = JSON_WRITER_EXCEPTION;
+        goto cleanup;
+    }
+
+    memcpy(buffer, envelope, envelopeSize - 1);
+    memcpy(buffer + envelopeSize - 1, ",\"", 2);
+    memcpy(buffer + envelopeSize + 1, eventsKey, eventsKeySize);
+    memcpy(buffer + envelopeSize + 1 + eventsKeySize, "\":[", 3);
+    buffer[outputSize] = '\0';
+
+    *output = buffer;
+    *size = outputSize;
+
+cleanup:
+    if (envelope != NULL) {
+        free(envelope);
+    }
+
+    if (envelopeWriter != NULL) {
+        JsonObjectWriter_Deinit(envelopeWriter);
+    }
+
+    return result;
+}
+
+static bool EventEncoder_IsJsonObject(const void* data, uint32_t size) {
+    return size > 0 && ((const char*)data)[0] == '{';
+}
+
+static JsonWriterResult EventEncoder_EncodeCborObject(JsonObjectWriterHandle object, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size) {
+    // the output is allocated once it is complete, at its exact size, so it is never released on failure
+    (void)release;
+
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    JsonWriterResult result = JSON_WRITER_OK;
+    if (!EventEncoder_WriteCborValue(&writer, ((JsonObjectWriter*)object)->rootValue) || !CborWriter_Finish(&writer, allocate, output, size)) {
+        result = JSON_WRITER_EXCEPTION;
+    }
+
+    CborWriter_Deinit(&writer);
+    return result;
+}
+
+static JsonWriterResult EventEncoder_EncodeCborEnvelope(const char** keys, const char** values, uint32_t count, const char* eventsKey, char** output, uint32_t* size) {
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    bool success = CborWriter_WriteMapHeader(&writer, count + 1);
+    for (uint32_t i = 0; success && i < count; ++i) {
+        success = CborWriter_WriteString(&writer, keys[i]) && CborWriter_WriteString(&writer, values[i]);
+    }
+
+    success = success &&
+        CborWriter_WriteString(&writer, eventsKey) &&
+        CborWriter_BeginIndefiniteArray(&writer) &&
+        CborWriter_Finish(&writer, EventEncoder_Allocate, output, size);
+    if (!success) {
+        Logger_Error("Error encoding the security message");
+    }
+
+    CborWriter_Deinit(&writer);
+    return success ? JSON_WRITER_OK : JSON_WRITER_EXCEPTION;
+}
+
+static bool EventEncoder_IsCborObject(const void* data, uint32_t size) {
+    return size > 0 && (((const uint8_t*)data)[0] & EVENT_ENCODER_CBOR_MAP_MASK) == EVENT_ENCODER_CBOR_MAP_TYPE;
+}
+
+static bool EventEncoder_WriteCborValue(CborWriter* writer, const JSON_Value* value) {
+    switch (json_value_get_type(value)) {
+        case JSONObject: {
+            const JSON_Object* object = json_value_get_object(value);
+            size_t count = json_object_get_count(object);
+            if (count > UINT32_MAX || !CborWriter_WriteMapHeader(writer, (uint32_t)count)) {
+                return false;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (!CborWriter_WriteString(writer, json_object_get_name(object, i)) ||
+                    !EventEncoder_WriteCborValue(writer, json_object_get_value_at(object, i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case JSONArray: {
+            const JSON_Array* array = json_value_get_array(value);
+            size_t count = json_array_get_count(array);
+            if (count > UINT32_MAX || !CborWriter_WriteArrayHeader(writer, (uint32_t)count)) {
+                return false;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (!EventEncoder_WriteCborValue(writer, json_array_get_value(array, i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case JSONString:
+            return CborWriter_WriteString(writer, json_value_get_string(value));
+        case JSONNumber:
+            return CborWriter_WriteDouble(writer, json_value_get_number(value));
+        case JSONBoolean:
+            return CborWriter_WriteBool(writer, json_value_get_boolean(value) == 1);
+        case JSONNull:
+            return CborWriter_WriteNull(writer);
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "eviction_policy.h"
+
+#include <string.h>
+
+/**
+ * @brief Returns the field of the eviction counter which counts the given priority.
+ */
+static uint32_t* EvictionPolicy_GetCounterField(EvictionPolicy* policy, QueuePriority priority) {
+    EvictionCounter* counter = &policy->counter.counter.evictionCounter;
+    switch (priority) {
+        case QUEUE_PRIORITY_LOW:
+            return &counter->lowPriority;
+        case QUEUE_PRIORITY_AGGREGATED:
+            return &counter->aggregated;
+        default:
+            return &counter->highPriority;
+    }
+}
+
+bool EvictionPolicy_Init(EvictionPolicy* policy) {
+    memset(policy, 0, sizeof(*policy));
+    return AgentTelemetryCounter_Init(&policy->counter);
+}
+
+void EvictionPolicy_Deinit(EvictionPolicy* policy) {
+    AgentTelemetryCounter_Deinit(&policy->counter);
+    policy->numberOfQueues = 0;
+}
+
+bool EvictionPolicy_AddQueue(EvictionPolicy* policy, SyncQueue* syncQueue, QueuePriority priority) {
+    if (policy->numberOfQueues == EVICTION_POLICY_MAX_QUEUES) {
+        return false;
+    }
+
+    if (!SyncQueue_SetEvictionPolicy(syncQueue, priority, EvictionPolicy_Evict, policy)) {
+        return false;
+    }
+
+    policy->queues[policy->numberOfQueues] = syncQueue;
+    ++policy->numberOfQueues;
+    return true;
+}
+
+bool EvictionPolicy_Evict(void* evictParams, Queue* queue, QueuePriority priority) {
+    EvictionPolicy* policy = (EvictionPolicy*)evictParams;
+
+    for (QueuePriority evictedPriority = QUEUE_PRIORITY_LOW; evictedPriority < priority; ++evictedPriority) {
+        for (uint32_t i = 0; i < policy->numberOfQueues; ++i) {
+            SyncQueue* syncQueue = policy->queues[i];
+            int result = QUEUE_IS_EMPTY;
+
+            if (&syncQueue->queue == queue) {
+                // the caller already holds the lock of its own queue
+                result = Queue_EvictOldest(queue, evictedPriority);
+            } else if (syncQueue->queue.priority < queue->priority && Queue_ConsumesSharedMemory(&syncQueue->queue)) {
+                result = SyncQueue_EvictOldest(syncQueue, evictedPriority);
+            }
+
+            if (result == QUEUE_OK) {
+                AgentTelemetryCounter_IncreaseBy(&policy->counter, EvictionPolicy_GetCounterField(policy, evictedPriority), 1);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+SyncedCounter* EvictionPolicy_GetCounter(EvictionPolicy* policy) {
+    return &policy->counter;
+}
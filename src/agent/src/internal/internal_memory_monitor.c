@@ -4,44 +4,189 @@
 #include "internal/internal_memory_monitor.h"
 
 #include "consts.h"
-#include "twin_configuration.h"
 
+// all the state is updated with atomic operations, so the monitor is safe to use from any thread without a lock
 static uint32_t currentConsumptionInBytes;
 static uint32_t memoryLimitInBytes;
+// the sum of the reservations of all the budgets, in percents of the limit
+static uint32_t reservedPercent;
+// the bytes consumed from the pool which is not reserved by any budget
+static uint32_t sharedConsumptionInBytes;
+
+// the usage of a budget packs its consumption and the part of it charged to the shared pool, so both are updated at once
+#define BUDGET_USAGE(consumed, charged) (((uint64_t)(charged) << 32) | (consumed))
+#define BUDGET_CONSUMED(usage) ((uint32_t)(usage))
+#define BUDGET_CHARGED(usage) ((uint32_t)((usage) >> 32))
+
+/**
+ * @brief Returns the part of the given consumption of a budget which exceeds its reservation.
+ */
+static uint32_t InternalMemoryMonitor_Excess(uint32_t consumed, uint32_t reserved) {
+    return consumed > reserved ? consumed - reserved : 0;
+}
+
+/**
+ * @brief Returns the given percents of the current limit.
+ */
+static uint32_t InternalMemoryMonitor_PercentOfLimit(uint32_t percent) {
+    return (uint32_t)((uint64_t)__atomic_load_n(&memoryLimitInBytes, __ATOMIC_RELAXED) * percent / 100);
+}
+
+/**
+ * @brief Takes the given amount of bytes from the shared pool.
+ * 
+ * @return MEMORY_MONITOR_OK on success or MEMORY_MONITOR_MEMORY_EXCEEDED if the pool is exhausted.
+ */
+static MemoryMonitorResultValues InternalMemoryMonitor_ChargeSharedPool(uint32_t size) {
+    uint32_t shared = __atomic_load_n(&sharedConsumptionInBytes, __ATOMIC_RELAXED);
+    do {
+        uint32_t limit = __atomic_load_n(&memoryLimitInBytes, __ATOMIC_RELAXED);
+        uint32_t reserved = InternalMemoryMonitor_PercentOfLimit(__atomic_load_n(&reservedPercent, __ATOMIC_RELAXED));
+        uint64_t pool = limit > reserved ? limit - reserved : 0;
+        if ((uint64_t)shared + size > pool) {
+            return MEMORY_MONITOR_MEMORY_EXCEEDED;
+        }
+    } while (!__atomic_compare_exchange_n(&sharedConsumptionInBytes, &shared, shared + size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return MEMORY_MONITOR_OK;
+}
 
 void InternalMemoryMonitor_Init() {
-    memoryLimitInBytes = DEFAULT_MAX_LOCAL_CACHE_SIZE;
-    currentConsumptionInBytes = 0;
+    __atomic_store_n(&memoryLimitInBytes, DEFAULT_MAX_LOCAL_CACHE_SIZE, __ATOMIC_RELAXED);
+    __atomic_store_n(&currentConsumptionInBytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&reservedPercent, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&sharedConsumptionInBytes, 0, __ATOMIC_RELAXED);
 }
 
 void InternalMemoryMonitor_Deinit() {
-    currentConsumptionInBytes = 0;
-    memoryLimitInBytes = 0;
+    __atomic_store_n(&currentConsumptionInBytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memoryLimitInBytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&reservedPercent, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&sharedConsumptionInBytes, 0, __ATOMIC_RELAXED);
 }
 
 MemoryMonitorResultValues InternalMemoryMonitor_Consume(uint32_t size) {
-    if (TwinConfiguration_GetMaxLocalCacheSize(&memoryLimitInBytes) != TWIN_OK) {
-        return MEMORY_MONITOR_EXCEPTION;
+    // a budget which holds more than its reservation after the limit was lowered is charged for it only when it grows
+    uint64_t current = __atomic_load_n(&currentConsumptionInBytes, __ATOMIC_RELAXED);
+    if (current + size > __atomic_load_n(&memoryLimitInBytes, __ATOMIC_RELAXED)) {
+        return MEMORY_MONITOR_MEMORY_EXCEEDED;
     }
 
-    if (currentConsumptionInBytes + size > memoryLimitInBytes) {
-        return MEMORY_MONITOR_MEMORY_EXCEEDED;
+    MemoryMonitorResultValues result = InternalMemoryMonitor_ChargeSharedPool(size);
+    if (result != MEMORY_MONITOR_OK) {
+        return result;
     }
 
-    currentConsumptionInBytes += size;
+    __atomic_add_fetch(&currentConsumptionInBytes, size, __ATOMIC_RELAXED);
     return MEMORY_MONITOR_OK;
 }
 
+void InternalMemoryMonitor_ForceConsume(uint32_t size) {
+    __atomic_add_fetch(&sharedConsumptionInBytes, size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&currentConsumptionInBytes, size, __ATOMIC_RELAXED);
+}
+
 MemoryMonitorResultValues InternalMemoryMonitor_Release(uint32_t size) {
-    if (size > currentConsumptionInBytes) {
-        return MEMORY_MONITOR_INVALID_RELEASE_SIZE;
-    }
+    uint32_t shared = __atomic_load_n(&sharedConsumptionInBytes, __ATOMIC_RELAXED);
+    do {
+        if (size > shared) {
+            return MEMORY_MONITOR_INVALID_RELEASE_SIZE;
+        }
+    } while (!__atomic_compare_exchange_n(&sharedConsumptionInBytes, &shared, shared - size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-    currentConsumptionInBytes -= size;
+    __atomic_sub_fetch(&currentConsumptionInBytes, size, __ATOMIC_RELAXED);
     return MEMORY_MONITOR_OK;
 }
 
 MemoryMonitorResultValues InternalMemoryMonitor_CurrentConsumption(uint32_t* sizeInBytes) {
-    *sizeInBytes = currentConsumptionInBytes;
+    *sizeInBytes = __atomic_load_n(&currentConsumptionInBytes, __ATOMIC_RELAXED);
+    return MEMORY_MONITOR_OK;
+}
+
+void InternalMemoryMonitor_SetLimit(uint32_t limitInBytes) {
+    __atomic_store_n(&memoryLimitInBytes, limitInBytes, __ATOMIC_RELAXED);
+}
+
+MemoryMonitorResultValues InternalMemoryMonitor_InitBudget(MemoryBudget* budget, uint32_t reservedPercentOfLimit) {
+    uint32_t reserved = __atomic_load_n(&reservedPercent, __ATOMIC_RELAXED);
+    do {
+        if (reserved + reservedPercentOfLimit > 100) {
+            return MEMORY_MONITOR_MEMORY_EXCEEDED;
+        }
+    } while (!__atomic_compare_exchange_n(&reservedPercent, &reserved, reserved + reservedPercentOfLimit, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    budget->reservedPercent = reservedPercentOfLimit;
+    budget->usage = 0;
     return MEMORY_MONITOR_OK;
 }
+
+void InternalMemoryMonitor_DeinitBudget(MemoryBudget* budget) {
+    __atomic_sub_fetch(&reservedPercent, budget->reservedPercent, __ATOMIC_RELAXED);
+    budget->reservedPercent = 0;
+}
+
+MemoryMonitorResultValues InternalMemoryMonitor_ConsumeFromBudget(MemoryBudget* budget, uint32_t size) {
+    uint64_t usage = __atomic_load_n(&budget->usage, __ATOMIC_RELAXED);
+    while (true) {
+        uint32_t consumed = BUDGET_CONSUMED(usage);
+        uint32_t charged = BUDGET_CHARGED(usage);
+        if ((uint64_t)consumed + size > UINT32_MAX) {
+            return MEMORY_MONITOR_MEMORY_EXCEEDED;
+        }
+
+        // the reservation follows the current limit, so a lowered limit charges the shared pool
+        // for the part of the consumption which no longer fits in the reservation
+        uint32_t newCharged = InternalMemoryMonitor_Excess(consumed + size, InternalMemoryMonitor_PercentOfLimit(budget->reservedPercent));
+        uint32_t charge = newCharged > charged ? newCharged - charged : 0;
+        uint32_t refund = newCharged < charged ? charged - newCharged : 0;
+
+        // the shared pool is charged before the budget is updated, and refunded if another thread updated the budget in between
+        if (charge > 0 && InternalMemoryMonitor_ChargeSharedPool(charge) != MEMORY_MONITOR_OK) {
+            return MEMORY_MONITOR_MEMORY_EXCEEDED;
+        }
+
+        if (__atomic_compare_exchange_n(&budget->usage, &usage, BUDGET_USAGE(consumed + size, newCharged), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            if (refund > 0) {
+                __atomic_sub_fetch(&sharedConsumptionInBytes, refund, __ATOMIC_RELAXED);
+            }
+            break;
+        }
+
+        if (charge > 0) {
+            __atomic_sub_fetch(&sharedConsumptionInBytes, charge, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_add_fetch(&currentConsumptionInBytes, size, __ATOMIC_RELAXED);
+    return MEMORY_MONITOR_OK;
+}
+
+MemoryMonitorResultValues InternalMemoryMonitor_ReleaseToBudget(MemoryBudget* budget, uint32_t size) {
+    uint64_t usage = __atomic_load_n(&budget->usage, __ATOMIC_RELAXED);
+    uint32_t refund = 0;
+    while (true) {
+        uint32_t consumed = BUDGET_CONSUMED(usage);
+        uint32_t charged = BUDGET_CHARGED(usage);
+        if (size > consumed) {
+            return MEMORY_MONITOR_INVALID_RELEASE_SIZE;
+        }
+
+        // the part charged to the shared pool is released first, a release never charges the pool
+        uint32_t excess = InternalMemoryMonitor_Excess(consumed - size, InternalMemoryMonitor_PercentOfLimit(budget->reservedPercent));
+        uint32_t newCharged = excess < charged ? excess : charged;
+        refund = charged - newCharged;
+        if (__atomic_compare_exchange_n(&budget->usage, &usage, BUDGET_USAGE(consumed - size, newCharged), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (refund > 0) {
+        __atomic_sub_fetch(&sharedConsumptionInBytes, refund, __ATOMIC_RELAXED);
+    }
+    __atomic_sub_fetch(&currentConsumptionInBytes, size, __ATOMIC_RELAXED);
+    return MEMORY_MONITOR_OK;
+}
+
+bool InternalMemoryMonitor_IsBeyondReservation(MemoryBudget* budget) {
+    return BUDGET_CONSUMED(__atomic_load_n(&budget->usage, __ATOMIC_RELAXED)) > InternalMemoryMonitor_PercentOfLimit(budget->reservedPercent);
+}
@@ -3,27 +3,32 @@
 
 #include "iothub_adapter.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "azure_c_shared_utility/threadapi.h"
 #include "iothub_client_options.h"
-#include "iothubtransportamqp.h"
 
 #include "consts.h"
+#include "internal/time_utils.h"
 #include "local_config.h"
 #include "logger.h"
 #include "message_schema_consts.h"
 #include "tasks/update_twin_task.h"
+#include "transport/hub_transport.h"
+#include "transport/local_transport.h"
 #include "agent_errors.h"
 
-#ifdef USE_MQTT
-#include "iothubtransportmqtt.h"
-IOTHUB_CLIENT_TRANSPORT_PROVIDER protocol = MQTT_Protocol;
-#endif
-#ifdef USE_AMQP
-#include "iothubtransportamqp.h"
-IOTHUB_CLIENT_TRANSPORT_PROVIDER protocol = AMQP_Protocol;
-#endif
+/**
+ * The context of a message whose confirmation is reported to a callback of the sender.
+ */
+typedef struct _IoTHubAdapterSendContext {
+
+    IoTHubAdapter* adapter;
+    IoTHubAdapterSendConfirmation callback;
+    void* context;
+
+} IoTHubAdapterSendContext;
 
 /**
  * @brief This function is called upon receiving confirmation of the delivery of the IoT Hub message
@@ -33,6 +38,15 @@ IOTHUB_CLIENT_TRANSPORT_PROVIDER protocol = AMQP_Protocol;
  */
 static void IoTHubAdapter_SendConfirmCallback(IOTHUB_CLIENT_CONFIRMATION_RESULT result, void* userContextCallback);
 
+/**
+ * @brief This function is called upon receiving confirmation of the delivery of an IoT Hub message which was sent with a confirmation callback.
+ *        The confirmation is reported to the callback of the sender, and the context of the message is freed.
+ *
+ * @param   result                  The result of the callback
+ * @param   userContextCallback     The IoTHubAdapterSendContext of the message.
+ */
+static void IoTHubAdapter_SendConfirmWithCallback(IOTHUB_CLIENT_CONFIRMATION_RESULT result, void* userContextCallback);
+
 /**
  * @brief This function is called upon receiving confirmation of setting up device twin reported properties
  *
@@ -78,25 +92,58 @@ static bool IoTHubAdapter_Init_Internal(IoTHubAdapter* iotHubAdapter, SyncQueue*
 static void IoTHubAdapter_Deinit_Internal(IoTHubAdapter* iotHubAdapter);
 
 /**
- * @brief Re-initiate a new IoT hub module client
+ * @brief Creates the transport of the adapter and registers the callbacks of the adapter with it.
+ *        On failure the transport which was created is left for the caller to destroy.
  *
- * @param   iotHubAdapter       The adapter to initiate.
- * @param   twinUpdatesQueue    The queue which will contain all the twin updates
+ * @param   iotHubAdapter   The adapter.
  *
  * @return true on success, false otherwise.
  */
-static bool IoTHubAdapter_Reinit(IoTHubAdapter* iotHubAdapter, SyncQueue* twinUpdatesQueue);
+static bool IoTHubAdapter_CreateTransport(IoTHubAdapter* iotHubAdapter);
+
+/**
+ * @brief Destroys the transport of the adapter, if it was created.
+ *
+ * @param   iotHubAdapter   The adapter.
+ */
+static void IoTHubAdapter_DestroyTransport(IoTHubAdapter* iotHubAdapter);
+
+/**
+ * @brief Recreates the transport after the connection was lost, called on the thread of the reconnect worker.
+ *        The connection string is renewed first if the agent is provisioned with DPS.
+ *
+ * @param   context     The adapter.
+ *
+ * @return true if the transport was recreated, false otherwise.
+ */
+static bool IoTHubAdapter_Reconnect(void* context);
 
 /**
  * @brief Send message a-sync to the hub (internal function).
  *
- * @param   iotHubAdapter   The adapter to send data with.
- * @param   data            The data to send.
- * @param   dataSize        The size of the data we want to send.
+ * @param   iotHubAdapter           The adapter to send data with.
+ * @param   data                    The data to send.
+ * @param   dataSize                The size of the data we want to send.
+ * @param   contentType             The content type of the data, NULL for json.
+ * @param   contentEncoding         The content encoding of the data, NULL for plain data.
+ * @param   confirmationCallback    The callback to report the confirmation to, NULL to only count failed messages.
+ * @param   context                 The context to pass to the callback.
  *
  * @return true on success, false otherwise.
  */
-static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize);
+static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding, IoTHubAdapterSendConfirmation confirmationCallback, void* context);
+
+/**
+ * @brief Drives the transport if it has no thread of its own (internal function, the caller serializes the calls to the transport).
+ *
+ * @param   iotHubAdapter   The adapter to drive.
+ */
+static void IoTHubAdapter_DoWork_Internal(IoTHubAdapter* iotHubAdapter);
+
+/**
+ * @brief Returns the transport which was configured.
+ */
+static const TransportInterface* IoTHubAdapter_GetTransport();
 
 static LOCK_HANDLE iotHubAdapterLock = NULL;
 
@@ -114,6 +161,12 @@ bool IoTHubAdapter_Init(IoTHubAdapter* iotHubAdapter, SyncQueue* twinUpdatesQueu
 
     bool result = IoTHubAdapter_Init_Internal(iotHubAdapter, twinUpdatesQueue);
 
+    if (result && !ReconnectWorker_Init(&iotHubAdapter->reconnectWorker, IoTHubAdapter_Reconnect, iotHubAdapter)) {
+        Logger_Error("Could not initialize the reconnect worker");
+        IoTHubAdapter_Deinit_Internal(iotHubAdapter);
+        result = false;
+    }
+
     if (Unlock(iotHubAdapterLock) != LOCK_OK) {
         Logger_Error("Could not unlock IoTHubAdapter lock");
         return false;
@@ -128,54 +181,89 @@ bool IoTHubAdapter_Init_Internal(IoTHubAdapter* iotHubAdapter, SyncQueue* twinUp
 
     iotHubAdapter->twinUpdatesQueue = twinUpdatesQueue;
 
+    success = IoTHubAdapter_CreateTransport(iotHubAdapter);
+    if (!success) {
+        goto cleanup;
+    }
+
+    success = AgentTelemetryCounter_Init(&iotHubAdapter->messageCounter);
+    if (!success){
+        goto cleanup;
+    }
+
+    iotHubAdapter->hubInitiated = true;
+
+cleanup:
+    if (!success) {
+        IoTHubAdapter_Deinit_Internal(iotHubAdapter);
+    }
+
+    return success;
+}
+
+static bool IoTHubAdapter_CreateTransport(IoTHubAdapter* iotHubAdapter) {
+    bool success = true;
+    iotHubAdapter->connected = false;
+    iotHubAdapter->transport = IoTHubAdapter_GetTransport();
+
     // Create the iothub handle here
-    iotHubAdapter->moduleHandle = IoTHubModuleClient_CreateFromConnectionString(LocalConfiguration_GetConnectionString(), protocol);
-    if (iotHubAdapter->moduleHandle == NULL) {
+    iotHubAdapter->transportHandle = iotHubAdapter->transport->Create(LocalConfiguration_GetConnectionString());
+    if (iotHubAdapter->transportHandle == NULL) {
         success = false;
         goto cleanup;
     }
 
 #ifdef USE_MQTT
     bool urlEncodeOn = true;
-    if (IoTHubModuleClient_SetOption(iotHubAdapter->moduleHandle, OPTION_AUTO_URL_ENCODE_DECODE, &urlEncodeOn) != IOTHUB_CLIENT_OK) {
+    if (iotHubAdapter->transport->SetOption(iotHubAdapter->transportHandle, OPTION_AUTO_URL_ENCODE_DECODE, &urlEncodeOn) != IOTHUB_CLIENT_OK) {
         success = false;
         goto cleanup;
     }
 #endif
 
     bool logTraces = false;
-    if (IoTHubModuleClient_SetOption(iotHubAdapter->moduleHandle, OPTION_LOG_TRACE, &logTraces) != IOTHUB_CLIENT_OK) {
+    if (iotHubAdapter->transport->SetOption(iotHubAdapter->transportHandle, OPTION_LOG_TRACE, &logTraces) != IOTHUB_CLIENT_OK) {
         success = false;
         goto cleanup;
     }
 
     // Setting connection status callback to get indication of connection to iothub
-    if (IoTHubModuleClient_SetConnectionStatusCallback(iotHubAdapter->moduleHandle, IoTHubAdapter_ConnectionStatusCallback, iotHubAdapter) != IOTHUB_CLIENT_OK) {
+    if (iotHubAdapter->transport->SetConnectionStatusCallback(iotHubAdapter->transportHandle, IoTHubAdapter_ConnectionStatusCallback, iotHubAdapter) != IOTHUB_CLIENT_OK) {
         success = false;
         goto cleanup;
     }
 
-    if (IoTHubModuleClient_SetModuleTwinCallback(iotHubAdapter->moduleHandle, IoTHubAdapter_DeviceTwinCallback, iotHubAdapter) != IOTHUB_CLIENT_OK) {
+    if (iotHubAdapter->transport->SetModuleTwinCallback(iotHubAdapter->transportHandle, IoTHubAdapter_DeviceTwinCallback, iotHubAdapter) != IOTHUB_CLIENT_OK) {
         success = false;
         goto cleanup;
     }
 
-    success = AgentTelemetryCounter_Init(&iotHubAdapter->messageCounter);
-    if (!success){
-        goto cleanup;
-    }
-
-    iotHubAdapter->hubInitiated = true;
-
 cleanup:
-    if (!success) {
-        IoTHubAdapter_Deinit_Internal(iotHubAdapter);
+    return success;
+}
+
+static void IoTHubAdapter_DestroyTransport(IoTHubAdapter* iotHubAdapter) {
+    if (iotHubAdapter->transportHandle != NULL) {
+        iotHubAdapter->transport->Destroy(iotHubAdapter->transportHandle);
+        iotHubAdapter->transportHandle = NULL;
     }
+}
 
-    return success;
+static const TransportInterface* IoTHubAdapter_GetTransport() {
+    switch (LocalConfiguration_GetTransportType()) {
+        case TRANSPORT_TYPE_LOCAL:
+            return LocalTransport_GetInterface();
+        case TRANSPORT_TYPE_HUB_LL:
+            return HubTransport_GetLowLevelInterface();
+        default:
+            return HubTransport_GetInterface();
+    }
 }
 
 void IoTHubAdapter_Deinit(IoTHubAdapter* iotHubAdapter) {
+    // a reconnect in progress takes the lock of the adapter, so the worker is stopped before it is taken
+    ReconnectWorker_Deinit(&iotHubAdapter->reconnectWorker);
+
     if (iotHubAdapterLock == NULL || Lock(iotHubAdapterLock) != LOCK_OK) {
         Logger_Error("Could not lock IoTHubAdapter lock");
         return;
@@ -197,25 +285,36 @@ void IoTHubAdapter_Deinit(IoTHubAdapter* iotHubAdapter) {
 void IoTHubAdapter_Deinit_Internal(IoTHubAdapter* iotHubAdapter) {
     iotHubAdapter->hubInitiated = false;
     AgentTelemetryCounter_Deinit(&iotHubAdapter->messageCounter);
-
-    if (iotHubAdapter->moduleHandle != NULL) {
-        IoTHubModuleClient_Destroy(iotHubAdapter->moduleHandle);
-    }
+    IoTHubAdapter_DestroyTransport(iotHubAdapter);
 }
 
-bool IoTHubAdapter_Reinit(IoTHubAdapter* iotHubAdapter, SyncQueue* twinUpdatesQueue) {
-    IoTHubAdapter_Deinit_Internal(iotHubAdapter);
-    if (!IoTHubAdapter_Init_Internal(iotHubAdapter, twinUpdatesQueue)) {
-        Logger_Error("Could not initialize IoTHub adapter");
+static bool IoTHubAdapter_Reconnect(void* context) {
+    IoTHubAdapter* iotHubAdapter = (IoTHubAdapter*)context;
+    AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.reconnectAttempts, 1);
+
+    // the renewal goes to the provisioning service, it is done before the lock is taken so the senders do not wait for it
+    if (LocalConfiguration_UseDps() && !LocalConfiguration_TryRenewConnectionString()) {
+        Logger_Error("Could not renew connection string");
         return false;
     }
 
-    if (!IoTHubAdapter_Connect(iotHubAdapter)) {
-        Logger_Error("Could not connect to IoT Hub");
+    if (iotHubAdapterLock == NULL || Lock(iotHubAdapterLock) != LOCK_OK) {
+        Logger_Error("Reconnect failed. Could not acquire lock");
         return false;
     }
 
-    return true;
+    IoTHubAdapter_DestroyTransport(iotHubAdapter);
+    bool success = IoTHubAdapter_CreateTransport(iotHubAdapter);
+    if (!success) {
+        Logger_Error("Could not recreate the IoTHub client");
+        IoTHubAdapter_DestroyTransport(iotHubAdapter);
+    }
+
+    if (Unlock(iotHubAdapterLock) != LOCK_OK) {
+        Logger_Error("Could not unlock IoTHubAdapter lock");
+    }
+
+    return success;
 }
 
 bool IoTHubAdapter_ValidateAdapterConnectionStatus(IoTHubAdapter* adapter, bool* isPermanent) {
@@ -236,6 +335,8 @@ bool IoTHubAdapter_Connect(IoTHubAdapter* iotHubAdapter) {
     uint32_t elapsedTime = 0;
     bool stop = false;
     while (!stop && elapsedTime < timeout) {
+        // the publisher does not run yet, so the low level client is driven from here
+        IoTHubAdapter_DoWork(iotHubAdapter);
         bool isPermanent;
         bool isConnected = IoTHubAdapter_ValidateAdapterConnectionStatus(iotHubAdapter, &isPermanent);
         stop = (isConnected && iotHubAdapter->hasTwinConfiguration) || isPermanent;
@@ -244,6 +345,7 @@ bool IoTHubAdapter_Connect(IoTHubAdapter* iotHubAdapter) {
     }
 
     if (iotHubAdapter->connected && iotHubAdapter->hasTwinConfiguration) {
+        iotHubAdapter->reconnectEnabled = true;
         return true;
     }
 
@@ -260,13 +362,50 @@ bool IoTHubAdapter_Connect(IoTHubAdapter* iotHubAdapter) {
     return false;
 }
 
+bool IoTHubAdapter_IsConnected(IoTHubAdapter* iotHubAdapter) {
+    return iotHubAdapter->connected;
+}
+
+uint32_t IoTHubAdapter_DoWork(IoTHubAdapter* iotHubAdapter) {
+    if (iotHubAdapter->transport == NULL || iotHubAdapter->transport->DoWork == NULL) {
+        return UINT32_MAX;
+    }
+
+    if (iotHubAdapterLock == NULL || Lock(iotHubAdapterLock) != LOCK_OK) {
+        Logger_Error("Do work failed. Could not acquire lock");
+        return IOTHUB_DO_WORK_INTERVAL;
+    }
+
+    IoTHubAdapter_DoWork_Internal(iotHubAdapter);
+
+    if (Unlock(iotHubAdapterLock) != LOCK_OK) {
+        Logger_Error("Could not unlock IoTHubAdapter lock");
+    }
+
+    return IOTHUB_DO_WORK_INTERVAL;
+}
+
+static void IoTHubAdapter_DoWork_Internal(IoTHubAdapter* iotHubAdapter) {
+    if (iotHubAdapter->transportHandle != NULL && iotHubAdapter->transport->DoWork != NULL) {
+        iotHubAdapter->transport->DoWork(iotHubAdapter->transportHandle);
+    }
+}
+
 bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize) {
+    return IoTHubAdapter_SendEncodedMessageAsync(iotHubAdapter, data, dataSize, NULL, NULL);
+}
+
+bool IoTHubAdapter_SendEncodedMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding) {
+    return IoTHubAdapter_SendMessageWithConfirmationAsync(iotHubAdapter, data, dataSize, contentType, contentEncoding, NULL, NULL);
+}
+
+bool IoTHubAdapter_SendMessageWithConfirmationAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding, IoTHubAdapterSendConfirmation confirmationCallback, void* context) {
     if (iotHubAdapterLock == NULL || Lock(iotHubAdapterLock) != LOCK_OK) {
         Logger_Error("Send message failed. Could not acquire lock");
         return false;
     }
 
-    bool success = IoTHubAdapter_SendMessageAsync_Internal(iotHubAdapter, data, dataSize);
+    bool success = IoTHubAdapter_SendMessageAsync_Internal(iotHubAdapter, data, dataSize, contentType, contentEncoding, confirmationCallback, context);
 
     if (Unlock(iotHubAdapterLock) != LOCK_OK) {
         Logger_Error("Could not unlock IoTHubAdapter lock");
@@ -276,9 +415,12 @@ bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* da
     return success;
 }
 
-static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize) {
+static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding, IoTHubAdapterSendConfirmation confirmationCallback, void* context) {
     bool success = true;
     IOTHUB_MESSAGE_HANDLE messageHandle = NULL;
+    IoTHubAdapterSendContext* sendContext = NULL;
+    IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK eventConfirmationCallback = IoTHubAdapter_SendConfirmCallback;
+    void* eventContext = iotHubAdapter;
 
     if (!iotHubAdapter->hubInitiated) {
         Logger_Error("Cannot send message, hub not initiated");
@@ -286,17 +428,11 @@ static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter
         goto cleanup;
     }
 
-    if (!iotHubAdapter->connected && LocalConfiguration_UseDps()) {
-        if (!LocalConfiguration_TryRenewConnectionString()) {
-            Logger_Error("Could not renew connection string");
-            success = false;
-            goto cleanup;
-        }
-        if (!IoTHubAdapter_Reinit(iotHubAdapter, iotHubAdapter->twinUpdatesQueue)) {
-            Logger_Error("Could not re-initialize IoTHub adapter");
-            success = false;
-            goto cleanup;
-        }
+    // the transport is recreated by the reconnect worker, a send while it is missing fails instead of waiting for it
+    if (iotHubAdapter->transportHandle == NULL) {
+        Logger_Warning("Cannot send message, the IoTHub client is being recreated");
+        success = false;
+        goto cleanup;
     }
 
     messageHandle = IoTHubMessage_CreateFromByteArray(data, dataSize);
@@ -313,20 +449,55 @@ static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter
         goto cleanup;
     }
 
-    if (IoTHubModuleClient_SendEventAsync(iotHubAdapter->moduleHandle, messageHandle, IoTHubAdapter_SendConfirmCallback, iotHubAdapter) != IOTHUB_CLIENT_OK) {
+    if (contentType != NULL && IoTHubMessage_SetContentTypeSystemProperty(messageHandle, contentType) != IOTHUB_MESSAGE_OK) {
+        Logger_Warning("Failed to set the content type of the message");
+        success = false;
+        goto cleanup;
+    }
+
+    if (contentEncoding != NULL && IoTHubMessage_SetContentEncodingSystemProperty(messageHandle, contentEncoding) != IOTHUB_MESSAGE_OK) {
+        Logger_Warning("Failed to set the content encoding of the message");
+        success = false;
+        goto cleanup;
+    }
+
+    if (confirmationCallback != NULL) {
+        sendContext = malloc(sizeof(*sendContext));
+        if (sendContext == NULL) {
+            success = false;
+            goto cleanup;
+        }
+        sendContext->adapter = iotHubAdapter;
+        sendContext->callback = confirmationCallback;
+        sendContext->context = context;
+        eventConfirmationCallback = IoTHubAdapter_SendConfirmWithCallback;
+        eventContext = sendContext;
+    }
+
+    if (iotHubAdapter->transport->SendEventAsync(iotHubAdapter->transportHandle, messageHandle, eventConfirmationCallback, eventContext) != IOTHUB_CLIENT_OK) {
         Logger_Warning("Failed to hand over the message to IoTHubClient");
         success = false;
         goto cleanup;
     }
+    // the context is freed by the confirmation
+    sendContext = NULL;
 
     if (dataSize < MESSAGE_BILLING_MULTIPLE){
         AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.smallMessages, 1);
     }
     AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.sentMessages, 1);
+    // a started billing unit is billed in full, the ratio between the two is the fill ratio of the messages
+    AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.sentBytes, dataSize);
+    AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.billedBytes, 
+        (dataSize + MESSAGE_BILLING_MULTIPLE - 1) / MESSAGE_BILLING_MULTIPLE * MESSAGE_BILLING_MULTIPLE);
     Logger_Debug("IoTHubClient accepted the message for delivery");
 
 cleanup:
 
+    if (sendContext != NULL) {
+        free(sendContext);
+    }
+
     if (messageHandle != NULL) {
         IoTHubMessage_Destroy(messageHandle);
     }
@@ -346,6 +517,18 @@ static void IoTHubAdapter_SendConfirmCallback(IOTHUB_CLIENT_CONFIRMATION_RESULT
     }
 }
 
+static void IoTHubAdapter_SendConfirmWithCallback(IOTHUB_CLIENT_CONFIRMATION_RESULT result, void* userContextCallback) {
+    if (userContextCallback == NULL) {
+        Logger_Error("send_confirm_callback error in user context");
+        return;
+    }
+
+    IoTHubAdapterSendContext* sendContext = (IoTHubAdapterSendContext*)userContextCallback;
+    IoTHubAdapter_SendConfirmCallback(result, sendContext->adapter);
+    sendContext->callback(result == IOTHUB_CLIENT_CONFIRMATION_OK, sendContext->context);
+    free(sendContext);
+}
+
 static void IoTHubAdapter_ConnectionStatusCallback(IOTHUB_CLIENT_CONNECTION_STATUS result, IOTHUB_CLIENT_CONNECTION_STATUS_REASON reason, void* userContextCallback) {
     if (userContextCallback == NULL) {
         Logger_Error("connection_status_callback error in user context");
@@ -354,14 +537,26 @@ static void IoTHubAdapter_ConnectionStatusCallback(IOTHUB_CLIENT_CONNECTION_STAT
 
     IoTHubAdapter* adapter = (IoTHubAdapter*)(userContextCallback);
     adapter->connectionStatusReason = reason;
-    // This sample DOES NOT take into consideration network outages.
     if (result == IOTHUB_CLIENT_CONNECTION_AUTHENTICATED && reason == IOTHUB_CLIENT_CONNECTION_OK) {
+        if (adapter->disconnectedTime != 0) {
+            uint32_t disconnectedTime = (uint32_t)TimeUtils_GetTimeDiff(TimeUtils_GetCurrentTime(), adapter->disconnectedTime);
+            AgentTelemetryCounter_IncreaseBy(&adapter->messageCounter, &adapter->messageCounter.counter.messageCounter.disconnectedTime, disconnectedTime);
+            adapter->disconnectedTime = 0;
+        }
         adapter->connected = true;
+        ReconnectWorker_Reset(&adapter->reconnectWorker);
         Logger_Information("The module client is connected to iothub");
     } else {
-        if (adapter->connected)
+        if (adapter->connected) {
             Logger_Information("The module client has been disconnected");
+            adapter->disconnectedTime = TimeUtils_GetCurrentTime();
+        }
         adapter->connected = false;
+
+        // the client retries by itself until its retry policy expires, a connection string from DPS may have to be renewed first
+        if (adapter->reconnectEnabled && (LocalConfiguration_UseDps() || reason == IOTHUB_CLIENT_CONNECTION_RETRY_EXPIRED)) {
+            ReconnectWorker_Schedule(&adapter->reconnectWorker);
+        }
     }
 }
 
@@ -405,6 +600,7 @@ cleanup:
 
 bool IoTHubAdapter_SetReportedPropertiesAsync(IoTHubAdapter* iotHubAdapter, const void* reportedData, size_t dataSize) {
     bool success = true;
+    bool locked = false;
 
     if (reportedData == NULL)
     {
@@ -413,7 +609,21 @@ bool IoTHubAdapter_SetReportedPropertiesAsync(IoTHubAdapter* iotHubAdapter, cons
         goto cleanup;
     }
 
-    if (IoTHubModuleClient_SendReportedState(iotHubAdapter->moduleHandle, reportedData, dataSize, IoTHubAdapter_SetReportedConfirmCallback, NULL) != IOTHUB_CLIENT_OK) {
+    // the low level client is driven by the publisher, the reported properties are set from the twin updater
+    if (iotHubAdapterLock == NULL || Lock(iotHubAdapterLock) != LOCK_OK) {
+        Logger_Error("Set reported properties failed. Could not acquire lock");
+        success = false;
+        goto cleanup;
+    }
+    locked = true;
+
+    if (iotHubAdapter->transportHandle == NULL) {
+        Logger_Warning("Cannot set reported properties, the IoTHub client is being recreated");
+        success = false;
+        goto cleanup;
+    }
+
+    if (iotHubAdapter->transport->SendReportedState(iotHubAdapter->transportHandle, reportedData, dataSize, IoTHubAdapter_SetReportedConfirmCallback, NULL) != IOTHUB_CLIENT_OK) {
         Logger_Warning("failed to hand over the reported properties to IoTHubClient");
         success = false;
         goto cleanup;
@@ -422,6 +632,10 @@ bool IoTHubAdapter_SetReportedPropertiesAsync(IoTHubAdapter* iotHubAdapter, cons
     Logger_Debug("IoTHubClient set reported properties");
 
 cleanup:
+    if (locked && Unlock(iotHubAdapterLock) != LOCK_OK) {
+        Logger_Error("Could not unlock IoTHubAdapter lock");
+    }
+
     return success;
 }
 
@@ -4,6 +4,7 @@
 #include "json/json_array_writer.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "json/json_writer.h"
@@ -69,12 +70,24 @@ JsonWriterResult JsonArrayWriter_AddObject(JsonArrayWriterHandle writer, JsonObj
 JsonWriterResult JsonArrayWriter_Serialize(JsonArrayWriterHandle writer, char** output, uint32_t* size) {
     JsonArrayWriter* writerObj = (JsonArrayWriter*)writer;
 
-    *output = json_serialize_to_string(writerObj->rootValue);
-    if (*output == NULL) {
+    // the output is not taken from parson's allocator since the callers free it with free
+    size_t bufferSize = json_serialization_size(writerObj->rootValue);
+    if (bufferSize == 0 || bufferSize > UINT32_MAX) {
         return JSON_WRITER_EXCEPTION;
     }
-    *size = strlen(*output);
 
+    char* buffer = malloc(bufferSize);
+    if (buffer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (json_serialize_to_buffer(writerObj->rootValue, buffer, bufferSize) != JSONSuccess) {
+        free(buffer);
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    *output = buffer;
+    *size = bufferSize - 1;
     return JSON_WRITER_OK;
 }
 
@@ -82,4 +95,25 @@ JsonWriterResult JsonArrayWriter_GetSize(JsonArrayWriterHandle handle, uint32_t*
     JsonArrayWriter* writer = (JsonArrayWriter*)handle;
     *numOfelements = json_array_get_count(writer->rootArray);
     return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonArrayWriter_GetObject(JsonArrayWriterHandle handle, uint32_t index, JsonObjectWriterHandle* item) {
+    JsonArrayWriter* writer = (JsonArrayWriter*)handle;
+
+    JSON_Value* itemValue = json_array_get_value(writer->rootArray, index);
+    JSON_Object* itemObject = json_value_get_object(itemValue);
+    if (itemObject == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    JsonObjectWriter* itemWriter = malloc(sizeof(JsonObjectWriter));
+    if (itemWriter == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    itemWriter->rootValue = itemValue;
+    itemWriter->rootObject = itemObject;
+    itemWriter->shouldFree = false;
+
+    *item = (JsonObjectWriterHandle)itemWriter;
+    return JSON_WRITER_OK;
 }
\ No newline at end of file
@@ -11,6 +11,10 @@
 
 static JsonWriterResult JsonObjectWriter_GetValueOfType(JsonObjectWriter* writer, const char* key, JSON_Value_Type type, JSON_Value ** outObject);
 
+static void* JsonObjectWriter_Allocate(uint32_t size) {
+    return malloc(size);
+}
+
 JsonWriterResult JsonObjectWriter_Init(JsonObjectWriterHandle* writer) {
     JsonWriterResult result = JSON_WRITER_OK;
 
@@ -128,14 +132,31 @@ JsonWriterResult JsonObjectWriter_WriteArray(JsonObjectWriterHandle writer, cons
 }
 
 JsonWriterResult JsonObjectWriter_Serialize(JsonObjectWriterHandle writer, char** output, uint32_t* size) {
+    // the output is not taken from parson's allocator since the callers free it with free
+    return JsonObjectWriter_SerializeWithAllocator(writer, JsonObjectWriter_Allocate, free, output, size);
+}
+
+JsonWriterResult JsonObjectWriter_SerializeWithAllocator(JsonObjectWriterHandle writer, JsonBufferAllocateFunc allocate, JsonBufferFreeFunc release, char** output, uint32_t* size) {
     JsonObjectWriter* writerObj = (JsonObjectWriter*)writer;
 
-    *output = json_serialize_to_string(writerObj->rootValue);
-    if (*output == NULL) {
+    // includes the null terminator
+    size_t bufferSize = json_serialization_size(writerObj->rootValue);
+    if (bufferSize == 0 || bufferSize > UINT32_MAX) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    char* buffer = allocate((uint32_t)bufferSize);
+    if (buffer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (json_serialize_to_buffer(writerObj->rootValue, buffer, bufferSize) != JSONSuccess) {
+        release(buffer);
         return JSON_WRITER_EXCEPTION;
     }
-    *size = strlen(*output);
 
+    *output = buffer;
+    *size = bufferSize - 1;
     return JSON_WRITER_OK;
 }
 
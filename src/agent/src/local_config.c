@@ -20,6 +20,15 @@ static uint32_t connectionTimeout = 0;
 static int32_t systemLoggerMinimumSeverity = 0;
 static int32_t diagnosticEventMinimumSeverity = 0;
 static char* remoteConfigurationObjectName = NULL;
+static char* spillLogDirectory = NULL;
+static uint32_t spillLogDiskQuota = 0;
+static EventEncoding eventEncoding = EVENT_ENCODING_JSON;
+static TransportType transportType = TRANSPORT_TYPE_HUB;
+static char* localTransportSinkPath = NULL;
+static char* localTransportTwinFilePath = NULL;
+static uint32_t localTransportLatency = 0;
+static uint32_t localTransportFailureRate = 0;
+static uint32_t collectorBudgets[COLLECTOR_COUNT] = { 0 };
 
 #define CONNECTION_STRING_SIZE 500
 #define KEY_SIZE 300
@@ -49,6 +58,25 @@ static const char LOCAL_CONFIG_LOGGING[] = "Logging";
 static const char LOCAL_CONFIG_LOGGING_SYSTEM_LOGGER_MINIMUM_SEVERITY[] = "SystemLoggerMinimumSeverity";
 static const char LOCAL_CONFIG_LOGGING_DIAGNOSTIC_EVENT_MINIMUM_SEVERITY[] = "DiagnoticEventMinimumSeverity";
 
+static const char LOCAL_CONFIG_SPILL_LOG[] = "SpillLog";
+static const char LOCAL_CONFIG_SPILL_LOG_DIRECTORY[] = "Directory";
+static const char LOCAL_CONFIG_SPILL_LOG_DISK_QUOTA[] = "DiskQuotaInBytes";
+
+static const char LOCAL_CONFIG_EVENT_ENCODING[] = "EventEncoding";
+static const char LOCAL_CONFIG_EVENT_ENCODING_VALUE_CBOR[] = "Cbor";
+
+static const char LOCAL_CONFIG_TRANSPORT[] = "Transport";
+static const char LOCAL_CONFIG_TRANSPORT_TYPE[] = "Type";
+static const char LOCAL_CONFIG_TRANSPORT_TYPE_VALUE_LOCAL[] = "Local";
+static const char LOCAL_CONFIG_TRANSPORT_TYPE_VALUE_HUB_LOW_LEVEL[] = "HubLowLevel";
+static const char LOCAL_CONFIG_TRANSPORT_LOCAL[] = "Local";
+static const char LOCAL_CONFIG_TRANSPORT_LOCAL_SINK_PATH[] = "SinkPath";
+static const char LOCAL_CONFIG_TRANSPORT_LOCAL_TWIN_FILE_PATH[] = "TwinFilePath";
+static const char LOCAL_CONFIG_TRANSPORT_LOCAL_LATENCY[] = "LatencyInMilliseconds";
+static const char LOCAL_CONFIG_TRANSPORT_LOCAL_FAILURE_RATE[] = "FailureRatePercent";
+
+static const char LOCAL_CONFIG_COLLECTOR_BUDGETS[] = "CollectorBudgets";
+
 /**
  * @brief   initializes the security module connection string using device authentication: certificate or sas token.
  * 
@@ -307,6 +335,127 @@ static void LocalConfiguration_InitLogger(JsonObjectReaderHandle jsonReader) {
     if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_LOGGING_DIAGNOSTIC_EVENT_MINIMUM_SEVERITY, &diagnosticEventMinimumSeverity) != JSON_READER_OK) {
         Logger_Error("Failed reading diagnostic event minimum severity from configuraiton file, using default value");
     }
+
+    JsonObjectReader_StepOut(jsonReader);
+}
+
+static void LocalConfiguration_InitSpillLog(JsonObjectReaderHandle jsonReader) {
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_SPILL_LOG) != JSON_READER_OK) {
+        Logger_Information("Could not find spill log info in local config, using default values");
+        return;
+    }
+
+    char* directory = NULL;
+    if (JsonObjectReader_ReadString(jsonReader, LOCAL_CONFIG_SPILL_LOG_DIRECTORY, &directory) != JSON_READER_OK || directory == NULL || strlen(directory) == 0 || 
+            !Utils_CreateStringCopy(&spillLogDirectory, directory)) {
+        Logger_Information("Failed reading spill log directory from configuraiton file, using default value");
+    }
+
+    int32_t diskQuota = 0;
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_SPILL_LOG_DISK_QUOTA, &diskQuota) != JSON_READER_OK || diskQuota <= 0) {
+        Logger_Information("Failed reading spill log disk quota from configuraiton file, using default value");
+    } else {
+        spillLogDiskQuota = (uint32_t)diskQuota;
+    }
+
+    JsonObjectReader_StepOut(jsonReader);
+}
+
+static void LocalConfiguration_InitEventEncoding(JsonObjectReaderHandle jsonReader) {
+    char* encoding = NULL;
+    if (JsonObjectReader_ReadString(jsonReader, LOCAL_CONFIG_EVENT_ENCODING, &encoding) != JSON_READER_OK || encoding == NULL) {
+        Logger_Information("Could not find event encoding in local config, using json");
+        return;
+    }
+
+    // any other value keeps json, which every consumer of the messages reads
+    if (Utils_UnsafeAreStringsEqual(encoding, LOCAL_CONFIG_EVENT_ENCODING_VALUE_CBOR, false)) {
+        eventEncoding = EVENT_ENCODING_CBOR;
+    }
+}
+
+static void LocalConfiguration_InitCollectorBudgets(JsonObjectReaderHandle jsonReader) {
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_COLLECTOR_BUDGETS) != JSON_READER_OK) {
+        Logger_Information("Could not find collector budgets in local config, using default values");
+        return;
+    }
+
+    // the budgets are keyed by the names of the collectors, a missing collector keeps the default budget
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        uint32_t budget = 0;
+        if (JsonObjectReader_ReadTimeInMilliseconds(jsonReader, CollectorExecution_GetName(id), &budget) == JSON_READER_OK) {
+            collectorBudgets[id] = budget;
+        }
+    }
+
+    JsonObjectReader_StepOut(jsonReader);
+}
+
+/**
+ * @brief   initializes the transport of the messages, the IoT hub unless the local sink was configured.
+ *          The hub is reached with the module client, or with the low level module client if it was configured.
+ *          The local sink does not connect anywhere, so it needs no authentication.
+ * 
+ * @param   jsonReader      a handle to the json reader.
+ * 
+ * @return LOCAL_CONFIGURATION_OK on success, LOCAL_CONFIGURATION_EXCEPTION otherwise.
+ */
+static LocalConfigurationResultValues LocalConfiguration_InitTransport(JsonObjectReaderHandle jsonReader) {
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_TRANSPORT) != JSON_READER_OK) {
+        Logger_Information("Could not find transport info in local config, using the IoT hub");
+        return LOCAL_CONFIGURATION_OK;
+    }
+
+    char* type = NULL;
+    if (JsonObjectReader_ReadString(jsonReader, LOCAL_CONFIG_TRANSPORT_TYPE, &type) != JSON_READER_OK || type == NULL) {
+        JsonObjectReader_StepOut(jsonReader);
+        return LOCAL_CONFIGURATION_OK;
+    }
+
+    if (!Utils_UnsafeAreStringsEqual(type, LOCAL_CONFIG_TRANSPORT_TYPE_VALUE_LOCAL, false)) {
+        if (Utils_UnsafeAreStringsEqual(type, LOCAL_CONFIG_TRANSPORT_TYPE_VALUE_HUB_LOW_LEVEL, false)) {
+            transportType = TRANSPORT_TYPE_HUB_LL;
+        }
+        JsonObjectReader_StepOut(jsonReader);
+        return LOCAL_CONFIGURATION_OK;
+    }
+    transportType = TRANSPORT_TYPE_LOCAL;
+
+    JsonReaderResult parseResult = JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_TRANSPORT_LOCAL);
+    if (parseResult != JSON_READER_OK) {
+        LocalConfiguration_LogReadErrors(parseResult, LOCAL_CONFIG_TRANSPORT_LOCAL);
+        return LOCAL_CONFIGURATION_EXCEPTION;
+    }
+
+    char* sinkPath = NULL;
+    if (LocalConfiguration_ReadJsonStringConfig(jsonReader, LOCAL_CONFIG_TRANSPORT_LOCAL_SINK_PATH, &sinkPath) != JSON_READER_OK ||
+            !Utils_CreateStringCopy(&localTransportSinkPath, sinkPath)) {
+        return LOCAL_CONFIGURATION_EXCEPTION;
+    }
+
+    char* twinFilePath = NULL;
+    if (LocalConfiguration_ReadJsonStringConfig(jsonReader, LOCAL_CONFIG_TRANSPORT_LOCAL_TWIN_FILE_PATH, &twinFilePath) != JSON_READER_OK ||
+            !Utils_CreateStringCopy(&localTransportTwinFilePath, twinFilePath)) {
+        return LOCAL_CONFIGURATION_EXCEPTION;
+    }
+
+    int32_t latency = 0;
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_TRANSPORT_LOCAL_LATENCY, &latency) != JSON_READER_OK || latency < 0) {
+        Logger_Information("Failed reading local transport latency from configuraiton file, using no latency");
+    } else {
+        localTransportLatency = (uint32_t)latency;
+    }
+
+    int32_t failureRate = 0;
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_TRANSPORT_LOCAL_FAILURE_RATE, &failureRate) != JSON_READER_OK || failureRate < 0) {
+        Logger_Information("Failed reading local transport failure rate from configuraiton file, using no failures");
+    } else {
+        localTransportFailureRate = (failureRate > 100) ? 100 : (uint32_t)failureRate;
+    }
+
+    JsonObjectReader_StepOut(jsonReader);
+    JsonObjectReader_StepOut(jsonReader);
+    return LOCAL_CONFIGURATION_OK;
 }
 
 LocalConfigurationResultValues LocalConfiguration_Init(){
@@ -381,7 +530,12 @@ LocalConfigurationResultValues LocalConfiguration_Init(){
         goto cleanup;
     }
 
-    if (LocalConfiguration_InitConnectionString(jsonReader) != LOCAL_CONFIGURATION_OK) {
+    if (LocalConfiguration_InitTransport(jsonReader) != LOCAL_CONFIGURATION_OK) {
+        returnVal = LOCAL_CONFIGURATION_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (transportType != TRANSPORT_TYPE_LOCAL && LocalConfiguration_InitConnectionString(jsonReader) != LOCAL_CONFIGURATION_OK) {
         returnVal = LOCAL_CONFIGURATION_EXCEPTION;
         goto cleanup;
     }
@@ -393,6 +547,9 @@ LocalConfigurationResultValues LocalConfiguration_Init(){
     }
 
     LocalConfiguration_InitLogger(jsonReader);
+    LocalConfiguration_InitSpillLog(jsonReader);
+    LocalConfiguration_InitEventEncoding(jsonReader);
+    LocalConfiguration_InitCollectorBudgets(jsonReader);
 
 cleanup:
     if (jsonReader != NULL) {
@@ -438,6 +595,24 @@ void LocalConfiguration_Deinit() {
         free(agentId);
         agentId = NULL;
     }
+    if (spillLogDirectory != NULL) {
+        free(spillLogDirectory);
+        spillLogDirectory = NULL;
+    }
+    spillLogDiskQuota = 0;
+    eventEncoding = EVENT_ENCODING_JSON;
+    if (localTransportSinkPath != NULL) {
+        free(localTransportSinkPath);
+        localTransportSinkPath = NULL;
+    }
+    if (localTransportTwinFilePath != NULL) {
+        free(localTransportTwinFilePath);
+        localTransportTwinFilePath = NULL;
+    }
+    localTransportLatency = 0;
+    localTransportFailureRate = 0;
+    transportType = TRANSPORT_TYPE_HUB;
+    memset(collectorBudgets, 0, sizeof(collectorBudgets));
 }
 
 const char* LocalConfiguration_GetConnectionString() {
@@ -470,4 +645,40 @@ uint32_t LocalConfiguration_GetConnectionTimeout() {
 
 const char* LocalConfiguration_GetRemoteConfigurationObjectName() {
     return remoteConfigurationObjectName;
-}
\ No newline at end of file
+}
+
+const char* LocalConfiguration_GetSpillLogDirectory() {
+    return (spillLogDirectory != NULL) ? spillLogDirectory : DEFAULT_SPILL_LOG_DIRECTORY;
+}
+
+uint32_t LocalConfiguration_GetSpillLogDiskQuota() {
+    return (spillLogDiskQuota != 0) ? spillLogDiskQuota : DEFAULT_SPILL_LOG_DISK_QUOTA;
+}
+
+EventEncoding LocalConfiguration_GetEventEncoding() {
+    return eventEncoding;
+}
+
+TransportType LocalConfiguration_GetTransportType() {
+    return transportType;
+}
+
+const char* LocalConfiguration_GetLocalTransportSinkPath() {
+    return localTransportSinkPath;
+}
+
+const char* LocalConfiguration_GetLocalTransportTwinFilePath() {
+    return localTransportTwinFilePath;
+}
+
+uint32_t LocalConfiguration_GetLocalTransportLatency() {
+    return localTransportLatency;
+}
+
+uint32_t LocalConfiguration_GetLocalTransportFailureRate() {
+    return localTransportFailureRate;
+}
+
+uint32_t LocalConfiguration_GetCollectorBudget(CollectorId id) {
+    return id < COLLECTOR_COUNT ? collectorBudgets[id] : 0;
+}
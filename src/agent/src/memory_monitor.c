@@ -2,6 +2,8 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 #include "memory_monitor.h"
 
+// the internal memory monitor is lock free, so the monitor forwards the calls as is from any thread
+
 bool MemoryMonitor_Init() {
     InternalMemoryMonitor_Init();
     return true;
@@ -19,6 +21,34 @@ MemoryMonitorResultValues MemoryMonitor_Release(uint32_t sizeInBytes) {
     return InternalMemoryMonitor_Release(sizeInBytes);
 }
 
+void MemoryMonitor_ForceConsume(uint32_t sizeInBytes) {
+    InternalMemoryMonitor_ForceConsume(sizeInBytes);
+}
+
 MemoryMonitorResultValues MemoryMonitor_CurrentConsumption(uint32_t* sizeInBytes) {
     return InternalMemoryMonitor_CurrentConsumption(sizeInBytes);
+}
+
+void MemoryMonitor_SetLimit(uint32_t limitInBytes) {
+    InternalMemoryMonitor_SetLimit(limitInBytes);
+}
+
+MemoryMonitorResultValues MemoryMonitor_InitBudget(MemoryBudget* budget, uint32_t reservedPercentOfLimit) {
+    return InternalMemoryMonitor_InitBudget(budget, reservedPercentOfLimit);
+}
+
+void MemoryMonitor_DeinitBudget(MemoryBudget* budget) {
+    InternalMemoryMonitor_DeinitBudget(budget);
+}
+
+MemoryMonitorResultValues MemoryMonitor_ConsumeFromBudget(MemoryBudget* budget, uint32_t sizeInBytes) {
+    return InternalMemoryMonitor_ConsumeFromBudget(budget, sizeInBytes);
+}
+
+MemoryMonitorResultValues MemoryMonitor_ReleaseToBudget(MemoryBudget* budget, uint32_t sizeInBytes) {
+    return InternalMemoryMonitor_ReleaseToBudget(budget, sizeInBytes);
+}
+
+bool MemoryMonitor_IsBeyondReservation(MemoryBudget* budget) {
+    return InternalMemoryMonitor_IsBeyondReservation(budget);
 }
\ No newline at end of file
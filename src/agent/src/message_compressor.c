@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "message_compressor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "logger.h"
+#include "message_schema_consts.h"
+
+// a small window keeps the deflate state around 32KB, the messages repeat their keys within a few events anyway
+#define MESSAGE_COMPRESSOR_WINDOW_BITS 12
+#define MESSAGE_COMPRESSOR_MEMORY_LEVEL 5
+// deflate ends a block at least every 2047 symbols, a block which does not compress is stored with a 5 bytes header
+#define MESSAGE_COMPRESSOR_BLOCK_OVERHEAD_SHIFT 8
+// the zlib header with the dictionary id, two partial blocks, the sync flush marker or the final block, and the adler32 trailer
+#define MESSAGE_COMPRESSOR_STREAM_OVERHEAD 32
+#define MESSAGE_COMPRESSOR_INITIAL_CAPACITY 1024
+
+/**
+ * A fragment of the preset dictionary.
+ */
+typedef struct _DictionaryEntry {
+
+    const char** value;
+    bool isKey;
+
+} DictionaryEntry;
+
+/**
+ * The strings which repeat in every message. deflate prefers the end of the dictionary (shorter distances),
+ * so the strings of the event envelope, which appear in every event, come last.
+ */
+static const DictionaryEntry DICTIONARY_ENTRIES[] = {
+    { &BASELINE_DESCRIPTION_KEY, true },
+    { &BASELINE_CCEID_KEY, true },
+    { &BASELINE_RESULT_KEY, true },
+    { &BASELINE_SEVERITY_KEY, true },
+    { &FIREWALL_RULES_CHAIN_NAME_KEY, true },
+    { &FIREWALL_RULES_ACTION_KEY, true },
+    { &FIREWALL_RULES_SRC_ADDRESS_KEY, true },
+    { &FIREWALL_RULES_DEST_ADDRESS_KEY, true },
+    { &FIREWALL_RULES_DEST_PORT_KEY, true },
+    { &LISTENING_PORTS_LOCAL_ADDRESS_KEY, true },
+    { &LISTENING_PORTS_LOCAL_PORT_KEY, true },
+    { &LOCAL_USERS_GROUP_NAMES_KEY, true },
+    { &LOCAL_USERS_GROUP_IDS_KEY, true },
+    { &USER_LOGIN_OPERATION_KEY, true },
+    { &USER_LOGIN_RESULT_KEY, true },
+    { &USER_LOGIN_USERNAME_KEY, true },
+    { &CONNECTION_CREATION_PROTOCOL_KEY, true },
+    { &CONNECTION_CREATION_REMOTE_ADDRESS_KEY, true },
+    { &CONNECTION_CREATION_REMOTE_PORT_KEY, true },
+    { &CONNECTION_CREATION_DIRECTION_KEY, true },
+    { &CONNECTION_CREATION_NAME, false },
+    { &PROCESS_CREATION_PARENT_PROCESS_ID_KEY, true },
+    { &PROCESS_CREATION_PROCESS_ID_KEY, true },
+    { &PROCESS_CREATION_USER_ID_KEY, true },
+    { &PROCESS_CREATION_COMMAND_LINE_KEY, true },
+    { &PROCESS_CREATION_EXECUTABLE_KEY, true },
+    { &PROCESS_CREATION_NAME, false },
+    { &EVENT_PERIODIC_CATEGORY, false },
+    { &EVENT_TRIGGERED_CATEGORY, false },
+    { &EVENT_ID_KEY, true },
+    { &EVENT_LOCAL_TIMESTAMP_KEY, true },
+    { &EVENT_UTC_TIMESTAMP_KEY, true },
+    { &EVENT_CATEGORY_KEY, true },
+    { &EVENT_IS_EMPTY_KEY, true },
+    { &EVENT_NAME_KEY, true },
+    { &EVENT_PAYLOAD_SCHEMA_VERSION_KEY, true },
+    { &EVENT_TYPE_KEY, true },
+    { &EVENT_TYPE_SECURITY_VALUE, false },
+    { &PAYLOAD_KEY, true }
+};
+
+/**
+ * Executable paths which repeat in the process and connection events.
+ */
+static const char* DICTIONARY_PATHS[] = { "\"/usr/sbin/", "\"/usr/lib/", "\"/bin/", "\"/usr/bin/" };
+
+/**
+ * @brief Runs deflate until all the input was consumed and the requested flush is done, growing the output as needed.
+ *
+ * @param   compressor      The compressor.
+ * @param   flush           The deflate flush mode.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool MessageCompressor_Deflate(MessageCompressor* compressor, int flush);
+
+/**
+ * @brief Appends the given string to the dictionary if it fits.
+ */
+static uint32_t MessageCompressor_AppendToDictionary(char* buffer, uint32_t bufferSize, uint32_t size, const char* prefix, const char* value, const char* suffix);
+
+bool MessageCompressor_Init(MessageCompressor* compressor) {
+    memset(compressor, 0, sizeof(*compressor));
+
+    if (deflateInit2(&compressor->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MESSAGE_COMPRESSOR_WINDOW_BITS, MESSAGE_COMPRESSOR_MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        Logger_Error("Could not initialize the message compressor");
+        return false;
+    }
+
+    char dictionary[MESSAGE_COMPRESSOR_MAX_DICTIONARY_SIZE];
+    uint32_t dictionarySize = MessageCompressor_GetDictionary(dictionary, sizeof(dictionary));
+    if (deflateSetDictionary(&compressor->stream, (const Bytef*)dictionary, dictionarySize) != Z_OK) {
+        Logger_Error("Could not set the message compressor dictionary");
+        deflateEnd(&compressor->stream);
+        return false;
+    }
+
+    return true;
+}
+
+void MessageCompressor_Deinit(MessageCompressor* compressor) {
+    deflateEnd(&compressor->stream);
+    if (compressor->data != NULL) {
+        free(compressor->data);
+        compressor->data = NULL;
+    }
+}
+
+bool MessageCompressor_Write(MessageCompressor* compressor, const void* data, uint32_t size) {
+    if (compressor->failed) {
+        return false;
+    }
+
+    compressor->stream.next_in = (Bytef*)data;
+    compressor->stream.avail_in = size;
+    if (!MessageCompressor_Deflate(compressor, Z_NO_FLUSH)) {
+        return false;
+    }
+
+    compressor->pendingSize += size;
+    return true;
+}
+
+bool MessageCompressor_Flush(MessageCompressor* compressor) {
+    if (compressor->failed) {
+        return false;
+    }
+
+    if (compressor->pendingSize == 0) {
+        return true;
+    }
+
+    if (!MessageCompressor_Deflate(compressor, Z_SYNC_FLUSH)) {
+        return false;
+    }
+
+    compressor->pendingSize = 0;
+    return true;
+}
+
+bool MessageCompressor_Finish(MessageCompressor* compressor, void** data, uint32_t* size) {
+    if (compressor->failed || !MessageCompressor_Deflate(compressor, Z_FINISH)) {
+        return false;
+    }
+
+    *data = compressor->data;
+    *size = compressor->size;
+    compressor->data = NULL;
+    compressor->size = 0;
+    compressor->capacity = 0;
+    compressor->pendingSize = 0;
+    return true;
+}
+
+uint32_t MessageCompressor_GetMaxInputSize(uint32_t room) {
+    if (room <= MESSAGE_COMPRESSOR_STREAM_OVERHEAD) {
+        return 0;
+    }
+
+    // the bound of n bytes is n + (n >> shift) + overhead, so the input may take the room less the block overhead of the room
+    uint32_t input = room - MESSAGE_COMPRESSOR_STREAM_OVERHEAD;
+    return input - (input >> MESSAGE_COMPRESSOR_BLOCK_OVERHEAD_SHIFT);
+}
+
+uint32_t MessageCompressor_GetDictionary(char* buffer, uint32_t bufferSize) {
+    uint32_t size = 0;
+
+    for (uint32_t i = 0; i < sizeof(DICTIONARY_PATHS) / sizeof(DICTIONARY_PATHS[0]); ++i) {
+        size = MessageCompressor_AppendToDictionary(buffer, bufferSize, size, "", DICTIONARY_PATHS[i], "");
+    }
+
+    for (uint32_t i = 0; i < sizeof(DICTIONARY_ENTRIES) / sizeof(DICTIONARY_ENTRIES[0]); ++i) {
+        const DictionaryEntry* entry = &DICTIONARY_ENTRIES[i];
+        size = MessageCompressor_AppendToDictionary(buffer, bufferSize, size, "\"", *entry->value, entry->isKey ? "\":" : "\",");
+    }
+
+    return size;
+}
+
+static uint32_t MessageCompressor_AppendToDictionary(char* buffer, uint32_t bufferSize, uint32_t size, const char* prefix, const char* value, const char* suffix) {
+    uint32_t prefixSize = strlen(prefix);
+    uint32_t valueSize = strlen(value);
+    uint32_t suffixSize = strlen(suffix);
+    if (size + prefixSize + valueSize + suffixSize > bufferSize) {
+        return size;
+    }
+
+    memcpy(buffer + size, prefix, prefixSize);
+    memcpy(buffer + size + prefixSize, value, valueSize);
+    memcpy(buffer + size + prefixSize + valueSize, suffix, suffixSize);
+    return size + prefixSize + valueSize + suffixSize;
+}
+
+static bool MessageCompressor_Deflate(MessageCompressor* compressor, int flush) {
+    int result = Z_OK;
+
+    do {
+        if (compressor->size == compressor->capacity) {
+            uint32_t capacity = compressor->capacity == 0 ? MESSAGE_COMPRESSOR_INITIAL_CAPACITY : compressor->capacity * 2;
+            char* newData = realloc(compressor->data, capacity);
+            if (newData == NULL) {
+                Logger_Error("Could not allocate the compressed message");
+                compressor->failed = true;
+                return false;
+            }
+            compressor->data = newData;
+            compressor->capacity = capacity;
+        }
+
+        compressor->stream.next_out = (Bytef*)(compressor->data + compressor->size);
+        compressor->stream.avail_out = compressor->capacity - compressor->size;
+        result = deflate(&compressor->stream, flush);
+        compressor->size = compressor->capacity - compressor->stream.avail_out;
+
+        if (result == Z_STREAM_ERROR) {
+            Logger_Error("Could not compress the message");
+            compressor->failed = true;
+            return false;
+        }
+    // a full output buffer means deflate may have more to write
+    } while (compressor->stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+
+    return true;
+}
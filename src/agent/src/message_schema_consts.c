@@ -10,6 +10,19 @@ const char* AGENT_ID_KEY = "AgentId";
 const char* MESSAGE_SCHEMA_VERSION_KEY = "MessageSchemaVersion";
 const char* HUB_RESOURCE_ID_PROPERTY_KEY = "HubResourceId";
 const char* EXTRA_DETAILS_KEY = "ExtraDetails";
+const char* MESSAGE_CONTENT_ENCODING_DEFLATE = "deflate";
+const char* MESSAGE_CONTENT_TYPE_CBOR = "application/cbor";
+
+const char* MESSAGE_LAYOUT_KEY = "Layout";
+const char* MESSAGE_LAYOUT_COLUMNAR = "Columnar";
+const char* COLUMNAR_STRINGS_KEY = "Strings";
+const char* COLUMNAR_EVENT_GROUPS_KEY = "EventGroups";
+const char* COLUMNAR_TIMESTAMP_BASE_KEY = "Base";
+const char* COLUMNAR_TIMESTAMP_DELTAS_KEY = "Deltas";
+const char* COLUMNAR_OFFSET_FROM_UTC_KEY = "OffsetFromUTC";
+const char* COLUMNAR_OFFSETS_FROM_UTC_KEY = "OffsetsFromUTC";
+const char* COLUMNAR_PAYLOAD_COUNTS_KEY = "PayloadCounts";
+const char* COLUMNAR_PAYLOAD_STRINGS_KEY = "PayloadStrings";
 
 const char* EVENT_CATEGORY_KEY = "Category";
 const char* EVENT_PERIODIC_CATEGORY = "Periodic";
@@ -22,6 +35,9 @@ const char* EVENT_PAYLOAD_SCHEMA_VERSION_KEY = "PayloadSchemaVersion";
 const char* EVENT_ID_KEY = "Id";
 const char* EVENT_LOCAL_TIMESTAMP_KEY = "TimestampLocal";
 const char* EVENT_UTC_TIMESTAMP_KEY = "TimestampUTC";
+const char* EVENT_SNAPSHOT_ID_KEY = "SnapshotId";
+const char* EVENT_SNAPSHOT_PART_KEY = "SnapshotPart";
+const char* EVENT_SNAPSHOT_PARTS_KEY = "SnapshotParts";
 const char* EVENT_TYPE_SECURITY_VALUE = "Security";
 const char* EVENT_TYPE_OPERATIONAL_VALUE = "Operational";
 const char* EVENT_TYPE_DIAGNOSTIC_VALUE = "Diagnostic";
@@ -92,11 +108,30 @@ const char* AGENT_TELEMETRY_DROPPED_EVENTS_KEY = "DroppedEvents";
 const char* AGENT_TELEMETRY_DROPPED_EVENTS_NAME = "DroppedEventsStatistics";
 const char* AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION = "1.0";
 const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME = "MessageStatistics";
-const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION = "1.1";
 const char* AGENT_TELEMETRY_MESSAGES_FAILED_KEY = "TotalFailed";
 const char* AGENT_TELEMETRY_MESSAGES_SENT_KEY = "MessagesSent";
 const char* AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY = "MessagesUnder4KB";
+const char* AGENT_TELEMETRY_MESSAGES_FILL_RATIO_KEY = "FillRatioPercent";
+const char* AGENT_TELEMETRY_RECONNECT_ATTEMPTS_KEY = "ReconnectAttempts";
+const char* AGENT_TELEMETRY_DISCONNECTED_TIME_KEY = "DisconnectedMilliseconds";
 const char* AGENT_TELEMETRY_QUEUE_EVENTS_KEY = "Queue";
+const char* AGENT_TELEMETRY_EVICTED_EVENTS_NAME = "EvictedEventsStatistics";
+const char* AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_PRIORITY_KEY = "Priority";
+const char* AGENT_TELEMETRY_EVICTED_EVENTS_KEY = "EvictedEvents";
+const char* AGENT_TELEMETRY_MEMORY_CONSUMPTION_NAME = "MemoryConsumptionStatistics";
+const char* AGENT_TELEMETRY_MEMORY_CONSUMPTION_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_SUBSYSTEM_KEY = "Subsystem";
+const char* AGENT_TELEMETRY_ALLOCATED_BYTES_KEY = "AllocatedBytes";
+const char* AGENT_TELEMETRY_COLLECTOR_STATISTICS_NAME = "CollectorStatistics";
+const char* AGENT_TELEMETRY_COLLECTOR_STATISTICS_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_COLLECTOR_KEY = "Collector";
+const char* AGENT_TELEMETRY_COLLECTOR_RUNS_KEY = "Runs";
+const char* AGENT_TELEMETRY_COLLECTOR_OVERRUNS_KEY = "Overruns";
+const char* AGENT_TELEMETRY_COLLECTOR_SKIPPED_KEY = "Skipped";
+const char* AGENT_TELEMETRY_COLLECTOR_AVERAGE_DURATION_KEY = "AverageDurationMilliseconds";
+const char* AGENT_TELEMETRY_COLLECTOR_MAX_DURATION_KEY = "MaxDurationMilliseconds";
 
 const char* AGENT_CONFIGURATION_ERROR_CONFIGURATION_NAME_KEY = "ConfigurationName";
 const char* AGENT_CONFIGURATION_ERROR_ERROR_KEY = "ErrorType";
@@ -5,150 +5,393 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
-#include "json/json_array_writer.h"
-#include "json/json_object_writer.h"
+#include "columnar_message.h"
+#include "consts.h"
+#include "event_encoder.h"
 #include "local_config.h"
 #include "logger.h"
+#include "message_compressor.h"
 #include "message_schema_consts.h"
 #include "twin_configuration.h"
 
+#define MESSAGE_SERIALIZER_INITIAL_CAPACITY 1024
+
+/**
+ * The security message, assembled by appending the already serialized events to the serialized envelope.
+ * A compressed message is written into the compressor instead of the buffer.
+ */
+typedef struct _MessageBuffer {
+
+    char* data;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t numberOfEvents;
+    MessageCompressor* compressor;
+    EventEncoding encoding;
+    const EventFraming* framing;
+
+} MessageBuffer;
+
 /**
- * @brief Handle adding events to the message from a single queue
+ * The space which is left in the message while events are packed into it.
+ */
+typedef struct _MessageSpace {
+
+    uint32_t messageSize;       // the exact size of the message, without its closing
+    uint32_t pendingSize;       // the events taken since, and the compressed bytes which were not flushed yet
+    uint32_t numberOfEvents;
+    uint32_t targetSize;        // the size the message is packed up to
+    uint32_t maxSize;           // the hard limit, which only an event which does not fit in an empty message may use
+    bool compressed;            // the limits apply to the compressed size, so the pending bytes take their worst case
+    uint32_t separatorSize;     // the framing of the events, per the encoding of the message
+    uint32_t closingSize;
+
+} MessageSpace;
+
+/**
+ * @brief Appends the given bytes to the message, growing it if needed. The message is kept null terminated.
+ * 
+ * @param   message     The message.
+ * @param   data        The bytes to append.
+ * @param   size        The number of bytes to append.
+ * 
+ * @return true on success, false if memory ran out.
+ */
+static bool MessageSerializer_Append(MessageBuffer* message, const char* data, uint32_t size);
+
+/**
+ * @brief Flushes a compressed message, so the space which is left in it becomes exact. Does nothing for a plain message.
+ * 
+ * @param   message     The message.
+ * 
+ * @return true on success, false otherwise.
+ */
+static bool MessageSerializer_Flush(MessageBuffer* message);
+
+/**
+ * @brief Writes the envelope of the security message (the agent details) and opens the events array.
+ * 
+ * @param   message     The message to write to.
+ * 
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_WriteEnvelope(MessageBuffer* message);
+
+/**
+ * @brief Returns the size the messages are packed up to. A started billing unit is billed in full, so when the max message size
+ *        is not a multiple of the billing unit the messages are packed up to the last full unit.
+ * 
+ * @param   maxMessageSize  The max message size.
+ * 
+ * @return the target size of a message.
+ */
+static uint32_t MessageSerializer_GetTargetSize(uint32_t maxMessageSize);
+
+/**
+ * @brief Syncs the space with the size of the message.
+ * 
+ * @param   space       The space to sync.
+ * @param   message     The message.
+ */
+static void MessageSerializer_SyncSpace(MessageSpace* space, const MessageBuffer* message);
+
+/**
+ * @brief Returns the largest event which still fits in the message, or 0 if the message is full.
+ * 
+ * @param   space       The space left in the message.
+ * 
+ * @return the max data size of the next event.
+ */
+static uint32_t MessageSerializer_GetMaxEventSize(const MessageSpace* space);
+
+/**
+ * @brief A pop condition which takes the event if it fits in the space which is left in the message, and accounts for it.
+ *        The items of a batch are checked in order, each of them once.
+ */
+static bool MessageSerializer_EventFitsCondition(const void* data, uint32_t dataSize, void* conditionParams);
+
+/**
+ * @brief Handle adding events to the message from a single queue, in order, until an event does not fit.
  * 
  * @param   queue               Th queue to handle.
- * @param   eventsArray         The events array.
- * @param   currentMessageSize  Pointer to the current size of the security message.
- * @param   maxMessageSize      The max message size.
+ * @param   message             The message to add the events to.
+ * @param   space               The space left in the message.
  * 
- * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error. The value of the out param is undefined in case of failure.
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
  */
-static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize);
+static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, MessageBuffer* message, MessageSpace* space);
+
+/**
+ * @brief Fills the space left in the message with the largest events of the queue which still fit, out of order.
+ * 
+ * @param   queue               Th queue to handle.
+ * @param   message             The message to add the events to.
+ * @param   space               The space left in the message.
+ * 
+ * @return MESSAGE_SERIALIZER_OK once the queue is empty, MESSAGE_SERIALIZER_FULL if the message was filled before the queue was
+ *         emptied, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_PackEventsFromQueue(SyncQueue* queue, MessageBuffer* message, MessageSpace* space);
 
 /**
  * @brief Generated the event list serialization.
  * 
  * @param    queues         The queues to take event from, the serializer create events from the first queue, than the second etc...  
  * @param    len            The length of the queues array            
- * @param    parentObj      The parent object which will hold the list of events.
+ * @param    message        The message which will hold the list of events.
  * 
  * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
  */
-static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue* queues[], uint32_t len, JsonObjectWriterHandle parentObj);
+static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue* queues[], uint32_t len, MessageBuffer* message);
 
 /**
  * @brief Serialize single event to the array.
  * 
- * @param   queue               The queue to pop the event from
- * @param   eventsArray         The array of events to add the new event to.
- * @param   currentMessageSize  Pointer to the current size of the security message.
- * @param   maxMessageSize      The maximum message size of the security message.
+ * @param   message             The message to add the new event to.
+ * @param   data                The serialized event.
+ * @param   dataSize            The size of the serialized event, without the null terminator.
+ * 
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_AddSingleEvent(MessageBuffer* message, const char* data, uint32_t dataSize);
+
+/**
+ * @brief Creates the security message from the given queues.
+ * 
+ * @param    queues         The queues to take event from.
+ * @param    len            The length of the queues array.
+ * @param    message        The message to write to.
  * 
  * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
  */
-static MessageSerializerResultValues MessageSerializer_AddSingleEvent(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize);
+static MessageSerializerResultValues MessageSerializer_CreateMessage(SyncQueue* queues[], uint32_t len, MessageBuffer* message);
 
-typedef struct _SerializaerSizeLimits {
-    uint32_t currentMessageSize;
-    uint32_t maxMessageSize;
-} SerializaerSizeLimits;
+/**
+ * @brief Replaces a plain json message with its columnar layout (see columnar_message.h), if the message fits the layout
+ *        and the layout is smaller. Otherwise the message is left as is.
+ * 
+ * @param   message     The message.
+ */
+static void MessageSerializer_TranscodeColumnar(MessageBuffer* message);
 
 /**
- * @brief A message serializer size limitiation condition. Reutrn true if the data size + current size does not exceed the max size.
+ * @brief Compresses a complete message.
  * 
- * @param   data                The item
- * @param   size                The size of the item
- * @param   conditionParams     Struct of SerializaerSizeLimits
+ * @param   data            The message.
+ * @param   size            The size of the message.
+ * @param   buffer          Out param. The compressed message.
+ * @param   bufferSize      Out param. The size of the compressed message.
  * 
- * @return true if (size + currentMessageSize) < maxMessageSize
+ * @return true on success, false otherwise.
  */
-static bool sizeLimitationCondition(const void* data, uint32_t size, void* conditionParams) {
-    SerializaerSizeLimits* limits = (SerializaerSizeLimits*) conditionParams;
-    return ((limits->currentMessageSize + size) < limits->maxMessageSize);
+static bool MessageSerializer_Compress(const char* data, uint32_t size, void** buffer, uint32_t* bufferSize);
+
+static bool MessageSerializer_Append(MessageBuffer* message, const char* data, uint32_t size) {
+    if (message->compressor != NULL) {
+        return MessageCompressor_Write(message->compressor, data, size);
+    }
+
+    if (message->size + size + 1 > message->capacity) {
+        uint32_t capacity = message->capacity == 0 ? MESSAGE_SERIALIZER_INITIAL_CAPACITY : message->capacity;
+        while (message->size + size + 1 > capacity) {
+            capacity *= 2;
+        }
+
+        char* newData = realloc(message->data, capacity);
+        if (newData == NULL) {
+            return false;
+        }
+        message->data = newData;
+        message->capacity = capacity;
+    }
+
+    memcpy(message->data + message->size, data, size);
+    message->size += size;
+    message->data[message->size] = '\0';
+    return true;
+}
+
+static bool MessageSerializer_Flush(MessageBuffer* message) {
+    return message->compressor == NULL || MessageCompressor_Flush(message->compressor);
 }
 
-static MessageSerializerResultValues MessageSerializer_AddSingleEvent(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize) {
+static MessageSerializerResultValues MessageSerializer_WriteEnvelope(MessageBuffer* message) {
     MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
-    void* data = NULL;
-    uint32_t dataSize = 0;
-    JsonObjectWriterHandle eventWriter = NULL;
-    SerializaerSizeLimits limits;
-    limits.currentMessageSize = *currentMessageSize;
-    limits.maxMessageSize = maxMessageSize;
-    int queueResult = SyncQueue_PopFrontIf(queue, sizeLimitationCondition, &limits, &data, &dataSize);
-    if (queueResult == QUEUE_IS_EMPTY) {
-        result = MESSAGE_SERIALIZER_EMPTY;
-        goto cleanup;
-    } else if (queueResult == QUEUE_CONDITION_FAILED) {
-        result = MESSAGE_SERIALIZER_MEMORY_EXCEEDED;
-        goto cleanup;
-    } else if (queueResult != QUEUE_OK) {
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
-    }
-    
-    if (JsonObjectWriter_InitFromString(&eventWriter, data) != JSON_WRITER_OK) {
-        Logger_Error("Error parsing event data as json");
+    char* envelope = NULL;
+    uint32_t envelopeSize = 0;
+
+    const char* keys[] = { AGENT_VERSION_KEY, AGENT_ID_KEY, MESSAGE_SCHEMA_VERSION_KEY };
+    const char* values[] = { AGENT_VERSION, LocalConfiguration_GetAgentId(), DEFAULT_MESSAGE_SCHEMA_VERSION };
+    if (EventEncoder_EncodeEnvelope(message->encoding, keys, values, sizeof(keys) / sizeof(keys[0]), EVENTS_KEY, &envelope, &envelopeSize) != JSON_WRITER_OK) {
+        Logger_Error("Error serialing the security message");
         result = MESSAGE_SERIALIZER_EXCEPTION;
         goto cleanup;
     }
 
-    if (JsonArrayWriter_AddObject(eventsArray, eventWriter) != JSON_WRITER_OK) {
-        Logger_Error("error while appending the new event to the array");
+    if (!MessageSerializer_Append(message, envelope, envelopeSize)) {
+        Logger_Error("Error allocating the security message");
         result = MESSAGE_SERIALIZER_EXCEPTION;
         goto cleanup;
     }
-    *currentMessageSize += dataSize;
 
 cleanup:
-    if (data != NULL) {
-        free(data);
+    if (envelope != NULL) {
+        free(envelope);
     }
 
-    if (eventWriter != NULL) {
-        JsonObjectWriter_Deinit(eventWriter);
+    return result;
+}
+
+static MessageSerializerResultValues MessageSerializer_AddSingleEvent(MessageBuffer* message, const char* data, uint32_t dataSize) {
+    // the events are serialized by the collectors, so they are spliced as is instead of being parsed again
+    if (!EventEncoder_IsObject(message->encoding, data, dataSize)) {
+        Logger_Error("Error event data is not an object of the message encoding");
+        return MESSAGE_SERIALIZER_EXCEPTION;
     }
 
-    return result;
+    uint32_t messageSize = message->size;
+    if ((message->numberOfEvents > 0 && !MessageSerializer_Append(message, message->framing->separator, message->framing->separatorSize)) ||
+        !MessageSerializer_Append(message, data, dataSize)) {
+        Logger_Error("error while appending the new event to the array");
+        // drop a dangling separator, a failed compressed stream fails the whole message
+        if (message->compressor == NULL) {
+            message->size = messageSize;
+            message->data[messageSize] = '\0';
+        }
+        return MESSAGE_SERIALIZER_EXCEPTION;
+    }
+
+    message->numberOfEvents++;
+    return MESSAGE_SERIALIZER_OK;
 }
 
-static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize) {
-    MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
+static uint32_t MessageSerializer_GetTargetSize(uint32_t maxMessageSize) {
+    if (maxMessageSize < MESSAGE_BILLING_MULTIPLE) {
+        return maxMessageSize;
+    }
+    return maxMessageSize - maxMessageSize % MESSAGE_BILLING_MULTIPLE;
+}
 
-    uint32_t queueSize = 0;
+static void MessageSerializer_SyncSpace(MessageSpace* space, const MessageBuffer* message) {
+    if (message->compressor != NULL) {
+        space->messageSize = message->compressor->size;
+        space->pendingSize = message->compressor->pendingSize;
+    } else {
+        space->messageSize = message->size;
+        space->pendingSize = 0;
+    }
+    space->numberOfEvents = message->numberOfEvents;
+}
 
-    if (SyncQueue_GetSize(queue, &queueSize) != QUEUE_OK) {
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+static uint32_t MessageSerializer_GetMaxEventSize(const MessageSpace* space) {
+    uint32_t limit = space->numberOfEvents == 0 ? space->maxSize : space->targetSize;
+    if (limit <= space->messageSize) {
+        return 0;
+    }
+
+    uint32_t room = limit - space->messageSize;
+    if (space->compressed) {
+        room = MessageCompressor_GetMaxInputSize(room);
+    }
+
+    uint32_t overhead = space->pendingSize + space->closingSize + (space->numberOfEvents == 0 ? 0 : space->separatorSize);
+    return room > overhead ? room - overhead : 0;
+}
+
+static bool MessageSerializer_EventFitsCondition(const void* data, uint32_t dataSize, void* conditionParams) {
+    MessageSpace* space = (MessageSpace*)conditionParams;
+    if (dataSize == 0 || dataSize > MessageSerializer_GetMaxEventSize(space)) {
+        return false;
     }
 
-    while (queueSize > 0 && *currentMessageSize < maxMessageSize) {
-        result = MessageSerializer_AddSingleEvent(queue, eventsArray, currentMessageSize, maxMessageSize);
-        if (result == MESSAGE_SERIALIZER_MEMORY_EXCEEDED) {
-            result = MESSAGE_SERIALIZER_OK;
+    space->pendingSize += dataSize + (space->numberOfEvents == 0 ? 0 : space->separatorSize);
+    space->numberOfEvents++;
+    return true;
+}
+
+static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, MessageBuffer* message, MessageSpace* space) {
+    MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
+    SyncQueueBatch batch;
+    void* data = NULL;
+    uint32_t dataSize = 0;
+
+    do {
+        // all the events which fit in the message are detached at once, so the queue lock is not taken per event
+        MessageSerializer_SyncSpace(space, message);
+        int queueResult = SyncQueue_PopBatchIf(queue, MessageSerializer_EventFitsCondition, space, UINT32_MAX, &batch);
+        if (queueResult == QUEUE_IS_EMPTY || (queueResult == QUEUE_CONDITION_FAILED && space->pendingSize == 0)) {
             break;
-        } else if (result == MESSAGE_SERIALIZER_EMPTY) {
-            result = MESSAGE_SERIALIZER_OK;
+        } else if (queueResult != QUEUE_OK && queueResult != QUEUE_CONDITION_FAILED) {
+            result = MESSAGE_SERIALIZER_EXCEPTION;
             break;
-        } else if (result != MESSAGE_SERIALIZER_OK) {
+        }
+
+        // the batch owns the events, so it is drained even if one of them is malformed
+        while (queueResult == QUEUE_OK && SyncQueue_BatchPopFront(&batch, &data, &dataSize) == QUEUE_OK) {
+            if (MessageSerializer_AddSingleEvent(message, data, dataSize) != MESSAGE_SERIALIZER_OK) {
+                result = MESSAGE_SERIALIZER_EXCEPTION;
+            }
+            Queue_FreeData(data);
+        }
+
+        // the pending bytes of a compressed message are accounted at their worst case, once they are flushed the
+        // message usually has room for more events. The number of flushes is logarithmic since each one shrinks the room.
+        if (!MessageSerializer_Flush(message)) {
             result = MESSAGE_SERIALIZER_EXCEPTION;
-            goto cleanup;
+            break;
         }
+    } while (space->compressed);
 
-        if (SyncQueue_GetSize(queue, &queueSize) != QUEUE_OK) {
+    return result;
+}
+
+static MessageSerializerResultValues MessageSerializer_PackEventsFromQueue(SyncQueue* queue, MessageBuffer* message, MessageSpace* space) {
+    MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
+    void* data = NULL;
+    uint32_t dataSize = 0;
+    bool emptied = false;
+
+    MessageSerializer_SyncSpace(space, message);
+    uint32_t maxEventSize = MessageSerializer_GetMaxEventSize(space);
+    while (maxEventSize > 0 || space->pendingSize > 0) {
+        int queueResult = maxEventSize > 0 ? SyncQueue_PopBestFit(queue, maxEventSize, &data, &dataSize) : QUEUE_CONDITION_FAILED;
+        if (queueResult == QUEUE_CONDITION_FAILED && space->pendingSize > 0) {
+            // the worst case of the pending bytes may be what keeps the next event out, flushing them makes the room exact
+            if (!MessageSerializer_Flush(message)) {
+                result = MESSAGE_SERIALIZER_EXCEPTION;
+                break;
+            }
+        } else if (queueResult == QUEUE_IS_EMPTY) {
+            emptied = true;
+            break;
+        } else if (queueResult == QUEUE_CONDITION_FAILED) {
+            break;
+        } else if (queueResult != QUEUE_OK) {
             result = MESSAGE_SERIALIZER_EXCEPTION;
-            goto cleanup;
+            break;
+        } else {
+            if (MessageSerializer_AddSingleEvent(message, data, dataSize) != MESSAGE_SERIALIZER_OK) {
+                result = MESSAGE_SERIALIZER_EXCEPTION;
+            }
+            Queue_FreeData(data);
         }
+
+        MessageSerializer_SyncSpace(space, message);
+        maxEventSize = MessageSerializer_GetMaxEventSize(space);
+    }
+
+    // the events left in the queue wait for the next message
+    if (result == MESSAGE_SERIALIZER_OK && !emptied) {
+        result = MESSAGE_SERIALIZER_FULL;
     }
 
-cleanup:
     return result;
 }
 
-static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue** queues, uint32_t size, JsonObjectWriterHandle parentObj) { 
+static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue** queues, uint32_t size, MessageBuffer* message) { 
     MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
-    JsonArrayWriterHandle eventsArray = NULL;
-    uint32_t currentMessageSize = 0;
 
     if (size == 0){
         goto cleanup;
@@ -160,92 +403,148 @@ static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQue
         goto cleanup;
     }
 
-    if (JsonArrayWriter_Init(&eventsArray) != JSON_WRITER_OK) {
-        Logger_Error("Error initializing the new events array");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+    MessageSpace space = { 0 };
+    space.maxSize = maxMessageSize;
+    space.targetSize = MessageSerializer_GetTargetSize(maxMessageSize);
+    space.compressed = message->compressor != NULL;
+    space.separatorSize = message->framing->separatorSize;
+    space.closingSize = message->framing->closingSize;
+
+    // the queues are taken in order first, then the space which is left behind an event that did not fit is packed with smaller ones
+    for (int i = 0; i < size; i++){
+        if (MessageSerializer_AddEventsFromQueue(queues[i], message, &space) != MESSAGE_SERIALIZER_OK) {
+            result = MESSAGE_SERIALIZER_PARTIAL;
+        }
     }
 
+    bool full = false;
     for (int i = 0; i < size; i++){
-        if (currentMessageSize < maxMessageSize) {
-            if (MessageSerializer_AddEventsFromQueue(queues[i], eventsArray, &currentMessageSize, maxMessageSize) != MESSAGE_SERIALIZER_OK) {
-                result = MESSAGE_SERIALIZER_PARTIAL;
-            }
+        MessageSerializerResultValues packResult = MessageSerializer_PackEventsFromQueue(queues[i], message, &space);
+        if (packResult == MESSAGE_SERIALIZER_FULL) {
+            full = true;
+        } else if (packResult != MESSAGE_SERIALIZER_OK) {
+            result = MESSAGE_SERIALIZER_PARTIAL;
         }
     }
 
-    if (JsonObjectWriter_WriteArray(parentObj, EVENTS_KEY, eventsArray) != JSON_WRITER_OK) {
-        Logger_Error("Error setting events array value to security message");
+    if (!MessageSerializer_Append(message, message->framing->closing, message->framing->closingSize)) {
+        Logger_Error("Error closing the security message");
         result = MESSAGE_SERIALIZER_EXCEPTION;
         goto cleanup;
     }
+
+    if (result == MESSAGE_SERIALIZER_OK && full) {
+        result = MESSAGE_SERIALIZER_FULL;
+    }
     
 cleanup:
-    if (eventsArray != NULL) {
-        JsonArrayWriter_Deinit(eventsArray);
-    }
-    if (currentMessageSize == 0) {
+    if (message->numberOfEvents == 0) {
         result = MESSAGE_SERIALIZER_EMPTY;
     }
 
     return result;
 }
 
-MessageSerializerResultValues MessageSerializer_CreateSecurityMessage(SyncQueue* queues[], uint32_t len, void** buffer) {
-    MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
-
-    JsonObjectWriterHandle securityMessageWriter = NULL;
-    if (JsonObjectWriter_Init(&securityMessageWriter) != JSON_WRITER_OK) {
-        Logger_Error("Error initializing the security message writer");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
-    }
-    
-    if (JsonObjectWriter_WriteString(securityMessageWriter, AGENT_VERSION_KEY, AGENT_VERSION) != JSON_WRITER_OK) {
-        Logger_Error("Error setting the agent version");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+static MessageSerializerResultValues MessageSerializer_CreateMessage(SyncQueue* queues[], uint32_t len, MessageBuffer* message) {
+    // the envelope is written before the queues are drained, so a failure does not lose events
+    MessageSerializerResultValues result = MessageSerializer_WriteEnvelope(message);
+    if (result != MESSAGE_SERIALIZER_OK) {
+        return result;
     }
 
-    if (JsonObjectWriter_WriteString(securityMessageWriter, AGENT_ID_KEY, LocalConfiguration_GetAgentId()) != JSON_WRITER_OK) {
-        Logger_Error("Error setting the agent version");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
-    }
+    return MessageSerializer_GenerateEventList(queues, len, message);
+}
 
-    if (JsonObjectWriter_WriteString(securityMessageWriter, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION) != JSON_WRITER_OK) {
-        Logger_Error("Error setting the agent version");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+MessageSerializerResultValues MessageSerializer_CreateSecurityMessage(SyncQueue* queues[], uint32_t len, void** buffer) {
+    MessageBuffer message = { 0 };
+    message.encoding = EVENT_ENCODING_JSON;
+    message.framing = EventEncoder_GetFraming(EVENT_ENCODING_JSON);
+
+    MessageSerializerResultValues result = MessageSerializer_CreateMessage(queues, len, &message);
+    if (result == MESSAGE_SERIALIZER_OK || result == MESSAGE_SERIALIZER_PARTIAL || result == MESSAGE_SERIALIZER_FULL) {
+        *buffer = message.data;
+    } else if (message.data != NULL) {
+        free(message.data);
     }
 
-    result = MessageSerializer_GenerateEventList(queues, len, securityMessageWriter);
-    if (result == MESSAGE_SERIALIZER_EMPTY) {
-        goto cleanup;
+    return result;
+}
+
+static void MessageSerializer_TranscodeColumnar(MessageBuffer* message) {
+    char* columnarData = NULL;
+    uint32_t columnarSize = 0;
+    if (!ColumnarMessage_Transcode(message->data, &columnarData, &columnarSize)) {
+        Logger_Debug("The security message is kept in rows, its events do not fit the columnar layout");
+        return;
     }
 
-    if (result != MESSAGE_SERIALIZER_OK && result != MESSAGE_SERIALIZER_PARTIAL) {
-        goto cleanup;
+    // a message of a few events of different types may gain nothing from the layout
+    if (columnarSize >= message->size) {
+        free(columnarData);
+        return;
     }
 
-    uint32_t buffersize = 0;
-    if (JsonObjectWriter_Serialize(securityMessageWriter, (char**)buffer, &buffersize) != JSON_WRITER_OK) {
-        Logger_Error("Error serialing the security message");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
+    free(message->data);
+    message->data = columnarData;
+    message->size = columnarSize;
+    message->capacity = columnarSize + 1;
+}
+
+static bool MessageSerializer_Compress(const char* data, uint32_t size, void** buffer, uint32_t* bufferSize) {
+    MessageCompressor compressor;
+    if (!MessageCompressor_Init(&compressor)) {
+        return false;
     }
 
-cleanup:
-    
-    if (securityMessageWriter != NULL) {
-        JsonObjectWriter_Deinit(securityMessageWriter);
+    bool success = MessageCompressor_Write(&compressor, data, size) && MessageCompressor_Finish(&compressor, buffer, bufferSize);
+    MessageCompressor_Deinit(&compressor);
+    return success;
+}
+
+MessageSerializerResultValues MessageSerializer_CreateEncodedSecurityMessage(SyncQueue* queues[], uint32_t len, EventEncoding encoding, bool compressed, bool columnar, void** buffer, uint32_t* bufferSize) {
+    MessageBuffer message = { 0 };
+    MessageCompressor compressor;
+    message.encoding = encoding;
+    message.framing = EventEncoder_GetFraming(encoding);
+
+    // the columnar layout is transcoded from the complete json message, so its rows are packed plain and compressed once transcoded
+    columnar = columnar && encoding == EVENT_ENCODING_JSON;
+    if (compressed && !columnar) {
+        if (!MessageCompressor_Init(&compressor)) {
+            return MESSAGE_SERIALIZER_EXCEPTION;
+        }
+        message.compressor = &compressor;
     }
 
-    if (result != MESSAGE_SERIALIZER_OK && result != MESSAGE_SERIALIZER_PARTIAL) {
-        if (*buffer != NULL) {
-            free(*buffer);
-            *buffer = NULL;
+    MessageSerializerResultValues result = MessageSerializer_CreateMessage(queues, len, &message);
+    if (result != MESSAGE_SERIALIZER_OK && result != MESSAGE_SERIALIZER_PARTIAL && result != MESSAGE_SERIALIZER_FULL) {
+        if (message.data != NULL) {
+            free(message.data);
+        }
+    } else if (message.compressor != NULL) {
+        if (!MessageCompressor_Finish(&compressor, buffer, bufferSize)) {
+            Logger_Error("Error compressing the security message");
+            result = MESSAGE_SERIALIZER_EXCEPTION;
+        }
+    } else {
+        if (columnar) {
+            MessageSerializer_TranscodeColumnar(&message);
+        }
+
+        if (!compressed) {
+            *buffer = message.data;
+            *bufferSize = message.size;
+        } else {
+            if (!MessageSerializer_Compress(message.data, message.size, buffer, bufferSize)) {
+                Logger_Error("Error compressing the security message");
+                result = MESSAGE_SERIALIZER_EXCEPTION;
+            }
+            free(message.data);
         }
     }
 
+    if (message.compressor != NULL) {
+        MessageCompressor_Deinit(&compressor);
+    }
     return result;
 }
\ No newline at end of file
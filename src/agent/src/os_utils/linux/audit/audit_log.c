@@ -0,0 +1,340 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "os_utils/linux/audit/audit_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "consts.h"
+#include "logger.h"
+#include "utils.h"
+
+// the end of the log is looked for in its tail, a line of the log is much shorter
+#define AUDIT_LOG_TAIL_SIZE (16 * 1024)
+// a rotation may rename the files while the next file is looked for
+#define AUDIT_LOG_MAX_RENAME_RETRIES 3
+
+static const char AUDIT_LOG_ROTATED_FILE_FORMAT[] = "%s.%u";
+static const char AUDIT_LOG_EVENT_PREFIX[] = "msg=audit(";
+
+/**
+ * @brief Builds the path of the log file with the given index, 0 is the active log and the rest are its rotated files.
+ *
+ * @return true on success, false if the path is too long.
+ */
+static bool AuditLog_GetFilePath(const char* path, uint32_t index, char* filePath);
+
+/**
+ * @brief Looks for the log file with the given inode.
+ *
+ * @param   path    The path of the active log.
+ * @param   inode   The inode of the file.
+ * @param   index   Out param. The index of the file.
+ *
+ * @return true if the file was found, false otherwise.
+ */
+static bool AuditLog_FindFile(const char* path, uint64_t inode, uint32_t* index);
+
+/**
+ * @brief Moves the reader to the start of the log file which is newer than the file it read to its end.
+ *
+ * @return AUDIT_LOG_OK on success, AUDIT_LOG_END in case the file is the active log (or is no longer in the log) or AUDIT_LOG_EXCEPTION.
+ */
+static AuditLogResult AuditLog_NextFile(AuditLogReader* reader);
+
+/**
+ * @brief Finds the identifier of the event of a line, the text between "msg=audit(" and the closing parenthesis.
+ *
+ * @param   line        The line.
+ * @param   lineEnd     The end of the line.
+ * @param   length      Out param. The length of the identifier.
+ *
+ * @return the identifier, or NULL if the line has none.
+ */
+static const char* AuditLog_GetEventId(const char* line, const char* lineEnd, size_t* length);
+
+/**
+ * @brief Cuts the lines of the last event off the end of a chunk, unless the chunk holds a single event.
+ *
+ * @param   chunk   The chunk, which ends with a new line.
+ * @param   length  The length of the chunk.
+ *
+ * @return the length of the chunk without its last event.
+ */
+static size_t AuditLog_CutLastEvent(const char* chunk, size_t length);
+
+bool AuditLog_GetEnd(const char* path, AuditLogPosition* end) {
+    bool success = false;
+    char tail[AUDIT_LOG_TAIL_SIZE];
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        Logger_Warning("Could not open the audit log, errno=%d", errno);
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        goto cleanup;
+    }
+
+    off_t tailOffset = fileStat.st_size > AUDIT_LOG_TAIL_SIZE ? fileStat.st_size - AUDIT_LOG_TAIL_SIZE : 0;
+    ssize_t tailSize = pread(fd, tail, fileStat.st_size - tailOffset, tailOffset);
+    if (tailSize < 0) {
+        goto cleanup;
+    }
+
+    // the last line may still be written
+    ssize_t i = tailSize;
+    while (i > 0 && tail[i - 1] != '\n') {
+        --i;
+    }
+
+    if (i == 0 && tailOffset > 0) {
+        goto cleanup;
+    }
+
+    end->inode = fileStat.st_ino;
+    end->offset = tailOffset + i;
+    success = true;
+
+cleanup:
+    close(fd);
+    return success;
+}
+
+AuditLogResult AuditLog_Open(AuditLogReader* reader, const char* path, const AuditLogPosition* position) {
+    AuditLogResult result = AUDIT_LOG_OK;
+    char filePath[PATH_MAX];
+    uint32_t index = 0;
+
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = -1;
+
+    if (!AuditLog_FindFile(path, position->inode, &index)) {
+        return AUDIT_LOG_NOT_FOUND;
+    }
+
+    if (!Utils_CreateStringCopy(&reader->path, path) || !AuditLog_GetFilePath(path, index, filePath)) {
+        result = AUDIT_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    reader->fd = open(filePath, O_RDONLY | O_CLOEXEC);
+    if (reader->fd < 0) {
+        // the file was rotated away since it was found
+        result = AUDIT_LOG_NOT_FOUND;
+        goto cleanup;
+    }
+
+    // a rotation may have renamed another file to the path since it was found, and auditd may truncate the active log
+    struct stat fileStat;
+    if (fstat(reader->fd, &fileStat) != 0) {
+        result = AUDIT_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (fileStat.st_ino != position->inode || (uint64_t)fileStat.st_size < position->offset) {
+        result = AUDIT_LOG_NOT_FOUND;
+        goto cleanup;
+    }
+
+    reader->chunk = malloc(AUDIT_LOG_CHUNK_SIZE);
+    if (reader->chunk == NULL) {
+        result = AUDIT_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    reader->position = *position;
+
+cleanup:
+    if (result != AUDIT_LOG_OK) {
+        AuditLog_Close(reader);
+    }
+    return result;
+}
+
+AuditLogResult AuditLog_ReadChunk(AuditLogReader* reader, const char** chunk) {
+    // the last byte is kept for the terminator
+    size_t maxSize = AUDIT_LOG_CHUNK_SIZE - 1;
+
+    while (true) {
+        ssize_t size = pread(reader->fd, reader->chunk, maxSize, reader->position.offset);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger_Error("Could not read the audit log, errno=%d", errno);
+            return AUDIT_LOG_EXCEPTION;
+        }
+
+        size_t length = size;
+        while (length > 0 && reader->chunk[length - 1] != '\n') {
+            --length;
+        }
+
+        if (length == 0) {
+            if ((size_t)size == maxSize) {
+                Logger_Warning("Skipped a line of the audit log which is longer than %u bytes.", AUDIT_LOG_CHUNK_SIZE);
+                reader->position.offset += size;
+                continue;
+            }
+
+            // the file was read to its end, a partial line of the active log is read once it is complete
+            AuditLogResult result = AuditLog_NextFile(reader);
+            if (result != AUDIT_LOG_OK) {
+                return result;
+            }
+            continue;
+        }
+
+        if ((size_t)size == maxSize) {
+            length = AuditLog_CutLastEvent(reader->chunk, length);
+        }
+
+        reader->chunk[length] = '\0';
+        reader->position.offset += length;
+        *chunk = reader->chunk;
+        return AUDIT_LOG_OK;
+    }
+}
+
+void AuditLog_Close(AuditLogReader* reader) {
+    if (reader->fd >= 0) {
+        close(reader->fd);
+        reader->fd = -1;
+    }
+
+    if (reader->path != NULL) {
+        free(reader->path);
+        reader->path = NULL;
+    }
+
+    if (reader->chunk != NULL) {
+        free(reader->chunk);
+        reader->chunk = NULL;
+    }
+}
+
+static bool AuditLog_GetFilePath(const char* path, uint32_t index, char* filePath) {
+    int length = 0;
+    if (index == 0) {
+        length = snprintf(filePath, PATH_MAX, "%s", path);
+    } else {
+        length = snprintf(filePath, PATH_MAX, AUDIT_LOG_ROTATED_FILE_FORMAT, path, index);
+    }
+    return length > 0 && length < PATH_MAX;
+}
+
+static bool AuditLog_FindFile(const char* path, uint64_t inode, uint32_t* index) {
+    char filePath[PATH_MAX];
+    struct stat fileStat;
+
+    for (uint32_t i = 0; i <= AUDIT_LOG_MAX_ROTATED_FILES; ++i) {
+        // the rotated files are numbered without gaps
+        if (!AuditLog_GetFilePath(path, i, filePath) || stat(filePath, &fileStat) != 0) {
+            return false;
+        }
+
+        if (fileStat.st_ino == inode) {
+            *index = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static AuditLogResult AuditLog_NextFile(AuditLogReader* reader) {
+    char filePath[PATH_MAX];
+    struct stat fileStat;
+
+    for (uint32_t attempt = 0; attempt < AUDIT_LOG_MAX_RENAME_RETRIES; ++attempt) {
+        uint32_t index = 0;
+        if (!AuditLog_FindFile(reader->path, reader->position.inode, &index) || index == 0) {
+            return AUDIT_LOG_END;
+        }
+
+        if (!AuditLog_GetFilePath(reader->path, index - 1, filePath)) {
+            return AUDIT_LOG_EXCEPTION;
+        }
+
+        int fd = open(filePath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        // the newer file is the right one only if the file which was read was not renamed meanwhile
+        uint32_t currentIndex = 0;
+        if (fstat(fd, &fileStat) != 0 || !AuditLog_FindFile(reader->path, reader->position.inode, &currentIndex) || currentIndex != index) {
+            close(fd);
+            continue;
+        }
+
+        close(reader->fd);
+        reader->fd = fd;
+        reader->position.inode = fileStat.st_ino;
+        reader->position.offset = 0;
+        return AUDIT_LOG_OK;
+    }
+
+    // the position stays at the end of the file, the next search moves on from it
+    return AUDIT_LOG_END;
+}
+
+static const char* AuditLog_GetEventId(const char* line, const char* lineEnd, size_t* length) {
+    size_t prefixLength = sizeof(AUDIT_LOG_EVENT_PREFIX) - 1;
+
+    for (const char* current = line; current + prefixLength <= lineEnd; ++current) {
+        if (memcmp(current, AUDIT_LOG_EVENT_PREFIX, prefixLength) == 0) {
+            const char* id = current + prefixLength;
+            const char* idEnd = memchr(id, ')', lineEnd - id);
+            if (idEnd == NULL) {
+                return NULL;
+            }
+            *length = idEnd - id;
+            return id;
+        }
+    }
+
+    return NULL;
+}
+
+static size_t AuditLog_CutLastEvent(const char* chunk, size_t length) {
+    const char* lineEnd = chunk + length - 1;
+    const char* line = lineEnd;
+    while (line > chunk && line[-1] != '\n') {
+        --line;
+    }
+
+    size_t lastIdLength = 0;
+    const char* lastId = AuditLog_GetEventId(line, lineEnd, &lastIdLength);
+    if (lastId == NULL) {
+        return length;
+    }
+
+    // the records of an event are written one after the other
+    while (line > chunk) {
+        lineEnd = line - 1;
+        const char* previousLine = lineEnd;
+        while (previousLine > chunk && previousLine[-1] != '\n') {
+            --previousLine;
+        }
+
+        size_t idLength = 0;
+        const char* id = AuditLog_GetEventId(previousLine, lineEnd, &idLength);
+        if (id == NULL || idLength != lastIdLength || memcmp(id, lastId, idLength) != 0) {
+            return line - chunk;
+        }
+        line = previousLine;
+    }
+
+    return length;
+}
@@ -7,10 +7,15 @@
 #include <libaudit.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
+#include "collectors/collector_execution.h"
+#include "consts.h"
 #include "internal/time_utils.h"
 #include "logger.h"
 #include "os_utils/file_utils.h"
+#include "os_utils/linux/audit/audit_log.h"
+#include "os_utils/linux/audit/audit_stream.h"
 #include "utils.h"
 
 static const char AUDIT_SEARCH_CRITERIA_TYPE_NAME[] = "type";
@@ -28,13 +33,58 @@ static const char AUDIT_USER_AUTH_SEARECH_RULE[] = "(type r= USER_AUTH) && (exe
 const char* AuditSearch_ConvertCriteriaToString(AuditSearchCriteria searchCriteria);
 
 /**
- * @brief Adds a timestamp checkpoint to the search.
+ * @brief Reads the checkpoint of the previous search.
  * 
  * @param   auditSearch     The search instance.
  * 
- * @return AUDIT_SEARCH_OKin case the checkpoint was added or the checkpoint file does not exist, otherwise AUDIT_SEARCH_EXCEPTION is returned.
+ * @return AUDIT_SEARCH_OK in case the checkpoint was read or the checkpoint file does not exist, otherwise AUDIT_SEARCH_EXCEPTION is returned.
  */
-AuditSearchResultValues AuditSearch_AddCheckpointToSearch(AuditSearch* auditSearch);
+static AuditSearchResultValues AuditSearch_ReadCheckpoint(AuditSearch* auditSearch);
+
+/**
+ * @brief Initiates the parser of the search over the given source, with the rules of the search.
+ * 
+ * @param   auditSearch     The search instance.
+ * @param   source          The source to parse.
+ * @param   buffer          The text to parse, for a buffer source.
+ * 
+ * @return AUDIT_SEARCH_OK on success, otherwise AUDIT_SEARCH_EXCEPTION is returned.
+ */
+static AuditSearchResultValues AuditSearch_InitParser(AuditSearch* auditSearch, ausource_t source, const char* buffer);
+
+/**
+ * @brief Parses the next chunk of the log, once the search has read the current one.
+ * 
+ * @param   auditSearch     The search instance.
+ * 
+ * @return AUDIT_SEARCH_HAS_MORE_DATA in case there is another chunk, AUDIT_SEARCH_NO_MORE_DATA in case the log was read to its end
+ *         or the search ran out of its time, or AUDIT_SEARCH_EXCEPTION.
+ */
+static AuditSearchResultValues AuditSearch_NextChunk(AuditSearch* auditSearch);
+
+/**
+ * @brief Progresses the search to the next matching event, including events which were consumed by the previous search.
+ * 
+ * @param   auditSearch     The search instance.
+ * 
+ * @return AUDIT_SEARCH_HAS_MORE_DATA in case there is another event, AUDIT_SEARCH_NO_MORE_DATA in case the search has finished or AUDIT_SEARCH_EXCEPTION.
+ */
+static AuditSearchResultValues AuditSearch_NextEvent(AuditSearch* auditSearch);
+
+/**
+ * @brief Checks whether the event was consumed by the previous search.
+ * 
+ * @param   checkpoint  The last event of the previous search.
+ * @param   event       The event.
+ * 
+ * @return true if the event is not after the checkpoint.
+ */
+static bool AuditSearch_IsConsumed(const AuditSearchCheckpoint* checkpoint, const au_event_t* event);
+
+/**
+ * @brief Returns the current time of a monotonic clock in milliseconds.
+ */
+static uint64_t AuditSearch_GetTime();
 
 AuditSearchResultValues AuditSearch_Init(AuditSearch* auditSearch, AuditSearchCriteria searchCriteria, const char* messageType, const char* checkpointFile) {
     const char* oneMessageTypeType[1];
@@ -48,17 +98,98 @@ AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* audi
     auditSearch->firstSearch = true;
     AuditSearchResultValues result = AUDIT_SEARCH_OK;
 
+    auditSearch->searchCriteria = searchCriteria;
+    auditSearch->messageTypesCount = messageTypesCount;
+    auditSearch->messageTypes = calloc(messageTypesCount > 0 ? messageTypesCount : 1, sizeof(const char*));
+    if (auditSearch->messageTypes == NULL) {
+        result = AUDIT_SEARCH_EXCEPTION;
+        goto cleanup;
+    }
+    for (uint32_t i = 0; i < messageTypesCount; ++i) {
+        auditSearch->messageTypes[i] = messageTypes[i];
+    }
+
     if (!ProcessInfoHandler_ChangeToRoot(&auditSearch->processInfo)) {
         Logger_Warning("Can not set privileges to root.");
         result = AUDIT_SEARCH_EXCEPTION;
         goto cleanup;
     }
 
-    auditSearch->audit = auparse_init(AUSOURCE_LOGS, NULL);
+    if (checkpointFile != NULL){
+        if (!(Utils_CreateStringCopy(&auditSearch->checkpointFile, checkpointFile))) {
+            result = AUDIT_SEARCH_EXCEPTION;
+            goto cleanup;
+        }
+
+        if (AuditSearch_ReadCheckpoint(auditSearch) != AUDIT_SEARCH_OK) {
+            result = AUDIT_SEARCH_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    // a collector which is caught up with the audit stream searches the events the stream buffered for it, instead of the logs
+    AuditStreamResult streamResult = AUDIT_STREAM_UNAVAILABLE;
+    CollectorId collectorId;
+    if (checkpointFile != NULL && CollectorExecution_GetCurrent(&collectorId)) {
+        streamResult = AuditStream_TakeEvents(collectorId, searchCriteria, messageTypes, messageTypesCount, &auditSearch->streamEvents);
+        auditSearch->streamSubscribed = streamResult != AUDIT_STREAM_UNAVAILABLE;
+    }
+
+    if (streamResult == AUDIT_STREAM_NO_EVENTS) {
+        // nothing arrived since the previous search, so there is nothing to parse
+        auditSearch->finished = true;
+    } else if (auditSearch->streamEvents != NULL) {
+        result = AuditSearch_InitParser(auditSearch, AUSOURCE_BUFFER, auditSearch->streamEvents);
+    } else {
+        // the log is read from the position of the checkpoint, so a search parses only the events which were logged since the previous one
+        if (auditSearch->position.inode != 0) {
+            AuditLogResult logResult = AuditLog_Open(&auditSearch->log, AUDIT_LOG_FILE_PATH, &auditSearch->position);
+            if (logResult == AUDIT_LOG_EXCEPTION) {
+                result = AUDIT_SEARCH_EXCEPTION;
+                goto cleanup;
+            }
+            auditSearch->readsLog = logResult == AUDIT_LOG_OK;
+        }
+
+        if (auditSearch->readsLog) {
+            const char* chunk = NULL;
+            AuditLogResult logResult = AuditLog_ReadChunk(&auditSearch->log, &chunk);
+            if (logResult == AUDIT_LOG_OK) {
+                result = AuditSearch_InitParser(auditSearch, AUSOURCE_BUFFER, chunk);
+            } else if (logResult == AUDIT_LOG_END) {
+                auditSearch->finished = true;
+                auditSearch->position = auditSearch->log.position;
+            } else {
+                result = AUDIT_SEARCH_EXCEPTION;
+            }
+        } else {
+            // the position is unknown or was rotated away, so all the logs are searched by time and the position is set to their current end
+            if (checkpointFile != NULL && !AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, &auditSearch->logEnd)) {
+                memset(&auditSearch->logEnd, 0, sizeof(auditSearch->logEnd));
+            }
+            result = AuditSearch_InitParser(auditSearch, AUSOURCE_LOGS, NULL);
+        }
+
+        if (result != AUDIT_SEARCH_OK) {
+            goto cleanup;
+        }
+    }
+  
+    auditSearch->searchTime = TimeUtils_GetCurrentTime();
+    auditSearch->deadline = AuditSearch_GetTime() + AUDIT_SEARCH_MAX_DURATION_PER_RUN;
+
+cleanup:
+    if (result != AUDIT_SEARCH_OK) {
+        AuditSearch_Deinit(auditSearch);
+    }
+    return result;
+}
+
+static AuditSearchResultValues AuditSearch_InitParser(AuditSearch* auditSearch, ausource_t source, const char* buffer) {
+    auditSearch->audit = auparse_init(source, buffer);
     if (auditSearch->audit == NULL) {
         Logger_Warning("Can not initiate auparse.");
-        result = AUDIT_SEARCH_EXCEPTION;
-        goto cleanup;
+        return AUDIT_SEARCH_EXCEPTION;
     }
 
     /*
@@ -69,7 +200,8 @@ AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* audi
      * the sub expressions (by the order of addition) and then the final op.
      * So basically we will get ((type1 || type2) || type3) && timestamp
      */
-    for (uint32_t i = 0; i < messageTypesCount; ++i) {
+    for (uint32_t i = 0; i < auditSearch->messageTypesCount; ++i) {
+        const char* messageType = auditSearch->messageTypes[i];
         ausearch_rule_t currentRule = AUSEARCH_RULE_OR;
         if (i == 0) {
             currentRule = AUSEARCH_RULE_CLEAR;
@@ -78,51 +210,37 @@ AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* audi
         * We want to monitor only local login operations but auditd "USER_AUTH" type includes sudo commands too.
         * The following expression makes sure to include only login operations and ignore sudo commands.
         */
-        if (searchCriteria == AUDIT_SEARCH_CRITERIA_TYPE && strcmp(messageTypes[i], AUDIT_USER_AUTH_NAME) == 0) {
+        if (auditSearch->searchCriteria == AUDIT_SEARCH_CRITERIA_TYPE && strcmp(messageType, AUDIT_USER_AUTH_NAME) == 0) {
             char *error = NULL;
             const char *expression = AUDIT_USER_AUTH_SEARECH_RULE;
             if (ausearch_add_expression(auditSearch->audit, expression, &error, currentRule) == -1) {
-                result = AUDIT_SEARCH_EXCEPTION;
-                goto cleanup;
+                return AUDIT_SEARCH_EXCEPTION;
             }
-        } else if (searchCriteria == AUDIT_SEARCH_CRITERIA_SYSCALL) {
+        } else if (auditSearch->searchCriteria == AUDIT_SEARCH_CRITERIA_SYSCALL) {
             // Compare syscalls only by name, to avoid syscall number arch differences 
-            if (ausearch_add_interpreted_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(searchCriteria), "=", messageTypes[i], currentRule) == -1) {
-                result = AUDIT_SEARCH_EXCEPTION;
-                goto cleanup;
+            if (ausearch_add_interpreted_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(auditSearch->searchCriteria), "=", messageType, currentRule) == -1) {
+                return AUDIT_SEARCH_EXCEPTION;
             }
         } else {
-            if (ausearch_add_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(searchCriteria), "=", messageTypes[i], currentRule) == -1) {
-                result = AUDIT_SEARCH_EXCEPTION;
-                goto cleanup;
+            if (ausearch_add_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(auditSearch->searchCriteria), "=", messageType, currentRule) == -1) {
+                return AUDIT_SEARCH_EXCEPTION;
             }
         }
     }
-    
-    if (checkpointFile != NULL){
-        if (!(Utils_CreateStringCopy(&auditSearch->checkpointFile, checkpointFile))) {
-            result = AUDIT_SEARCH_EXCEPTION;
-            goto cleanup;
-        }
 
-        if (AuditSearch_AddCheckpointToSearch(auditSearch) != AUDIT_SEARCH_OK) {
-            result = AUDIT_SEARCH_EXCEPTION;
-            goto cleanup;
+    // the events of the checkpoint's millisecond are matched again, the ones which were already consumed are skipped
+    if (auditSearch->hasCheckpoint) {
+        AuditSearchCheckpoint* checkpoint = &auditSearch->checkpoint;
+        if (ausearch_add_timestamp_item(auditSearch->audit, ">=", checkpoint->sec, checkpoint->milli, AUSEARCH_RULE_AND) == -1) {
+            return AUDIT_SEARCH_EXCEPTION;
         }
     }
 
     if (ausearch_set_stop(auditSearch->audit, AUSEARCH_STOP_EVENT) == -1) {
-        result = AUDIT_SEARCH_EXCEPTION;
-        goto cleanup;
+        return AUDIT_SEARCH_EXCEPTION;
     }
-  
-    auditSearch->searchTime = TimeUtils_GetCurrentTime();
 
-cleanup:
-    if (result != AUDIT_SEARCH_OK) {
-        AuditSearch_Deinit(auditSearch);
-    }
-    return result;
+    return AUDIT_SEARCH_OK;
 }
 
 void AuditSearch_Deinit(AuditSearch* auditSearch) {
@@ -136,18 +254,37 @@ void AuditSearch_Deinit(AuditSearch* auditSearch) {
         auditSearch->audit = NULL;
     }
 
+    if (auditSearch->streamEvents != NULL) {
+        AuditStream_FreeEvents(auditSearch->streamEvents);
+        auditSearch->streamEvents = NULL;
+    }
+
+    if (auditSearch->readsLog) {
+        AuditLog_Close(&auditSearch->log);
+        auditSearch->readsLog = false;
+    }
+
+    if (auditSearch->messageTypes != NULL) {
+        free(auditSearch->messageTypes);
+        auditSearch->messageTypes = NULL;
+    }
+
     if (!ProcessInfoHandler_Reset(&auditSearch->processInfo)) {
         Logger_Warning("Can not set privileges back to user.");
     }
 }
 
-AuditSearchResultValues AuditSearch_AddCheckpointToSearch(AuditSearch* auditSearch) {
-    time_t timeval;
-    FileResults result = FileUtils_ReadFile(auditSearch->checkpointFile, &timeval, sizeof(timeval), false);
+static AuditSearchResultValues AuditSearch_ReadCheckpoint(AuditSearch* auditSearch) {
+    AuditSearchCheckpoint* checkpoint = &auditSearch->checkpoint;
+    FileResults result = FileUtils_ReadFile(auditSearch->checkpointFile, checkpoint, sizeof(*checkpoint), false);
+    if (result == FILE_UTILS_SIZE_MISMATCH) {
+        // the checkpoint of an older agent holds only the time of its search or its last event, the rest of the checkpoint stays zeroed
+        result = FILE_UTILS_OK;
+    }
+
     if (result == FILE_UTILS_OK) {
-        if (ausearch_add_timestamp_item(auditSearch->audit, ">", timeval, 0, AUSEARCH_RULE_AND) == -1) {
-            return AUDIT_SEARCH_EXCEPTION;
-        } 
+        auditSearch->hasCheckpoint = true;
+        auditSearch->position = checkpoint->position;
     } else if (result == FILE_UTILS_ERROR ) {
         return AUDIT_SEARCH_EXCEPTION;
     }
@@ -155,37 +292,140 @@ AuditSearchResultValues AuditSearch_AddCheckpointToSearch(AuditSearch* auditSear
 }
 
 AuditSearchResultValues AuditSearch_GetNext(AuditSearch* auditSearch) {
-    int result = 0;
+    // a large audit log is not read to its end once the collector ran out of its budget
+    if (CollectorExecution_IsCanceled()) {
+        return AUDIT_SEARCH_CANCELED;
+    }
 
-    if (!auditSearch->firstSearch) {
-        result = auparse_next_event(auditSearch->audit);
-        if (result == -1) {
+    if (auditSearch->finished) {
+        return AUDIT_SEARCH_NO_MORE_DATA;
+    }
+
+    // the cost of a run is bounded, the next run resumes right after the last event of this one
+    if (auditSearch->eventsRead >= AUDIT_SEARCH_MAX_EVENTS_PER_RUN || AuditSearch_GetTime() >= auditSearch->deadline) {
+        Logger_Information("The audit search read %u events, the rest of the log is read on the next run.", auditSearch->eventsRead);
+        return AUDIT_SEARCH_NO_MORE_DATA;
+    }
+
+    const au_event_t* event = NULL;
+    do {
+        AuditSearchResultValues result = AuditSearch_NextEvent(auditSearch);
+        if (result != AUDIT_SEARCH_HAS_MORE_DATA) {
+            return result;
+        }
+
+        event = auparse_get_timestamp(auditSearch->audit);
+        if (event == NULL) {
             return AUDIT_SEARCH_EXCEPTION;
         }
+    } while (auditSearch->hasCheckpoint && AuditSearch_IsConsumed(&auditSearch->checkpoint, event));
+
+    auditSearch->lastEvent.sec = event->sec;
+    auditSearch->lastEvent.milli = event->milli;
+    auditSearch->lastEvent.serial = event->serial;
+    ++auditSearch->eventsRead;
+    return AUDIT_SEARCH_HAS_MORE_DATA;
+}
+
+static AuditSearchResultValues AuditSearch_NextEvent(AuditSearch* auditSearch) {
+    int result = 0;
+
+    while (true) {
+        if (!auditSearch->firstSearch) {
+            result = auparse_next_event(auditSearch->audit);
+            if (result == -1) {
+                return AUDIT_SEARCH_EXCEPTION;
+            }
+        }
+
+        if (auditSearch->firstSearch || result != 0) {
+            auditSearch->firstSearch = false;
+            result = ausearch_next_event(auditSearch->audit);
+            if (result == -1) {
+                return AUDIT_SEARCH_EXCEPTION;
+            }
+
+            if (result != 0) {
+                return AUDIT_SEARCH_HAS_MORE_DATA;
+            }
+        }
 
-        if (result == 0) {
+        if (!auditSearch->readsLog) {
+            auditSearch->finished = true;
+            if (auditSearch->logEnd.inode != 0) {
+                auditSearch->position = auditSearch->logEnd;
+            }
             return AUDIT_SEARCH_NO_MORE_DATA;
         }
+
+        AuditSearchResultValues chunkResult = AuditSearch_NextChunk(auditSearch);
+        if (chunkResult != AUDIT_SEARCH_HAS_MORE_DATA) {
+            return chunkResult;
+        }
     }
+}
 
-    auditSearch->firstSearch = false;
-    result = ausearch_next_event(auditSearch->audit);
-    if (result == -1) {
-        return AUDIT_SEARCH_EXCEPTION;
+static AuditSearchResultValues AuditSearch_NextChunk(AuditSearch* auditSearch) {
+    auparse_destroy(auditSearch->audit);
+    auditSearch->audit = NULL;
+    // the chunk was read to its end, so all of its events were consumed
+    auditSearch->position = auditSearch->log.position;
+
+    // a chunk without matching events returns no event, so the time is checked between chunks too
+    if (AuditSearch_GetTime() >= auditSearch->deadline) {
+        return AUDIT_SEARCH_NO_MORE_DATA;
     }
 
-    if (result == 0) {
+    const char* chunk = NULL;
+    AuditLogResult result = AuditLog_ReadChunk(&auditSearch->log, &chunk);
+    if (result == AUDIT_LOG_END) {
+        auditSearch->finished = true;
+        auditSearch->position = auditSearch->log.position;
         return AUDIT_SEARCH_NO_MORE_DATA;
+    } else if (result != AUDIT_LOG_OK) {
+        return AUDIT_SEARCH_EXCEPTION;
     }
 
+    if (AuditSearch_InitParser(auditSearch, AUSOURCE_BUFFER, chunk) != AUDIT_SEARCH_OK) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+    auditSearch->firstSearch = true;
     return AUDIT_SEARCH_HAS_MORE_DATA;
 }
 
+static bool AuditSearch_IsConsumed(const AuditSearchCheckpoint* checkpoint, const au_event_t* event) {
+    if (event->sec != checkpoint->sec) {
+        return event->sec < checkpoint->sec;
+    }
+
+    if (event->milli != checkpoint->milli) {
+        return event->milli < checkpoint->milli;
+    }
+
+    return event->serial <= checkpoint->serial;
+}
+
 AuditSearchResultValues AuditSearch_SetCheckpoint(AuditSearch* auditSearch) {
-    if (FileUtils_WriteToFile(auditSearch->checkpointFile, &auditSearch->searchTime, sizeof(auditSearch->searchTime)) != FILE_UTILS_OK) {
+    AuditSearchCheckpoint checkpoint = auditSearch->checkpoint;
+    if (auditSearch->eventsRead > 0) {
+        checkpoint = auditSearch->lastEvent;
+    } else if (!auditSearch->hasCheckpoint) {
+        // nothing was read, so the next search starts from the time of this one
+        memset(&checkpoint, 0, sizeof(checkpoint));
+        checkpoint.sec = auditSearch->searchTime;
+    }
+    checkpoint.position = auditSearch->position;
+
+    if (FileUtils_WriteToFile(auditSearch->checkpointFile, &checkpoint, sizeof(checkpoint)) != FILE_UTILS_OK) {
         return AUDIT_SEARCH_EXCEPTION; 
     }
 
+    // the stream serves the next search only if this one read all of its events
+    CollectorId collectorId;
+    if (auditSearch->streamSubscribed && CollectorExecution_GetCurrent(&collectorId)) {
+        AuditStream_ReportSearchEnd(collectorId, auditSearch->finished);
+    }
+
     return AUDIT_SEARCH_OK;
 }
 
@@ -262,4 +502,10 @@ const char* AuditSearch_ConvertCriteriaToString(AuditSearchCriteria searchCriter
         case AUDIT_SEARCH_CRITERIA_SYSCALL: return (const char*) AUDIT_SEARCH_CRITERIA_SYSCALL_NAME;
         default: return (const char*) AUDIT_SEARCH_CRITERIA_TYPE_NAME;
     }
+}
+
+static uint64_t AuditSearch_GetTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
 }
\ No newline at end of file
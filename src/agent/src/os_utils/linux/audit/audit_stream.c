@@ -0,0 +1,612 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "os_utils/linux/audit/audit_stream.h"
+
+#include <auparse.h>
+#include <errno.h>
+#include <libaudit.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "azure_c_shared_utility/lock.h"
+#include "consts.h"
+#include "logger.h"
+#include "os_utils/process_info_handler.h"
+#include "tracked_allocator.h"
+#include "utils.h"
+
+// the number of reads on a single wake up, so a busy stream does not hold the event loop
+#define AUDIT_STREAM_MAX_READS 16
+#define AUDIT_STREAM_READ_SIZE 4096
+
+static const char AUDIT_STREAM_ARCH_FIELD[] = "arch";
+static const char AUDIT_STREAM_SYSCALL_FIELD[] = "syscall";
+
+/**
+ * The events which were buffered for a single collector.
+ */
+typedef struct _AuditStreamChannel {
+
+    bool subscribed;
+    // the events are kept for the next search of the collector, from the time it took its events and as long as none was dropped
+    bool buffering;
+    // the previous search of the collector read all of its events, so the buffer holds every event which is after its checkpoint
+    bool caughtUp;
+    AuditSearchCriteria searchCriteria;
+    // copied, the types of the search may not outlive it
+    char** messageTypes;
+    uint32_t messageTypesCount;
+    // the text of the events, terminated
+    char* events;
+    uint32_t size;
+    uint32_t capacity;
+
+} AuditStreamChannel;
+
+typedef struct _AuditStream {
+
+    // guards the channels and the connection state, which the collectors read from the threads of their worker pool.
+    // the rest of the stream is used on the thread of the event loop only
+    LOCK_HANDLE lock;
+    bool connected;
+    // watched by the event loop, it holds the reconnect timer, and the socket while the stream is connected
+    int epollFd;
+    int timerFd;
+    int socketFd;
+    auparse_state_t* parser;
+    AuditStreamListener listener;
+    void* listenerContext;
+    // the collectors which received events on the current wake up, they are notified once the lock is released
+    bool received[COLLECTOR_COUNT];
+    AuditStreamChannel channels[COLLECTOR_COUNT];
+
+} AuditStream;
+
+static AuditStream stream = { .lock = NULL, .epollFd = -1, .timerFd = -1, .socketFd = -1 };
+
+/**
+ * @brief Connects to the socket of the audispd plugin, called by the reconnect timer while the stream is disconnected.
+ */
+static void AuditStream_Connect();
+
+/**
+ * @brief Closes the socket and drops the buffered events, the collectors search the logs until they catch up again.
+ */
+static void AuditStream_Disconnect();
+
+/**
+ * @brief Reads the available data of the socket and feeds it to the parser, and notifies the collectors which received events.
+ */
+static void AuditStream_Read();
+
+/**
+ * @brief Called by the parser for each complete event, buffers the event for every collector which searches for it.
+ *
+ * @param   parser      The parser.
+ * @param   eventType   The type of the callback.
+ * @param   userData    Unused.
+ */
+static void AuditStream_OnEvent(auparse_state_t* parser, auparse_cb_event_t eventType, void* userData);
+
+/**
+ * @brief Checks whether the current event of the parser matches the search criteria of the channel.
+ *
+ * @param   channel     The channel.
+ * @param   parser      The parser.
+ *
+ * @return true if the collector of the channel searches for the event.
+ */
+static bool AuditStream_IsMatch(AuditStreamChannel* channel, auparse_state_t* parser);
+
+/**
+ * @brief Returns the name of the syscall of the current event of the parser, from the syscall tables of libaudit.
+ *        The field is not interpreted by auparse, whose interpretation caches are shared with the searches which run on the collector threads.
+ *
+ * @param   parser      The parser, positioned on the first record of the event.
+ *
+ * @return the name of the syscall, or NULL if the event has no syscall.
+ */
+static const char* AuditStream_GetSyscallName(auparse_state_t* parser);
+
+/**
+ * @brief Checks whether the given type is one of the types of the channel.
+ *
+ * @param   channel     The channel.
+ * @param   type        The type, may be NULL.
+ *
+ * @return true if the channel searches for the type.
+ */
+static bool AuditStream_IsMessageType(AuditStreamChannel* channel, const char* type);
+
+/**
+ * @brief Appends the records of the current event of the parser to the buffer of the channel, one record per line.
+ *
+ * @param   channel     The channel.
+ * @param   parser      The parser.
+ *
+ * @return true on success, false if the buffer is full or the event could not be read.
+ */
+static bool AuditStream_Append(AuditStreamChannel* channel, auparse_state_t* parser);
+
+/**
+ * @brief Makes room in the buffer of the channel for the given size and its terminator.
+ *
+ * @param   channel     The channel.
+ * @param   size        The size to append.
+ *
+ * @return true on success, false if the buffer may not grow any more.
+ */
+static bool AuditStream_Reserve(AuditStreamChannel* channel, uint32_t size);
+
+/**
+ * @brief Subscribes the collector of the channel to the stream with a copy of its search criteria.
+ *
+ * @param   channel             The channel.
+ * @param   searchCriteria      The search criteria of the collector.
+ * @param   messageTypes        The types the collector searches for.
+ * @param   messageTypesCount   Number of elements in the messageTypes array.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool AuditStream_Subscribe(AuditStreamChannel* channel, AuditSearchCriteria searchCriteria, const char** messageTypes, uint32_t messageTypesCount);
+
+/**
+ * @brief Unsubscribes the collector of the channel and frees its search criteria.
+ *
+ * @param   channel     The channel.
+ */
+static void AuditStream_Unsubscribe(AuditStreamChannel* channel);
+
+/**
+ * @brief Drops the buffered events of the channel.
+ *
+ * @param   channel     The channel.
+ */
+static void AuditStream_DropEvents(AuditStreamChannel* channel);
+
+bool AuditStream_Init(AuditStreamListener listener, void* context) {
+    memset(&stream, 0, sizeof(stream));
+    stream.epollFd = -1;
+    stream.timerFd = -1;
+    stream.socketFd = -1;
+    stream.listener = listener;
+    stream.listenerContext = context;
+
+    stream.lock = Lock_Init();
+    if (stream.lock == NULL) {
+        return false;
+    }
+
+    stream.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (stream.epollFd < 0) {
+        Logger_Error("Could not create the epoll instance of the audit stream, errno=%d", errno);
+        goto cleanup;
+    }
+
+    stream.timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (stream.timerFd < 0) {
+        Logger_Error("Could not create the reconnect timer of the audit stream, errno=%d", errno);
+        goto cleanup;
+    }
+
+    // the first attempt to connect is right away
+    struct itimerspec spec = {
+        .it_interval = { .tv_sec = AUDIT_STREAM_RECONNECT_INTERVAL / 1000, .tv_nsec = (long)(AUDIT_STREAM_RECONNECT_INTERVAL % 1000) * 1000000 },
+        .it_value = { .tv_sec = 0, .tv_nsec = 1 }
+    };
+    if (timerfd_settime(stream.timerFd, 0, &spec, NULL) != 0) {
+        Logger_Error("Could not arm the reconnect timer of the audit stream, errno=%d", errno);
+        goto cleanup;
+    }
+
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = stream.timerFd };
+    if (epoll_ctl(stream.epollFd, EPOLL_CTL_ADD, stream.timerFd, &event) != 0) {
+        Logger_Error("Could not watch the reconnect timer of the audit stream, errno=%d", errno);
+        goto cleanup;
+    }
+
+    return true;
+
+cleanup:
+    AuditStream_Deinit();
+    return false;
+}
+
+void AuditStream_Deinit() {
+    if (stream.lock != NULL) {
+        AuditStream_Disconnect();
+        for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+            AuditStream_DropEvents(&stream.channels[id]);
+            AuditStream_Unsubscribe(&stream.channels[id]);
+        }
+        Lock_Deinit(stream.lock);
+    }
+
+    if (stream.timerFd >= 0) {
+        close(stream.timerFd);
+    }
+
+    if (stream.epollFd >= 0) {
+        close(stream.epollFd);
+    }
+
+    memset(&stream, 0, sizeof(stream));
+    stream.epollFd = -1;
+    stream.timerFd = -1;
+    stream.socketFd = -1;
+}
+
+int AuditStream_GetFd() {
+    return stream.epollFd;
+}
+
+void AuditStream_OnReadable(void* context) {
+    struct epoll_event events[2];
+    int count = epoll_wait(stream.epollFd, events, 2, 0);
+
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.fd == stream.timerFd) {
+            uint64_t expirations = 0;
+            if (read(stream.timerFd, &expirations, sizeof(expirations)) == sizeof(expirations) && stream.socketFd < 0) {
+                AuditStream_Connect();
+            }
+        } else if (events[i].data.fd == stream.socketFd) {
+            AuditStream_Read();
+        }
+    }
+}
+
+AuditStreamResult AuditStream_TakeEvents(CollectorId id, AuditSearchCriteria searchCriteria, const char** messageTypes, uint32_t messageTypesCount, char** events) {
+    *events = NULL;
+    if (stream.lock == NULL || Lock(stream.lock) != LOCK_OK) {
+        return AUDIT_STREAM_UNAVAILABLE;
+    }
+
+    AuditStreamResult result = AUDIT_STREAM_UNAVAILABLE;
+    AuditStreamChannel* channel = &stream.channels[id];
+    if (!stream.connected) {
+        goto cleanup;
+    }
+
+    if (!channel->subscribed && !AuditStream_Subscribe(channel, searchCriteria, messageTypes, messageTypesCount)) {
+        goto cleanup;
+    }
+
+    if (!channel->caughtUp) {
+        // the logs hold these events too
+        AuditStream_DropEvents(channel);
+        result = AUDIT_STREAM_CATCH_UP;
+    } else if (channel->size == 0) {
+        result = AUDIT_STREAM_NO_EVENTS;
+    } else {
+        *events = channel->events;
+        channel->events = NULL;
+        channel->size = 0;
+        channel->capacity = 0;
+        result = AUDIT_STREAM_EVENTS;
+    }
+
+    // the events which arrive while the collector searches are left to its next search
+    channel->buffering = true;
+
+cleanup:
+    Unlock(stream.lock);
+    return result;
+}
+
+void AuditStream_FreeEvents(char* events) {
+    TrackedAllocator_Free(ALLOCATION_TAG_AUDIT_STREAM, events);
+}
+
+void AuditStream_ReportSearchEnd(CollectorId id, bool finished) {
+    if (stream.lock == NULL || Lock(stream.lock) != LOCK_OK) {
+        return;
+    }
+
+    AuditStreamChannel* channel = &stream.channels[id];
+    channel->caughtUp = channel->buffering && finished;
+    if (!channel->caughtUp) {
+        // the next search reads the logs, which hold the buffered events too
+        Logger_Debug("The %s collector is not caught up with the audit stream, its next search reads the logs", CollectorExecution_GetName(id));
+        AuditStream_DropEvents(channel);
+        channel->buffering = false;
+    }
+
+    Unlock(stream.lock);
+}
+
+static void AuditStream_Connect() {
+    ProcessInfo processInfo;
+    bool connected = false;
+    int fd = -1;
+    int connectError = 0;
+
+    // the socket of the plugin is accessible to root only
+    if (ProcessInfoHandler_ChangeToRoot(&processInfo)) {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd >= 0) {
+            struct sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            strncpy(address.sun_path, AUDIT_STREAM_SOCKET_PATH, sizeof(address.sun_path) - 1);
+            connected = connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0;
+        }
+        connectError = errno;
+    }
+
+    if (!ProcessInfoHandler_Reset(&processInfo)) {
+        Logger_Warning("Can not set privileges back to user.");
+    }
+
+    if (!connected) {
+        // the plugin of audispd may be disabled, the collectors keep searching the logs
+        Logger_Debug("Could not connect to the audit stream at %s, errno=%d", AUDIT_STREAM_SOCKET_PATH, connectError);
+        goto cleanup;
+    }
+
+    stream.parser = auparse_init(AUSOURCE_FEED, NULL);
+    if (stream.parser == NULL) {
+        Logger_Error("Could not initiate the parser of the audit stream");
+        connected = false;
+        goto cleanup;
+    }
+    auparse_add_callback(stream.parser, AuditStream_OnEvent, NULL, NULL);
+
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = fd };
+    if (epoll_ctl(stream.epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        Logger_Error("Could not watch the socket of the audit stream, errno=%d", errno);
+        connected = false;
+        goto cleanup;
+    }
+
+    if (Lock(stream.lock) != LOCK_OK) {
+        epoll_ctl(stream.epollFd, EPOLL_CTL_DEL, fd, NULL);
+        connected = false;
+        goto cleanup;
+    }
+    stream.socketFd = fd;
+    stream.connected = true;
+    Unlock(stream.lock);
+
+    Logger_Information("Connected to the audit stream, the audit events are collected as they are logged");
+
+cleanup:
+    if (!connected) {
+        if (stream.parser != NULL) {
+            auparse_destroy(stream.parser);
+            stream.parser = NULL;
+        }
+
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+static void AuditStream_Disconnect() {
+    if (stream.socketFd < 0) {
+        return;
+    }
+
+    if (Lock(stream.lock) == LOCK_OK) {
+        stream.connected = false;
+        for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+            AuditStreamChannel* channel = &stream.channels[id];
+            AuditStream_DropEvents(channel);
+            channel->buffering = false;
+            channel->caughtUp = false;
+        }
+        Unlock(stream.lock);
+    }
+
+    epoll_ctl(stream.epollFd, EPOLL_CTL_DEL, stream.socketFd, NULL);
+    close(stream.socketFd);
+    stream.socketFd = -1;
+
+    auparse_destroy(stream.parser);
+    stream.parser = NULL;
+}
+
+static void AuditStream_Read() {
+    char buffer[AUDIT_STREAM_READ_SIZE];
+
+    for (uint32_t i = 0; i < AUDIT_STREAM_MAX_READS && stream.socketFd >= 0; ++i) {
+        ssize_t bytesRead = read(stream.socketFd, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            if (auparse_feed(stream.parser, buffer, (size_t)bytesRead) != 0) {
+                Logger_Error("Could not parse the audit stream, the audit logs are searched until it reconnects");
+                AuditStream_Disconnect();
+            }
+            continue;
+        }
+
+        if (bytesRead == -1 && errno == EINTR) {
+            continue;
+        } else if (bytesRead == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+
+        // audispd closes the socket when auditd restarts
+        Logger_Warning("The audit stream was disconnected, the audit logs are searched until it reconnects");
+        AuditStream_Disconnect();
+    }
+
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        if (stream.received[id]) {
+            stream.received[id] = false;
+            stream.listener(stream.listenerContext, (CollectorId)id);
+        }
+    }
+}
+
+static void AuditStream_OnEvent(auparse_state_t* parser, auparse_cb_event_t eventType, void* userData) {
+    if (eventType != AUPARSE_CB_EVENT_READY || Lock(stream.lock) != LOCK_OK) {
+        return;
+    }
+
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        AuditStreamChannel* channel = &stream.channels[id];
+        if (!channel->buffering || !AuditStream_IsMatch(channel, parser)) {
+            continue;
+        }
+
+        if (AuditStream_Append(channel, parser)) {
+            stream.received[id] = true;
+        } else {
+            Logger_Warning("The audit stream dropped the events of the %s collector, its next search reads the logs", CollectorExecution_GetName((CollectorId)id));
+            AuditStream_DropEvents(channel);
+            channel->buffering = false;
+            channel->caughtUp = false;
+        }
+    }
+
+    Unlock(stream.lock);
+}
+
+static bool AuditStream_IsMatch(AuditStreamChannel* channel, auparse_state_t* parser) {
+    if (auparse_first_record(parser) != 1) {
+        return false;
+    }
+
+    if (channel->searchCriteria == AUDIT_SEARCH_CRITERIA_SYSCALL) {
+        // syscalls are compared by name, as the search compares them
+        return AuditStream_IsMessageType(channel, AuditStream_GetSyscallName(parser));
+    }
+
+    do {
+        if (AuditStream_IsMessageType(channel, auparse_get_type_name(parser))) {
+            return true;
+        }
+    } while (auparse_next_record(parser) == 1);
+
+    return false;
+}
+
+static const char* AuditStream_GetSyscallName(auparse_state_t* parser) {
+    // the arch field comes before the syscall field in the record
+    if (auparse_find_field(parser, AUDIT_STREAM_ARCH_FIELD) == NULL) {
+        return NULL;
+    }
+
+    const char* arch = auparse_get_field_str(parser);
+    int machine = arch != NULL ? audit_elf_to_machine((unsigned int)strtoul(arch, NULL, 16)) : -1;
+    if (machine < 0 || auparse_find_field(parser, AUDIT_STREAM_SYSCALL_FIELD) == NULL) {
+        return NULL;
+    }
+
+    return audit_syscall_to_name(auparse_get_field_int(parser), machine);
+}
+
+static bool AuditStream_IsMessageType(AuditStreamChannel* channel, const char* type) {
+    if (type == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < channel->messageTypesCount; ++i) {
+        if (strcmp(channel->messageTypes[i], type) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool AuditStream_Append(AuditStreamChannel* channel, auparse_state_t* parser) {
+    if (auparse_first_record(parser) != 1) {
+        return false;
+    }
+
+    do {
+        const char* record = auparse_get_record_text(parser);
+        if (record == NULL) {
+            return false;
+        }
+
+        uint32_t length = (uint32_t)strlen(record);
+        if (!AuditStream_Reserve(channel, length + 1)) {
+            return false;
+        }
+        memcpy(channel->events + channel->size, record, length);
+        channel->size += length;
+        channel->events[channel->size++] = '\n';
+        channel->events[channel->size] = '\0';
+    } while (auparse_next_record(parser) == 1);
+
+    return true;
+}
+
+static bool AuditStream_Reserve(AuditStreamChannel* channel, uint32_t size) {
+    uint32_t required = channel->size + size + 1;
+    if (required <= channel->capacity) {
+        return true;
+    }
+
+    if (required > AUDIT_STREAM_MAX_BUFFER_SIZE) {
+        return false;
+    }
+
+    uint32_t capacity = channel->capacity > 0 ? channel->capacity : AUDIT_STREAM_READ_SIZE;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    if (capacity > AUDIT_STREAM_MAX_BUFFER_SIZE) {
+        capacity = AUDIT_STREAM_MAX_BUFFER_SIZE;
+    }
+
+    char* events = TrackedAllocator_Malloc(ALLOCATION_TAG_AUDIT_STREAM, capacity);
+    if (events == NULL) {
+        return false;
+    }
+
+    if (channel->events != NULL) {
+        memcpy(events, channel->events, channel->size + 1);
+        TrackedAllocator_Free(ALLOCATION_TAG_AUDIT_STREAM, channel->events);
+    }
+    channel->events = events;
+    channel->capacity = capacity;
+    return true;
+}
+
+static bool AuditStream_Subscribe(AuditStreamChannel* channel, AuditSearchCriteria searchCriteria, const char** messageTypes, uint32_t messageTypesCount) {
+    channel->messageTypes = calloc(messageTypesCount, sizeof(char*));
+    if (channel->messageTypes == NULL) {
+        return false;
+    }
+
+    channel->searchCriteria = searchCriteria;
+    channel->messageTypesCount = messageTypesCount;
+    for (uint32_t i = 0; i < messageTypesCount; ++i) {
+        if (!Utils_CreateStringCopy(&channel->messageTypes[i], messageTypes[i])) {
+            AuditStream_Unsubscribe(channel);
+            return false;
+        }
+    }
+
+    channel->subscribed = true;
+    return true;
+}
+
+static void AuditStream_Unsubscribe(AuditStreamChannel* channel) {
+    if (channel->messageTypes != NULL) {
+        for (uint32_t i = 0; i < channel->messageTypesCount; ++i) {
+            free(channel->messageTypes[i]);
+        }
+        free(channel->messageTypes);
+    }
+
+    channel->messageTypes = NULL;
+    channel->messageTypesCount = 0;
+    channel->subscribed = false;
+}
+
+static void AuditStream_DropEvents(AuditStreamChannel* channel) {
+    TrackedAllocator_Free(ALLOCATION_TAG_AUDIT_STREAM, channel->events);
+    channel->events = NULL;
+    channel->size = 0;
+    channel->capacity = 0;
+}
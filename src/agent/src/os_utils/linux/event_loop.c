@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "os_utils/event_loop.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "logger.h"
+
+/**
+ * @brief Adds the given source to the loop and registers it with epoll.
+ *
+ * @param   loop        The loop.
+ * @param   fd          The file descriptor of the source.
+ * @param   isTimer     Whether the source is a timer of the loop.
+ * @param   handler     The handler of the source.
+ * @param   context     The context of the handler.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool EventLoop_AddSource(EventLoop* loop, int fd, bool isTimer, EventLoopHandler handler, void* context);
+
+/**
+ * @brief Calls the handler of the given source, after reading the expirations if it is a timer.
+ *
+ * @param   source  The source which is ready.
+ */
+static void EventLoop_Dispatch(EventLoopSource* source);
+
+bool EventLoop_Init(EventLoop* loop) {
+    memset(loop, 0, sizeof(*loop));
+    loop->stopFd = -1;
+
+    loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epollFd < 0) {
+        Logger_Error("Could not create the epoll instance of the event loop, errno=%d", errno);
+        return false;
+    }
+
+    loop->stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (loop->stopFd < 0) {
+        Logger_Error("Could not create the stop event of the event loop, errno=%d", errno);
+        goto cleanup;
+    }
+
+    // the stop is the only source without a source entry
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = NULL };
+    if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->stopFd, &event) != 0) {
+        Logger_Error("Could not watch the stop event of the event loop, errno=%d", errno);
+        goto cleanup;
+    }
+
+    return true;
+
+cleanup:
+    EventLoop_Deinit(loop);
+    return false;
+}
+
+void EventLoop_Deinit(EventLoop* loop) {
+    for (uint32_t i = 0; i < loop->numberOfSources; ++i) {
+        if (loop->sources[i].isTimer) {
+            close(loop->sources[i].fd);
+        }
+    }
+
+    if (loop->stopFd >= 0) {
+        close(loop->stopFd);
+    }
+
+    if (loop->epollFd >= 0) {
+        close(loop->epollFd);
+    }
+
+    memset(loop, 0, sizeof(*loop));
+    loop->epollFd = -1;
+    loop->stopFd = -1;
+}
+
+bool EventLoop_AddTimer(EventLoop* loop, uint32_t interval, EventLoopHandler handler, void* context) {
+    if (interval == 0) {
+        return false;
+    }
+
+    int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (timerFd < 0) {
+        Logger_Error("Could not create a timer, errno=%d", errno);
+        return false;
+    }
+
+    // a zero value disarms the timer, so the first expiration is right away
+    struct itimerspec spec = {
+        .it_interval = { .tv_sec = interval / 1000, .tv_nsec = (long)(interval % 1000) * 1000000 },
+        .it_value = { .tv_sec = 0, .tv_nsec = 1 }
+    };
+    if (timerfd_settime(timerFd, 0, &spec, NULL) != 0) {
+        Logger_Error("Could not arm a timer, errno=%d", errno);
+        close(timerFd);
+        return false;
+    }
+
+    if (!EventLoop_AddSource(loop, timerFd, true, handler, context)) {
+        close(timerFd);
+        return false;
+    }
+
+    return true;
+}
+
+bool EventLoop_AddFd(EventLoop* loop, int fd, EventLoopHandler handler, void* context) {
+    return EventLoop_AddSource(loop, fd, false, handler, context);
+}
+
+static bool EventLoop_AddSource(EventLoop* loop, int fd, bool isTimer, EventLoopHandler handler, void* context) {
+    if (loop->numberOfSources == EVENT_LOOP_MAX_SOURCES) {
+        Logger_Error("The event loop handles at most %d sources", EVENT_LOOP_MAX_SOURCES);
+        return false;
+    }
+
+    EventLoopSource* source = &loop->sources[loop->numberOfSources];
+    source->fd = fd;
+    source->isTimer = isTimer;
+    source->handler = handler;
+    source->context = context;
+
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = source };
+    if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        Logger_Error("Could not watch a source of the event loop, errno=%d", errno);
+        memset(source, 0, sizeof(*source));
+        return false;
+    }
+
+    ++loop->numberOfSources;
+    return true;
+}
+
+bool EventLoop_Run(EventLoop* loop) {
+    struct epoll_event events[EVENT_LOOP_MAX_SOURCES + 1];
+
+    while (true) {
+        int count = epoll_wait(loop->epollFd, events, EVENT_LOOP_MAX_SOURCES + 1, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger_Error("Waiting on the event loop failed, errno=%d", errno);
+            return false;
+        }
+
+        // the stop takes precedence over the sources which became ready with it
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.ptr == NULL) {
+                return true;
+            }
+        }
+
+        for (int i = 0; i < count; ++i) {
+            EventLoop_Dispatch((EventLoopSource*)events[i].data.ptr);
+        }
+    }
+}
+
+static void EventLoop_Dispatch(EventLoopSource* source) {
+    if (source->isTimer) {
+        uint64_t expirations = 0;
+        if (read(source->fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            // another wake up consumed the expiration
+            return;
+        }
+        if (expirations > 1) {
+            Logger_Debug("%llu timer expirations were coalesced", (unsigned long long)expirations);
+        }
+    }
+
+    Logger_SetCorrelation();
+    source->handler(source->context);
+}
+
+void EventLoop_Stop(EventLoop* loop) {
+    uint64_t signal = 1;
+    if (write(loop->stopFd, &signal, sizeof(signal)) != sizeof(signal)) {
+        Logger_Error("Could not stop the event loop, errno=%d", errno);
+    }
+}
@@ -6,6 +6,7 @@
 #include <errno.h>
 #include <stdlib.h>
 
+#include "collectors/collector_execution.h"
 #include "os_utils/linux/iptables/iptables_rules_iterator.h"
 #include "os_utils/linux/iptables/iptables_utils.h"
 #include "utils.h"
@@ -53,6 +54,10 @@ void IptablesIterator_Deinit(IptablesIteratorHandle iterator) {
 
 IptablesResults IptablesIterator_GetNext(IptablesIteratorHandle iterator) {
     IptablesIterator* iteratorObj = (IptablesIterator*)iterator;
+    if (CollectorExecution_IsCanceled()) {
+        return IPTABLES_CANCELED;
+    }
+
     if (!iteratorObj->started) {
         iteratorObj->currentChain = iptc_first_chain(iteratorObj->iptcHandle);
         iteratorObj->started = true;
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "collectors/collector_execution.h"
 #include "os_utils/linux/iptables/iptables_ip_utils.h"
 #include "os_utils/linux/iptables/iptables_port_utils.h"
 #include "os_utils/linux/iptables/iptables_utils.h"
@@ -46,6 +47,10 @@ void IptablesRulesIterator_Deinit(IptablesRulesIteratorHandle iterator) {
 IptablesResults IptablesRulesIterator_GetNext(IptablesRulesIteratorHandle iterator) {
     IptablesRulesIterator* iteratorObj = (IptablesRulesIterator*)iterator;
 
+    if (CollectorExecution_IsCanceled()) {
+        return IPTABLES_CANCELED;
+    }
+
     if (!iteratorObj->started) {
         iteratorObj->currentEntry = iptc_first_rule(iteratorObj->chain, iteratorObj->iptcHandle);
         iteratorObj->started = true;
@@ -1,44 +1,154 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+// pipe2 is a linux extension
+#define _GNU_SOURCE
+
 #include "os_utils/process_utils.h"
 
-#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
+#include "collectors/collector_execution.h"
 #include "logger.h"
 
+// the output is polled in slices, so a canceled collector stops waiting for the command within a slice
+#define PROCESS_UTILS_POLL_INTERVAL 100
+
+typedef enum _ProcessUtilsReadResult {
+
+    // the command closed its output
+    PROCESS_UTILS_READ_DONE,
+    PROCESS_UTILS_READ_MORE_DATA,
+    PROCESS_UTILS_READ_CANCELED,
+    PROCESS_UTILS_READ_FAILED
+
+} ProcessUtilsReadResult;
+
+/**
+ * @brief Starts the command in a process group of its own, with its output written to the given pipe.
+ *
+ * @param   command     The command to run.
+ * @param   fds         The pipe.
+ *
+ * @return the pid of the process, -1 on failure.
+ */
+static pid_t ProcessUtils_Start(const char* command, int fds[2]);
+
+/**
+ * @brief Reads the output of the command until the command closes it, the buffer is full or the collector which runs the command is canceled.
+ *
+ * @param   fd          The read end of the pipe.
+ * @param   output      The output buffer.
+ * @param   size        The size of the output buffer.
+ * @param   outputSize  Out param. The amount of data written to the output buffer.
+ *
+ * @return PROCESS_UTILS_READ_DONE if the whole output was read.
+ */
+static ProcessUtilsReadResult ProcessUtils_ReadOutput(int fd, char* output, uint32_t size, uint32_t* outputSize);
+
 bool ProcessUtils_Execute(const char* command, char* output, uint32_t* outputSize) {
     bool success = true;
-    FILE* commandStream = NULL;
-    commandStream = popen(command, "r");
-    if (commandStream == NULL) {
+    int fds[2] = { -1, -1 };
+    uint32_t originalSize = *outputSize;
+    *outputSize = 0;
+
+    // the pipe is not inherited by the commands which other collectors run at the same time, so their output closes when they exit
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        return false;
+    }
+
+    pid_t pid = ProcessUtils_Start(command, fds);
+    close(fds[1]);
+    if (pid == -1) {
         success = false;
         goto cleanup;
     }
-    
-    clearerr(commandStream);
-    uint32_t originalSize = *outputSize;
-    *outputSize = fread(output, 1, *outputSize, commandStream);
-    if (ferror(commandStream) != 0) {
+
+    ProcessUtilsReadResult readResult = ProcessUtils_ReadOutput(fds[0], output, originalSize, outputSize);
+    if (readResult != PROCESS_UTILS_READ_DONE) {
+        if (readResult == PROCESS_UTILS_READ_CANCELED) {
+            Logger_Warning("Execution of [%s] was canceled.", command);
+        }
+        // the whole group is killed, so the children of the shell do not outlive the collector
+        if (kill(-pid, SIGKILL) != 0 && errno == ESRCH) {
+            // the command did not get a group of its own, it is killed alone so the wait below does not block
+            kill(pid, SIGKILL);
+        }
         success = false;
-        goto cleanup;
     }
 
-    // there is more data to read
-    if (originalSize == *outputSize && feof(commandStream) == 0) {
+    int status = 0;
+    pid_t waitResult = -1;
+    do {
+        waitResult = waitpid(pid, &status, 0);
+    } while (waitResult == -1 && errno == EINTR);
+
+    if (waitResult == -1) {
+        success = false;
+    } else if (readResult == PROCESS_UTILS_READ_DONE && status != 0) {
+        Logger_Error("Excution of [%s] failed with return value of %d.", command, WEXITSTATUS(status));
         success = false;
-        goto cleanup;
     }
 
 cleanup:
-    if (commandStream != NULL) {
-        int closeResult = pclose(commandStream);
-        if (closeResult != 0) {
-            Logger_Error("Excution of [%s] failed with return value of %d.", command, WEXITSTATUS(closeResult));
-            success = false;
+    close(fds[0]);
+    return success;
+}
+
+static pid_t ProcessUtils_Start(const char* command, int fds[2]) {
+    pid_t pid = fork();
+    if (pid > 0) {
+        // the group is set on both sides of the fork, so it exists whichever side runs first
+        setpgid(pid, pid);
+    }
+
+    if (pid != 0) {
+        return pid;
+    }
+
+    // only async signal safe calls are made between the fork and the exec
+    setpgid(0, 0);
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[0]);
+    close(fds[1]);
+    char* const argv[] = { "sh", "-c", (char*)command, NULL };
+    execv("/bin/sh", argv);
+    _exit(127);
+}
+
+static ProcessUtilsReadResult ProcessUtils_ReadOutput(int fd, char* output, uint32_t size, uint32_t* outputSize) {
+    while (!CollectorExecution_IsCanceled()) {
+        struct pollfd pollFd = { .fd = fd, .events = POLLIN, .revents = 0 };
+        int ready = poll(&pollFd, 1, PROCESS_UTILS_POLL_INTERVAL);
+        if (ready == 0 || (ready == -1 && errno == EINTR)) {
+            continue;
+        } else if (ready == -1) {
+            return PROCESS_UTILS_READ_FAILED;
         }
+
+        // a full buffer is fine as long as the command has nothing more to write
+        char extra = 0;
+        bool full = *outputSize == size;
+        ssize_t bytesRead = full ? read(fd, &extra, 1) : read(fd, output + *outputSize, size - *outputSize);
+        if (bytesRead == 0) {
+            return PROCESS_UTILS_READ_DONE;
+        } else if (bytesRead == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return PROCESS_UTILS_READ_FAILED;
+        } else if (full) {
+            return PROCESS_UTILS_READ_MORE_DATA;
+        }
+
+        *outputSize += (uint32_t)bytesRead;
     }
 
-    return success;
-}
\ No newline at end of file
+    return PROCESS_UTILS_READ_CANCELED;
+}
@@ -0,0 +1,372 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "os_utils/spill_log.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils.h"
+
+#define SPILL_LOG_RECORD_MAGIC 0x4C505341
+#define SPILL_LOG_RECORD_ALIGNMENT 8
+
+static const char SPILL_LOG_SEGMENT_FORMAT[] = "%s/segment_%010u.log";
+static const char SPILL_LOG_SEGMENT_SCAN_FORMAT[] = "segment_%10u.log%n";
+
+/**
+ * The header of each record. The magic is written last, so a segment ends at the first header without it.
+ */
+typedef struct _SpillLogRecordHeader {
+
+    uint32_t magic;
+    uint32_t dataSize;
+    uint32_t crc;           // of the data size followed by the data
+    uint32_t consumed;
+
+} SpillLogRecordHeader;
+
+// CRC-32 (IEEE 802.3), one nibble at a time
+static const uint32_t SPILL_LOG_CRC_TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t SpillLog_UpdateCrc(uint32_t crc, const void* buffer, uint32_t size) {
+    const unsigned char* bytes = (const unsigned char*)buffer;
+    for (uint32_t i = 0; i < size; ++i) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ SPILL_LOG_CRC_TABLE[crc & 0xF];
+        crc = (crc >> 4) ^ SPILL_LOG_CRC_TABLE[crc & 0xF];
+    }
+    return crc;
+}
+
+static uint32_t SpillLog_RecordCrc(const void* data, uint32_t dataSize) {
+    uint32_t crc = SpillLog_UpdateCrc(0xFFFFFFFF, &dataSize, sizeof(dataSize));
+    return ~SpillLog_UpdateCrc(crc, data, dataSize);
+}
+
+static uint32_t SpillLog_RecordSize(uint32_t dataSize) {
+    uint32_t size = sizeof(SpillLogRecordHeader) + dataSize;
+    return (size + SPILL_LOG_RECORD_ALIGNMENT - 1) & ~(uint32_t)(SPILL_LOG_RECORD_ALIGNMENT - 1);
+}
+
+static bool SpillLog_GetSegmentPath(SpillLog* spillLog, uint32_t id, char* path) {
+    int length = snprintf(path, PATH_MAX, SPILL_LOG_SEGMENT_FORMAT, spillLog->directory, id);
+    return length > 0 && length < PATH_MAX;
+}
+
+/**
+ * @brief Maps the segment file with the given id, creating it if needed.
+ *
+ * @return the mapped segment or NULL upon failure.
+ */
+static char* SpillLog_MapSegment(SpillLog* spillLog, uint32_t id, bool create) {
+    char path[PATH_MAX];
+    char* base = NULL;
+
+    if (!SpillLog_GetSegmentPath(spillLog, id, path)) {
+        return NULL;
+    }
+
+    int fd = open(path, create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (create) {
+        // the file is zero filled, so a new segment has no records
+        if (ftruncate(fd, SPILL_LOG_SEGMENT_SIZE) != 0) {
+            goto cleanup;
+        }
+    } else {
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size != SPILL_LOG_SEGMENT_SIZE) {
+            goto cleanup;
+        }
+    }
+
+    base = mmap(NULL, SPILL_LOG_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        base = NULL;
+    }
+
+cleanup:
+    // the mapping stays valid after the file is closed
+    close(fd);
+    if (base == NULL && create) {
+        unlink(path);
+    }
+    return base;
+}
+
+static void SpillLog_RemoveSegmentFile(SpillLog* spillLog, uint32_t id) {
+    char path[PATH_MAX];
+    if (SpillLog_GetSegmentPath(spillLog, id, path)) {
+        unlink(path);
+    }
+}
+
+static bool SpillLog_AddSegment(SpillLog* spillLog, uint32_t id, char* base, uint32_t readOffset, uint32_t writeOffset) {
+    SpillLogSegment* newSegments = realloc(spillLog->segments, (spillLog->numberOfSegments + 1) * sizeof(SpillLogSegment));
+    if (newSegments == NULL) {
+        return false;
+    }
+    spillLog->segments = newSegments;
+
+    SpillLogSegment* segment = &spillLog->segments[spillLog->numberOfSegments++];
+    segment->id = id;
+    segment->base = base;
+    segment->readOffset = readOffset;
+    segment->writeOffset = writeOffset;
+    return true;
+}
+
+/**
+ * @brief Unmaps and deletes the oldest segment.
+ */
+static void SpillLog_RemoveOldestSegment(SpillLog* spillLog) {
+    SpillLogSegment* segment = &spillLog->segments[0];
+    munmap(segment->base, SPILL_LOG_SEGMENT_SIZE);
+    SpillLog_RemoveSegmentFile(spillLog, segment->id);
+
+    --spillLog->numberOfSegments;
+    memmove(&spillLog->segments[0], &spillLog->segments[1], spillLog->numberOfSegments * sizeof(SpillLogSegment));
+}
+
+/**
+ * @brief Scans the records of a reloaded segment up to the first torn or corrupted record.
+ *
+ * @return the number of records which were not consumed yet.
+ */
+static uint32_t SpillLog_ScanSegment(const char* base, uint32_t* readOffset, uint32_t* writeOffset) {
+    uint32_t numberOfRecords = 0;
+    uint32_t offset = 0;
+    *readOffset = 0;
+
+    while (offset + sizeof(SpillLogRecordHeader) <= SPILL_LOG_SEGMENT_SIZE) {
+        const SpillLogRecordHeader* header = (const SpillLogRecordHeader*)(base + offset);
+        if (header->magic != SPILL_LOG_RECORD_MAGIC || header->dataSize > SPILL_LOG_SEGMENT_SIZE - offset - sizeof(SpillLogRecordHeader)) {
+            break;
+        }
+
+        if (SpillLog_RecordCrc(header + 1, header->dataSize) != header->crc) {
+            break;
+        }
+
+        offset += SpillLog_RecordSize(header->dataSize);
+        if (header->consumed) {
+            // records are consumed in order, so the consumed records are a prefix of the segment
+            *readOffset = offset;
+        } else {
+            ++numberOfRecords;
+        }
+    }
+
+    *writeOffset = offset;
+    return numberOfRecords;
+}
+
+static int SpillLog_CompareIds(const void* first, const void* second) {
+    uint32_t firstId = *(const uint32_t*)first;
+    uint32_t secondId = *(const uint32_t*)second;
+    return (firstId > secondId) - (firstId < secondId);
+}
+
+/**
+ * @brief Reloads the segments found in the log directory, in the order they were created.
+ */
+static SpillLogResultValues SpillLog_Reload(SpillLog* spillLog) {
+    SpillLogResultValues result = SPILL_LOG_OK;
+    uint32_t* ids = NULL;
+    uint32_t numberOfIds = 0;
+
+    DIR* directory = opendir(spillLog->directory);
+    if (directory == NULL) {
+        return SPILL_LOG_EXCEPTION;
+    }
+
+    struct dirent* entry = NULL;
+    while ((entry = readdir(directory)) != NULL) {
+        uint32_t id = 0;
+        int length = 0;
+        if (sscanf(entry->d_name, SPILL_LOG_SEGMENT_SCAN_FORMAT, &id, &length) != 1 || entry->d_name[length] != '\0') {
+            continue;
+        }
+
+        uint32_t* newIds = realloc(ids, (numberOfIds + 1) * sizeof(uint32_t));
+        if (newIds == NULL) {
+            result = SPILL_LOG_EXCEPTION;
+            goto cleanup;
+        }
+        ids = newIds;
+        ids[numberOfIds++] = id;
+    }
+
+    if (numberOfIds > 0) {
+        qsort(ids, numberOfIds, sizeof(uint32_t), SpillLog_CompareIds);
+    }
+
+    for (uint32_t i = 0; i < numberOfIds; ++i) {
+        spillLog->nextSegmentId = ids[i] + 1;
+
+        char* base = SpillLog_MapSegment(spillLog, ids[i], false);
+        if (base == NULL) {
+            // not a segment this log can read, it would only hold the quota
+            SpillLog_RemoveSegmentFile(spillLog, ids[i]);
+            continue;
+        }
+
+        uint32_t readOffset = 0;
+        uint32_t writeOffset = 0;
+        uint32_t numberOfRecords = SpillLog_ScanSegment(base, &readOffset, &writeOffset);
+        if (numberOfRecords == 0) {
+            munmap(base, SPILL_LOG_SEGMENT_SIZE);
+            SpillLog_RemoveSegmentFile(spillLog, ids[i]);
+            continue;
+        }
+
+        if (!SpillLog_AddSegment(spillLog, ids[i], base, readOffset, writeOffset)) {
+            munmap(base, SPILL_LOG_SEGMENT_SIZE);
+            result = SPILL_LOG_EXCEPTION;
+            goto cleanup;
+        }
+        spillLog->numberOfRecords += numberOfRecords;
+    }
+
+cleanup:
+    closedir(directory);
+    free(ids);
+    return result;
+}
+
+/**
+ * @brief Creates the log directory and its missing parents.
+ * 
+ * @param   directory   The directory, modified during the call and restored before returning.
+ * 
+ * @return true on success, false otherwise.
+ */
+static bool SpillLog_CreateDirectory(char* directory) {
+    for (char* separator = strchr(directory + 1, '/'); separator != NULL; separator = strchr(separator + 1, '/')) {
+        *separator = '\0';
+        int result = mkdir(directory, S_IRWXU);
+        *separator = '/';
+        if (result != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+
+    return mkdir(directory, S_IRWXU) == 0 || errno == EEXIST;
+}
+
+SpillLogResultValues SpillLog_Init(SpillLog* spillLog, const char* directory, uint32_t diskQuota) {
+    memset(spillLog, 0, sizeof(*spillLog));
+    spillLog->maxSegments = diskQuota / SPILL_LOG_SEGMENT_SIZE;
+
+    if (!Utils_CreateStringCopy(&spillLog->directory, directory)) {
+        return SPILL_LOG_EXCEPTION;
+    }
+
+    if (!SpillLog_CreateDirectory(spillLog->directory)) {
+        SpillLog_Deinit(spillLog);
+        return SPILL_LOG_EXCEPTION;
+    }
+
+    SpillLogResultValues result = SpillLog_Reload(spillLog);
+    if (result != SPILL_LOG_OK) {
+        SpillLog_Deinit(spillLog);
+    }
+    return result;
+}
+
+void SpillLog_Deinit(SpillLog* spillLog) {
+    for (uint32_t i = 0; i < spillLog->numberOfSegments; ++i) {
+        msync(spillLog->segments[i].base, SPILL_LOG_SEGMENT_SIZE, MS_SYNC);
+        munmap(spillLog->segments[i].base, SPILL_LOG_SEGMENT_SIZE);
+    }
+    free(spillLog->segments);
+    free(spillLog->directory);
+    memset(spillLog, 0, sizeof(*spillLog));
+}
+
+SpillLogResultValues SpillLog_Append(SpillLog* spillLog, const void* data, uint32_t dataSize) {
+    if (dataSize > SPILL_LOG_SEGMENT_SIZE - sizeof(SpillLogRecordHeader)) {
+        return SPILL_LOG_QUOTA_EXCEEDED;
+    }
+    uint32_t recordSize = SpillLog_RecordSize(dataSize);
+
+    SpillLogSegment* segment = spillLog->numberOfSegments == 0 ? NULL : &spillLog->segments[spillLog->numberOfSegments - 1];
+    if (segment == NULL || segment->writeOffset + recordSize > SPILL_LOG_SEGMENT_SIZE) {
+        if (spillLog->numberOfSegments >= spillLog->maxSegments) {
+            return SPILL_LOG_QUOTA_EXCEEDED;
+        }
+
+        char* base = SpillLog_MapSegment(spillLog, spillLog->nextSegmentId, true);
+        if (base == NULL) {
+            return SPILL_LOG_EXCEPTION;
+        }
+
+        if (!SpillLog_AddSegment(spillLog, spillLog->nextSegmentId, base, 0, 0)) {
+            munmap(base, SPILL_LOG_SEGMENT_SIZE);
+            SpillLog_RemoveSegmentFile(spillLog, spillLog->nextSegmentId);
+            return SPILL_LOG_EXCEPTION;
+        }
+        ++spillLog->nextSegmentId;
+        segment = &spillLog->segments[spillLog->numberOfSegments - 1];
+    }
+
+    SpillLogRecordHeader* header = (SpillLogRecordHeader*)(segment->base + segment->writeOffset);
+    memcpy(header + 1, data, dataSize);
+    header->dataSize = dataSize;
+    header->crc = SpillLog_RecordCrc(data, dataSize);
+    header->consumed = 0;
+    __atomic_store_n(&header->magic, SPILL_LOG_RECORD_MAGIC, __ATOMIC_RELEASE);
+
+    segment->writeOffset += recordSize;
+    ++spillLog->numberOfRecords;
+    return SPILL_LOG_OK;
+}
+
+SpillLogResultValues SpillLog_Peek(SpillLog* spillLog, const void** data, uint32_t* dataSize) {
+    if (spillLog->numberOfRecords == 0) {
+        return SPILL_LOG_IS_EMPTY;
+    }
+
+    // a segment is removed once it was read to its end, so the oldest segment always holds the next record
+    SpillLogSegment* segment = &spillLog->segments[0];
+    const SpillLogRecordHeader* header = (const SpillLogRecordHeader*)(segment->base + segment->readOffset);
+    *data = header + 1;
+    *dataSize = header->dataSize;
+    return SPILL_LOG_OK;
+}
+
+SpillLogResultValues SpillLog_Consume(SpillLog* spillLog) {
+    if (spillLog->numberOfRecords == 0) {
+        return SPILL_LOG_IS_EMPTY;
+    }
+
+    SpillLogSegment* segment = &spillLog->segments[0];
+    SpillLogRecordHeader* header = (SpillLogRecordHeader*)(segment->base + segment->readOffset);
+    header->consumed = 1;
+    segment->readOffset += SpillLog_RecordSize(header->dataSize);
+    --spillLog->numberOfRecords;
+
+    if (segment->readOffset >= segment->writeOffset) {
+        SpillLog_RemoveOldestSegment(spillLog);
+    }
+    return SPILL_LOG_OK;
+}
+
+uint32_t SpillLog_GetSize(SpillLog* spillLog) {
+    return spillLog->numberOfRecords;
+}
@@ -3,21 +3,240 @@
 #include "queue.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "logger.h"
 #include "memory_monitor.h"
 #include "agent_telemetry_counters.h"
+#include "slab_allocator.h"
 
 static uint32_t Queue_CalculateItemSize(uint32_t dataSize) {
     // each item in the list has a struct cllocate for it, a pointer to this struct and the data size for the data itself
     return dataSize + sizeof(QueueItem) + sizeof(QueueItem*);
 }
 
+/**
+ * @brief Returns the item which shares its block with the given data.
+ * 
+ * @param   data        The data.
+ * @param   blockSize   Out param. The size of the shared block.
+ * 
+ * @return the item, or NULL if the data was not allocated by Queue_AllocateData from the pool.
+ */
+static QueueItem* Queue_GetInlineItem(const void* data, uint32_t* blockSize) {
+    void* block = NULL;
+    if (data == NULL || !SlabAllocator_GetBlock(data, &block, blockSize)) {
+        return NULL;
+    }
+
+    if ((char*)block + sizeof(QueueItem) != data) {
+        return NULL;
+    }
+    return (QueueItem*)block;
+}
+
+/**
+ * @brief Allocates the item which holds the given data in the queue.
+ * 
+ * @param   data        The data to hold.
+ * @param   dataSize    The size of the data.
+ * @param   itemSize    Out param. The exact amount of memory held by the item and its data.
+ * 
+ * @return the item or NULL upon failure.
+ */
+static QueueItem* Queue_AllocateItem(void* data, uint32_t dataSize, uint32_t* itemSize) {
+    uint32_t blockSize = 0;
+    QueueItem* item = Queue_GetInlineItem(data, &blockSize);
+    if (item != NULL) {
+        item->pooledItem = true;
+        item->inlineData = true;
+        *itemSize = blockSize;
+        return item;
+    }
+
+    item = (QueueItem*)SlabAllocator_Allocate(sizeof(QueueItem));
+    if (item != NULL) {
+        item->pooledItem = true;
+        *itemSize = dataSize + SlabAllocator_GetBlockSize(sizeof(QueueItem));
+    } else {
+        item = (QueueItem*)malloc(sizeof(QueueItem));
+        if (item == NULL) {
+            return NULL;
+        }
+        item->pooledItem = false;
+        *itemSize = Queue_CalculateItemSize(dataSize);
+    }
+
+    item->inlineData = false;
+    return item;
+}
+
+/**
+ * @brief Consumes the memory of an item from the memory budget of the queue, or from the shared memory if it has none.
+ */
+static MemoryMonitorResultValues Queue_ConsumeMemory(Queue* queue, uint32_t size) {
+    if (queue->budget == NULL) {
+        return MemoryMonitor_Consume(size);
+    }
+    return MemoryMonitor_ConsumeFromBudget(queue->budget, size);
+}
+
+static void Queue_ReleaseMemory(Queue* queue, uint32_t size) {
+    if (queue->budget == NULL) {
+        MemoryMonitor_Release(size);
+    } else {
+        MemoryMonitor_ReleaseToBudget(queue->budget, size);
+    }
+}
+
+static void Queue_FreeItem(QueueItem* item) {
+    if (item->inlineData) {
+        // the item is part of the data block, it is released together with the data
+        return;
+    }
+
+    if (item->pooledItem) {
+        SlabAllocator_Free(item);
+    } else {
+        free(item);
+    }
+}
+
+/**
+ * @brief Links the given data to the end of the queue if it fits in the memory budget.
+ * 
+ * @param   queue       The queue.
+ * @param   data        The data to link.
+ * @param   dataSize    The size of the data.
+ * @param   priority    The eviction priority of the data.
+ * 
+ * @return QUEUE_OK on success, QUEUE_MAX_MEMORY_EXCEEDED if the data does not fit or QUEUE_MEMORY_EXCEPTION.
+ */
+static QueueResultValues Queue_Append(Queue* queue, void* data, uint32_t dataSize, QueuePriority priority) {
+    uint32_t itemSize = 0;
+    QueueItem* newItem = Queue_AllocateItem(data, dataSize, &itemSize);
+    if (newItem == NULL) {
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    MemoryMonitorResultValues consumeResult = Queue_ConsumeMemory(queue, itemSize);
+    if (consumeResult != MEMORY_MONITOR_OK) {
+        Queue_FreeItem(newItem);
+        return (consumeResult == MEMORY_MONITOR_MEMORY_EXCEEDED) ? QUEUE_MAX_MEMORY_EXCEEDED : QUEUE_MEMORY_EXCEPTION;
+    }
+
+    newItem->data = data;
+    newItem->dataSize = dataSize;
+    newItem->accountedSize = itemSize;
+    newItem->priority = priority;
+    newItem->nextItem = NULL;
+
+    if (queue->firstItem == NULL) {
+        // queue is empty
+        queue->firstItem = newItem;
+        queue->lastItem = newItem;
+        newItem->prevItem = NULL;
+    } else {
+        queue->lastItem->nextItem = newItem;
+        newItem->prevItem = queue->lastItem;
+        queue->lastItem = newItem;
+    }
+    ++queue->numberOfElements;
+    return QUEUE_OK;
+}
+
+/**
+ * @brief Appends the given data to the spill log of the queue, the data is released on success since the log keeps a copy.
+ * 
+ * @param   queue       The queue.
+ * @param   data        The data to spill.
+ * @param   dataSize    The size of the data.
+ * 
+ * @return QUEUE_OK on success or QUEUE_MAX_MEMORY_EXCEEDED if the log is full as well.
+ */
+static QueueResultValues Queue_Spill(Queue* queue, void* data, uint32_t dataSize) {
+    SpillLogResultValues spillResult = SpillLog_Append(queue->spillLog, data, dataSize);
+    if (spillResult != SPILL_LOG_OK) {
+        if (spillResult == SPILL_LOG_EXCEPTION && queue->shouldSendLogs) {
+            Logger_Error("failed to spill an item to the disk");
+        }
+        return QUEUE_MAX_MEMORY_EXCEEDED;
+    }
+
+    Queue_FreeData(data);
+    return QUEUE_OK;
+}
+
+/**
+ * @brief Moves records from the spill log back to the memory of the queue while they fit in the memory budget.
+ * 
+ * @param   queue   The queue.
+ */
+static void Queue_Refill(Queue* queue) {
+    if (queue->spillLog == NULL) {
+        return;
+    }
+
+    const void* record = NULL;
+    uint32_t recordSize = 0;
+    while (SpillLog_Peek(queue->spillLog, &record, &recordSize) == SPILL_LOG_OK) {
+        void* data = Queue_AllocateData(recordSize);
+        if (data == NULL) {
+            return;
+        }
+        memcpy(data, record, recordSize);
+
+        QueueResultValues result = Queue_Append(queue, data, recordSize, queue->priority);
+        if (result != QUEUE_OK) {
+            Queue_FreeData(data);
+            if (result != QUEUE_MAX_MEMORY_EXCEEDED || queue->numberOfElements > 0) {
+                return;
+            }
+
+            // the record does not fit even in an empty queue, keeping it would block the log forever
+            if (queue->shouldSendLogs) {
+                Logger_Information("Spilled item exceeds the max cache size");
+            }
+            AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+        }
+
+        SpillLog_Consume(queue->spillLog);
+    }
+}
+
+/**
+ * @brief Unlinks the given item from any position in the queue and releases its memory from the memory budget.
+ *        The item itself is not freed.
+ * 
+ * @param   queue   The queue.
+ * @param   item    The item to unlink.
+ */
+static void Queue_Unlink(Queue* queue, QueueItem* item) {
+    if (item->prevItem == NULL) {
+        queue->firstItem = item->nextItem;
+    } else {
+        ((QueueItem*)item->prevItem)->nextItem = item->nextItem;
+    }
+    if (item->nextItem == NULL) {
+        queue->lastItem = item->prevItem;
+    } else {
+        ((QueueItem*)item->nextItem)->prevItem = item->prevItem;
+    }
+
+    --queue->numberOfElements;
+    Queue_ReleaseMemory(queue, item->accountedSize);
+}
+
 QueueResultValues Queue_Init(Queue* queue, bool shouldSendLogs) {
     queue->numberOfElements = 0;
     queue->firstItem = NULL;
     queue->lastItem = NULL;
     queue->shouldSendLogs = shouldSendLogs;
+    queue->spillLog = NULL;
+    queue->priority = QUEUE_PRIORITY_PROTECTED;
+    queue->evict = NULL;
+    queue->evictParams = NULL;
+    queue->budget = NULL;
     if (!AgentTelemetryCounter_Init(&(queue->counter))){
         return QUEUE_MEMORY_EXCEPTION;
     }
@@ -27,64 +246,73 @@ QueueResultValues Queue_Init(Queue* queue, bool shouldSendLogs) {
 
 void Queue_Deinit(Queue* queue) {
     AgentTelemetryCounter_Deinit(&queue->counter);
+
+    // detach the log first so poping does not refill from it
+    SpillLog* spillLog = queue->spillLog;
+    queue->spillLog = NULL;
     
     void* currentData;
     uint32_t currentDataSize;
     while (queue->numberOfElements > 0) {
         if (Queue_PopFront(queue, &currentData, &currentDataSize) == QUEUE_OK) {
-            free(currentData);
+            // keep the items for the next run, they end up after the records which were spilled earlier
+            if (spillLog != NULL) {
+                SpillLog_Append(spillLog, currentData, currentDataSize);
+            }
+            Queue_FreeData(currentData);
         }
     }
 }
 
+void Queue_SetSpillLog(Queue* queue, SpillLog* spillLog) {
+    queue->spillLog = spillLog;
+    Queue_Refill(queue);
+}
+
+void Queue_SetMemoryBudget(Queue* queue, struct _MemoryBudget* budget) {
+    queue->budget = budget;
+}
+
+bool Queue_ConsumesSharedMemory(Queue* queue) {
+    return queue->budget == NULL || MemoryMonitor_IsBeyondReservation(queue->budget);
+}
+
+void Queue_SetEvictionPolicy(Queue* queue, QueuePriority priority, QueueEvictFunction evict, void* evictParams) {
+    queue->priority = priority;
+    queue->evict = evict;
+    queue->evictParams = evictParams;
+}
+
 QueueResultValues Queue_PushBack(Queue* queue, void* data, uint32_t dataSize) {
-    int result = QUEUE_OK;
-    bool memoryConsumed = false;
-
-    result = MemoryMonitor_Consume(Queue_CalculateItemSize(dataSize));
-    if (result != MEMORY_MONITOR_OK) {
-        if (result == MEMORY_MONITOR_MEMORY_EXCEEDED) {
-            if (queue->shouldSendLogs) { 
-                Logger_Information("Max cache size exceeded"); 
-            }
-            result = QUEUE_MAX_MEMORY_EXCEEDED;
-            AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
-        }
-        else if (result == MEMORY_MONITOR_EXCEPTION) {
-            if (queue->shouldSendLogs) { 
-                Logger_Error("critical memory exception"); 
-            }
-            result = QUEUE_MEMORY_EXCEPTION;
+    return Queue_PushBackWithPriority(queue, data, dataSize, queue->priority);
+}
+
+QueueResultValues Queue_PushBackWithPriority(Queue* queue, void* data, uint32_t dataSize, QueuePriority priority) {
+    QueueResultValues result = QUEUE_OK;
+
+    if (queue->spillLog != NULL && SpillLog_GetSize(queue->spillLog) > 0) {
+        // older items are waiting in the log, so the item goes after them to keep the order
+        result = Queue_Spill(queue, data, dataSize);
+    } else {
+        result = Queue_Append(queue, data, dataSize, priority);
+        if (result == QUEUE_MAX_MEMORY_EXCEEDED && queue->spillLog != NULL) {
+            result = Queue_Spill(queue, data, dataSize);
         }
-        goto cleanup;
     }
-    memoryConsumed = true;
 
-    QueueItem* newItem = (QueueItem*)malloc(sizeof(QueueItem));
-    if (newItem == NULL) {
-        result = QUEUE_MEMORY_EXCEPTION;
-        goto cleanup;
+    // the disk is exhausted as well, make room by evicting items with a lower priority
+    while (result == QUEUE_MAX_MEMORY_EXCEEDED && queue->evict != NULL && queue->evict(queue->evictParams, queue, priority)) {
+        result = Queue_Append(queue, data, dataSize, priority);
     }
 
-    newItem->data = data;
-    newItem->dataSize = dataSize;
-    newItem->nextItem = NULL;
-
-    if (queue->firstItem == NULL) {
-        // queue is empty
-        queue->firstItem = newItem;
-        queue->lastItem = newItem;
-        newItem->prevItem = NULL;
-    } else {
-        queue->lastItem->nextItem = newItem;
-        newItem->prevItem = queue->lastItem;
-        queue->lastItem = newItem;
-    }
-    ++queue->numberOfElements;
-cleanup:
-    if (result != QUEUE_OK) {
-        if (memoryConsumed) {
-            MemoryMonitor_Release(Queue_CalculateItemSize(dataSize));
+    if (result == QUEUE_MAX_MEMORY_EXCEEDED) {
+        if (queue->shouldSendLogs) { 
+            Logger_Information("Max cache size exceeded"); 
+        }
+        AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+    } else if (result == QUEUE_MEMORY_EXCEPTION) {
+        if (queue->shouldSendLogs) { 
+            Logger_Error("critical memory exception"); 
         }
     }
 
@@ -110,9 +338,10 @@ QueueResultValues Queue_PopFront(Queue* queue, void** data, uint32_t* dataSize)
     }
 
     --queue->numberOfElements;
-    MemoryMonitor_Release(Queue_CalculateItemSize(*dataSize));
+    Queue_ReleaseMemory(queue, item->accountedSize);
     // we allocated the item itself while inserting it, so we soquld free its memory here
-    free(item); 
+    Queue_FreeItem(item); 
+    Queue_Refill(queue);
     return QUEUE_OK;
 }
 
@@ -128,7 +357,140 @@ QueueResultValues Queue_PopFrontIf(Queue* queue, QueuePopCondition condition, vo
     return Queue_PopFront(queue, data, dataSize);
 }
 
+QueueResultValues Queue_PopBatchIf(Queue* queue, QueuePopCondition condition, void* conditionParams, uint32_t maxBatchSize, QueueBatch* batch) {
+    batch->firstItem = NULL;
+    batch->numberOfElements = 0;
+    batch->dataSize = 0;
+
+    if (queue->numberOfElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    // find the end of the prefix, nothing is allocated or freed here since this usually runs under the queue lock,
+    // unless a spill log is attached and the queue is refilled from it
+    uint32_t accountedSize = 0;
+    QueueItem* lastItem = NULL;
+    QueueItem* item = queue->firstItem;
+    while (item != NULL && item->dataSize < maxBatchSize - batch->dataSize) {
+        if (condition != NULL && !condition(item->data, item->dataSize, conditionParams)) {
+            break;
+        }
+        batch->dataSize += item->dataSize;
+        ++batch->numberOfElements;
+        accountedSize += item->accountedSize;
+        lastItem = item;
+        item = item->nextItem;
+    }
+
+    if (lastItem == NULL) {
+        return QUEUE_CONDITION_FAILED;
+    }
+
+    batch->firstItem = queue->firstItem;
+    lastItem->nextItem = NULL;
+    queue->firstItem = item;
+    if (item == NULL) {
+        queue->lastItem = NULL;
+    } else {
+        item->prevItem = NULL;
+    }
+
+    queue->numberOfElements -= batch->numberOfElements;
+    Queue_ReleaseMemory(queue, accountedSize);
+    Queue_Refill(queue);
+    return QUEUE_OK;
+}
+
+QueueResultValues Queue_BatchPopFront(QueueBatch* batch, void** data, uint32_t* dataSize) {
+    if (batch->numberOfElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    QueueItem* item = batch->firstItem;
+    *data = item->data;
+    *dataSize = item->dataSize;
+
+    batch->firstItem = item->nextItem;
+    --batch->numberOfElements;
+    batch->dataSize -= item->dataSize;
+    Queue_FreeItem(item);
+    return QUEUE_OK;
+}
+
+QueueResultValues Queue_EvictOldest(Queue* queue, QueuePriority priority) {
+    QueueItem* item = queue->firstItem;
+    while (item != NULL && item->priority != priority) {
+        item = item->nextItem;
+    }
+
+    if (item == NULL) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    Queue_Unlink(queue, item);
+    void* data = item->data;
+    Queue_FreeItem(item);
+    Queue_FreeData(data);
+
+    AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+    return QUEUE_OK;
+}
+
+QueueResultValues Queue_PopBestFit(Queue* queue, uint32_t maxDataSize, void** data, uint32_t* dataSize) {
+    if (queue->numberOfElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    // the largest item which fits, the oldest one wins a tie
+    QueueItem* bestItem = NULL;
+    uint32_t lookAhead = 0;
+    for (QueueItem* item = queue->firstItem; item != NULL && lookAhead < QUEUE_BEST_FIT_MAX_LOOK_AHEAD; item = item->nextItem, ++lookAhead) {
+        if (item->dataSize <= maxDataSize && (bestItem == NULL || item->dataSize > bestItem->dataSize)) {
+            bestItem = item;
+            if (item->dataSize == maxDataSize) {
+                break;
+            }
+        }
+    }
+
+    if (bestItem == NULL) {
+        return QUEUE_CONDITION_FAILED;
+    }
+
+    Queue_Unlink(queue, bestItem);
+    *data = bestItem->data;
+    *dataSize = bestItem->dataSize;
+    Queue_FreeItem(bestItem);
+    Queue_Refill(queue);
+    return QUEUE_OK;
+}
+
 QueueResultValues Queue_GetSize(Queue* queue, uint32_t* size) {
     *size = queue->numberOfElements;
+    if (queue->spillLog != NULL) {
+        *size += SpillLog_GetSize(queue->spillLog);
+    }
     return QUEUE_OK;
+}
+
+void* Queue_AllocateData(uint32_t dataSize) {
+    if (dataSize <= SLAB_ALLOCATOR_MAX_BLOCK_SIZE) {
+        QueueItem* item = (QueueItem*)SlabAllocator_Allocate(sizeof(QueueItem) + dataSize);
+        if (item != NULL) {
+            return item + 1;
+        }
+    }
+
+    // too big for the pool, or the pool is not available
+    return malloc(dataSize);
+}
+
+void Queue_FreeData(void* data) {
+    uint32_t blockSize = 0;
+    QueueItem* item = Queue_GetInlineItem(data, &blockSize);
+    if (item != NULL) {
+        SlabAllocator_Free(item);
+    } else {
+        free(data);
+    }
 }
\ No newline at end of file
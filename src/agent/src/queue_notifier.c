@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "queue_notifier.h"
+
+#include <string.h>
+
+bool QueueNotifier_Init(QueueNotifier* notifier, uint32_t watermark) {
+    memset(notifier, 0, sizeof(*notifier));
+    notifier->watermark = watermark;
+
+    notifier->lock = Lock_Init();
+    if (notifier->lock == NULL) {
+        return false;
+    }
+
+    notifier->condition = Condition_Init();
+    if (notifier->condition == NULL) {
+        Lock_Deinit(notifier->lock);
+        notifier->lock = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void QueueNotifier_Deinit(QueueNotifier* notifier) {
+    if (notifier->condition != NULL) {
+        Condition_Deinit(notifier->condition);
+    }
+
+    if (notifier->lock != NULL) {
+        Lock_Deinit(notifier->lock);
+    }
+
+    memset(notifier, 0, sizeof(*notifier));
+}
+
+void QueueNotifier_SetWatermark(QueueNotifier* notifier, uint32_t watermark) {
+    if (Lock(notifier->lock) != LOCK_OK) {
+        return;
+    }
+
+    notifier->watermark = watermark;
+
+    Unlock(notifier->lock);
+}
+
+void QueueNotifier_NotifyPush(QueueNotifier* notifier, uint32_t dataSize, bool urgent) {
+    if (Lock(notifier->lock) != LOCK_OK) {
+        return;
+    }
+
+    notifier->pendingSize = (UINT32_MAX - notifier->pendingSize < dataSize) ? UINT32_MAX : notifier->pendingSize + dataSize;
+    notifier->urgent |= urgent;
+
+    // the consumer is woken once per crossing, it resets the pending size when it wakes up
+    if (!notifier->signaled && (notifier->urgent || notifier->pendingSize >= notifier->watermark)) {
+        notifier->signaled = true;
+        Condition_Post(notifier->condition);
+    }
+
+    Unlock(notifier->lock);
+}
+
+void QueueNotifier_Signal(QueueNotifier* notifier) {
+    if (Lock(notifier->lock) != LOCK_OK) {
+        return;
+    }
+
+    notifier->signaled = true;
+    Condition_Post(notifier->condition);
+
+    Unlock(notifier->lock);
+}
+
+QueueNotifierWaitResult QueueNotifier_Wait(QueueNotifier* notifier, uint32_t timeout) {
+    QueueNotifierWaitResult result = QUEUE_NOTIFIER_TIMEOUT;
+
+    if (Lock(notifier->lock) != LOCK_OK) {
+        return QUEUE_NOTIFIER_EXCEPTION;
+    }
+
+    // the wait may wake up spuriously, so it is repeated until signaled or timed out
+    while (!notifier->signaled) {
+        COND_RESULT waitResult = Condition_Wait(notifier->condition, notifier->lock, (int)timeout);
+        if (waitResult == COND_TIMEOUT) {
+            break;
+        } else if (waitResult != COND_OK) {
+            result = QUEUE_NOTIFIER_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    if (notifier->urgent) {
+        result = QUEUE_NOTIFIER_URGENT;
+    } else if (notifier->signaled) {
+        result = QUEUE_NOTIFIER_SIGNALED;
+    }
+
+    notifier->signaled = false;
+    notifier->urgent = false;
+    notifier->pendingSize = 0;
+
+cleanup:
+    Unlock(notifier->lock);
+    return result;
+}
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "reconnect_worker.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "consts.h"
+#include "logger.h"
+
+/**
+ * @brief The main function of the worker thread, waits for the due reconnects and attempts them.
+ *
+ * @param   params  The worker instance.
+ *
+ * @return always 0.
+ */
+static int ReconnectWorker_MainFunc(void* params);
+
+/**
+ * @brief Schedules the next attempt, the lock of the worker is held by the caller.
+ */
+static void ReconnectWorker_ScheduleLocked(ReconnectWorker* worker);
+
+/**
+ * @brief Returns the monotonic time in milliseconds.
+ */
+static uint64_t ReconnectWorker_GetTime();
+
+bool ReconnectWorker_Init(ReconnectWorker* worker, ReconnectWorkerReconnect reconnect, void* context) {
+    memset(worker, 0, sizeof(*worker));
+    worker->reconnect = reconnect;
+    worker->context = context;
+    // agents which start together still draw different backoffs
+    worker->seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
+
+    worker->lock = Lock_Init();
+    if (worker->lock == NULL) {
+        return false;
+    }
+
+    worker->condition = Condition_Init();
+    if (worker->condition == NULL) {
+        Lock_Deinit(worker->lock);
+        worker->lock = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void ReconnectWorker_Deinit(ReconnectWorker* worker) {
+    if (worker->lock == NULL) {
+        return;
+    }
+
+    if (worker->thread != NULL && Lock(worker->lock) == LOCK_OK) {
+        worker->stop = true;
+        Condition_Post(worker->condition);
+        Unlock(worker->lock);
+
+        int result;
+        ThreadAPI_Join(worker->thread, &result);
+    }
+
+    Condition_Deinit(worker->condition);
+    Lock_Deinit(worker->lock);
+    memset(worker, 0, sizeof(*worker));
+}
+
+bool ReconnectWorker_Schedule(ReconnectWorker* worker) {
+    if (worker->lock == NULL || Lock(worker->lock) != LOCK_OK) {
+        return false;
+    }
+
+    bool success = true;
+    if (worker->thread == NULL && ThreadAPI_Create(&worker->thread, ReconnectWorker_MainFunc, worker) != THREADAPI_OK) {
+        Logger_Error("Could not start the reconnect thread");
+        worker->thread = NULL;
+        success = false;
+        goto cleanup;
+    }
+
+    if (!worker->pending) {
+        ReconnectWorker_ScheduleLocked(worker);
+        Condition_Post(worker->condition);
+    }
+
+cleanup:
+    Unlock(worker->lock);
+    return success;
+}
+
+void ReconnectWorker_Reset(ReconnectWorker* worker) {
+    if (worker->lock == NULL || Lock(worker->lock) != LOCK_OK) {
+        return;
+    }
+
+    worker->pending = false;
+    worker->attempts = 0;
+
+    Unlock(worker->lock);
+}
+
+uint32_t ReconnectWorker_GetBackoff(uint32_t attempts, unsigned int* seed) {
+    uint32_t interval = RECONNECT_INITIAL_INTERVAL;
+    for (uint32_t i = 0; i < attempts && interval < RECONNECT_MAX_INTERVAL; ++i) {
+        interval *= 2;
+    }
+    if (interval > RECONNECT_MAX_INTERVAL) {
+        interval = RECONNECT_MAX_INTERVAL;
+    }
+
+    uint32_t half = interval / 2;
+    return half + (uint32_t)rand_r(seed) % (interval - half + 1);
+}
+
+static void ReconnectWorker_ScheduleLocked(ReconnectWorker* worker) {
+    uint32_t backoff = ReconnectWorker_GetBackoff(worker->attempts, &worker->seed);
+    Logger_Information("Reconnecting in %u milliseconds, attempt %u", backoff, worker->attempts + 1);
+    worker->dueTime = ReconnectWorker_GetTime() + backoff;
+    worker->pending = true;
+}
+
+static int ReconnectWorker_MainFunc(void* params) {
+    ReconnectWorker* worker = (ReconnectWorker*)params;
+    if (Lock(worker->lock) != LOCK_OK) {
+        Logger_Error("Could not lock the reconnect worker, the thread exits");
+        return 0;
+    }
+
+    while (!worker->stop) {
+        uint64_t now = ReconnectWorker_GetTime();
+        if (!worker->pending) {
+            Condition_Wait(worker->condition, worker->lock, 0);
+            continue;
+        }
+        if (now < worker->dueTime) {
+            Condition_Wait(worker->condition, worker->lock, (int)(worker->dueTime - now));
+            continue;
+        }
+
+        worker->pending = false;
+        ++worker->attempts;
+        Unlock(worker->lock);
+
+        bool started = worker->reconnect(worker->context);
+
+        if (Lock(worker->lock) != LOCK_OK) {
+            Logger_Error("Could not lock the reconnect worker, the thread exits");
+            return 0;
+        }
+
+        // the next attempt is scheduled until the connection is reported back, which resets the attempts
+        if (!worker->stop && !worker->pending && worker->attempts > 0) {
+            if (!started) {
+                Logger_Warning("Reconnect attempt %u failed", worker->attempts);
+            }
+            ReconnectWorker_ScheduleLocked(worker);
+        }
+    }
+
+    Unlock(worker->lock);
+    return 0;
+}
+
+static uint64_t ReconnectWorker_GetTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
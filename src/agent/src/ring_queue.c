@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include "ring_queue.h"
+
+#include <stdlib.h>
+
+#include "logger.h"
+#include "memory_monitor.h"
+#include "agent_telemetry_counters.h"
+
+static uint32_t RingQueue_CalculateItemSize(uint32_t dataSize) {
+    // the slots are allocated up front, we still account for them so the cache limit means the same for both queue types
+    return dataSize + sizeof(RingQueueSlot);
+}
+
+static uint32_t RingQueue_RoundUpToPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value && result != 0) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the slot at the head of the queue if a producer has finished writing to it.
+ *
+ * @param   queue   The queue.
+ *
+ * @return the head slot or NULL if it is not ready.
+ */
+static RingQueueSlot* RingQueue_PeekFront(RingQueue* queue) {
+    uint32_t position = queue->dequeuePosition;
+    RingQueueSlot* slot = &queue->slots[position & queue->mask];
+    uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+    if ((int32_t)(sequence - (position + 1)) < 0) {
+        return NULL;
+    }
+    return slot;
+}
+
+/**
+ * @brief Takes the data out of the head slot and hands the slot back to the producers.
+ */
+static void RingQueue_ConsumeFront(RingQueue* queue, RingQueueSlot* slot, void** data, uint32_t* dataSize) {
+    *data = slot->data;
+    *dataSize = slot->dataSize;
+
+    __atomic_store_n(&slot->sequence, queue->dequeuePosition + queue->mask + 1, __ATOMIC_RELEASE);
+    ++queue->dequeuePosition;
+    __atomic_sub_fetch(&queue->numberOfElements, 1, __ATOMIC_RELAXED);
+
+    MemoryMonitor_Release(RingQueue_CalculateItemSize(*dataSize));
+}
+
+QueueResultValues RingQueue_Init(RingQueue* queue, uint32_t capacity, bool shouldSendLogs) {
+    uint32_t slotsCount = RingQueue_RoundUpToPowerOfTwo(capacity);
+    if (capacity == 0 || slotsCount == 0) {
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    queue->slots = (RingQueueSlot*)malloc(slotsCount * sizeof(RingQueueSlot));
+    if (queue->slots == NULL) {
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    for (uint32_t i = 0; i < slotsCount; ++i) {
+        queue->slots[i].sequence = i;
+        queue->slots[i].data = NULL;
+        queue->slots[i].dataSize = 0;
+    }
+
+    queue->mask = slotsCount - 1;
+    queue->enqueuePosition = 0;
+    queue->dequeuePosition = 0;
+    queue->numberOfElements = 0;
+    queue->shouldSendLogs = shouldSendLogs;
+
+    if (!AgentTelemetryCounter_Init(&queue->counter)) {
+        free(queue->slots);
+        queue->slots = NULL;
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    return QUEUE_OK;
+}
+
+void RingQueue_Deinit(RingQueue* queue) {
+    AgentTelemetryCounter_Deinit(&queue->counter);
+
+    void* currentData;
+    uint32_t currentDataSize;
+    while (RingQueue_PopFront(queue, &currentData, &currentDataSize) == QUEUE_OK) {
+        free(currentData);
+    }
+
+    free(queue->slots);
+    queue->slots = NULL;
+}
+
+QueueResultValues RingQueue_PushBack(RingQueue* queue, void* data, uint32_t dataSize) {
+    int result = QUEUE_OK;
+    bool memoryConsumed = false;
+
+    result = MemoryMonitor_Consume(RingQueue_CalculateItemSize(dataSize));
+    if (result != MEMORY_MONITOR_OK) {
+        if (result == MEMORY_MONITOR_MEMORY_EXCEEDED) {
+            if (queue->shouldSendLogs) {
+                Logger_Information("Max cache size exceeded");
+            }
+            result = QUEUE_MAX_MEMORY_EXCEEDED;
+            AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+        } else {
+            if (queue->shouldSendLogs) {
+                Logger_Error("critical memory exception");
+            }
+            result = QUEUE_MEMORY_EXCEPTION;
+        }
+        goto cleanup;
+    }
+    memoryConsumed = true;
+
+    RingQueueSlot* slot = NULL;
+    uint32_t position = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_RELAXED);
+    while (slot == NULL) {
+        RingQueueSlot* candidate = &queue->slots[position & queue->mask];
+        uint32_t sequence = __atomic_load_n(&candidate->sequence, __ATOMIC_ACQUIRE);
+        int32_t difference = (int32_t)(sequence - position);
+
+        if (difference == 0) {
+            // the slot is free, try to claim it. on failure position is reloaded with the current value
+            if (__atomic_compare_exchange_n(&queue->enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot = candidate;
+            }
+        } else if (difference < 0) {
+            // the consumer did not free this slot yet, the ring is full
+            if (queue->shouldSendLogs) {
+                Logger_Information("Max queue capacity exceeded");
+            }
+            result = QUEUE_MAX_MEMORY_EXCEEDED;
+            AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+            goto cleanup;
+        } else {
+            // another producer claimed this position
+            position = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+
+    // count the element before publishing it so the consumer never sees the counter go below zero
+    __atomic_add_fetch(&queue->numberOfElements, 1, __ATOMIC_RELAXED);
+    slot->data = data;
+    slot->dataSize = dataSize;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+
+cleanup:
+    if (result != QUEUE_OK) {
+        if (memoryConsumed) {
+            MemoryMonitor_Release(RingQueue_CalculateItemSize(dataSize));
+        }
+    }
+
+    AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.collected, 1);
+    return result;
+}
+
+QueueResultValues RingQueue_PopFront(RingQueue* queue, void** data, uint32_t* dataSize) {
+    RingQueueSlot* slot = RingQueue_PeekFront(queue);
+    if (slot == NULL) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    RingQueue_ConsumeFront(queue, slot, data, dataSize);
+    return QUEUE_OK;
+}
+
+QueueResultValues RingQueue_PopFrontIf(RingQueue* queue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+    RingQueueSlot* slot = RingQueue_PeekFront(queue);
+    if (slot == NULL) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    if (!condition(slot->data, slot->dataSize, conditionParams)) {
+        return QUEUE_CONDITION_FAILED;
+    }
+
+    RingQueue_ConsumeFront(queue, slot, data, dataSize);
+    return QUEUE_OK;
+}
+
+QueueResultValues RingQueue_GetSize(RingQueue* queue, uint32_t* size) {
+    *size = __atomic_load_n(&queue->numberOfElements, __ATOMIC_RELAXED);
+    return QUEUE_OK;
+}
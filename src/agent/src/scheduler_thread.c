@@ -17,9 +17,14 @@
 static int SchedulerThread_MainFunc(void* params);
 
 bool SchedulerThread_Init(SchedulerThread* scheduler, uint32_t schedulerInterval, SchedulerTask task, void* taskParam) {
+    return SchedulerThread_InitWithWait(scheduler, schedulerInterval, task, NULL, taskParam);
+}
+
+bool SchedulerThread_InitWithWait(SchedulerThread* scheduler, uint32_t schedulerInterval, SchedulerTask task, SchedulerWait wait, void* taskParam) {
     scheduler->threadHandle = NULL;
     scheduler->schedulerInterval = schedulerInterval;
     scheduler->task = task;
+    scheduler->wait = wait;
     scheduler->taskParam = taskParam;
     scheduler->continueRunning = true;
     scheduler->state = SCHEDULER_THREAD_CREATED;
@@ -53,7 +58,11 @@ static int SchedulerThread_MainFunc(void* params) {
     while(scheduler->continueRunning) {
         Logger_SetCorrelation();
         scheduler->task(scheduler->taskParam);
-        ThreadAPI_Sleep(scheduler->schedulerInterval);
+        if (scheduler->wait != NULL) {
+            scheduler->wait(scheduler->taskParam, scheduler->schedulerInterval);
+        } else {
+            ThreadAPI_Sleep(scheduler->schedulerInterval);
+        }
     }
 
     scheduler->state = SCHEDULER_THREAD_STOPPED;
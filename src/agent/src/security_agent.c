@@ -3,14 +3,24 @@
 
 #include "security_agent.h"
 
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "os_utils/system_logger.h"
 #include "agent_telemetry_provider.h"
+#include "consts.h"
 #include "iothub.h"
 #include "iothub_adapter.h"
 #include "local_config.h"
 #include "logger.h"
 #include "memory_monitor.h"
+#include "os_utils/linux/audit/audit_stream.h"
 #include "os_utils/process_info_handler.h"
+#include "os_utils/spill_log.h"
+#include "parson.h"
+#include "slab_allocator.h"
+#include "tracked_allocator.h"
 #include "twin_configuration.h"
 
 /**
@@ -26,10 +36,60 @@ void SecurityAgent_DeinitQueue(SyncQueue* queue, bool queueInitiated);
  * 
  * @param   queue               The queue to initiate.
  * @param   queueInitiated      Out param. A falg which indicates whether the queue was initiated.
+ * @param   shouldSendLogs      Whether the queue should send out logs.
+ * @param   backend             The data structure backing the queue.
+ * @param   capacity            The maximal number of elements, only used by bounded backends.
  * 
  * @return true upon successful queue initialization, false otherwise.
  */
-bool SecurityAgent_InitQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs);
+bool SecurityAgent_InitQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs, SyncQueueBackend backend, uint32_t capacity);
+
+/**
+ * @brief Initiate a spill log in a sub directory of the configured spill log directory and attach it to the given queue.
+ *        The agent keeps running without the spill log if it could not be initiated.
+ * 
+ * @param   queue               The queue to attach the spill log to.
+ * @param   spillLog            The spill log to initiate.
+ * @param   spillLogInitiated   Out param. A flag which indicates whether the spill log was initiated.
+ * @param   name                The name of the sub directory.
+ * @param   diskQuota           The disk quota of the spill log in bytes.
+ */
+void SecurityAgent_InitSpillLog(SyncQueue* queue, SpillLog* spillLog, bool* spillLogInitiated, const char* name, uint32_t diskQuota);
+
+/**
+ * @brief Deinitiate the given spill log only if the initiated flag is on.
+ * 
+ * @param   spillLog            The spill log to deinitiate.
+ * @param   spillLogInitiated   A flag which indicates whether the spill log was initiated.
+ */
+void SecurityAgent_DeinitSpillLog(SpillLog* spillLog, bool spillLogInitiated);
+
+/**
+ * @brief Reserve memory for the given queue. The queue uses the shared memory if the reservation does not fit.
+ * 
+ * @param   queue           The queue.
+ * @param   budget          The budget to initiate.
+ * @param   budgetInitiated Out param. A flag which indicates whether the budget was initiated.
+ * @param   reservedPercent The share of the max cache size to reserve, in percents.
+ */
+void SecurityAgent_InitMemoryBudget(SyncQueue* queue, MemoryBudget* budget, bool* budgetInitiated, uint32_t reservedPercent);
+
+/**
+ * @brief Deinitiate the given memory budget only if the initiated flag is on.
+ * 
+ * @param   budget          The budget to deinitiate.
+ * @param   budgetInitiated A flag which indicates whether the budget was initiated.
+ */
+void SecurityAgent_DeinitMemoryBudget(MemoryBudget* budget, bool budgetInitiated);
+
+/**
+ * @brief Initiate the eviction policy and add the given queues to it.
+ * 
+ * @param   agent    The agent instance,
+ * 
+ * @return true upon successful initialization, false otherwise.
+ */
+bool SecurityAgent_InitEvictionPolicy(SecurityAgent* agent);
 
 /**
  * @brief Initiate all the queues of the agent.
@@ -66,7 +126,46 @@ bool SecurityAgent_ConnectAndUpdateConfiguration(SecurityAgent* agent);
  * 
  * @return ture if the thread was created and started, false otherwise.
  */
-bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, void* taskParam);
+bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, SchedulerWait waitFunction, void* taskParam);
+
+/**
+ * @brief Starts the thread of the event loop, after the timers of the tasks were added to it.
+ * 
+ * @param   agent    The agent instance,
+ * 
+ * @return ture if the thread was created and started, false otherwise.
+ */
+bool SecurityAgent_StartEventLoop(SecurityAgent* agent);
+
+/**
+ * @brief Stops the event loop and waits for its thread, if it was started.
+ * 
+ * @param   agent    The agent instance,
+ */
+void SecurityAgent_StopEventLoop(SecurityAgent* agent);
+
+/**
+ * @brief The main function of the event loop thread.
+ * 
+ * @param   params  The event loop.
+ * 
+ * @return always 0.
+ */
+static int SecurityAgent_EventLoopMainFunc(void* params);
+
+/**
+ * @brief Allocates memory for parson, charged to the json documents.
+ */
+static void* SecurityAgent_JsonMalloc(size_t size) {
+    return TrackedAllocator_Malloc(ALLOCATION_TAG_JSON, size);
+}
+
+/**
+ * @brief Frees memory which was allocated by SecurityAgent_JsonMalloc.
+ */
+static void SecurityAgent_JsonFree(void* ptr) {
+    TrackedAllocator_Free(ALLOCATION_TAG_JSON, ptr);
+}
 
 bool SecurityAgent_Init(SecurityAgent* agent) {
     bool success = true;
@@ -99,6 +198,15 @@ bool SecurityAgent_Init(SecurityAgent* agent) {
     }
     agent->memoryMonitorInitiated = true;
 
+    // the json documents, e.g. the ones held by the event aggregators, are charged to the memory limit
+    json_set_allocation_functions(SecurityAgent_JsonMalloc, SecurityAgent_JsonFree);
+
+    if (!SlabAllocator_Init()) {
+        success = false;
+        goto cleanup;
+    }
+    agent->slabAllocatorInitiated = true;
+
     if (TwinConfiguration_Init() != TWIN_OK) {
         success = false;
         goto cleanup;
@@ -123,7 +231,7 @@ bool SecurityAgent_Init(SecurityAgent* agent) {
     agent->diagnosticEventCollectorInitiated = true;
     Logger_SetCorrelation();
 
-    if (AgentTelemetryProvider_Init(&agent->queues.lowPriorityEventQueue.queue.counter, &agent->queues.highPriorityEventQueue.queue.counter, &agent->iothubAdapter.messageCounter) != TELEMETRY_PROVIDER_OK){
+    if (AgentTelemetryProvider_Init(SyncQueue_GetCounter(&agent->queues.lowPriorityEventQueue), SyncQueue_GetCounter(&agent->queues.highPriorityEventQueue), &agent->iothubAdapter.messageCounter, EvictionPolicy_GetCounter(&agent->queues.evictionPolicy)) != TELEMETRY_PROVIDER_OK){
         success = false;
         goto cleanup;
     }
@@ -143,23 +251,38 @@ cleanup:
 
 void SecurityAgent_Deinit(SecurityAgent* agent) {
 
+    // all threads are stopped before any task is deinitiated, since the tasks notify the publisher on each push
+    if (agent->asyncPublisherTask.taskInitiated) {
+        EventPublisherTask_Wake(&agent->publisherTask);
+    }
     SecurityAgent_StopAsyncTask(&agent->asyncPublisherTask);
+    SecurityAgent_StopEventLoop(agent);
+
+    // destroying the module client confirms the messages which are still in flight to the send pipeline of the publisher,
+    // so the adapter goes before the publisher
+    if (agent->iothubAdapterInitiated) {
+        IoTHubAdapter_Deinit(&agent->iothubAdapter);
+    }
+
     if (agent->asyncPublisherTask.taskInitiated) {
         EventPublisherTask_Deinit(&agent->publisherTask);
     }
 
-    SecurityAgent_StopAsyncTask(&agent->asyncMonitorTask);
-    if (agent->asyncMonitorTask.taskInitiated) {
+    if (agent->monitorTaskInitiated) {
         EventMonitorTask_Deinit(&agent->monitorTask);
     }
 
-    SecurityAgent_StopAsyncTask(&agent->asyncUpdateTwinTask);
-    if (agent->asyncUpdateTwinTask.taskInitiated) {
+    // the collectors are done, so nothing takes events from the stream anymore
+    if (agent->auditStreamInitiated) {
+        AuditStream_Deinit();
+    }
+
+    if (agent->updateTwinTaskInitiated) {
         UpdateTwinTask_Deinit(&agent->updateTwinTask);
     }
 
-    if (agent->iothubAdapterInitiated) {
-        IoTHubAdapter_Deinit(&agent->iothubAdapter);
+    if (agent->eventLoopInitiated) {
+        EventLoop_Deinit(&agent->eventLoop);
     }
 
     if (agent->twinConfigurationInitiated) {
@@ -177,7 +300,25 @@ void SecurityAgent_Deinit(SecurityAgent* agent) {
     SecurityAgent_DeinitQueue(&agent->queues.operationalEventsQueue, agent->queues.operationalEventsQueueInitiated);
     SecurityAgent_DeinitQueue(&agent->queues.diagnosticEventQueue, agent->queues.diagnosticEventQueueInitiated);
 
+    // the queues append the events they still hold to their spill logs on deinit
+    SecurityAgent_DeinitSpillLog(&agent->queues.highPrioritySpillLog, agent->queues.highPrioritySpillLogInitiated);
+    SecurityAgent_DeinitSpillLog(&agent->queues.lowPrioritySpillLog, agent->queues.lowPrioritySpillLogInitiated);
+
+    if (agent->queues.evictionPolicyInitiated) {
+        EvictionPolicy_Deinit(&agent->queues.evictionPolicy);
+    }
+
+    // the queues release the memory of their events on deinit
+    SecurityAgent_DeinitMemoryBudget(&agent->queues.highPriorityMemoryBudget, agent->queues.highPriorityMemoryBudgetInitiated);
+    SecurityAgent_DeinitMemoryBudget(&agent->queues.lowPriorityMemoryBudget, agent->queues.lowPriorityMemoryBudgetInitiated);
+
+    // the queues may still hold pooled blocks, release the slabs only after they are drained
+    if (agent->slabAllocatorInitiated) {
+        SlabAllocator_Deinit();
+    }
+
     if (agent->memoryMonitorInitiated) {
+        json_set_allocation_functions(malloc, free);
         MemoryMonitor_Deinit();
     }
 
@@ -199,7 +340,7 @@ bool SecurityAgent_Start(SecurityAgent* agent) {
     if (!UpdateTwinTask_Init(&agent->updateTwinTask, &agent->queues.twinUpdatesQueue, &agent->iothubAdapter)) {
         return false;
     }
-    agent->asyncUpdateTwinTask.taskInitiated = true;
+    agent->updateTwinTaskInitiated = true;
 
     if (!SecurityAgent_ConnectAndUpdateConfiguration(agent)) {
         return false;
@@ -210,20 +351,39 @@ bool SecurityAgent_Start(SecurityAgent* agent) {
         return false;
     }
     agent->asyncPublisherTask.taskInitiated = true;
-    if (!SecurityAgent_StartAsyncTask(&agent->asyncPublisherTask, SCHEDULER_INTERVAL, (SchedulerTask)EventPublisherTask_Execute, &agent->publisherTask)) {
+    if (!SecurityAgent_StartAsyncTask(&agent->asyncPublisherTask, SCHEDULER_INTERVAL, (SchedulerTask)EventPublisherTask_Execute, (SchedulerWait)EventPublisherTask_Wait, &agent->publisherTask)) {
         return false;
     }
 
-    // init & start event monitor
+    // init event monitor
     if (!EventMonitorTask_Init(&agent->monitorTask, &agent->queues.highPriorityEventQueue, &agent->queues.lowPriorityEventQueue, &agent->queues.operationalEventsQueue)) {
         return false;
     }
-    if (!SecurityAgent_StartAsyncTask(&agent->asyncMonitorTask, SCHEDULER_INTERVAL, (SchedulerTask)EventMonitorTask_Execute, &agent->monitorTask)) {
+    agent->monitorTaskInitiated = true;
+
+    // start event monitor & twin updater
+    if (!EventLoop_Init(&agent->eventLoop)) {
+        return false;
+    }
+    agent->eventLoopInitiated = true;
+    if (!EventLoop_AddTimer(&agent->eventLoop, SCHEDULER_INTERVAL, (EventLoopHandler)EventMonitorTask_Execute, &agent->monitorTask)) {
         return false;
     }
+    if (!EventLoop_AddTimer(&agent->eventLoop, TWIN_UPDATE_SCHEDULER_INTERVAL, (EventLoopHandler)UpdateTwinTask_Execute, &agent->updateTwinTask)) {
+        return false;
+    }
+
+    // the stream notifies the monitor on the thread of the loop, so the monitor needs no lock
+    if (AuditStream_Init(EventMonitorTask_OnAuditEvents, &agent->monitorTask)) {
+        agent->auditStreamInitiated = true;
+        if (!EventLoop_AddFd(&agent->eventLoop, AuditStream_GetFd(), AuditStream_OnReadable, NULL)) {
+            return false;
+        }
+    } else {
+        Logger_Warning("Could not initiate the audit stream, the audit logs are searched on the triggered interval");
+    }
 
-    // start twin updater
-    if (!SecurityAgent_StartAsyncTask(&agent->asyncUpdateTwinTask, TWIN_UPDATE_SCHEDULER_INTERVAL, (SchedulerTask)UpdateTwinTask_Execute, &agent->updateTwinTask)) {
+    if (!SecurityAgent_StartEventLoop(agent)) {
         return false;
     }
     Logger_Information("ASC for IoT Agent initialized!");
@@ -233,20 +393,22 @@ bool SecurityAgent_Start(SecurityAgent* agent) {
 void SecurityAgent_Wait(SecurityAgent* agent) {
     int result;
     ThreadAPI_Join(agent->asyncPublisherTask.taskThread.threadHandle, &result);
-    ThreadAPI_Join(agent->asyncMonitorTask.taskThread.threadHandle, &result);
-    SchedulerThread_Stop(&agent->asyncUpdateTwinTask.taskThread);
-    ThreadAPI_Join(agent->asyncUpdateTwinTask.taskThread.threadHandle, &result);
+    SecurityAgent_StopEventLoop(agent);
 }
 
 void SecurityAgent_Stop(SecurityAgent* agent) {
     SchedulerThread_Stop(&agent->asyncPublisherTask.taskThread);
-    SchedulerThread_Stop(&agent->asyncMonitorTask.taskThread);
+    // the publisher may be blocked until its next deadline
+    EventPublisherTask_Wake(&agent->publisherTask);
+    // the loop returns once the handler it runs returns, without waiting for the next deadline
+    SecurityAgent_StopEventLoop(agent);
 
     SecurityAgent_Wait(agent);
 }
 
-bool SecurityAgent_InitQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs) {
-    if (SyncQueue_Init(queue, shouldSendLogs) != QUEUE_OK) {
+bool SecurityAgent_InitQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs, SyncQueueBackend backend, uint32_t capacity) {
+    int result = (backend == SYNC_QUEUE_BACKEND_RING) ? SyncQueue_InitRing(queue, shouldSendLogs, capacity) : SyncQueue_Init(queue, shouldSendLogs);
+    if (result != QUEUE_OK) {
         return false;
     }
     *queueInitiated = true;
@@ -260,29 +422,105 @@ void SecurityAgent_DeinitQueue(SyncQueue* queue, bool queueInitiated) {
 }
 
 bool SecurityAgent_InitAllQueues(SecurityAgent* agent) {
-    if (!SecurityAgent_InitQueue(&agent->queues.diagnosticEventQueue, &agent->queues.diagnosticEventQueueInitiated, false)) {
+    // diagnostic events are pushed by the logger from every thread and drained only by the monitor task
+    if (!SecurityAgent_InitQueue(&agent->queues.diagnosticEventQueue, &agent->queues.diagnosticEventQueueInitiated, false, SYNC_QUEUE_BACKEND_RING, DIAGNOSTIC_EVENT_QUEUE_CAPACITY)) {
         return false;
     }
 
-    if (!SecurityAgent_InitQueue(&agent->queues.operationalEventsQueue, &agent->queues.operationalEventsQueueInitiated, true)) {
+    if (!SecurityAgent_InitQueue(&agent->queues.operationalEventsQueue, &agent->queues.operationalEventsQueueInitiated, true, SYNC_QUEUE_BACKEND_LIST, 0)) {
         return false;
     }
 
-    if (!SecurityAgent_InitQueue(&agent->queues.highPriorityEventQueue, &agent->queues.highPriorityEventQueueInitiated, true)) {
+    if (!SecurityAgent_InitQueue(&agent->queues.highPriorityEventQueue, &agent->queues.highPriorityEventQueueInitiated, true, SYNC_QUEUE_BACKEND_LIST, 0)) {
         return false;
     }
 
-    if (!SecurityAgent_InitQueue(&agent->queues.lowPriorityEventQueue, &agent->queues.lowPriorityEventQueueInitiated, true)) {
+    if (!SecurityAgent_InitQueue(&agent->queues.lowPriorityEventQueue, &agent->queues.lowPriorityEventQueueInitiated, true, SYNC_QUEUE_BACKEND_LIST, 0)) {
         return false;
     }
 
-    if (!SecurityAgent_InitQueue(&agent->queues.twinUpdatesQueue, &agent->queues.twinUpdatesQueueInitiated, true)) {
+    if (!SecurityAgent_InitQueue(&agent->queues.twinUpdatesQueue, &agent->queues.twinUpdatesQueueInitiated, true, SYNC_QUEUE_BACKEND_LIST, 0)) {
+        return false;
+    }
+
+    // the budgets are set before the spill logs are attached, since attaching a log loads its records
+    SecurityAgent_InitMemoryBudget(&agent->queues.highPriorityEventQueue, &agent->queues.highPriorityMemoryBudget, &agent->queues.highPriorityMemoryBudgetInitiated, HIGH_PRIORITY_QUEUE_RESERVED_MEMORY_PERCENT);
+    SecurityAgent_InitMemoryBudget(&agent->queues.lowPriorityEventQueue, &agent->queues.lowPriorityMemoryBudget, &agent->queues.lowPriorityMemoryBudgetInitiated, LOW_PRIORITY_QUEUE_RESERVED_MEMORY_PERCENT);
+
+    // the security events are kept across connectivity loss and restarts, the quota is split between the two queues
+    uint32_t diskQuota = LocalConfiguration_GetSpillLogDiskQuota() / 2;
+    SecurityAgent_InitSpillLog(&agent->queues.highPriorityEventQueue, &agent->queues.highPrioritySpillLog, &agent->queues.highPrioritySpillLogInitiated, "high", diskQuota);
+    SecurityAgent_InitSpillLog(&agent->queues.lowPriorityEventQueue, &agent->queues.lowPrioritySpillLog, &agent->queues.lowPrioritySpillLogInitiated, "low", diskQuota);
+
+    return SecurityAgent_InitEvictionPolicy(agent);
+}
+
+bool SecurityAgent_InitEvictionPolicy(SecurityAgent* agent) {
+    if (!EvictionPolicy_Init(&agent->queues.evictionPolicy)) {
+        return false;
+    }
+    agent->queues.evictionPolicyInitiated = true;
+
+    // the diagnostic events are bounded by the capacity of their ring, so they are not part of the policy
+    if (!EvictionPolicy_AddQueue(&agent->queues.evictionPolicy, &agent->queues.lowPriorityEventQueue, QUEUE_PRIORITY_LOW) ||
+        !EvictionPolicy_AddQueue(&agent->queues.evictionPolicy, &agent->queues.highPriorityEventQueue, QUEUE_PRIORITY_HIGH) ||
+        !EvictionPolicy_AddQueue(&agent->queues.evictionPolicy, &agent->queues.operationalEventsQueue, QUEUE_PRIORITY_HIGH) ||
+        !EvictionPolicy_AddQueue(&agent->queues.evictionPolicy, &agent->queues.twinUpdatesQueue, QUEUE_PRIORITY_PROTECTED)) {
         return false;
     }
 
     return true;
 }
 
+void SecurityAgent_InitMemoryBudget(SyncQueue* queue, MemoryBudget* budget, bool* budgetInitiated, uint32_t reservedPercent) {
+    if (MemoryMonitor_InitBudget(budget, reservedPercent) != MEMORY_MONITOR_OK) {
+        Logger_Information("The reservations of the queues exceed the max cache size, the queue uses the shared memory");
+        return;
+    }
+    *budgetInitiated = true;
+
+    if (!SyncQueue_SetMemoryBudget(queue, budget)) {
+        Logger_Error("Failed to set the memory budget of the queue");
+    }
+}
+
+void SecurityAgent_DeinitMemoryBudget(MemoryBudget* budget, bool budgetInitiated) {
+    if (budgetInitiated) {
+        MemoryMonitor_DeinitBudget(budget);
+    }
+}
+
+void SecurityAgent_InitSpillLog(SyncQueue* queue, SpillLog* spillLog, bool* spillLogInitiated, const char* name, uint32_t diskQuota) {
+    if (diskQuota < SPILL_LOG_SEGMENT_SIZE) {
+        Logger_Warning("Spill log quota is smaller than a single segment, events which exceed the max cache size are dropped");
+        return;
+    }
+
+    char directory[PATH_MAX];
+    int length = snprintf(directory, sizeof(directory), "%s/%s", LocalConfiguration_GetSpillLogDirectory(), name);
+    if (length < 0 || length >= (int)sizeof(directory)) {
+        Logger_Warning("Spill log directory path is too long, events which exceed the max cache size are dropped");
+        return;
+    }
+
+    if (SpillLog_Init(spillLog, directory, diskQuota) != SPILL_LOG_OK) {
+        // the agent runs as its own user by now, so the directory must be writable by that user
+        Logger_Warning("Failed to initiate the spill log in %s, events which exceed the max cache size are dropped", directory);
+        return;
+    }
+    *spillLogInitiated = true;
+
+    if (!SyncQueue_SetSpillLog(queue, spillLog)) {
+        Logger_Warning("Failed to attach the spill log in %s, events which exceed the max cache size are dropped", directory);
+    }
+}
+
+void SecurityAgent_DeinitSpillLog(SpillLog* spillLog, bool spillLogInitiated) {
+    if (spillLogInitiated) {
+        SpillLog_Deinit(spillLog);
+    }
+}
+
 bool SecurityAgent_ConnectAndUpdateConfiguration(SecurityAgent* agent) {
     bool success = true;
 
@@ -309,8 +547,8 @@ cleanup:
     return success;
 }
 
-bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, void* taskParam) {
-    if (!SchedulerThread_Init(&asyncTask->taskThread, interval, taskFunction, taskParam)) {
+bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, SchedulerWait waitFunction, void* taskParam) {
+    if (!SchedulerThread_InitWithWait(&asyncTask->taskThread, interval, taskFunction, waitFunction, taskParam)) {
         return false;
     }
     asyncTask->taskThreadInitiated = true;
@@ -323,6 +561,32 @@ bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t in
     return true;
 }
 
+bool SecurityAgent_StartEventLoop(SecurityAgent* agent) {
+    if (ThreadAPI_Create(&agent->eventLoopThread, SecurityAgent_EventLoopMainFunc, &agent->eventLoop) != THREADAPI_OK) {
+        Logger_Error("Error starting thread");
+        agent->eventLoopThread = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void SecurityAgent_StopEventLoop(SecurityAgent* agent) {
+    if (agent->eventLoopThread != NULL) {
+        EventLoop_Stop(&agent->eventLoop);
+        int result;
+        ThreadAPI_Join(agent->eventLoopThread, &result);
+        agent->eventLoopThread = NULL;
+    }
+}
+
+static int SecurityAgent_EventLoopMainFunc(void* params) {
+    if (!EventLoop_Run((EventLoop*)params)) {
+        Logger_Error("The event loop failed, the monitor and the twin updater stopped");
+    }
+    return 0;
+}
+
 void SecurityAgent_StopAsyncTask(SecurityAgentAsyncTask* asyncTask) {
     if (asyncTask->taskThreadInitiated) {
         if (SchedulerThread_GetState(&asyncTask->taskThread) == SCHEDULER_THREAD_STARTED) {
@@ -0,0 +1,236 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "send_pipeline.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "consts.h"
+#include "internal/time_utils.h"
+#include "internal/time_utils_consts.h"
+#include "logger.h"
+
+/**
+ * @brief Hands the message of a slot which is marked in flight to the hub, the slot is marked for a retry if the hub does not take it.
+ *        The lock must not be held, the confirmation may arrive before the adapter returns.
+ *
+ * @param   pipeline    The pipeline.
+ * @param   slot        The slot to send.
+ *
+ * @return true if the hub took the message, false otherwise.
+ */
+static bool SendPipeline_SendSlot(SendPipeline* pipeline, SendPipelineSlot* slot);
+
+/**
+ * @brief Called by the adapter once the hub confirms a message, or fails to deliver it.
+ *
+ * @param   confirmed   Whether the hub received the message.
+ * @param   context     The slot of the message.
+ */
+static void SendPipeline_ConfirmationCallback(bool confirmed, void* context);
+
+/**
+ * @brief Marks a slot whose message failed for a retry, or drops the message once it failed SEND_MAX_ATTEMPTS times.
+ *        The lock must be held.
+ *
+ * @param   slot            The slot which failed.
+ * @param   currentTime     The time of the failure.
+ */
+static void SendPipeline_FailSlot(SendPipelineSlot* slot, time_t currentTime);
+
+/**
+ * @brief Frees the message of a slot and marks it free. The lock must be held.
+ *
+ * @param   slot    The slot to release.
+ */
+static void SendPipeline_ReleaseSlot(SendPipelineSlot* slot);
+
+bool SendPipeline_Init(SendPipeline* pipeline, IoTHubAdapter* iothubAdapter) {
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->iothubAdapter = iothubAdapter;
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        pipeline->slots[i].pipeline = pipeline;
+    }
+
+    pipeline->lock = Lock_Init();
+    return pipeline->lock != NULL;
+}
+
+void SendPipeline_Deinit(SendPipeline* pipeline) {
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        SendPipeline_ReleaseSlot(&pipeline->slots[i]);
+    }
+
+    if (pipeline->lock != NULL) {
+        Lock_Deinit(pipeline->lock);
+    }
+
+    memset(pipeline, 0, sizeof(*pipeline));
+}
+
+bool SendPipeline_HasRoom(SendPipeline* pipeline, uint32_t window) {
+    if (window == 0) {
+        window = 1;
+    } else if (window > SEND_PIPELINE_MAX_WINDOW) {
+        window = SEND_PIPELINE_MAX_WINDOW;
+    }
+
+    if (Lock(pipeline->lock) != LOCK_OK) {
+        return false;
+    }
+
+    uint32_t taken = 0;
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        if (pipeline->slots[i].state != SEND_PIPELINE_SLOT_FREE) {
+            ++taken;
+        }
+    }
+
+    Unlock(pipeline->lock);
+    return taken < window;
+}
+
+SendPipelineResult SendPipeline_Send(SendPipeline* pipeline, void* buffer, uint32_t size, const char* contentType, const char* contentEncoding) {
+    if (Lock(pipeline->lock) != LOCK_OK) {
+        return SEND_PIPELINE_EXCEPTION;
+    }
+
+    SendPipelineSlot* slot = NULL;
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        if (pipeline->slots[i].state == SEND_PIPELINE_SLOT_FREE) {
+            slot = &pipeline->slots[i];
+            break;
+        }
+    }
+
+    if (slot != NULL) {
+        slot->buffer = buffer;
+        slot->size = size;
+        slot->contentType = contentType;
+        slot->contentEncoding = contentEncoding;
+        slot->state = SEND_PIPELINE_SLOT_IN_FLIGHT;
+        slot->attempts = 1;
+    }
+
+    Unlock(pipeline->lock);
+
+    if (slot == NULL) {
+        return SEND_PIPELINE_FULL;
+    }
+
+    return SendPipeline_SendSlot(pipeline, slot) ? SEND_PIPELINE_OK : SEND_PIPELINE_DEFERRED;
+}
+
+void SendPipeline_Retry(SendPipeline* pipeline, time_t currentTime) {
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        SendPipelineSlot* slot = &pipeline->slots[i];
+        if (Lock(pipeline->lock) != LOCK_OK) {
+            return;
+        }
+
+        bool due = slot->state == SEND_PIPELINE_SLOT_RETRY && TimeUtils_GetTimeDiff(currentTime, slot->retryTime) >= 0;
+        if (due) {
+            slot->state = SEND_PIPELINE_SLOT_IN_FLIGHT;
+            ++slot->attempts;
+        }
+
+        Unlock(pipeline->lock);
+
+        // while the hub does not take messages the rest of the due messages wait for the next retry
+        if (due && !SendPipeline_SendSlot(pipeline, slot)) {
+            return;
+        }
+    }
+}
+
+uint32_t SendPipeline_GetRetryTimeout(SendPipeline* pipeline, time_t currentTime) {
+    uint32_t timeout = UINT32_MAX;
+    if (Lock(pipeline->lock) != LOCK_OK) {
+        return timeout;
+    }
+
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        if (pipeline->slots[i].state != SEND_PIPELINE_SLOT_RETRY) {
+            continue;
+        }
+
+        int32_t timeLeft = TimeUtils_GetTimeDiff(pipeline->slots[i].retryTime, currentTime);
+        uint32_t slotTimeout = timeLeft < 0 ? 0 : (uint32_t)timeLeft;
+        if (slotTimeout < timeout) {
+            timeout = slotTimeout;
+        }
+    }
+
+    Unlock(pipeline->lock);
+    return timeout;
+}
+
+static bool SendPipeline_SendSlot(SendPipeline* pipeline, SendPipelineSlot* slot) {
+    if (IoTHubAdapter_SendMessageWithConfirmationAsync(pipeline->iothubAdapter, slot->buffer, slot->size, slot->contentType, slot->contentEncoding, SendPipeline_ConfirmationCallback, slot)) {
+        return true;
+    }
+
+    Logger_Error("error sending a message to the hub");
+    // no confirmation arrives for a message the adapter did not take
+    time_t currentTime = TimeUtils_GetCurrentTime();
+    if (Lock(pipeline->lock) != LOCK_OK) {
+        Logger_Error("Could not lock the send pipeline, the message is kept until the pipeline is deinitiated");
+        return false;
+    }
+
+    SendPipeline_FailSlot(slot, currentTime);
+    Unlock(pipeline->lock);
+    return false;
+}
+
+static void SendPipeline_ConfirmationCallback(bool confirmed, void* context) {
+    SendPipelineSlot* slot = (SendPipelineSlot*)context;
+    time_t currentTime = confirmed ? 0 : TimeUtils_GetCurrentTime();
+
+    if (Lock(slot->pipeline->lock) != LOCK_OK) {
+        Logger_Error("Could not lock the send pipeline, the message is kept until the pipeline is deinitiated");
+        return;
+    }
+
+    if (confirmed) {
+        SendPipeline_ReleaseSlot(slot);
+    } else {
+        SendPipeline_FailSlot(slot, currentTime);
+    }
+
+    Unlock(slot->pipeline->lock);
+}
+
+static void SendPipeline_FailSlot(SendPipelineSlot* slot, time_t currentTime) {
+    if (slot->attempts >= SEND_MAX_ATTEMPTS) {
+        Logger_Error("a message was not delivered after %u attempts, dropping it", slot->attempts);
+        SendPipeline_ReleaseSlot(slot);
+        return;
+    }
+
+    uint32_t interval = SEND_RETRY_INITIAL_INTERVAL;
+    for (uint32_t i = 1; i < slot->attempts && interval < SEND_RETRY_MAX_INTERVAL; ++i) {
+        interval *= 2;
+    }
+    if (interval > SEND_RETRY_MAX_INTERVAL) {
+        interval = SEND_RETRY_MAX_INTERVAL;
+    }
+
+    slot->retryTime = currentTime + (time_t)(interval / MILLISECONDS_IN_A_SECOND);
+    slot->state = SEND_PIPELINE_SLOT_RETRY;
+}
+
+static void SendPipeline_ReleaseSlot(SendPipelineSlot* slot) {
+    if (slot->buffer != NULL) {
+        free(slot->buffer);
+    }
+
+    slot->buffer = NULL;
+    slot->size = 0;
+    slot->contentType = NULL;
+    slot->contentEncoding = NULL;
+    slot->state = SEND_PIPELINE_SLOT_FREE;
+    slot->attempts = 0;
+    slot->retryTime = 0;
+}
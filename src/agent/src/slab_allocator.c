@@ -0,0 +1,316 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "slab_allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "azure_c_shared_utility/lock.h"
+
+#define SLAB_ALLOCATOR_MIN_BLOCK_SIZE 64
+#define SLAB_ALLOCATOR_ADDRESS_SPACE_SIZE ((size_t)SLAB_ALLOCATOR_MAX_SLABS * SLAB_ALLOCATOR_SLAB_SIZE)
+
+/**
+ * A free block, the free list of a slab is threaded through its blocks
+ */
+typedef struct _SlabAllocatorFreeBlock {
+
+    struct _SlabAllocatorFreeBlock* next;
+
+} SlabAllocatorFreeBlock;
+
+typedef struct _SlabAllocatorSlab {
+
+    SlabAllocatorFreeBlock* freeList;
+    uint32_t bumpOffset;                // the blocks from this offset on were never handed out, so their memory was not touched
+    uint32_t usedBlocks;
+    uint32_t classIndex;
+    bool inUse;
+    // the neighbours in the slabs of the class which have free blocks, or the next released slab
+    struct _SlabAllocatorSlab* next;
+    struct _SlabAllocatorSlab* prev;
+
+} SlabAllocatorSlab;
+
+typedef struct _SlabAllocatorClass {
+
+    LOCK_HANDLE lock;
+    SlabAllocatorSlab* partialSlabs;
+
+} SlabAllocatorClass;
+
+typedef struct _SlabAllocator {
+
+    // guards the slabs which do not belong to any class
+    LOCK_HANDLE lock;
+    // the address space of all slabs, fixed from init to deinit so the slab of an address is found without a lock
+    char* base;
+    SlabAllocatorSlab* slabs;
+    uint32_t numberOfSlabs;
+    SlabAllocatorSlab* releasedSlabs;
+    SlabAllocatorClass classes[SLAB_ALLOCATOR_NUMBER_OF_CLASSES];
+
+} SlabAllocator;
+
+static SlabAllocator slabAllocator = { 0 };
+
+static int32_t SlabAllocator_GetClassIndex(uint32_t size) {
+    uint32_t blockSize = SLAB_ALLOCATOR_MIN_BLOCK_SIZE;
+    for (int32_t i = 0; i < SLAB_ALLOCATOR_NUMBER_OF_CLASSES; ++i) {
+        if (size <= blockSize) {
+            return i;
+        }
+        blockSize <<= 1;
+    }
+    return -1;
+}
+
+static uint32_t SlabAllocator_GetClassBlockSize(uint32_t classIndex) {
+    return SLAB_ALLOCATOR_MIN_BLOCK_SIZE << classIndex;
+}
+
+static char* SlabAllocator_GetSlabBase(const SlabAllocatorSlab* slab) {
+    return slabAllocator.base + (size_t)(slab - slabAllocator.slabs) * SLAB_ALLOCATOR_SLAB_SIZE;
+}
+
+/**
+ * @brief Returns the slab which contains the given address, or NULL if the address is outside of the slabs.
+ */
+static SlabAllocatorSlab* SlabAllocator_FindSlab(const void* address) {
+    uintptr_t offset = (uintptr_t)address - (uintptr_t)slabAllocator.base;
+    if ((uintptr_t)address < (uintptr_t)slabAllocator.base || offset >= SLAB_ALLOCATOR_ADDRESS_SPACE_SIZE) {
+        return NULL;
+    }
+    return &slabAllocator.slabs[offset / SLAB_ALLOCATOR_SLAB_SIZE];
+}
+
+static bool SlabAllocator_IsFull(const SlabAllocatorSlab* slab) {
+    return slab->freeList == NULL && slab->bumpOffset + SlabAllocator_GetClassBlockSize(slab->classIndex) > SLAB_ALLOCATOR_SLAB_SIZE;
+}
+
+/**
+ * @brief Links a slab to the slabs of its class which have free blocks. Must be called under the lock of the class.
+ */
+static void SlabAllocator_LinkPartialSlab(SlabAllocatorClass* slabClass, SlabAllocatorSlab* slab) {
+    slab->prev = NULL;
+    slab->next = slabClass->partialSlabs;
+    if (slabClass->partialSlabs != NULL) {
+        slabClass->partialSlabs->prev = slab;
+    }
+    slabClass->partialSlabs = slab;
+}
+
+/**
+ * @brief Unlinks a slab from the slabs of its class which have free blocks. Must be called under the lock of the class.
+ */
+static void SlabAllocator_UnlinkPartialSlab(SlabAllocatorClass* slabClass, SlabAllocatorSlab* slab) {
+    if (slab->prev != NULL) {
+        slab->prev->next = slab->next;
+    } else {
+        slabClass->partialSlabs = slab->next;
+    }
+
+    if (slab->next != NULL) {
+        slab->next->prev = slab->prev;
+    }
+
+    slab->next = NULL;
+    slab->prev = NULL;
+}
+
+/**
+ * @brief Takes a slab which does not belong to any class, a released one before one which was never used.
+ */
+static SlabAllocatorSlab* SlabAllocator_AcquireSlab(uint32_t classIndex) {
+    if (Lock(slabAllocator.lock) != LOCK_OK) {
+        return NULL;
+    }
+
+    SlabAllocatorSlab* slab = slabAllocator.releasedSlabs;
+    if (slab != NULL) {
+        slabAllocator.releasedSlabs = slab->next;
+    } else if (slabAllocator.numberOfSlabs < SLAB_ALLOCATOR_MAX_SLABS) {
+        slab = &slabAllocator.slabs[slabAllocator.numberOfSlabs++];
+    }
+
+    Unlock(slabAllocator.lock);
+
+    if (slab != NULL) {
+        memset(slab, 0, sizeof(*slab));
+        slab->classIndex = classIndex;
+        slab->inUse = true;
+    }
+    return slab;
+}
+
+/**
+ * @brief Returns the memory of an empty slab to the system and makes it available to any class.
+ */
+static void SlabAllocator_ReleaseSlab(SlabAllocatorSlab* slab) {
+    // the pages are zero filled on their next use, only the touched ones are returned
+    (void)madvise(SlabAllocator_GetSlabBase(slab), slab->bumpOffset, MADV_DONTNEED);
+    slab->inUse = false;
+
+    if (Lock(slabAllocator.lock) != LOCK_OK) {
+        // the slab is leaked, its address space is still returned upon deinit
+        return;
+    }
+
+    slab->next = slabAllocator.releasedSlabs;
+    slabAllocator.releasedSlabs = slab;
+
+    Unlock(slabAllocator.lock);
+}
+
+bool SlabAllocator_Init() {
+    memset(&slabAllocator, 0, sizeof(slabAllocator));
+
+    // only the address space is reserved, the pages are committed as they are touched
+    void* base = mmap(NULL, SLAB_ALLOCATOR_ADDRESS_SPACE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        goto cleanup;
+    }
+    slabAllocator.base = base;
+
+    slabAllocator.slabs = calloc(SLAB_ALLOCATOR_MAX_SLABS, sizeof(SlabAllocatorSlab));
+    if (slabAllocator.slabs == NULL) {
+        goto cleanup;
+    }
+
+    slabAllocator.lock = Lock_Init();
+    if (slabAllocator.lock == NULL) {
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < SLAB_ALLOCATOR_NUMBER_OF_CLASSES; ++i) {
+        slabAllocator.classes[i].lock = Lock_Init();
+        if (slabAllocator.classes[i].lock == NULL) {
+            goto cleanup;
+        }
+    }
+
+    return true;
+
+cleanup:
+    SlabAllocator_Deinit();
+    return false;
+}
+
+void SlabAllocator_Deinit() {
+    if (slabAllocator.base != NULL) {
+        munmap(slabAllocator.base, SLAB_ALLOCATOR_ADDRESS_SPACE_SIZE);
+    }
+    free(slabAllocator.slabs);
+
+    if (slabAllocator.lock != NULL) {
+        Lock_Deinit(slabAllocator.lock);
+    }
+
+    for (uint32_t i = 0; i < SLAB_ALLOCATOR_NUMBER_OF_CLASSES; ++i) {
+        if (slabAllocator.classes[i].lock != NULL) {
+            Lock_Deinit(slabAllocator.classes[i].lock);
+        }
+    }
+
+    memset(&slabAllocator, 0, sizeof(slabAllocator));
+}
+
+void* SlabAllocator_Allocate(uint32_t size) {
+    void* result = NULL;
+
+    int32_t classIndex = SlabAllocator_GetClassIndex(size);
+    if (classIndex < 0 || slabAllocator.base == NULL) {
+        return NULL;
+    }
+
+    SlabAllocatorClass* slabClass = &slabAllocator.classes[classIndex];
+    if (Lock(slabClass->lock) != LOCK_OK) {
+        return NULL;
+    }
+
+    SlabAllocatorSlab* slab = slabClass->partialSlabs;
+    if (slab == NULL) {
+        slab = SlabAllocator_AcquireSlab(classIndex);
+        if (slab == NULL) {
+            goto cleanup;
+        }
+        SlabAllocator_LinkPartialSlab(slabClass, slab);
+    }
+
+    if (slab->freeList != NULL) {
+        result = slab->freeList;
+        slab->freeList = slab->freeList->next;
+    } else {
+        result = SlabAllocator_GetSlabBase(slab) + slab->bumpOffset;
+        slab->bumpOffset += SlabAllocator_GetClassBlockSize(classIndex);
+    }
+    ++slab->usedBlocks;
+
+    if (SlabAllocator_IsFull(slab)) {
+        SlabAllocator_UnlinkPartialSlab(slabClass, slab);
+    }
+
+cleanup:
+    Unlock(slabClass->lock);
+    return result;
+}
+
+void SlabAllocator_Free(void* block) {
+    if (block == NULL || slabAllocator.base == NULL) {
+        return;
+    }
+
+    SlabAllocatorSlab* slab = SlabAllocator_FindSlab(block);
+    if (slab == NULL) {
+        return;
+    }
+
+    SlabAllocatorClass* slabClass = &slabAllocator.classes[slab->classIndex];
+    if (Lock(slabClass->lock) != LOCK_OK) {
+        return;
+    }
+
+    if (SlabAllocator_IsFull(slab)) {
+        SlabAllocator_LinkPartialSlab(slabClass, slab);
+    }
+
+    SlabAllocatorFreeBlock* freeBlock = (SlabAllocatorFreeBlock*)block;
+    freeBlock->next = slab->freeList;
+    slab->freeList = freeBlock;
+    --slab->usedBlocks;
+
+    // the last slab with free blocks is kept, so a class which empties and refills does not release and commit a slab every time
+    if (slab->usedBlocks == 0 && (slab->prev != NULL || slab->next != NULL)) {
+        SlabAllocator_UnlinkPartialSlab(slabClass, slab);
+        SlabAllocator_ReleaseSlab(slab);
+    }
+
+    Unlock(slabClass->lock);
+}
+
+bool SlabAllocator_GetBlock(const void* address, void** block, uint32_t* blockSize) {
+    if (slabAllocator.base == NULL) {
+        return false;
+    }
+
+    SlabAllocatorSlab* slab = SlabAllocator_FindSlab(address);
+    if (slab == NULL || !slab->inUse) {
+        return false;
+    }
+
+    uint32_t size = SlabAllocator_GetClassBlockSize(slab->classIndex);
+    uintptr_t offset = ((uintptr_t)address - (uintptr_t)slabAllocator.base) % SLAB_ALLOCATOR_SLAB_SIZE;
+    *block = (char*)address - offset % size;
+    *blockSize = size;
+    return true;
+}
+
+uint32_t SlabAllocator_GetBlockSize(uint32_t size) {
+    int32_t classIndex = SlabAllocator_GetClassIndex(size);
+    if (classIndex < 0) {
+        return 0;
+    }
+    return SlabAllocator_GetClassBlockSize(classIndex);
+}
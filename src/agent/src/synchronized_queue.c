@@ -3,6 +3,9 @@
 #include "synchronized_queue.h"
 
 int SyncQueue_Init(SyncQueue* syncQueue, bool shouldSendLogs) {
+    syncQueue->backend = SYNC_QUEUE_BACKEND_LIST;
+    syncQueue->notifier = NULL;
+    syncQueue->urgent = false;
     QueueResultValues result = Queue_Init(&syncQueue->queue, shouldSendLogs);
     if (result != QUEUE_OK) {
         return result;
@@ -17,7 +20,21 @@ int SyncQueue_Init(SyncQueue* syncQueue, bool shouldSendLogs) {
     return QUEUE_OK;
 }
 
+int SyncQueue_InitRing(SyncQueue* syncQueue, bool shouldSendLogs, uint32_t capacity) {
+    syncQueue->backend = SYNC_QUEUE_BACKEND_RING;
+    syncQueue->notifier = NULL;
+    syncQueue->urgent = false;
+    // the ring is lock free, the lock is never used
+    syncQueue->lock = NULL;
+    return RingQueue_Init(&syncQueue->ring, capacity, shouldSendLogs);
+}
+
 void SyncQueue_Deinit(SyncQueue* syncQueue) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        RingQueue_Deinit(&syncQueue->ring);
+        return;
+    }
+
     Queue_Deinit(&syncQueue->queue);
 
     if (syncQueue->lock != NULL) {
@@ -25,20 +42,62 @@ void SyncQueue_Deinit(SyncQueue* syncQueue) {
     }
 }
 
+/**
+ * @brief Notifies the consumer of the queue about a push, outside of the queue lock so it can pop as soon as it wakes up.
+ */
+static void SyncQueue_NotifyPush(SyncQueue* syncQueue, QueueResultValues result, uint32_t dataSize) {
+    if (result == QUEUE_OK && syncQueue->notifier != NULL) {
+        QueueNotifier_NotifyPush(syncQueue->notifier, dataSize, syncQueue->urgent);
+    }
+}
+
 int SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
-    if (Lock(syncQueue->lock) != LOCK_OK) {
-        return SYNC_QUEUE_LOCK_EXCEPTION;
+    QueueResultValues result = QUEUE_OK;
+
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        result = RingQueue_PushBack(&syncQueue->ring, data, dataSize);
+    } else {
+        if (Lock(syncQueue->lock) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+        
+        result = Queue_PushBack(&syncQueue->queue, data, dataSize);
+                                    
+        if (Unlock(syncQueue->lock) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
     }
-    
-    QueueResultValues result = Queue_PushBack(&syncQueue->queue, data, dataSize);
-                                
-    if (Unlock(syncQueue->lock) != LOCK_OK) {
-        return SYNC_QUEUE_LOCK_EXCEPTION;
+
+    SyncQueue_NotifyPush(syncQueue, result, dataSize);
+    return result;
+}
+
+int SyncQueue_PushBackWithPriority(SyncQueue* syncQueue, void* data, uint32_t dataSize, QueuePriority priority) {
+    QueueResultValues result = QUEUE_OK;
+
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        result = RingQueue_PushBack(&syncQueue->ring, data, dataSize);
+    } else {
+        if (Lock(syncQueue->lock) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+        
+        result = Queue_PushBackWithPriority(&syncQueue->queue, data, dataSize, priority);
+                                    
+        if (Unlock(syncQueue->lock) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
     }
+
+    SyncQueue_NotifyPush(syncQueue, result, dataSize);
     return result;
 }
 
 int SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataSize) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return RingQueue_PopFront(&syncQueue->ring, data, dataSize);
+    }
+
     if (Lock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }          
@@ -52,6 +111,10 @@ int SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataSize) {
 }
 
 int SyncQueue_PopFrontIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return RingQueue_PopFrontIf(&syncQueue->ring, condition, conditionParams, data, dataSize);
+    }
+
     if (Lock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }          
@@ -64,7 +127,69 @@ int SyncQueue_PopFrontIf(SyncQueue* syncQueue, QueuePopCondition condition, void
     return result;
 }
 
+int SyncQueue_PopBatchIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, uint32_t maxBatchSize, SyncQueueBatch* batch) {
+    batch->backend = syncQueue->backend;
+    batch->ring = NULL;
+    batch->condition = condition;
+    batch->conditionParams = conditionParams;
+    batch->remainingElements = 0;
+    batch->remainingSize = maxBatchSize;
+    batch->batch.firstItem = NULL;
+    batch->batch.numberOfElements = 0;
+    batch->batch.dataSize = 0;
+
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        batch->ring = &syncQueue->ring;
+        RingQueue_GetSize(&syncQueue->ring, &batch->remainingElements);
+        return batch->remainingElements == 0 ? QUEUE_IS_EMPTY : QUEUE_OK;
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+
+    QueueResultValues result = Queue_PopBatchIf(&syncQueue->queue, condition, conditionParams, maxBatchSize, &batch->batch);
+
+    if (Unlock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+    return result;
+}
+
+static bool SyncQueue_RingBatchCondition(const void* data, uint32_t dataSize, void* conditionParams) {
+    SyncQueueBatch* batch = (SyncQueueBatch*)conditionParams;
+    if (dataSize >= batch->remainingSize) {
+        return false;
+    }
+    return batch->condition == NULL || batch->condition(data, dataSize, batch->conditionParams);
+}
+
+int SyncQueue_BatchPopFront(SyncQueueBatch* batch, void** data, uint32_t* dataSize) {
+    if (batch->backend != SYNC_QUEUE_BACKEND_RING) {
+        return Queue_BatchPopFront(&batch->batch, data, dataSize);
+    }
+
+    if (batch->remainingElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    QueueResultValues result = RingQueue_PopFrontIf(batch->ring, SyncQueue_RingBatchCondition, batch, data, dataSize);
+    if (result != QUEUE_OK) {
+        // the rest of the ring does not belong to this batch
+        batch->remainingElements = 0;
+        return QUEUE_IS_EMPTY;
+    }
+
+    --batch->remainingElements;
+    batch->remainingSize -= *dataSize;
+    return QUEUE_OK;
+}
+
 int SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return RingQueue_GetSize(&syncQueue->ring, size);
+    }
+
     if (Lock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }          
@@ -75,4 +200,98 @@ int SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }
     return result;
+}
+
+void SyncQueue_SetNotifier(SyncQueue* syncQueue, QueueNotifier* notifier, bool urgent) {
+    syncQueue->notifier = notifier;
+    syncQueue->urgent = urgent;
+}
+
+bool SyncQueue_SetSpillLog(SyncQueue* syncQueue, SpillLog* spillLog) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        // the ring is bounded by its capacity, not by the memory budget
+        return false;
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return false;
+    }
+
+    Queue_SetSpillLog(&syncQueue->queue, spillLog);
+
+    return Unlock(syncQueue->lock) == LOCK_OK;
+}
+
+bool SyncQueue_SetMemoryBudget(SyncQueue* syncQueue, struct _MemoryBudget* budget) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        // the ring consumes from the shared memory
+        return false;
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return false;
+    }
+
+    Queue_SetMemoryBudget(&syncQueue->queue, budget);
+
+    return Unlock(syncQueue->lock) == LOCK_OK;
+}
+
+bool SyncQueue_SetEvictionPolicy(SyncQueue* syncQueue, QueuePriority priority, QueueEvictFunction evict, void* evictParams) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return false;
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return false;
+    }
+
+    Queue_SetEvictionPolicy(&syncQueue->queue, priority, evict, evictParams);
+
+    return Unlock(syncQueue->lock) == LOCK_OK;
+}
+
+static bool SyncQueue_FitsCondition(const void* data, uint32_t dataSize, void* conditionParams) {
+    return dataSize <= *(uint32_t*)conditionParams;
+}
+
+int SyncQueue_PopBestFit(SyncQueue* syncQueue, uint32_t maxDataSize, void** data, uint32_t* dataSize) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return RingQueue_PopFrontIf(&syncQueue->ring, SyncQueue_FitsCondition, &maxDataSize, data, dataSize);
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+
+    QueueResultValues result = Queue_PopBestFit(&syncQueue->queue, maxDataSize, data, dataSize);
+
+    if (Unlock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+    return result;
+}
+
+int SyncQueue_EvictOldest(SyncQueue* syncQueue, QueuePriority priority) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+
+    QueueResultValues result = Queue_EvictOldest(&syncQueue->queue, priority);
+
+    if (Unlock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+    return result;
+}
+
+SyncedCounter* SyncQueue_GetCounter(SyncQueue* syncQueue) {
+    if (syncQueue->backend == SYNC_QUEUE_BACKEND_RING) {
+        return &syncQueue->ring.counter;
+    }
+    return &syncQueue->queue.counter;
 }
\ No newline at end of file
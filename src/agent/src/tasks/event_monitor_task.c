@@ -18,40 +18,122 @@
 #include "collectors/process_creation_collector.h"
 #include "collectors/system_information_collector.h"
 #include "collectors/user_login_collector.h"
+#include "consts.h"
 #include "internal/time_utils.h"
+#include "internal/time_utils_consts.h"
 #include "local_config.h"
 #include "logger.h"
 #include "twin_configuration_event_collectors.h"
 #include "twin_configuration.h"
 
+// a clock which moves further than this, in seconds, starts the schedules over instead of catching up
+#define EVENT_MONITOR_MAX_CLOCK_JUMP (MILLISECONDS_IN_A_DAY / MILLISECONDS_IN_A_SECOND)
+
+typedef struct _EventMonitorCollectorDefinition {
+
+    CollectorId id;
+    TwinConfigurationEventType eventType;
+    EventCollectorFunc collectFunction;
+
+} EventMonitorCollectorDefinition;
+
+static const EventMonitorCollectorDefinition PERIODIC_COLLECTORS[EVENT_MONITOR_PERIODIC_COLLECTORS] = {
+    { COLLECTOR_AGENT_TELEMETRY, EVENT_TYPE_OPERATIONAL_EVENT, AgentTelemetryCollector_GetEvents },
+    { COLLECTOR_LOCAL_USERS, EVENT_TYPE_LOCAL_USERS, LocalUsersCollector_GetEvents },
+    { COLLECTOR_SYSTEM_INFORMATION, EVENT_TYPE_SYSTEM_INFORMATION, SystemInformationCollector_GetEvents },
+    { COLLECTOR_LISTENING_PORTS, EVENT_TYPE_LISTENING_PORTS, ListeningPortCollector_GetEvents },
+    { COLLECTOR_FIREWALL, EVENT_TYPE_FIREWALL_CONFIGURATION, FirewallCollector_GetEvents },
+    { COLLECTOR_BASELINE, EVENT_TYPE_BASELINE, BaselineCollector_GetEvents }
+};
+
+// each collector is either periodic or triggered, so it runs on a single pool
+static const EventMonitorCollectorDefinition TRIGGERED_COLLECTORS[EVENT_MONITOR_TRIGGERED_COLLECTORS] = {
+    { COLLECTOR_AGENT_CONFIGURATION_ERROR, EVENT_TYPE_OPERATIONAL_EVENT, AgentConfigurationErrorCollector_GetEvents },
+    { COLLECTOR_PROCESS_CREATION, EVENT_TYPE_PROCESS_CREATE, ProcessCreationCollector_GetEvents },
+    { COLLECTOR_USER_LOGIN, EVENT_TYPE_USER_LOGIN, UserLoginCollector_GetEvents },
+    { COLLECTOR_CONNECTION_CREATE, EVENT_TYPE_CONNECTION_CREATE, ConnectionCreateEventCollector_GetEvents },
+    { COLLECTOR_DIAGNOSTIC, EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents }
+};
+
 /**
- * @brief Monitors all the periodic events in the system.
+ * @brief Initiates a collector of the task.
+ * 
+ * @param   collector       The collector to initiate.
+ * @param   task            The monitor task.
+ * @param   definition      The event type and the collection function of the collector.
+ * @param   defaultBudget   The budget of the collector unless it has a configured budget of its own.
+ */
+static void EventMonitorTask_InitCollector(EventMonitorCollector* collector, EventMonitorTask* task, const EventMonitorCollectorDefinition* definition, uint32_t defaultBudget);
+
+/**
+ * @brief Runs a collector, called on a thread of a worker pool.
+ * 
+ * @param   context     The collector.
+ */
+static void EventMonitorTask_RunCollector(void* context);
+
+/**
+ * @brief Submits a collector to a worker pool. A collector which still runs from its previous submit is skipped.
+ * 
+ * @param   pool        The pool.
+ * @param   collector   The collector.
+ */
+static void EventMonitorTask_SubmitCollector(WorkerPool* pool, EventMonitorCollector* collector);
+
+/**
+ * @brief Runs the periodic collectors which are due.
+ * 
+ * @param   task            The monitor task.
+ * @param   currentTime     The current time.
+ */
+static void EventMonitorTask_MonitorPeriodicEvents(EventMonitorTask* task, time_t currentTime);
+
+/**
+ * @brief Schedules the first run of every periodic collector. The collectors are spread over their interval, unless their offset is configured.
  * 
  * @param   task    The monitor task.
+ * @param   now     The current tick.
+ */
+static void EventMonitorTask_StartSchedules(EventMonitorTask* task, uint64_t now);
+
+/**
+ * @brief Returns the interval and the offset of a periodic collector in ticks.
  * 
- * @return true on success, false otherwise.
+ * @param   schedule    The schedule of the collector.
+ * @param   interval    Out param. The interval of the collector.
+ * @param   offset      Out param. The offset of the first run of the collector.
+ */
+static void EventMonitorTask_GetSchedule(EventMonitorSchedule* schedule, uint64_t* interval, uint64_t* offset);
+
+/**
+ * @brief Submits a periodic collector and schedules its next run, called by the wheel.
+ * 
+ * @param   context     The schedule of the collector.
  */
-static bool EventMonitorTask_MonitorPeriodicEvents(EventMonitorTask* task);
+static void EventMonitorTask_OnScheduleExpired(void* context);
 
 /**
- * @brief Monitors all the triggered events in the system.
+ * @brief Submits all the triggered collectors.
  * 
  * @param   task    The monitor task.
+ */
+static void EventMonitorTask_MonitorTriggeredEvents(EventMonitorTask* task);
+
+/**
+ * @brief Submits the triggered collectors which received events while they were running.
  * 
- * @return true on success, false otherwise.
+ * @param   task    The monitor task.
  */
-static bool EventMonitorTask_MonitorTriggeredEvents(EventMonitorTask* task);
+static void EventMonitorTask_SubmitPendingCollectors(EventMonitorTask* task);
 
 /**
  * @brief Monitor a singke event type.
  * 
- * @param   task              The monitor task.
- * @param   eventType         The type of the collected event.
- * @param   collectFunction    The event collection function.
+ * @param   collector   The collector of the event type, it runs under its budget.
  *
  * @return true on success, false otherwise.
  */
-static bool EventMonitorTask_MonitorSingleEvents(EventMonitorTask* task, TwinConfigurationEventType eventType, EventCollectorFunc collectFunction);
+static bool EventMonitorTask_MonitorSingleEvents(EventMonitorCollector* collector);
 
 /**
  * @brief Initializes the collecots.
@@ -72,11 +154,45 @@ bool EventMonitorTask_Init(EventMonitorTask* task, SyncQueue* highPriorityQueue,
     task->lowPriorityQueue = lowPriorityQueue;
     task->lastPeriodicExecution = 0;
     task->lastTriggeredExecution = 0;
+    task->wheelStarted = false;
+    task->snapshotFrequency = 0;
+
+    for (uint32_t i = 0; i < EVENT_MONITOR_PERIODIC_COLLECTORS; ++i) {
+        EventMonitorSchedule* schedule = &task->schedules[i];
+        EventMonitorTask_InitCollector(&schedule->collector, task, &PERIODIC_COLLECTORS[i], SNAPSHOT_COLLECTOR_DEFAULT_BUDGET);
+        schedule->index = i;
+        TimerWheel_InitTimer(&schedule->timer, EventMonitorTask_OnScheduleExpired, schedule);
+    }
+
+    for (uint32_t i = 0; i < EVENT_MONITOR_TRIGGERED_COLLECTORS; ++i) {
+        EventMonitorTask_InitCollector(&task->triggeredCollectors[i], task, &TRIGGERED_COLLECTORS[i], TRIGGERED_COLLECTOR_DEFAULT_BUDGET);
+    }
+
+    if (!EventMonitorTask_InitCollectors()) {
+        return false;
+    }
 
-    return EventMonitorTask_InitCollectors();
+    if (!WorkerPool_Init(&task->triggeredPool, TRIGGERED_COLLECTOR_WORKERS)) {
+        goto cleanup;
+    }
+
+    if (!WorkerPool_Init(&task->snapshotPool, SNAPSHOT_COLLECTOR_WORKERS)) {
+        WorkerPool_Deinit(&task->triggeredPool);
+        goto cleanup;
+    }
+
+    return true;
+
+cleanup:
+    EventMonitorTask_DeinitCollectors();
+    return false;
 }
 
 void EventMonitorTask_Deinit(EventMonitorTask* task) {
+    // the running collectors are waited for, they still use the queues
+    WorkerPool_Deinit(&task->snapshotPool);
+    WorkerPool_Deinit(&task->triggeredPool);
+
     task->highPriorityQueue = NULL;
     task->lowPriorityQueue = NULL;
 
@@ -84,110 +200,189 @@ void EventMonitorTask_Deinit(EventMonitorTask* task) {
 }
 
 void EventMonitorTask_Execute(EventMonitorTask* task) {
+    // a collector which is stuck is reported on every execution, even though its run is skipped
+    CollectorExecution_Watchdog();
 
-    uint32_t periodicFrequency = 0;
-    if (TwinConfiguration_GetSnapshotFrequency(&periodicFrequency) != TWIN_OK) {
+    if (TwinConfiguration_GetSnapshotFrequency(&task->snapshotFrequency) != TWIN_OK) {
         return;
     }
     
     time_t currentTime = TimeUtils_GetCurrentTime();
-    // time is in seconds so we convert it to milliseconds here
-    uint32_t timeDiff = TimeUtils_GetTimeDiff(currentTime, task->lastPeriodicExecution);
-
-    if (timeDiff >= periodicFrequency) {
-        task->lastPeriodicExecution = currentTime;
-        EventMonitorTask_MonitorPeriodicEvents(task);
-    }
+    EventMonitorTask_MonitorPeriodicEvents(task, currentTime);
 
-    timeDiff = TimeUtils_GetTimeDiff(currentTime, task->lastTriggeredExecution);
+    // time is in seconds so we convert it to milliseconds here
+    uint32_t timeDiff = TimeUtils_GetTimeDiff(currentTime, task->lastTriggeredExecution);
     if (timeDiff >= LocalConfiguration_GetTriggeredEventInterval()) {
         task->lastTriggeredExecution = currentTime;
         EventMonitorTask_MonitorTriggeredEvents(task);
     }
+
+    EventMonitorTask_SubmitPendingCollectors(task);
 }
 
-static bool EventMonitorTask_MonitorPeriodicEvents(EventMonitorTask* task) {
-    //FIXME: add all periodic events
-    Logger_Debug("Collect telemetry");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_OPERATIONAL_EVENT, AgentTelemetryCollector_GetEvents)){
-        return false;
+void EventMonitorTask_OnAuditEvents(void* context, CollectorId id) {
+    EventMonitorTask* task = (EventMonitorTask*)context;
+
+    for (uint32_t i = 0; i < EVENT_MONITOR_TRIGGERED_COLLECTORS; ++i) {
+        EventMonitorCollector* collector = &task->triggeredCollectors[i];
+        if (collector->id != id) {
+            continue;
+        }
+
+        WorkerPoolResult result = WorkerPool_Submit(&task->triggeredPool, &collector->job);
+        if (result == WORKER_POOL_JOB_BUSY) {
+            // the running search may have missed the events, so the collector runs again once it is done
+            collector->pending = true;
+        } else if (result != WORKER_POOL_OK) {
+            Logger_Error("Could not submit the collector of event type %d", collector->eventType);
+        }
+        return;
     }
+}
 
-    Logger_Debug("Collect local users.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_LOCAL_USERS, LocalUsersCollector_GetEvents)) {
-        return false;
+static void EventMonitorTask_MonitorPeriodicEvents(EventMonitorTask* task, time_t currentTime) {
+    uint64_t now = (uint64_t)currentTime;
+    if (!task->wheelStarted || now < task->wheel.now || now - task->wheel.now > EVENT_MONITOR_MAX_CLOCK_JUMP) {
+        EventMonitorTask_StartSchedules(task, now);
     }
 
-    Logger_Debug("Collect system info.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_SYSTEM_INFORMATION, SystemInformationCollector_GetEvents)) {
-        return false;
+    task->lastPeriodicExecution = currentTime;
+    TimerWheel_Advance(&task->wheel, now);
+}
+
+static void EventMonitorTask_StartSchedules(EventMonitorTask* task, uint64_t now) {
+    TimerWheel_Init(&task->wheel, now);
+
+    for (uint32_t i = 0; i < EVENT_MONITOR_PERIODIC_COLLECTORS; ++i) {
+        EventMonitorSchedule* schedule = &task->schedules[i];
+        // the wheel was reset, so the timers are not linked anymore
+        TimerWheel_InitTimer(&schedule->timer, EventMonitorTask_OnScheduleExpired, schedule);
+
+        uint64_t interval = 0;
+        uint64_t offset = 0;
+        EventMonitorTask_GetSchedule(schedule, &interval, &offset);
+        TimerWheel_Schedule(&task->wheel, &schedule->timer, now + offset);
     }
 
-    Logger_Debug("Collect listening ports.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_LISTENING_PORTS, ListeningPortCollector_GetEvents)) {
-        return false;
+    task->wheelStarted = true;
+}
+
+static void EventMonitorTask_GetSchedule(EventMonitorSchedule* schedule, uint64_t* interval, uint64_t* offset) {
+    TwinConfigurationSnapshotSchedule configuration = { 0, 0 };
+    if (TwinConfigurationEventCollectors_GetSnapshotSchedule(schedule->collector.eventType, &configuration) != TWIN_OK) {
+        Logger_Warning("Could not get the snapshot schedule of event type %d, using the snapshot frequency", schedule->collector.eventType);
+        configuration.interval = 0;
+        configuration.offset = 0;
     }
 
-    Logger_Debug("Collect firewall configuration.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_FIREWALL_CONFIGURATION, FirewallCollector_GetEvents)) {
-        return false;
+    uint32_t intervalInMilliseconds = configuration.interval > 0 ? configuration.interval : schedule->collector.task->snapshotFrequency;
+    *interval = ((uint64_t)intervalInMilliseconds + MILLISECONDS_IN_A_SECOND - 1) / MILLISECONDS_IN_A_SECOND;
+    if (*interval == 0) {
+        *interval = 1;
     }
 
-    Logger_Debug("Collect baseline events.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_BASELINE, BaselineCollector_GetEvents)) {
-        return false;
+    if (configuration.offset > 0) {
+        *offset = configuration.offset / MILLISECONDS_IN_A_SECOND;
+    } else {
+        *offset = *interval * schedule->index / EVENT_MONITOR_PERIODIC_COLLECTORS;
     }
+}
 
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents)) {
-        return false;
+static void EventMonitorTask_OnScheduleExpired(void* context) {
+    EventMonitorSchedule* schedule = (EventMonitorSchedule*)context;
+    EventMonitorTask* task = schedule->collector.task;
+
+    Logger_Debug("Collect periodic events of type %d.", schedule->collector.eventType);
+    EventMonitorTask_SubmitCollector(&task->snapshotPool, &schedule->collector);
+
+    // the interval is read again, so a changed configuration applies from the next run
+    uint64_t interval = 0;
+    uint64_t offset = 0;
+    EventMonitorTask_GetSchedule(schedule, &interval, &offset);
+
+    // runs which were missed while the agent was not executing are skipped, and the phase of the collector is kept
+    uint64_t now = (uint64_t)task->lastPeriodicExecution;
+    uint64_t next = schedule->timer.expiry + interval;
+    if (next <= now) {
+        next += ((now - next) / interval + 1) * interval;
     }
 
-    return true;
+    TimerWheel_Schedule(&task->wheel, &schedule->timer, next);
 }
 
-static bool EventMonitorTask_MonitorTriggeredEvents(EventMonitorTask* task) {
-    //FIXME: add all triggered events
-    Logger_Debug("Collect configuration error events");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_OPERATIONAL_EVENT, AgentConfigurationErrorCollector_GetEvents)) {
-        return false;
+static void EventMonitorTask_MonitorTriggeredEvents(EventMonitorTask* task) {
+    for (uint32_t i = 0; i < EVENT_MONITOR_TRIGGERED_COLLECTORS; ++i) {
+        Logger_Debug("Collect triggered events of type %d.", task->triggeredCollectors[i].eventType);
+        EventMonitorTask_SubmitCollector(&task->triggeredPool, &task->triggeredCollectors[i]);
     }
+}
 
-    Logger_Debug("Collect process create.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_PROCESS_CREATE, ProcessCreationCollector_GetEvents)) {
-        return false;
+static void EventMonitorTask_SubmitPendingCollectors(EventMonitorTask* task) {
+    for (uint32_t i = 0; i < EVENT_MONITOR_TRIGGERED_COLLECTORS; ++i) {
+        EventMonitorCollector* collector = &task->triggeredCollectors[i];
+        if (!collector->pending) {
+            continue;
+        }
+
+        WorkerPoolResult result = WorkerPool_Submit(&task->triggeredPool, &collector->job);
+        if (result == WORKER_POOL_JOB_BUSY) {
+            continue;
+        }
+
+        collector->pending = false;
+        if (result != WORKER_POOL_OK) {
+            Logger_Error("Could not submit the collector of event type %d", collector->eventType);
+        }
     }
+}
 
-    Logger_Debug("Collect login.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_USER_LOGIN, UserLoginCollector_GetEvents)) {
-        return false;
+static void EventMonitorTask_InitCollector(EventMonitorCollector* collector, EventMonitorTask* task, const EventMonitorCollectorDefinition* definition, uint32_t defaultBudget) {
+    collector->task = task;
+    collector->id = definition->id;
+    collector->eventType = definition->eventType;
+    collector->collectFunction = definition->collectFunction;
+    collector->pending = false;
+    collector->budget = LocalConfiguration_GetCollectorBudget(definition->id);
+    if (collector->budget == 0) {
+        collector->budget = defaultBudget;
     }
+    WorkerPool_InitJob(&collector->job, EventMonitorTask_RunCollector, collector);
+}
 
-    Logger_Debug("Collect connection create.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_CONNECTION_CREATE, ConnectionCreateEventCollector_GetEvents)) {
-        return false;
-    }
+static void EventMonitorTask_RunCollector(void* context) {
+    EventMonitorTask_MonitorSingleEvents((EventMonitorCollector*)context);
+}
 
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents)) {
-        return false;
+static void EventMonitorTask_SubmitCollector(WorkerPool* pool, EventMonitorCollector* collector) {
+    WorkerPoolResult result = WorkerPool_Submit(pool, &collector->job);
+    if (result == WORKER_POOL_JOB_BUSY) {
+        Logger_Warning("The %s collector did not finish its previous run, the run is skipped", CollectorExecution_GetName(collector->id));
+        CollectorExecution_ReportSkipped(collector->id);
+    } else if (result != WORKER_POOL_OK) {
+        Logger_Error("Could not submit the collector of event type %d", collector->eventType);
     }
-
-    return true;
 }
 
-static bool EventMonitorTask_MonitorSingleEvents(EventMonitorTask* task, TwinConfigurationEventType eventType, EventCollectorFunc collectFunction) {
+static bool EventMonitorTask_MonitorSingleEvents(EventMonitorCollector* collector) {
+    EventMonitorTask* task = collector->task;
     TwinConfigurationEventPriority priority = 0;
 
-    if (TwinConfigurationEventCollectors_GetPriority(eventType, &priority) != TWIN_OK) {
+    if (TwinConfigurationEventCollectors_GetPriority(collector->eventType, &priority) != TWIN_OK) {
         return false;
     }
 
-    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    SyncQueue* queue = NULL;
     if (priority == EVENT_PRIORITY_OPERATIONAL){
-        result = collectFunction(task->operationalEventsQueue);
+        queue = task->operationalEventsQueue;
     } else if (priority == EVENT_PRIORITY_HIGH) {
-        result = collectFunction(task->highPriorityQueue);
+        queue = task->highPriorityQueue;
     } else if (priority == EVENT_PRIORITY_LOW) {
-        result = collectFunction(task->lowPriorityQueue);
+        queue = task->lowPriorityQueue;
+    }
+
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    if (queue != NULL) {
+        result = CollectorExecution_Run(collector->id, collector->collectFunction, queue, collector->budget);
     }
 
     if (result == EVENT_COLLECTOR_OK) {
@@ -5,24 +5,43 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "azure_c_shared_utility/threadapi.h"
+#include "consts.h"
 #include "internal/time_utils.h"
+#include "local_config.h"
 #include "logger.h"
-#include "memory_monitor.h"
+#include "message_schema_consts.h"
 #include "message_serializer.h"
+#include "tracked_allocator.h"
 #include "twin_configuration.h"
 
 /**
- * @brief Dequeue all the events in the queue and send them to the hub
+ * @brief Dequeue all the events in the queue and send them to the hub.
+ *        While a message is in flight the next one is built, as long as the in flight window has room.
  * 
- * @param   task            The task instance.
- * @param   mainQueue       The main message queue.
- * @param   paddingQueue    A queue to add messages from in case the main queue does not have enough data.
+ * @param   task                The task instance.
+ * @param   mainQueue           The main message queue.
+ * @param   paddingQueue        A queue to add messages from in case the main queue does not have enough data.
+ * @param   maxInFlightMessages The in flight window.
  * 
  * @return true on success, false otherwise.
  */
 
-bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue);
+bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, uint32_t maxInFlightMessages);
+
+/**
+ * @brief Sends the events whose deadline passed, as long as the in flight window has room.
+ * 
+ * @param   task    The task instance.
+ */
+static void EventPublisherTask_Publish(EventPublisherTask* task);
+
+/**
+ * @brief Returns the time left until the given deadline, in milliseconds.
+ */
+static uint32_t EventPublisherTask_TimeUntil(time_t currentTime, time_t lastExecution, uint32_t frequency);
 
 bool EventPublisherTask_Init(EventPublisherTask* task, SyncQueue* highPriorityEventQueue, SyncQueue* lowPriorityEventQueue, SyncQueue* operationalEventsQueue, IoTHubAdapter* iothubAdapter) {
     task->operationalEventsQueue = operationalEventsQueue;
@@ -31,17 +50,52 @@ bool EventPublisherTask_Init(EventPublisherTask* task, SyncQueue* highPriorityEv
     task->iothubAdapter = iothubAdapter;
     task->highPriorityQueueLastExecution = TimeUtils_GetCurrentTime();
     task->lowPriorityQueueLastExecution = TimeUtils_GetCurrentTime();
+    task->urgentEventsPending = false;
+    task->doWorkTimeout = UINT32_MAX;
+
+    // the watermark is updated from the max message size before each wait
+    if (!QueueNotifier_Init(&task->notifier, UINT32_MAX)) {
+        return false;
+    }
+
+    if (!SendPipeline_Init(&task->sendPipeline, iothubAdapter)) {
+        QueueNotifier_Deinit(&task->notifier);
+        return false;
+    }
+
+    // only operational events are sent right away, the high priority events are batched by their frequency unless they fill a message
+    SyncQueue_SetNotifier(operationalEventsQueue, &task->notifier, true);
+    SyncQueue_SetNotifier(highPriorityEventQueue, &task->notifier, false);
+    SyncQueue_SetNotifier(lowPriorityEventQueue, &task->notifier, false);
     return true;
 }
 
 void EventPublisherTask_Deinit(EventPublisherTask* task) {
+    if (task->operationalEventsQueue != NULL) {
+        SyncQueue_SetNotifier(task->operationalEventsQueue, NULL, false);
+    }
+    if (task->highPriorityEventQueue != NULL) {
+        SyncQueue_SetNotifier(task->highPriorityEventQueue, NULL, false);
+    }
+    if (task->lowPriorityEventQueue != NULL) {
+        SyncQueue_SetNotifier(task->lowPriorityEventQueue, NULL, false);
+    }
+    QueueNotifier_Deinit(&task->notifier);
+    SendPipeline_Deinit(&task->sendPipeline);
+
+    task->operationalEventsQueue = NULL;
     task->lowPriorityEventQueue = NULL;
     task->highPriorityEventQueue = NULL;
     task->iothubAdapter = NULL;
 }
 
 void EventPublisherTask_Execute(EventPublisherTask* task) {
+    EventPublisherTask_Publish(task);
+    // the low level module client delivers all the messages which were sent since the last call at once
+    task->doWorkTimeout = IoTHubAdapter_DoWork(task->iothubAdapter);
+}
 
+static void EventPublisherTask_Publish(EventPublisherTask* task) {
     uint32_t highPriorityQueueFrequency = 0;
     if (TwinConfiguration_GetHighPriorityMessageFrequency(&highPriorityQueueFrequency) != TWIN_OK) {
         return;
@@ -56,19 +110,37 @@ void EventPublisherTask_Execute(EventPublisherTask* task) {
     if (TwinConfiguration_GetMaxMessageSize(&maxMessageSize) != TWIN_OK) {
         return;
     }
+
+    uint32_t maxInFlightMessages = 0;
+    if (TwinConfiguration_GetMaxInFlightMessages(&maxInFlightMessages) != TWIN_OK) {
+        return;
+    }
     
-    uint32_t currentMemoryConsumption = 0;
-    if (MemoryMonitor_CurrentConsumption(&currentMemoryConsumption) != MEMORY_MONITOR_OK) {
+    // only the queued events count towards a full message, the memory of the other subsystems is never sent
+    uint32_t queuedEventsSize = 0;
+    if (!TrackedAllocator_GetUntrackedConsumption(&queuedEventsSize)) {
         return;
     }
 
     time_t currentTime = TimeUtils_GetCurrentTime();
 
-    if (currentMemoryConsumption > maxMessageSize) {
+    if (!IoTHubAdapter_IsConnected(task->iothubAdapter)) {
+        // the adapter reconnects in the background, the events wait in the queues, and spill to the spill log once they are full
+        return;
+    }
+
+    SendPipeline_Retry(&task->sendPipeline, currentTime);
+    if (!SendPipeline_HasRoom(&task->sendPipeline, maxInFlightMessages)) {
+        // the events wait in the queues and the deadlines stay due until the hub confirms the messages in flight
+        return;
+    }
+
+    if (task->urgentEventsPending || queuedEventsSize > maxMessageSize) {
         // If we got to the max message size in the queue, we are sending the message as high priority even if there
         // weren't any actual high priority events
-        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue);
+        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue, maxInFlightMessages);
         task->highPriorityQueueLastExecution = currentTime;
+        task->urgentEventsPending = false;
     }
 
     // time is in seconds so we convert it to milliseconds here
@@ -76,18 +148,73 @@ void EventPublisherTask_Execute(EventPublisherTask* task) {
     uint32_t lowPriorityQueueTimeDiff = TimeUtils_GetTimeDiff(currentTime, task->lowPriorityQueueLastExecution);
     
     if (highPriorityQueueTimeDiff > highPriorityQueueFrequency) {
-        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue);
+        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue, maxInFlightMessages);
         task->highPriorityQueueLastExecution = currentTime;
     }
     
     if (lowPriorityQueueTimeDiff > lowPriorityQueueFrequency) {
-        EventPublisherTask_SendEvents(task, task->lowPriorityEventQueue, task->highPriorityEventQueue);
+        EventPublisherTask_SendEvents(task, task->lowPriorityEventQueue, task->highPriorityEventQueue, maxInFlightMessages);
         task->lowPriorityQueueLastExecution = currentTime;
     }
 }
 
-bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue) {
-    void* buffer = NULL;
+void EventPublisherTask_Wait(EventPublisherTask* task, uint32_t schedulerInterval) {
+    uint32_t highPriorityQueueFrequency = 0;
+    uint32_t lowPriorityQueueFrequency = 0;
+    uint32_t maxMessageSize = 0;
+    if (TwinConfiguration_GetHighPriorityMessageFrequency(&highPriorityQueueFrequency) != TWIN_OK ||
+        TwinConfiguration_GetLowPriorityMessageFrequency(&lowPriorityQueueFrequency) != TWIN_OK ||
+        TwinConfiguration_GetMaxMessageSize(&maxMessageSize) != TWIN_OK) {
+        ThreadAPI_Sleep(schedulerInterval);
+        return;
+    }
+
+    QueueNotifier_SetWatermark(&task->notifier, maxMessageSize);
+
+    time_t currentTime = TimeUtils_GetCurrentTime();
+    uint32_t timeout = EventPublisherTask_TimeUntil(currentTime, task->highPriorityQueueLastExecution, highPriorityQueueFrequency);
+    uint32_t lowPriorityTimeout = EventPublisherTask_TimeUntil(currentTime, task->lowPriorityQueueLastExecution, lowPriorityQueueFrequency);
+    if (lowPriorityTimeout < timeout) {
+        timeout = lowPriorityTimeout;
+    }
+    uint32_t retryTimeout = SendPipeline_GetRetryTimeout(&task->sendPipeline, currentTime);
+    if (retryTimeout < timeout) {
+        timeout = retryTimeout;
+    }
+
+    // the deadlines have a resolution of seconds, waking up before the scheduler interval would spin
+    if (timeout < schedulerInterval) {
+        timeout = schedulerInterval;
+    } else if (timeout > PUBLISHER_MAX_WAIT_INTERVAL) {
+        timeout = PUBLISHER_MAX_WAIT_INTERVAL;
+    }
+
+    // a low level module client is driven only by this task
+    if (task->doWorkTimeout < timeout) {
+        timeout = task->doWorkTimeout;
+    }
+
+    QueueNotifierWaitResult result = QueueNotifier_Wait(&task->notifier, timeout);
+    if (result == QUEUE_NOTIFIER_URGENT) {
+        task->urgentEventsPending = true;
+    } else if (result == QUEUE_NOTIFIER_EXCEPTION) {
+        ThreadAPI_Sleep(schedulerInterval);
+    }
+}
+
+void EventPublisherTask_Wake(EventPublisherTask* task) {
+    QueueNotifier_Signal(&task->notifier);
+}
+
+static uint32_t EventPublisherTask_TimeUntil(time_t currentTime, time_t lastExecution, uint32_t frequency) {
+    int32_t timeDiff = TimeUtils_GetTimeDiff(currentTime, lastExecution);
+    if (timeDiff < 0) {
+        return 0;
+    }
+    return (uint32_t)timeDiff >= frequency ? 0 : frequency - (uint32_t)timeDiff;
+}
+
+bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, uint32_t maxInFlightMessages) {
     bool result = true;
 
     uint32_t queueSize = 0;
@@ -99,21 +226,53 @@ bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueu
         return true;
     }
 
-    SyncQueue* queuesOrder[] = {task->operationalEventsQueue, mainQueue, paddingQueue};
-    MessageSerializerResultValues serializationResult = MessageSerializer_CreateSecurityMessage(queuesOrder, 3, &buffer);
-    if (serializationResult != MESSAGE_SERIALIZER_OK && serializationResult != MESSAGE_SERIALIZER_PARTIAL) {
+    bool compressionEnabled = false;
+    if (TwinConfiguration_GetMessageCompressionEnabled(&compressionEnabled) != TWIN_OK) {
+        return false;
+    }
+
+    bool columnarEnabled = false;
+    if (TwinConfiguration_GetColumnarMessagesEnabled(&columnarEnabled) != TWIN_OK) {
         return false;
     }
 
-    if (buffer != NULL) {
-        uint32_t size = strlen(buffer);
-        if (!IoTHubAdapter_SendMessageAsync(task->iothubAdapter, buffer, size)) {
-                //FIXME: do we want to stop sedning message in this case?
-                result = false;
-                Logger_Error("error sending a message to the hub");
+    // the collectors encode the events with the same local setting, so the message always matches its events
+    EventEncoding encoding = LocalConfiguration_GetEventEncoding();
+    bool encoded = compressionEnabled || columnarEnabled || encoding != EVENT_ENCODING_JSON;
+    const char* contentType = encoding == EVENT_ENCODING_CBOR ? MESSAGE_CONTENT_TYPE_CBOR : NULL;
+    const char* contentEncoding = compressionEnabled ? MESSAGE_CONTENT_ENCODING_DEFLATE : NULL;
+
+    SyncQueue* queuesOrder[] = {task->operationalEventsQueue, mainQueue, paddingQueue};
+    bool eventsLeft = true;
+    while (eventsLeft && SendPipeline_HasRoom(&task->sendPipeline, maxInFlightMessages)) {
+        void* buffer = NULL;
+        uint32_t size = 0;
+        MessageSerializerResultValues serializationResult = encoded ?
+            MessageSerializer_CreateEncodedSecurityMessage(queuesOrder, 3, encoding, compressionEnabled, columnarEnabled, &buffer, &size) :
+            MessageSerializer_CreateSecurityMessage(queuesOrder, 3, &buffer);
+        if (serializationResult != MESSAGE_SERIALIZER_OK && serializationResult != MESSAGE_SERIALIZER_PARTIAL && serializationResult != MESSAGE_SERIALIZER_FULL) {
+            return false;
+        }
+
+        if (buffer == NULL) {
+            break;
         }
-        
-        free(buffer);
+
+        SendPipelineResult sendResult = SendPipeline_Send(&task->sendPipeline, buffer, encoded ? size : strlen(buffer), contentType, contentEncoding);
+        if (sendResult == SEND_PIPELINE_DEFERRED) {
+            // the pipeline sends the message again later, the rest of the events wait in the queues
+            result = false;
+            break;
+        } else if (sendResult != SEND_PIPELINE_OK) {
+            Logger_Error("error sending a message to the hub");
+            free(buffer);
+            result = false;
+            break;
+        }
+
+        // a message which left events behind was full, the next one is built while it is in flight
+        eventsLeft = serializationResult == MESSAGE_SERIALIZER_FULL &&
+            SyncQueue_GetSize(mainQueue, &queueSize) == QUEUE_OK && queueSize > 0;
     }
 
     return result;
@@ -5,6 +5,7 @@
 
 #include <stdlib.h>
 
+#include "memory_monitor.h"
 #include "twin_configuration.h"
 #include "logger.h"
 
@@ -17,6 +18,13 @@
  */
 static bool UpdateTwinTask_UpdateTwinReportedProperties(IoTHubAdapter* iothubClient);
 
+/**
+ * @brief   Publishes the configured local cache size to the memory monitor, so it is not read on every consumption
+ * 
+ * @return  true upon success
+ */
+static bool UpdateTwinTask_PublishMemoryLimit();
+
 
 bool UpdateTwinTask_Init(UpdateTwinTask* task, SyncQueue* updateQueue, IoTHubAdapter* client) {
     task->updateQueue = updateQueue;
@@ -95,6 +103,10 @@ void UpdateTwinTask_Execute(UpdateTwinTask* task) {
         }
     }
 
+    if (UpdateTwinTask_PublishMemoryLimit() == false) {
+        success = false;
+    }
+
     if (UpdateTwinTask_UpdateTwinReportedProperties(task->iothubClient) == false) {
         success = false;
         goto cleanup;
@@ -136,6 +148,16 @@ cleanup:
     return success;
 }
 
+static bool UpdateTwinTask_PublishMemoryLimit() {
+    uint32_t maxLocalCacheSize = 0;
+    if (TwinConfiguration_GetMaxLocalCacheSize(&maxLocalCacheSize) != TWIN_OK) {
+        return false;
+    }
+
+    MemoryMonitor_SetLimit(maxLocalCacheSize);
+    return true;
+}
+
 bool UpdateTwinTask_InitUpdateTwinTaskItem(UpdateTwinTaskItem** twinTaskItem, const unsigned char* payload, size_t size, bool isComplete) {
     bool result = true;
     *twinTaskItem = malloc(sizeof(UpdateTwinTaskItem));
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "timer_wheel.h"
+
+#include <string.h>
+
+#define TIMER_WHEEL_SLOT_MASK ((uint64_t)TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVEL_MASK(level) (((uint64_t)1 << (TIMER_WHEEL_SLOT_BITS * (level))) - 1)
+
+/**
+ * @brief Links the timer into the slot of its expiry relative to the current tick of the wheel.
+ *
+ * @param   wheel   The wheel.
+ * @param   timer   The timer, which is not linked.
+ */
+static void TimerWheel_Link(TimerWheel* wheel, TimerWheelTimer* timer);
+
+/**
+ * @brief Unlinks the timer from its slot.
+ *
+ * @param   timer   The timer, which is linked.
+ */
+static void TimerWheel_Unlink(TimerWheelTimer* timer);
+
+/**
+ * @brief Links all the timers of the given list again, relative to the current tick of the wheel.
+ *
+ * @param   wheel   The wheel.
+ * @param   list    The head of the list.
+ */
+static void TimerWheel_Relink(TimerWheel* wheel, TimerWheelTimer** list);
+
+/**
+ * @brief Cascades the higher levels which reached a new slot, and expires the level 0 slot of the current tick.
+ *
+ * @param   wheel   The wheel, already moved to the tick.
+ */
+static void TimerWheel_ProcessTick(TimerWheel* wheel);
+
+void TimerWheel_Init(TimerWheel* wheel, uint64_t now) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now;
+}
+
+void TimerWheel_InitTimer(TimerWheelTimer* timer, TimerWheelCallback callback, void* context) {
+    memset(timer, 0, sizeof(*timer));
+    timer->callback = callback;
+    timer->context = context;
+}
+
+void TimerWheel_Schedule(TimerWheel* wheel, TimerWheelTimer* timer, uint64_t expiry) {
+    TimerWheel_Cancel(wheel, timer);
+
+    // the slot of the current tick was already expired
+    timer->expiry = expiry > wheel->now ? expiry : wheel->now + 1;
+    TimerWheel_Link(wheel, timer);
+    ++wheel->numberOfTimers;
+}
+
+void TimerWheel_Cancel(TimerWheel* wheel, TimerWheelTimer* timer) {
+    if (timer->pprev == NULL) {
+        return;
+    }
+
+    TimerWheel_Unlink(timer);
+    --wheel->numberOfTimers;
+}
+
+bool TimerWheel_IsScheduled(TimerWheelTimer* timer) {
+    return timer->pprev != NULL;
+}
+
+void TimerWheel_Advance(TimerWheel* wheel, uint64_t now) {
+    // an empty wheel has nothing to cascade, so it moves at once
+    while (wheel->now < now && wheel->numberOfTimers > 0) {
+        ++wheel->now;
+        TimerWheel_ProcessTick(wheel);
+    }
+
+    if (wheel->now < now) {
+        wheel->now = now;
+    }
+}
+
+static void TimerWheel_ProcessTick(TimerWheel* wheel) {
+    uint64_t now = wheel->now;
+
+    if ((now & TIMER_WHEEL_LEVEL_MASK(TIMER_WHEEL_LEVELS)) == 0) {
+        TimerWheel_Relink(wheel, &wheel->overflow);
+    }
+
+    // higher levels first, a timer may cascade down several levels on the same tick
+    for (uint32_t level = TIMER_WHEEL_LEVELS - 1; level > 0; --level) {
+        if ((now & TIMER_WHEEL_LEVEL_MASK(level)) == 0) {
+            uint64_t slot = (now >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+            TimerWheel_Relink(wheel, &wheel->slots[level][slot]);
+        }
+    }
+
+    // timers are popped one by one, since a callback may cancel the other timers of the slot
+    TimerWheelTimer** expired = &wheel->slots[0][now & TIMER_WHEEL_SLOT_MASK];
+    while (*expired != NULL) {
+        TimerWheelTimer* timer = *expired;
+        TimerWheel_Unlink(timer);
+        --wheel->numberOfTimers;
+        timer->callback(timer->context);
+    }
+}
+
+static void TimerWheel_Link(TimerWheel* wheel, TimerWheelTimer* timer) {
+    TimerWheelTimer** head = &wheel->overflow;
+
+    // the level is the highest group of bits in which the expiry differs from the current tick
+    uint64_t diff = timer->expiry ^ wheel->now;
+    for (uint32_t level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        if ((diff >> (TIMER_WHEEL_SLOT_BITS * (level + 1))) == 0) {
+            head = &wheel->slots[level][(timer->expiry >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK];
+            break;
+        }
+    }
+
+    timer->next = *head;
+    if (timer->next != NULL) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+}
+
+static void TimerWheel_Unlink(TimerWheelTimer* timer) {
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+static void TimerWheel_Relink(TimerWheel* wheel, TimerWheelTimer** list) {
+    TimerWheelTimer* pending = *list;
+    *list = NULL;
+
+    while (pending != NULL) {
+        TimerWheelTimer* timer = pending;
+        pending = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        TimerWheel_Link(wheel, timer);
+    }
+}
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "tracked_allocator.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+
+#include "memory_monitor.h"
+
+// glibc keeps a size word in front of every chunk and aligns chunks to two words
+#define TRACKED_ALLOCATOR_CHUNK_HEADER_SIZE sizeof(size_t)
+#define TRACKED_ALLOCATOR_CHUNK_ALIGNMENT (2 * sizeof(size_t))
+#define TRACKED_ALLOCATOR_MIN_CHUNK_SIZE (4 * sizeof(size_t))
+
+// the usage of every tag, updated with atomic operations so it can be used from any thread
+static uint32_t usageInBytes[ALLOCATION_TAG_COUNT];
+
+// whether a tag must stay within the memory limit, unbounded tags are charged even if the limit is exceeded
+static const bool isBounded[ALLOCATION_TAG_COUNT] = {
+    [ALLOCATION_TAG_JSON] = false,
+    [ALLOCATION_TAG_PROCESS_HASHES] = true,
+    [ALLOCATION_TAG_BASELINE] = true,
+    [ALLOCATION_TAG_AUDIT_STREAM] = true
+};
+
+/**
+ * @brief Returns the size the given allocation really takes on the heap.
+ */
+static uint32_t TrackedAllocator_AllocationSize(void* ptr) {
+    return (uint32_t)(malloc_usable_size(ptr) + TRACKED_ALLOCATOR_CHUNK_HEADER_SIZE);
+}
+
+void* TrackedAllocator_Malloc(AllocationTag tag, size_t size) {
+    void* ptr = malloc(size);
+    if (ptr == NULL) {
+        return NULL;
+    }
+
+    if (!TrackedAllocator_Charge(tag, TrackedAllocator_AllocationSize(ptr))) {
+        free(ptr);
+        return NULL;
+    }
+
+    return ptr;
+}
+
+void TrackedAllocator_Free(AllocationTag tag, void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    TrackedAllocator_Discharge(tag, TrackedAllocator_AllocationSize(ptr));
+    free(ptr);
+}
+
+bool TrackedAllocator_Charge(AllocationTag tag, uint32_t size) {
+    if (isBounded[tag]) {
+        if (MemoryMonitor_Consume(size) != MEMORY_MONITOR_OK) {
+            return false;
+        }
+    } else {
+        MemoryMonitor_ForceConsume(size);
+    }
+
+    __atomic_add_fetch(&usageInBytes[tag], size, __ATOMIC_RELAXED);
+    return true;
+}
+
+void TrackedAllocator_Discharge(AllocationTag tag, uint32_t size) {
+    // never release more than the tag was charged for, so a mismatched free can not release the charge of the queues
+    uint32_t usage = __atomic_load_n(&usageInBytes[tag], __ATOMIC_RELAXED);
+    uint32_t released = 0;
+    do {
+        released = size < usage ? size : usage;
+    } while (!__atomic_compare_exchange_n(&usageInBytes[tag], &usage, usage - released, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    if (released > 0) {
+        MemoryMonitor_Release(released);
+    }
+}
+
+uint32_t TrackedAllocator_EstimateSize(size_t size) {
+    size_t chunkSize = size + TRACKED_ALLOCATOR_CHUNK_HEADER_SIZE;
+    if (chunkSize < TRACKED_ALLOCATOR_MIN_CHUNK_SIZE) {
+        chunkSize = TRACKED_ALLOCATOR_MIN_CHUNK_SIZE;
+    }
+
+    return (uint32_t)((chunkSize + TRACKED_ALLOCATOR_CHUNK_ALIGNMENT - 1) & ~(TRACKED_ALLOCATOR_CHUNK_ALIGNMENT - 1));
+}
+
+uint32_t TrackedAllocator_GetUsage(AllocationTag tag) {
+    return __atomic_load_n(&usageInBytes[tag], __ATOMIC_RELAXED);
+}
+
+bool TrackedAllocator_GetUntrackedConsumption(uint32_t* sizeInBytes) {
+    uint32_t totalConsumption = 0;
+    if (MemoryMonitor_CurrentConsumption(&totalConsumption) != MEMORY_MONITOR_OK) {
+        return false;
+    }
+
+    uint32_t trackedConsumption = 0;
+    for (uint32_t tag = 0; tag < ALLOCATION_TAG_COUNT; ++tag) {
+        trackedConsumption += TrackedAllocator_GetUsage(tag);
+    }
+
+    // the monitor and the tags are read one after the other, so a concurrent charge may briefly make the difference negative
+    *sizeInBytes = totalConsumption > trackedConsumption ? totalConsumption - trackedConsumption : 0;
+    return true;
+}
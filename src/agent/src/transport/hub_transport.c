@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "transport/hub_transport.h"
+
+#include "iothub_module_client_ll.h"
+
+#ifdef USE_MQTT
+#include "iothubtransportmqtt.h"
+static IOTHUB_CLIENT_TRANSPORT_PROVIDER protocol = MQTT_Protocol;
+#endif
+#ifdef USE_AMQP
+#include "iothubtransportamqp.h"
+static IOTHUB_CLIENT_TRANSPORT_PROVIDER protocol = AMQP_Protocol;
+#endif
+
+static TRANSPORT_HANDLE HubTransport_Create(const char* connectionString) {
+    return IoTHubModuleClient_CreateFromConnectionString(connectionString, protocol);
+}
+
+static void HubTransport_Destroy(TRANSPORT_HANDLE handle) {
+    IoTHubModuleClient_Destroy(handle);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_SetOption(TRANSPORT_HANDLE handle, const char* optionName, const void* value) {
+    return IoTHubModuleClient_SetOption(handle, optionName, value);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_SetConnectionStatusCallback(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK connectionStatusCallback, void* context) {
+    return IoTHubModuleClient_SetConnectionStatusCallback(handle, connectionStatusCallback, context);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_SetModuleTwinCallback(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK moduleTwinCallback, void* context) {
+    return IoTHubModuleClient_SetModuleTwinCallback(handle, moduleTwinCallback, context);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_SendEventAsync(TRANSPORT_HANDLE handle, IOTHUB_MESSAGE_HANDLE message, IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK confirmationCallback, void* context) {
+    return IoTHubModuleClient_SendEventAsync(handle, message, confirmationCallback, context);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_SendReportedState(TRANSPORT_HANDLE handle, const unsigned char* reportedState, size_t size, IOTHUB_CLIENT_REPORTED_STATE_CALLBACK reportedStateCallback, void* context) {
+    return IoTHubModuleClient_SendReportedState(handle, reportedState, size, reportedStateCallback, context);
+}
+
+static TRANSPORT_HANDLE HubTransport_LL_Create(const char* connectionString) {
+    return IoTHubModuleClient_LL_CreateFromConnectionString(connectionString, protocol);
+}
+
+static void HubTransport_LL_Destroy(TRANSPORT_HANDLE handle) {
+    IoTHubModuleClient_LL_Destroy(handle);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_LL_SetOption(TRANSPORT_HANDLE handle, const char* optionName, const void* value) {
+    return IoTHubModuleClient_LL_SetOption(handle, optionName, value);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_LL_SetConnectionStatusCallback(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK connectionStatusCallback, void* context) {
+    return IoTHubModuleClient_LL_SetConnectionStatusCallback(handle, connectionStatusCallback, context);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_LL_SetModuleTwinCallback(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK moduleTwinCallback, void* context) {
+    return IoTHubModuleClient_LL_SetModuleTwinCallback(handle, moduleTwinCallback, context);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_LL_SendEventAsync(TRANSPORT_HANDLE handle, IOTHUB_MESSAGE_HANDLE message, IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK confirmationCallback, void* context) {
+    return IoTHubModuleClient_LL_SendEventAsync(handle, message, confirmationCallback, context);
+}
+
+static IOTHUB_CLIENT_RESULT HubTransport_LL_SendReportedState(TRANSPORT_HANDLE handle, const unsigned char* reportedState, size_t size, IOTHUB_CLIENT_REPORTED_STATE_CALLBACK reportedStateCallback, void* context) {
+    return IoTHubModuleClient_LL_SendReportedState(handle, reportedState, size, reportedStateCallback, context);
+}
+
+static void HubTransport_LL_DoWork(TRANSPORT_HANDLE handle) {
+    IoTHubModuleClient_LL_DoWork(handle);
+}
+
+static const TransportInterface hubTransport = {
+    HubTransport_Create,
+    HubTransport_Destroy,
+    HubTransport_SetOption,
+    HubTransport_SetConnectionStatusCallback,
+    HubTransport_SetModuleTwinCallback,
+    HubTransport_SendEventAsync,
+    HubTransport_SendReportedState,
+    NULL
+};
+
+static const TransportInterface hubLowLevelTransport = {
+    HubTransport_LL_Create,
+    HubTransport_LL_Destroy,
+    HubTransport_LL_SetOption,
+    HubTransport_LL_SetConnectionStatusCallback,
+    HubTransport_LL_SetModuleTwinCallback,
+    HubTransport_LL_SendEventAsync,
+    HubTransport_LL_SendReportedState,
+    HubTransport_LL_DoWork
+};
+
+const TransportInterface* HubTransport_GetInterface() {
+    return &hubTransport;
+}
+
+const TransportInterface* HubTransport_GetLowLevelInterface() {
+    return &hubLowLevelTransport;
+}
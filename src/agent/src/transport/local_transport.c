@@ -0,0 +1,549 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "transport/local_transport.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#include "local_config.h"
+#include "logger.h"
+#include "os_utils/file_utils.h"
+#include "utils.h"
+
+#define LOCAL_TRANSPORT_RECORD_HEADER_SIZE 256
+#define LOCAL_TRANSPORT_MISSING_PROPERTY "-"
+#define LOCAL_TRANSPORT_RECORD_MESSAGE "message"
+#define LOCAL_TRANSPORT_RECORD_REPORTED "reported"
+#define LOCAL_TRANSPORT_REPORTED_STATE_OK 200
+
+/**
+ * A message which waits for its confirmation.
+ */
+typedef struct _LocalTransportMessage {
+
+    struct _LocalTransportMessage* next;
+    unsigned char* data;
+    size_t size;
+    char* contentType;
+    char* contentEncoding;
+    uint64_t dueTime;
+    IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK confirmationCallback;
+    void* context;
+
+} LocalTransportMessage;
+
+/**
+ * An instance of the local transport. The callbacks are called on the worker thread of the instance,
+ * without its lock, like the module client calls them on its own thread.
+ */
+typedef struct _LocalTransport {
+
+    LOCK_HANDLE lock;
+    COND_HANDLE condition;
+    THREAD_HANDLE worker;
+    bool stop;
+
+    int sink;
+    const char* twinFilePath;
+    struct timespec twinModificationTime;
+    uint32_t latency;
+    uint32_t failureRate;
+    unsigned int seed;
+
+    IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK connectionStatusCallback;
+    void* connectionStatusContext;
+    bool connectionReported;
+    IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK twinCallback;
+    void* twinContext;
+
+    LocalTransportMessage* head;
+    LocalTransportMessage* tail;
+
+} LocalTransport;
+
+/**
+ * @brief Opens the sink, connects to it if it is a UNIX socket and opens it for append otherwise.
+ *
+ * @param   sinkPath    The path of the sink.
+ *
+ * @return the file descriptor of the sink on success, -1 otherwise.
+ */
+static int LocalTransport_OpenSink(const char* sinkPath);
+
+/**
+ * @brief Writes a record to the sink. The lock must be held.
+ *
+ * @param   transport       The transport.
+ * @param   kind            The kind of the record.
+ * @param   contentType     The content type of the data, NULL if it has none.
+ * @param   contentEncoding The content encoding of the data, NULL if it has none.
+ * @param   data            The data of the record.
+ * @param   size            The size of the data.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool LocalTransport_WriteRecord(LocalTransport* transport, const char* kind, const char* contentType, const char* contentEncoding, const unsigned char* data, size_t size);
+
+/**
+ * @brief Writes the whole buffer to the sink.
+ *
+ * @param   sink    The file descriptor of the sink.
+ * @param   buffer  The buffer to write.
+ * @param   size    The size of the buffer.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool LocalTransport_WriteAll(int sink, const void* buffer, size_t size);
+
+/**
+ * @brief The worker of the transport, reports the connection, delivers the twin and confirms the messages.
+ *
+ * @param   context     The transport.
+ *
+ * @return 0
+ */
+static int LocalTransport_Worker(void* context);
+
+/**
+ * @brief Reads the twin file if it changed since it was last delivered. The lock must be held.
+ *
+ * @param   transport   The transport.
+ * @param   size        Out param. The size of the twin.
+ *
+ * @return the twin, allocated with malloc, or NULL if the twin did not change or could not be read.
+ */
+static unsigned char* LocalTransport_ReadChangedTwin(LocalTransport* transport, size_t* size);
+
+/**
+ * @brief Frees a message.
+ *
+ * @param   message     The message to free.
+ */
+static void LocalTransport_FreeMessage(LocalTransportMessage* message);
+
+/**
+ * @brief Returns a monotonic time in milliseconds.
+ *
+ * @return the time.
+ */
+static uint64_t LocalTransport_GetTime();
+
+static TRANSPORT_HANDLE LocalTransport_Create(const char* connectionString) {
+    bool success = true;
+    LocalTransport* transport = malloc(sizeof(*transport));
+    if (transport == NULL) {
+        return NULL;
+    }
+    memset(transport, 0, sizeof(*transport));
+    transport->sink = -1;
+    transport->twinFilePath = LocalConfiguration_GetLocalTransportTwinFilePath();
+    transport->latency = LocalConfiguration_GetLocalTransportLatency();
+    transport->failureRate = LocalConfiguration_GetLocalTransportFailureRate();
+    transport->seed = (unsigned int)time(NULL);
+
+    transport->lock = Lock_Init();
+    if (transport->lock == NULL) {
+        success = false;
+        goto cleanup;
+    }
+
+    transport->condition = Condition_Init();
+    if (transport->condition == NULL) {
+        success = false;
+        goto cleanup;
+    }
+
+    transport->sink = LocalTransport_OpenSink(LocalConfiguration_GetLocalTransportSinkPath());
+    if (transport->sink == -1) {
+        success = false;
+        goto cleanup;
+    }
+
+    if (ThreadAPI_Create(&transport->worker, LocalTransport_Worker, transport) != THREADAPI_OK) {
+        Logger_Error("Could not start the local transport worker");
+        transport->worker = NULL;
+        success = false;
+        goto cleanup;
+    }
+
+cleanup:
+    if (!success) {
+        if (transport->sink != -1) {
+            close(transport->sink);
+        }
+        if (transport->condition != NULL) {
+            Condition_Deinit(transport->condition);
+        }
+        if (transport->lock != NULL) {
+            Lock_Deinit(transport->lock);
+        }
+        free(transport);
+        transport = NULL;
+    }
+
+    return transport;
+}
+
+static void LocalTransport_Destroy(TRANSPORT_HANDLE handle) {
+    LocalTransport* transport = (LocalTransport*)handle;
+    if (Lock(transport->lock) == LOCK_OK) {
+        transport->stop = true;
+        Condition_Post(transport->condition);
+        Unlock(transport->lock);
+    }
+
+    // the worker confirms the messages which were not delivered before it exits
+    ThreadAPI_Join(transport->worker, NULL);
+
+    close(transport->sink);
+    Condition_Deinit(transport->condition);
+    Lock_Deinit(transport->lock);
+    free(transport);
+}
+
+static IOTHUB_CLIENT_RESULT LocalTransport_SetOption(TRANSPORT_HANDLE handle, const char* optionName, const void* value) {
+    // the options tune the protocol of the hub, the local transport has none
+    return IOTHUB_CLIENT_OK;
+}
+
+static IOTHUB_CLIENT_RESULT LocalTransport_SetConnectionStatusCallback(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK connectionStatusCallback, void* context) {
+    LocalTransport* transport = (LocalTransport*)handle;
+    if (Lock(transport->lock) != LOCK_OK) {
+        return IOTHUB_CLIENT_ERROR;
+    }
+
+    transport->connectionStatusCallback = connectionStatusCallback;
+    transport->connectionStatusContext = context;
+    transport->connectionReported = false;
+    Condition_Post(transport->condition);
+
+    Unlock(transport->lock);
+    return IOTHUB_CLIENT_OK;
+}
+
+static IOTHUB_CLIENT_RESULT LocalTransport_SetModuleTwinCallback(TRANSPORT_HANDLE handle, IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK moduleTwinCallback, void* context) {
+    LocalTransport* transport = (LocalTransport*)handle;
+    if (Lock(transport->lock) != LOCK_OK) {
+        return IOTHUB_CLIENT_ERROR;
+    }
+
+    transport->twinCallback = moduleTwinCallback;
+    transport->twinContext = context;
+    // a new subscriber gets the complete twin
+    memset(&transport->twinModificationTime, 0, sizeof(transport->twinModificationTime));
+    Condition_Post(transport->condition);
+
+    Unlock(transport->lock);
+    return IOTHUB_CLIENT_OK;
+}
+
+static IOTHUB_CLIENT_RESULT LocalTransport_SendEventAsync(TRANSPORT_HANDLE handle, IOTHUB_MESSAGE_HANDLE message, IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK confirmationCallback, void* context) {
+    LocalTransport* transport = (LocalTransport*)handle;
+    IOTHUB_CLIENT_RESULT result = IOTHUB_CLIENT_OK;
+    const unsigned char* data = NULL;
+    size_t size = 0;
+    const char* contentType = IoTHubMessage_GetContentTypeSystemProperty(message);
+    const char* contentEncoding = IoTHubMessage_GetContentEncodingSystemProperty(message);
+
+    LocalTransportMessage* localMessage = malloc(sizeof(*localMessage));
+    if (localMessage == NULL) {
+        result = IOTHUB_CLIENT_ERROR;
+        goto cleanup;
+    }
+    memset(localMessage, 0, sizeof(*localMessage));
+
+    if (IoTHubMessage_GetByteArray(message, &data, &size) != IOTHUB_MESSAGE_OK) {
+        result = IOTHUB_CLIENT_ERROR;
+        goto cleanup;
+    }
+
+    localMessage->data = malloc(size > 0 ? size : 1);
+    if (localMessage->data == NULL) {
+        result = IOTHUB_CLIENT_ERROR;
+        goto cleanup;
+    }
+    memcpy(localMessage->data, data, size);
+    localMessage->size = size;
+
+    if ((contentType != NULL && !Utils_CreateStringCopy(&localMessage->contentType, contentType)) ||
+            (contentEncoding != NULL && !Utils_CreateStringCopy(&localMessage->contentEncoding, contentEncoding))) {
+        result = IOTHUB_CLIENT_ERROR;
+        goto cleanup;
+    }
+
+    localMessage->confirmationCallback = confirmationCallback;
+    localMessage->context = context;
+    localMessage->dueTime = LocalTransport_GetTime() + transport->latency;
+
+    if (Lock(transport->lock) != LOCK_OK) {
+        result = IOTHUB_CLIENT_ERROR;
+        goto cleanup;
+    }
+
+    // the latency is the same for every message, so the queue is ordered by the due time
+    if (transport->tail == NULL) {
+        transport->head = localMessage;
+    } else {
+        transport->tail->next = localMessage;
+    }
+    transport->tail = localMessage;
+    localMessage = NULL;
+    Condition_Post(transport->condition);
+
+    Unlock(transport->lock);
+
+cleanup:
+    if (localMessage != NULL) {
+        LocalTransport_FreeMessage(localMessage);
+    }
+
+    return result;
+}
+
+static IOTHUB_CLIENT_RESULT LocalTransport_SendReportedState(TRANSPORT_HANDLE handle, const unsigned char* reportedState, size_t size, IOTHUB_CLIENT_REPORTED_STATE_CALLBACK reportedStateCallback, void* context) {
+    LocalTransport* transport = (LocalTransport*)handle;
+    if (Lock(transport->lock) != LOCK_OK) {
+        return IOTHUB_CLIENT_ERROR;
+    }
+
+    bool written = LocalTransport_WriteRecord(transport, LOCAL_TRANSPORT_RECORD_REPORTED, NULL, NULL, reportedState, size);
+
+    Unlock(transport->lock);
+
+    if (!written) {
+        return IOTHUB_CLIENT_ERROR;
+    }
+
+    if (reportedStateCallback != NULL) {
+        reportedStateCallback(LOCAL_TRANSPORT_REPORTED_STATE_OK, context);
+    }
+
+    return IOTHUB_CLIENT_OK;
+}
+
+static int LocalTransport_Worker(void* context) {
+    LocalTransport* transport = (LocalTransport*)context;
+    if (Lock(transport->lock) != LOCK_OK) {
+        Logger_Error("Could not lock the local transport, the worker exits");
+        return 0;
+    }
+
+    while (!transport->stop) {
+        if (transport->connectionStatusCallback != NULL && !transport->connectionReported) {
+            transport->connectionReported = true;
+            IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK callback = transport->connectionStatusCallback;
+            void* callbackContext = transport->connectionStatusContext;
+            Unlock(transport->lock);
+            callback(IOTHUB_CLIENT_CONNECTION_AUTHENTICATED, IOTHUB_CLIENT_CONNECTION_OK, callbackContext);
+            Lock(transport->lock);
+            continue;
+        }
+
+        size_t twinSize = 0;
+        unsigned char* twin = (transport->twinCallback != NULL) ? LocalTransport_ReadChangedTwin(transport, &twinSize) : NULL;
+        if (twin != NULL) {
+            IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK callback = transport->twinCallback;
+            void* callbackContext = transport->twinContext;
+            Unlock(transport->lock);
+            callback(DEVICE_TWIN_UPDATE_COMPLETE, twin, twinSize, callbackContext);
+            free(twin);
+            Lock(transport->lock);
+            continue;
+        }
+
+        uint64_t currentTime = LocalTransport_GetTime();
+        LocalTransportMessage* message = transport->head;
+        if (message != NULL && message->dueTime <= currentTime) {
+            transport->head = message->next;
+            if (transport->head == NULL) {
+                transport->tail = NULL;
+            }
+
+            IOTHUB_CLIENT_CONFIRMATION_RESULT result = IOTHUB_CLIENT_CONFIRMATION_ERROR;
+            if ((uint32_t)(rand_r(&transport->seed) % 100) >= transport->failureRate &&
+                    LocalTransport_WriteRecord(transport, LOCAL_TRANSPORT_RECORD_MESSAGE, message->contentType, message->contentEncoding, message->data, message->size)) {
+                result = IOTHUB_CLIENT_CONFIRMATION_OK;
+            }
+
+            Unlock(transport->lock);
+            if (message->confirmationCallback != NULL) {
+                message->confirmationCallback(result, message->context);
+            }
+            LocalTransport_FreeMessage(message);
+            Lock(transport->lock);
+            continue;
+        }
+
+        uint64_t timeout = LOCAL_TRANSPORT_TWIN_POLL_INTERVAL;
+        if (message != NULL && message->dueTime - currentTime < timeout) {
+            timeout = message->dueTime - currentTime;
+        }
+        Condition_Wait(transport->condition, transport->lock, (int)timeout);
+    }
+
+    LocalTransportMessage* message = transport->head;
+    transport->head = NULL;
+    transport->tail = NULL;
+    Unlock(transport->lock);
+
+    while (message != NULL) {
+        LocalTransportMessage* next = message->next;
+        if (message->confirmationCallback != NULL) {
+            message->confirmationCallback(IOTHUB_CLIENT_CONFIRMATION_BECAUSE_DESTROY, message->context);
+        }
+        LocalTransport_FreeMessage(message);
+        message = next;
+    }
+
+    return 0;
+}
+
+static unsigned char* LocalTransport_ReadChangedTwin(LocalTransport* transport, size_t* size) {
+    struct stat twinStat;
+    if (transport->twinFilePath == NULL || stat(transport->twinFilePath, &twinStat) != 0 || twinStat.st_size == 0) {
+        return NULL;
+    }
+
+    if (twinStat.st_mtim.tv_sec == transport->twinModificationTime.tv_sec && twinStat.st_mtim.tv_nsec == transport->twinModificationTime.tv_nsec) {
+        return NULL;
+    }
+
+    unsigned char* twin = malloc(twinStat.st_size + 1);
+    if (twin == NULL) {
+        return NULL;
+    }
+    memset(twin, 0, twinStat.st_size + 1);
+
+    if (FileUtils_ReadFile(transport->twinFilePath, twin, twinStat.st_size, true) != FILE_UTILS_OK) {
+        Logger_Error("Could not read the twin file of the local transport");
+        free(twin);
+        return NULL;
+    }
+
+    transport->twinModificationTime = twinStat.st_mtim;
+    *size = strlen((char*)twin);
+    return twin;
+}
+
+static int LocalTransport_OpenSink(const char* sinkPath) {
+    if (sinkPath == NULL) {
+        Logger_Error("The local transport has no sink");
+        return -1;
+    }
+
+    struct stat sinkStat;
+    if (stat(sinkPath, &sinkStat) != 0 || !S_ISSOCK(sinkStat.st_mode)) {
+        int sink = open(sinkPath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (sink == -1) {
+            Logger_Error("Could not open the local transport sink %s, errno %d", sinkPath, errno);
+        }
+        return sink;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(sinkPath) >= sizeof(address.sun_path)) {
+        Logger_Error("The local transport sink path is too long for a socket");
+        return -1;
+    }
+    strcpy(address.sun_path, sinkPath);
+
+    int sink = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sink == -1) {
+        Logger_Error("Could not create a socket for the local transport sink, errno %d", errno);
+        return -1;
+    }
+
+    if (connect(sink, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        Logger_Error("Could not connect to the local transport sink %s, errno %d", sinkPath, errno);
+        close(sink);
+        return -1;
+    }
+
+    return sink;
+}
+
+static bool LocalTransport_WriteRecord(LocalTransport* transport, const char* kind, const char* contentType, const char* contentEncoding, const unsigned char* data, size_t size) {
+    char header[LOCAL_TRANSPORT_RECORD_HEADER_SIZE];
+    int headerSize = snprintf(header, sizeof(header), "%s %s %s %zu\n", kind,
+        (contentType != NULL) ? contentType : LOCAL_TRANSPORT_MISSING_PROPERTY,
+        (contentEncoding != NULL) ? contentEncoding : LOCAL_TRANSPORT_MISSING_PROPERTY, size);
+    if (headerSize < 0 || (size_t)headerSize >= sizeof(header)) {
+        return false;
+    }
+
+    return LocalTransport_WriteAll(transport->sink, header, headerSize) &&
+        LocalTransport_WriteAll(transport->sink, data, size) &&
+        LocalTransport_WriteAll(transport->sink, "\n", 1);
+}
+
+static bool LocalTransport_WriteAll(int sink, const void* buffer, size_t size) {
+    const char* current = buffer;
+    while (size > 0) {
+        // a socket sink which went away fails the write instead of raising SIGPIPE
+        ssize_t written = send(sink, current, size, MSG_NOSIGNAL);
+        if (written == -1 && errno == ENOTSOCK) {
+            written = write(sink, current, size);
+        }
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger_Error("Could not write to the local transport sink, errno %d", errno);
+            return false;
+        }
+        current += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+static void LocalTransport_FreeMessage(LocalTransportMessage* message) {
+    if (message->data != NULL) {
+        free(message->data);
+    }
+    if (message->contentType != NULL) {
+        free(message->contentType);
+    }
+    if (message->contentEncoding != NULL) {
+        free(message->contentEncoding);
+    }
+    free(message);
+}
+
+static uint64_t LocalTransport_GetTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static const TransportInterface localTransport = {
+    LocalTransport_Create,
+    LocalTransport_Destroy,
+    LocalTransport_SetOption,
+    LocalTransport_SetConnectionStatusCallback,
+    LocalTransport_SetModuleTwinCallback,
+    LocalTransport_SendEventAsync,
+    LocalTransport_SendReportedState,
+    NULL
+};
+
+const TransportInterface* LocalTransport_GetInterface() {
+    return &localTransport;
+}
@@ -31,6 +31,10 @@ typedef struct _TwinConfiguration {
     char* baselineCustomChecksFilePath;
     char* baselineCustomChecksFileHash;
 
+    bool messageCompressionEnabled;
+    bool columnarMessagesEnabled;
+    uint32_t maxInFlightMessages;
+
     LOCK_HANDLE lock;
 } TwinConfiguration;
 
@@ -115,6 +119,9 @@ TwinConfigurationResult TwinConfiguration_Init() {
         returnValue = TWIN_MEMORY_EXCEPTION;
         goto cleanup;
     }
+    twinConfiguration.messageCompressionEnabled = DEFAULT_MESSAGE_COMPRESSION_ENABLED;
+    twinConfiguration.columnarMessagesEnabled = DEFAULT_COLUMNAR_MESSAGES_ENABLED;
+    twinConfiguration.maxInFlightMessages = DEFAULT_MAX_IN_FLIGHT_MESSAGES;
     twinConfigurationObjectName = LocalConfiguration_GetRemoteConfigurationObjectName();
 
     returnValue = TwinConfigurationEventCollectors_Init();
@@ -154,6 +161,10 @@ TwinConfigurationResult TwinConfiguration_DeepCopy(TwinConfiguration* dest, Twin
         goto cleanup;
     }
 
+    dest->messageCompressionEnabled = src->messageCompressionEnabled;
+    dest->columnarMessagesEnabled = src->columnarMessagesEnabled;
+    dest->maxInFlightMessages = src->maxInFlightMessages;
+
 cleanup:
     return returnValue;
 }
@@ -291,6 +302,18 @@ TwinConfigurationResult TwinConfiguration_GetBaselineCustomChecksFileHash(char**
     return TwinConfiguration_GetFieldString(baselineCustomChecksFileHash, twinConfiguration.baselineCustomChecksFileHash);
 }
 
+TwinConfigurationResult TwinConfiguration_GetMessageCompressionEnabled(bool* messageCompressionEnabled) {
+    return TwinConfiguration_GetFieldBool(messageCompressionEnabled, twinConfiguration.messageCompressionEnabled);
+}
+
+TwinConfigurationResult TwinConfiguration_GetColumnarMessagesEnabled(bool* columnarMessagesEnabled) {
+    return TwinConfiguration_GetFieldBool(columnarMessagesEnabled, twinConfiguration.columnarMessagesEnabled);
+}
+
+TwinConfigurationResult TwinConfiguration_GetMaxInFlightMessages(uint32_t* maxInFlightMessages) {
+    return TwinConfiguration_GetFieldInteger(maxInFlightMessages, twinConfiguration.maxInFlightMessages);
+}
+
 static TwinConfigurationResult TwinConfiguration_SetSingleUintValueFromJsonOrDefault(uint32_t* value, uint32_t defaultValue, JsonObjectReaderHandle reader, const char* key, bool isTime, TwinConfigurationStatus* outStatus) {
     *outStatus = CONFIGURATION_OK;
     TwinConfigurationResult result;
@@ -414,6 +437,30 @@ static TwinConfigurationResult TwinConfiguration_ExtractConfiguration(JsonObject
         goto cleanup;
     }
 
+    currentKeyResult = TwinConfiguration_SetSingleBoolValueFromJsonOrDefault(&(newConfiguration->messageCompressionEnabled), DEFAULT_MESSAGE_COMPRESSION_ENABLED, jsonReader, MESSAGE_COMPRESSION_ENABLED_KEY, &(parsingResult->messageCompressionEnabled));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleBoolValueFromJsonOrDefault(&(newConfiguration->columnarMessagesEnabled), DEFAULT_COLUMNAR_MESSAGES_ENABLED, jsonReader, COLUMNAR_MESSAGES_ENABLED_KEY, &(parsingResult->columnarMessagesEnabled));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleUintValueFromJsonOrDefault(&(newConfiguration->maxInFlightMessages), DEFAULT_MAX_IN_FLIGHT_MESSAGES, jsonReader, MAX_IN_FLIGHT_MESSAGES_KEY, false, &(parsingResult->maxInFlightMessages));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
 cleanup:
     return result;
 }
@@ -544,6 +591,21 @@ TwinConfigurationResult TwinConfiguration_GetSerializedTwinConfiguration(char**
         goto cleanup;
     }
 
+    result = TwinConfigurationUtils_WriteBoolConfigurationToJson(configurationObject, MESSAGE_COMPRESSION_ENABLED_KEY, twinConfiguration.messageCompressionEnabled);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteBoolConfigurationToJson(configurationObject, COLUMNAR_MESSAGES_ENABLED_KEY, twinConfiguration.columnarMessagesEnabled);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteUintConfigurationToJson(configurationObject, MAX_IN_FLIGHT_MESSAGES_KEY, twinConfiguration.maxInFlightMessages);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
     result = TwinConfigurationEventCollectors_GetPrioritiesJson(configurationObject);
     if (result != TWIN_OK){
         goto cleanup;
@@ -5,6 +5,8 @@
 #define EVENT_PRIO_PREFIX "eventPriority"
 #define EVENT_AGG_ENABLED_PREFIX "aggregationEnabled"
 #define EVENT_AGG_INTERVAL_PREFIX "aggregationInterval"
+#define SNAPSHOT_INTERVAL_PREFIX "snapshotInterval"
+#define SNAPSHOT_OFFSET_PREFIX "snapshotOffset"
 #define BASELINE_CUSTOM_CHECKS_PREFIX "baselineCustomChecks"
 
 /* ===== Twin configuration Schema =====*/
@@ -13,6 +15,9 @@ const char* HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY = "highPriorityMessageFrequency"
 const char* MAX_LOCAL_CACHE_SIZE_KEY = "maxLocalCacheSizeInBytes";
 const char* MAX_MESSAGE_SIZE_KEY = "maxMessageSizeInBytes";
 const char* SNAPSHOT_FREQUENCY_KEY = "snapshotFrequency";
+const char* MESSAGE_COMPRESSION_ENABLED_KEY = "messageCompressionEnabled";
+const char* COLUMNAR_MESSAGES_ENABLED_KEY = "columnarMessagesEnabled";
+const char* MAX_IN_FLIGHT_MESSAGES_KEY = "maxInFlightMessages";
 const char* HUB_RESOURCE_ID_KEY = "hubResourceId";
 const char* EVENT_PROPERTIES_KEY = "eventPriorities";
 
@@ -34,6 +39,18 @@ const char* PROCESS_CREATE_AGGREGATION_INTERVAL_KEY = EVENT_AGG_INTERVAL_PREFIX"
 const char* CONNECTION_CREATE_AGGREGATION_ENABLED_KEY = EVENT_AGG_ENABLED_PREFIX"ConnectionCreate";
 const char* CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY = EVENT_AGG_INTERVAL_PREFIX"ConnectionCreate";
 
+/* ===== Snapshot Schedule Schema =====*/
+const char* LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY = SNAPSHOT_INTERVAL_PREFIX"ListeningPorts";
+const char* LISTENING_PORTS_SNAPSHOT_OFFSET_KEY = SNAPSHOT_OFFSET_PREFIX"ListeningPorts";
+const char* FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY = SNAPSHOT_INTERVAL_PREFIX"FirewallConfiguration";
+const char* FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY = SNAPSHOT_OFFSET_PREFIX"FirewallConfiguration";
+const char* BASELINE_SNAPSHOT_INTERVAL_KEY = SNAPSHOT_INTERVAL_PREFIX"OSBaseline";
+const char* BASELINE_SNAPSHOT_OFFSET_KEY = SNAPSHOT_OFFSET_PREFIX"OSBaseline";
+const char* LOCAL_USERS_SNAPSHOT_INTERVAL_KEY = SNAPSHOT_INTERVAL_PREFIX"LocalUsers";
+const char* LOCAL_USERS_SNAPSHOT_OFFSET_KEY = SNAPSHOT_OFFSET_PREFIX"LocalUsers";
+const char* SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY = SNAPSHOT_INTERVAL_PREFIX"SystemInformation";
+const char* SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY = SNAPSHOT_OFFSET_PREFIX"SystemInformation";
+
 /* ===== Baseline custom checks configuration =====*/
 const char* BASELINE_CUSTOM_CHECKS_ENABLED_KEY = BASELINE_CUSTOM_CHECKS_PREFIX"Enabled";
 const char* BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY = BASELINE_CUSTOM_CHECKS_PREFIX"FilePath";
@@ -31,6 +31,7 @@ static const bool PROCESS_CREATE_AGGREGATION_ENABLED = true;
 static const bool CONNECTION_CREATE_AGGREGATION_ENABLED = true;
 static const uint32_t PROCESS_CREATE_AGGREGATION_INTERVAL = MILLISECONDS_IN_AN_HOUR;
 static const uint32_t CONNECTION_CREATE_AGGREGATION_INTERVAL = MILLISECONDS_IN_AN_HOUR;
+static const TwinConfigurationSnapshotSchedule DEFAULT_SNAPSHOT_SCHEDULE = { 0, 0 };
 
 typedef struct _TwinConfigurationEventCollectors {
     TwinConfigurationEventPriority processCreatePriority;
@@ -47,7 +48,11 @@ typedef struct _TwinConfigurationEventCollectors {
     bool connectionCreateAggregationEnabled;
     uint32_t processCreateAggregationInterval;
     uint32_t connectionCreateAggregationInterval;
-
+    TwinConfigurationSnapshotSchedule listeningPortsSnapshot;
+    TwinConfigurationSnapshotSchedule firewallConfigurationSnapshot;
+    TwinConfigurationSnapshotSchedule baselineSnapshot;
+    TwinConfigurationSnapshotSchedule localUsersSnapshot;
+    TwinConfigurationSnapshotSchedule systemInformationSnapshot;
 
     LOCK_HANDLE lock;
     bool isLocked;
@@ -100,6 +105,30 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleBoolVal
  */
 static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleUintTimeValue(JsonObjectReaderHandle propertiesReader, const char* key, uint32_t* field, uint32_t defaultValue);
 
+/**
+ * @brief Set the snapshot schedule of a single event
+ * 
+ * @param   propertiesReader    The json reader of the preperties.
+ * @param   intervalKey         The interval key in the json.
+ * @param   offsetKey           The offset key in the json.
+ * @param   field               The field of the schedule.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfigurationEventCollectors_SetSnapshotSchedule(JsonObjectReaderHandle propertiesReader, const char* intervalKey, const char* offsetKey, TwinConfigurationSnapshotSchedule* field);
+
+/**
+ * @brief writes the snapshot schedule of a single event
+ * 
+ * @param   prioritiesJson      json object writer handle
+ * @param   intervalKey         The interval key in the json.
+ * @param   offsetKey           The offset key in the json.
+ * @param   schedule            The schedule to write.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfigurationEventCollectors_WriteSnapshotSchedule(JsonObjectWriterHandle prioritiesJson, const char* intervalKey, const char* offsetKey, const TwinConfigurationSnapshotSchedule* schedule);
+
 
 /**
  * @brief returns the enum type representing this value.
@@ -161,6 +190,11 @@ TwinConfigurationResult TwinConfigurationEventCollectors_Init() {
     eventPriorities.processCreateAggregationInterval = PROCESS_CREATE_AGGREGATION_INTERVAL;
     eventPriorities.connectionCreateAggregationEnabled = CONNECTION_CREATE_AGGREGATION_ENABLED;
     eventPriorities.connectionCreateAggregationInterval = CONNECTION_CREATE_AGGREGATION_INTERVAL;
+    eventPriorities.listeningPortsSnapshot = DEFAULT_SNAPSHOT_SCHEDULE;
+    eventPriorities.firewallConfigurationSnapshot = DEFAULT_SNAPSHOT_SCHEDULE;
+    eventPriorities.baselineSnapshot = DEFAULT_SNAPSHOT_SCHEDULE;
+    eventPriorities.localUsersSnapshot = DEFAULT_SNAPSHOT_SCHEDULE;
+    eventPriorities.systemInformationSnapshot = DEFAULT_SNAPSHOT_SCHEDULE;
 
     return TWIN_OK;
 }
@@ -173,8 +207,8 @@ void TwinConfigurationEventCollectors_Deinit() {
 }
 
 bool TwinConfigurationEventCollectors_Lock() {
-    if (eventPriorities.isLocked == true 
-        || Lock(eventPriorities.lock) != LOCK_OK) {
+    // the collectors read the configuration from several threads, so a taken lock is waited for rather than failed
+    if (Lock(eventPriorities.lock) != LOCK_OK) {
         return false;
     }
 
@@ -183,12 +217,15 @@ bool TwinConfigurationEventCollectors_Lock() {
 }
 
 bool TwinConfigurationEventCollectors_Unlock() {
-    if (eventPriorities.isLocked == true
-        && Unlock(eventPriorities.lock) != LOCK_OK ) {
-        return false;
+    if (eventPriorities.isLocked == false) {
+        return true;
     }
 
     eventPriorities.isLocked = false;
+    if (Unlock(eventPriorities.lock) != LOCK_OK) {
+        return false;
+    }
+
     return true;
 }
 
@@ -278,6 +315,42 @@ cleanup:
     return result;
 }
 
+TwinConfigurationResult TwinConfigurationEventCollectors_GetSnapshotSchedule(TwinConfigurationEventType eventType, TwinConfigurationSnapshotSchedule* schedule) {
+    TwinConfigurationResult result = TWIN_OK;
+    if (TwinConfigurationEventCollectors_Lock() == false) {
+        result = TWIN_LOCK_EXCEPTION;
+        goto cleanup;
+    }
+
+    switch (eventType) {
+        case EVENT_TYPE_LISTENING_PORTS:
+            *schedule = eventPriorities.listeningPortsSnapshot;
+            break;
+        case EVENT_TYPE_FIREWALL_CONFIGURATION:
+            *schedule = eventPriorities.firewallConfigurationSnapshot;
+            break;
+        case EVENT_TYPE_BASELINE:
+            *schedule = eventPriorities.baselineSnapshot;
+            break;
+        case EVENT_TYPE_LOCAL_USERS:
+            *schedule = eventPriorities.localUsersSnapshot;
+            break;
+        case EVENT_TYPE_SYSTEM_INFORMATION:
+            *schedule = eventPriorities.systemInformationSnapshot;
+            break;
+        default:
+            *schedule = DEFAULT_SNAPSHOT_SCHEDULE;
+            break;
+    }
+    
+cleanup:
+    if (TwinConfigurationEventCollectors_Unlock() == false) {
+        result = TWIN_LOCK_EXCEPTION;
+    }
+    
+    return result;
+}
+
 TwinConfigurationResult  TwinConfigurationEventCollectors_GetPrioritiesJson(JsonObjectWriterHandle prioritiesJson){
     TwinConfigurationResult result = TWIN_OK;
     if (TwinConfigurationEventCollectors_Lock() == false) {
@@ -371,6 +444,31 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetValues(JsonOb
         goto cleanup;
     }
 
+    result = TwinConfigurationEventCollectors_SetSnapshotSchedule(propertiesReader, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, &(newPriorities.listeningPortsSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_SetSnapshotSchedule(propertiesReader, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, &(newPriorities.firewallConfigurationSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_SetSnapshotSchedule(propertiesReader, BASELINE_SNAPSHOT_INTERVAL_KEY, BASELINE_SNAPSHOT_OFFSET_KEY, &(newPriorities.baselineSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_SetSnapshotSchedule(propertiesReader, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, &(newPriorities.localUsersSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_SetSnapshotSchedule(propertiesReader, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, &(newPriorities.systemInformationSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
 cleanup:
     if (result == TWIN_OK){
         newPriorities.lock = eventPriorities.lock;
@@ -422,6 +520,33 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleUintTim
     return result;
 }
 
+static TwinConfigurationResult TwinConfigurationEventCollectors_SetSnapshotSchedule(JsonObjectReaderHandle propertiesReader, const char* intervalKey, const char* offsetKey, TwinConfigurationSnapshotSchedule* field) {
+    TwinConfigurationResult result = TwinConfigurationEventCollectors_SetSingleUintTimeValue(propertiesReader, intervalKey, &(field->interval), DEFAULT_SNAPSHOT_SCHEDULE.interval);
+    if (result != TWIN_OK) {
+        return result;
+    }
+
+    return TwinConfigurationEventCollectors_SetSingleUintTimeValue(propertiesReader, offsetKey, &(field->offset), DEFAULT_SNAPSHOT_SCHEDULE.offset);
+}
+
+static TwinConfigurationResult TwinConfigurationEventCollectors_WriteSnapshotSchedule(JsonObjectWriterHandle prioritiesJson, const char* intervalKey, const char* offsetKey, const TwinConfigurationSnapshotSchedule* schedule) {
+    char iso8601Duration[DURATION_MAX_LENGTH] = {0};
+    if (TimeUtils_MillisecondsToISO8601DurationString(schedule->interval, iso8601Duration, DURATION_MAX_LENGTH) == false) {
+        return TWIN_EXCEPTION;
+    }
+
+    TwinConfigurationResult result = TwinConfigurationUtils_WriteStringConfigurationToJson(prioritiesJson, intervalKey, iso8601Duration);
+    if (result != TWIN_OK) {
+        return result;
+    }
+
+    if (TimeUtils_MillisecondsToISO8601DurationString(schedule->offset, iso8601Duration, DURATION_MAX_LENGTH) == false) {
+        return TWIN_EXCEPTION;
+    }
+
+    return TwinConfigurationUtils_WriteStringConfigurationToJson(prioritiesJson, offsetKey, iso8601Duration);
+}
+
 static TwinConfigurationResult TwinConfigurationEventCollectors_PriorityAsEnum(const char* str, TwinConfigurationEventPriority* priority) {
     if (Utils_UnsafeAreStringsEqual(str, PRIORITY_HIGH, false)) {
         *priority = EVENT_PRIORITY_HIGH;
@@ -581,6 +706,31 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SafeGetPrioritie
         goto cleanup;
     }
 
+    result = TwinConfigurationEventCollectors_WriteSnapshotSchedule(prioritiesJson, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, &(eventPriorities.listeningPortsSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_WriteSnapshotSchedule(prioritiesJson, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, &(eventPriorities.firewallConfigurationSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_WriteSnapshotSchedule(prioritiesJson, BASELINE_SNAPSHOT_INTERVAL_KEY, BASELINE_SNAPSHOT_OFFSET_KEY, &(eventPriorities.baselineSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_WriteSnapshotSchedule(prioritiesJson, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, &(eventPriorities.localUsersSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_WriteSnapshotSchedule(prioritiesJson, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, &(eventPriorities.systemInformationSnapshot));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
 
 cleanup:
     return result;
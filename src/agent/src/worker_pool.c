@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "worker_pool.h"
+
+#include <string.h>
+
+#include "logger.h"
+
+/**
+ * @brief The main function of a thread of the pool, runs the queued jobs until the pool is stopped.
+ *
+ * @param   params  The pool instance.
+ *
+ * @return always 0.
+ */
+static int WorkerPool_MainFunc(void* params);
+
+void WorkerPool_InitJob(WorkerPoolJob* job, WorkerPoolJobFunc function, void* context) {
+    memset(job, 0, sizeof(*job));
+    job->function = function;
+    job->context = context;
+}
+
+bool WorkerPool_Init(WorkerPool* pool, uint32_t numberOfThreads) {
+    memset(pool, 0, sizeof(*pool));
+    if (numberOfThreads == 0 || numberOfThreads > WORKER_POOL_MAX_THREADS) {
+        Logger_Error("A worker pool has between 1 and %d threads, %u were requested", WORKER_POOL_MAX_THREADS, numberOfThreads);
+        return false;
+    }
+
+    pool->lock = Lock_Init();
+    if (pool->lock == NULL) {
+        return false;
+    }
+
+    pool->condition = Condition_Init();
+    if (pool->condition == NULL) {
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < numberOfThreads; ++i) {
+        if (ThreadAPI_Create(&pool->threads[i], WorkerPool_MainFunc, pool) != THREADAPI_OK) {
+            Logger_Error("Could not start a thread of the worker pool");
+            goto cleanup;
+        }
+        ++pool->numberOfThreads;
+    }
+
+    return true;
+
+cleanup:
+    WorkerPool_Deinit(pool);
+    return false;
+}
+
+void WorkerPool_Deinit(WorkerPool* pool) {
+    if (pool->lock == NULL) {
+        return;
+    }
+
+    if (Lock(pool->lock) == LOCK_OK) {
+        pool->stop = true;
+        // the jobs which did not start are dropped, so they can be submitted to another pool
+        while (pool->head != NULL) {
+            WorkerPoolJob* job = pool->head;
+            pool->head = job->next;
+            job->next = NULL;
+            job->busy = false;
+        }
+        pool->tail = NULL;
+
+        if (pool->condition != NULL) {
+            Condition_Post(pool->condition);
+        }
+        Unlock(pool->lock);
+
+        for (uint32_t i = 0; i < pool->numberOfThreads; ++i) {
+            int result;
+            ThreadAPI_Join(pool->threads[i], &result);
+        }
+    }
+
+    if (pool->condition != NULL) {
+        Condition_Deinit(pool->condition);
+    }
+    Lock_Deinit(pool->lock);
+    memset(pool, 0, sizeof(*pool));
+}
+
+WorkerPoolResult WorkerPool_Submit(WorkerPool* pool, WorkerPoolJob* job) {
+    if (pool->lock == NULL || Lock(pool->lock) != LOCK_OK) {
+        return WORKER_POOL_EXCEPTION;
+    }
+
+    WorkerPoolResult result = WORKER_POOL_OK;
+    if (pool->stop) {
+        result = WORKER_POOL_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (job->busy) {
+        result = WORKER_POOL_JOB_BUSY;
+        goto cleanup;
+    }
+
+    job->busy = true;
+    job->next = NULL;
+    if (pool->tail != NULL) {
+        pool->tail->next = job;
+    } else {
+        pool->head = job;
+    }
+    pool->tail = job;
+    Condition_Post(pool->condition);
+
+cleanup:
+    Unlock(pool->lock);
+    return result;
+}
+
+static int WorkerPool_MainFunc(void* params) {
+    WorkerPool* pool = (WorkerPool*)params;
+    if (Lock(pool->lock) != LOCK_OK) {
+        Logger_Error("Could not lock the worker pool, the thread exits");
+        return 0;
+    }
+
+    while (!pool->stop) {
+        if (pool->head == NULL) {
+            Condition_Wait(pool->condition, pool->lock, 0);
+            continue;
+        }
+
+        WorkerPoolJob* job = pool->head;
+        pool->head = job->next;
+        if (pool->head == NULL) {
+            pool->tail = NULL;
+        }
+        job->next = NULL;
+        Unlock(pool->lock);
+
+        job->function(job->context);
+
+        if (Lock(pool->lock) != LOCK_OK) {
+            Logger_Error("Could not lock the worker pool, the thread exits");
+            return 0;
+        }
+        job->busy = false;
+    }
+
+    // a single post may wake a single thread, so each thread wakes the next one on its way out
+    Condition_Post(pool->condition);
+    Unlock(pool->lock);
+    return 0;
+}
@@ -34,6 +34,6 @@ fi
 popd
 
 installed_packages_output=$build_root"/cmake/installed_packages.txt"
-dpkg -l cmake build-essential uuid-dev libssl-dev libaudit-dev libauparse-dev moreutils iptables-dev valgrind > $installed_packages_output
+dpkg -l cmake build-essential uuid-dev zlib1g-dev libssl-dev libaudit-dev libauparse-dev moreutils iptables-dev valgrind > $installed_packages_output
 
 echo 'build finished'
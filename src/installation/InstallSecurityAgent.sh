@@ -4,6 +4,7 @@ _userName="asciotagent"
 _serviceTemplateName="ASCIoTAgent.service"
 _systemServiceFileLocation="/etc/systemd/system"
 _targetDirectory="/var/ASCIoTAgent"
+_stateDirectory="/var/lib/ASCIoTAgent"
 _execName="ASCIoTAgent"
 _scriptDir=
 _mode="none"
@@ -65,6 +66,9 @@ uninstallagent()
     #remove the agent files
     rm -rf $_targetDirectory
 
+    #remove the spilled events
+    rm -rf $_stateDirectory
+
     #remove the service user
     deluser --remove-home --remove-all-files $_userName
 
@@ -129,6 +133,11 @@ installagent()
     #make the agent user owner of the target directory
     chown -R $_userName:$_userName $_targetDirectory
 
+    #the agent drops its root privileges before it opens the spill logs, so their directory is created for the agent user
+    mkdir -p $_stateDirectory/spill
+    chown -R $_userName:$_userName $_stateDirectory
+    chmod -R 700 $_stateDirectory
+
     #make agent executable
     chown root $_targetDirectory/$_execName
     chmod 4755 $_targetDirectory/$_execName
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include "collectors/generic_event.h"
+#include "os_utils/linux/audit/audit_stream.h"
 #include "synchronized_queue.h"
 #include "test_defs.h"
 
@@ -92,4 +93,17 @@ EventCollectorResult ConnectionCreateEventCollector_Init() {
 
 void ProcessCreationCollector_Deinit() { }
 
-void ConnectionCreateEventCollector_Deinit() { }
\ No newline at end of file
+void ConnectionCreateEventCollector_Deinit() { }
+
+// the collectors are mocked, so the agent runs without the audit stream
+bool AuditStream_Init(AuditStreamListener listener, void* context) {
+    return false;
+}
+
+void AuditStream_Deinit() { }
+
+int AuditStream_GetFd() {
+    return -1;
+}
+
+void AuditStream_OnReadable(void* context) { }
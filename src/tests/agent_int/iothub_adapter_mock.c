@@ -37,6 +37,14 @@ cleanup:
     return success;
 }
 
+bool IoTHubAdapter_IsConnected(IoTHubAdapter* iotHubAdapter) {
+    return true;
+}
+
+uint32_t IoTHubAdapter_DoWork(IoTHubAdapter* iotHubAdapter) {
+    return UINT32_MAX;
+}
+
 bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize) {
 
     if (Lock(sentMessages.lock) != LOCK_OK) {
@@ -54,6 +62,45 @@ bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* da
     return true;
 }
 
+bool IoTHubAdapter_SendEncodedMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding) {
+
+    if (Lock(sentMessages.lock) != LOCK_OK) {
+        return false;
+    }
+
+    sentMessages.items[sentMessages.index].data = malloc(dataSize);
+    memcpy(sentMessages.items[sentMessages.index].data, data, dataSize);
+    sentMessages.items[sentMessages.index].dataSize = dataSize;
+    sentMessages.index++;
+
+    if (Unlock(sentMessages.lock) != LOCK_OK) {
+        return false;
+    }
+
+    return true;
+}
+
+bool IoTHubAdapter_SendMessageWithConfirmationAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding, IoTHubAdapterSendConfirmation confirmationCallback, void* context) {
+
+    if (Lock(sentMessages.lock) != LOCK_OK) {
+        return false;
+    }
+
+    // json messages are sent without their terminator, it is kept here so they can be read as strings
+    sentMessages.items[sentMessages.index].data = malloc(dataSize + 1);
+    memcpy(sentMessages.items[sentMessages.index].data, data, dataSize);
+    ((char*)sentMessages.items[sentMessages.index].data)[dataSize] = '\0';
+    sentMessages.items[sentMessages.index].dataSize = dataSize;
+    sentMessages.index++;
+
+    if (Unlock(sentMessages.lock) != LOCK_OK) {
+        return false;
+    }
+
+    confirmationCallback(true, context);
+    return true;
+}
+
 bool IoTHubAdapter_SetReportedPropertiesAsync(IoTHubAdapter* iotHubAdapter, const void* reportedData, size_t dataSize) {
     return true;
 }
\ No newline at end of file
@@ -25,4 +25,22 @@ uint32_t LocalConfiguration_GetTriggeredEventInterval() {
 
 const char* LocalConfiguration_GetRemoteConfigurationObjectName() {
     return "ms_iotn:urn_azureiot_Security_SecurityAgentConfiguration";
-}
\ No newline at end of file
+}
+
+const char* LocalConfiguration_GetSpillLogDirectory() {
+    return "/tmp/agent_int/spill";
+}
+
+EventEncoding LocalConfiguration_GetEventEncoding() {
+    return EVENT_ENCODING_JSON;
+}
+
+uint32_t LocalConfiguration_GetSpillLogDiskQuota() {
+    // no spilling, so events left in the queues do not leak between the tests
+    return 0;
+}
+
+uint32_t LocalConfiguration_GetCollectorBudget(CollectorId id) {
+    // the collectors run under the default budgets
+    return 0;
+}
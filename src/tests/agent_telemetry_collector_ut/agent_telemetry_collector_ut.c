@@ -57,6 +57,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(AgentQueueMeter, int);
     REGISTER_UMOCK_ALIAS_TYPE(AgentTelemetryProviderResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(AgentTelemetryProviderResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(CollectorId, int);
     REGISTER_UMOCK_ALIAS_TYPE(EventCollectorResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonArrayReaderHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(JsonArrayWriterHandle, void*);
@@ -109,13 +110,58 @@ void setupAddMessageStatisticsPayloadAddExpectSuccess(){
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_SENT_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FAILED_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FILL_RATIO_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_RECONNECT_ATTEMPTS_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_DISCONNECTED_TIME_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+}
+
+void setupAddEvictedEventsPayloadAddExpectSuccess(const char* priorityName){
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_PRIORITY_KEY, priorityName)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_EVICTED_EVENTS_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+}
+
+void setupAddMemoryConsumptionPayloadAddExpectSuccess(const char* subsystemName){
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_SUBSYSTEM_KEY, subsystemName)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+}
+
+void setupMemoryConsumptionEventExpectSuccess(SyncQueue* queue){
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMemoryConsumption(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_MEMORY_CONSUMPTION_NAME, AGENT_TELEMETRY_MEMORY_CONSUMPTION_SCHEMA_VERSION);
+    setupAddMemoryConsumptionPayloadAddExpectSuccess("Queues");
+    setupAddMemoryConsumptionPayloadAddExpectSuccess("Json");
+    setupAddMemoryConsumptionPayloadAddExpectSuccess("ProcessHashes");
+    setupAddMemoryConsumptionPayloadAddExpectSuccess("Baseline");
+    setupAddMemoryConsumptionPayloadAddExpectSuccess("AuditStream");
+    setupPushEventExpectSuccess(queue);
+    setupCleanUpExpectSuccess();
+}
+
+void setupAddCollectorStatisticsPayloadAddExpectSuccess(CollectorId id, const char* collectorName, CollectorStatistics* statistics){
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(CollectorExecution_GetName(id)).SetReturn(collectorName);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_KEY, collectorName)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_RUNS_KEY, statistics->runs)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_OVERRUNS_KEY, statistics->overruns)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_SKIPPED_KEY, statistics->skipped)).SetReturn(JSON_WRITER_OK);
+    uint32_t averageDuration = statistics->runs == 0 ? 0 : (uint32_t)(statistics->totalDuration / statistics->runs);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_AVERAGE_DURATION_KEY, averageDuration)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_MAX_DURATION_KEY, statistics->maxDuration)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 }
 
 void setupPushEventExpectSuccess(SyncQueue* queue){
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(queue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
 }
 
@@ -140,12 +186,93 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsExpectSuccess)
     setupPushEventExpectSuccess(&queue);
     setupCleanUpExpectSuccess();    
     
+    //nothing was evicted, so no evicted events statistics
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
+
+    //memory consumption
+    setupMemoryConsumptionEventExpectSuccess(&queue);
+
+    //no collector ran, so no collector statistics
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
     
     EventCollectorResult result = AgentTelemetryCollector_GetEvents(&queue);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(AgentTelemetryProvider_GetEventsWithEvictedEventsExpectSuccess)
+{  
+    SyncQueue queue = {NULL};
+    EvictionCounter evictionCounter = { .lowPriority = 3, .aggregated = 0, .highPriority = 1 };
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_DROPPED_EVENTS_NAME, AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION);
+    setupAddDroppedEventsPayloadAddExpectSuccess(HIGH_PRIORITY);
+    setupAddDroppedEventsPayloadAddExpectSuccess(LOW_PRIORITY);
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();  
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME, AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION);
+    setupAddMessageStatisticsPayloadAddExpectSuccess();
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    //evicted events
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_counterData(&evictionCounter, sizeof(evictionCounter))
+        .SetReturn(TELEMETRY_PROVIDER_OK);
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_EVICTED_EVENTS_NAME, AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION);
+    setupAddEvictedEventsPayloadAddExpectSuccess("Low");
+    setupAddEvictedEventsPayloadAddExpectSuccess("Aggregated");
+    setupAddEvictedEventsPayloadAddExpectSuccess("High");
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    setupMemoryConsumptionEventExpectSuccess(&queue);
+
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
+
+    EventCollectorResult result = AgentTelemetryCollector_GetEvents(&queue);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AgentTelemetryProvider_GetEventsWithCollectorStatisticsExpectSuccess)
+{  
+    SyncQueue queue = {NULL};
+    CollectorStatistics statistics[COLLECTOR_COUNT] = {{0}};
+    statistics[COLLECTOR_BASELINE] = (CollectorStatistics){ .runs = 2, .overruns = 1, .skipped = 0, .totalDuration = 150000, .maxDuration = 120000 };
+    statistics[COLLECTOR_PROCESS_CREATION] = (CollectorStatistics){ .runs = 0, .overruns = 0, .skipped = 3, .totalDuration = 0, .maxDuration = 0 };
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_DROPPED_EVENTS_NAME, AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION);
+    setupAddDroppedEventsPayloadAddExpectSuccess(HIGH_PRIORITY);
+    setupAddDroppedEventsPayloadAddExpectSuccess(LOW_PRIORITY);
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();  
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME, AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION);
+    setupAddMessageStatisticsPayloadAddExpectSuccess();
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
+
+    setupMemoryConsumptionEventExpectSuccess(&queue);
+
+    //only the collectors which were scheduled are reported
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_statistics(statistics, sizeof(statistics))
+        .SetReturn(TELEMETRY_PROVIDER_OK);
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_COLLECTOR_STATISTICS_NAME, AGENT_TELEMETRY_COLLECTOR_STATISTICS_SCHEMA_VERSION);
+    setupAddCollectorStatisticsPayloadAddExpectSuccess(COLLECTOR_BASELINE, "Baseline", &statistics[COLLECTOR_BASELINE]);
+    setupAddCollectorStatisticsPayloadAddExpectSuccess(COLLECTOR_PROCESS_CREATION, "ProcessCreate", &statistics[COLLECTOR_PROCESS_CREATION]);
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    EventCollectorResult result = AgentTelemetryCollector_GetEvents(&queue);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 TEST_FUNCTION(AgentTelemetryProvider_GetEventsFail)
 {  
     umock_c_negative_tests_init();
@@ -173,7 +300,7 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsFail)
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(&queue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(1);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
@@ -189,20 +316,66 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsFail)
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_SENT_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FAILED_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FILL_RATIO_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(1);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 
+    //evicted events, nothing was evicted so no event is created
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG)).SetFailReturn(!TELEMETRY_PROVIDER_OK);
+
+    //memory consumption
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMemoryConsumption(IGNORED_PTR_ARG)).SetFailReturn(!TELEMETRY_PROVIDER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_AddMetadata(IGNORED_PTR_ARG, EVENT_PERIODIC_CATEGORY, AGENT_TELEMETRY_MEMORY_CONSUMPTION_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_MEMORY_CONSUMPTION_SCHEMA_VERSION)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_SUBSYSTEM_KEY, "Queues")).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_SUBSYSTEM_KEY, "Json")).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_SUBSYSTEM_KEY, "ProcessHashes")).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_SUBSYSTEM_KEY, "Baseline")).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_SUBSYSTEM_KEY, "AuditStream")).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_ALLOCATED_BYTES_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(GenericEvent_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&queue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(1);
+
+    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+
+    //collector statistics, no collector ran so no event is created
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG)).SetFailReturn(!TELEMETRY_PROVIDER_OK);
+
     umock_c_negative_tests_snapshot();
     int count = umock_c_negative_tests_call_count();
     for (int i = 0; i < umock_c_negative_tests_call_count(); i++) {
-        if (i == 9 || i == 16 || i == 20 || i == 21 || i == 31 || i == 35 || i == 36) {
+        if (i == 9 || i == 16 || i == 20 || i == 21 || i == 32 || i == 36 || i == 37 ||
+            i == 47 || i == 52 || i == 57 || i == 62 || i == 66 || i == 67) {
             // skip deinit since they don't have a fail return
             continue;
         }
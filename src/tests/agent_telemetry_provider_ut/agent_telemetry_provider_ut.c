@@ -7,6 +7,9 @@
 
 #define ENABLE_MOCKS
 #include "agent_telemetry_counters.h"
+#include "collectors/collector_execution.h"
+#include "memory_monitor.h"
+#include "tracked_allocator.h"
 
 #undef ENABLE_MOCKS
 
@@ -27,6 +30,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 static SyncedCounter highPrioCounter;
 static SyncedCounter lowPrioCounter;
 static SyncedCounter iothubCounter;
+static SyncedCounter evictionCounter;
 
 bool getCounterData(SyncedCounter* counter, Counter* counterData){
     if (counter == & highPrioCounter){
@@ -39,11 +43,36 @@ bool getCounterData(SyncedCounter* counter, Counter* counterData){
         counterData->messageCounter.sentMessages = 3;
         counterData->messageCounter.smallMessages = 1;
         counterData->messageCounter.failedMessages = 2;
+        counterData->messageCounter.sentBytes = 6000;
+        counterData->messageCounter.billedBytes = 8192;
+        counterData->messageCounter.reconnectAttempts = 4;
+        counterData->messageCounter.disconnectedTime = 12000;
+    } else if (counter == &evictionCounter){
+        counterData->evictionCounter.lowPriority = 5;
+        counterData->evictionCounter.aggregated = 6;
+        counterData->evictionCounter.highPriority = 7;
     } 
 
     return true;
 }
 
+MemoryMonitorResultValues Mocked_MemoryMonitor_CurrentConsumption(uint32_t* sizeInBytes) {
+    *sizeInBytes = 1000;
+    return MEMORY_MONITOR_OK;
+}
+
+uint32_t Mocked_TrackedAllocator_GetUsage(AllocationTag tag) {
+    return tag == ALLOCATION_TAG_JSON ? 300 : 100;
+}
+
+void Mocked_CollectorExecution_GetStatistics(CollectorId id, CollectorStatistics* statistics) {
+    statistics->runs = id;
+    statistics->overruns = id == COLLECTOR_BASELINE ? 1 : 0;
+    statistics->skipped = 0;
+    statistics->totalDuration = id * 10;
+    statistics->maxDuration = id * 10;
+}
+
 BEGIN_TEST_SUITE(agent_telemetry_provider_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -56,8 +85,14 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
   
     REGISTER_UMOCK_ALIAS_TYPE(AgentTelemetryProviderResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AllocationTag, int);
+    REGISTER_UMOCK_ALIAS_TYPE(CollectorId, int);
+    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
 
     REGISTER_GLOBAL_MOCK_HOOK(AgentTelemetryCounter_SnapshotAndReset, getCounterData);
+    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_CurrentConsumption, Mocked_MemoryMonitor_CurrentConsumption);
+    REGISTER_GLOBAL_MOCK_HOOK(TrackedAllocator_GetUsage, Mocked_TrackedAllocator_GetUsage);
+    REGISTER_GLOBAL_MOCK_HOOK(CollectorExecution_GetStatistics, Mocked_CollectorExecution_GetStatistics);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -76,7 +111,7 @@ TEST_FUNCTION(AgentTelemetryProvider_GethighPrioQueueCounterDataExpectSucess)
 {  
     QueueCounter counterData;
 
-    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter);
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter, &evictionCounter);
     ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
 
     result = AgentTelemetryProvider_GetQueueCounterData(HIGH_PRIORITY, &counterData);
@@ -89,7 +124,7 @@ TEST_FUNCTION(AgentTelemetryProvider_GetlowPrioQueueCounterDataExpectSucess)
 {  
     QueueCounter counterData;
 
-    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter);
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter, &evictionCounter);
     ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
 
     result = AgentTelemetryProvider_GetQueueCounterData(LOW_PRIORITY, &counterData);
@@ -102,7 +137,7 @@ TEST_FUNCTION(AgentTelemetryProvider_GetMessageCounterDataExpectSucess)
 {  
     MessageCounter counterData;
 
-    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter);
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter, &evictionCounter);
     ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
 
     result = AgentTelemetryProvider_GetMessageCounterData(&counterData);
@@ -110,13 +145,17 @@ TEST_FUNCTION(AgentTelemetryProvider_GetMessageCounterDataExpectSucess)
     ASSERT_ARE_EQUAL(int, 3, counterData.sentMessages);
     ASSERT_ARE_EQUAL(int, 2, counterData.failedMessages);
     ASSERT_ARE_EQUAL(int, 1, counterData.smallMessages);
+    ASSERT_ARE_EQUAL(int, 6000, counterData.sentBytes);
+    ASSERT_ARE_EQUAL(int, 8192, counterData.billedBytes);
+    ASSERT_ARE_EQUAL(int, 4, counterData.reconnectAttempts);
+    ASSERT_ARE_EQUAL(int, 12000, counterData.disconnectedTime);
 }
 
 TEST_FUNCTION(AgentTelemetryProvider_GetlowPrioQueueCounterDataExpectFail)
 {  
     MessageCounter counterData;
 
-    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter);
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter, &evictionCounter);
     ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
 
     result = AgentTelemetryProvider_GetMessageCounterData(&counterData);
@@ -126,4 +165,45 @@ TEST_FUNCTION(AgentTelemetryProvider_GetlowPrioQueueCounterDataExpectFail)
     ASSERT_ARE_EQUAL(int, 1, counterData.smallMessages);
 }
 
+TEST_FUNCTION(AgentTelemetryProvider_GetEvictionCounterDataExpectSucess)
+{  
+    EvictionCounter counterData;
+
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter, &evictionCounter);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+
+    result = AgentTelemetryProvider_GetEvictionCounterData(&counterData);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+    ASSERT_ARE_EQUAL(int, 5, counterData.lowPriority);
+    ASSERT_ARE_EQUAL(int, 6, counterData.aggregated);
+    ASSERT_ARE_EQUAL(int, 7, counterData.highPriority);
+}
+
+TEST_FUNCTION(AgentTelemetryProvider_GetMemoryConsumptionExpectSucess)
+{  
+    MemoryConsumption consumption;
+
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_GetMemoryConsumption(&consumption);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+    ASSERT_ARE_EQUAL(int, 300, consumption.subsystems[ALLOCATION_TAG_JSON]);
+    ASSERT_ARE_EQUAL(int, 100, consumption.subsystems[ALLOCATION_TAG_PROCESS_HASHES]);
+    ASSERT_ARE_EQUAL(int, 100, consumption.subsystems[ALLOCATION_TAG_BASELINE]);
+    ASSERT_ARE_EQUAL(int, 100, consumption.subsystems[ALLOCATION_TAG_AUDIT_STREAM]);
+    // the rest was consumed by the queues
+    ASSERT_ARE_EQUAL(int, 400, consumption.queues);
+}
+
+TEST_FUNCTION(AgentTelemetryProvider_GetCollectorStatisticsExpectSucess)
+{  
+    CollectorStatistics statistics[COLLECTOR_COUNT];
+
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_GetCollectorStatistics(statistics);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+    // the statistics are indexed by the collector
+    ASSERT_ARE_EQUAL(int, 0, statistics[COLLECTOR_AGENT_TELEMETRY].runs);
+    ASSERT_ARE_EQUAL(int, COLLECTOR_BASELINE, statistics[COLLECTOR_BASELINE].runs);
+    ASSERT_ARE_EQUAL(int, 1, statistics[COLLECTOR_BASELINE].overruns);
+    ASSERT_ARE_EQUAL(int, COLLECTOR_DIAGNOSTIC * 10, statistics[COLLECTOR_DIAGNOSTIC].maxDuration);
+}
+
 END_TEST_SUITE(agent_telemetry_provider_ut)
\ No newline at end of file
@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "consts.h"
+#include "os_utils/linux/audit/audit_log.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static const char FIRST_EVENT[] = "type=SYSCALL msg=audit(1000.100:1): pid=1\ntype=EXECVE msg=audit(1000.100:1): argc=1\n";
+static const char SECOND_EVENT[] = "type=SYSCALL msg=audit(1000.200:2): pid=2\ntype=EXECVE msg=audit(1000.200:2): argc=1\n";
+static const char PARTIAL_LINE[] = "type=SYSCALL msg=audit(1000.300:3): pid=3";
+
+static char testDirectory[] = "/tmp/audit_log_ut_XXXXXX";
+static char logPath[256];
+static char rotatedLogPath[256];
+static AuditLogReader reader;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void AppendToFile(const char* path, const char* text) {
+    FILE* file = fopen(path, "a");
+    ASSERT_IS_NOT_NULL(file);
+    ASSERT_ARE_EQUAL(int, strlen(text), fwrite(text, 1, strlen(text), file));
+    fclose(file);
+}
+
+static uint64_t GetInode(const char* path) {
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(path, &fileStat));
+    return fileStat.st_ino;
+}
+
+static void AssertNextChunk(const char* expected) {
+    const char* chunk = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_OK, AuditLog_ReadChunk(&reader, &chunk));
+    ASSERT_ARE_EQUAL(char_ptr, expected, chunk);
+}
+
+BEGIN_TEST_SUITE(audit_log_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+
+    ASSERT_IS_NOT_NULL(mkdtemp(testDirectory));
+    snprintf(logPath, sizeof(logPath), "%s/audit.log", testDirectory);
+    snprintf(rotatedLogPath, sizeof(rotatedLogPath), "%s/audit.log.1", testDirectory);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    rmdir(testDirectory);
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    memset(&reader, 0, sizeof(reader));
+    reader.fd = -1;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    AuditLog_Close(&reader);
+    unlink(logPath);
+    unlink(rotatedLogPath);
+}
+
+TEST_FUNCTION(AuditLog_GetEnd_PartialLastLine_ExpectEndOfLastCompleteLine)
+{
+    AppendToFile(logPath, FIRST_EVENT);
+    AppendToFile(logPath, PARTIAL_LINE);
+
+    AuditLogPosition end;
+    ASSERT_IS_TRUE(AuditLog_GetEnd(logPath, &end));
+
+    ASSERT_ARE_EQUAL(int, GetInode(logPath), end.inode);
+    ASSERT_ARE_EQUAL(int, strlen(FIRST_EVENT), end.offset);
+}
+
+TEST_FUNCTION(AuditLog_GetEnd_NoLog_ExpectFailure)
+{
+    AuditLogPosition end;
+    ASSERT_IS_FALSE(AuditLog_GetEnd(logPath, &end));
+}
+
+TEST_FUNCTION(AuditLog_ReadChunk_FromPosition_ExpectOnlyNewEvents)
+{
+    AppendToFile(logPath, FIRST_EVENT);
+    AuditLogPosition position = { GetInode(logPath), strlen(FIRST_EVENT) };
+    AppendToFile(logPath, SECOND_EVENT);
+    AppendToFile(logPath, PARTIAL_LINE);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_OK, AuditLog_Open(&reader, logPath, &position));
+    AssertNextChunk(SECOND_EVENT);
+
+    // the partial line is read once it is complete
+    const char* chunk = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_END, AuditLog_ReadChunk(&reader, &chunk));
+    ASSERT_ARE_EQUAL(int, strlen(FIRST_EVENT) + strlen(SECOND_EVENT), reader.position.offset);
+}
+
+TEST_FUNCTION(AuditLog_Open_UnknownOrTruncatedPosition_ExpectNotFound)
+{
+    AppendToFile(logPath, FIRST_EVENT);
+
+    AuditLogPosition position = { GetInode(logPath) + 1, 0 };
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_NOT_FOUND, AuditLog_Open(&reader, logPath, &position));
+
+    position.inode = GetInode(logPath);
+    position.offset = strlen(FIRST_EVENT) + 1;
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_NOT_FOUND, AuditLog_Open(&reader, logPath, &position));
+}
+
+TEST_FUNCTION(AuditLog_ReadChunk_LogRotated_ExpectRotationFollowed)
+{
+    AppendToFile(logPath, FIRST_EVENT);
+    AuditLogPosition position = { GetInode(logPath), 0 };
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_OK, AuditLog_Open(&reader, logPath, &position));
+
+    // the log is rotated while it is read
+    ASSERT_ARE_EQUAL(int, 0, rename(logPath, rotatedLogPath));
+    AppendToFile(logPath, SECOND_EVENT);
+
+    AssertNextChunk(FIRST_EVENT);
+    AssertNextChunk(SECOND_EVENT);
+    ASSERT_ARE_EQUAL(int, GetInode(logPath), reader.position.inode);
+
+    const char* chunk = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_END, AuditLog_ReadChunk(&reader, &chunk));
+}
+
+TEST_FUNCTION(AuditLog_ReadChunk_LargeLog_ExpectEventsNotSplit)
+{
+    uint32_t events = 0;
+    FILE* file = fopen(logPath, "a");
+    ASSERT_IS_NOT_NULL(file);
+    for (long size = 0; size < 2 * AUDIT_LOG_CHUNK_SIZE; size = ftell(file)) {
+        ++events;
+        fprintf(file, "type=SYSCALL msg=audit(1000.000:%u): pid=1\ntype=EXECVE msg=audit(1000.000:%u): argc=1\n", events, events);
+    }
+    fclose(file);
+
+    AuditLogPosition position = { GetInode(logPath), 0 };
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_OK, AuditLog_Open(&reader, logPath, &position));
+
+    uint32_t chunks = 0;
+    uint32_t eventsRead = 0;
+    const char* chunk = NULL;
+    while (AuditLog_ReadChunk(&reader, &chunk) == AUDIT_LOG_OK) {
+        ++chunks;
+        ASSERT_IS_TRUE(strlen(chunk) < AUDIT_LOG_CHUNK_SIZE);
+        // each chunk starts with the first record of an event and ends with its last record
+        ASSERT_ARE_EQUAL(int, 0, strncmp(chunk, "type=SYSCALL", strlen("type=SYSCALL")));
+        for (const char* record = strstr(chunk, "type=EXECVE"); record != NULL; record = strstr(record + 1, "type=EXECVE")) {
+            ++eventsRead;
+        }
+    }
+
+    ASSERT_IS_TRUE(chunks > 2);
+    ASSERT_ARE_EQUAL(int, events, eventsRead);
+}
+
+END_TEST_SUITE(audit_log_ut)
@@ -6,6 +6,6 @@
 int main(void)
 {
     size_t failedTestCount = 0;
-    RUN_TEST_SUITE(sync_memory_monitor_ut, failedTestCount);
+    RUN_TEST_SUITE(audit_log_ut, failedTestCount);
     return failedTestCount;
 }
\ No newline at end of file
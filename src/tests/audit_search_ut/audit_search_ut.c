@@ -9,15 +9,22 @@
 #include "umocktypes_charptr.h"
 #include "umock_c_negative_tests.h"
 
+// the search runs inside real collectors, so their execution is not mocked with the stream
+#include "collectors/collector_execution.h"
+
 #define ENABLE_MOCKS
 #include "audit_mocks.h"
 #include "internal/time_utils.h"
 #include "os_utils/file_utils.h"
+#include "os_utils/linux/audit/audit_log.h"
 #include "os_utils/linux/audit/audit_search_utils.h"
+#include "os_utils/linux/audit/audit_stream.h"
 #include "os_utils/process_info_handler.h"
 #undef ENABLE_MOCKS
 
 #include <errno.h>
+#include <time.h>
+#include "consts.h"
 #include "os_utils/linux/audit/audit_search.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -37,22 +44,131 @@ static time_t MOCKED_SEARCH_TIME;
 static time_t TIME_IN_FILE;
 static auparse_state_t* mockedAudit;
 
+static const AuditSearchCheckpoint CHECKPOINT_IN_FILE = { 1000, 500, 42 };
+
 FileResults Mocked_FileUtils_ReadFile_SetBufferToTime(const char* filename, void* data, uint32_t readCount, bool maxCount) {
     memcpy(data, &TIME_IN_FILE, sizeof(TIME_IN_FILE));
     return FILE_UTILS_OK;
 }
 
+// the checkpoint file of an older agent holds only the search time
+FileResults Mocked_FileUtils_ReadFile_SetBufferToLegacyTime(const char* filename, void* data, uint32_t readCount, bool maxCount) {
+    memcpy(data, &TIME_IN_FILE, sizeof(TIME_IN_FILE));
+    return FILE_UTILS_SIZE_MISMATCH;
+}
+
+FileResults Mocked_FileUtils_ReadFile_SetBufferToCheckpoint(const char* filename, void* data, uint32_t readCount, bool maxCount) {
+    memcpy(data, &CHECKPOINT_IN_FILE, sizeof(CHECKPOINT_IN_FILE));
+    return FILE_UTILS_OK;
+}
+
+// the previous search consumed the log up to offset 300 of the file with inode 7
+static const AuditSearchCheckpoint CHECKPOINT_WITH_POSITION = { 1000, 500, 42, { 7, 300 } };
+static const AuditLogPosition LOG_END = { 9, 1234 };
+static char LOG_CHUNK[] = "type=USER_AUTH msg=audit(1000.500:43): pid=1\n";
+static char NEXT_LOG_CHUNK[] = "type=USER_AUTH msg=audit(1001.000:45): pid=1\n";
+static uint32_t chunksRead = 0;
+
+FileResults Mocked_FileUtils_ReadFile_SetBufferToCheckpointWithPosition(const char* filename, void* data, uint32_t readCount, bool maxCount) {
+    memcpy(data, &CHECKPOINT_WITH_POSITION, sizeof(CHECKPOINT_WITH_POSITION));
+    return FILE_UTILS_OK;
+}
+
+bool Mocked_AuditLog_GetEnd(const char* path, AuditLogPosition* end) {
+    *end = LOG_END;
+    return true;
+}
+
+AuditLogResult Mocked_AuditLog_Open(AuditLogReader* reader, const char* path, const AuditLogPosition* position) {
+    reader->position = *position;
+    return AUDIT_LOG_OK;
+}
+
+// each chunk is 100 bytes long, and the log ends after the second one
+AuditLogResult Mocked_AuditLog_ReadChunk(AuditLogReader* reader, const char** chunk) {
+    if (chunksRead == 2) {
+        return AUDIT_LOG_END;
+    }
+
+    *chunk = chunksRead == 0 ? LOG_CHUNK : NEXT_LOG_CHUNK;
+    ++chunksRead;
+    reader->position.offset += 100;
+    return AUDIT_LOG_OK;
+}
+
 void InitAuditSearchFotTests(AuditSearch* search) {
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search->processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    AuditSearchResultValues result = AuditSearch_Init(search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+}
+
+void InitAuditSearchWithCheckpointFotTests(AuditSearch* search) {
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search->processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false));
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">=", CHECKPOINT_IN_FILE.sec, CHECKPOINT_IN_FILE.milli, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToCheckpoint);
+    AuditSearchResultValues result = AuditSearch_Init(search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+}
+
+void InitAuditSearchWithLogPositionFotTests(AuditSearch* search) {
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search->processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false));
+    STRICT_EXPECTED_CALL(AuditLog_Open(&search->log, AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditLog_ReadChunk(&search->log, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_BUFFER, LOG_CHUNK)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">=", CHECKPOINT_WITH_POSITION.sec, CHECKPOINT_WITH_POSITION.milli, AUSEARCH_RULE_AND)).SetReturn(0);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToCheckpointWithPosition);
     AuditSearchResultValues result = AuditSearch_Init(search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
 }
 
+static au_event_t mockedEvents[3];
+
+static AuditSearch* searchPastBudget = NULL;
+static AuditSearchResultValues resultPastBudget = AUDIT_SEARCH_OK;
+
+EventCollectorResult CollectPastBudget(SyncQueue* queue) {
+    struct timespec duration = { 0, 5000000 };
+    nanosleep(&duration, NULL);
+    resultPastBudget = AuditSearch_GetNext(searchPastBudget);
+    return EVENT_COLLECTOR_OK;
+}
+
+static char STREAM_EVENTS[] = "type=USER_AUTH msg=audit(1000.500:43): pid=1\n";
+static char* streamEvents = STREAM_EVENTS;
+static AuditSearchResultValues resultInCollector = AUDIT_SEARCH_OK;
+
+// searches like a collector, from init to checkpoint
+EventCollectorResult CollectFromStream(SyncQueue* queue) {
+    AuditSearch search;
+    resultInCollector = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+    if (resultInCollector == AUDIT_SEARCH_OK) {
+        resultInCollector = AuditSearch_GetNext(&search);
+    }
+    if (resultInCollector == AUDIT_SEARCH_NO_MORE_DATA) {
+        resultInCollector = AuditSearch_SetCheckpoint(&search);
+    }
+    AuditSearch_Deinit(&search);
+    return EVENT_COLLECTOR_OK;
+}
+
 BEGIN_TEST_SUITE(audit_search_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -73,12 +189,24 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(austop_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(ausearch_rule_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditStreamResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditSearchCriteria, int);
+    REGISTER_UMOCK_ALIAS_TYPE(CollectorId, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditLogResult, int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLog_Open, Mocked_AuditLog_Open);
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLog_ReadChunk, Mocked_AuditLog_ReadChunk);
 
     struct tm tmpTime = {0, 0, 13, 14, 2, 118 }; 
     MOCKED_SEARCH_TIME = mktime(&tmpTime);
 
     struct tm tmpTime2 = {0, 0, 20, 7, 1, 118 }; 
     TIME_IN_FILE = mktime(&tmpTime);
+
+    // the first event is in the millisecond of the checkpoint but was not consumed yet
+    mockedEvents[0] = (au_event_t){ .sec = 1000, .milli = 500, .serial = 43 };
+    mockedEvents[1] = (au_event_t){ .sec = 1000, .milli = 501, .serial = 44 };
+    mockedEvents[2] = (au_event_t){ .sec = 1001, .milli = 0, .serial = 45 };
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -92,6 +220,7 @@ TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
     mockedAudit = (auparse_state_t*)0x1;
+    chunksRead = 0;
 }
 
 TEST_FUNCTION(AuditSearch_InitType_ExpectSuccess)
@@ -99,9 +228,10 @@ TEST_FUNCTION(AuditSearch_InitType_ExpectSuccess)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
 
@@ -121,9 +251,10 @@ TEST_FUNCTION(AuditSearch_InitSysCall_ExpectSuccess)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_interpreted_item(mockedAudit, "syscall", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
 
@@ -143,10 +274,11 @@ TEST_FUNCTION(AuditSearch_Init_WithCheckpoint_ExpectSuccess)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false));
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false));
-    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">", TIME_IN_FILE, 0, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">=", TIME_IN_FILE, 0, AUSEARCH_RULE_AND)).SetReturn(0);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
 
@@ -165,6 +297,33 @@ TEST_FUNCTION(AuditSearch_Init_WithCheckpoint_ExpectSuccess)
     AuditSearch_Deinit(&search);
 }
 
+TEST_FUNCTION(AuditSearch_Init_WithLegacyCheckpoint_ExpectSuccess)
+{
+    AuditSearch search;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false));
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">=", TIME_IN_FILE, 0, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToLegacyTime);
+    
+    AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+    
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_IS_TRUE(search.hasCheckpoint);
+    ASSERT_ARE_EQUAL(int, 0, search.checkpoint.serial);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
 TEST_FUNCTION(AuditSearch_Init_ChangeToRootFailed_ExpectFailure)
 {
     AuditSearch search;
@@ -185,10 +344,7 @@ TEST_FUNCTION(AuditSearch_Init_ReadTimeFailed_ExpectFailure)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
-    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
-    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_ERROR);
-    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_ERROR);
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(&search.processInfo)).SetReturn(true);
 
     AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
@@ -206,9 +362,10 @@ TEST_FUNCTION(AuditSearch_Init_AuditFunctionFailed_ExpectFailure)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(-1);
     STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(&search.processInfo)).SetReturn(true);
@@ -244,6 +401,7 @@ TEST_FUNCTION(AuditSearch_GetNext_ExpectSuccess)
     InitAuditSearchFotTests(&search);
 
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[0]);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
 
@@ -290,8 +448,10 @@ TEST_FUNCTION(AuditSearch_GetNextGetNext_ExpectSuccess)
     InitAuditSearchFotTests(&search);
 
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[0]);
     STRICT_EXPECTED_CALL(auparse_next_event(mockedAudit)).SetReturn(1);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[0]);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_HAS_MORE_DATA, result);
@@ -310,6 +470,7 @@ TEST_FUNCTION(AuditSearch_GetNextGetNext_NoMoreData_ExpectSuccess)
     InitAuditSearchFotTests(&search);
 
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[0]);
     STRICT_EXPECTED_CALL(auparse_next_event(mockedAudit)).SetReturn(0);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
@@ -338,11 +499,271 @@ TEST_FUNCTION(AuditSearch_GetNext_AuditFunctionFailed_ExpectFailure)
     AuditSearch_Deinit(&search);
 }
 
+TEST_FUNCTION(AuditSearch_GetNext_CollectorPastBudget_ExpectCanceled)
+{
+    AuditSearch search;
+    InitAuditSearchFotTests(&search);
+    searchPastBudget = &search;
+
+    // the search is not progressed once the budget of the collector is over
+    CollectorExecution_Run(COLLECTOR_USER_LOGIN, CollectPastBudget, NULL, 1);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_CANCELED, resultPastBudget);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_InCaughtUpCollector_ExpectStreamEventsSearched)
+{
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditStream_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 1, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_events(&streamEvents, sizeof(streamEvents))
+        .SetReturn(AUDIT_STREAM_EVENTS);
+    // the buffered events are parsed instead of the logs
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_BUFFER, STREAM_EVENTS)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(AuditStream_ReportSearchEnd(COLLECTOR_USER_LOGIN, true));
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(AuditStream_FreeEvents(STREAM_EVENTS));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    CollectorExecution_Run(COLLECTOR_USER_LOGIN, CollectFromStream, NULL, 0);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, resultInCollector);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearch_InCaughtUpCollectorWithoutStreamEvents_ExpectNothingParsed)
+{
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false));
+    STRICT_EXPECTED_CALL(AuditStream_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 1, IGNORED_PTR_ARG)).SetReturn(AUDIT_STREAM_NO_EVENTS);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    // the checkpoint is kept
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint)))
+        .ValidateArgumentBuffer(2, &CHECKPOINT_IN_FILE, sizeof(CHECKPOINT_IN_FILE))
+        .SetReturn(FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(AuditStream_ReportSearchEnd(COLLECTOR_USER_LOGIN, true));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToCheckpoint);
+    CollectorExecution_Run(COLLECTOR_USER_LOGIN, CollectFromStream, NULL, 0);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, resultInCollector);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearch_InCollectorWithoutStream_ExpectLogsSearched)
+{
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditStream_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 1, IGNORED_PTR_ARG)).SetReturn(AUDIT_STREAM_UNAVAILABLE);
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(0);
+    // the stream is not reported to
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    CollectorExecution_Run(COLLECTOR_USER_LOGIN, CollectFromStream, NULL, 0);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, resultInCollector);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearch_GetNext_WithCheckpoint_ExpectConsumedEventsSkipped)
+{
+    AuditSearch search;
+    InitAuditSearchWithCheckpointFotTests(&search);
+    au_event_t consumedEvent = { .sec = CHECKPOINT_IN_FILE.sec, .milli = CHECKPOINT_IN_FILE.milli, .serial = CHECKPOINT_IN_FILE.serial };
+
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&consumedEvent);
+    STRICT_EXPECTED_CALL(auparse_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[0]);
+
+    AuditSearchResultValues result = AuditSearch_GetNext(&search);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_HAS_MORE_DATA, result);
+    ASSERT_ARE_EQUAL(int, mockedEvents[0].serial, search.lastEvent.serial);
+    ASSERT_ARE_EQUAL(int, 1, search.eventsRead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_GetNext_MaxEventsRead_ExpectNoMoreData)
+{
+    AuditSearch search;
+    InitAuditSearchFotTests(&search);
+    search.eventsRead = AUDIT_SEARCH_MAX_EVENTS_PER_RUN;
+
+    // the rest of the log is left to the next run
+    AuditSearchResultValues result = AuditSearch_GetNext(&search);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_NO_MORE_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_Init_WithLogPosition_ExpectLogReadFromPosition)
+{
+    AuditSearch search;
+    InitAuditSearchWithLogPositionFotTests(&search);
+
+    ASSERT_IS_TRUE(search.readsLog);
+    ASSERT_ARE_EQUAL(void_ptr, mockedAudit, search.audit);
+    // the events of the chunk were not consumed yet
+    ASSERT_ARE_EQUAL(int, CHECKPOINT_WITH_POSITION.position.offset, search.position.offset);
+    ASSERT_ARE_EQUAL(int, CHECKPOINT_WITH_POSITION.position.offset + 100, search.log.position.offset);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_Init_LogPositionRotatedAway_ExpectAllLogsSearched)
+{
+    AuditSearch search;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false));
+    STRICT_EXPECTED_CALL(AuditLog_Open(&search.log, AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_NOT_FOUND);
+    // the logs are searched by the time of the checkpoint
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG)).SetReturn(false);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">=", CHECKPOINT_WITH_POSITION.sec, CHECKPOINT_WITH_POSITION.milli, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToCheckpointWithPosition);
+    AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_IS_FALSE(search.readsLog);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_GetNext_EndOfLogChunk_ExpectNextChunkSearched)
+{
+    AuditSearch search;
+    InitAuditSearchWithLogPositionFotTests(&search);
+    AuditSearchCheckpoint expectedCheckpoint;
+    memset(&expectedCheckpoint, 0, sizeof(expectedCheckpoint));
+    expectedCheckpoint.sec = mockedEvents[2].sec;
+    expectedCheckpoint.milli = mockedEvents[2].milli;
+    expectedCheckpoint.serial = mockedEvents[2].serial;
+    expectedCheckpoint.position.inode = CHECKPOINT_WITH_POSITION.position.inode;
+    expectedCheckpoint.position.offset = CHECKPOINT_WITH_POSITION.position.offset + 200;
+
+    // the first chunk has no matching event
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(AuditLog_ReadChunk(&search.log, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_BUFFER, NEXT_LOG_CHUNK)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">=", CHECKPOINT_WITH_POSITION.sec, CHECKPOINT_WITH_POSITION.milli, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[2]);
+    // the log ends after the second chunk
+    STRICT_EXPECTED_CALL(auparse_next_event(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(AuditLog_ReadChunk(&search.log, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint)))
+        .ValidateArgumentBuffer(2, &expectedCheckpoint, sizeof(expectedCheckpoint))
+        .SetReturn(FILE_UTILS_OK);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_HAS_MORE_DATA, AuditSearch_GetNext(&search));
+    ASSERT_ARE_EQUAL(int, CHECKPOINT_WITH_POSITION.position.offset + 100, search.position.offset);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_NO_MORE_DATA, AuditSearch_GetNext(&search));
+    AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_SetCheckpoint_AfterAllLogsSearched_ExpectLogEnd)
+{
+    AuditSearch search;
+    AuditSearchCheckpoint expectedCheckpoint;
+    memset(&expectedCheckpoint, 0, sizeof(expectedCheckpoint));
+    expectedCheckpoint.sec = MOCKED_SEARCH_TIME;
+    expectedCheckpoint.position = LOG_END;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLog_GetEnd(AUDIT_LOG_FILE_PATH, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(0);
+    // the next search reads the log from where this one ended
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint)))
+        .ValidateArgumentBuffer(2, &expectedCheckpoint, sizeof(expectedCheckpoint))
+        .SetReturn(FILE_UTILS_OK);
+
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLog_GetEnd, Mocked_AuditLog_GetEnd);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH));
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLog_GetEnd, NULL);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_NO_MORE_DATA, AuditSearch_GetNext(&search));
+    AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_SetCheckpoint_AfterGetNext_ExpectLastEvent)
+{
+    AuditSearch search;
+    InitAuditSearchWithCheckpointFotTests(&search);
+    AuditSearchCheckpoint expectedCheckpoint;
+    memset(&expectedCheckpoint, 0, sizeof(expectedCheckpoint));
+    expectedCheckpoint.sec = mockedEvents[1].sec;
+    expectedCheckpoint.milli = mockedEvents[1].milli;
+    expectedCheckpoint.serial = mockedEvents[1].serial;
+
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&mockedEvents[1]);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint)))
+        .ValidateArgumentBuffer(2, &expectedCheckpoint, sizeof(expectedCheckpoint))
+        .SetReturn(FILE_UTILS_OK);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_HAS_MORE_DATA, AuditSearch_GetNext(&search));
+    AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
 TEST_FUNCTION(AuditSearch_SetCheckpoint_ExpectSuccess)
 {
     AuditSearch search;
     InitAuditSearchFotTests(&search);
-    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(MOCKED_SEARCH_TIME))).SetReturn(FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(FILE_UTILS_OK);
 
     AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
 
@@ -356,7 +777,7 @@ TEST_FUNCTION(AuditSearch_SetCheckpoint_WriteFailed_ExpectFailure)
 {
     AuditSearch search;
     InitAuditSearchFotTests(&search);
-    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(MOCKED_SEARCH_TIME))).SetReturn(!FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(!FILE_UTILS_OK);
 
     AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
 
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include <auparse.h>
+#include <libaudit.h>
+
+MOCKABLE_FUNCTION(, auparse_state_t*, auparse_init, ausource_t, source, const void*, b)
+MOCKABLE_FUNCTION(, void, auparse_add_callback, auparse_state_t*, au, auparse_callback_ptr, callback, void*, userData, user_destroy, userDestroy);
+MOCKABLE_FUNCTION(, int, auparse_feed, auparse_state_t*, au, const char*, data, size_t, dataLength);
+MOCKABLE_FUNCTION(, void, auparse_destroy, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_first_record, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_next_record, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_get_type_name, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_get_record_text, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_find_field, auparse_state_t*, au, const char*, field);
+MOCKABLE_FUNCTION(, int, auparse_get_field_int, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_get_field_str, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, audit_elf_to_machine, unsigned int, elf);
+MOCKABLE_FUNCTION(, const char*, audit_syscall_to_name, int, sc, int, machine);
@@ -0,0 +1,385 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "audit_mocks.h"
+#include "azure_c_shared_utility/lock.h"
+#include "collectors/collector_execution.h"
+#include "os_mocks.h"
+#include "os_utils/process_info_handler.h"
+#include "tracked_allocator.h"
+#undef ENABLE_MOCKS
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "consts.h"
+#include "os_utils/linux/audit/audit_stream.h"
+
+// the stream reconnects quickly and overflows after a few events in the tests
+const char AUDIT_STREAM_SOCKET_PATH[] = "/tmp/audit_stream_ut";
+const uint32_t AUDIT_STREAM_RECONNECT_INTERVAL = 10;
+const uint32_t AUDIT_STREAM_MAX_BUFFER_SIZE = 8 * 1024;
+
+#define TEST_WAIT_TIMEOUT 5000
+#define TEST_ELF_X86_64 0xc000003e
+#define TEST_MACHINE_X86_64 0
+#define TEST_EXECVE 59
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static const char* LOGIN_TYPES[] = { "USER_LOGIN" };
+static const char* AUTH_TYPES[] = { "USER_AUTH" };
+static const char* EXECVE_SYSCALLS[] = { "execve" };
+static const char LOGIN_RECORD[] = "type=USER_LOGIN msg=audit(1000.100:1): pid=1 res=success";
+static const char AUTH_RECORD[] = "type=USER_AUTH msg=audit(1000.200:2): pid=2 res=success";
+static const char EXECVE_RECORD[] = "type=SYSCALL msg=audit(1000.300:3): arch=c000003e syscall=59";
+
+static auparse_state_t* mockedParser = (auparse_state_t*)0x1;
+// the stream connects to the first socket of the pair, the test writes the events to the second
+static int socketPair[2];
+static bool pluginListening;
+static auparse_callback_ptr parserCallback;
+// the fed data which does not end with a complete line yet
+static char pendingFeed[2 * 4096];
+static size_t pendingFeedSize;
+static char currentRecord[1024];
+static char currentType[64];
+static uint32_t notifications[COLLECTOR_COUNT];
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+void* Mocked_TrackedAllocator_Malloc(AllocationTag tag, size_t size) {
+    return malloc(size);
+}
+
+void Mocked_TrackedAllocator_Free(AllocationTag tag, void* ptr) {
+    free(ptr);
+}
+
+int Mocked_socket(int domain, int type, int protocol) {
+    // the stream closes its socket once it is disconnected
+    if (socketPair[1] >= 0) {
+        close(socketPair[1]);
+    }
+    ASSERT_ARE_EQUAL(int, 0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, socketPair));
+    return socketPair[0];
+}
+
+int Mocked_connect(int fd, const struct sockaddr* address, socklen_t addressLength) {
+    if (!pluginListening) {
+        errno = ECONNREFUSED;
+        return -1;
+    }
+    return 0;
+}
+
+void Mocked_auparse_add_callback(auparse_state_t* au, auparse_callback_ptr callback, void* userData, user_destroy userDestroy) {
+    parserCallback = callback;
+}
+
+// every line is an event of a single record, as the records of a real event are sent one after the other
+int Mocked_auparse_feed(auparse_state_t* au, const char* data, size_t dataLength) {
+    ASSERT_IS_TRUE(pendingFeedSize + dataLength <= sizeof(pendingFeed));
+    memcpy(pendingFeed + pendingFeedSize, data, dataLength);
+    pendingFeedSize += dataLength;
+
+    char* line = pendingFeed;
+    char* lineEnd = NULL;
+    while ((lineEnd = memchr(line, '\n', pendingFeed + pendingFeedSize - line)) != NULL) {
+        *lineEnd = '\0';
+        ASSERT_IS_TRUE(strlen(line) < sizeof(currentRecord));
+        strcpy(currentRecord, line);
+        sscanf(line, "type=%63s", currentType);
+        parserCallback(au, AUPARSE_CB_EVENT_READY, NULL);
+        line = lineEnd + 1;
+    }
+
+    pendingFeedSize -= line - pendingFeed;
+    memmove(pendingFeed, line, pendingFeedSize);
+    return 0;
+}
+
+const char* Mocked_auparse_get_type_name(auparse_state_t* au) {
+    return currentType;
+}
+
+const char* Mocked_auparse_get_record_text(auparse_state_t* au) {
+    return currentRecord;
+}
+
+const char* Mocked_auparse_find_field(auparse_state_t* au, const char* field) {
+    return strstr(currentRecord, field);
+}
+
+const char* Mocked_auparse_get_field_str(auparse_state_t* au) {
+    return "c000003e";
+}
+
+int Mocked_auparse_get_field_int(auparse_state_t* au) {
+    return TEST_EXECVE;
+}
+
+int Mocked_audit_elf_to_machine(unsigned int elf) {
+    return elf == TEST_ELF_X86_64 ? TEST_MACHINE_X86_64 : -1;
+}
+
+const char* Mocked_audit_syscall_to_name(int sc, int machine) {
+    return sc == TEST_EXECVE && machine == TEST_MACHINE_X86_64 ? "execve" : NULL;
+}
+
+static void Test_OnEvents(void* context, CollectorId id) {
+    ++notifications[id];
+}
+
+/**
+ * @brief Waits for the stream to have work and runs it, as the event loop does.
+ */
+static void Test_RunStream() {
+    struct pollfd pollFd = { .fd = AuditStream_GetFd(), .events = POLLIN, .revents = 0 };
+    ASSERT_ARE_EQUAL(int, 1, poll(&pollFd, 1, TEST_WAIT_TIMEOUT));
+    AuditStream_OnReadable(NULL);
+}
+
+static void Test_Connect() {
+    pluginListening = true;
+    Test_RunStream();
+}
+
+static void Test_Send(const char* record) {
+    ASSERT_ARE_EQUAL(int, strlen(record), write(socketPair[1], record, strlen(record)));
+    ASSERT_ARE_EQUAL(int, 1, write(socketPair[1], "\n", 1));
+}
+
+// the stream buffers the records one per line
+static void Test_AssertEvents(const char* expectedRecord, const char* events) {
+    ASSERT_IS_NOT_NULL(events);
+    ASSERT_ARE_EQUAL(int, strlen(expectedRecord) + 1, strlen(events));
+    ASSERT_ARE_EQUAL(int, 0, strncmp(expectedRecord, events, strlen(expectedRecord)));
+    ASSERT_ARE_EQUAL(int, '\n', events[strlen(expectedRecord)]);
+}
+
+static AuditStreamResult Test_TakeEvents(CollectorId id, AuditSearchCriteria searchCriteria, const char** messageTypes, char** events) {
+    return AuditStream_TakeEvents(id, searchCriteria, messageTypes, 1, events);
+}
+
+/**
+ * @brief Subscribes the collector and reports a search which read all of its events, so the stream buffers its events from now on.
+ */
+static void Test_CatchUp(CollectorId id, AuditSearchCriteria searchCriteria, const char** messageTypes) {
+    char* events = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_CATCH_UP, Test_TakeEvents(id, searchCriteria, messageTypes, &events));
+    AuditStream_ReportSearchEnd(id, true);
+}
+
+BEGIN_TEST_SUITE(audit_stream_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_charptr_register_types();
+    umocktypes_bool_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AllocationTag, int);
+    REGISTER_UMOCK_ALIAS_TYPE(CollectorId, int);
+    REGISTER_UMOCK_ALIAS_TYPE(ausource_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(auparse_callback_ptr, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(user_destroy, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(socklen_t, unsigned int);
+
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Init, (LOCK_HANDLE)0x1);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(ProcessInfoHandler_ChangeToRoot, true);
+    REGISTER_GLOBAL_MOCK_RETURN(ProcessInfoHandler_Reset, true);
+    REGISTER_GLOBAL_MOCK_RETURN(auparse_init, mockedParser);
+    REGISTER_GLOBAL_MOCK_RETURN(auparse_first_record, 1);
+    REGISTER_GLOBAL_MOCK_RETURN(auparse_next_record, 0);
+    REGISTER_GLOBAL_MOCK_HOOK(TrackedAllocator_Malloc, Mocked_TrackedAllocator_Malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(TrackedAllocator_Free, Mocked_TrackedAllocator_Free);
+    REGISTER_GLOBAL_MOCK_HOOK(socket, Mocked_socket);
+    REGISTER_GLOBAL_MOCK_HOOK(connect, Mocked_connect);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_add_callback, Mocked_auparse_add_callback);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_feed, Mocked_auparse_feed);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_get_type_name, Mocked_auparse_get_type_name);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_get_record_text, Mocked_auparse_get_record_text);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_find_field, Mocked_auparse_find_field);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_get_field_str, Mocked_auparse_get_field_str);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_get_field_int, Mocked_auparse_get_field_int);
+    REGISTER_GLOBAL_MOCK_HOOK(audit_elf_to_machine, Mocked_audit_elf_to_machine);
+    REGISTER_GLOBAL_MOCK_HOOK(audit_syscall_to_name, Mocked_audit_syscall_to_name);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex)) {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    socketPair[0] = -1;
+    socketPair[1] = -1;
+    pluginListening = false;
+    parserCallback = NULL;
+    pendingFeedSize = 0;
+    memset(notifications, 0, sizeof(notifications));
+    ASSERT_IS_TRUE(AuditStream_Init(Test_OnEvents, NULL));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    // the stream closes its own end of the socket
+    AuditStream_Deinit();
+    if (socketPair[1] >= 0) {
+        close(socketPair[1]);
+    }
+
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(AuditStream_TakeEvents_NotConnected_ExpectUnavailable)
+{
+    // the plugin of audispd is disabled
+    Test_RunStream();
+
+    char* events = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_UNAVAILABLE, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    ASSERT_IS_NULL(events);
+}
+
+TEST_FUNCTION(AuditStream_OnReadable_Disconnected_ExpectReconnectedAndCollectorsCatchUp)
+{
+    // the first attempt fails, the reconnect timer tries again
+    Test_RunStream();
+    Test_Connect();
+    Test_CatchUp(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES);
+
+    // audispd closes the socket when auditd restarts
+    close(socketPair[1]);
+    socketPair[1] = -1;
+    pluginListening = false;
+    Test_RunStream();
+
+    char* events = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_UNAVAILABLE, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+
+    // the events of the disconnection are in the logs only, so the collector catches up with the logs first
+    Test_Connect();
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_CATCH_UP, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    ASSERT_IS_NULL(events);
+}
+
+TEST_FUNCTION(AuditStream_OnReadable_Events_ExpectDispatchedToMatchingCollectors)
+{
+    Test_Connect();
+    Test_CatchUp(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES);
+    Test_CatchUp(COLLECTOR_PROCESS_CREATION, AUDIT_SEARCH_CRITERIA_SYSCALL, EXECVE_SYSCALLS);
+    // the collector did not catch up, so it is not notified
+    char* events = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_CATCH_UP, Test_TakeEvents(COLLECTOR_CONNECTION_CREATE, AUDIT_SEARCH_CRITERIA_TYPE, AUTH_TYPES, &events));
+    AuditStream_ReportSearchEnd(COLLECTOR_CONNECTION_CREATE, false);
+
+    Test_Send(LOGIN_RECORD);
+    Test_Send(AUTH_RECORD);
+    Test_Send(EXECVE_RECORD);
+    Test_Send(LOGIN_RECORD);
+    Test_RunStream();
+
+    ASSERT_ARE_EQUAL(int, 1, notifications[COLLECTOR_USER_LOGIN]);
+    ASSERT_ARE_EQUAL(int, 1, notifications[COLLECTOR_PROCESS_CREATION]);
+    ASSERT_ARE_EQUAL(int, 0, notifications[COLLECTOR_CONNECTION_CREATE]);
+
+    char expectedEvents[sizeof(LOGIN_RECORD) * 2 + 1];
+    snprintf(expectedEvents, sizeof(expectedEvents), "%s\n%s\n", LOGIN_RECORD, LOGIN_RECORD);
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_EVENTS, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    ASSERT_ARE_EQUAL(char_ptr, expectedEvents, events);
+    AuditStream_FreeEvents(events);
+    AuditStream_ReportSearchEnd(COLLECTOR_USER_LOGIN, true);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_EVENTS, Test_TakeEvents(COLLECTOR_PROCESS_CREATION, AUDIT_SEARCH_CRITERIA_SYSCALL, EXECVE_SYSCALLS, &events));
+    Test_AssertEvents(EXECVE_RECORD, events);
+    AuditStream_FreeEvents(events);
+
+    // the events were taken, nothing arrived since
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_NO_EVENTS, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    ASSERT_IS_NULL(events);
+}
+
+TEST_FUNCTION(AuditStream_ReportSearchEnd_SearchNotFinished_ExpectLogsSearchedNext)
+{
+    Test_Connect();
+    Test_CatchUp(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES);
+
+    char* events = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_NO_EVENTS, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    Test_Send(LOGIN_RECORD);
+    Test_RunStream();
+    // the search was bounded, the events it did not read are in the logs
+    AuditStream_ReportSearchEnd(COLLECTOR_USER_LOGIN, false);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_CATCH_UP, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    ASSERT_IS_NULL(events);
+}
+
+TEST_FUNCTION(AuditStream_OnReadable_BufferOverflow_ExpectLogsSearchedNext)
+{
+    Test_Connect();
+    Test_CatchUp(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES);
+    Test_CatchUp(COLLECTOR_CONNECTION_CREATE, AUDIT_SEARCH_CRITERIA_TYPE, AUTH_TYPES);
+
+    // the buffer of the collector overflows, the events of the other collector still fit
+    uint32_t sent = 0;
+    while (sent <= AUDIT_STREAM_MAX_BUFFER_SIZE) {
+        Test_Send(LOGIN_RECORD);
+        Test_RunStream();
+        sent += sizeof(LOGIN_RECORD);
+    }
+    Test_Send(AUTH_RECORD);
+    Test_RunStream();
+
+    char* events = NULL;
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_CATCH_UP, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    ASSERT_IS_NULL(events);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_EVENTS, Test_TakeEvents(COLLECTOR_CONNECTION_CREATE, AUDIT_SEARCH_CRITERIA_TYPE, AUTH_TYPES, &events));
+    Test_AssertEvents(AUTH_RECORD, events);
+    AuditStream_FreeEvents(events);
+
+    // the events which arrive after the collector caught up with the logs are buffered again
+    AuditStream_ReportSearchEnd(COLLECTOR_USER_LOGIN, true);
+    Test_Send(LOGIN_RECORD);
+    Test_RunStream();
+    ASSERT_ARE_EQUAL(int, AUDIT_STREAM_EVENTS, Test_TakeEvents(COLLECTOR_USER_LOGIN, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, &events));
+    Test_AssertEvents(LOGIN_RECORD, events);
+    AuditStream_FreeEvents(events);
+}
+
+END_TEST_SUITE(audit_stream_ut)
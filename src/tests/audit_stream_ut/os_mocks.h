@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include <sys/socket.h>
+
+MOCKABLE_FUNCTION(, int, socket, int, domain, int, type, int, protocol);
+MOCKABLE_FUNCTION(, int, connect, int, fd, const struct sockaddr*, address, socklen_t, addressLength);
@@ -11,6 +11,7 @@
 
 #define ENABLE_MOCKS
 #include "collectors/generic_event.h"
+#include "collectors/snapshot_event.h"
 #include "json/json_array_reader.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_reader.h"
@@ -25,7 +26,10 @@
 #include "twin_configuration_consts.h"
 #include "twin_configuration_defs.h"
 #include "collectors/linux/baseline_collector.h"
+#include "consts.h"
+#include "memory_monitor.h"
 #include "message_schema_consts.h"
+#include "tracked_allocator.h"
 
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -79,11 +83,20 @@ JsonWriterResult Mocked_JsonArrayWriter_Init(JsonArrayWriterHandle* writer) {
     return JSON_WRITER_OK;
 }
 
+static uint32_t baselineUsageWhileParsing = 0;
 JsonReaderResult Mocked_JsonObjectReader_InitFromString(JsonObjectReaderHandle* handle, const char* data) {
+    baselineUsageWhileParsing = TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE);
     *handle = (JsonObjectReaderHandle)0x3;
     return JSON_READER_OK;
 }
 
+static const char* OMS_BASELINE_OUTPUT = "{\"results\":[]}";
+bool Mocked_ProcessUtils_Execute(const char* command, char* output, uint32_t* outputSize) {
+    *outputSize = strlen(OMS_BASELINE_OUTPUT);
+    memcpy(output, OMS_BASELINE_OUTPUT, *outputSize);
+    return true;
+}
+
 JsonReaderResult Mocked_JsonArrayReader_ReadObject(JsonArrayReaderHandle handle, uint32_t index, JsonObjectReaderHandle* objectHandle) {
     *objectHandle = (JsonObjectReaderHandle)0x4;
     return JSON_READER_OK;
@@ -123,6 +136,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(JsonObjectReader_InitFromString, Mocked_JsonObjectReader_InitFromString);
     REGISTER_GLOBAL_MOCK_HOOK(JsonArrayReader_ReadObject, Mocked_JsonArrayReader_ReadObject);
     REGISTER_GLOBAL_MOCK_HOOK(JsonObjectReader_ReadArray, Mocked_JsonObjectReader_ReadArray);
+
+    // the output buffer is charged to the real memory monitor
+    ASSERT_IS_TRUE(MemoryMonitor_Init());
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -134,6 +150,7 @@ TEST_SUITE_CLEANUP(suite_cleanup)
     REGISTER_GLOBAL_MOCK_HOOK(JsonArrayWriter_Init, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(JsonObjectReader_ReadString, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(JsonArrayReader_GetSize, NULL);
+    MemoryMonitor_Deinit();
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
      
@@ -193,9 +210,7 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectSuccess)
     STRICT_EXPECTED_CALL(TwinConfiguration_GetBaselineCustomChecksFilePath(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfiguration_GetBaselineCustomChecksFileHash(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
 
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SnapshotEvent_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
@@ -203,6 +218,8 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectSuccess)
     EventCollectorResult result = BaselineCollector_GetEvents(&mockedQueue);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    // the output buffer was released
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE));
 }
 
 TEST_FUNCTION(BaselineCollector_GetEvents_ExpectFailure)
@@ -253,9 +270,7 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectFailure)
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
 
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(SnapshotEvent_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
 
     // no fail case
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
@@ -281,9 +296,6 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectFailure)
             case 28:
             case 29:
             case 30:
-            case 31:
-            case 32:
-            case 33:
                 // skip deinit since they don't have a fail return
                 continue;
         }
@@ -297,6 +309,65 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectFailure)
     umock_c_negative_tests_deinit();
 }
 
+TEST_FUNCTION(BaselineCollector_GetEvents_MemoryLimitExceeded_ExpectFailure)
+{
+    SyncQueue mockedQueue;
+    MemoryMonitor_SetLimit(1024 * 1024);
+
+    EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    EXPECTED_CALL(GenericEvent_AddMetadata(IGNORED_PTR_ARG, EVENT_PERIODIC_CATEGORY, BASELINE_NAME, EVENT_TYPE_SECURITY_VALUE, BASELINE_PAYLOAD_SCHEMA_VERSION)).SetReturn(EVENT_COLLECTOR_OK);
+    EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ProcessUtils_Execute("./omsbaseline -d .", IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+    // the whole output buffer was filled and does not fit, so it is not parsed
+    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+
+    EventCollectorResult result = BaselineCollector_GetEvents(&mockedQueue);
+    MemoryMonitor_SetLimit(DEFAULT_MAX_LOCAL_CACHE_SIZE);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE));
+}
+
+TEST_FUNCTION(BaselineCollector_GetEvents_SmallOutputBelowMemoryLimit_ExpectOnlyOutputCharged)
+{
+    SyncQueue mockedQueue;
+    MemoryMonitor_SetLimit(1024 * 1024);
+    REGISTER_GLOBAL_MOCK_HOOK(ProcessUtils_Execute, Mocked_ProcessUtils_Execute);
+
+    EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    EXPECTED_CALL(GenericEvent_AddMetadata(IGNORED_PTR_ARG, EVENT_PERIODIC_CATEGORY, BASELINE_NAME, EVENT_TYPE_SECURITY_VALUE, BASELINE_PAYLOAD_SCHEMA_VERSION)).SetReturn(EVENT_COLLECTOR_OK);
+    EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ProcessUtils_Execute("./omsbaseline -d .", IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_InitFromString(IGNORED_PTR_ARG, OMS_BASELINE_OUTPUT));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadArray(IGNORED_PTR_ARG, "results", IGNORED_PTR_ARG));
+    numberOfItems = 0;
+    STRICT_EXPECTED_CALL(JsonArrayReader_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonArrayReader_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetBaselineCustomChecksEnabled(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetBaselineCustomChecksFilePath(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetBaselineCustomChecksFileHash(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(SnapshotEvent_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+
+    EventCollectorResult result = BaselineCollector_GetEvents(&mockedQueue);
+    REGISTER_GLOBAL_MOCK_HOOK(ProcessUtils_Execute, NULL);
+    MemoryMonitor_SetLimit(DEFAULT_MAX_LOCAL_CACHE_SIZE);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    // only the output the command wrote was charged, not the whole scratch buffer
+    ASSERT_ARE_EQUAL(int, TrackedAllocator_EstimateSize(strlen(OMS_BASELINE_OUTPUT) + 1), baselineUsageWhileParsing);
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE));
+}
+
 TEST_FUNCTION(BaselineCollector_GetEvents_ProcessUtilsFailed_ExpectFailure) {
     
     SyncQueue mockedQueue;
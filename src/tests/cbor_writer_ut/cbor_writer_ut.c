@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+
+#include "cbor_writer.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void* FailingAllocate(uint32_t size) {
+    return NULL;
+}
+
+static void* Allocate(uint32_t size) {
+    return malloc(size);
+}
+
+/**
+ * Finishes the writer and compares its data with the expected bytes.
+ */
+static void AssertWriterData(CborWriter* writer, const uint8_t* expected, uint32_t expectedSize) {
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_TRUE(CborWriter_Finish(writer, Allocate, &output, &size));
+    ASSERT_ARE_EQUAL(int, expectedSize, size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, output, size));
+    free(output);
+}
+
+BEGIN_TEST_SUITE(cbor_writer_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(CborWriter_WriteIntegers_ExpectShortestForm)
+{
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, 0));
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, 23));
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, 24));
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, 1000));
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, -1));
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, -1000));
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, 4294967296));
+
+    const uint8_t expected[] = {
+        0x00, 0x17, 0x18, 0x18, 0x19, 0x03, 0xE8, 0x20, 0x39, 0x03, 0xE7,
+        0x1B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00
+    };
+    AssertWriterData(&writer, expected, sizeof(expected));
+
+    CborWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborWriter_WriteDoubles_ExpectShortestExactForm)
+{
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    ASSERT_IS_TRUE(CborWriter_WriteDouble(&writer, 42.0));
+    ASSERT_IS_TRUE(CborWriter_WriteDouble(&writer, 1.5));
+    ASSERT_IS_TRUE(CborWriter_WriteDouble(&writer, 1.1));
+
+    const uint8_t expected[] = {
+        0x18, 0x2A,
+        0xFA, 0x3F, 0xC0, 0x00, 0x00,
+        0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A
+    };
+    AssertWriterData(&writer, expected, sizeof(expected));
+
+    CborWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborWriter_WriteContainers_ExpectHeadersAndSimpleValues)
+{
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    ASSERT_IS_TRUE(CborWriter_WriteMapHeader(&writer, 2));
+    ASSERT_IS_TRUE(CborWriter_WriteString(&writer, "a"));
+    ASSERT_IS_TRUE(CborWriter_WriteArrayHeader(&writer, 2));
+    ASSERT_IS_TRUE(CborWriter_WriteBool(&writer, true));
+    ASSERT_IS_TRUE(CborWriter_WriteNull(&writer));
+    ASSERT_IS_TRUE(CborWriter_WriteString(&writer, "b"));
+    ASSERT_IS_TRUE(CborWriter_BeginIndefiniteArray(&writer));
+    ASSERT_IS_TRUE(CborWriter_WriteBool(&writer, false));
+    ASSERT_IS_TRUE(CborWriter_WriteBreak(&writer));
+
+    const uint8_t expected[] = { 0xA2, 0x61, 'a', 0x82, 0xF5, 0xF6, 0x61, 'b', 0x9F, 0xF4, 0xFF };
+    AssertWriterData(&writer, expected, sizeof(expected));
+
+    CborWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborWriter_WriteBeyondInlineBuffer_ExpectDataMovedToHeap)
+{
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    char value[CBOR_WRITER_INLINE_SIZE];
+    memset(value, 'x', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+
+    ASSERT_IS_TRUE(CborWriter_WriteInt(&writer, 7));
+    ASSERT_IS_NULL(writer.heapData);
+    ASSERT_IS_TRUE(CborWriter_WriteString(&writer, value));
+    ASSERT_IS_NOT_NULL(writer.heapData);
+
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_TRUE(CborWriter_Finish(&writer, Allocate, &output, &size));
+    ASSERT_ARE_EQUAL(int, 1 + 3 + sizeof(value) - 1, size);
+    ASSERT_ARE_EQUAL(int, 0x07, (uint8_t)output[0]);
+    ASSERT_ARE_EQUAL(int, 0x79, (uint8_t)output[1]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(value, output + 4, sizeof(value) - 1));
+    free(output);
+
+    CborWriter_Deinit(&writer);
+    ASSERT_IS_NULL(writer.heapData);
+}
+
+TEST_FUNCTION(CborWriter_FinishAllocationFailed_ExpectFailure)
+{
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    ASSERT_IS_TRUE(CborWriter_WriteNull(&writer));
+
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_FALSE(CborWriter_Finish(&writer, FailingAllocate, &output, &size));
+    ASSERT_IS_NULL(output);
+
+    CborWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborWriter_FinishEmptyWriter_ExpectFailure)
+{
+    CborWriter writer;
+    CborWriter_Init(&writer);
+
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_FALSE(CborWriter_Finish(&writer, Allocate, &output, &size));
+
+    CborWriter_Deinit(&writer);
+}
+
+END_TEST_SUITE(cbor_writer_ut)
@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_bool.h"
+
+#define ENABLE_MOCKS
+#include "os_mocks.h"
+#undef ENABLE_MOCKS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "collectors/collector_execution.h"
+
+#define TEST_BUDGET 100
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+// the monotonic clock of the tests, in milliseconds
+static uint64_t testTime;
+// how long the collector of the test runs, in milliseconds
+static uint32_t collectorDuration;
+static bool canceledBeforeOverrun;
+static bool canceledAfterOverrun;
+static bool currentFound;
+static CollectorId currentId;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+int Mocked_clock_gettime(clockid_t clockId, struct timespec* time) {
+    time->tv_sec = testTime / 1000;
+    time->tv_nsec = (testTime % 1000) * 1000000;
+    return 0;
+}
+
+static EventCollectorResult Test_Collect(SyncQueue* queue) {
+    currentFound = CollectorExecution_GetCurrent(&currentId);
+    canceledBeforeOverrun = CollectorExecution_IsCanceled();
+    testTime += collectorDuration;
+    canceledAfterOverrun = CollectorExecution_IsCanceled();
+    return EVENT_COLLECTOR_OK;
+}
+
+// the collector is stuck, the watchdog of the monitor notices it while it runs
+static EventCollectorResult Test_CollectStuck(SyncQueue* queue) {
+    testTime += collectorDuration;
+    CollectorExecution_Watchdog();
+    canceledAfterOverrun = CollectorExecution_IsCanceled();
+    return EVENT_COLLECTOR_EXCEPTION;
+}
+
+BEGIN_TEST_SUITE(collector_execution_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_charptr_register_types();
+    umocktypes_bool_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(clockid_t, int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(clock_gettime, Mocked_clock_gettime);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    testTime = 1000;
+    collectorDuration = 0;
+    canceledBeforeOverrun = false;
+    canceledAfterOverrun = false;
+    currentFound = false;
+
+    // the statistics are kept between the runs until they are read
+    CollectorStatistics statistics;
+    for (uint32_t id = 0; id < COLLECTOR_COUNT; ++id) {
+        CollectorExecution_GetStatistics(id, &statistics);
+    }
+}
+
+TEST_FUNCTION(CollectorExecution_Run_WithinBudget_ExpectNotCanceled)
+{
+    collectorDuration = TEST_BUDGET;
+
+    EventCollectorResult result = CollectorExecution_Run(COLLECTOR_PROCESS_CREATION, Test_Collect, NULL, TEST_BUDGET);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_IS_TRUE(currentFound);
+    ASSERT_ARE_EQUAL(int, COLLECTOR_PROCESS_CREATION, currentId);
+    ASSERT_IS_FALSE(canceledBeforeOverrun);
+    ASSERT_IS_FALSE(canceledAfterOverrun);
+
+    CollectorStatistics statistics;
+    CollectorExecution_GetStatistics(COLLECTOR_PROCESS_CREATION, &statistics);
+    ASSERT_ARE_EQUAL(int, 1, statistics.runs);
+    ASSERT_ARE_EQUAL(int, 0, statistics.overruns);
+}
+
+TEST_FUNCTION(CollectorExecution_Run_BudgetExpired_ExpectCanceledAndOverrunCountedOnce)
+{
+    collectorDuration = TEST_BUDGET + 1;
+
+    CollectorExecution_Run(COLLECTOR_PROCESS_CREATION, Test_Collect, NULL, TEST_BUDGET);
+
+    ASSERT_IS_FALSE(canceledBeforeOverrun);
+    ASSERT_IS_TRUE(canceledAfterOverrun);
+
+    // the collector saw its cancellation and the run ended past its deadline, the overrun is counted once
+    CollectorStatistics statistics;
+    CollectorExecution_GetStatistics(COLLECTOR_PROCESS_CREATION, &statistics);
+    ASSERT_ARE_EQUAL(int, 1, statistics.runs);
+    ASSERT_ARE_EQUAL(int, 1, statistics.overruns);
+
+    // the next run starts with a fresh budget
+    collectorDuration = 0;
+    CollectorExecution_Run(COLLECTOR_PROCESS_CREATION, Test_Collect, NULL, TEST_BUDGET);
+    ASSERT_IS_FALSE(canceledAfterOverrun);
+}
+
+TEST_FUNCTION(CollectorExecution_Run_NoBudget_ExpectNeverCanceled)
+{
+    collectorDuration = 60 * 60 * 1000;
+
+    CollectorExecution_Run(COLLECTOR_BASELINE, Test_Collect, NULL, 0);
+
+    ASSERT_IS_FALSE(canceledAfterOverrun);
+    CollectorStatistics statistics;
+    CollectorExecution_GetStatistics(COLLECTOR_BASELINE, &statistics);
+    ASSERT_ARE_EQUAL(int, 0, statistics.overruns);
+}
+
+TEST_FUNCTION(CollectorExecution_Watchdog_CollectorOverruns_ExpectRunCanceled)
+{
+    collectorDuration = TEST_BUDGET + 1;
+
+    EventCollectorResult result = CollectorExecution_Run(COLLECTOR_FIREWALL, Test_CollectStuck, NULL, TEST_BUDGET);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    ASSERT_IS_TRUE(canceledAfterOverrun);
+
+    CollectorStatistics statistics;
+    CollectorExecution_GetStatistics(COLLECTOR_FIREWALL, &statistics);
+    ASSERT_ARE_EQUAL(int, 1, statistics.runs);
+    ASSERT_ARE_EQUAL(int, 1, statistics.overruns);
+
+    // the other collectors are not running, so the watchdog leaves them alone
+    CollectorExecution_GetStatistics(COLLECTOR_PROCESS_CREATION, &statistics);
+    ASSERT_ARE_EQUAL(int, 0, statistics.overruns);
+}
+
+TEST_FUNCTION(CollectorExecution_Watchdog_CollectorWithinBudget_ExpectNotCanceled)
+{
+    collectorDuration = TEST_BUDGET;
+
+    CollectorExecution_Run(COLLECTOR_FIREWALL, Test_CollectStuck, NULL, TEST_BUDGET);
+
+    ASSERT_IS_FALSE(canceledAfterOverrun);
+    CollectorStatistics statistics;
+    CollectorExecution_GetStatistics(COLLECTOR_FIREWALL, &statistics);
+    ASSERT_ARE_EQUAL(int, 0, statistics.overruns);
+}
+
+TEST_FUNCTION(CollectorExecution_GetStatistics_SeveralRuns_ExpectCountersAggregatedAndReset)
+{
+    collectorDuration = 10;
+    CollectorExecution_Run(COLLECTOR_LOCAL_USERS, Test_Collect, NULL, TEST_BUDGET);
+    collectorDuration = 30;
+    CollectorExecution_Run(COLLECTOR_LOCAL_USERS, Test_Collect, NULL, TEST_BUDGET);
+    collectorDuration = 20;
+    CollectorExecution_Run(COLLECTOR_LOCAL_USERS, Test_Collect, NULL, TEST_BUDGET);
+    CollectorExecution_ReportSkipped(COLLECTOR_LOCAL_USERS);
+
+    CollectorStatistics statistics;
+    CollectorExecution_GetStatistics(COLLECTOR_LOCAL_USERS, &statistics);
+    ASSERT_ARE_EQUAL(int, 3, statistics.runs);
+    ASSERT_ARE_EQUAL(int, 0, statistics.overruns);
+    ASSERT_ARE_EQUAL(int, 1, statistics.skipped);
+    ASSERT_ARE_EQUAL(int, 60, statistics.totalDuration);
+    ASSERT_ARE_EQUAL(int, 30, statistics.maxDuration);
+
+    // reading the statistics resets them
+    CollectorExecution_GetStatistics(COLLECTOR_LOCAL_USERS, &statistics);
+    ASSERT_ARE_EQUAL(int, 0, statistics.runs);
+    ASSERT_ARE_EQUAL(int, 0, statistics.skipped);
+    ASSERT_ARE_EQUAL(int, 0, statistics.totalDuration);
+    ASSERT_ARE_EQUAL(int, 0, statistics.maxDuration);
+}
+
+TEST_FUNCTION(CollectorExecution_IsCanceled_NoCollectorRunning_ExpectFalse)
+{
+    CollectorId id;
+    ASSERT_IS_FALSE(CollectorExecution_IsCanceled());
+    ASSERT_IS_FALSE(CollectorExecution_GetCurrent(&id));
+}
+
+END_TEST_SUITE(collector_execution_ut)
@@ -0,0 +1,9 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include <time.h>
+
+MOCKABLE_FUNCTION(, int, clock_gettime, clockid_t, clockId, struct timespec*, time);
@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+#include "columnar_message.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+#define MESSAGE_PREFIX "{\"AgentVersion\":\"1.0\",\"AgentId\":\"id\",\"Events\":["
+#define MESSAGE_SUFFIX "]}"
+
+/**
+ * Writes an event with the given name, times and payload, the way the collectors do.
+ */
+static void AppendEvent(char* message, const char* name, const char* id, const char* localTime, const char* utcTime, const char* payload) {
+    if (message[strlen(message) - 1] != '[') {
+        strcat(message, ",");
+    }
+    sprintf(message + strlen(message),
+        "{\"Category\":\"Triggered\",\"EventType\":\"Security\",\"Name\":\"%s\",\"PayloadSchemaVersion\":\"1.0\",\"Id\":\"%s\","
+        "\"TimestampLocal\":\"%s\",\"TimestampUTC\":\"%s\",\"IsEmpty\":%s,\"Payload\":%s}",
+        name, id, localTime, utcTime, strcmp(payload, "[]") == 0 ? "true" : "false", payload);
+}
+
+BEGIN_TEST_SUITE(columnar_message_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+    umocktypes_charptr_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(ColumnarMessage_TranscodeEventsOfTwoTypes_ExpectGroupedColumns)
+{
+    char message[2048] = MESSAGE_PREFIX;
+    AppendEvent(message, "ProcessCreate", "a", "2019-03-04T12:59:58Z", "2019-03-04T10:59:58Z", "[{\"Executable\":\"sh\",\"ProcessId\":7,\"CommandLine\":\"sh -c ls\"}]");
+    AppendEvent(message, "ListeningPorts", "b", "2019-03-04T12:59:59Z", "2019-03-04T10:59:59Z", "[]");
+    AppendEvent(message, "ProcessCreate", "c", "2019-03-04T13:00:03Z", "2019-03-04T11:00:03Z", "[{\"Executable\":\"sh\",\"ProcessId\":8},{\"Executable\":\"bash\",\"ProcessId\":9}]");
+    strcat(message, MESSAGE_SUFFIX);
+
+    char* output = NULL;
+    uint32_t size = 0;
+    bool result = ColumnarMessage_Transcode(message, &output, &size);
+
+    ASSERT_IS_TRUE(result);
+    // the repeating executable is written once to the string table, a field missing from an item is null
+    ASSERT_ARE_EQUAL(char_ptr,
+        "{\"AgentVersion\":\"1.0\",\"AgentId\":\"id\",\"Layout\":\"Columnar\",\"Strings\":[\"sh\"],\"EventGroups\":["
+        "{\"Category\":\"Triggered\",\"EventType\":\"Security\",\"Name\":\"ProcessCreate\",\"PayloadSchemaVersion\":\"1.0\","
+        "\"Id\":[\"a\",\"c\"],\"TimestampUTC\":{\"Base\":\"2019-03-04T10:59:58Z\",\"Deltas\":[5]},\"TimestampLocal\":{\"OffsetFromUTC\":7200},"
+        "\"PayloadCounts\":[1,2],\"Payload\":{\"ProcessId\":[7,8,9]},\"PayloadStrings\":{\"Executable\":[0,0,\"bash\"],\"CommandLine\":[\"sh -c ls\",null,null]}},"
+        "{\"Category\":\"Triggered\",\"EventType\":\"Security\",\"Name\":\"ListeningPorts\",\"PayloadSchemaVersion\":\"1.0\","
+        "\"Id\":[\"b\"],\"TimestampUTC\":{\"Base\":\"2019-03-04T10:59:59Z\",\"Deltas\":[]},\"TimestampLocal\":{\"OffsetFromUTC\":7200},"
+        "\"PayloadCounts\":[0]}]}",
+        output);
+    ASSERT_ARE_EQUAL(int, strlen(output), size);
+
+    free(output);
+}
+
+TEST_FUNCTION(ColumnarMessage_TranscodeLocalOffsetChanged_ExpectOffsetPerEvent)
+{
+    char message[1024] = MESSAGE_PREFIX;
+    AppendEvent(message, "ProcessCreate", "a", "2019-03-31T01:59:59Z", "2019-03-31T00:59:59Z", "[{\"ProcessId\":7}]");
+    AppendEvent(message, "ProcessCreate", "b", "2019-03-31T03:00:00Z", "2019-03-31T01:00:00Z", "[{\"ProcessId\":8}]");
+    strcat(message, MESSAGE_SUFFIX);
+
+    char* output = NULL;
+    uint32_t size = 0;
+    bool result = ColumnarMessage_Transcode(message, &output, &size);
+
+    ASSERT_IS_TRUE(result);
+    ASSERT_IS_NOT_NULL(strstr(output, "\"TimestampUTC\":{\"Base\":\"2019-03-31T00:59:59Z\",\"Deltas\":[1]},\"TimestampLocal\":{\"OffsetsFromUTC\":[3600,7200]}"));
+
+    free(output);
+}
+
+TEST_FUNCTION(ColumnarMessage_TranscodeInvalidTimestamp_ExpectFailure)
+{
+    char message[1024] = MESSAGE_PREFIX;
+    AppendEvent(message, "ProcessCreate", "a", "2019-02-29T12:00:00Z", "2019-02-29T10:00:00Z", "[]");
+    strcat(message, MESSAGE_SUFFIX);
+
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_FALSE(ColumnarMessage_Transcode(message, &output, &size));
+    ASSERT_IS_NULL(output);
+}
+
+TEST_FUNCTION(ColumnarMessage_TranscodeNullPayloadField_ExpectFailure)
+{
+    char message[1024] = MESSAGE_PREFIX;
+    AppendEvent(message, "ProcessCreate", "a", "2019-03-04T12:00:00Z", "2019-03-04T10:00:00Z", "[{\"Executable\":null}]");
+    strcat(message, MESSAGE_SUFFIX);
+
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_FALSE(ColumnarMessage_Transcode(message, &output, &size));
+    ASSERT_IS_NULL(output);
+}
+
+TEST_FUNCTION(ColumnarMessage_TranscodeUnknownEventMember_ExpectFailure)
+{
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_FALSE(ColumnarMessage_Transcode(MESSAGE_PREFIX "{\"Name\":\"ProcessCreate\",\"Extra\":1}" MESSAGE_SUFFIX, &output, &size));
+    ASSERT_IS_FALSE(ColumnarMessage_Transcode(MESSAGE_PREFIX MESSAGE_SUFFIX, &output, &size));
+    ASSERT_IS_FALSE(ColumnarMessage_Transcode("not a message", &output, &size));
+    ASSERT_IS_NULL(output);
+}
+
+END_TEST_SUITE(columnar_message_ut)
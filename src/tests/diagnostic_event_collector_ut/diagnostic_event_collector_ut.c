@@ -84,6 +84,20 @@ int Mocked_SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) {
     return QUEUE_OK;
 }
 
+int Mocked_SyncQueue_PopBatchIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, uint32_t maxBatchSize, SyncQueueBatch* batch) {
+    batch->remainingElements = TEST_SIZE;
+    return TEST_SIZE == 0 ? QUEUE_IS_EMPTY : QUEUE_OK;
+}
+
+int Mocked_SyncQueue_BatchPopFront(SyncQueueBatch* batch, void** data, uint32_t* dataSize) {
+    if (batch->remainingElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    batch->remainingElements--;
+    return Mocked_InternalSyncQueue_PopFront(NULL, data, dataSize);
+}
+
 static time_t dummyTime;
 
 BEGIN_TEST_SUITE(diagnostic_event_collector_ut)
@@ -102,9 +116,12 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(EventCollectorResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(JsonArrayWriterHandle, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(JsonBufferAllocateFunc, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(JsonBufferFreeFunc, void*);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(QueuePopCondition, void*);
 
     REGISTER_GLOBAL_MOCK_RETURN(CorrelationManager_GetCorrelation, TEST_CORRELATION_ID);
 }
@@ -122,6 +139,8 @@ TEST_FUNCTION_INITIALIZE(method_init)
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, Mocked_SyncQueue_PushBack);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, Mocked_SyncQueue_PopFront);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, Mocked_SyncQueue_GetSize);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopBatchIf, Mocked_SyncQueue_PopBatchIf);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_BatchPopFront, Mocked_SyncQueue_BatchPopFront);
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -129,6 +148,8 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopBatchIf, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_BatchPopFront, NULL);
 }
 
 TEST_FUNCTION(DiagnosticEventCollector_Init_ExpectSuccess)
@@ -164,18 +185,17 @@ TEST_FUNCTION(DiagnosticEventCollector_AddEvent_ExpectSuccess)
 
 TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectSuccess)
 {
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, Mocked_InternalSyncQueue_PopFront);
-
     SyncQueue internalEventsQueue, priorityQueue;
 
     STRICT_EXPECTED_CALL(CorrelationManager_Init());
     DiagnosticEventCollector_Init(&internalEventsQueue);
 
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&internalEventsQueue, IGNORED_PTR_ARG));
+    // the whole queue is taken in one batch
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&internalEventsQueue, NULL, NULL, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
 
     TEST_SIZE = 4;
     for (int event=0; event < TEST_SIZE; event++) {
-        STRICT_EXPECTED_CALL(SyncQueue_PopFront(&internalEventsQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
         STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
         STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, DIAGNOSTIC_NAME, EVENT_TYPE_DIAGNOSTIC_VALUE, DIAGNOSTIC_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
         STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
@@ -187,9 +207,10 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectSuccess)
         STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, DIAGNOSTIC_CORRELATION_KEY, TEST_CORRELATION_ID));
         STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
         STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-        STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(GenericEvent_SerializeWithAllocator(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
         STRICT_EXPECTED_CALL(SyncQueue_PushBack(&priorityQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     }
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     EventCollectorResult result = DiagnosticEventCollector_GetEvents(&priorityQueue);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -200,7 +221,7 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectSuccess)
     DiagnosticEventCollector_Deinit();
 }
 
-TEST_FUNCTION(DiagnosticEventCollector_GetEvents_QueueIsEmptyInLoop_ExpectSuccess)
+TEST_FUNCTION(DiagnosticEventCollector_GetEvents_QueueIsEmpty_ExpectSuccess)
 {
     SyncQueue internalEventsQueue;
     SyncQueue priorityQueue;
@@ -208,9 +229,8 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_QueueIsEmptyInLoop_ExpectSucces
     STRICT_EXPECTED_CALL(CorrelationManager_Init());
     DiagnosticEventCollector_Init(&internalEventsQueue);
 
-    TEST_SIZE = 4;
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&internalEventsQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&internalEventsQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(QUEUE_IS_EMPTY);
+    TEST_SIZE = 0;
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&internalEventsQueue, NULL, NULL, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
 
     EventCollectorResult result = DiagnosticEventCollector_GetEvents(&priorityQueue);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -222,10 +242,8 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_QueueIsEmptyInLoop_ExpectSucces
 
 TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectFailures)
 {
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, Mocked_InternalSyncQueue_PopFront);
-
     SyncQueue internalEventsQueue, priorityQueue;
-    TEST_SIZE = 4;
+    TEST_SIZE = 1;
 
     // non-failed function
     STRICT_EXPECTED_CALL(CorrelationManager_Init());
@@ -233,8 +251,8 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectFailures)
 
     umock_c_negative_tests_init();
 
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&internalEventsQueue, IGNORED_PTR_ARG)).SetFailReturn(!QUEUE_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&internalEventsQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&internalEventsQueue, NULL, NULL, IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetFailReturn(SYNC_QUEUE_LOCK_EXCEPTION);
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(QUEUE_IS_EMPTY);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(JSON_WRITER_EXCEPTION);
     STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, DIAGNOSTIC_NAME, EVENT_TYPE_DIAGNOSTIC_VALUE, DIAGNOSTIC_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(JSON_WRITER_EXCEPTION);
@@ -246,13 +264,14 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectFailures)
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, DIAGNOSTIC_CORRELATION_KEY, TEST_CORRELATION_ID)).SetFailReturn(JSON_WRITER_EXCEPTION);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(JSON_WRITER_EXCEPTION);
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
-    STRICT_EXPECTED_CALL (JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(JSON_WRITER_EXCEPTION);
+    STRICT_EXPECTED_CALL (GenericEvent_SerializeWithAllocator(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(&priorityQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
 
     umock_c_negative_tests_snapshot();
 
     for (int i = 0; i < umock_c_negative_tests_call_count(); i++) {
-        if (i == 0) {
+        // an empty batch is not a failure
+        if (i == 1) {
             continue;
         }
         umock_c_negative_tests_reset();
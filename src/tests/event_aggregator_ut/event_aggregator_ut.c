@@ -11,6 +11,7 @@
 #include "json/json_object_writer.h"
 
 #define ENABLE_MOCKS
+#include "local_config.h"
 #include "synchronized_queue.h"
 #include "twin_configuration_event_collectors.h"
 #undef ENABLE_MOCKS
@@ -49,7 +50,7 @@ TwinConfigurationResult Mocked_TwinConfiguration_GetAggregationInterval(TwinConf
     return TWIN_OK;
 }
 
-int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
+int Mocked_SyncQueue_PushBackWithPriority(SyncQueue* syncQueue, void* data, uint32_t dataSize, QueuePriority priority) {
     if (data != NULL) {
         free(data);
     }
@@ -58,6 +59,14 @@ int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSiz
     return QUEUE_OK;
 }
 
+void* Mocked_Queue_AllocateData(uint32_t dataSize) {
+    return malloc(dataSize);
+}
+
+void Mocked_Queue_FreeData(void* data) {
+    free(data);
+}
+
 void InitAggregator(EventAggregatorHandle* aggregator) {
     EventAggregatorConfiguration configuration = {
         .iotEventType = EVENT_TYPE_PROCESS_CREATE,
@@ -82,13 +91,16 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
     umocktypes_charptr_register_types();
     umocktypes_bool_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(QueuePriority, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationEventType, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, int);
 
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationEnabled, Mocked_TwinConfiguration_GetAggregationEnabled);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationInterval, Mocked_TwinConfiguration_GetAggregationInterval);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, Mocked_SyncQueue_PushBack);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBackWithPriority, Mocked_SyncQueue_PushBackWithPriority);
+    REGISTER_GLOBAL_MOCK_HOOK(Queue_AllocateData, Mocked_Queue_AllocateData);
+    REGISTER_GLOBAL_MOCK_HOOK(Queue_FreeData, Mocked_Queue_FreeData);
 
     JsonObjectWriter_InitFromString(&payload1Handle, jsonPayload1);
     JsonObjectWriter_InitFromString(&payload2Handle, jsonPayload2);
@@ -102,7 +114,9 @@ TEST_SUITE_CLEANUP(suite_cleanup)
     
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationEnabled, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationInterval, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBackWithPriority, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(Queue_AllocateData, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(Queue_FreeData, NULL);
 
     JsonObjectWriter_Deinit(payload2Handle);
     JsonObjectWriter_Deinit(payload1Handle);
@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+#include "event_encoder.h"
+#include "json/json_array_writer.h"
+#include "json/json_object_writer.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char* ENVELOPE_KEYS[] = { "AgentVersion", "AgentId" };
+static const char* ENVELOPE_VALUES[] = { "1.0", "id" };
+
+static void* Allocate(uint32_t size) {
+    return malloc(size);
+}
+
+/**
+ * Creates the event {"a":"b","n":5,"e":false,"p":[{"x":-1.5}]}.
+ */
+static JsonObjectWriterHandle CreateTestEvent() {
+    JsonObjectWriterHandle event = NULL;
+    JsonObjectWriterHandle item = NULL;
+    JsonArrayWriterHandle payload = NULL;
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_Init(&event));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(event, "a", "b"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteInt(event, "n", 5));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteBool(event, "e", false));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&item, "{\"x\":-1.5}"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonArrayWriter_Init(&payload));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonArrayWriter_AddObject(payload, item));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteArray(event, "p", payload));
+    JsonObjectWriter_Deinit(item);
+    JsonArrayWriter_Deinit(payload);
+
+    return event;
+}
+
+BEGIN_TEST_SUITE(event_encoder_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+    umocktypes_charptr_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(EventEncoder_EncodeObjectJson_ExpectParsonSerialization)
+{
+    JsonObjectWriterHandle event = CreateTestEvent();
+
+    char* output = NULL;
+    uint32_t size = 0;
+    JsonWriterResult result = EventEncoder_EncodeObject(EVENT_ENCODING_JSON, event, Allocate, free, &output, &size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":\"b\",\"n\":5,\"e\":false,\"p\":[{\"x\":-1.5}]}", output);
+    ASSERT_ARE_EQUAL(int, strlen(output), size);
+    ASSERT_IS_TRUE(EventEncoder_IsObject(EVENT_ENCODING_JSON, output, size));
+    ASSERT_IS_FALSE(EventEncoder_IsObject(EVENT_ENCODING_CBOR, output, size));
+
+    free(output);
+    JsonObjectWriter_Deinit(event);
+}
+
+TEST_FUNCTION(EventEncoder_EncodeObjectCbor_ExpectCborOfTheTree)
+{
+    JsonObjectWriterHandle event = CreateTestEvent();
+
+    char* output = NULL;
+    uint32_t size = 0;
+    JsonWriterResult result = EventEncoder_EncodeObject(EVENT_ENCODING_CBOR, event, Allocate, free, &output, &size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    const uint8_t expected[] = {
+        0xA4,
+        0x61, 'a', 0x61, 'b',
+        0x61, 'n', 0x05,
+        0x61, 'e', 0xF4,
+        0x61, 'p', 0x81, 0xA1, 0x61, 'x', 0xFA, 0xBF, 0xC0, 0x00, 0x00
+    };
+    ASSERT_ARE_EQUAL(int, sizeof(expected), size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, output, size));
+    ASSERT_IS_TRUE(EventEncoder_IsObject(EVENT_ENCODING_CBOR, output, size));
+    ASSERT_IS_FALSE(EventEncoder_IsObject(EVENT_ENCODING_JSON, output, size));
+
+    free(output);
+    JsonObjectWriter_Deinit(event);
+}
+
+TEST_FUNCTION(EventEncoder_EncodeEnvelopeJson_ExpectEventsArrayOpened)
+{
+    char* output = NULL;
+    uint32_t size = 0;
+    JsonWriterResult result = EventEncoder_EncodeEnvelope(EVENT_ENCODING_JSON, ENVELOPE_KEYS, ENVELOPE_VALUES, 2, "Events", &output, &size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "{\"AgentVersion\":\"1.0\",\"AgentId\":\"id\",\"Events\":[", output);
+    ASSERT_ARE_EQUAL(int, strlen(output), size);
+
+    const EventFraming* framing = EventEncoder_GetFraming(EVENT_ENCODING_JSON);
+    ASSERT_ARE_EQUAL(int, 1, framing->separatorSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(",", framing->separator, framing->separatorSize));
+    ASSERT_ARE_EQUAL(int, 2, framing->closingSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("]}", framing->closing, framing->closingSize));
+
+    free(output);
+}
+
+TEST_FUNCTION(EventEncoder_EncodeEnvelopeCbor_ExpectIndefiniteEventsArrayOpened)
+{
+    char* output = NULL;
+    uint32_t size = 0;
+    JsonWriterResult result = EventEncoder_EncodeEnvelope(EVENT_ENCODING_CBOR, ENVELOPE_KEYS, ENVELOPE_VALUES, 2, "Events", &output, &size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    const uint8_t expected[] = {
+        0xA3,
+        0x6C, 'A', 'g', 'e', 'n', 't', 'V', 'e', 'r', 's', 'i', 'o', 'n', 0x63, '1', '.', '0',
+        0x67, 'A', 'g', 'e', 'n', 't', 'I', 'd', 0x62, 'i', 'd',
+        0x66, 'E', 'v', 'e', 'n', 't', 's', 0x9F
+    };
+    ASSERT_ARE_EQUAL(int, sizeof(expected), size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, output, size));
+
+    // the events follow each other, the break closes the events array and the map has no more members
+    const EventFraming* framing = EventEncoder_GetFraming(EVENT_ENCODING_CBOR);
+    ASSERT_ARE_EQUAL(int, 0, framing->separatorSize);
+    ASSERT_ARE_EQUAL(int, 1, framing->closingSize);
+    ASSERT_ARE_EQUAL(int, 0xFF, (uint8_t)framing->closing[0]);
+
+    free(output);
+}
+
+TEST_FUNCTION(EventEncoder_IsObjectEmptyData_ExpectFalse)
+{
+    ASSERT_IS_FALSE(EventEncoder_IsObject(EVENT_ENCODING_JSON, "", 0));
+    ASSERT_IS_FALSE(EventEncoder_IsObject(EVENT_ENCODING_CBOR, "", 0));
+}
+
+END_TEST_SUITE(event_encoder_ut)
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "os_utils/event_loop.h"
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST_TIMER_INTERVAL 10
+#define TEST_TIMER_RUNS 5
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static EventLoop loop;
+static uint32_t timerCalls = 0;
+static uint32_t fdCalls = 0;
+static int testPipe[2];
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static uint64_t GetTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void StopAfterRuns(void* context) {
+    ++timerCalls;
+    if (timerCalls == TEST_TIMER_RUNS) {
+        EventLoop_Stop((EventLoop*)context);
+    }
+}
+
+static void ReadAndStop(void* context) {
+    char data;
+    ASSERT_ARE_EQUAL(int, 1, read(testPipe[0], &data, 1));
+    ++fdCalls;
+    EventLoop_Stop((EventLoop*)context);
+}
+
+static void CountCalls(void* context) {
+    ++timerCalls;
+}
+
+BEGIN_TEST_SUITE(event_loop_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    timerCalls = 0;
+    fdCalls = 0;
+    ASSERT_IS_TRUE(EventLoop_Init(&loop));
+    ASSERT_ARE_EQUAL(int, 0, pipe(testPipe));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    EventLoop_Deinit(&loop);
+    close(testPipe[0]);
+    close(testPipe[1]);
+}
+
+TEST_FUNCTION(EventLoop_RunTimer_ExpectFirstRunImmediateAndThenEveryInterval)
+{
+    ASSERT_IS_TRUE(EventLoop_AddTimer(&loop, TEST_TIMER_INTERVAL, StopAfterRuns, &loop));
+
+    uint64_t start = GetTime();
+    ASSERT_IS_TRUE(EventLoop_Run(&loop));
+    uint64_t elapsed = GetTime() - start;
+
+    ASSERT_ARE_EQUAL(int, TEST_TIMER_RUNS, timerCalls);
+    ASSERT_IS_TRUE(elapsed >= (TEST_TIMER_RUNS - 1) * TEST_TIMER_INTERVAL);
+}
+
+TEST_FUNCTION(EventLoop_RunFdReadable_ExpectHandlerCalled)
+{
+    ASSERT_IS_TRUE(EventLoop_AddFd(&loop, testPipe[0], ReadAndStop, &loop));
+    ASSERT_ARE_EQUAL(int, 1, write(testPipe[1], "x", 1));
+
+    ASSERT_IS_TRUE(EventLoop_Run(&loop));
+
+    ASSERT_ARE_EQUAL(int, 1, fdCalls);
+}
+
+TEST_FUNCTION(EventLoop_StopBeforeRun_ExpectRunReturnsWithoutHandlers)
+{
+    ASSERT_IS_TRUE(EventLoop_AddTimer(&loop, TEST_TIMER_INTERVAL, CountCalls, NULL));
+
+    EventLoop_Stop(&loop);
+    ASSERT_IS_TRUE(EventLoop_Run(&loop));
+
+    ASSERT_ARE_EQUAL(int, 0, timerCalls);
+}
+
+TEST_FUNCTION(EventLoop_AddTooManySources_ExpectFailure)
+{
+    for (uint32_t i = 0; i < EVENT_LOOP_MAX_SOURCES; ++i) {
+        ASSERT_IS_TRUE(EventLoop_AddTimer(&loop, TEST_TIMER_INTERVAL, CountCalls, NULL));
+    }
+
+    ASSERT_IS_FALSE(EventLoop_AddTimer(&loop, TEST_TIMER_INTERVAL, CountCalls, NULL));
+    ASSERT_IS_FALSE(EventLoop_AddFd(&loop, testPipe[0], CountCalls, NULL));
+}
+
+TEST_FUNCTION(EventLoop_AddTimerZeroInterval_ExpectFailure)
+{
+    ASSERT_IS_FALSE(EventLoop_AddTimer(&loop, 0, CountCalls, NULL));
+}
+
+END_TEST_SUITE(event_loop_ut)
@@ -6,6 +6,10 @@
 #include "macro_utils.h"
 #include "umock_c.h"
 #include "umocktypes_charptr.h"
+#include "umocktypes_bool.h"
+
+// the collectors run through the real execution module, so it is included before its mocked dependents
+#include "collectors/collector_execution.h"
 
 #define ENABLE_MOCKS
 #include "collectors/agent_configuration_error_collector.h"
@@ -25,8 +29,11 @@
 #include "synchronized_queue.h"
 #include "twin_configuration_event_collectors.h"
 #include "twin_configuration.h"
+#include "worker_pool.h"
 #undef ENABLE_MOCKS
 
+#include "consts.h"
+
 #include "tasks/event_monitor_task.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -39,18 +46,39 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
     ASSERT_FAIL(temp_str);
 }
 
-const uint32_t mockedSnapshotFrequiency = 10;
+// the periodic collectors are spread over 14 seconds, so each one runs on its own tick
+const uint32_t mockedSnapshotFrequiency = 14000;
+const time_t mockedStartTime = 1000;
 
 TwinConfigurationResult Mocked_TwinConfiguration_GetSnapshotFrequency(uint32_t* snapshotFrequency) {
     *snapshotFrequency = mockedSnapshotFrequiency;
     return TWIN_OK;
 }
 
+TwinConfigurationResult Mocked_TwinConfigurationEventCollectors_GetSnapshotSchedule(TwinConfigurationEventType eventType, TwinConfigurationSnapshotSchedule* schedule) {
+    schedule->interval = 0;
+    schedule->offset = 0;
+    return TWIN_OK;
+}
+
 TwinConfigurationResult Mocked_TwinConfigurationEventCollectors_GetPriority(TwinConfigurationEventType eventType, TwinConfigurationEventPriority* priority){
     *priority = eventType == EVENT_TYPE_OPERATIONAL_EVENT ? EVENT_PRIORITY_OPERATIONAL : EVENT_PRIORITY_HIGH;
     return TWIN_OK;
 }
 
+void Mocked_WorkerPool_InitJob(WorkerPoolJob* job, WorkerPoolJobFunc function, void* context) {
+    job->function = function;
+    job->context = context;
+    job->busy = false;
+    job->next = NULL;
+}
+
+// the jobs run inline, so the collectors are called in the order they are submitted
+WorkerPoolResult Mocked_WorkerPool_Submit(WorkerPool* pool, WorkerPoolJob* job) {
+    job->function(job->context);
+    return WORKER_POOL_OK;
+}
+
 int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
     if (data != NULL) {
         free(data);
@@ -70,6 +98,7 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     umock_c_init(on_umock_c_error);
     umocktypes_charptr_register_types();
+    umocktypes_bool_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
@@ -78,17 +107,27 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(int32_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationEventType, int);
+    REGISTER_UMOCK_ALIAS_TYPE(WorkerPoolResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(WorkerPoolJobFunc, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CollectorId, int);
 
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetSnapshotFrequency, Mocked_TwinConfiguration_GetSnapshotFrequency);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetPriority, Mocked_TwinConfigurationEventCollectors_GetPriority);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetSnapshotSchedule, Mocked_TwinConfigurationEventCollectors_GetSnapshotSchedule);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, Mocked_SyncQueue_PushBack);
+    REGISTER_GLOBAL_MOCK_HOOK(WorkerPool_InitJob, Mocked_WorkerPool_InitJob);
+    REGISTER_GLOBAL_MOCK_HOOK(WorkerPool_Submit, Mocked_WorkerPool_Submit);
+    REGISTER_GLOBAL_MOCK_RETURN(WorkerPool_Init, true);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
 {
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetSnapshotFrequency, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetPriority, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetSnapshotSchedule, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(WorkerPool_InitJob, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(WorkerPool_Submit, NULL);
 
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
@@ -100,6 +139,35 @@ TEST_FUNCTION_INITIALIZE(method_init)
     umock_c_reset_all_calls();
 }
 
+static void ExpectCollectorsInit() {
+    for (uint32_t i = 0; i < EVENT_MONITOR_PERIODIC_COLLECTORS + EVENT_MONITOR_TRIGGERED_COLLECTORS; ++i) {
+        // no budget is configured, so each collector gets the default budget of its pool
+        STRICT_EXPECTED_CALL(LocalConfiguration_GetCollectorBudget(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(WorkerPool_InitJob(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    }
+}
+
+static void ExpectInit() {
+    ExpectCollectorsInit();
+
+    // init collectors
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+
+    // the triggered collectors have their own pool
+    STRICT_EXPECTED_CALL(WorkerPool_Init(IGNORED_PTR_ARG, TRIGGERED_COLLECTOR_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(IGNORED_PTR_ARG, SNAPSHOT_COLLECTOR_WORKERS));
+}
+
+static void ExpectSchedulesStarted() {
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LOCAL_USERS, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_SYSTEM_INFORMATION, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LISTENING_PORTS, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_FIREWALL_CONFIGURATION, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_BASELINE, IGNORED_PTR_ARG));
+}
+
 TEST_FUNCTION(EventMonitorTask_Init_ExpectSuccess)
 {
     EventMonitorTask task;
@@ -107,9 +175,7 @@ TEST_FUNCTION(EventMonitorTask_Init_ExpectSuccess)
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    ExpectInit();
     bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
     ASSERT_IS_TRUE(result);
 
@@ -118,20 +184,47 @@ TEST_FUNCTION(EventMonitorTask_Init_ExpectSuccess)
     ASSERT_ARE_EQUAL(void_ptr, &lowPriorityQueue, task.lowPriorityQueue);
     ASSERT_ARE_EQUAL(uint32_t, 0, task.lastPeriodicExecution);
     ASSERT_ARE_EQUAL(uint32_t, 0, task.lastTriggeredExecution);
+    ASSERT_ARE_EQUAL(uint32_t, SNAPSHOT_COLLECTOR_DEFAULT_BUDGET, task.schedules[0].collector.budget);
+    ASSERT_ARE_EQUAL(uint32_t, TRIGGERED_COLLECTOR_DEFAULT_BUDGET, task.triggeredCollectors[0].budget);
 
     EventMonitorTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventMonitorTask_Deinit_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_InitWithConfiguredBudget_ExpectConfiguredBudget)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
+    const uint32_t baselineBudget = 5 * 60 * 1000;
 
-    // init collectors
+    for (uint32_t i = 0; i < EVENT_MONITOR_PERIODIC_COLLECTORS + EVENT_MONITOR_TRIGGERED_COLLECTORS; ++i) {
+        STRICT_EXPECTED_CALL(LocalConfiguration_GetCollectorBudget(IGNORED_NUM_ARG)).SetReturn(i == COLLECTOR_BASELINE ? baselineBudget : 0);
+        STRICT_EXPECTED_CALL(WorkerPool_InitJob(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    }
     STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
     STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    STRICT_EXPECTED_CALL(WorkerPool_Init(IGNORED_PTR_ARG, TRIGGERED_COLLECTOR_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(IGNORED_PTR_ARG, SNAPSHOT_COLLECTOR_WORKERS));
+
+    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
+    ASSERT_IS_TRUE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ASSERT_ARE_EQUAL(uint32_t, baselineBudget, task.schedules[COLLECTOR_BASELINE].collector.budget);
+    ASSERT_ARE_EQUAL(uint32_t, SNAPSHOT_COLLECTOR_DEFAULT_BUDGET, task.schedules[COLLECTOR_FIREWALL].collector.budget);
+
+    EventMonitorTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventMonitorTask_Deinit_ExpectSuccess)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    ExpectInit();
     bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
     ASSERT_IS_TRUE(result);
 
@@ -141,16 +234,38 @@ TEST_FUNCTION(EventMonitorTask_Deinit_ExpectSuccess)
     ASSERT_IS_NULL(task.lowPriorityQueue);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteGetSnapshotFrequencyFailed_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_InitSnapshotPoolFailed_ExpectFailure)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
+    ExpectCollectorsInit();
     STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
     STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.triggeredPool, TRIGGERED_COLLECTOR_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.snapshotPool, SNAPSHOT_COLLECTOR_WORKERS)).SetReturn(false);
+
+    // the started pool and the collectors are deinitiated
+    STRICT_EXPECTED_CALL(WorkerPool_Deinit(&task.triggeredPool));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_Deinit());
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Deinit());
+
+    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
+
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EventMonitorTask_ExecuteGetSnapshotFrequencyFailed_ExpectSuccess)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    ExpectInit();
     bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
     ASSERT_IS_TRUE(result);
 
@@ -163,22 +278,20 @@ TEST_FUNCTION(EventMonitorTask_ExecuteGetSnapshotFrequencyFailed_ExpectSuccess)
     EventMonitorTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteTimeoutDidNotPass_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_ExecuteFirstTime_ExpectSchedulesStartedAndNothingCollected)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    ExpectInit();
     bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(mockedStartTime);
+    ExpectSchedulesStarted();
 
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
     STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(100);
@@ -186,11 +299,12 @@ TEST_FUNCTION(EventMonitorTask_ExecuteTimeoutDidNotPass_ExpectSuccess)
     EventMonitorTask_Execute(&task);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(task.wheelStarted);
 
     EventMonitorTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteSnapshotTimeout_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_ExecuteSnapshotTimeout_ExpectCollectorsSpreadOverTheInterval)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
@@ -198,38 +312,54 @@ TEST_FUNCTION(EventMonitorTask_ExecuteSnapshotTimeout_ExpectSuccess)
     SyncQueue lowPriorityQueue;
     uint32_t triggeredInterval = 20;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    ExpectInit();
     bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
     ASSERT_IS_TRUE(result);
 
-    // check periodic events interval
+    // the first execution only starts the schedules
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(mockedStartTime);
+    ExpectSchedulesStarted();
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(triggeredInterval);
+    EventMonitorTask_Execute(&task);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    // check periodic events interval, the collectors are due one after the other during the interval
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(mockedSnapshotFrequiency * 10);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(mockedStartTime + mockedSnapshotFrequiency / 1000 - 1);
 
-    // all periodic collectors
+    // all periodic collectors run on the snapshot pool, each one is scheduled again after it is submitted
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.snapshotPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCollector_GetEvents(&operationalEventsQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.snapshotPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_LOCAL_USERS, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(LocalUsersCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LOCAL_USERS, IGNORED_PTR_ARG));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.snapshotPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_SYSTEM_INFORMATION, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(SystemInformationCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_SYSTEM_INFORMATION, IGNORED_PTR_ARG));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.snapshotPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_LISTENING_PORTS, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(ListeningPortCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LISTENING_PORTS, IGNORED_PTR_ARG));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.snapshotPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_FIREWALL_CONFIGURATION, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(FirewallCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_FIREWALL_CONFIGURATION, IGNORED_PTR_ARG));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.snapshotPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_BASELINE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(BaselineCollector_GetEvents(&highPriorityQueue));
-
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_BASELINE, IGNORED_PTR_ARG));
 
     // check triggered events interval
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(triggeredInterval / 2);
@@ -250,34 +380,37 @@ TEST_FUNCTION(EventMonitorTask_ExecuteTriggeredTimeout_ExpectSuccess)
     SyncQueue lowPriorityQueue;
     uint32_t triggeredInterval = 20;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    ExpectInit();
     bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
     ASSERT_IS_TRUE(result);
 
-    // check periodic events interval
+    // start the periodic schedules
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(mockedStartTime);
+    ExpectSchedulesStarted();
 
     // check triggered events interval
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(triggeredInterval * 10);
     STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(triggeredInterval);
 
-    // all collectors
+    // all collectors run on the triggered pool
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AgentConfigurationErrorCollector_GetEvents(&operationalEventsQueue));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_PROCESS_CREATE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(ProcessCreationCollector_GetEvents(&highPriorityQueue));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_USER_LOGIN, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(UserLoginCollector_GetEvents(&highPriorityQueue));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_CONNECTION_CREATE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_GetEvents(&highPriorityQueue));
 
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(&highPriorityQueue));
 
@@ -288,4 +421,68 @@ TEST_FUNCTION(EventMonitorTask_ExecuteTriggeredTimeout_ExpectSuccess)
     EventMonitorTask_Deinit(&task);
 }
 
+TEST_FUNCTION(EventMonitorTask_OnAuditEvents_ExpectCollectorSubmitted)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    ExpectInit();
+    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
+    ASSERT_IS_TRUE(result);
+    umock_c_reset_all_calls();
+
+    // only the collector which received the events runs
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_USER_LOGIN, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(UserLoginCollector_GetEvents(&highPriorityQueue));
+
+    EventMonitorTask_OnAuditEvents(&task, COLLECTOR_USER_LOGIN);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventMonitorTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventMonitorTask_OnAuditEventsWhileCollectorRuns_ExpectCollectorSubmittedOnNextExecution)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    uint32_t triggeredInterval = 20;
+
+    ExpectInit();
+    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
+    ASSERT_IS_TRUE(result);
+    umock_c_reset_all_calls();
+
+    // the collector still runs, so it is not skipped but marked pending
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG)).SetReturn(WORKER_POOL_JOB_BUSY);
+
+    EventMonitorTask_OnAuditEvents(&task, COLLECTOR_PROCESS_CREATION);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(mockedStartTime);
+    ExpectSchedulesStarted();
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(triggeredInterval);
+
+    // the pending collector runs even though the triggered interval did not pass
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredPool, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_PROCESS_CREATE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_GetEvents(&highPriorityQueue));
+
+    EventMonitorTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_FALSE(task.triggeredCollectors[1].pending);
+
+    EventMonitorTask_Deinit(&task);
+}
+
 END_TEST_SUITE(event_monitor_task_ut)
@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iothub_adapter.h"
+#include "local_config.h"
+#include "memory_monitor.h"
+#include "send_pipeline.h"
+#include "synchronized_queue.h"
+#include "tasks/event_publisher_task.h"
+#include "twin_configuration.h"
+
+// a message holds a few events only, so the events of the test fill several messages
+#define TEST_MAX_MESSAGE_SIZE 1024
+#define TEST_NUMBER_OF_EVENTS 12
+
+bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, uint32_t maxInFlightMessages);
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+// a process creation event, as serialized by the collector
+static const char TEST_EVENT_FORMAT[] =
+    "{\"Category\":\"Triggered\",\"IsEmpty\":false,\"IsOperational\":false,\"Name\":\"ProcessCreate\",\"PayloadSchemaVersion\":\"1.0\","
+    "\"Id\":\"9c3a46a5-0d9e-4b3f-8b1e-3f4f2f7d%04u\",\"TimestampLocal\":\"2019-01-01 10:00:00+0000\",\"TimestampUTC\":\"2019-01-01 10:00:00\","
+    "\"EventType\":\"Security\",\"Payload\":[{\"Executable\":\"/usr/bin/python3\",\"ProcessId\":%u}]}";
+static const char TEST_EVENT_NAME[] = "\"Name\":\"ProcessCreate\"";
+
+static SyncQueue highPriorityQueue;
+static SyncQueue lowPriorityQueue;
+static SyncQueue operationalQueue;
+static IoTHubAdapter adapter;
+static EventPublisherTask task;
+
+static char* sentMessages[SEND_PIPELINE_MAX_WINDOW];
+static uint32_t sentMessagesCount;
+
+TwinConfigurationResult TwinConfiguration_GetMaxMessageSize(uint32_t* maxMessageSize) {
+    *maxMessageSize = TEST_MAX_MESSAGE_SIZE;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult TwinConfiguration_GetMaxLocalCacheSize(uint32_t* maxLocalCacheSize) {
+    *maxLocalCacheSize = UINT32_MAX;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult TwinConfiguration_GetMessageCompressionEnabled(bool* messageCompressionEnabled) {
+    *messageCompressionEnabled = false;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult TwinConfiguration_GetColumnarMessagesEnabled(bool* columnarMessagesEnabled) {
+    *columnarMessagesEnabled = false;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult TwinConfiguration_GetHighPriorityMessageFrequency(uint32_t* highPriorityMessageFrequency) {
+    *highPriorityMessageFrequency = 0;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult TwinConfiguration_GetLowPriorityMessageFrequency(uint32_t* lowPriorityMessageFrequency) {
+    *lowPriorityMessageFrequency = 0;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult TwinConfiguration_GetMaxInFlightMessages(uint32_t* maxInFlightMessages) {
+    *maxInFlightMessages = SEND_PIPELINE_MAX_WINDOW;
+    return TWIN_OK;
+}
+
+const char* LocalConfiguration_GetAgentId() {
+    return "ea05af2d-7397-4a1b-9ec7-3dc15e762a69";
+}
+
+EventEncoding LocalConfiguration_GetEventEncoding() {
+    return EVENT_ENCODING_JSON;
+}
+
+bool IoTHubAdapter_IsConnected(IoTHubAdapter* iotHubAdapter) {
+    return true;
+}
+
+uint32_t IoTHubAdapter_DoWork(IoTHubAdapter* iotHubAdapter) {
+    return UINT32_MAX;
+}
+
+// the hub never confirms the messages, so every message which was sent stays in flight
+bool IoTHubAdapter_SendMessageWithConfirmationAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding, IoTHubAdapterSendConfirmation confirmationCallback, void* context) {
+    ASSERT_IS_TRUE(sentMessagesCount < SEND_PIPELINE_MAX_WINDOW);
+    char* message = malloc(dataSize + 1);
+    ASSERT_IS_NOT_NULL(message);
+    memcpy(message, data, dataSize);
+    message[dataSize] = '\0';
+    sentMessages[sentMessagesCount++] = message;
+    return true;
+}
+
+static void Test_FillQueue(SyncQueue* queue, uint32_t numberOfEvents) {
+    for (uint32_t i = 0; i < numberOfEvents; ++i) {
+        int eventSize = snprintf(NULL, 0, TEST_EVENT_FORMAT, i, i);
+        char* event = Queue_AllocateData(eventSize + 1);
+        ASSERT_IS_NOT_NULL(event);
+        snprintf(event, eventSize + 1, TEST_EVENT_FORMAT, i, i);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(queue, event, eventSize));
+    }
+}
+
+static uint32_t Test_CountEvents(const char* message) {
+    uint32_t events = 0;
+    for (const char* event = strstr(message, TEST_EVENT_NAME); event != NULL; event = strstr(event + 1, TEST_EVENT_NAME)) {
+        ++events;
+    }
+    return events;
+}
+
+BEGIN_TEST_SUITE(event_publisher_int)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+    ASSERT_IS_TRUE(MemoryMonitor_Init());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    MemoryMonitor_Deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex)) {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    memset(sentMessages, 0, sizeof(sentMessages));
+    sentMessagesCount = 0;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&highPriorityQueue, false));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&lowPriorityQueue, false));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&operationalQueue, false));
+    ASSERT_IS_TRUE(EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalQueue, &adapter));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    // the messages in flight are freed by the pipeline
+    EventPublisherTask_Deinit(&task);
+    for (uint32_t i = 0; i < sentMessagesCount; ++i) {
+        free(sentMessages[i]);
+    }
+    SyncQueue_Deinit(&highPriorityQueue);
+    SyncQueue_Deinit(&lowPriorityQueue);
+    SyncQueue_Deinit(&operationalQueue);
+
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(EventPublisherTask_SendEvents_FullMessages_ExpectAllEventsSentWhileInFlight)
+{
+    Test_FillQueue(&highPriorityQueue, TEST_NUMBER_OF_EVENTS);
+
+    ASSERT_IS_TRUE(EventPublisherTask_SendEvents(&task, &highPriorityQueue, &lowPriorityQueue, SEND_PIPELINE_MAX_WINDOW));
+
+    // none of the messages was confirmed, the messages after the first full one were built while it was in flight
+    ASSERT_IS_TRUE(sentMessagesCount > 1);
+    uint32_t sentEvents = 0;
+    for (uint32_t i = 0; i < sentMessagesCount; ++i) {
+        ASSERT_IS_TRUE(strlen(sentMessages[i]) <= TEST_MAX_MESSAGE_SIZE);
+        sentEvents += Test_CountEvents(sentMessages[i]);
+    }
+    ASSERT_ARE_EQUAL(int, TEST_NUMBER_OF_EVENTS, sentEvents);
+
+    uint32_t queueSize = 0;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_GetSize(&highPriorityQueue, &queueSize));
+    ASSERT_ARE_EQUAL(int, 0, queueSize);
+}
+
+TEST_FUNCTION(EventPublisherTask_SendEvents_WindowFull_ExpectEventsLeftInQueue)
+{
+    Test_FillQueue(&highPriorityQueue, TEST_NUMBER_OF_EVENTS);
+
+    ASSERT_IS_TRUE(EventPublisherTask_SendEvents(&task, &highPriorityQueue, &lowPriorityQueue, 2));
+
+    ASSERT_ARE_EQUAL(int, 2, sentMessagesCount);
+    uint32_t queueSize = 0;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_GetSize(&highPriorityQueue, &queueSize));
+    ASSERT_IS_TRUE(queueSize > 0);
+}
+
+END_TEST_SUITE(event_publisher_int)
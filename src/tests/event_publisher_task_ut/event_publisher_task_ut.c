@@ -11,12 +11,16 @@
 #define ENABLE_MOCKS
 #include "internal/time_utils.h"
 #include "iothub_adapter.h"
-#include "memory_monitor.h"
+#include "local_config.h"
 #include "message_serializer.h"
+#include "send_pipeline.h"
 #include "synchronized_queue.h"
+#include "tracked_allocator.h"
 #include "twin_configuration.h"
 #undef ENABLE_MOCKS
 
+#include "consts.h"
+#include "message_schema_consts.h"
 #include "tasks/event_publisher_task.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -32,10 +36,42 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+// the number of messages the serializer fills up before it empties the queues
+static uint32_t mockedFullMessages = 0;
+
 MessageSerializerResultValues Mocked_MessageSerializer_CreateSecurityMessage(SyncQueue** queues, uint32_t size, void** buffer) {
     *buffer = strdup("a");
+    if (mockedFullMessages > 0) {
+        --mockedFullMessages;
+        return MESSAGE_SERIALIZER_FULL;
+    }
+    return MESSAGE_SERIALIZER_OK;
+}
+
+MessageSerializerResultValues Mocked_MessageSerializer_CreateEncodedSecurityMessage(SyncQueue** queues, uint32_t size, EventEncoding encoding, bool compressed, bool columnar, void** buffer, uint32_t* bufferSize) {
+    *buffer = strdup("a");
+    *bufferSize = 1;
     return MESSAGE_SERIALIZER_OK;
 }
+
+SendPipelineResult Mocked_SendPipeline_Send(SendPipeline* pipeline, void* buffer, uint32_t size, const char* contentType, const char* contentEncoding) {
+    free(buffer);
+    return SEND_PIPELINE_OK;
+}
+
+static bool mockedMessageCompressionEnabled = false;
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetMessageCompressionEnabled(bool* messageCompressionEnabled) {
+    *messageCompressionEnabled = mockedMessageCompressionEnabled;
+    return TWIN_OK;
+}
+
+static bool mockedColumnarMessagesEnabled = false;
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetColumnarMessagesEnabled(bool* columnarMessagesEnabled) {
+    *columnarMessagesEnabled = mockedColumnarMessagesEnabled;
+    return TWIN_OK;
+}
 static uint32_t mockedSyncQueueGetSizesize = 0;
 static int mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
 
@@ -44,13 +80,13 @@ int Mocked_SyncQueue_GetSize(SyncQueue* queue, uint32_t* size){
     return mockedSyncQueueGetSizeReturnValue;
 }
 
-static uint32_t mockedCurrentMemoryConsumption = 0;
+static uint32_t mockedQueuedEventsSize = 0;
 static uint32_t mockedMaxMessageSize = 0;
 
 
-MemoryMonitorResultValues Mocked_MemoryMonitor_CurrentConsumption(uint32_t* size) {
-    *size = mockedCurrentMemoryConsumption;
-    return MEMORY_MONITOR_OK;
+bool Mocked_TrackedAllocator_GetUntrackedConsumption(uint32_t* size) {
+    *size = mockedQueuedEventsSize;
+    return true;
 }
 
 TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* maxMessageSize) {
@@ -58,6 +94,29 @@ TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* max
     return TWIN_OK;
 }
 
+static uint32_t mockedHighPriorityFrequency = 0;
+static uint32_t mockedLowPriorityFrequency = 0;
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetHighPriorityMessageFrequency(uint32_t* frequency) {
+    *frequency = mockedHighPriorityFrequency;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetLowPriorityMessageFrequency(uint32_t* frequency) {
+    *frequency = mockedLowPriorityFrequency;
+    return TWIN_OK;
+}
+
+static void ExpectInit(time_t currentTime) {
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(currentTime);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(currentTime);
+    STRICT_EXPECTED_CALL(QueueNotifier_Init(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_SetNotifier(IGNORED_PTR_ARG, IGNORED_PTR_ARG, true));
+    STRICT_EXPECTED_CALL(SyncQueue_SetNotifier(IGNORED_PTR_ARG, IGNORED_PTR_ARG, false));
+    STRICT_EXPECTED_CALL(SyncQueue_SetNotifier(IGNORED_PTR_ARG, IGNORED_PTR_ARG, false));
+}
+
 BEGIN_TEST_SUITE(event_publisher_task_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -74,7 +133,9 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(MessageSerializerResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
-    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(QueueNotifierWaitResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(EventEncoding, int);
+    REGISTER_UMOCK_ALIAS_TYPE(SendPipelineResult, int);
 
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(int32_t, unsigned int);
@@ -84,18 +145,36 @@ TEST_SUITE_INITIALIZE(suite_init)
     dummyTime = mktime(&tmpTime);
 
     REGISTER_GLOBAL_MOCK_HOOK(MessageSerializer_CreateSecurityMessage, Mocked_MessageSerializer_CreateSecurityMessage);
-    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_CurrentConsumption, Mocked_MemoryMonitor_CurrentConsumption);
+    REGISTER_GLOBAL_MOCK_HOOK(MessageSerializer_CreateEncodedSecurityMessage, Mocked_MessageSerializer_CreateEncodedSecurityMessage);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMessageCompressionEnabled, Mocked_TwinConfiguration_GetMessageCompressionEnabled);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetColumnarMessagesEnabled, Mocked_TwinConfiguration_GetColumnarMessagesEnabled);
+    REGISTER_GLOBAL_MOCK_HOOK(TrackedAllocator_GetUntrackedConsumption, Mocked_TrackedAllocator_GetUntrackedConsumption);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, Mocked_TwinConfiguration_GetMaxMessageSize);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, Mocked_SyncQueue_GetSize);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetHighPriorityMessageFrequency, Mocked_TwinConfiguration_GetHighPriorityMessageFrequency);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetLowPriorityMessageFrequency, Mocked_TwinConfiguration_GetLowPriorityMessageFrequency);
+    REGISTER_GLOBAL_MOCK_RETURN(QueueNotifier_Init, true);
+    REGISTER_GLOBAL_MOCK_RETURN(SendPipeline_Init, true);
+    REGISTER_GLOBAL_MOCK_RETURN(SendPipeline_HasRoom, true);
+    REGISTER_GLOBAL_MOCK_RETURN(SendPipeline_GetRetryTimeout, UINT32_MAX);
+    REGISTER_GLOBAL_MOCK_RETURN(IoTHubAdapter_DoWork, UINT32_MAX);
+    REGISTER_GLOBAL_MOCK_RETURN(IoTHubAdapter_IsConnected, true);
+    REGISTER_GLOBAL_MOCK_HOOK(SendPipeline_Send, Mocked_SendPipeline_Send);
 
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
 {
     REGISTER_GLOBAL_MOCK_HOOK(MessageSerializer_CreateSecurityMessage, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_CurrentConsumption, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(MessageSerializer_CreateEncodedSecurityMessage, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMessageCompressionEnabled, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetColumnarMessagesEnabled, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TrackedAllocator_GetUntrackedConsumption, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetHighPriorityMessageFrequency, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetLowPriorityMessageFrequency, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SendPipeline_Send, NULL);
 
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
@@ -106,8 +185,13 @@ TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
     // the default behavior  is that we haven't passed the maxMessageSize
-    mockedCurrentMemoryConsumption = 0;
-    mockedMaxMessageSize = mockedCurrentMemoryConsumption + 10;
+    mockedQueuedEventsSize = 0;
+    mockedMaxMessageSize = mockedQueuedEventsSize + 10;
+    mockedHighPriorityFrequency = 0;
+    mockedLowPriorityFrequency = 0;
+    mockedMessageCompressionEnabled = false;
+    mockedColumnarMessagesEnabled = false;
+    mockedFullMessages = 0;
 }
 
 TEST_FUNCTION(EventPublisherTask_Init_ExpectSuccess)
@@ -118,8 +202,7 @@ TEST_FUNCTION(EventPublisherTask_Init_ExpectSuccess)
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(dummyTime);
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(dummyTime);
+    ExpectInit(dummyTime);
 
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
 
@@ -130,6 +213,8 @@ TEST_FUNCTION(EventPublisherTask_Init_ExpectSuccess)
     ASSERT_ARE_EQUAL(void_ptr, &adapter, task.iothubAdapter);
     ASSERT_ARE_EQUAL(uint32_t, dummyTime, task.highPriorityQueueLastExecution);
     ASSERT_ARE_EQUAL(uint32_t, dummyTime, task.lowPriorityQueueLastExecution);
+    ASSERT_IS_FALSE(task.urgentEventsPending);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 TEST_FUNCTION(EventPublisherTask_Deinit_ExpectSuccess)
@@ -140,8 +225,7 @@ TEST_FUNCTION(EventPublisherTask_Deinit_ExpectSuccess)
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(dummyTime);
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(dummyTime);
+    ExpectInit(dummyTime);
 
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
 
@@ -166,18 +250,22 @@ TEST_FUNCTION(EventPublisherTask_ExecuteTimeoutsDidNotPass_ExpectSuccess)
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    ExpectInit(dummyTime);
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
 
     EventPublisherTask_Execute(&task);
 
@@ -186,7 +274,7 @@ TEST_FUNCTION(EventPublisherTask_ExecuteTimeoutsDidNotPass_ExpectSuccess)
     EventPublisherTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_ExpectSuccess)
+TEST_FUNCTION(EventPublisherTask_ExecuteDisconnected_ExpectEventsKeptInQueues)
 {
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
@@ -194,22 +282,58 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_Exp
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter)).SetReturn(false);
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_ExpectSuccess)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
 
     EventPublisherTask_Execute(&task);
 
@@ -218,7 +342,7 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_Exp
     EventPublisherTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueDidNotTimeoutLowQueueTimeout_ExpectSuccess)
+TEST_FUNCTION(EventPublisherTask_ExecuteCompressionEnabled_ExpectCompressedMessageSent)
 {
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
@@ -226,22 +350,152 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueDidNotTimeoutLowQueueTimeout_Exp
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
+    mockedMessageCompressionEnabled = true;
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateEncodedSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_ENCODING_JSON, true, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, MESSAGE_CONTENT_ENCODING_DEFLATE));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_ExecuteCborEncoding_ExpectCborMessageSent)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding()).SetReturn(EVENT_ENCODING_CBOR);
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateEncodedSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_ENCODING_CBOR, false, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, MESSAGE_CONTENT_TYPE_CBOR, NULL));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_ExecuteColumnarMessagesEnabled_ExpectColumnarMessageSent)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    mockedColumnarMessagesEnabled = true;
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateEncodedSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_ENCODING_JSON, false, true, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueDidNotTimeoutLowQueueTimeout_ExpectSuccess)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // low priority queue
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
 
     EventPublisherTask_Execute(&task);
 
@@ -258,26 +512,38 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueTimeout_ExpectSuc
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    ExpectInit(dummyTime);
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // low priority queue
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
 
     EventPublisherTask_Execute(&task);
 
@@ -294,22 +560,30 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeoutCeat
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    ExpectInit(dummyTime);
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&highPriorityQueue, &lowPriorityQueue};
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(MESSAGE_SERIALIZER_EXCEPTION);
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
     
     EventPublisherTask_Execute(&task);
 
@@ -326,29 +600,314 @@ TEST_FUNCTION(EventPublisherTask_Execute_MaxMessageSizeExceeded_ExpectSuccess)
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    ExpectInit(dummyTime);
     bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
     ASSERT_IS_TRUE(result);
 
-    mockedCurrentMemoryConsumption = 10;
+    mockedQueuedEventsSize = 10;
     mockedMaxMessageSize = 5;
     mockedSyncQueueGetSizesize = 1;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&highPriorityQueue, &lowPriorityQueue};
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_WaitUrgentEvent_ExpectHighPriorityQueueSent)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityFrequency = 5000;
+    mockedLowPriorityFrequency = 60000;
+    mockedSyncQueueGetSizesize = 1;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_SetWatermark(&task.notifier, mockedMaxMessageSize));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1000); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1000); // low priority queue
+    // the next deadline is the high priority one
+    STRICT_EXPECTED_CALL(SendPipeline_GetRetryTimeout(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_Wait(&task.notifier, 4000)).SetReturn(QUEUE_NOTIFIER_URGENT);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Wait(&task, SCHEDULER_INTERVAL);
+    ASSERT_IS_TRUE(task.urgentEventsPending);
+    EventPublisherTask_Execute(&task);
+    ASSERT_IS_FALSE(task.urgentEventsPending);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
 
+TEST_FUNCTION(EventPublisherTask_WaitDeadlinePassed_ExpectSchedulerIntervalTimeout)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityFrequency = 5000;
+    mockedLowPriorityFrequency = 60000;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_SetWatermark(&task.notifier, mockedMaxMessageSize));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(5000); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(5000); // low priority queue
+    STRICT_EXPECTED_CALL(SendPipeline_GetRetryTimeout(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_Wait(&task.notifier, SCHEDULER_INTERVAL)).SetReturn(QUEUE_NOTIFIER_TIMEOUT);
+
+    EventPublisherTask_Wait(&task, SCHEDULER_INTERVAL);
+    ASSERT_IS_FALSE(task.urgentEventsPending);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_WaitDeadlineFar_ExpectMaxWaitTimeout)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityFrequency = 10 * PUBLISHER_MAX_WAIT_INTERVAL;
+    mockedLowPriorityFrequency = 10 * PUBLISHER_MAX_WAIT_INTERVAL;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_SetWatermark(&task.notifier, mockedMaxMessageSize));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+    STRICT_EXPECTED_CALL(SendPipeline_GetRetryTimeout(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_Wait(&task.notifier, PUBLISHER_MAX_WAIT_INTERVAL)).SetReturn(QUEUE_NOTIFIER_SIGNALED);
+
+    EventPublisherTask_Wait(&task, SCHEDULER_INTERVAL);
+    ASSERT_IS_FALSE(task.urgentEventsPending);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_ExecuteFullMessage_ExpectNextMessageBuiltWhileInFlight)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedFullMessages = 1;
+    mockedSyncQueueGetSizesize = 1;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMessageCompressionEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetColumnarMessagesEnabled(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding());
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    // the first message was full, the second one is built while it is in flight
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_Send(&task.sendPipeline, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_ExecuteWindowFull_ExpectEventsKeptAndDeadlinesDue)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(dummyTime + 10);
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, dummyTime + 10));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG)).SetReturn(false);
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, dummyTime, task.highPriorityQueueLastExecution);
+    ASSERT_ARE_EQUAL(uint32_t, dummyTime, task.lowPriorityQueueLastExecution);
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_WaitRetryBeforeDeadline_ExpectRetryTimeout)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityFrequency = 5000;
+    mockedLowPriorityFrequency = 60000;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_SetWatermark(&task.notifier, mockedMaxMessageSize));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1000); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1000); // low priority queue
+    STRICT_EXPECTED_CALL(SendPipeline_GetRetryTimeout(&task.sendPipeline, IGNORED_NUM_ARG)).SetReturn(2000);
+    STRICT_EXPECTED_CALL(QueueNotifier_Wait(&task.notifier, 2000)).SetReturn(QUEUE_NOTIFIER_TIMEOUT);
+
+    EventPublisherTask_Wait(&task, SCHEDULER_INTERVAL);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_WaitLowLevelClient_ExpectDoWorkTimeout)
+{
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    ExpectInit(dummyTime);
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityFrequency = 5000;
+    mockedLowPriorityFrequency = 60000;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxInFlightMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_GetUntrackedConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(IoTHubAdapter_IsConnected(&adapter));
+    STRICT_EXPECTED_CALL(SendPipeline_Retry(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(SendPipeline_HasRoom(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+    STRICT_EXPECTED_CALL(IoTHubAdapter_DoWork(&adapter)).SetReturn(IOTHUB_DO_WORK_INTERVAL);
+
+    // the low level client is driven before the scheduler interval passes
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_SetWatermark(&task.notifier, mockedMaxMessageSize));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1000); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1000); // low priority queue
+    STRICT_EXPECTED_CALL(SendPipeline_GetRetryTimeout(&task.sendPipeline, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(QueueNotifier_Wait(&task.notifier, IOTHUB_DO_WORK_INTERVAL)).SetReturn(QUEUE_NOTIFIER_TIMEOUT);
 
     EventPublisherTask_Execute(&task);
+    ASSERT_ARE_EQUAL(uint32_t, IOTHUB_DO_WORK_INTERVAL, task.doWorkTimeout);
+    EventPublisherTask_Wait(&task, SCHEDULER_INTERVAL);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+
+#define ENABLE_MOCKS
+#include "agent_telemetry_counters.h"
+#include "queue.h"
+#include "synchronized_queue.h"
+#undef ENABLE_MOCKS
+
+#include "eviction_policy.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static EvictionPolicy policy;
+static SyncQueue lowPriorityQueue;
+static SyncQueue highPriorityQueue;
+static SyncQueue protectedQueue;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void AddQueue(SyncQueue* syncQueue, QueuePriority priority) {
+    syncQueue->queue.priority = priority;
+    ASSERT_IS_TRUE(EvictionPolicy_AddQueue(&policy, syncQueue, priority));
+}
+
+BEGIN_TEST_SUITE(eviction_policy_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(QueueEvictFunction, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(QueuePriority, int);
+    REGISTER_UMOCK_ALIAS_TYPE(QueueResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+
+    REGISTER_GLOBAL_MOCK_RETURN(AgentTelemetryCounter_Init, true);
+    REGISTER_GLOBAL_MOCK_RETURN(SyncQueue_SetEvictionPolicy, true);
+    REGISTER_GLOBAL_MOCK_RETURN(Queue_ConsumesSharedMemory, true);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    ASSERT_IS_TRUE(EvictionPolicy_Init(&policy));
+    AddQueue(&lowPriorityQueue, QUEUE_PRIORITY_LOW);
+    AddQueue(&highPriorityQueue, QUEUE_PRIORITY_HIGH);
+    AddQueue(&protectedQueue, QUEUE_PRIORITY_PROTECTED);
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    EvictionPolicy_Deinit(&policy);
+}
+
+TEST_FUNCTION(EvictionPolicy_AddQueue_ExpectPolicySetOnQueue)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(SyncQueue_SetEvictionPolicy(&syncQueue, QUEUE_PRIORITY_AGGREGATED, EvictionPolicy_Evict, &policy));
+
+    ASSERT_IS_TRUE(EvictionPolicy_AddQueue(&policy, &syncQueue, QUEUE_PRIORITY_AGGREGATED));
+    ASSERT_ARE_EQUAL(int, 4, policy.numberOfQueues);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_AddQueueBeyondMax_ExpectFailure)
+{
+    SyncQueue syncQueue;
+    while (policy.numberOfQueues < EVICTION_POLICY_MAX_QUEUES) {
+        ASSERT_IS_TRUE(EvictionPolicy_AddQueue(&policy, &syncQueue, QUEUE_PRIORITY_LOW));
+    }
+    umock_c_reset_all_calls();
+
+    ASSERT_IS_FALSE(EvictionPolicy_AddQueue(&policy, &syncQueue, QUEUE_PRIORITY_LOW));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_EvictForHighPriority_ExpectLowPriorityEvictedFromLowerQueue)
+{
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&lowPriorityQueue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&policy.counter, &policy.counter.counter.evictionCounter.lowPriority, 1));
+
+    ASSERT_IS_TRUE(EvictionPolicy_Evict(&policy, &highPriorityQueue.queue, QUEUE_PRIORITY_HIGH));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_EvictNoLowPriority_ExpectAggregatedEvictedFromOwnQueueWithoutLocking)
+{
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&lowPriorityQueue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&highPriorityQueue.queue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&lowPriorityQueue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&highPriorityQueue.queue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&policy.counter, &policy.counter.counter.evictionCounter.aggregated, 1));
+
+    ASSERT_IS_TRUE(EvictionPolicy_Evict(&policy, &highPriorityQueue.queue, QUEUE_PRIORITY_HIGH));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_EvictForProtected_ExpectHighPriorityEvicted)
+{
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&lowPriorityQueue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&highPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&highPriorityQueue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&protectedQueue.queue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&lowPriorityQueue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&highPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&highPriorityQueue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&protectedQueue.queue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&lowPriorityQueue, QUEUE_PRIORITY_HIGH)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&highPriorityQueue.queue));
+    STRICT_EXPECTED_CALL(SyncQueue_EvictOldest(&highPriorityQueue, QUEUE_PRIORITY_HIGH)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&policy.counter, &policy.counter.counter.evictionCounter.highPriority, 1));
+
+    ASSERT_IS_TRUE(EvictionPolicy_Evict(&policy, &protectedQueue.queue, QUEUE_PRIORITY_PROTECTED));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_EvictLowerQueueWithinReservation_ExpectOnlyOwnQueueEvicted)
+{
+    // evicting from a queue within its reserved budget frees nothing the pushing queue can use
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue)).SetReturn(false);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&highPriorityQueue.queue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_ConsumesSharedMemory(&lowPriorityQueue.queue)).SetReturn(false);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&highPriorityQueue.queue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_IS_EMPTY);
+
+    ASSERT_IS_FALSE(EvictionPolicy_Evict(&policy, &highPriorityQueue.queue, QUEUE_PRIORITY_HIGH));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_EvictForLowPriority_ExpectNothingEvicted)
+{
+    ASSERT_IS_FALSE(EvictionPolicy_Evict(&policy, &lowPriorityQueue.queue, QUEUE_PRIORITY_LOW));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EvictionPolicy_EvictFromLowPriorityQueue_ExpectHigherQueuesNotLocked)
+{
+    // a low priority queue may hold higher priority items, it evicts only from itself
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&lowPriorityQueue.queue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_IS_EMPTY);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&lowPriorityQueue.queue, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_IS_EMPTY);
+
+    ASSERT_IS_FALSE(EvictionPolicy_Evict(&policy, &lowPriorityQueue.queue, QUEUE_PRIORITY_HIGH));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(eviction_policy_ut)
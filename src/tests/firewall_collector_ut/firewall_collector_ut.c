@@ -11,6 +11,7 @@
 
 #define ENABLE_MOCKS
 #include "collectors/generic_event.h"
+#include "collectors/snapshot_event.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
 #include "os_utils/linux/iptables/iptables_iterator.h"
@@ -200,9 +201,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_ExpectSuccess)
     STRICT_EXPECTED_CALL(IptablesIterator_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SnapshotEvent_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
@@ -225,9 +224,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_NoIptables_ExpectSuccess)
     STRICT_EXPECTED_CALL(IptablesIterator_Init(IGNORED_PTR_ARG)).SetReturn(IPTABLES_NO_DATA);
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SnapshotEvent_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
@@ -288,9 +285,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_ExpectFailure)
     // no fail return
     STRICT_EXPECTED_CALL(IptablesIterator_Deinit(IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(SnapshotEvent_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
 
     // no fail return
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
@@ -300,7 +295,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_ExpectFailure)
     umock_c_negative_tests_snapshot();
 
     for (int i = 0; i < umock_c_negative_tests_call_count(); i++) {
-        if (i == 3 || i == 5 || i == 7 || i == 23 || i == 24 || i == 25 || i == 26 || i == 27 || i == 28 || i == 32 || i == 33) {
+        if (i == 3 || i == 5 || i == 7 || i == 23 || i == 24 || i == 25 || i == 26 || i == 27 || i == 28 || i == 30 || i == 31) {
             // no fail return
             continue;
         }
@@ -14,6 +14,8 @@
 #include "internal/time_utils.h"
 #include "json/json_object_writer.h"
 #include "json/json_array_writer.h"
+#include "event_encoder.h"
+#include "local_config.h"
 #undef ENABLE_MOCKS
 
 #include "collectors/generic_event.h"
@@ -126,6 +128,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(EventCollectorResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(UNIQUEID_RESULT, int);
     REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(EventEncoding, int);
+    REGISTER_UMOCK_ALIAS_TYPE(JsonBufferAllocateFunc, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(JsonBufferFreeFunc, void*);
     umocktypes_charptr_register_types();
     umocktypes_bool_register_types();
 
@@ -262,4 +267,30 @@ TEST_FUNCTION(GenericEvent_AddEmptyPayload_ExpectFail)
 }
 
 
+TEST_FUNCTION(GenericEvent_Serialize_ExpectEncodedWithLocalEncoding)
+{
+    char* output = NULL;
+    uint32_t size = 0;
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding()).SetReturn(EVENT_ENCODING_CBOR);
+    STRICT_EXPECTED_CALL(EventEncoder_EncodeObject(EVENT_ENCODING_CBOR, mockHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG, &output, &size)).SetReturn(JSON_WRITER_OK);
+
+    EventCollectorResult result = GenericEvent_Serialize(mockHandle, &output, &size);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(GenericEvent_Serialize_EncodingFailed_ExpectFail)
+{
+    char* output = NULL;
+    uint32_t size = 0;
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetEventEncoding()).SetReturn(EVENT_ENCODING_JSON);
+    STRICT_EXPECTED_CALL(EventEncoder_EncodeObject(EVENT_ENCODING_JSON, mockHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG, &output, &size)).SetReturn(JSON_WRITER_EXCEPTION);
+
+    EventCollectorResult result = GenericEvent_Serialize(mockHandle, &output, &size);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(generic_event_ut)
\ No newline at end of file
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+
+#define ENABLE_MOCKS
+#include "iothub_module_client.h"
+#include "iothub_module_client_ll.h"
+#undef ENABLE_MOCKS
+
+#include "transport/hub_transport.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static const char TEST_CONNECTION_STRING[] = "HostName=hub;DeviceId=device;ModuleId=module;SharedAccessKey=key";
+static const char TEST_OPTION_NAME[] = "option";
+static const unsigned char TEST_REPORTED_STATE[] = "{\"a\":\"b\"}";
+static const TRANSPORT_HANDLE TEST_HANDLE = (TRANSPORT_HANDLE)0x42;
+static const IOTHUB_MESSAGE_HANDLE TEST_MESSAGE = (IOTHUB_MESSAGE_HANDLE)0x43;
+static int testValue;
+static int testContext;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+const TRANSPORT_PROVIDER* AMQP_Protocol(void) {
+    return NULL;
+}
+
+static void Test_ConnectionStatusCallback(IOTHUB_CLIENT_CONNECTION_STATUS result, IOTHUB_CLIENT_CONNECTION_STATUS_REASON reason, void* context) {}
+static void Test_TwinCallback(DEVICE_TWIN_UPDATE_STATE updateState, const unsigned char* payload, size_t size, void* context) {}
+static void Test_ConfirmationCallback(IOTHUB_CLIENT_CONFIRMATION_RESULT result, void* context) {}
+static void Test_ReportedStateCallback(int statusCode, void* context) {}
+
+BEGIN_TEST_SUITE(hub_transport_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_charptr_register_types();
+    umocktypes_stdint_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(const unsigned char*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_CLIENT_CONNECTION_STATUS_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_CLIENT_DEVICE_TWIN_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_CLIENT_EVENT_CONFIRMATION_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_CLIENT_REPORTED_STATE_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_CLIENT_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_CLIENT_TRANSPORT_PROVIDER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MODULE_CLIENT_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MODULE_CLIENT_LL_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(HubTransport_GetInterface_ExpectOperationsDispatchedToModuleClient)
+{
+    const TransportInterface* transport = HubTransport_GetInterface();
+
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(TEST_CONNECTION_STRING, AMQP_Protocol)).SetReturn(TEST_HANDLE);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(TEST_HANDLE, TEST_OPTION_NAME, &testValue)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(TEST_HANDLE, Test_ConnectionStatusCallback, &testContext)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(TEST_HANDLE, Test_TwinCallback, &testContext)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(TEST_HANDLE, TEST_MESSAGE, Test_ConfirmationCallback, &testContext)).SetReturn(IOTHUB_CLIENT_ERROR);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendReportedState(TEST_HANDLE, TEST_REPORTED_STATE, sizeof(TEST_REPORTED_STATE), Test_ReportedStateCallback, &testContext)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_Destroy(TEST_HANDLE));
+
+    TRANSPORT_HANDLE handle = transport->Create(TEST_CONNECTION_STRING);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_HANDLE, handle);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetOption(handle, TEST_OPTION_NAME, &testValue));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetConnectionStatusCallback(handle, Test_ConnectionStatusCallback, &testContext));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetModuleTwinCallback(handle, Test_TwinCallback, &testContext));
+    // the results of the module client are passed through
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_ERROR, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, &testContext));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendReportedState(handle, TEST_REPORTED_STATE, sizeof(TEST_REPORTED_STATE), Test_ReportedStateCallback, &testContext));
+    transport->Destroy(handle);
+
+    // the module client does its work on a thread of its own
+    ASSERT_IS_NULL(transport->DoWork);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(HubTransport_GetLowLevelInterface_ExpectOperationsDispatchedToLowLevelModuleClient)
+{
+    const TransportInterface* transport = HubTransport_GetLowLevelInterface();
+
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_CreateFromConnectionString(TEST_CONNECTION_STRING, AMQP_Protocol)).SetReturn(TEST_HANDLE);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SetOption(TEST_HANDLE, TEST_OPTION_NAME, &testValue)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SetConnectionStatusCallback(TEST_HANDLE, Test_ConnectionStatusCallback, &testContext)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SetModuleTwinCallback(TEST_HANDLE, Test_TwinCallback, &testContext)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SendEventAsync(TEST_HANDLE, TEST_MESSAGE, Test_ConfirmationCallback, &testContext)).SetReturn(IOTHUB_CLIENT_ERROR);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SendReportedState(TEST_HANDLE, TEST_REPORTED_STATE, sizeof(TEST_REPORTED_STATE), Test_ReportedStateCallback, &testContext)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_DoWork(TEST_HANDLE));
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_Destroy(TEST_HANDLE));
+
+    TRANSPORT_HANDLE handle = transport->Create(TEST_CONNECTION_STRING);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_HANDLE, handle);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetOption(handle, TEST_OPTION_NAME, &testValue));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetConnectionStatusCallback(handle, Test_ConnectionStatusCallback, &testContext));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetModuleTwinCallback(handle, Test_TwinCallback, &testContext));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_ERROR, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, &testContext));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendReportedState(handle, TEST_REPORTED_STATE, sizeof(TEST_REPORTED_STATE), Test_ReportedStateCallback, &testContext));
+    ASSERT_IS_NOT_NULL(transport->DoWork);
+    transport->DoWork(handle);
+    transport->Destroy(handle);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(hub_transport_ut)
@@ -5,10 +5,6 @@
 #include "macro_utils.h"
 #include "umock_c.h"
 
-#define ENABLE_MOCKS
-#include "twin_configuration.h"
-#undef ENABLE_MOCKS
-
 #include "internal/internal_memory_monitor.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -22,12 +18,6 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
-static uint32_t mockedMaxLocalCacheSize = 0;
-TwinConfigurationResult Mocked_TwinConfiguration_GetMaxLocalCacheSize(uint32_t* maxLocalCacheSize) {
-    *maxLocalCacheSize = mockedMaxLocalCacheSize;
-    return TWIN_OK;
-}
-
 BEGIN_TEST_SUITE(internal_memory_monitor_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -41,14 +31,10 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
-    REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
-
-    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxLocalCacheSize, Mocked_TwinConfiguration_GetMaxLocalCacheSize);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
 {
-    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxLocalCacheSize, NULL);
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
      
@@ -62,8 +48,7 @@ TEST_FUNCTION_INITIALIZE(method_init)
 TEST_FUNCTION(InternalMemoryMonitor_Consume_ExpectSuccess)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -73,8 +58,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Consume_ExpectSuccess)
 TEST_FUNCTION(InternalMemoryMonitor_Consume_TwoItems_ExpectSuccess)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -87,30 +71,17 @@ TEST_FUNCTION(InternalMemoryMonitor_Consume_TwoItems_ExpectSuccess)
 TEST_FUNCTION(InternalMemoryMonitor_Consume_MemoryExceeded_ExpectSuccess)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(15);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, result);
 
     InternalMemoryMonitor_Deinit();
 }
 
-TEST_FUNCTION(InternalMemoryMonitor_Consume_TwinFailed_ExpectFailure)
-{
-    InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG)).SetReturn(!TWIN_OK);
-    MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(15);
-    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_EXCEPTION, result);
-
-    InternalMemoryMonitor_Deinit();
-}
-
 TEST_FUNCTION(InternalMemoryMonitor_Release_ExpectSuccess)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -125,8 +96,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Release_ExpectSuccess)
 TEST_FUNCTION(InternalMemoryMonitor_Release_TwoItems_ExpectSuccess)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -139,8 +109,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Release_TwoItems_ExpectSuccess)
 TEST_FUNCTION(InternalMemoryMonitor_Release_InvalidSize_ExpectFailure)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
 
     MemoryMonitorResultValues result = InternalMemoryMonitor_Release(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_INVALID_RELEASE_SIZE, result);
@@ -151,8 +120,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Release_InvalidSize_ExpectFailure)
 TEST_FUNCTION(InternalMemoryMonitor_CurrentConsumption_ExpectSuccess)
 {
     InternalMemoryMonitor_Init();
-    mockedMaxLocalCacheSize = 10;
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    InternalMemoryMonitor_SetLimit(10);
 
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(7);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
@@ -174,4 +142,189 @@ TEST_FUNCTION(InternalMemoryMonitor_CurrentConsumption_ExpectSuccess)
     InternalMemoryMonitor_Deinit();
 }
 
+TEST_FUNCTION(InternalMemoryMonitor_SetLimit_ExpectNewLimitApplied)
+{
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(8));
+
+    // lowering the limit does not affect what was already consumed
+    InternalMemoryMonitor_SetLimit(5);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Release(8));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(5));
+
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_ForceConsume_BeyondLimit_ExpectConsumedAndLimitEnforced)
+{
+    uint32_t currentConsumption = 0;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+
+    // forced consumption is never refused, but leaves no room for the rest
+    InternalMemoryMonitor_ForceConsume(12);
+    InternalMemoryMonitor_CurrentConsumption(&currentConsumption);
+    ASSERT_ARE_EQUAL(int, 12, currentConsumption);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Release(12));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(10));
+
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_InitBudget_ReservationExceedsLimit_ExpectFailure)
+{
+    MemoryBudget firstBudget;
+    MemoryBudget secondBudget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&firstBudget, 60));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_InitBudget(&secondBudget, 50));
+
+    InternalMemoryMonitor_DeinitBudget(&firstBudget);
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_Consume_ReservedMemory_ExpectMemoryExceeded)
+{
+    MemoryBudget budget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&budget, 60));
+
+    // only the unreserved part of the limit is shared
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(4));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+
+    // the reservation is still available to the budget
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 6));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_ConsumeFromBudget(&budget, 1));
+
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_CurrentConsumption(&size));
+    ASSERT_ARE_EQUAL(int, 10, size);
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&budget, 6));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Release(4));
+    InternalMemoryMonitor_DeinitBudget(&budget);
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_ConsumeFromBudget_BeyondReservation_ExpectSharedPoolUsed)
+{
+    MemoryBudget budget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&budget, 40));
+
+    // 4 bytes come from the reservation and 3 from the shared pool
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 7));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(3));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+
+    // releasing from the budget returns the shared part first
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&budget, 2));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(2));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+
+    InternalMemoryMonitor_DeinitBudget(&budget);
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_IsBeyondReservation_ExpectTrueOnlyWhileSharedPoolUsed)
+{
+    MemoryBudget budget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&budget, 40));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 4));
+    ASSERT_IS_FALSE(InternalMemoryMonitor_IsBeyondReservation(&budget));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 1));
+    ASSERT_IS_TRUE(InternalMemoryMonitor_IsBeyondReservation(&budget));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&budget, 5));
+    ASSERT_IS_FALSE(InternalMemoryMonitor_IsBeyondReservation(&budget));
+
+    InternalMemoryMonitor_DeinitBudget(&budget);
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_ReleaseToBudget_InvalidSize_ExpectFailure)
+{
+    MemoryBudget budget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&budget, 40));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 2));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_INVALID_RELEASE_SIZE, InternalMemoryMonitor_ReleaseToBudget(&budget, 3));
+
+    InternalMemoryMonitor_DeinitBudget(&budget);
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_SetLimit_LimitLoweredBelowReservations_ExpectReservationsFollowLimit)
+{
+    MemoryBudget firstBudget;
+    MemoryBudget secondBudget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(100);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&firstBudget, 20));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&secondBudget, 10));
+
+    // the limit is lowered below the reservations the budgets had, they now reserve 2 and 1 bytes out of 10
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(7));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&firstBudget, 2));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&secondBudget, 1));
+
+    // the budgets together never hold more than the limit
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_ConsumeFromBudget(&firstBudget, 1));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_ConsumeFromBudget(&secondBudget, 1));
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_CurrentConsumption(&size));
+    ASSERT_ARE_EQUAL(int, 10, size);
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&firstBudget, 2));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&secondBudget, 1));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Release(7));
+    InternalMemoryMonitor_DeinitBudget(&firstBudget);
+    InternalMemoryMonitor_DeinitBudget(&secondBudget);
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_ConsumeFromBudget_LimitLoweredWhileConsumed_ExpectSharedPoolCharged)
+{
+    MemoryBudget budget;
+    InternalMemoryMonitor_Init();
+    InternalMemoryMonitor_SetLimit(100);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_InitBudget(&budget, 50));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 40));
+
+    // the budget now holds more than its reservation of 5 bytes, so it is beyond it and cannot grow past the limit
+    InternalMemoryMonitor_SetLimit(10);
+    ASSERT_IS_TRUE(InternalMemoryMonitor_IsBeyondReservation(&budget));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_ConsumeFromBudget(&budget, 1));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+
+    // once it is drained the limit applies as usual
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&budget, 40));
+    ASSERT_IS_FALSE(InternalMemoryMonitor_IsBeyondReservation(&budget));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ConsumeFromBudget(&budget, 5));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(5));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_ReleaseToBudget(&budget, 5));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Release(5));
+    InternalMemoryMonitor_DeinitBudget(&budget);
+    InternalMemoryMonitor_Deinit();
+}
+
 END_TEST_SUITE(internal_memory_monitor_ut)
@@ -14,12 +14,17 @@
 
 #include "iothub.h"
 #include "iothub_module_client.h"
+#include "iothub_module_client_ll.h"
 #include "iothub_client.h"
 #include "iothub_client_options.h"
 
+#include "internal/time_utils.h"
 #include "local_config.h"
+#include "memory_monitor.h"
+#include "reconnect_worker.h"
 #include "synchronized_queue.h"
 #include "agent_telemetry_counters.h"
+#include "transport/local_transport.h"
 #include "twin_configuration.h"
 
 #undef ENABLE_MOCKS
@@ -63,8 +68,12 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_RESULT, void*);
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MODULE_CLIENT_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MODULE_CLIENT_LL_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ReconnectWorkerReconnect, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(TransportType, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
 
     umocktypes_bool_register_types();
@@ -94,6 +103,7 @@ TEST_FUNCTION(IoTHubAdapter_Init_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_AUTO_URL_ENCODE_DECODE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
@@ -101,12 +111,13 @@ TEST_FUNCTION(IoTHubAdapter_Init_ExpectSuccess)
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true); 
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     
     bool result = IoTHubAdapter_Init(&adapter, &queue);
     
     ASSERT_IS_TRUE(result);
-    ASSERT_ARE_EQUAL(void_ptr, 0x1, adapter.moduleHandle);
+    ASSERT_ARE_EQUAL(void_ptr, 0x1, adapter.transportHandle);
     ASSERT_IS_FALSE(adapter.hasTwinConfiguration);
     ASSERT_IS_FALSE(adapter.connected);
     ASSERT_ARE_EQUAL(void_ptr, &queue, adapter.twinUpdatesQueue);
@@ -122,6 +133,7 @@ TEST_FUNCTION(IoTHubAdapter_Init_SetAutoUrlOptionFailed_ExpectFailure)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_AUTO_URL_ENCODE_DECODE, IGNORED_PTR_ARG)).SetReturn(!IOTHUB_CLIENT_OK);
@@ -12,12 +12,17 @@
 #define ENABLE_MOCKS
 #include "agent_telemetry_counters.h"
 #include "azure_c_shared_utility/threadapi.h"
+#include "internal/time_utils.h"
 #include "iothub_client_options.h"
 #include "iothub_client.h"
 #include "iothub_module_client.h"
+#include "iothub_module_client_ll.h"
 #include "iothub.h"
 #include "local_config.h"
+#include "memory_monitor.h"
+#include "reconnect_worker.h"
 #include "synchronized_queue.h"
+#include "transport/local_transport.h"
 #include "twin_configuration.h"
 #undef ENABLE_MOCKS
 
@@ -83,8 +88,12 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_RESULT, void*);
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MODULE_CLIENT_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MODULE_CLIENT_LL_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ReconnectWorkerReconnect, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(TransportType, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
 
     umocktypes_bool_register_types();
@@ -123,18 +132,20 @@ TEST_FUNCTION(IoTHubAdapter_Init_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true); 
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
     bool result = IoTHubAdapter_Init(&adapter, &queue);
     
     ASSERT_IS_TRUE(result);
-    ASSERT_ARE_EQUAL(void_ptr, 0x1, adapter.moduleHandle);
+    ASSERT_ARE_EQUAL(void_ptr, 0x1, adapter.transportHandle);
     ASSERT_IS_FALSE(adapter.hasTwinConfiguration);
     ASSERT_IS_FALSE(adapter.connected);
     ASSERT_ARE_EQUAL(void_ptr, &queue, adapter.twinUpdatesQueue);
@@ -149,6 +160,7 @@ TEST_FUNCTION(IoTHubAdapter_Init_CreateFromConnectionStringFailed_ExpectFailure)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn((IOTHUB_MODULE_CLIENT_HANDLE)NULL);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Deinit(IGNORED_PTR_ARG));
@@ -169,6 +181,7 @@ TEST_FUNCTION(IoTHubAdapter_Init_SetLogOptionFailed_ExpectFailure)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(!IOTHUB_CLIENT_OK);
@@ -192,6 +205,7 @@ TEST_FUNCTION(IoTHubAdapter_Init_SetConnectionCallbackFailed_ExpectFailure)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
@@ -216,6 +230,7 @@ TEST_FUNCTION(IoTHubAdapter_Init_SetDeviceTwinCallbackFailed_ExpectFailure)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
@@ -242,17 +257,20 @@ TEST_FUNCTION(IoTHubAdapter_Deinit_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     bool result = IoTHubAdapter_Init(&adapter, &queue);
     
     ASSERT_IS_TRUE(result);
     
+    STRICT_EXPECTED_CALL(ReconnectWorker_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(IoTHubModuleClient_Destroy(mockHandle));
@@ -275,12 +293,14 @@ TEST_FUNCTION(IoTHubAdapter_Connect_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter));
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     bool result = IoTHubAdapter_Init(&adapter, &queue);
 
@@ -303,6 +323,124 @@ TEST_FUNCTION(IoTHubAdapter_Connect_ExpectSuccess)
     REGISTER_GLOBAL_MOCK_HOOK(IoTHubModuleClient_SetModuleTwinCallback, NULL);
 }
 
+TEST_FUNCTION(IoTHubAdapter_ConnectionLost_ExpectReconnectScheduledAndDisconnectedTimeCounted)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubModuleClient_SetConnectionStatusCallback, Mocked_IoTHubModuleClient_SetConnectionStatusCallback);
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter));
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+
+    ASSERT_IS_TRUE(result);
+    connectionCallback(IOTHUB_CLIENT_CONNECTION_AUTHENTICATED, IOTHUB_CLIENT_CONNECTION_OK, connectionContext);
+    adapter.reconnectEnabled = true;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(10);
+    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Schedule(&adapter.reconnectWorker)).SetReturn(true);
+    connectionCallback(IOTHUB_CLIENT_CONNECTION_UNAUTHENTICATED, IOTHUB_CLIENT_CONNECTION_RETRY_EXPIRED, connectionContext);
+    ASSERT_IS_FALSE(IoTHubAdapter_IsConnected(&adapter));
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(15);
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(15, 10)).SetReturn(5000);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 5000));
+    STRICT_EXPECTED_CALL(ReconnectWorker_Reset(&adapter.reconnectWorker));
+    connectionCallback(IOTHUB_CLIENT_CONNECTION_AUTHENTICATED, IOTHUB_CLIENT_CONNECTION_OK, connectionContext);
+    ASSERT_IS_TRUE(IoTHubAdapter_IsConnected(&adapter));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubModuleClient_SetConnectionStatusCallback, NULL);
+}
+
+TEST_FUNCTION(IoTHubAdapter_DoWork_ExpectNothingDoneForHubTransport)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+
+    ASSERT_IS_TRUE(result);
+    umock_c_reset_all_calls();
+
+    uint32_t nextDoWork = IoTHubAdapter_DoWork(&adapter);
+
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, nextDoWork);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);
+}
+
+TEST_FUNCTION(IoTHubAdapter_DoWork_ExpectLowLevelClientDriven)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_LL_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_LL_HANDLE)0x1;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType()).SetReturn(TRANSPORT_TYPE_HUB_LL);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_DoWork(mockHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    STRICT_EXPECTED_CALL(ReconnectWorker_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_LL_Destroy(mockHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Lock_Deinit(MOCKED_LOCK));
+
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+    ASSERT_IS_TRUE(result);
+
+    uint32_t nextDoWork = IoTHubAdapter_DoWork(&adapter);
+    ASSERT_ARE_EQUAL(uint32_t, IOTHUB_DO_WORK_INTERVAL, nextDoWork);
+
+    IoTHubAdapter_Deinit(&adapter);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_ExpectSuccess)
 {
     IoTHubAdapter adapter;
@@ -312,12 +450,14 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     
     bool result = IoTHubAdapter_Init(&adapter, &queue);
@@ -327,12 +467,13 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_ExpectSuccess)
     char* dataToSend = "This is a message";
     IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
     STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
     STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
@@ -344,6 +485,96 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_ExpectSuccess)
     IoTHubAdapter_Deinit(&adapter);   
 }
 
+TEST_FUNCTION(IoTHubAdapter_SendEncodedMessageAsync_ExpectContentEncodingSet)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+    
+    ASSERT_IS_TRUE(result);
+    
+    char* dataToSend = "This is a message";
+    IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetContentEncodingSystemProperty(mockedMessageHandle, MESSAGE_CONTENT_ENCODING_DEFLATE)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
+    STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    result = IoTHubAdapter_SendEncodedMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, MESSAGE_CONTENT_ENCODING_DEFLATE);
+    ASSERT_IS_TRUE(result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);   
+}
+
+TEST_FUNCTION(IoTHubAdapter_SendEncodedMessageAsync_ExpectContentTypeSet)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+    
+    ASSERT_IS_TRUE(result);
+    
+    char* dataToSend = "This is a message";
+    IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetContentTypeSystemProperty(mockedMessageHandle, MESSAGE_CONTENT_TYPE_CBOR)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
+    STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    result = IoTHubAdapter_SendEncodedMessageAsync(&adapter, dataToSend, strlen(dataToSend), MESSAGE_CONTENT_TYPE_CBOR, NULL);
+    ASSERT_IS_TRUE(result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);   
+}
+
 TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageSentCallback_ExpectSuccess)
 {
     IoTHubAdapter adapter;
@@ -353,12 +584,14 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageSentCallback_ExpectSucce
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
     bool result = IoTHubAdapter_Init(&adapter, &queue);
@@ -368,12 +601,13 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageSentCallback_ExpectSucce
     char* dataToSend = "This is a message";
     IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
     STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
     STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
@@ -394,12 +628,14 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageConfirmationCallback_Exp
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
     bool result = IoTHubAdapter_Init(&adapter, &queue);
@@ -409,12 +645,13 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageConfirmationCallback_Exp
     char* dataToSend = "This is a message";
     IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
     STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
     STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
@@ -427,6 +664,59 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageConfirmationCallback_Exp
     REGISTER_GLOBAL_MOCK_HOOK(IoTHubModuleClient_SendEventAsync, NULL);
 }
 
+static bool messageConfirmed = false;
+
+static void TestSendConfirmation(bool confirmed, void* context) {
+    messageConfirmed = confirmed && context == &messageConfirmed;
+}
+
+TEST_FUNCTION(IoTHubAdapter_SendMessageWithConfirmationAsync_ExpectConfirmationReported)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubModuleClient_SendEventAsync, Mocked_IoTHubModuleClient_SendEventAsync);
+    messageConfirmed = false;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+    
+    ASSERT_IS_TRUE(result);
+    
+    char* dataToSend = "This is a message";
+    IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
+    STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    result = IoTHubAdapter_SendMessageWithConfirmationAsync(&adapter, dataToSend, strlen(dataToSend), NULL, NULL, TestSendConfirmation, &messageConfirmed);
+    ASSERT_IS_TRUE(result);
+    ASSERT_IS_TRUE(messageConfirmed);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubModuleClient_SendEventAsync, NULL);
+}
+
 TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CreateMessageFromBytesFailed_ExpectFailure)
 {
     IoTHubAdapter adapter;
@@ -436,12 +726,14 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CreateMessageFromBytesFailed_Expect
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
     bool result = IoTHubAdapter_Init(&adapter, &queue);
@@ -450,7 +742,6 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CreateMessageFromBytesFailed_Expect
     
     char* dataToSend = "This is a message";
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
     STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(NULL);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     
@@ -471,12 +762,14 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_SetAsSecurityMessageFailed_ExpectFa
 
     STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTransportType());
     STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
     STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ReconnectWorker_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     bool result = IoTHubAdapter_Init(&adapter, &queue);
     
@@ -485,7 +778,6 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_SetAsSecurityMessageFailed_ExpectFa
     char* dataToSend = "This is a message";
     IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
     STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
     STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
     STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(!IOTHUB_MESSAGE_OK);
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
@@ -22,6 +22,11 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+static JSON_Status Mocked_json_serialize_to_buffer(const JSON_Value* value, char* buf, size_t buf_size_in_bytes) {
+    strncpy(buf, "abc", buf_size_in_bytes);
+    return JSONSuccess;
+}
+
 BEGIN_TEST_SUITE(json_array_writer_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -34,6 +39,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JSON_Status, int);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned long);
+
+    REGISTER_GLOBAL_MOCK_HOOK(json_serialize_to_buffer, Mocked_json_serialize_to_buffer);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -192,7 +200,8 @@ TEST_FUNCTION(JsonArrayWriter_Serialize_ExpectSuccess)
 
     char* expectedBuffer = "abc";
     
-    STRICT_EXPECTED_CALL(json_serialize_to_string(arrayValuePtr)).SetReturn(expectedBuffer);
+    STRICT_EXPECTED_CALL(json_serialization_size(arrayValuePtr)).SetReturn(strlen(expectedBuffer) + 1);
+    STRICT_EXPECTED_CALL(json_serialize_to_buffer(arrayValuePtr, IGNORED_PTR_ARG, strlen(expectedBuffer) + 1));
 
     char* outBuffer = NULL;
     uint32_t outBufferSize = 0;
@@ -203,6 +212,8 @@ TEST_FUNCTION(JsonArrayWriter_Serialize_ExpectSuccess)
     ASSERT_ARE_EQUAL(int, strlen(expectedBuffer), outBufferSize);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());  
 
+    free(outBuffer);
+
     JsonArrayWriter_Deinit(writer);
 }
 
@@ -217,7 +228,8 @@ TEST_FUNCTION(JsonArrayWriter_SerializeFailed_ExpectFailure)
     JsonWriterResult result = JsonArrayWriter_Init(&writer);
     ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
 
-    STRICT_EXPECTED_CALL(json_serialize_to_string(arrayValuePtr)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(json_serialization_size(arrayValuePtr)).SetReturn(4);
+    STRICT_EXPECTED_CALL(json_serialize_to_buffer(arrayValuePtr, IGNORED_PTR_ARG, 4)).SetReturn(JSONFailure);
 
     char* outBuffer = NULL;
     uint32_t outBufferSize = 0;
@@ -229,4 +241,43 @@ TEST_FUNCTION(JsonArrayWriter_SerializeFailed_ExpectFailure)
     JsonArrayWriter_Deinit(writer);
 }
 
+TEST_FUNCTION(JsonArrayWriter_GetObject_ExpectWriterOfTheItem)
+{
+    JsonArrayWriter writer;
+    writer.rootArray = (JSON_Array*)0x1;
+    JSON_Value* itemValuePtr = (JSON_Value*)0x20;
+    JSON_Object* itemObjectPtr = (JSON_Object*)0x21;
+
+    STRICT_EXPECTED_CALL(json_array_get_value((JSON_Array*)0x1, 3)).SetReturn(itemValuePtr);
+    STRICT_EXPECTED_CALL(json_value_get_object(itemValuePtr)).SetReturn(itemObjectPtr);
+
+    JsonObjectWriterHandle item = NULL;
+    JsonWriterResult result = JsonArrayWriter_GetObject((JsonArrayWriterHandle)&writer, 3, &item);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    ASSERT_IS_TRUE(((JsonObjectWriter*)item)->rootValue == itemValuePtr);
+    ASSERT_IS_TRUE(((JsonObjectWriter*)item)->rootObject == itemObjectPtr);
+    // the item is owned by the array
+    ASSERT_IS_FALSE(((JsonObjectWriter*)item)->shouldFree);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    free(item);
+}
+
+TEST_FUNCTION(JsonArrayWriter_GetObjectNotAnObject_ExpectFailure)
+{
+    JsonArrayWriter writer;
+    writer.rootArray = (JSON_Array*)0x1;
+
+    STRICT_EXPECTED_CALL(json_array_get_value((JSON_Array*)0x1, 3)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(json_value_get_object(NULL)).SetReturn(NULL);
+
+    JsonObjectWriterHandle item = NULL;
+    JsonWriterResult result = JsonArrayWriter_GetObject((JsonArrayWriterHandle)&writer, 3, &item);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, result);
+    ASSERT_IS_NULL(item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(json_array_writer_ut)
@@ -10,5 +10,8 @@ MOCKABLE_FUNCTION(, JSON_Value*, json_value_init_array);
 MOCKABLE_FUNCTION(, JSON_Array*, json_value_get_array, const JSON_Value*, value);
 MOCKABLE_FUNCTION(, void, json_value_free, JSON_Value*, value);
 MOCKABLE_FUNCTION(, JSON_Status, json_array_append_value, JSON_Array*, array, JSON_Value*, value);
-MOCKABLE_FUNCTION(, char *, json_serialize_to_string, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, size_t, json_serialization_size, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, JSON_Status, json_serialize_to_buffer, const JSON_Value*, value, char*, buf, size_t, buf_size_in_bytes);
 MOCKABLE_FUNCTION(, size_t, json_array_get_count, const JSON_Array*, array);
+MOCKABLE_FUNCTION(, JSON_Value*, json_array_get_value, const JSON_Array*, array, size_t, index);
+MOCKABLE_FUNCTION(, JSON_Object*, json_value_get_object, const JSON_Value*, value);
\ No newline at end of file
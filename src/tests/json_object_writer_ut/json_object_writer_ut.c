@@ -22,6 +22,11 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+static JSON_Status Mocked_json_serialize_to_buffer(const JSON_Value* value, char* buf, size_t buf_size_in_bytes) {
+    strncpy(buf, "abc", buf_size_in_bytes);
+    return JSONSuccess;
+}
+
 BEGIN_TEST_SUITE(json_object_writer_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -34,6 +39,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JSON_Status, int);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned long);
+
+    REGISTER_GLOBAL_MOCK_HOOK(json_serialize_to_buffer, Mocked_json_serialize_to_buffer);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
 }
 
@@ -357,7 +365,8 @@ TEST_FUNCTION(JsonObjectWriter_Serialize_ExpectSuccess)
 
     char* expectedBuffer = "abc";
     
-    STRICT_EXPECTED_CALL(json_serialize_to_string(valuePtr)).SetReturn(expectedBuffer);
+    STRICT_EXPECTED_CALL(json_serialization_size(valuePtr)).SetReturn(strlen(expectedBuffer) + 1);
+    STRICT_EXPECTED_CALL(json_serialize_to_buffer(valuePtr, IGNORED_PTR_ARG, strlen(expectedBuffer) + 1));
 
     char* outBuffer = NULL;
     uint32_t outBufferSize = 0;
@@ -368,6 +377,8 @@ TEST_FUNCTION(JsonObjectWriter_Serialize_ExpectSuccess)
     ASSERT_ARE_EQUAL(int, strlen(expectedBuffer), outBufferSize);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());  
 
+    free(outBuffer);
+
     JsonObjectWriter_Deinit(writer);
 }
 
@@ -383,7 +394,8 @@ TEST_FUNCTION(JsonObjectWriter_SerializeFailed_ExpectFailure)
 
     ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
 
-    STRICT_EXPECTED_CALL(json_serialize_to_string(valuePtr)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(json_serialization_size(valuePtr)).SetReturn(4);
+    STRICT_EXPECTED_CALL(json_serialize_to_buffer(valuePtr, IGNORED_PTR_ARG, 4)).SetReturn(JSONFailure);
 
     char* outBuffer = NULL;
     uint32_t outBufferSize = 0;
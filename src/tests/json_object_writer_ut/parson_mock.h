@@ -13,7 +13,8 @@ MOCKABLE_FUNCTION(, JSON_Status, json_object_set_string, JSON_Object*, object, c
 MOCKABLE_FUNCTION(, JSON_Status, json_object_set_number, JSON_Object*, object, const char*, name, double, number);
 MOCKABLE_FUNCTION(, JSON_Status, json_object_set_value, JSON_Object*, object, const char*, name, JSON_Value*, value);
 MOCKABLE_FUNCTION(, JSON_Status, json_object_set_boolean, JSON_Object*, object, const char*, name, int, boolean);
-MOCKABLE_FUNCTION(, char *, json_serialize_to_string, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, size_t, json_serialization_size, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, JSON_Status, json_serialize_to_buffer, const JSON_Value*, value, char*, buf, size_t, buf_size_in_bytes);
 MOCKABLE_FUNCTION(, JSON_Value*, json_parse_string, const char*, string);
 MOCKABLE_FUNCTION(, int, json_value_equals, const JSON_Value*, a, const JSON_Value*, b);
 MOCKABLE_FUNCTION(, size_t, json_object_get_count, const JSON_Object*, object);
@@ -144,5 +144,39 @@ TEST_FUNCTION(JsonWriterWithParson_TestObjectWithArrayWithObjects_ExpectSuccess)
     JsonObjectWriter_Deinit(outerObjectWriter);
 }
 
+static uint32_t allocatedBufferSize = 0;
+
+static void* TestAllocate(uint32_t size) {
+    allocatedBufferSize = size;
+    return malloc(size);
+}
+
+TEST_FUNCTION(JsonWriterWithParson_SerializeWithAllocator_ExpectSuccess)
+{
+    JsonObjectWriterHandle writer;
+    JsonWriterResult result = JsonObjectWriter_Init(&writer);
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+
+    result = JsonObjectWriter_WriteString(writer, "name", "Sherlock Holmes");
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+
+    result = JsonObjectWriter_WriteInt(writer, "street number", 221);
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+
+    char* buffer = NULL;
+    uint32_t size = 0;
+    allocatedBufferSize = 0;
+
+    result = JsonObjectWriter_SerializeWithAllocator(writer, TestAllocate, free, &buffer, &size);
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    const char* expectedValue = "{\"name\":\"Sherlock Holmes\",\"street number\":221}";
+    ASSERT_ARE_EQUAL(char_ptr, expectedValue, buffer);
+    ASSERT_ARE_EQUAL(int, strlen(expectedValue), size);
+    // exactly the serialized object and its null terminator
+    ASSERT_ARE_EQUAL(int, strlen(expectedValue) + 1, allocatedBufferSize);
+
+    free(buffer);
+    JsonObjectWriter_Deinit(writer);
+}
 
 END_TEST_SUITE(json_writer_with_parson_ut)
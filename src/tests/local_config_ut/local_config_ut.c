@@ -105,6 +105,7 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateSecurityModuleKeyAuthenticat
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ConnectionTimeout", IGNORED_PTR_ARG));    
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "RemoteConfigurationObjectName", IGNORED_PTR_ARG));    
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Transport")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Authentication"));
 
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "AuthenticationMethod", IGNORED_PTR_ARG));
@@ -126,11 +127,20 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateSecurityModuleKeyAuthenticat
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "SpillLog"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiskQuotaInBytes", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "EventEncoding", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_UnsafeAreStringsEqual(IGNORED_PTR_ARG, "Cbor", false)).SetReturn(false);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "CollectorBudgets")).SetReturn(JSON_READER_KEY_MISSING);
 
     int result = LocalConfiguration_Init();
     ASSERT_ARE_EQUAL(int, LOCAL_CONFIGURATION_OK, result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, EVENT_ENCODING_JSON, LocalConfiguration_GetEventEncoding());
 
     LocalConfiguration_Deinit();
 }
@@ -146,6 +156,7 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceKeyAuthentication_Expe
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ConnectionTimeout", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "RemoteConfigurationObjectName", IGNORED_PTR_ARG)); 
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);   
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Transport")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Authentication"));
 
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "AuthenticationMethod", IGNORED_PTR_ARG));
@@ -169,11 +180,20 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceKeyAuthentication_Expe
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "SpillLog"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiskQuotaInBytes", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "EventEncoding", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_UnsafeAreStringsEqual(IGNORED_PTR_ARG, "Cbor", false)).SetReturn(false);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "CollectorBudgets")).SetReturn(JSON_READER_KEY_MISSING);
 
     int result = LocalConfiguration_Init();
     ASSERT_ARE_EQUAL(int, LOCAL_CONFIGURATION_OK, result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, EVENT_ENCODING_JSON, LocalConfiguration_GetEventEncoding());
 
     LocalConfiguration_Deinit();
 }
@@ -190,6 +210,7 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceCertificateAuthenticat
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ConnectionTimeout", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "RemoteConfigurationObjectName", IGNORED_PTR_ARG));  
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);  
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Transport")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Authentication"));
 
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "AuthenticationMethod", IGNORED_PTR_ARG));
@@ -214,11 +235,20 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceCertificateAuthenticat
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "SpillLog"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiskQuotaInBytes", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "EventEncoding", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_UnsafeAreStringsEqual(IGNORED_PTR_ARG, "Cbor", false)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "CollectorBudgets")).SetReturn(JSON_READER_KEY_MISSING);
 
     int result = LocalConfiguration_Init();
     ASSERT_ARE_EQUAL(int, LOCAL_CONFIGURATION_OK, result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, EVENT_ENCODING_CBOR, LocalConfiguration_GetEventEncoding());
 
     LocalConfiguration_Deinit();
 }
@@ -235,6 +265,7 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceNonExistingAuthenticat
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ConnectionTimeout", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "RemoteConfigurationObjectName", IGNORED_PTR_ARG)); 
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);   
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Transport")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Authentication"));
 
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "AuthenticationMethod", IGNORED_PTR_ARG));
@@ -261,4 +292,71 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceNonExistingAuthenticat
     LocalConfiguration_Deinit();
 }
 
+TEST_FUNCTION(LocalConfiguration_InitJsonWithLocalTransport_ExpectNoAuthentication)
+{
+    uint32_t baselineBudget = 60000;
+
+    STRICT_EXPECTED_CALL(GetExecutableDirectory());
+    STRICT_EXPECTED_CALL(JsonObjectReader_InitFromFile(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Configuration"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "AgentId", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "TriggerdEventsInterval", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ConnectionTimeout", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "RemoteConfigurationObjectName", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Transport"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Type", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_UnsafeAreStringsEqual(IGNORED_PTR_ARG, "Local", false)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Local"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "SinkPath", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "TwinFilePath", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "LatencyInMilliseconds", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "FailureRatePercent", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "SpillLog"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiskQuotaInBytes", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "EventEncoding", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Utils_UnsafeAreStringsEqual(IGNORED_PTR_ARG, "Cbor", false)).SetReturn(false);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "CollectorBudgets"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "AgentTelemetry", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "LocalUsers", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "SystemInformation", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ListeningPorts", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "FirewallConfiguration", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "Baseline", IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_output(&baselineBudget, sizeof(baselineBudget))
+        .SetReturn(JSON_READER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "AgentConfigurationError", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ProcessCreate", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "UserLogin", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "ConnectionCreate", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadTimeInMilliseconds(IGNORED_PTR_ARG, "Diagnostic", IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+
+    int result = LocalConfiguration_Init();
+    ASSERT_ARE_EQUAL(int, LOCAL_CONFIGURATION_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, TRANSPORT_TYPE_LOCAL, LocalConfiguration_GetTransportType());
+    ASSERT_ARE_EQUAL(int, 60000, LocalConfiguration_GetCollectorBudget(COLLECTOR_BASELINE));
+    ASSERT_ARE_EQUAL(int, 0, LocalConfiguration_GetCollectorBudget(COLLECTOR_FIREWALL));
+
+    LocalConfiguration_Deinit();
+    ASSERT_ARE_EQUAL(int, TRANSPORT_TYPE_HUB, LocalConfiguration_GetTransportType());
+    ASSERT_ARE_EQUAL(int, 0, LocalConfiguration_GetCollectorBudget(COLLECTOR_BASELINE));
+}
+
 END_TEST_SUITE(local_config_ut)
@@ -0,0 +1,361 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+
+#define ENABLE_MOCKS
+#include "iothub_message.h"
+#include "local_config.h"
+#undef ENABLE_MOCKS
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#include "transport/local_transport.h"
+
+// the longest the tests wait for the worker of the transport, in milliseconds
+#define TEST_TIMEOUT (5 * LOCAL_TRANSPORT_TWIN_POLL_INTERVAL)
+#define TEST_WAIT_INTERVAL 10
+#define TEST_MAX_CONFIRMATIONS 16
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static const IOTHUB_MESSAGE_HANDLE TEST_MESSAGE = (IOTHUB_MESSAGE_HANDLE)0x42;
+static const char TEST_MESSAGE_DATA[] = "{\"Events\":[]}";
+static const char TEST_CONTENT_TYPE[] = "application/json";
+static const char TEST_CONTENT_ENCODING[] = "utf-8";
+static const char TEST_MESSAGE_RECORD[] = "message application/json utf-8 13\n{\"Events\":[]}\n";
+static const char TEST_REPORTED_STATE[] = "{\"a\":\"b\"}";
+static const char TEST_REPORTED_RECORD[] = "reported - - 9\n{\"a\":\"b\"}\n";
+static const char FIRST_TWIN[] = "{\"desired\":{\"a\":1}}";
+static const char SECOND_TWIN[] = "{\"desired\":{\"a\":2}}";
+
+static char testDirectory[] = "/tmp/local_transport_ut_XXXXXX";
+static char sinkPath[256];
+static char twinFilePath[256];
+static char newTwinFilePath[256];
+static uint32_t latency;
+static uint32_t failureRate;
+
+// the callbacks are called on the worker of the transport
+static LOCK_HANDLE resultsLock;
+static IOTHUB_CLIENT_CONFIRMATION_RESULT confirmations[TEST_MAX_CONFIRMATIONS];
+static uint32_t confirmationsCount;
+static uint32_t connectionsCount;
+static uint32_t twinsCount;
+static char lastTwin[256];
+static uint32_t reportedStatesCount;
+static int reportedStatusCode;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+const char* Mocked_LocalConfiguration_GetLocalTransportSinkPath() {
+    return sinkPath;
+}
+
+const char* Mocked_LocalConfiguration_GetLocalTransportTwinFilePath() {
+    return twinFilePath;
+}
+
+uint32_t Mocked_LocalConfiguration_GetLocalTransportLatency() {
+    return latency;
+}
+
+uint32_t Mocked_LocalConfiguration_GetLocalTransportFailureRate() {
+    return failureRate;
+}
+
+IOTHUB_MESSAGE_RESULT Mocked_IoTHubMessage_GetByteArray(IOTHUB_MESSAGE_HANDLE iotHubMessageHandle, const unsigned char** buffer, size_t* size) {
+    *buffer = (const unsigned char*)TEST_MESSAGE_DATA;
+    *size = strlen(TEST_MESSAGE_DATA);
+    return IOTHUB_MESSAGE_OK;
+}
+
+static void Test_ConfirmationCallback(IOTHUB_CLIENT_CONFIRMATION_RESULT result, void* context) {
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(resultsLock));
+    ASSERT_IS_TRUE(confirmationsCount < TEST_MAX_CONFIRMATIONS);
+    confirmations[confirmationsCount++] = result;
+    Unlock(resultsLock);
+}
+
+static void Test_ConnectionStatusCallback(IOTHUB_CLIENT_CONNECTION_STATUS result, IOTHUB_CLIENT_CONNECTION_STATUS_REASON reason, void* context) {
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONNECTION_AUTHENTICATED, result);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONNECTION_OK, reason);
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(resultsLock));
+    ++connectionsCount;
+    Unlock(resultsLock);
+}
+
+static void Test_TwinCallback(DEVICE_TWIN_UPDATE_STATE updateState, const unsigned char* payload, size_t size, void* context) {
+    ASSERT_ARE_EQUAL(int, DEVICE_TWIN_UPDATE_COMPLETE, updateState);
+    ASSERT_IS_TRUE(size < sizeof(lastTwin));
+    ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(resultsLock));
+    memcpy(lastTwin, payload, size);
+    lastTwin[size] = '\0';
+    ++twinsCount;
+    Unlock(resultsLock);
+}
+
+static void Test_ReportedStateCallback(int statusCode, void* context) {
+    reportedStatusCode = statusCode;
+    ++reportedStatesCount;
+}
+
+/**
+ * @brief Waits for the worker of the transport to bring a counter of the callbacks to the expected value.
+ */
+static void Test_WaitForCount(const uint32_t* count, uint32_t expected) {
+    for (uint32_t waited = 0; waited <= TEST_TIMEOUT; waited += TEST_WAIT_INTERVAL) {
+        ASSERT_ARE_EQUAL(int, LOCK_OK, Lock(resultsLock));
+        uint32_t current = *count;
+        Unlock(resultsLock);
+        if (current >= expected) {
+            return;
+        }
+        ThreadAPI_Sleep(TEST_WAIT_INTERVAL);
+    }
+    ASSERT_FAIL("The local transport did not call the callback in time");
+}
+
+static void Test_AssertSink(const char* expected) {
+    char content[512] = "";
+    FILE* sink = fopen(sinkPath, "r");
+    ASSERT_IS_NOT_NULL(sink);
+    size_t size = fread(content, 1, sizeof(content) - 1, sink);
+    fclose(sink);
+    content[size] = '\0';
+    ASSERT_ARE_EQUAL(char_ptr, expected, content);
+}
+
+static void Test_WriteFile(const char* path, const char* content) {
+    FILE* file = fopen(path, "w");
+    ASSERT_IS_NOT_NULL(file);
+    ASSERT_ARE_EQUAL(int, strlen(content), fwrite(content, 1, strlen(content), file));
+    fclose(file);
+}
+
+BEGIN_TEST_SUITE(local_transport_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_charptr_register_types();
+    umocktypes_stdint_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_RESULT, int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(LocalConfiguration_GetLocalTransportSinkPath, Mocked_LocalConfiguration_GetLocalTransportSinkPath);
+    REGISTER_GLOBAL_MOCK_HOOK(LocalConfiguration_GetLocalTransportTwinFilePath, Mocked_LocalConfiguration_GetLocalTransportTwinFilePath);
+    REGISTER_GLOBAL_MOCK_HOOK(LocalConfiguration_GetLocalTransportLatency, Mocked_LocalConfiguration_GetLocalTransportLatency);
+    REGISTER_GLOBAL_MOCK_HOOK(LocalConfiguration_GetLocalTransportFailureRate, Mocked_LocalConfiguration_GetLocalTransportFailureRate);
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubMessage_GetByteArray, Mocked_IoTHubMessage_GetByteArray);
+    REGISTER_GLOBAL_MOCK_RETURN(IoTHubMessage_GetContentTypeSystemProperty, TEST_CONTENT_TYPE);
+    REGISTER_GLOBAL_MOCK_RETURN(IoTHubMessage_GetContentEncodingSystemProperty, TEST_CONTENT_ENCODING);
+
+    ASSERT_IS_NOT_NULL(mkdtemp(testDirectory));
+    snprintf(sinkPath, sizeof(sinkPath), "%s/sink", testDirectory);
+    snprintf(twinFilePath, sizeof(twinFilePath), "%s/twin.json", testDirectory);
+    snprintf(newTwinFilePath, sizeof(newTwinFilePath), "%s/twin.json.new", testDirectory);
+
+    resultsLock = Lock_Init();
+    ASSERT_IS_NOT_NULL(resultsLock);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    Lock_Deinit(resultsLock);
+    rmdir(testDirectory);
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    latency = 0;
+    failureRate = 0;
+    confirmationsCount = 0;
+    connectionsCount = 0;
+    twinsCount = 0;
+    lastTwin[0] = '\0';
+    reportedStatesCount = 0;
+    reportedStatusCode = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    unlink(sinkPath);
+    unlink(twinFilePath);
+    unlink(newTwinFilePath);
+}
+
+TEST_FUNCTION(LocalTransport_SendEventAsync_FileSink_ExpectRecordWrittenAndConfirmed)
+{
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_IS_NULL(transport->DoWork);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, NULL));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, NULL));
+    Test_WaitForCount(&confirmationsCount, 2);
+    transport->Destroy(handle);
+
+    ASSERT_ARE_EQUAL(int, 2, confirmationsCount);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONFIRMATION_OK, confirmations[0]);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONFIRMATION_OK, confirmations[1]);
+
+    char expected[2 * sizeof(TEST_MESSAGE_RECORD)];
+    snprintf(expected, sizeof(expected), "%s%s", TEST_MESSAGE_RECORD, TEST_MESSAGE_RECORD);
+    Test_AssertSink(expected);
+}
+
+TEST_FUNCTION(LocalTransport_SendEventAsync_SocketSink_ExpectRecordWrittenToSocket)
+{
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_IS_TRUE(listener >= 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, sinkPath);
+    ASSERT_ARE_EQUAL(int, 0, bind(listener, (struct sockaddr*)&address, sizeof(address)));
+    ASSERT_ARE_EQUAL(int, 0, listen(listener, 1));
+
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+    ASSERT_IS_NOT_NULL(handle);
+    int connection = accept(listener, NULL, NULL);
+    ASSERT_IS_TRUE(connection >= 0);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, NULL));
+    Test_WaitForCount(&confirmationsCount, 1);
+    transport->Destroy(handle);
+
+    char record[sizeof(TEST_MESSAGE_RECORD)] = "";
+    size_t size = 0;
+    while (size < strlen(TEST_MESSAGE_RECORD)) {
+        ssize_t received = recv(connection, record + size, strlen(TEST_MESSAGE_RECORD) - size, 0);
+        ASSERT_IS_TRUE(received > 0);
+        size += received;
+    }
+    close(connection);
+    close(listener);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONFIRMATION_OK, confirmations[0]);
+    ASSERT_ARE_EQUAL(char_ptr, TEST_MESSAGE_RECORD, record);
+}
+
+TEST_FUNCTION(LocalTransport_SendEventAsync_AllMessagesFail_ExpectConfirmationErrorAndNothingWritten)
+{
+    failureRate = 100;
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+    ASSERT_IS_NOT_NULL(handle);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, NULL));
+    Test_WaitForCount(&confirmationsCount, 1);
+    transport->Destroy(handle);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONFIRMATION_ERROR, confirmations[0]);
+    Test_AssertSink("");
+}
+
+TEST_FUNCTION(LocalTransport_Destroy_MessagesPending_ExpectConfirmedBecauseDestroy)
+{
+    // the messages are still waiting for their latency when the transport is destroyed
+    latency = 60 * 1000;
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+    ASSERT_IS_NOT_NULL(handle);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, NULL));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendEventAsync(handle, TEST_MESSAGE, Test_ConfirmationCallback, NULL));
+    transport->Destroy(handle);
+
+    ASSERT_ARE_EQUAL(int, 2, confirmationsCount);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONFIRMATION_BECAUSE_DESTROY, confirmations[0]);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_CONFIRMATION_BECAUSE_DESTROY, confirmations[1]);
+    Test_AssertSink("");
+}
+
+TEST_FUNCTION(LocalTransport_SendReportedState_ExpectRecordWrittenAndAccepted)
+{
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+    ASSERT_IS_NOT_NULL(handle);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SendReportedState(handle, (const unsigned char*)TEST_REPORTED_STATE, strlen(TEST_REPORTED_STATE), Test_ReportedStateCallback, NULL));
+    transport->Destroy(handle);
+
+    // the reported state is written and accepted before the call returns
+    ASSERT_ARE_EQUAL(int, 1, reportedStatesCount);
+    ASSERT_ARE_EQUAL(int, 200, reportedStatusCode);
+    Test_AssertSink(TEST_REPORTED_RECORD);
+}
+
+TEST_FUNCTION(LocalTransport_SetModuleTwinCallback_TwinFileReplaced_ExpectTwinDeliveredAgain)
+{
+    Test_WriteFile(twinFilePath, FIRST_TWIN);
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+    ASSERT_IS_NOT_NULL(handle);
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetConnectionStatusCallback(handle, Test_ConnectionStatusCallback, NULL));
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, transport->SetModuleTwinCallback(handle, Test_TwinCallback, NULL));
+    Test_WaitForCount(&connectionsCount, 1);
+    Test_WaitForCount(&twinsCount, 1);
+    ASSERT_ARE_EQUAL(char_ptr, FIRST_TWIN, lastTwin);
+
+    // the twin is replaced with a rename, the new file is dated after the first one even on a coarse clock
+    Test_WriteFile(newTwinFilePath, SECOND_TWIN);
+    struct stat twinStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(twinFilePath, &twinStat));
+    struct timespec times[2] = { twinStat.st_mtim, twinStat.st_mtim };
+    times[1].tv_sec += 1;
+    ASSERT_ARE_EQUAL(int, 0, utimensat(AT_FDCWD, newTwinFilePath, times, 0));
+    ASSERT_ARE_EQUAL(int, 0, rename(newTwinFilePath, twinFilePath));
+
+    Test_WaitForCount(&twinsCount, 2);
+    transport->Destroy(handle);
+
+    ASSERT_ARE_EQUAL(int, 2, twinsCount);
+    ASSERT_ARE_EQUAL(char_ptr, SECOND_TWIN, lastTwin);
+    ASSERT_ARE_EQUAL(int, 1, connectionsCount);
+}
+
+TEST_FUNCTION(LocalTransport_Create_SinkNotOpened_ExpectFailure)
+{
+    snprintf(sinkPath, sizeof(sinkPath), "%s/missing/sink", testDirectory);
+
+    const TransportInterface* transport = LocalTransport_GetInterface();
+    TRANSPORT_HANDLE handle = transport->Create(NULL);
+
+    snprintf(sinkPath, sizeof(sinkPath), "%s/sink", testDirectory);
+    ASSERT_IS_NULL(handle);
+}
+
+END_TEST_SUITE(local_transport_ut)
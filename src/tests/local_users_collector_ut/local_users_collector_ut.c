@@ -170,7 +170,7 @@ TEST_FUNCTION(LocalUsersCollector_GetEvents_ExpectSuccess)
     STRICT_EXPECTED_CALL(UsersIterator_GetNext(IGNORED_PTR_ARG)).SetReturn(USER_ITERATOR_STOP);
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
 
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
 
     STRICT_EXPECTED_CALL(UsersIterator_Deinit(IGNORED_PTR_ARG));
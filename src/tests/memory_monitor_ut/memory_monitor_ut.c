@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "internal/internal_memory_monitor.h"
+#undef ENABLE_MOCKS
+
+#include "memory_monitor.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(memory_monitor_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+    umocktypes_charptr_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(MemoryMonitor_InitDeinit_ExpectSuccess)
+{
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Init());
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Deinit());
+
+    ASSERT_IS_TRUE(MemoryMonitor_Init());
+    MemoryMonitor_Deinit();
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MemoryMonitor_Consume_ExpectForwardedWithoutLocking)
+{
+    uint32_t size = 123;
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Consume(size)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED);
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, MemoryMonitor_Consume(size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MemoryMonitor_Release_ExpectForwardedWithoutLocking)
+{
+    uint32_t size = 123;
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Release(size)).SetReturn(MEMORY_MONITOR_OK);
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, MemoryMonitor_Release(size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MemoryMonitor_ForceConsume_ExpectForwardedWithoutLocking)
+{
+    uint32_t size = 123;
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_ForceConsume(size));
+
+    MemoryMonitor_ForceConsume(size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MemoryMonitor_CurrentConsumption_ExpectForwardedWithoutLocking)
+{
+    uint32_t size = 0;
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_CurrentConsumption(&size)).SetReturn(MEMORY_MONITOR_OK);
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, MemoryMonitor_CurrentConsumption(&size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MemoryMonitor_SetLimit_ExpectForwarded)
+{
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_SetLimit(1024));
+
+    MemoryMonitor_SetLimit(1024);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MemoryMonitor_Budget_ExpectForwarded)
+{
+    MemoryBudget budget;
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_InitBudget(&budget, 100)).SetReturn(MEMORY_MONITOR_OK);
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_ConsumeFromBudget(&budget, 10)).SetReturn(MEMORY_MONITOR_OK);
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_IsBeyondReservation(&budget)).SetReturn(true);
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_ReleaseToBudget(&budget, 10)).SetReturn(MEMORY_MONITOR_OK);
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_DeinitBudget(&budget));
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, MemoryMonitor_InitBudget(&budget, 100));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, MemoryMonitor_ConsumeFromBudget(&budget, 10));
+    ASSERT_IS_TRUE(MemoryMonitor_IsBeyondReservation(&budget));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, MemoryMonitor_ReleaseToBudget(&budget, 10));
+    MemoryMonitor_DeinitBudget(&budget);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(memory_monitor_ut)
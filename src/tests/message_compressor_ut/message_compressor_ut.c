@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+
+#include "message_compressor.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char* TEST_MESSAGE = "{\"Events\":[{\"EventType\":\"Security\",\"Category\":\"Triggered\",\"Name\":\"ProcessCreate\",\"IsEmpty\":false,"
+    "\"PayloadSchemaVersion\":\"1.0\",\"Id\":\"1\",\"TimestampLocal\":\"2019-01-01 00:00:00\",\"TimestampUTC\":\"2019-01-01 00:00:00\","
+    "\"Payload\":[{\"Executable\":\"/usr/bin/ls\",\"ProcessId\":1,\"ParentProcessId\":0,\"UserId\":0,\"CommandLine\":\"ls -la\"}]}]}";
+
+/**
+ * Inflates the given stream with the compressor dictionary, returns the size of the inflated data.
+ */
+static uint32_t Inflate(void* data, uint32_t size, char* output, uint32_t outputSize, bool finished) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    ASSERT_ARE_EQUAL(int, Z_OK, inflateInit(&stream));
+
+    stream.next_in = data;
+    stream.avail_in = size;
+    stream.next_out = (Bytef*)output;
+    stream.avail_out = outputSize;
+    int result = inflate(&stream, Z_SYNC_FLUSH);
+    ASSERT_ARE_EQUAL(int, Z_NEED_DICT, result);
+
+    char dictionary[MESSAGE_COMPRESSOR_MAX_DICTIONARY_SIZE];
+    uint32_t dictionarySize = MessageCompressor_GetDictionary(dictionary, sizeof(dictionary));
+    ASSERT_ARE_EQUAL(int, Z_OK, inflateSetDictionary(&stream, (const Bytef*)dictionary, dictionarySize));
+
+    result = inflate(&stream, Z_SYNC_FLUSH);
+    ASSERT_ARE_EQUAL(int, finished ? Z_STREAM_END : Z_OK, result);
+
+    uint32_t inflatedSize = outputSize - stream.avail_out;
+    inflateEnd(&stream);
+    return inflatedSize;
+}
+
+BEGIN_TEST_SUITE(message_compressor_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(MessageCompressor_WriteAndFinish_ExpectRoundTrip)
+{
+    MessageCompressor compressor;
+    ASSERT_IS_TRUE(MessageCompressor_Init(&compressor));
+
+    uint32_t messageSize = strlen(TEST_MESSAGE);
+    ASSERT_IS_TRUE(MessageCompressor_Write(&compressor, TEST_MESSAGE, 10));
+    ASSERT_IS_TRUE(MessageCompressor_Write(&compressor, TEST_MESSAGE + 10, messageSize - 10));
+    ASSERT_ARE_EQUAL(int, messageSize, compressor.pendingSize);
+
+    void* data = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_TRUE(MessageCompressor_Finish(&compressor, &data, &size));
+    MessageCompressor_Deinit(&compressor);
+
+    // the schema dictionary takes most of the envelope away
+    ASSERT_IS_TRUE(size < messageSize / 2);
+
+    char inflated[1024];
+    uint32_t inflatedSize = Inflate(data, size, inflated, sizeof(inflated), true);
+    ASSERT_ARE_EQUAL(int, messageSize, inflatedSize);
+    ASSERT_IS_TRUE(memcmp(TEST_MESSAGE, inflated, messageSize) == 0);
+
+    free(data);
+}
+
+TEST_FUNCTION(MessageCompressor_Flush_ExpectEverythingWrittenIsInTheStream)
+{
+    MessageCompressor compressor;
+    ASSERT_IS_TRUE(MessageCompressor_Init(&compressor));
+
+    uint32_t messageSize = strlen(TEST_MESSAGE);
+    ASSERT_IS_TRUE(MessageCompressor_Write(&compressor, TEST_MESSAGE, messageSize));
+    ASSERT_IS_TRUE(MessageCompressor_Flush(&compressor));
+    ASSERT_ARE_EQUAL(int, 0, compressor.pendingSize);
+
+    char inflated[1024];
+    uint32_t inflatedSize = Inflate(compressor.data, compressor.size, inflated, sizeof(inflated), false);
+    ASSERT_ARE_EQUAL(int, messageSize, inflatedSize);
+    ASSERT_IS_TRUE(memcmp(TEST_MESSAGE, inflated, messageSize) == 0);
+
+    MessageCompressor_Deinit(&compressor);
+}
+
+TEST_FUNCTION(MessageCompressor_IncompressibleDataOfMaxInputSize_ExpectFitsTheRoom)
+{
+    uint32_t room = 4096;
+    uint32_t inputSize = MessageCompressor_GetMaxInputSize(room);
+    ASSERT_IS_TRUE(inputSize < room);
+
+    char* input = malloc(inputSize);
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < inputSize; ++i) {
+        seed = seed * 1103515245 + 12345;
+        input[i] = (char)(seed >> 16);
+    }
+
+    MessageCompressor compressor;
+    ASSERT_IS_TRUE(MessageCompressor_Init(&compressor));
+    ASSERT_IS_TRUE(MessageCompressor_Write(&compressor, input, inputSize));
+
+    void* data = NULL;
+    uint32_t size = 0;
+    ASSERT_IS_TRUE(MessageCompressor_Finish(&compressor, &data, &size));
+    MessageCompressor_Deinit(&compressor);
+
+    ASSERT_IS_TRUE(size <= room);
+
+    free(data);
+    free(input);
+}
+
+TEST_FUNCTION(MessageCompressor_GetMaxInputSize_RoomSmallerThanOverhead_ExpectZero)
+{
+    ASSERT_ARE_EQUAL(int, 0, MessageCompressor_GetMaxInputSize(0));
+    ASSERT_ARE_EQUAL(int, 0, MessageCompressor_GetMaxInputSize(10));
+}
+
+TEST_FUNCTION(MessageCompressor_GetDictionary_ExpectFitsMaxSize)
+{
+    char dictionary[MESSAGE_COMPRESSOR_MAX_DICTIONARY_SIZE];
+    uint32_t size = MessageCompressor_GetDictionary(dictionary, sizeof(dictionary));
+    ASSERT_IS_TRUE(size > 0);
+
+    // a shorter buffer takes only the entries which fit
+    char shortDictionary[16];
+    ASSERT_IS_TRUE(MessageCompressor_GetDictionary(shortDictionary, sizeof(shortDictionary)) <= sizeof(shortDictionary));
+}
+
+END_TEST_SUITE(message_compressor_ut)
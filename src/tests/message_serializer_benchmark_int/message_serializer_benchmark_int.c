@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "json/json_array_writer.h"
+#include "json/json_object_writer.h"
+#include "local_config.h"
+#include "memory_monitor.h"
+#include "message_schema_consts.h"
+#include "message_serializer.h"
+#include "parson.h"
+#include "synchronized_queue.h"
+#include "twin_configuration.h"
+
+#define BENCHMARK_MESSAGES 2000
+#define BENCHMARK_MAX_MESSAGE_SIZE (64 * 1024)
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+// a process creation event, as serialized by the collector
+static const char BENCHMARK_EVENT[] =
+    "{\"Category\":\"Triggered\",\"IsEmpty\":false,\"IsOperational\":false,\"Name\":\"ProcessCreate\",\"PayloadSchemaVersion\":\"1.0\","
+    "\"Id\":\"9c3a46a5-0d9e-4b3f-8b1e-3f4f2f7d3c11\",\"TimestampLocal\":\"2019-01-01 10:00:00+0000\",\"TimestampUTC\":\"2019-01-01 10:00:00\","
+    "\"EventType\":\"Security\",\"Payload\":[{\"Executable\":\"/usr/bin/python3\",\"ProcessId\":4242,\"ParentProcessId\":4000,"
+    "\"UserName\":\"root\",\"UserId\":\"0\",\"CommandLine\":\"python3 /opt/app/main.py --config /etc/app/config.json\","
+    "\"Time\":\"2019-01-01 10:00:00+0000\",\"ExecutableHash\":\"sha1:6b4b2a3c7e8f9d0a1b2c3d4e5f60718293a4b5c6\"}]}";
+
+static uint32_t eventsPerMessage;
+
+TwinConfigurationResult TwinConfiguration_GetMaxMessageSize(uint32_t* maxMessageSize) {
+    *maxMessageSize = BENCHMARK_MAX_MESSAGE_SIZE;
+    return TWIN_OK;
+}
+
+// the memory monitor asks for the cache limit on each push, the benchmark measures the serializer only
+TwinConfigurationResult TwinConfiguration_GetMaxLocalCacheSize(uint32_t* maxLocalCacheSize) {
+    *maxLocalCacheSize = UINT32_MAX;
+    return TWIN_OK;
+}
+
+const char* LocalConfiguration_GetAgentId() {
+    return "ea05af2d-7397-4a1b-9ec7-3dc15e762a69";
+}
+
+static double Benchmark_Now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void Benchmark_FillQueue(SyncQueue* queue) {
+    for (uint32_t i = 0; i < eventsPerMessage; ++i) {
+        char* event = Queue_AllocateData(sizeof(BENCHMARK_EVENT));
+        ASSERT_IS_NOT_NULL(event);
+        memcpy(event, BENCHMARK_EVENT, sizeof(BENCHMARK_EVENT));
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(queue, event, sizeof(BENCHMARK_EVENT) - 1));
+    }
+}
+
+/**
+ * @brief The message assembly before the events were spliced into the message: every event is parsed back into a json tree,
+ *        copied into the events array and the whole message is serialized again.
+ */
+static char* Benchmark_CreateSecurityMessageByReparsing(SyncQueue* queue) {
+    JsonObjectWriterHandle messageWriter = NULL;
+    JsonArrayWriterHandle eventsArray = NULL;
+    SyncQueueBatch batch;
+    void* data = NULL;
+    uint32_t dataSize = 0;
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_Init(&messageWriter));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(messageWriter, AGENT_VERSION_KEY, AGENT_VERSION));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(messageWriter, AGENT_ID_KEY, LocalConfiguration_GetAgentId()));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(messageWriter, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonArrayWriter_Init(&eventsArray));
+
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PopBatchIf(queue, NULL, NULL, BENCHMARK_MAX_MESSAGE_SIZE, &batch));
+    while (SyncQueue_BatchPopFront(&batch, &data, &dataSize) == QUEUE_OK) {
+        JsonObjectWriterHandle eventWriter = NULL;
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&eventWriter, data));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonArrayWriter_AddObject(eventsArray, eventWriter));
+        JsonObjectWriter_Deinit(eventWriter);
+        Queue_FreeData(data);
+    }
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteArray(messageWriter, EVENTS_KEY, eventsArray));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_Serialize(messageWriter, &buffer, &bufferSize));
+
+    JsonArrayWriter_Deinit(eventsArray);
+    JsonObjectWriter_Deinit(messageWriter);
+    return buffer;
+}
+
+static char* Benchmark_CreateSecurityMessage(SyncQueue* queue) {
+    void* buffer = NULL;
+    SyncQueue* queues[] = { queue };
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, MessageSerializer_CreateSecurityMessage(queues, 1, &buffer));
+    return buffer;
+}
+
+/**
+ * @brief Asserts the message is valid json which holds all the events of a full queue.
+ */
+static void Benchmark_ValidateMessage(const char* message) {
+    JSON_Value* root = json_parse_string(message);
+    ASSERT_IS_NOT_NULL(root);
+    JSON_Object* rootObject = json_value_get_object(root);
+    ASSERT_ARE_EQUAL(char_ptr, AGENT_VERSION, json_object_get_string(rootObject, AGENT_VERSION_KEY));
+    ASSERT_ARE_EQUAL(char_ptr, LocalConfiguration_GetAgentId(), json_object_get_string(rootObject, AGENT_ID_KEY));
+    ASSERT_ARE_EQUAL(char_ptr, DEFAULT_MESSAGE_SCHEMA_VERSION, json_object_get_string(rootObject, MESSAGE_SCHEMA_VERSION_KEY));
+
+    JSON_Array* events = json_object_get_array(rootObject, EVENTS_KEY);
+    ASSERT_IS_NOT_NULL(events);
+    ASSERT_ARE_EQUAL(int, eventsPerMessage, json_array_get_count(events));
+    ASSERT_ARE_EQUAL(char_ptr, "ProcessCreate", json_object_get_string(json_array_get_object(events, eventsPerMessage - 1), "Name"));
+    json_value_free(root);
+}
+
+static double Benchmark_Run(SyncQueue* queue, char* (*createMessage)(SyncQueue*)) {
+    double elapsed = 0;
+    for (uint32_t i = 0; i < BENCHMARK_MESSAGES; ++i) {
+        Benchmark_FillQueue(queue);
+
+        double start = Benchmark_Now();
+        char* message = createMessage(queue);
+        elapsed += Benchmark_Now() - start;
+
+        ASSERT_IS_NOT_NULL(message);
+        if (i == 0) {
+            Benchmark_ValidateMessage(message);
+        }
+        free(message);
+    }
+
+    return BENCHMARK_MESSAGES / elapsed;
+}
+
+BEGIN_TEST_SUITE(message_serializer_benchmark_int)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+    ASSERT_IS_TRUE(MemoryMonitor_Init());
+
+    // as many events as the message can hold
+    eventsPerMessage = BENCHMARK_MAX_MESSAGE_SIZE / (sizeof(BENCHMARK_EVENT) - 1);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    MemoryMonitor_Deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_ReparsingVersusSplicing)
+{
+    SyncQueue queue;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&queue, false));
+
+    double reparsingResult = Benchmark_Run(&queue, Benchmark_CreateSecurityMessageByReparsing);
+    double splicingResult = Benchmark_Run(&queue, Benchmark_CreateSecurityMessage);
+
+    printf("events per message: %u\treparsing: %.0f messages/sec\tsplicing: %.0f messages/sec\tspeedup: %.2fx\n",
+        eventsPerMessage, reparsingResult, splicingResult, splicingResult / reparsingResult);
+
+    SyncQueue_Deinit(&queue);
+}
+
+END_TEST_SUITE(message_serializer_benchmark_int)
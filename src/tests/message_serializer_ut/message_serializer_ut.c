@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 #include <stdint.h>
+#include <string.h>
+
+#include <zlib.h>
 
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
@@ -9,15 +12,16 @@
 
 
 #define ENABLE_MOCKS
-#include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
 #include "local_config.h"
 #include "synchronized_queue.h"
 #include "twin_configuration.h"
 #undef ENABLE_MOCKS
 
+#include "consts.h"
 #include "json/json_defs.h"
 #include "local_config.h"
+#include "message_compressor.h"
 #include "message_schema_consts.h"
 #include "message_serializer.h"
 
@@ -32,46 +36,86 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
 }
 
 static const char DUMMY_JSON[] =  "{ \"test\" : \"yes\", \"a\" : \"b\"}";
+// {"a":"b"} as cbor
+static const char DUMMY_CBOR[] = "\xA1\x61\x61\x61\x62";
+static const char DUMMY_PROCESS_EVENT[] =
+    "{\"Category\":\"Triggered\",\"EventType\":\"Security\",\"Name\":\"ProcessCreate\",\"PayloadSchemaVersion\":\"1.0\","
+    "\"Id\":\"1\",\"TimestampLocal\":\"2019-03-04T12:00:10Z\",\"TimestampUTC\":\"2019-03-04T10:00:10Z\",\"IsEmpty\":false,"
+    "\"Payload\":[{\"Executable\":\"sh\",\"ProcessId\":7}]}";
+static const char* mockedEventData = DUMMY_JSON;
 static SyncQueue mainQueue;
 static SyncQueue paddingQueue;
 
-static uint32_t mainQueueMockedSyncQueueGetSizeMainSize = 0;
-static uint32_t paddingQueueMockedSyncQueueGetSizeSize = 0;
-static int mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+static uint32_t mainQueueMockedSize = 0;
+static uint32_t paddingQueueMockedSize = 0;
 static int mockedSyncQueuePopFrontReturnValue = QUEUE_OK;
+// the first event of the padding queue is too big for the message, the events behind it are not
+static bool paddingQueueFrontTooBig = false;
 static uint32_t mockedGetMaxSizeValue = 0;
 static TwinConfigurationResult mockedGetMaxSizeReturnValue = TWIN_OK;
 static JsonObjectWriterHandle mockedObjectWriterHandle = (JsonObjectWriterHandle)0x1;
-static JsonArrayWriterHandle mockedArrayWriterHandle = (JsonArrayWriterHandle)0x2;
+static const char MOCKED_ENVELOPE[] = "{\"AgentVersion\":\"1.0\"}";
 static char TEST_AGENT_ID[] = "ea05af2d-7397-4a1b-9ec7-3dc15e762a69";
+// the envelope without its closing brace followed by the opening of the events array
+#define MESSAGE_PREFIX_SIZE (strlen(MOCKED_ENVELOPE) - 1 + strlen(",\"Events\":["))
+// the closing of the events array and of the message
+#define MESSAGE_CLOSING_SIZE 2
 
-int Mocked_SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) { 
-    if (syncQueue == &mainQueue) {
-        *size = mainQueueMockedSyncQueueGetSizeMainSize;
-    } else {
-        *size = paddingQueueMockedSyncQueueGetSizeSize;
-    }
-    
-    return mockedSyncQueueGetSizeReturnValue;
-}
-
-int Mocked_SyncQueue_PopFrontIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+int Mocked_SyncQueue_PopBatchIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, uint32_t maxBatchSize, SyncQueueBatch* batch) {
     if (mockedSyncQueuePopFrontReturnValue != QUEUE_OK) {
         return mockedSyncQueuePopFrontReturnValue;
     }
 
-    if (!condition(NULL, strlen(DUMMY_JSON), conditionParams)) {
+    uint32_t* queueSize = (syncQueue == &mainQueue) ? &mainQueueMockedSize : &paddingQueueMockedSize;
+    if (*queueSize == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    if (syncQueue == &paddingQueue && paddingQueueFrontTooBig) {
         return QUEUE_CONDITION_FAILED;
     }
 
-    *data = strdup(DUMMY_JSON);
-    *dataSize = strlen(DUMMY_JSON);
-    if (syncQueue == &mainQueue) {
-        mainQueueMockedSyncQueueGetSizeMainSize--;
-    } else {
-        paddingQueueMockedSyncQueueGetSizeSize--;
+    batch->remainingElements = 0;
+    batch->remainingSize = maxBatchSize;
+    while (*queueSize > 0 && strlen(mockedEventData) < batch->remainingSize && 
+           (condition == NULL || condition(mockedEventData, strlen(mockedEventData), conditionParams))) {
+        batch->remainingSize -= strlen(mockedEventData);
+        batch->remainingElements++;
+        (*queueSize)--;
+    }
+
+    return batch->remainingElements == 0 ? QUEUE_CONDITION_FAILED : QUEUE_OK;
+}
+
+int Mocked_SyncQueue_BatchPopFront(SyncQueueBatch* batch, void** data, uint32_t* dataSize) {
+    if (batch->remainingElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    *data = strdup(mockedEventData);
+    *dataSize = strlen(mockedEventData);
+    batch->remainingElements--;
+    return QUEUE_OK;
+}
+
+int Mocked_SyncQueue_PopBestFit(SyncQueue* syncQueue, uint32_t maxDataSize, void** data, uint32_t* dataSize) {
+    uint32_t* queueSize = (syncQueue == &mainQueue) ? &mainQueueMockedSize : &paddingQueueMockedSize;
+    if (*queueSize == 0) {
+        return QUEUE_IS_EMPTY;
     }
-    return mockedSyncQueuePopFrontReturnValue;
+
+    if (strlen(mockedEventData) > maxDataSize) {
+        return QUEUE_CONDITION_FAILED;
+    }
+
+    *data = strdup(mockedEventData);
+    *dataSize = strlen(mockedEventData);
+    (*queueSize)--;
+    return QUEUE_OK;
+}
+
+void Mocked_Queue_FreeData(void* data) {
+    free(data);
 }
 
 TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* maxMessageSize) {
@@ -87,22 +131,43 @@ JsonWriterResult Mocked_JsonObjectWriter_Init_SetWriterToNotNull(JsonObjectWrite
     return JSON_WRITER_OK;
 }
 
-JsonWriterResult Mocked_JsonObjectWriter_InitFromString_SetWriterToNotNull(JsonObjectWriterHandle* writer, const char* json) {
-    *writer = mockedObjectWriterHandle;
+JsonWriterResult Mocked_JsonObjectWriter_Serialize(JsonObjectWriterHandle writer, char** output, uint32_t* size) {
+    *output = strdup(MOCKED_ENVELOPE);
+    *size = strlen(MOCKED_ENVELOPE);
     return JSON_WRITER_OK;
 }
 
-JsonWriterResult Mocked_JsonArrayWriter_Init_SetWriterToNotNull(JsonArrayWriterHandle* writer) {
-    *writer = mockedArrayWriterHandle;
-    return JSON_WRITER_OK;
+static void SetupWriteEnvelopeExpectations() {
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, AGENT_VERSION)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+}
+
+static uint32_t AppendCborString(uint8_t* buffer, uint32_t size, const char* value) {
+    uint32_t length = strlen(value);
+    if (length < 24) {
+        buffer[size++] = 0x60 | length;
+    } else {
+        buffer[size++] = 0x78;
+        buffer[size++] = length;
+    }
+    memcpy(buffer + size, value, length);
+    return size + length;
+}
+
+static void SetupAddEventExpectations() {
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Queue_FreeData(IGNORED_PTR_ARG));
 }
 
 BEGIN_TEST_SUITE(message_serializer_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
 {
-     
-
     test_serialize_mutex = TEST_MUTEX_CREATE();
     ASSERT_IS_NOT_NULL(test_serialize_mutex);
 
@@ -112,190 +177,386 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(MessageSerializerResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(QueuePopCondition, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(JsonArrayWriterHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
 
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, Mocked_SyncQueue_GetSize);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFrontIf, Mocked_SyncQueue_PopFrontIf);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopBatchIf, Mocked_SyncQueue_PopBatchIf);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_BatchPopFront, Mocked_SyncQueue_BatchPopFront);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopBestFit, Mocked_SyncQueue_PopBestFit);
+    REGISTER_GLOBAL_MOCK_HOOK(Queue_FreeData, Mocked_Queue_FreeData);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, Mocked_TwinConfiguration_GetMaxMessageSize);
     REGISTER_GLOBAL_MOCK_RETURN(LocalConfiguration_GetAgentId, TEST_AGENT_ID);
 
     REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_Init, Mocked_JsonObjectWriter_Init_SetWriterToNotNull);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_InitFromString, Mocked_JsonObjectWriter_InitFromString_SetWriterToNotNull);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonArrayWriter_Init, Mocked_JsonArrayWriter_Init_SetWriterToNotNull);
+    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_Serialize, Mocked_JsonObjectWriter_Serialize);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
 {
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
-     
 
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopBatchIf, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_BatchPopFront, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopBestFit, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(Queue_FreeData, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_Init, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_InitFromString, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonArrayWriter_Init, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_Serialize, NULL);
 }
 
 TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
+    mockedEventData = DUMMY_JSON;
 }
 
 TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasDataPaddingQueueIsEmpty_ExpectSuccess)
 {
     char* buffer = NULL;
-    mainQueueMockedSyncQueueGetSizeMainSize = 1;
-    paddingQueueMockedSyncQueueGetSizeSize = 0;
-    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+    mainQueueMockedSize = 1;
+    paddingQueueMockedSize = 0;
 
     mockedGetMaxSizeReturnValue = TWIN_OK;
-    mockedGetMaxSizeValue = strlen(DUMMY_JSON) + 1;
+    // exactly one event fits
+    mockedGetMaxSizeValue = MESSAGE_PREFIX_SIZE + strlen(DUMMY_JSON) + MESSAGE_CLOSING_SIZE;
 
     // write the beginning of the message
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, AGENT_VERSION)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+    SetupWriteEnvelopeExpectations();
 
     // initial settings
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-    // write to the array
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
-
     // write all elements fron main queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     // write all elements fron padding queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-
-    // writes the array and serialize
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockedObjectWriterHandle, EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(mockedArrayWriterHandle));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&mainQueue, &paddingQueue};
     MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
 
-    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    // the message has no room left, so the queues are not asked whether they hold more events
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_FULL, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "{\"AgentVersion\":\"1.0\",\"Events\":[{ \"test\" : \"yes\", \"a\" : \"b\"}]}", buffer);
+
+    // freeing local buffer
+    free(buffer);
 }
 
 TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasDataPaddingQueueHasDataMaxMessageSizeReached_ExpectSuccess)
 {
     char* buffer = NULL;
-    mainQueueMockedSyncQueueGetSizeMainSize = 1;
-    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+    mainQueueMockedSize = 1;
 
-    paddingQueueMockedSyncQueueGetSizeSize = 1;
+    paddingQueueMockedSize = 1;
 
     mockedGetMaxSizeReturnValue = TWIN_OK;
-    mockedGetMaxSizeValue = strlen(DUMMY_JSON) + 1;
+    // exactly one event fits
+    mockedGetMaxSizeValue = MESSAGE_PREFIX_SIZE + strlen(DUMMY_JSON) + MESSAGE_CLOSING_SIZE;
 
      // write the beginning of the message
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+    SetupWriteEnvelopeExpectations();
 
     // initial settings
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-    // write to the array
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
-
     // write all elements fron main queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     // write all elements fron padding queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-
-    // writes the array and serialize
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockedObjectWriterHandle, EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(mockedArrayWriterHandle));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&mainQueue, &paddingQueue};
     MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
 
-    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    // the event which did not fit is left for the next message
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_FULL, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, paddingQueueMockedSize);
+
+    // freeing local buffer
+    free(buffer);
 }
 
 TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasDataPaddingQueueHasData_ExpectSuccess)
 {
     char* buffer = NULL;
-    mainQueueMockedSyncQueueGetSizeMainSize = 1;
-    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+    mainQueueMockedSize = 1;
 
-    paddingQueueMockedSyncQueueGetSizeSize = 1;
+    paddingQueueMockedSize = 1;
 
     mockedGetMaxSizeReturnValue = TWIN_OK;
-    mockedGetMaxSizeValue = strlen(DUMMY_JSON) * 3;
+    mockedGetMaxSizeValue = MESSAGE_PREFIX_SIZE + strlen(DUMMY_JSON) * 3 + MESSAGE_CLOSING_SIZE;
 
     // write the beginning of the message
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, AGENT_VERSION)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+    SetupWriteEnvelopeExpectations();
 
     // initial settings
-    //STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-    // write to the array
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
-
     // write all elements fron main queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     // write all elements fron padding queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-    // writes the array and serialize
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockedObjectWriterHandle, EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(mockedArrayWriterHandle));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+    // there is room for another event, but the queues are empty
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&mainQueue, strlen(DUMMY_JSON) - 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, strlen(DUMMY_JSON) - 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&mainQueue, &paddingQueue};
     MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
 
     ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "{\"AgentVersion\":\"1.0\",\"Events\":[{ \"test\" : \"yes\", \"a\" : \"b\"},{ \"test\" : \"yes\", \"a\" : \"b\"}]}", buffer);
 
     // freeing local buffer
     free(buffer);
 }
 
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_FirstEventDoesNotFit_ExpectSmallerEventPackedUpToBillingUnit)
+{
+    char* buffer = NULL;
+    mainQueueMockedSize = 0;
+    paddingQueueMockedSize = 1;
+    paddingQueueFrontTooBig = true;
+
+    mockedGetMaxSizeReturnValue = TWIN_OK;
+    mockedGetMaxSizeValue = MESSAGE_BILLING_MULTIPLE + 100;
+
+    SetupWriteEnvelopeExpectations();
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+
+    // the first event of the padding queue does not fit
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+
+    // an empty message may use the max message size
+    uint32_t maxEventSize = mockedGetMaxSizeValue - MESSAGE_PREFIX_SIZE - MESSAGE_CLOSING_SIZE;
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&mainQueue, maxEventSize, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, maxEventSize, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Queue_FreeData(IGNORED_PTR_ARG));
+
+    // the rest of the message is packed up to the last full billing unit, a separator is needed
+    maxEventSize = MESSAGE_BILLING_MULTIPLE - MESSAGE_PREFIX_SIZE - strlen(DUMMY_JSON) - MESSAGE_CLOSING_SIZE - 1;
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, maxEventSize, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
+    paddingQueueFrontTooBig = false;
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "{\"AgentVersion\":\"1.0\",\"Events\":[{ \"test\" : \"yes\", \"a\" : \"b\"}]}", buffer);
+
+    // freeing local buffer
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_SerializeEnvelopeFailed_ExpectQueuesNotDrained)
+{
+    char* buffer = NULL;
+    mainQueueMockedSize = 1;
+    paddingQueueMockedSize = 0;
+
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, AGENT_VERSION)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer);
+    ASSERT_ARE_EQUAL(int, 1, mainQueueMockedSize);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateEncodedSecurityMessage_JsonCompressed_ExpectInflatesToMessage)
+{
+    void* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSize = 1;
+    paddingQueueMockedSize = 0;
+
+    mockedGetMaxSizeReturnValue = TWIN_OK;
+    mockedGetMaxSizeValue = MESSAGE_BILLING_MULTIPLE;
+
+    SetupWriteEnvelopeExpectations();
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+
+    // the event is flushed, then the queue is asked again for the room the flush revealed
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&mainQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateEncodedSecurityMessage(queues, 2, EVENT_ENCODING_JSON, true, false, &buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(buffer);
+    ASSERT_IS_TRUE(bufferSize <= MESSAGE_BILLING_MULTIPLE);
+
+    char inflated[256] = { 0 };
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    ASSERT_ARE_EQUAL(int, Z_OK, inflateInit(&stream));
+    stream.next_in = buffer;
+    stream.avail_in = bufferSize;
+    stream.next_out = (Bytef*)inflated;
+    stream.avail_out = sizeof(inflated) - 1;
+    ASSERT_ARE_EQUAL(int, Z_NEED_DICT, inflate(&stream, Z_FINISH));
+    char dictionary[MESSAGE_COMPRESSOR_MAX_DICTIONARY_SIZE];
+    uint32_t dictionarySize = MessageCompressor_GetDictionary(dictionary, sizeof(dictionary));
+    ASSERT_ARE_EQUAL(int, Z_OK, inflateSetDictionary(&stream, (const Bytef*)dictionary, dictionarySize));
+    ASSERT_ARE_EQUAL(int, Z_STREAM_END, inflate(&stream, Z_FINISH));
+    inflateEnd(&stream);
+
+    ASSERT_ARE_EQUAL(char_ptr, "{\"AgentVersion\":\"1.0\",\"Events\":[{ \"test\" : \"yes\", \"a\" : \"b\"}]}", inflated);
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateEncodedSecurityMessage_Cbor_ExpectEventsSplicedIntoCborEnvelope)
+{
+    void* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSize = 1;
+    paddingQueueMockedSize = 0;
+    mockedEventData = DUMMY_CBOR;
+
+    mockedGetMaxSizeReturnValue = TWIN_OK;
+    mockedGetMaxSizeValue = MESSAGE_BILLING_MULTIPLE;
+
+    // the cbor envelope is encoded without the json writer
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&mainQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateEncodedSecurityMessage(queues, 2, EVENT_ENCODING_CBOR, false, false, &buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // a map of the three envelope members and the events array, which the break closes
+    uint8_t expected[256];
+    uint32_t expectedSize = 0;
+    expected[expectedSize++] = 0xA4;
+    expectedSize = AppendCborString(expected, expectedSize, AGENT_VERSION_KEY);
+    expectedSize = AppendCborString(expected, expectedSize, AGENT_VERSION);
+    expectedSize = AppendCborString(expected, expectedSize, AGENT_ID_KEY);
+    expectedSize = AppendCborString(expected, expectedSize, TEST_AGENT_ID);
+    expectedSize = AppendCborString(expected, expectedSize, MESSAGE_SCHEMA_VERSION_KEY);
+    expectedSize = AppendCborString(expected, expectedSize, DEFAULT_MESSAGE_SCHEMA_VERSION);
+    expectedSize = AppendCborString(expected, expectedSize, EVENTS_KEY);
+    expected[expectedSize++] = 0x9F;
+    memcpy(expected + expectedSize, DUMMY_CBOR, strlen(DUMMY_CBOR));
+    expectedSize += strlen(DUMMY_CBOR);
+    expected[expectedSize++] = 0xFF;
+
+    ASSERT_ARE_EQUAL(int, expectedSize, bufferSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, buffer, expectedSize));
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateEncodedSecurityMessage_JsonEventInCborMessage_ExpectEventDropped)
+{
+    void* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSize = 1;
+    paddingQueueMockedSize = 0;
+
+    mockedGetMaxSizeReturnValue = TWIN_OK;
+    mockedGetMaxSizeValue = MESSAGE_BILLING_MULTIPLE;
+
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&mainQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateEncodedSecurityMessage(queues, 2, EVENT_ENCODING_CBOR, false, false, &buffer, &bufferSize);
+
+    // an event of another encoding is never spliced into the message
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_EMPTY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer);
+    ASSERT_ARE_EQUAL(int, 0, mainQueueMockedSize);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateEncodedSecurityMessage_JsonColumnar_ExpectEventsGrouped)
+{
+    void* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSize = 2;
+    paddingQueueMockedSize = 0;
+    mockedEventData = DUMMY_PROCESS_EVENT;
+
+    mockedGetMaxSizeReturnValue = TWIN_OK;
+    mockedGetMaxSizeValue = MESSAGE_BILLING_MULTIPLE;
+
+    SetupWriteEnvelopeExpectations();
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+    SetupAddEventExpectations();
+    SetupAddEventExpectations();
+    STRICT_EXPECTED_CALL(SyncQueue_BatchPopFront(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBatchIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, UINT32_MAX, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&mainQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopBestFit(&paddingQueue, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateEncodedSecurityMessage(queues, 2, EVENT_ENCODING_JSON, false, true, &buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr,
+        "{\"AgentVersion\":\"1.0\",\"Layout\":\"Columnar\",\"Strings\":[\"sh\"],\"EventGroups\":[{"
+        "\"Category\":\"Triggered\",\"EventType\":\"Security\",\"Name\":\"ProcessCreate\",\"PayloadSchemaVersion\":\"1.0\","
+        "\"Id\":[\"1\",\"1\"],\"TimestampUTC\":{\"Base\":\"2019-03-04T10:00:10Z\",\"Deltas\":[0]},\"TimestampLocal\":{\"OffsetFromUTC\":7200},"
+        "\"PayloadCounts\":[1,1],\"Payload\":{\"ProcessId\":[7,7]},\"PayloadStrings\":{\"Executable\":[0,0]}}]}",
+        buffer);
+    ASSERT_ARE_EQUAL(int, strlen(buffer), bufferSize);
+    ASSERT_IS_TRUE(bufferSize < MESSAGE_PREFIX_SIZE + 2 * strlen(DUMMY_PROCESS_EVENT) + 1 + MESSAGE_CLOSING_SIZE);
+
+    free(buffer);
+}
+
 END_TEST_SUITE(message_serializer_ut)
@@ -20,6 +20,7 @@
 #include "synchronized_queue.h"
 #include "collectors/event_aggregator.h"
 #include "azure_c_shared_utility/map.h"
+#include "tracked_allocator.h"
 #undef ENABLE_MOCKS
 
 #include "collectors/process_creation_collector.h"
@@ -101,6 +102,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(QueueResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(JsonArrayWriterHandle, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(JsonBufferAllocateFunc, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(JsonBufferFreeFunc, void*);
     REGISTER_UMOCK_ALIAS_TYPE(EventCollectorResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(AuditSearchCriteria, int);
     REGISTER_UMOCK_ALIAS_TYPE(Architecture, int);
@@ -109,6 +112,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(AuditControlResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(MAP_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AllocationTag, int);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned long);
 
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearchRecord_MaxRecordLength, Mocked_AuditSearchRecord_MaxRecordLength);
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearchRecord_ReadInt, Mocked_AuditSearchRecord_ReadInt);
@@ -164,7 +170,7 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_ExpectSucce
     STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_SerializeWithAllocator(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
@@ -278,7 +284,7 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_BadRecord_E
     STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_SerializeWithAllocator(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
 
     // another record - the uncomplete record
@@ -324,7 +330,7 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_ExpectFailu
     STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_SerializeWithAllocator(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetFailReturn(!AUDIT_SEARCH_NO_MORE_DATA);
@@ -363,4 +369,46 @@ TEST_FUNCTION(ProcessCreationCollector_Init_ExpectSuccess)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-END_TEST_SUITE(process_creation_collector_ut)
+TEST_FUNCTION(ProcessCreationCollector_InitWithIntegrityRecord_ExpectHashEntryCharged)
+{
+    const char* hash = "\"sha1:abcd\"";
+    const char* executable = "/bin/ls";
+    uint32_t entrySize = 32 + 32 + 2 * sizeof(char*);
+
+    STRICT_EXPECTED_CALL(AuditControl_Init(IGNORED_PTR_ARG)).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(AuditControl_AddRule(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, NULL)).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(EventAggregator_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_AGGREGATOR_OK);
+    STRICT_EXPECTED_CALL(Map_Create(IGNORED_PTR_ARG)).SetReturn((MAP_HANDLE)0x01);
+    STRICT_EXPECTED_CALL(AuditSearch_Init(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE,IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
+    STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, "hash", IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_output(&hash, sizeof(hash))
+        .SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, "file", IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_output(&executable, sizeof(executable))
+        .SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, executable)).SetReturn(NULL);
+    // the key and the hash without its prefix and suffix
+    STRICT_EXPECTED_CALL(TrackedAllocator_EstimateSize(strlen(executable) + 1)).SetReturn(32);
+    STRICT_EXPECTED_CALL(TrackedAllocator_EstimateSize(strlen("abcd") + 1)).SetReturn(32);
+    STRICT_EXPECTED_CALL(TrackedAllocator_Charge(ALLOCATION_TAG_PROCESS_HASHES, entrySize)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, executable, "abcd")).SetReturn(MAP_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
+    STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditControl_Deinit(IGNORED_PTR_ARG));
+
+    EventCollectorResult result = ProcessCreationCollector_Init();
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(EventAggregator_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TrackedAllocator_Discharge(ALLOCATION_TAG_PROCESS_HASHES, entrySize));
+
+    ProcessCreationCollector_Deinit();
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(process_creation_collector_ut)
\ No newline at end of file
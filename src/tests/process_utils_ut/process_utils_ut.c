@@ -1,18 +1,32 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+// O_CLOEXEC
+#define _GNU_SOURCE
+
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
 
 #include "umock_c.h"
 #include "umocktypes_charptr.h"
+#include "umocktypes_bool.h"
 
 #define ENABLE_MOCKS
 #include "os_mocks.h"
+#include "collectors/collector_execution.h"
 #undef ENABLE_MOCKS
 
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+
 #include "os_utils/process_utils.h"
 
+#define TEST_READ_FD 3
+#define TEST_WRITE_FD 4
+#define TEST_PID 1234
+
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
  MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -24,6 +38,47 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+int Mocked_pipe2(int* fds, int flags) {
+    fds[0] = TEST_READ_FD;
+    fds[1] = TEST_WRITE_FD;
+    return 0;
+}
+
+ssize_t Mocked_read(int fd, void* buffer, size_t size) {
+    errno = EIO;
+    return -1;
+}
+
+int Mocked_killNoGroup(pid_t pid, int signal) {
+    if (pid < 0) {
+        errno = ESRCH;
+        return -1;
+    }
+    return 0;
+}
+
+static void ExpectStart() {
+    STRICT_EXPECTED_CALL(pipe2(IGNORED_PTR_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(fork()).SetReturn(TEST_PID);
+    STRICT_EXPECTED_CALL(setpgid(TEST_PID, TEST_PID));
+    STRICT_EXPECTED_CALL(close(TEST_WRITE_FD));
+}
+
+static void ExpectRead(size_t size, ssize_t bytesRead) {
+    STRICT_EXPECTED_CALL(CollectorExecution_IsCanceled()).SetReturn(false);
+    STRICT_EXPECTED_CALL(poll(IGNORED_PTR_ARG, 1, IGNORED_NUM_ARG)).SetReturn(1);
+    STRICT_EXPECTED_CALL(read(TEST_READ_FD, IGNORED_PTR_ARG, size)).SetReturn(bytesRead);
+}
+
+static void ExpectKill() {
+    STRICT_EXPECTED_CALL(kill(-TEST_PID, SIGKILL));
+}
+
+static void ExpectWait() {
+    STRICT_EXPECTED_CALL(waitpid(TEST_PID, IGNORED_PTR_ARG, 0)).SetReturn(TEST_PID);
+    STRICT_EXPECTED_CALL(close(TEST_READ_FD));
+}
+
 BEGIN_TEST_SUITE(process_utils_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -36,6 +91,14 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
 
     umocktypes_charptr_register_types();
+    umocktypes_bool_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(pid_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(nfds_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(ssize_t, long long);
+
+    REGISTER_GLOBAL_MOCK_HOOK(pipe2, Mocked_pipe2);
+    REGISTER_GLOBAL_MOCK_HOOK(read, Mocked_read);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -52,82 +115,135 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
 TEST_FUNCTION(ProccesUtils_Execute_ExpectSuccess)
 {
-    FILE* mockedStream = (FILE*) 0x1;
     const char* command = "abc def";
     uint32_t dataSize = 56;
     char buffer[56] = "";
 
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(dataSize);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(feof(mockedStream)).SetReturn(1);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    // the buffer is full, but the command has nothing more to write
+    ExpectStart();
+    ExpectRead(dataSize, dataSize);
+    ExpectRead(1, 0);
+    ExpectWait();
 
     bool result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_TRUE(result);
     ASSERT_ARE_EQUAL(int, 56, dataSize);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
+    // the output arrives in parts
+    umock_c_reset_all_calls();
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(10);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    ExpectStart();
+    ExpectRead(56, 10);
+    ExpectRead(46, 6);
+    ExpectRead(40, 0);
+    ExpectWait();
 
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_TRUE(result);
-    ASSERT_ARE_EQUAL(int, 10, dataSize);
+    ASSERT_ARE_EQUAL(int, 16, dataSize);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 TEST_FUNCTION(ProccesUtils_Execute_ExpectFailure)
 {
-    FILE* mockedStream = (FILE*) 0x1;
     const char* command = "abc def";
     uint32_t dataSize = 56;
     char buffer[56] = "";
+    int exitStatus = 32512;
 
-    // popen failed
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(NULL);
+    // pipe failed
+    STRICT_EXPECTED_CALL(pipe2(IGNORED_PTR_ARG, O_CLOEXEC)).SetReturn(-1);
     bool result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // fread failed - error is set
+    // fork failed
+    umock_c_reset_all_calls();
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(dataSize);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(1);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    STRICT_EXPECTED_CALL(pipe2(IGNORED_PTR_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(fork()).SetReturn(-1);
+    STRICT_EXPECTED_CALL(close(TEST_WRITE_FD));
+    STRICT_EXPECTED_CALL(close(TEST_READ_FD));
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    
-    // fread failed - more data to read in file
+
+    // read failed
+    umock_c_reset_all_calls();
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(dataSize);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(feof(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    ExpectStart();
+    STRICT_EXPECTED_CALL(CollectorExecution_IsCanceled()).SetReturn(false);
+    STRICT_EXPECTED_CALL(poll(IGNORED_PTR_ARG, 1, IGNORED_NUM_ARG)).SetReturn(1);
+    STRICT_EXPECTED_CALL(read(TEST_READ_FD, IGNORED_PTR_ARG, dataSize));
+    ExpectKill();
+    ExpectWait();
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    
-    // pclose failed - process not found
+
+    // more data to read
+    umock_c_reset_all_calls();
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(10);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(pclose(mockedStream)).SetReturn(32512);
+    ExpectStart();
+    ExpectRead(dataSize, dataSize);
+    ExpectRead(1, 1);
+    ExpectKill();
+    ExpectWait();
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the command failed - process not found
+    umock_c_reset_all_calls();
+    dataSize = 56;
+    ExpectStart();
+    ExpectRead(dataSize, 10);
+    ExpectRead(46, 0);
+    STRICT_EXPECTED_CALL(waitpid(TEST_PID, IGNORED_PTR_ARG, 0))
+        .CopyOutArgumentBuffer_status(&exitStatus, sizeof(exitStatus))
+        .SetReturn(TEST_PID);
+    STRICT_EXPECTED_CALL(close(TEST_READ_FD));
+    result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(ProccesUtils_Execute_CollectorCanceled_ExpectProcessGroupKilled)
+{
+    const char* command = "abc def";
+    uint32_t dataSize = 56;
+    char buffer[56] = "";
+
+    ExpectStart();
+    ExpectRead(dataSize, 10);
+    STRICT_EXPECTED_CALL(CollectorExecution_IsCanceled()).SetReturn(true);
+    ExpectKill();
+    ExpectWait();
+
+    bool result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(int, 10, dataSize);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(ProccesUtils_Execute_CollectorCanceledWithoutProcessGroup_ExpectProcessKilled)
+{
+    const char* command = "abc def";
+    uint32_t dataSize = 56;
+    char buffer[56] = "";
+    REGISTER_GLOBAL_MOCK_HOOK(kill, Mocked_killNoGroup);
+
+    ExpectStart();
+    STRICT_EXPECTED_CALL(CollectorExecution_IsCanceled()).SetReturn(true);
+    ExpectKill();
+    STRICT_EXPECTED_CALL(kill(TEST_PID, SIGKILL));
+    ExpectWait();
+
+    bool result = ProcessUtils_Execute(command, buffer, &dataSize);
+    REGISTER_GLOBAL_MOCK_HOOK(kill, NULL);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-END_TEST_SUITE(process_utils_ut)
+END_TEST_SUITE(process_utils_ut)
\ No newline at end of file
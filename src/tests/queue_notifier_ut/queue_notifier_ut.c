@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "queue_notifier.h"
+#include <stdint.h>
+
+#define TEST_WATERMARK 100
+#define TEST_TIMEOUT 10
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static QueueNotifier notifier;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(queue_notifier_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    ASSERT_IS_TRUE(QueueNotifier_Init(&notifier, TEST_WATERMARK));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    QueueNotifier_Deinit(&notifier);
+}
+
+TEST_FUNCTION(QueueNotifier_WaitNothingPushed_ExpectTimeout)
+{
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_TIMEOUT, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+}
+
+TEST_FUNCTION(QueueNotifier_PushBelowWatermark_ExpectTimeout)
+{
+    QueueNotifier_NotifyPush(&notifier, TEST_WATERMARK - 1, false);
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_TIMEOUT, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+}
+
+TEST_FUNCTION(QueueNotifier_PushCrossesWatermark_ExpectWokenOnce)
+{
+    QueueNotifier_NotifyPush(&notifier, TEST_WATERMARK / 2, false);
+    QueueNotifier_NotifyPush(&notifier, TEST_WATERMARK / 2, false);
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_SIGNALED, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+
+    // the pending size is reset by the wait
+    QueueNotifier_NotifyPush(&notifier, TEST_WATERMARK / 2, false);
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_TIMEOUT, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+}
+
+TEST_FUNCTION(QueueNotifier_PushUrgent_ExpectUrgent)
+{
+    QueueNotifier_NotifyPush(&notifier, 1, true);
+    QueueNotifier_NotifyPush(&notifier, TEST_WATERMARK, false);
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_URGENT, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_TIMEOUT, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+}
+
+TEST_FUNCTION(QueueNotifier_SetWatermark_ExpectNewWatermarkUsed)
+{
+    QueueNotifier_SetWatermark(&notifier, 2 * TEST_WATERMARK);
+    QueueNotifier_NotifyPush(&notifier, TEST_WATERMARK, false);
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_TIMEOUT, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+}
+
+TEST_FUNCTION(QueueNotifier_Signal_ExpectWoken)
+{
+    QueueNotifier_Signal(&notifier);
+    ASSERT_ARE_EQUAL(int, QUEUE_NOTIFIER_SIGNALED, QueueNotifier_Wait(&notifier, TEST_TIMEOUT));
+}
+
+END_TEST_SUITE(queue_notifier_ut)
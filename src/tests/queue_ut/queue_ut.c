@@ -16,10 +16,12 @@
 #include "memory_monitor.h"
 #include "local_config.h"
 #include "agent_telemetry_counters.h"
+#include "os_utils/spill_log.h"
 #undef ENABLE_MOCKS
 
 #include "queue.h"
 #include "logger.h"
+#include "slab_allocator.h"
 #include <stdint.h>
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -41,6 +43,10 @@ bool alwaysFalseCondition(const void* data, uint32_t size, void* params) {
     return false;
 }
 
+bool evictLowPriority(void* evictParams, Queue* queue, QueuePriority priority) {
+    return Queue_EvictOldest(queue, QUEUE_PRIORITY_LOW) == QUEUE_OK;
+}
+
 BEGIN_TEST_SUITE(queue_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -67,6 +73,7 @@ TEST_FUNCTION_INITIALIZE(method_init)
 {
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(SpillLogResultValues, int);
     
     umock_c_reset_all_calls();
     
@@ -257,5 +264,497 @@ TEST_FUNCTION(Queue_MemoryMonitorExcpetion_ExpectMemoryException)
     free(firstMessage);
 }
 
+TEST_FUNCTION(Queue_PushBackInlineData_ExpectBlockAccounted)
+{
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    const char* message = "inline message";
+    uint32_t messageSize = strlen(message) + 1;
+    char* data = Queue_AllocateData(messageSize);
+    ASSERT_IS_NOT_NULL(data);
+    strcpy(data, message);
+    uint32_t expectedSize = SlabAllocator_GetBlockSize(sizeof(QueueItem) + messageSize);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(expectedSize)).SetReturn(MEMORY_MONITOR_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, data, messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output;
+    uint32_t outputSize;
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(expectedSize)).SetReturn(MEMORY_MONITOR_OK);
+    result = Queue_PopFront(&queue, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(void_ptr, data, output);
+    ASSERT_ARE_EQUAL(char_ptr, message, output);
+    ASSERT_ARE_EQUAL(int, messageSize, outputSize);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    Queue_FreeData(output);
+    Queue_Deinit(&queue);
+    SlabAllocator_Deinit();
+}
+
+TEST_FUNCTION(Queue_PushBackHeapData_ExpectPooledItemAccounted)
+{
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = strdup("heap message");
+    uint32_t messageSize = strlen(message) + 1;
+    uint32_t expectedSize = messageSize + SlabAllocator_GetBlockSize(sizeof(QueueItem));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(expectedSize)).SetReturn(MEMORY_MONITOR_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, message, messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output;
+    uint32_t outputSize;
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(expectedSize)).SetReturn(MEMORY_MONITOR_OK);
+    result = Queue_PopFront(&queue, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(void_ptr, message, output);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    Queue_FreeData(output);
+    Queue_Deinit(&queue);
+    SlabAllocator_Deinit();
+}
+
+TEST_FUNCTION(Queue_PushBackWithMemoryBudget_ExpectBudgetAccounted)
+{
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    MemoryBudget budget;
+    Queue_SetMemoryBudget(&queue, &budget);
+
+    char* message = strdup("heap message");
+    uint32_t messageSize = strlen(message) + 1;
+    uint32_t expectedSize = messageSize + SlabAllocator_GetBlockSize(sizeof(QueueItem));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(MemoryMonitor_ConsumeFromBudget(&budget, expectedSize)).SetReturn(MEMORY_MONITOR_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, message, messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output;
+    uint32_t outputSize;
+    STRICT_EXPECTED_CALL(MemoryMonitor_ReleaseToBudget(&budget, expectedSize)).SetReturn(MEMORY_MONITOR_OK);
+    result = Queue_PopFront(&queue, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(void_ptr, message, output);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    Queue_FreeData(output);
+    Queue_Deinit(&queue);
+    SlabAllocator_Deinit();
+}
+
+TEST_FUNCTION(Queue_ConsumesSharedMemory_WithMemoryBudget_ExpectBudgetChecked)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    // without a budget every item is consumed from the shared memory
+    ASSERT_IS_TRUE(Queue_ConsumesSharedMemory(&queue));
+
+    MemoryBudget budget;
+    Queue_SetMemoryBudget(&queue, &budget);
+    STRICT_EXPECTED_CALL(MemoryMonitor_IsBeyondReservation(&budget)).SetReturn(false);
+    STRICT_EXPECTED_CALL(MemoryMonitor_IsBeyondReservation(&budget)).SetReturn(true);
+
+    ASSERT_IS_FALSE(Queue_ConsumesSharedMemory(&queue));
+    ASSERT_IS_TRUE(Queue_ConsumesSharedMemory(&queue));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_AllocateDataTooBigForPool_ExpectHeapBuffer)
+{
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+
+    char* data = Queue_AllocateData(SLAB_ALLOCATOR_MAX_BLOCK_SIZE + 1);
+    ASSERT_IS_NOT_NULL(data);
+    memset(data, 0, SLAB_ALLOCATOR_MAX_BLOCK_SIZE + 1);
+
+    void* block = NULL;
+    uint32_t blockSize = 0;
+    ASSERT_IS_FALSE(SlabAllocator_GetBlock(data, &block, &blockSize));
+
+    Queue_FreeData(data);
+    SlabAllocator_Deinit();
+}
+
+TEST_FUNCTION(Queue_DeinitWithInlineData_ExpectDataReleased)
+{
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* data = Queue_AllocateData(32);
+    ASSERT_IS_NOT_NULL(data);
+    result = Queue_PushBack(&queue, data, 32);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    Queue_Deinit(&queue);
+
+    // the block is back in the pool, so the next allocation reuses it
+    char* reused = Queue_AllocateData(32);
+    ASSERT_ARE_EQUAL(void_ptr, data, reused);
+    Queue_FreeData(reused);
+    SlabAllocator_Deinit();
+}
+
+TEST_FUNCTION(Queue_PopBatchIf_ExpectPrefixBelowMaxSize)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    for (int i = 0; i < 3; ++i) {
+        char* message = strdup("message");
+        result = Queue_PushBack(&queue, message, strlen(message) + 1);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    }
+
+    // room for the first two messages only
+    QueueBatch batch;
+    uint32_t messageSize = strlen("message") + 1;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(2 * (messageSize + sizeof(QueueItem) + sizeof(QueueItem*)))).SetReturn(MEMORY_MONITOR_OK);
+    result = Queue_PopBatchIf(&queue, NULL, NULL, 2 * messageSize + 1, &batch);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 2, batch.numberOfElements);
+    ASSERT_ARE_EQUAL(int, 2 * messageSize, batch.dataSize);
+    ASSERT_ARE_EQUAL(int, 1, queue.numberOfElements);
+    ASSERT_IS_NULL(queue.firstItem->prevItem);
+
+    char* output;
+    uint32_t outputSize;
+    for (int i = 0; i < 2; ++i) {
+        result = Queue_BatchPopFront(&batch, (void**)&output, &outputSize);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, "message", output);
+        ASSERT_ARE_EQUAL(int, messageSize, outputSize);
+        free(output);
+    }
+    result = Queue_BatchPopFront(&batch, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    // the rest of the queue is intact
+    result = Queue_PopBatchIf(&queue, NULL, NULL, UINT32_MAX, &batch);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, batch.numberOfElements);
+    ASSERT_ARE_EQUAL(int, 0, queue.numberOfElements);
+    ASSERT_IS_NULL(queue.firstItem);
+    ASSERT_IS_NULL(queue.lastItem);
+    result = Queue_BatchPopFront(&batch, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    free(output);
+
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_PopBatchIfFirstItemDoesNotFit_ExpectConditionFailed)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = strdup("first message");
+    result = Queue_PushBack(&queue, message, strlen(message) + 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    QueueBatch batch;
+    result = Queue_PopBatchIf(&queue, NULL, NULL, strlen(message) + 1, &batch);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, 0, batch.numberOfElements);
+
+    result = Queue_PopBatchIf(&queue, alwaysFalseCondition, NULL, UINT32_MAX, &batch);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, 1, queue.numberOfElements);
+
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_PopBatchIfEmpty_ExpectQueueIsEmpty)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    QueueBatch batch;
+    result = Queue_PopBatchIf(&queue, alwaysTrueCondition, NULL, UINT32_MAX, &batch);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+    ASSERT_ARE_EQUAL(int, 0, batch.numberOfElements);
+
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_MaxLocalCacheSizeExceededWithSpillLog_ExpectSpilledInOrder)
+{
+    Queue queue;
+    SpillLog spillLog;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(SPILL_LOG_IS_EMPTY);
+    Queue_SetSpillLog(&queue, &spillLog);
+
+    // the first message exceeds the memory budget, so it is spilled
+    char* firstMessage = strdup("first message");
+    uint32_t firstMessageSize = strlen(firstMessage) + 1;
+    STRICT_EXPECTED_CALL(SpillLog_GetSize(&spillLog)).SetReturn(0);
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(SpillLog_Append(&spillLog, firstMessage, firstMessageSize)).SetReturn(SPILL_LOG_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, firstMessage, firstMessageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    // the log is not empty, so the second message goes after the first one without trying the memory
+    char* secondMessage = strdup("second message");
+    uint32_t secondMessageSize = strlen(secondMessage) + 1;
+    STRICT_EXPECTED_CALL(SpillLog_GetSize(&spillLog)).SetReturn(1);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&spillLog, secondMessage, secondMessageSize)).SetReturn(SPILL_LOG_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, secondMessage, secondMessageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    // the log is full as well
+    char* thirdMessage = strdup("third message");
+    uint32_t thirdMessageSize = strlen(thirdMessage) + 1;
+    STRICT_EXPECTED_CALL(SpillLog_GetSize(&spillLog)).SetReturn(2);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&spillLog, thirdMessage, thirdMessageSize)).SetReturn(SPILL_LOG_QUOTA_EXCEEDED);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, thirdMessage, thirdMessageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+
+    uint32_t size = 0;
+    STRICT_EXPECTED_CALL(SpillLog_GetSize(&spillLog)).SetReturn(2);
+    Queue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 2, size);
+    ASSERT_ARE_EQUAL(int, 0, queue.numberOfElements);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    free(thirdMessage);
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_PopWithSpillLog_ExpectRefilledFromLog)
+{
+    Queue queue;
+    SpillLog spillLog;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(SPILL_LOG_IS_EMPTY);
+    Queue_SetSpillLog(&queue, &spillLog);
+
+    char* firstMessage = strdup("first message");
+    uint32_t firstMessageSize = strlen(firstMessage) + 1;
+    STRICT_EXPECTED_CALL(SpillLog_GetSize(&spillLog)).SetReturn(0);
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBack(&queue, firstMessage, firstMessageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    // poping the first message makes room for the record waiting in the log
+    const void* record = "spilled message";
+    uint32_t recordSize = strlen(record) + 1;
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_data(&record, sizeof(record))
+        .CopyOutArgumentBuffer_dataSize(&recordSize, sizeof(recordSize))
+        .SetReturn(SPILL_LOG_OK);
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(SpillLog_Consume(&spillLog)).SetReturn(SPILL_LOG_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(SPILL_LOG_IS_EMPTY);
+
+    char* output;
+    uint32_t outputSize;
+    result = Queue_PopFront(&queue, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    free(output);
+
+    ASSERT_ARE_EQUAL(int, 1, queue.numberOfElements);
+    ASSERT_ARE_EQUAL(char_ptr, record, queue.firstItem->data);
+    ASSERT_ARE_EQUAL(int, recordSize, queue.firstItem->dataSize);
+
+    // the refilled record is kept in the log on deinit
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(SpillLog_Append(&spillLog, IGNORED_PTR_ARG, recordSize)).SetReturn(SPILL_LOG_OK);
+    Queue_Deinit(&queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(Queue_MaxLocalCacheSizeExceededWithEvictionPolicy_ExpectLowPriorityEvicted)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    Queue_SetEvictionPolicy(&queue, QUEUE_PRIORITY_HIGH, evictLowPriority, NULL);
+    umock_c_reset_all_calls();
+
+    char* lowPriorityMessage = strdup("low priority message");
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
+    result = Queue_PushBackWithPriority(&queue, lowPriorityMessage, strlen(lowPriorityMessage) + 1, QUEUE_PRIORITY_LOW);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    // the budget is exhausted, the low priority message is evicted to admit the high priority one
+    char* highPriorityMessage = strdup("high priority message");
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.dropped, 1)).SetReturn(true);
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.collected, 1)).SetReturn(true);
+    result = Queue_PushBack(&queue, highPriorityMessage, strlen(highPriorityMessage) + 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, queue.numberOfElements);
+    ASSERT_ARE_EQUAL(char_ptr, highPriorityMessage, queue.firstItem->data);
+    ASSERT_ARE_EQUAL(int, QUEUE_PRIORITY_HIGH, queue.firstItem->priority);
+
+    // nothing is left to evict
+    char* message = strdup("another high priority message");
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.dropped, 1)).SetReturn(true);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.collected, 1)).SetReturn(true);
+    result = Queue_PushBack(&queue, message, strlen(message) + 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    free(message);
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_EvictOldest_ExpectOldestItemWithPriorityUnlinked)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first");
+    char* secondMessage = strdup("second");
+    char* thirdMessage = strdup("third");
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, Queue_PushBackWithPriority(&queue, firstMessage, strlen(firstMessage) + 1, QUEUE_PRIORITY_HIGH));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, Queue_PushBackWithPriority(&queue, secondMessage, strlen(secondMessage) + 1, QUEUE_PRIORITY_LOW));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, Queue_PushBackWithPriority(&queue, thirdMessage, strlen(thirdMessage) + 1, QUEUE_PRIORITY_HIGH));
+
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, Queue_EvictOldest(&queue, QUEUE_PRIORITY_AGGREGATED));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, Queue_EvictOldest(&queue, QUEUE_PRIORITY_LOW));
+    ASSERT_ARE_EQUAL(int, 2, queue.numberOfElements);
+
+    // the middle item is unlinked from both sides
+    char* output;
+    uint32_t outputSize;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, Queue_PopFront(&queue, (void**)&output, &outputSize));
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    free(output);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, Queue_EvictOldest(&queue, QUEUE_PRIORITY_HIGH));
+    ASSERT_ARE_EQUAL(int, 0, queue.numberOfElements);
+    ASSERT_IS_NULL(queue.firstItem);
+    ASSERT_IS_NULL(queue.lastItem);
+
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_PopBestFit_ExpectLargestItemWhichFits)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    const char* messages[] = { "a long message", "short", "medium", "tiny", "medium" };
+    for (int i = 0; i < 5; ++i) {
+        char* message = strdup(messages[i]);
+        result = Queue_PushBack(&queue, message, strlen(message) + 1);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    }
+
+    char* output;
+    uint32_t outputSize;
+    result = Queue_PopBestFit(&queue, strlen("tiny"), (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, 5, queue.numberOfElements);
+
+    // the oldest of the largest items which fit is taken from the middle of the queue
+    result = Queue_PopBestFit(&queue, strlen("medium") + 2, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "medium", output);
+    ASSERT_ARE_EQUAL(int, strlen("medium") + 1, outputSize);
+    ASSERT_ARE_EQUAL(int, 4, queue.numberOfElements);
+    free(output);
+
+    // the rest of the queue keeps its order
+    const char* expected[] = { "a long message", "short", "tiny", "medium" };
+    for (int i = 0; i < 4; ++i) {
+        result = Queue_PopFront(&queue, (void**)&output, &outputSize);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, expected[i], output);
+        free(output);
+    }
+    ASSERT_IS_NULL(queue.firstItem);
+    ASSERT_IS_NULL(queue.lastItem);
+
+    result = Queue_PopBestFit(&queue, UINT32_MAX, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    Queue_Deinit(&queue);
+}
+
+TEST_FUNCTION(Queue_PopBestFitBeyondLookAhead_ExpectConditionFailed)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    for (int i = 0; i < QUEUE_BEST_FIT_MAX_LOOK_AHEAD; ++i) {
+        char* message = strdup("a long message");
+        result = Queue_PushBack(&queue, message, strlen(message) + 1);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    }
+    char* tiny = strdup("tiny");
+    result = Queue_PushBack(&queue, tiny, strlen(tiny) + 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    // the only item which fits is behind the look ahead
+    char* output;
+    uint32_t outputSize;
+    result = Queue_PopBestFit(&queue, strlen("tiny") + 1, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, QUEUE_BEST_FIT_MAX_LOOK_AHEAD + 1, queue.numberOfElements);
+
+    // it is reached once the queue moves
+    result = Queue_PopFront(&queue, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    free(output);
+    result = Queue_PopBestFit(&queue, strlen("tiny") + 1, (void**)&output, &outputSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "tiny", output);
+    free(output);
+
+    Queue_Deinit(&queue);
+}
 
 END_TEST_SUITE(queue_ut)
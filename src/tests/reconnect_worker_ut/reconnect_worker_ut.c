@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "consts.h"
+#include "reconnect_worker.h"
+#include <stdint.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static ReconnectWorker worker;
+static uint32_t reconnectCalls = 0;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static bool TestReconnect(void* context) {
+    ++reconnectCalls;
+    return true;
+}
+
+BEGIN_TEST_SUITE(reconnect_worker_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    reconnectCalls = 0;
+    ASSERT_IS_TRUE(ReconnectWorker_Init(&worker, TestReconnect, NULL));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    ReconnectWorker_Deinit(&worker);
+}
+
+TEST_FUNCTION(ReconnectWorker_GetBackoff_ExpectJitterWithinDoubledInterval)
+{
+    unsigned int seed = 1;
+    uint32_t interval = RECONNECT_INITIAL_INTERVAL;
+    for (uint32_t attempts = 0; attempts < 4; ++attempts) {
+        for (int i = 0; i < 100; ++i) {
+            uint32_t backoff = ReconnectWorker_GetBackoff(attempts, &seed);
+            ASSERT_IS_TRUE(backoff >= interval / 2);
+            ASSERT_IS_TRUE(backoff <= interval);
+        }
+        interval *= 2;
+    }
+}
+
+TEST_FUNCTION(ReconnectWorker_GetBackoff_ManyAttempts_ExpectCappedAtMaxInterval)
+{
+    unsigned int seed = 1;
+    for (int i = 0; i < 100; ++i) {
+        uint32_t backoff = ReconnectWorker_GetBackoff(UINT32_MAX, &seed);
+        ASSERT_IS_TRUE(backoff >= RECONNECT_MAX_INTERVAL / 2);
+        ASSERT_IS_TRUE(backoff <= RECONNECT_MAX_INTERVAL);
+    }
+}
+
+TEST_FUNCTION(ReconnectWorker_Schedule_ExpectNoReconnectBeforeBackoff)
+{
+    ASSERT_IS_NULL(worker.thread);
+
+    ASSERT_IS_TRUE(ReconnectWorker_Schedule(&worker));
+    ASSERT_IS_NOT_NULL(worker.thread);
+    ASSERT_IS_TRUE(worker.pending);
+
+    // a second schedule keeps the reconnect which is due
+    uint64_t dueTime = worker.dueTime;
+    ASSERT_IS_TRUE(ReconnectWorker_Schedule(&worker));
+    ASSERT_IS_TRUE(dueTime == worker.dueTime);
+
+    // the deinit does not wait for the backoff
+    ReconnectWorker_Deinit(&worker);
+    ASSERT_ARE_EQUAL(int, 0, reconnectCalls);
+}
+
+TEST_FUNCTION(ReconnectWorker_Reset_ExpectScheduledReconnectCanceled)
+{
+    ASSERT_IS_TRUE(ReconnectWorker_Schedule(&worker));
+    worker.attempts = 3;
+
+    ReconnectWorker_Reset(&worker);
+
+    ASSERT_IS_FALSE(worker.pending);
+    ASSERT_ARE_EQUAL(int, 0, worker.attempts);
+    ASSERT_ARE_EQUAL(int, 0, reconnectCalls);
+}
+
+END_TEST_SUITE(reconnect_worker_ut)
@@ -0,0 +1,315 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umock_c_negative_tests.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+#include "umockalloc.h"
+
+#define ENABLE_MOCKS
+#include "twin_configuration.h"
+#include "memory_monitor.h"
+#include "local_config.h"
+#include "agent_telemetry_counters.h"
+#undef ENABLE_MOCKS
+
+#include "ring_queue.h"
+#include "logger.h"
+#include <stdint.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+bool alwaysTrueCondition(const void* data, uint32_t size, void* params) {
+    return true;
+}
+
+bool alwaysFalseCondition(const void* data, uint32_t size, void* params) {
+    return false;
+}
+
+BEGIN_TEST_SUITE(ring_queue_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
+
+    REGISTER_GLOBAL_MOCK_RETURN(AgentTelemetryCounter_Init, true);
+    REGISTER_GLOBAL_MOCK_RETURN(AgentTelemetryCounter_IncreaseBy, true);
+    REGISTER_GLOBAL_MOCK_RETURN(MemoryMonitor_Consume, MEMORY_MONITOR_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(MemoryMonitor_Release, MEMORY_MONITOR_OK);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(RingQueue_Init_ExpectSuccess)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 5, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    // the capacity is rounded up to a power of two
+    ASSERT_ARE_EQUAL(int, 7, queue.mask);
+    ASSERT_ARE_EQUAL(int, 0, queue.numberOfElements);
+    ASSERT_IS_NOT_NULL(queue.slots);
+
+    RingQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingQueue_InitZeroCapacity_ExpectFailure)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 0, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_MEMORY_EXCEPTION, result);
+}
+
+TEST_FUNCTION(RingQueue_InitCounterFailed_ExpectFailure)
+{
+    RingQueue queue;
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(false);
+
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_MEMORY_EXCEPTION, result);
+    ASSERT_IS_NULL(queue.slots);
+}
+
+TEST_FUNCTION(RingQueue_PushBackAndPop_ExpectSuccess)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first message");
+    char* secondMessage = strdup("second message");
+    unsigned int size;
+
+    result = RingQueue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    result = RingQueue_PushBack(&queue, secondMessage, strlen(secondMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 2, size);
+
+    char* output;
+    unsigned int messageSize;
+    result = RingQueue_PopFront(&queue, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    ASSERT_ARE_EQUAL(int, strlen(firstMessage) + 1, messageSize);
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    RingQueue_Deinit(&queue);
+
+    // free the message popped from the queue
+    free(output);
+}
+
+TEST_FUNCTION(RingQueue_PushBackAndPopIfConditionReutrnsTrue_ExpectSuccess)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first message");
+    unsigned int size;
+
+    result = RingQueue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output;
+    unsigned int messageSize;
+    result = RingQueue_PopFrontIf(&queue, alwaysTrueCondition, NULL, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    ASSERT_ARE_EQUAL(int, strlen(firstMessage) + 1, messageSize);
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    RingQueue_Deinit(&queue);
+    free(output);
+}
+
+TEST_FUNCTION(RingQueue_PushBackAndPopIfConditionReutrnsFalse_ExpectConditionFailed)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first message");
+    unsigned int size;
+
+    result = RingQueue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output;
+    unsigned int messageSize;
+    result = RingQueue_PopFrontIf(&queue, alwaysFalseCondition, NULL, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    RingQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingQueue_PushToFullRing_ExpectMaxMemoryExceeded)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 2, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first message");
+    char* secondMessage = strdup("second message");
+    char* thirdMessage = "third message";
+    unsigned int size;
+
+    result = RingQueue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    result = RingQueue_PushBack(&queue, secondMessage, strlen(secondMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.dropped, 1));
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(IGNORED_NUM_ARG)).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.collected, 1));
+
+    result = RingQueue_PushBack(&queue, thirdMessage, strlen(thirdMessage)+1);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 2, size);
+
+    RingQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingQueue_PushPopWrapsAround_ExpectFifoOrder)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 2, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    static char messages[5][2] = { "a", "b", "c", "d", "e" };
+    char* output;
+    unsigned int messageSize;
+
+    result = RingQueue_PushBack(&queue, messages[0], 2);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    for (int i = 1; i < 5; ++i) {
+        result = RingQueue_PushBack(&queue, messages[i], 2);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+        result = RingQueue_PopFront(&queue, (void**)&output, &messageSize);
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+        ASSERT_ARE_EQUAL(void_ptr, messages[i - 1], output);
+    }
+
+    result = RingQueue_PopFront(&queue, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(void_ptr, messages[4], output);
+
+    RingQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingQueue_MaxLocalCacheSizeExceeded_ExpectMaxMemoryExceeded)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = "first message";
+    unsigned int size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.dropped, 1));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.collected, 1));
+    result = RingQueue_PushBack(&queue, message, strlen(message) + 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    RingQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingQueue_MemoryMonitorExcpetion_ExpectMemoryException)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = "first message";
+    unsigned int size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_EXCEPTION).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&queue.counter, &queue.counter.counter.queueCounter.collected, 1));
+    result = RingQueue_PushBack(&queue, message, strlen(message) + 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_MEMORY_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    RingQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    RingQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingQueue_PopEmpty_ExpectQueueIsEmpty)
+{
+    RingQueue queue;
+    int result = RingQueue_Init(&queue, 4, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output;
+    unsigned int messageSize;
+
+    result = RingQueue_PopFront(&queue, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    result = RingQueue_PopFrontIf(&queue, alwaysTrueCondition, NULL, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    RingQueue_Deinit(&queue);
+}
+
+END_TEST_SUITE(ring_queue_ut)
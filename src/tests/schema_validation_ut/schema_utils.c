@@ -9,9 +9,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "parson.h"
+
 #define BUFFER_SIZE 4096
 
-char* to_full_path(char* path)
+char* to_full_path(const char* path)
 {
 	char* dest = malloc(BUFFER_SIZE);
 	memset(dest, 0, BUFFER_SIZE);
@@ -26,60 +28,160 @@ char* to_full_path(char* path)
 	return dest;
 }
 
-SchemaValidationResult validate_schema(SyncQueue* eventQueue)
+/**
+ * @brief Validates the given json against the given schema, the other message schemas may be referenced by it.
+ */
+static SchemaValidationResult validate_json(const char* schema, const JSON_Value* json)
 {
 	SchemaValidationResult result = SCHEMA_VALIDATION_OK;
 
- 	char* messageJsonString = NULL;
+	char* jsonString = json_serialize_to_string(json);
+	char* tempPath = to_full_path("temp.json");
+	char* schemaPath = to_full_path(schema);
+	char* referenceWildcard = to_full_path("message*.json");
 
-    SyncQueue* queues[] = {eventQueue};
-    if(MESSAGE_SERIALIZER_OK != MessageSerializer_CreateSecurityMessage(queues, 1, (void**)&messageJsonString))
+	if (jsonString == NULL)
 	{
 		result = SCHEMA_VALIDATION_ERROR;
 		goto cleanup;
 	}
 
-	char* tempPath = to_full_path("temp.json");
 	FILE* jsonFile = fopen(tempPath, "w");
-	if(jsonFile == NULL)
+	if (jsonFile == NULL)
 	{
 		result = SCHEMA_VALIDATION_ERROR;
 		goto cleanup;
 	}
 
-	if(fprintf(jsonFile, "%s", messageJsonString) < 0)
+	int written = fprintf(jsonFile, "%s", jsonString);
+	if (fclose(jsonFile) == EOF || written < 0)
 	{
 		result = SCHEMA_VALIDATION_ERROR;
 		goto cleanup;
 	}
 
-	if(fclose(jsonFile) == EOF)
+	char commandBuffer[BUFFER_SIZE];
+	snprintf(commandBuffer, sizeof(commandBuffer), "ajv test -s \"%s\" -r \"%s\" -d \"%s\" --valid", schemaPath, referenceWildcard, tempPath);
+
+	int status = system(commandBuffer);
+	int retcode = WEXITSTATUS(status);
+	if (retcode != 0)
 	{
 		result = SCHEMA_VALIDATION_ERROR;
+		fprintf(stderr, "json failed validation against %s:\n%s\n", schema, jsonString);
 		goto cleanup;
 	}
 
-	char* referenceWildcard = to_full_path("message*.json");
+cleanup:
 
-	char* messageRootPath = to_full_path("messageRoot.json");
-	char commandBuffer[BUFFER_SIZE];
-	snprintf(commandBuffer, sizeof(commandBuffer), "ajv test -s \"%s\" -r \"%s\" -d \"%s\" --valid", messageRootPath, referenceWildcard, tempPath);
+	json_free_serialized_string(jsonString);
+	free(tempPath);
+	free(schemaPath);
+	free(referenceWildcard);
 
-	int status = system(commandBuffer);
-	int retcode = WEXITSTATUS(status);
-	if(retcode != 0)
+	return result;
+}
+
+/**
+ * @brief Returns the index of the schema of the given event, or the count of the schemas if the event has none of its own.
+ */
+static size_t find_event_schema(const JSON_Object* event, const EventSchema* eventSchemas, size_t eventSchemasCount)
+{
+	const char* name = json_object_get_string(event, "Name");
+	size_t index = 0;
+	for (; index < eventSchemasCount; index++)
+	{
+		if (name != NULL && strcmp(name, eventSchemas[index].name) == 0)
+		{
+			break;
+		}
+	}
+
+	return index;
+}
+
+SchemaValidationResult validate_schema(SyncQueue* eventQueue)
+{
+	return validate_schema_with_event_schemas(eventQueue, NULL, 0);
+}
+
+SchemaValidationResult validate_schema_with_event_schemas(SyncQueue* eventQueue, const EventSchema* eventSchemas, size_t eventSchemasCount)
+{
+	SchemaValidationResult result = SCHEMA_VALIDATION_OK;
+	char* messageJsonString = NULL;
+	JSON_Value* message = NULL;
+	bool* validatedSchemas = calloc(eventSchemasCount + 1, sizeof(bool));
+
+	SyncQueue* queues[] = {eventQueue};
+	if (MESSAGE_SERIALIZER_OK != MessageSerializer_CreateSecurityMessage(queues, 1, (void**)&messageJsonString))
+	{
+		result = SCHEMA_VALIDATION_ERROR;
+		goto cleanup;
+	}
+
+	message = json_parse_string(messageJsonString);
+	JSON_Array* events = json_object_get_array(json_object(message), "Events");
+	if (events == NULL)
 	{
 		result = SCHEMA_VALIDATION_ERROR;
-		fprintf(stderr, "json failed schema validation:\n%s\n", messageJsonString);
+		fprintf(stderr, "message has no events:\n%s\n", messageJsonString);
 		goto cleanup;
 	}
 
+	// the events which have a schema of their own are validated against it and taken out of the message,
+	// or only the members it describes are taken out when the rest of the event is published
+	size_t i = 0;
+	while (i < json_array_get_count(events))
+	{
+		const JSON_Object* event = json_array_get_object(events, i);
+		size_t index = find_event_schema(event, eventSchemas, eventSchemasCount);
+		if (index == eventSchemasCount)
+		{
+			i++;
+			continue;
+		}
+
+		result = validate_json(eventSchemas[index].schema, json_array_get_value(events, i));
+		if (result != SCHEMA_VALIDATION_OK)
+		{
+			goto cleanup;
+		}
+
+		validatedSchemas[index] = true;
+		if (eventSchemas[index].members == NULL)
+		{
+			json_array_remove(events, i);
+			continue;
+		}
+
+		for (const char* const* member = eventSchemas[index].members; *member != NULL; member++)
+		{
+			json_object_remove(json_array_get_object(events, i), *member);
+		}
+		i++;
+	}
+
+	for (i = 0; i < eventSchemasCount; i++)
+	{
+		if (!validatedSchemas[i])
+		{
+			result = SCHEMA_VALIDATION_ERROR;
+			fprintf(stderr, "message has no %s event:\n%s\n", eventSchemas[i].name, messageJsonString);
+			goto cleanup;
+		}
+	}
+
+	// the rest of the message is validated against the published message schemas
+	if (eventSchemasCount == 0 || json_array_get_count(events) > 0)
+	{
+		result = validate_json("messageRoot.json", message);
+	}
+
 cleanup:
 
+	json_value_free(message);
 	free(messageJsonString);
-	free(tempPath);
-	free(messageRootPath);
-	free(referenceWildcard);
+	free(validatedSchemas);
 
 	return result;
-}
\ No newline at end of file
+}
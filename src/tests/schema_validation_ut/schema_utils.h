@@ -8,4 +8,23 @@ typedef enum _SchemaValidationResult {
     SCHEMA_VALIDATION_ERROR
 } SchemaValidationResult;
 
-SchemaValidationResult validate_schema(SyncQueue* eventQueue);
\ No newline at end of file
+/**
+ * The schema of an event which is owned by the agent, rather than published with the message schemas
+ */
+typedef struct _EventSchema {
+    const char* name;
+    const char* schema;
+    // the members of the event which are described by the schema, NULL terminated.
+    // they are taken out of the event and the rest of it is validated against the message schemas.
+    // NULL if the schema describes the whole event.
+    const char* const* members;
+} EventSchema;
+
+SchemaValidationResult validate_schema(SyncQueue* eventQueue);
+
+/**
+ * @brief Validates each event with one of the given names against its schema, and the rest of the message against the message schemas.
+ *        An event whose schema describes only some of its members is left in the message without them.
+ *        Fails if the message has no event of one of the given names.
+ */
+SchemaValidationResult validate_schema_with_event_schemas(SyncQueue* eventQueue, const EventSchema* eventSchemas, size_t eventSchemasCount);
@@ -14,6 +14,7 @@
 #include "twin_configuration.h"
 #include "collectors/user_login_collector.h"
 #include "collectors/agent_telemetry_collector.h"
+#include "collectors/collector_execution.h"
 #include "collectors/listening_ports_collector.h"
 #include "collectors/diagnostic_event_collector.h"
 #include "collectors/system_information_collector.h"
@@ -181,15 +182,105 @@ TEST_FUNCTION(SchemaValidation_Telemetry)
     counterData.failedMessages = 3;
     counterData.sentMessages = 4;
     counterData.smallMessages = 5;
+    counterData.sentBytes = 3000;
+    counterData.billedBytes = 4096;
+    counterData.reconnectAttempts = 1;
+    counterData.disconnectedTime = 2000;
+
+    MemoryConsumption consumption = {0};
+    consumption.queues = 6;
+    for (uint32_t tag = 0; tag < ALLOCATION_TAG_COUNT; ++tag) {
+        consumption.subsystems[tag] = 7 + tag;
+    }
+
+    EvictionCounter evictionCounter = {0};
+    CollectorStatistics statistics[COLLECTOR_COUNT] = {{0}};
 
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
     STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
     STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMessageCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counterData, sizeof(counterData));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&evictionCounter, sizeof(evictionCounter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMemoryConsumption(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_consumption(&consumption, sizeof(consumption));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_statistics(statistics, sizeof(statistics));
 
     SyncQueue queue;
     ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&queue, false));
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, AgentTelemetryCollector_GetEvents(&queue));
 
-    ASSERT_ARE_EQUAL(int, SCHEMA_VALIDATION_OK, validate_schema(&queue));
+    const EventSchema eventSchemas[] = {
+        { "MemoryConsumptionStatistics", "messageOperationalEventMemoryConsumptionStatistics_v1_0.json" },
+        { "MessageStatistics", "messageOperationalEventMessageStatistics_v1_1.json" }
+    };
+    ASSERT_ARE_EQUAL(int, SCHEMA_VALIDATION_OK, validate_schema_with_event_schemas(&queue, eventSchemas, sizeof(eventSchemas) / sizeof(eventSchemas[0])));
+
+    SyncQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(SchemaValidation_EvictedEvents)
+{
+    QueueCounter counter = {0};
+    MessageCounter counterData = {0};
+    MemoryConsumption consumption = {0};
+    CollectorStatistics statistics[COLLECTOR_COUNT] = {{0}};
+
+    EvictionCounter evictionCounter;
+    evictionCounter.lowPriority = 1;
+    evictionCounter.aggregated = 2;
+    evictionCounter.highPriority = 3;
+
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMessageCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counterData, sizeof(counterData));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&evictionCounter, sizeof(evictionCounter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMemoryConsumption(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_consumption(&consumption, sizeof(consumption));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_statistics(statistics, sizeof(statistics));
+
+    SyncQueue queue;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&queue, false));
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, AgentTelemetryCollector_GetEvents(&queue));
+
+    const EventSchema eventSchemas[] = {
+        { "EvictedEventsStatistics", "messageOperationalEventEvictedEventsStatistics_v1_0.json" },
+        { "MemoryConsumptionStatistics", "messageOperationalEventMemoryConsumptionStatistics_v1_0.json" },
+        { "MessageStatistics", "messageOperationalEventMessageStatistics_v1_1.json" }
+    };
+    ASSERT_ARE_EQUAL(int, SCHEMA_VALIDATION_OK, validate_schema_with_event_schemas(&queue, eventSchemas, sizeof(eventSchemas) / sizeof(eventSchemas[0])));
+
+    SyncQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(SchemaValidation_CollectorStatistics)
+{
+    QueueCounter counter = {0};
+    MessageCounter counterData = {0};
+    EvictionCounter evictionCounter = {0};
+    MemoryConsumption consumption = {0};
+
+    // a collector which ran, and one which was only skipped
+    CollectorStatistics statistics[COLLECTOR_COUNT] = {{0}};
+    statistics[COLLECTOR_LISTENING_PORTS].runs = 2;
+    statistics[COLLECTOR_LISTENING_PORTS].overruns = 1;
+    statistics[COLLECTOR_LISTENING_PORTS].totalDuration = 300;
+    statistics[COLLECTOR_LISTENING_PORTS].maxDuration = 200;
+    statistics[COLLECTOR_BASELINE].skipped = 1;
+
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMessageCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counterData, sizeof(counterData));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictionCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&evictionCounter, sizeof(evictionCounter));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMemoryConsumption(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_consumption(&consumption, sizeof(consumption));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetCollectorStatistics(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_statistics(statistics, sizeof(statistics));
+
+    SyncQueue queue;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&queue, false));
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, AgentTelemetryCollector_GetEvents(&queue));
+
+    const EventSchema eventSchemas[] = {
+        { "CollectorStatistics", "messageOperationalEventCollectorStatistics_v1_0.json" },
+        { "MemoryConsumptionStatistics", "messageOperationalEventMemoryConsumptionStatistics_v1_0.json" },
+        { "MessageStatistics", "messageOperationalEventMessageStatistics_v1_1.json" }
+    };
+    ASSERT_ARE_EQUAL(int, SCHEMA_VALIDATION_OK, validate_schema_with_event_schemas(&queue, eventSchemas, sizeof(eventSchemas) / sizeof(eventSchemas[0])));
 
     SyncQueue_Deinit(&queue);
 }
@@ -366,6 +457,45 @@ TEST_FUNCTION(SchemaValidation_Firewall)
     SyncQueue_Deinit(&queue);
 }
 
+TEST_FUNCTION(SchemaValidation_FirewallSplitSnapshot)
+{
+    // every rule is sent in a part of its own
+    ASSERT_ARE_EQUAL(int, TWIN_OK, TwinConfiguration_Update("{\"ms_iotn:urn_azureiot_Security_SecurityAgentConfiguration\":{\"maxMessageSizeInBytes\":{\"value\" :1100}}}", false));
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesIterator_GetNext, MockIptablesIterator_GetNext);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesRulesIterator_GetNext, MockIptablesRulesIterator_GetNext);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesRulesIterator_GetChainName, MockIptablesRulesIterator_GetChainName);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesIterator_GetChainName, MockIptablesIterator_GetChainName);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesIterator_GetPolicyAction, MockIptablesIterator_GetPolicyAction);
+
+    SyncQueue queue;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&queue, false));
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, FirewallCollector_GetEvents(&queue));
+
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesIterator_GetNext, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesRulesIterator_GetNext, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesRulesIterator_GetChainName, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesIterator_GetChainName, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(IptablesIterator_GetPolicyAction, NULL);
+
+    // the parts are validated in a single message
+    ASSERT_ARE_EQUAL(int, TWIN_OK, TwinConfiguration_Update("{\"ms_iotn:urn_azureiot_Security_SecurityAgentConfiguration\":{}}", false));
+
+    uint32_t partsCount = 0;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_GetSize(&queue, &partsCount));
+    ASSERT_IS_TRUE(partsCount > 1);
+
+    const char* const snapshotMembers[] = { "SnapshotId", "SnapshotPart", "SnapshotParts", NULL };
+    const EventSchema eventSchemas[] = {
+        { "FirewallConfiguration", "messageEventSnapshotPart_v1_0.json", snapshotMembers }
+    };
+    ASSERT_ARE_EQUAL(int, SCHEMA_VALIDATION_OK, validate_schema_with_event_schemas(&queue, eventSchemas, sizeof(eventSchemas) / sizeof(eventSchemas[0])));
+
+    SyncQueue_Deinit(&queue);
+}
+
 int UsersIteratorPosition = 0;
 UserIteratorResults MockUsersIterator_GetNext(UsersIteratorHandle iterator) 
 {
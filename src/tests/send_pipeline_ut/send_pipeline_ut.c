@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+
+#define ENABLE_MOCKS
+#include "internal/time_utils.h"
+#include "iothub_adapter.h"
+#undef ENABLE_MOCKS
+
+#include "consts.h"
+#include "send_pipeline.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static SendPipeline pipeline;
+static IoTHubAdapter adapter;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static time_t mockedCurrentTime = 0;
+
+time_t Mocked_TimeUtils_GetCurrentTime() {
+    return mockedCurrentTime;
+}
+
+int32_t Mocked_TimeUtils_GetTimeDiff(time_t end, time_t beginning) {
+    return (int32_t)(end - beginning) * 1000;
+}
+
+static bool mockedSendResult = true;
+static uint32_t mockedSendCount = 0;
+static IoTHubAdapterSendConfirmation lastConfirmationCallback = NULL;
+static void* lastConfirmationContext = NULL;
+
+bool Mocked_IoTHubAdapter_SendMessageWithConfirmationAsync(IoTHubAdapter* iothubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding, IoTHubAdapterSendConfirmation confirmationCallback, void* context) {
+    ++mockedSendCount;
+    lastConfirmationCallback = confirmationCallback;
+    lastConfirmationContext = context;
+    return mockedSendResult;
+}
+
+static void ConfirmLastMessage(bool confirmed) {
+    ASSERT_IS_NOT_NULL(lastConfirmationCallback);
+    lastConfirmationCallback(confirmed, lastConfirmationContext);
+}
+
+BEGIN_TEST_SUITE(send_pipeline_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+    (void)umocktypes_stdint_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(IoTHubAdapterSendConfirmation, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(TimeUtils_GetCurrentTime, Mocked_TimeUtils_GetCurrentTime);
+    REGISTER_GLOBAL_MOCK_HOOK(TimeUtils_GetTimeDiff, Mocked_TimeUtils_GetTimeDiff);
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubAdapter_SendMessageWithConfirmationAsync, Mocked_IoTHubAdapter_SendMessageWithConfirmationAsync);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    REGISTER_GLOBAL_MOCK_HOOK(TimeUtils_GetCurrentTime, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TimeUtils_GetTimeDiff, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(IoTHubAdapter_SendMessageWithConfirmationAsync, NULL);
+
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    mockedCurrentTime = 100;
+    mockedSendResult = true;
+    mockedSendCount = 0;
+    lastConfirmationCallback = NULL;
+    lastConfirmationContext = NULL;
+    ASSERT_IS_TRUE(SendPipeline_Init(&pipeline, &adapter));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    SendPipeline_Deinit(&pipeline);
+}
+
+TEST_FUNCTION(SendPipeline_SendConfirmed_ExpectSlotReleased)
+{
+    ASSERT_ARE_EQUAL(int, SEND_PIPELINE_OK, SendPipeline_Send(&pipeline, strdup("a"), 1, NULL, NULL));
+    ASSERT_ARE_EQUAL(uint32_t, 1, mockedSendCount);
+    ASSERT_IS_FALSE(SendPipeline_HasRoom(&pipeline, 1));
+    ASSERT_IS_TRUE(SendPipeline_HasRoom(&pipeline, 2));
+
+    ConfirmLastMessage(true);
+
+    ASSERT_IS_TRUE(SendPipeline_HasRoom(&pipeline, 1));
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, SendPipeline_GetRetryTimeout(&pipeline, mockedCurrentTime));
+}
+
+TEST_FUNCTION(SendPipeline_SendNotConfirmed_ExpectRetriedWithBackoff)
+{
+    ASSERT_ARE_EQUAL(int, SEND_PIPELINE_OK, SendPipeline_Send(&pipeline, strdup("a"), 1, NULL, NULL));
+    ConfirmLastMessage(false);
+
+    // the message is kept until its retry
+    ASSERT_IS_FALSE(SendPipeline_HasRoom(&pipeline, 1));
+    ASSERT_ARE_EQUAL(uint32_t, SEND_RETRY_INITIAL_INTERVAL, SendPipeline_GetRetryTimeout(&pipeline, mockedCurrentTime));
+
+    SendPipeline_Retry(&pipeline, mockedCurrentTime);
+    ASSERT_ARE_EQUAL(uint32_t, 1, mockedSendCount);
+
+    mockedCurrentTime += SEND_RETRY_INITIAL_INTERVAL / 1000;
+    SendPipeline_Retry(&pipeline, mockedCurrentTime);
+    ASSERT_ARE_EQUAL(uint32_t, 2, mockedSendCount);
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, SendPipeline_GetRetryTimeout(&pipeline, mockedCurrentTime));
+
+    // the interval doubles on every failure
+    ConfirmLastMessage(false);
+    ASSERT_ARE_EQUAL(uint32_t, 2 * SEND_RETRY_INITIAL_INTERVAL, SendPipeline_GetRetryTimeout(&pipeline, mockedCurrentTime));
+}
+
+TEST_FUNCTION(SendPipeline_AdapterFails_ExpectMessageDeferred)
+{
+    mockedSendResult = false;
+    ASSERT_ARE_EQUAL(int, SEND_PIPELINE_DEFERRED, SendPipeline_Send(&pipeline, strdup("a"), 1, NULL, NULL));
+    ASSERT_ARE_EQUAL(uint32_t, SEND_RETRY_INITIAL_INTERVAL, SendPipeline_GetRetryTimeout(&pipeline, mockedCurrentTime));
+
+    mockedSendResult = true;
+    mockedCurrentTime += SEND_RETRY_INITIAL_INTERVAL / 1000;
+    SendPipeline_Retry(&pipeline, mockedCurrentTime);
+    ASSERT_ARE_EQUAL(uint32_t, 2, mockedSendCount);
+
+    ConfirmLastMessage(true);
+    ASSERT_IS_TRUE(SendPipeline_HasRoom(&pipeline, 1));
+}
+
+TEST_FUNCTION(SendPipeline_MaxAttemptsFailed_ExpectMessageDropped)
+{
+    ASSERT_ARE_EQUAL(int, SEND_PIPELINE_OK, SendPipeline_Send(&pipeline, strdup("a"), 1, NULL, NULL));
+    for (uint32_t i = 1; i < SEND_MAX_ATTEMPTS; ++i) {
+        ConfirmLastMessage(false);
+        mockedCurrentTime += SEND_RETRY_MAX_INTERVAL / 1000;
+        SendPipeline_Retry(&pipeline, mockedCurrentTime);
+    }
+    ASSERT_ARE_EQUAL(uint32_t, SEND_MAX_ATTEMPTS, mockedSendCount);
+
+    ConfirmLastMessage(false);
+
+    ASSERT_IS_TRUE(SendPipeline_HasRoom(&pipeline, 1));
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, SendPipeline_GetRetryTimeout(&pipeline, mockedCurrentTime));
+}
+
+TEST_FUNCTION(SendPipeline_SendWindowFull_ExpectFull)
+{
+    for (uint32_t i = 0; i < SEND_PIPELINE_MAX_WINDOW; ++i) {
+        ASSERT_ARE_EQUAL(int, SEND_PIPELINE_OK, SendPipeline_Send(&pipeline, strdup("a"), 1, NULL, NULL));
+    }
+
+    // the window is capped to the slots of the pipeline
+    ASSERT_IS_FALSE(SendPipeline_HasRoom(&pipeline, SEND_PIPELINE_MAX_WINDOW + 1));
+    ASSERT_ARE_EQUAL(int, SEND_PIPELINE_FULL, SendPipeline_Send(&pipeline, NULL, 1, NULL, NULL));
+}
+
+END_TEST_SUITE(send_pipeline_ut)
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "slab_allocator.h"
+#include <stdint.h>
+#include <string.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(slab_allocator_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    SlabAllocator_Deinit();
+}
+
+TEST_FUNCTION(SlabAllocator_GetBlockSize_ExpectSmallestFittingClass)
+{
+    ASSERT_ARE_EQUAL(int, 64, SlabAllocator_GetBlockSize(1));
+    ASSERT_ARE_EQUAL(int, 64, SlabAllocator_GetBlockSize(64));
+    ASSERT_ARE_EQUAL(int, 128, SlabAllocator_GetBlockSize(65));
+    ASSERT_ARE_EQUAL(int, SLAB_ALLOCATOR_MAX_BLOCK_SIZE, SlabAllocator_GetBlockSize(SLAB_ALLOCATOR_MAX_BLOCK_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, SlabAllocator_GetBlockSize(SLAB_ALLOCATOR_MAX_BLOCK_SIZE + 1));
+}
+
+TEST_FUNCTION(SlabAllocator_AllocateAndFree_ExpectBlockReused)
+{
+    char* first = SlabAllocator_Allocate(100);
+    ASSERT_IS_NOT_NULL(first);
+    memset(first, 'a', 100);
+
+    char* second = SlabAllocator_Allocate(100);
+    ASSERT_IS_NOT_NULL(second);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, first, second);
+
+    SlabAllocator_Free(first);
+    char* third = SlabAllocator_Allocate(128);
+    ASSERT_ARE_EQUAL(void_ptr, first, third);
+
+    SlabAllocator_Free(second);
+    SlabAllocator_Free(third);
+}
+
+TEST_FUNCTION(SlabAllocator_AllocateMoreThanOneSlab_ExpectSuccess)
+{
+    uint32_t blocksPerSlab = SLAB_ALLOCATOR_SLAB_SIZE / SLAB_ALLOCATOR_MAX_BLOCK_SIZE;
+    void* blocks[3 * (SLAB_ALLOCATOR_SLAB_SIZE / SLAB_ALLOCATOR_MAX_BLOCK_SIZE)];
+
+    for (uint32_t i = 0; i < 3 * blocksPerSlab; ++i) {
+        blocks[i] = SlabAllocator_Allocate(SLAB_ALLOCATOR_MAX_BLOCK_SIZE);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+        memset(blocks[i], 0, SLAB_ALLOCATOR_MAX_BLOCK_SIZE);
+    }
+
+    for (uint32_t i = 0; i < 3 * blocksPerSlab; ++i) {
+        SlabAllocator_Free(blocks[i]);
+    }
+}
+
+TEST_FUNCTION(SlabAllocator_FreeAllBlocksOfSlab_ExpectSlabReleasedAndReused)
+{
+    uint32_t blocksPerSlab = SLAB_ALLOCATOR_SLAB_SIZE / SLAB_ALLOCATOR_MAX_BLOCK_SIZE;
+    void* blocks[2 * (SLAB_ALLOCATOR_SLAB_SIZE / SLAB_ALLOCATOR_MAX_BLOCK_SIZE)];
+
+    for (uint32_t i = 0; i < 2 * blocksPerSlab; ++i) {
+        blocks[i] = SlabAllocator_Allocate(SLAB_ALLOCATOR_MAX_BLOCK_SIZE);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+        memset(blocks[i], 'a', SLAB_ALLOCATOR_MAX_BLOCK_SIZE);
+    }
+
+    // the first slab is kept for its class, the second one is released once it is empty
+    for (uint32_t i = 0; i < 2 * blocksPerSlab; ++i) {
+        SlabAllocator_Free(blocks[i]);
+    }
+
+    void* foundBlock = NULL;
+    uint32_t blockSize = 0;
+    ASSERT_IS_FALSE(SlabAllocator_GetBlock(blocks[blocksPerSlab], &foundBlock, &blockSize));
+
+    // the released slab is taken by another class, its memory was returned zero filled
+    char* block = SlabAllocator_Allocate(64);
+    ASSERT_ARE_EQUAL(void_ptr, blocks[blocksPerSlab], block);
+    ASSERT_ARE_EQUAL(int, 0, block[0]);
+    ASSERT_IS_TRUE(SlabAllocator_GetBlock(block + 1, &foundBlock, &blockSize));
+    ASSERT_ARE_EQUAL(int, 64, blockSize);
+
+    SlabAllocator_Free(block);
+}
+
+TEST_FUNCTION(SlabAllocator_AllocateAllSlabs_ExpectNull)
+{
+    uint32_t blocksPerSlab = SLAB_ALLOCATOR_SLAB_SIZE / SLAB_ALLOCATOR_MAX_BLOCK_SIZE;
+    uint32_t numberOfBlocks = SLAB_ALLOCATOR_MAX_SLABS * blocksPerSlab;
+    void** blocks = malloc(numberOfBlocks * sizeof(void*));
+    ASSERT_IS_NOT_NULL(blocks);
+
+    for (uint32_t i = 0; i < numberOfBlocks; ++i) {
+        blocks[i] = SlabAllocator_Allocate(SLAB_ALLOCATOR_MAX_BLOCK_SIZE);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+    }
+    ASSERT_IS_NULL(SlabAllocator_Allocate(1));
+
+    for (uint32_t i = 0; i < numberOfBlocks; ++i) {
+        SlabAllocator_Free(blocks[i]);
+    }
+    free(blocks);
+}
+
+TEST_FUNCTION(SlabAllocator_AllocateTooBig_ExpectNull)
+{
+    ASSERT_IS_NULL(SlabAllocator_Allocate(SLAB_ALLOCATOR_MAX_BLOCK_SIZE + 1));
+}
+
+TEST_FUNCTION(SlabAllocator_AllocateNotInitiated_ExpectNull)
+{
+    SlabAllocator_Deinit();
+    ASSERT_IS_NULL(SlabAllocator_Allocate(1));
+    ASSERT_IS_TRUE(SlabAllocator_Init());
+}
+
+TEST_FUNCTION(SlabAllocator_GetBlock_ExpectContainingBlock)
+{
+    char* block = SlabAllocator_Allocate(200);
+    ASSERT_IS_NOT_NULL(block);
+
+    void* foundBlock = NULL;
+    uint32_t blockSize = 0;
+    ASSERT_IS_TRUE(SlabAllocator_GetBlock(block + 17, &foundBlock, &blockSize));
+    ASSERT_ARE_EQUAL(void_ptr, block, foundBlock);
+    ASSERT_ARE_EQUAL(int, 256, blockSize);
+
+    SlabAllocator_Free(block);
+}
+
+TEST_FUNCTION(SlabAllocator_GetBlockOfForeignAddress_ExpectFalse)
+{
+    char* block = SlabAllocator_Allocate(64);
+    ASSERT_IS_NOT_NULL(block);
+
+    char* foreign = malloc(64);
+    void* foundBlock = NULL;
+    uint32_t blockSize = 0;
+    ASSERT_IS_FALSE(SlabAllocator_GetBlock(foreign, &foundBlock, &blockSize));
+
+    free(foreign);
+    SlabAllocator_Free(block);
+}
+
+END_TEST_SUITE(slab_allocator_ut)
@@ -0,0 +1,283 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/uniqueid.h"
+#include "internal/time_utils.h"
+#include "local_config.h"
+#include "synchronized_queue.h"
+#include "twin_configuration.h"
+#undef ENABLE_MOCKS
+
+#include "collectors/snapshot_event.h"
+#include "consts.h"
+#include "message_schema_consts.h"
+#include "parson.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+#define MAX_PUSHED_EVENTS 512
+
+static char* pushedEvents[MAX_PUSHED_EVENTS];
+static uint32_t pushedEventSizes[MAX_PUSHED_EVENTS];
+static uint32_t pushedEventsCount = 0;
+static int pushBackResult = QUEUE_OK;
+static uint32_t maxMessageSize = 0;
+static uint32_t generatedIds = 0;
+
+int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
+    if (pushBackResult != QUEUE_OK) {
+        return pushBackResult;
+    }
+
+    ASSERT_IS_TRUE(pushedEventsCount < MAX_PUSHED_EVENTS);
+    pushedEvents[pushedEventsCount] = data;
+    pushedEventSizes[pushedEventsCount] = dataSize;
+    pushedEventsCount++;
+    return QUEUE_OK;
+}
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* size) {
+    *size = maxMessageSize;
+    return TWIN_OK;
+}
+
+UNIQUEID_RESULT Mocked_UniqueId_Generate(char* uid, size_t len) {
+    ASSERT_ARE_EQUAL(int, 37, len);
+    snprintf(uid, len, "00000000-0000-0000-0000-%012u", ++generatedIds);
+    return UNIQUEID_OK;
+}
+
+static void FreePushedEvents() {
+    for (uint32_t i = 0; i < pushedEventsCount; i++) {
+        free(pushedEvents[i]);
+    }
+    pushedEventsCount = 0;
+}
+
+/**
+ * Creates a baseline event with the given number of failed checks.
+ */
+static void CreateBaselineSnapshot(uint32_t checksCount, uint32_t descriptionSize, JsonObjectWriterHandle* eventWriter, JsonArrayWriterHandle* payloadWriter) {
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_Init(eventWriter));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_CATEGORY_KEY, EVENT_PERIODIC_CATEGORY));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_TYPE_KEY, EVENT_TYPE_SECURITY_VALUE));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_NAME_KEY, BASELINE_NAME));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_PAYLOAD_SCHEMA_VERSION_KEY, BASELINE_PAYLOAD_SCHEMA_VERSION));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_ID_KEY, "id"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_LOCAL_TIMESTAMP_KEY, "2019-03-04T12:00:00Z"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(*eventWriter, EVENT_UTC_TIMESTAMP_KEY, "2019-03-04T10:00:00Z"));
+
+    char* description = malloc(descriptionSize + 1);
+    ASSERT_IS_NOT_NULL(description);
+    memset(description, 'd', descriptionSize);
+    description[descriptionSize] = '\0';
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonArrayWriter_Init(payloadWriter));
+    for (uint32_t i = 0; i < checksCount; i++) {
+        char cceId[32];
+        snprintf(cceId, sizeof(cceId), "CCE-%u", i);
+
+        JsonObjectWriterHandle check = NULL;
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_Init(&check));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(check, BASELINE_RESULT_KEY, "FAIL"));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(check, BASELINE_DESCRIPTION_KEY, description));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(check, BASELINE_CCEID_KEY, cceId));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(check, BASELINE_ERROR_KEY, "File does not exist"));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_WriteString(check, BASELINE_SEVERITY_KEY, "Critical"));
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonArrayWriter_AddObject(*payloadWriter, check));
+        JsonObjectWriter_Deinit(check);
+    }
+
+    free(description);
+}
+
+/**
+ * Checks the pushed events are the parts of a single snapshot, and returns the number of the items in them.
+ */
+static uint32_t AssertSnapshotParts(uint32_t maxPartSize) {
+    char snapshotId[37] = "";
+    uint32_t itemsCount = 0;
+
+    for (uint32_t part = 0; part < pushedEventsCount; part++) {
+        JSON_Value* partValue = json_parse_string(pushedEvents[part]);
+        ASSERT_IS_NOT_NULL(partValue);
+        JSON_Object* partObject = json_value_get_object(partValue);
+
+        if (maxPartSize > 0) {
+            ASSERT_IS_TRUE(pushedEventSizes[part] <= maxPartSize);
+        }
+        ASSERT_ARE_EQUAL(char_ptr, BASELINE_NAME, json_object_get_string(partObject, EVENT_NAME_KEY));
+        if (part == 0) {
+            strcpy(snapshotId, json_object_get_string(partObject, EVENT_SNAPSHOT_ID_KEY));
+        }
+        ASSERT_ARE_EQUAL(char_ptr, snapshotId, json_object_get_string(partObject, EVENT_SNAPSHOT_ID_KEY));
+        ASSERT_ARE_NOT_EQUAL(char_ptr, snapshotId, json_object_get_string(partObject, EVENT_ID_KEY));
+        ASSERT_ARE_EQUAL(int, part, (uint32_t)json_object_get_number(partObject, EVENT_SNAPSHOT_PART_KEY));
+        ASSERT_ARE_EQUAL(int, pushedEventsCount, (uint32_t)json_object_get_number(partObject, EVENT_SNAPSHOT_PARTS_KEY));
+        ASSERT_IS_FALSE(json_object_get_boolean(partObject, EVENT_IS_EMPTY_KEY));
+
+        // the items are kept in order
+        JSON_Array* payload = json_object_get_array(partObject, PAYLOAD_KEY);
+        ASSERT_IS_TRUE(json_array_get_count(payload) > 0);
+        for (uint32_t i = 0; i < json_array_get_count(payload); i++) {
+            char cceId[32];
+            snprintf(cceId, sizeof(cceId), "CCE-%u", itemsCount++);
+            ASSERT_ARE_EQUAL(char_ptr, cceId, json_object_get_string(json_array_get_object(payload, i), BASELINE_CCEID_KEY));
+        }
+
+        json_value_free(partValue);
+    }
+
+    return itemsCount;
+}
+
+BEGIN_TEST_SUITE(snapshot_event_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+    umocktypes_charptr_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(UNIQUEID_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(EventEncoding, int);
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, Mocked_SyncQueue_PushBack);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, Mocked_TwinConfiguration_GetMaxMessageSize);
+    REGISTER_GLOBAL_MOCK_HOOK(UniqueId_Generate, Mocked_UniqueId_Generate);
+    REGISTER_GLOBAL_MOCK_RETURN(LocalConfiguration_GetEventEncoding, EVENT_ENCODING_JSON);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    REGISTER_GLOBAL_MOCK_HOOK(UniqueId_Generate, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, NULL);
+
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    pushedEventsCount = 0;
+    pushBackResult = QUEUE_OK;
+    maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE;
+    generatedIds = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    FreePushedEvents();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(SnapshotEvent_PushBackSnapshotFitsInMessage_ExpectEventAsIs)
+{
+    JsonObjectWriterHandle eventWriter = NULL;
+    JsonArrayWriterHandle payloadWriter = NULL;
+    CreateBaselineSnapshot(2, 4, &eventWriter, &payloadWriter);
+
+    EventCollectorResult result = SnapshotEvent_PushBack((SyncQueue*)0x1, eventWriter, payloadWriter);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, pushedEventsCount);
+    ASSERT_ARE_EQUAL(char_ptr,
+        "{\"Category\":\"Periodic\",\"EventType\":\"Security\",\"Name\":\"OSBaseline\",\"PayloadSchemaVersion\":\"1.0\",\"Id\":\"id\","
+        "\"TimestampLocal\":\"2019-03-04T12:00:00Z\",\"TimestampUTC\":\"2019-03-04T10:00:00Z\",\"IsEmpty\":false,\"Payload\":["
+        "{\"Result\":\"FAIL\",\"Description\":\"dddd\",\"CceId\":\"CCE-0\",\"Error\":\"File does not exist\",\"Severity\":\"Critical\"},"
+        "{\"Result\":\"FAIL\",\"Description\":\"dddd\",\"CceId\":\"CCE-1\",\"Error\":\"File does not exist\",\"Severity\":\"Critical\"}]}",
+        pushedEvents[0]);
+    ASSERT_ARE_EQUAL(int, strlen(pushedEvents[0]), pushedEventSizes[0]);
+
+    JsonArrayWriter_Deinit(payloadWriter);
+    JsonObjectWriter_Deinit(eventWriter);
+}
+
+TEST_FUNCTION(SnapshotEvent_PushBackMultiMegabyteBaseline_ExpectPartsWhichFitInMessage)
+{
+    // about 4mb of baseline output, the snapshot which used to block the queue
+    JsonObjectWriterHandle eventWriter = NULL;
+    JsonArrayWriterHandle payloadWriter = NULL;
+    CreateBaselineSnapshot(20000, 100, &eventWriter, &payloadWriter);
+
+    EventCollectorResult result = SnapshotEvent_PushBack((SyncQueue*)0x1, eventWriter, payloadWriter);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_IS_TRUE(pushedEventsCount > 16);
+    ASSERT_ARE_EQUAL(int, 20000, AssertSnapshotParts(DEFAULT_MAX_MESSAGE_SIZE - MESSAGE_ENVELOPE_RESERVED_SIZE));
+
+    // the parts are packed, a part and the first item of the next one do not fit together
+    ASSERT_IS_TRUE(pushedEventSizes[0] + 200 > DEFAULT_MAX_MESSAGE_SIZE - MESSAGE_ENVELOPE_RESERVED_SIZE);
+
+    JsonArrayWriter_Deinit(payloadWriter);
+    JsonObjectWriter_Deinit(eventWriter);
+}
+
+TEST_FUNCTION(SnapshotEvent_PushBackItemLargerThanMessage_ExpectPartOfItsOwn)
+{
+    maxMessageSize = 4 * 1024;
+    JsonObjectWriterHandle eventWriter = NULL;
+    JsonArrayWriterHandle payloadWriter = NULL;
+    CreateBaselineSnapshot(3, 2 * 1024, &eventWriter, &payloadWriter);
+
+    EventCollectorResult result = SnapshotEvent_PushBack((SyncQueue*)0x1, eventWriter, payloadWriter);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(int, 3, pushedEventsCount);
+    ASSERT_ARE_EQUAL(int, 3, AssertSnapshotParts(0));
+
+    JsonArrayWriter_Deinit(payloadWriter);
+    JsonObjectWriter_Deinit(eventWriter);
+}
+
+TEST_FUNCTION(SnapshotEvent_PushBackQueueFailed_ExpectFailure)
+{
+    maxMessageSize = 4 * 1024;
+    pushBackResult = QUEUE_MAX_MEMORY_EXCEEDED;
+    JsonObjectWriterHandle eventWriter = NULL;
+    JsonArrayWriterHandle payloadWriter = NULL;
+    CreateBaselineSnapshot(100, 100, &eventWriter, &payloadWriter);
+
+    EventCollectorResult result = SnapshotEvent_PushBack((SyncQueue*)0x1, eventWriter, payloadWriter);
+
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(int, 0, pushedEventsCount);
+
+    JsonArrayWriter_Deinit(payloadWriter);
+    JsonObjectWriter_Deinit(eventWriter);
+}
+
+END_TEST_SUITE(snapshot_event_ut)
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "os_utils/spill_log.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static char testDirectory[] = "/tmp/spill_log_ut_XXXXXX";
+static SpillLog spillLog;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static uint32_t CountSegmentFiles() {
+    uint32_t count = 0;
+    DIR* directory = opendir(testDirectory);
+    ASSERT_IS_NOT_NULL(directory);
+    struct dirent* entry = NULL;
+    while ((entry = readdir(directory)) != NULL) {
+        if (strncmp(entry->d_name, "segment_", strlen("segment_")) == 0) {
+            ++count;
+        }
+    }
+    closedir(directory);
+    return count;
+}
+
+static void RemoveSegmentFiles() {
+    DIR* directory = opendir(testDirectory);
+    ASSERT_IS_NOT_NULL(directory);
+    struct dirent* entry = NULL;
+    while ((entry = readdir(directory)) != NULL) {
+        if (strncmp(entry->d_name, "segment_", strlen("segment_")) == 0) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s", testDirectory, entry->d_name);
+            unlink(path);
+        }
+    }
+    closedir(directory);
+}
+
+static void AssertNextRecord(const char* expected) {
+    const void* data = NULL;
+    uint32_t dataSize = 0;
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Peek(&spillLog, &data, &dataSize));
+    ASSERT_ARE_EQUAL(int, strlen(expected), dataSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, data, dataSize));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Consume(&spillLog));
+}
+
+BEGIN_TEST_SUITE(spill_log_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+
+    ASSERT_IS_NOT_NULL(mkdtemp(testDirectory));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    rmdir(testDirectory);
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Init(&spillLog, testDirectory, 2 * SPILL_LOG_SEGMENT_SIZE));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    SpillLog_Deinit(&spillLog);
+    RemoveSegmentFiles();
+}
+
+TEST_FUNCTION(SpillLog_PeekEmpty_ExpectIsEmpty)
+{
+    const void* data = NULL;
+    uint32_t dataSize = 0;
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_IS_EMPTY, SpillLog_Peek(&spillLog, &data, &dataSize));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_IS_EMPTY, SpillLog_Consume(&spillLog));
+    ASSERT_ARE_EQUAL(int, 0, SpillLog_GetSize(&spillLog));
+}
+
+TEST_FUNCTION(SpillLog_AppendAndConsume_ExpectFifoAndSegmentRemoved)
+{
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "first", 5));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "second", 6));
+    ASSERT_ARE_EQUAL(int, 2, SpillLog_GetSize(&spillLog));
+    ASSERT_ARE_EQUAL(int, 1, CountSegmentFiles());
+
+    AssertNextRecord("first");
+    AssertNextRecord("second");
+
+    ASSERT_ARE_EQUAL(int, 0, SpillLog_GetSize(&spillLog));
+    ASSERT_ARE_EQUAL(int, 0, CountSegmentFiles());
+}
+
+TEST_FUNCTION(SpillLog_Reinit_ExpectUnconsumedRecordsReloaded)
+{
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "first", 5));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "second", 6));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "third", 5));
+    AssertNextRecord("first");
+
+    SpillLog_Deinit(&spillLog);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Init(&spillLog, testDirectory, 2 * SPILL_LOG_SEGMENT_SIZE));
+
+    ASSERT_ARE_EQUAL(int, 2, SpillLog_GetSize(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "fourth", 6));
+    AssertNextRecord("second");
+    AssertNextRecord("third");
+    AssertNextRecord("fourth");
+}
+
+TEST_FUNCTION(SpillLog_CorruptedRecord_ExpectLogEndsBeforeIt)
+{
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "first", 5));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "second", 6));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, "third", 5));
+
+    // flip a byte of the second record, each record is a 16 bytes header followed by its data rounded up to 8 bytes
+    char* secondRecordData = spillLog.segments[0].base + 24 + 16;
+    ASSERT_ARE_EQUAL(int, 0, memcmp("second", secondRecordData, 6));
+    secondRecordData[0] = 'S';
+
+    SpillLog_Deinit(&spillLog);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Init(&spillLog, testDirectory, 2 * SPILL_LOG_SEGMENT_SIZE));
+
+    ASSERT_ARE_EQUAL(int, 1, SpillLog_GetSize(&spillLog));
+    AssertNextRecord("first");
+}
+
+TEST_FUNCTION(SpillLog_AppendBeyondQuota_ExpectQuotaExceeded)
+{
+    static char record[SPILL_LOG_SEGMENT_SIZE / 4];
+    memset(record, 'a', sizeof(record));
+
+    // each segment holds three records since every record carries a header
+    uint32_t appended = 0;
+    while (SpillLog_Append(&spillLog, record, sizeof(record)) == SPILL_LOG_OK) {
+        ++appended;
+    }
+    ASSERT_ARE_EQUAL(int, 6, appended);
+    ASSERT_ARE_EQUAL(int, 2, CountSegmentFiles());
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_QUOTA_EXCEEDED, SpillLog_Append(&spillLog, record, sizeof(record)));
+
+    // draining the oldest segment frees its quota
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Consume(&spillLog));
+    }
+    ASSERT_ARE_EQUAL(int, 1, CountSegmentFiles());
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, record, sizeof(record)));
+}
+
+TEST_FUNCTION(SpillLog_AppendBiggerThanSegment_ExpectQuotaExceeded)
+{
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_QUOTA_EXCEEDED, SpillLog_Append(&spillLog, "", SPILL_LOG_SEGMENT_SIZE));
+}
+
+TEST_FUNCTION(SpillLog_InitNestedDirectory_ExpectParentsCreated)
+{
+    char nestedDirectory[256];
+    char parentDirectory[256];
+    snprintf(parentDirectory, sizeof(parentDirectory), "%s/parent", testDirectory);
+    snprintf(nestedDirectory, sizeof(nestedDirectory), "%s/child", parentDirectory);
+
+    SpillLog nestedSpillLog;
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Init(&nestedSpillLog, nestedDirectory, SPILL_LOG_SEGMENT_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, access(nestedDirectory, W_OK));
+    SpillLog_Deinit(&nestedSpillLog);
+
+    ASSERT_ARE_EQUAL(int, 0, rmdir(nestedDirectory));
+    ASSERT_ARE_EQUAL(int, 0, rmdir(parentDirectory));
+}
+
+END_TEST_SUITE(spill_log_ut)
@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "azure_c_shared_utility/threadapi.h"
+#include "memory_monitor.h"
+#include "synchronized_queue.h"
+#include "twin_configuration.h"
+
+#define BENCHMARK_ITEMS_PER_PRODUCER 200000
+#define BENCHMARK_RING_CAPACITY 4096
+#define BENCHMARK_MAX_PRODUCERS 8
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+static const uint32_t producerCounts[] = { 1, 2, 4, BENCHMARK_MAX_PRODUCERS };
+
+// the queues never own the pushed payload in this benchmark
+static char benchmarkPayload[64];
+
+typedef struct _BenchmarkContext {
+
+    SyncQueue* queue;
+    uint32_t itemsPerProducer;
+    uint32_t retries;
+
+} BenchmarkContext;
+
+typedef struct _BenchmarkResult {
+
+    double itemsPerSecond;
+    uint32_t retries;
+
+} BenchmarkResult;
+
+// the memory monitor asks for the cache limit on each push, the benchmark measures the queues only
+TwinConfigurationResult TwinConfiguration_GetMaxLocalCacheSize(uint32_t* maxLocalCacheSize) {
+    *maxLocalCacheSize = UINT32_MAX;
+    return TWIN_OK;
+}
+
+static double Benchmark_Now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int Benchmark_Producer(void* param) {
+    BenchmarkContext* context = (BenchmarkContext*)param;
+
+    for (uint32_t i = 0; i < context->itemsPerProducer; ++i) {
+        // a bounded queue rejects pushes while full, wait for the consumer to catch up
+        while (SyncQueue_PushBack(context->queue, benchmarkPayload, sizeof(benchmarkPayload)) != QUEUE_OK) {
+            __atomic_add_fetch(&context->retries, 1, __ATOMIC_RELAXED);
+            sched_yield();
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Runs the given number of producers against a single consumer which drains the queue on the calling thread,
+ *        either one item at a time or in batches.
+ */
+static BenchmarkResult Benchmark_Run(SyncQueue* queue, uint32_t producers, bool batched) {
+    BenchmarkContext context = { queue, BENCHMARK_ITEMS_PER_PRODUCER, 0 };
+    THREAD_HANDLE threads[BENCHMARK_MAX_PRODUCERS];
+    uint32_t total = producers * BENCHMARK_ITEMS_PER_PRODUCER;
+    uint32_t received = 0;
+
+    double start = Benchmark_Now();
+    for (uint32_t i = 0; i < producers; ++i) {
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&threads[i], Benchmark_Producer, &context));
+    }
+
+    while (received < total) {
+        void* data = NULL;
+        uint32_t dataSize = 0;
+        int result;
+        if (batched) {
+            SyncQueueBatch batch;
+            result = SyncQueue_PopBatchIf(queue, NULL, NULL, UINT32_MAX, &batch);
+            while (result == QUEUE_OK && SyncQueue_BatchPopFront(&batch, &data, &dataSize) == QUEUE_OK) {
+                ASSERT_ARE_EQUAL(void_ptr, benchmarkPayload, data);
+                ++received;
+            }
+        } else {
+            result = SyncQueue_PopFront(queue, &data, &dataSize);
+            if (result == QUEUE_OK) {
+                ASSERT_ARE_EQUAL(void_ptr, benchmarkPayload, data);
+                ++received;
+            }
+        }
+
+        if (result != QUEUE_OK) {
+            ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+            sched_yield();
+        }
+    }
+    double elapsed = Benchmark_Now() - start;
+
+    for (uint32_t i = 0; i < producers; ++i) {
+        int threadResult;
+        ThreadAPI_Join(threads[i], &threadResult);
+    }
+
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_GetSize(queue, &size));
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    BenchmarkResult result = { total / elapsed, context.retries };
+    return result;
+}
+
+BEGIN_TEST_SUITE(sync_queue_benchmark_int)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+    ASSERT_IS_TRUE(MemoryMonitor_Init());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    MemoryMonitor_Deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION(SyncQueue_ContendedPushPop_ListVersusRing)
+{
+    for (uint32_t i = 0; i < sizeof(producerCounts) / sizeof(producerCounts[0]); ++i) {
+        SyncQueue listQueue;
+        SyncQueue ringQueue;
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&listQueue, false));
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRing(&ringQueue, false, BENCHMARK_RING_CAPACITY));
+
+        BenchmarkResult listResult = Benchmark_Run(&listQueue, producerCounts[i], false);
+        BenchmarkResult listBatchResult = Benchmark_Run(&listQueue, producerCounts[i], true);
+        BenchmarkResult ringResult = Benchmark_Run(&ringQueue, producerCounts[i], false);
+
+        printf("producers: %u\tlist: %.0f items/sec\tlist batched: %.0f items/sec\tring: %.0f items/sec (%u full ring retries)\tspeedup: %.2fx\n",
+            producerCounts[i], listResult.itemsPerSecond, listBatchResult.itemsPerSecond, ringResult.itemsPerSecond, ringResult.retries,
+            ringResult.itemsPerSecond / listResult.itemsPerSecond);
+
+        SyncQueue_Deinit(&listQueue);
+        SyncQueue_Deinit(&ringQueue);
+    }
+}
+
+END_TEST_SUITE(sync_queue_benchmark_int)
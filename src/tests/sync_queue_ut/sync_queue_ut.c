@@ -10,8 +10,11 @@
 #define ENABLE_MOCKS
 #include "azure_c_shared_utility/lock.h"
 #include "queue.h"
+#include "queue_notifier.h"
+#include "ring_queue.h"
 #undef ENABLE_MOCKS
 
+#include "memory_monitor.h"
 #include "synchronized_queue.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -28,6 +31,13 @@ bool alwaysTrueCondition(const void* data, uint32_t size, void* params) {
     return true;
 }
 
+static uint32_t mockedRingSize = 0;
+
+QueueResultValues Mocked_RingQueue_GetSize(RingQueue* queue, uint32_t* size) {
+    *size = mockedRingSize;
+    return QUEUE_OK;
+}
+
 BEGIN_TEST_SUITE(sync_queue_ut)
 
 
@@ -43,7 +53,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     umocktypes_bool_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(QueueEvictFunction, void*);
     REGISTER_UMOCK_ALIAS_TYPE(QueuePopCondition, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(QueuePriority, int);
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, int);
     REGISTER_UMOCK_ALIAS_TYPE(QueueResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
@@ -271,4 +283,290 @@ TEST_FUNCTION(SyncQueue_GetSize_UnlockFail_ExpectLockException)
     SyncQueue_Deinit(&syncQueue);
 }
 
+TEST_FUNCTION(SyncQueue_InitRing_ExpectSuccess)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&syncQueue.ring, 16, true)).SetReturn(QUEUE_OK).ValidateAllArguments();
+
+    int result = SyncQueue_InitRing(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, SYNC_QUEUE_BACKEND_RING, syncQueue.backend);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    STRICT_EXPECTED_CALL(RingQueue_Deinit(&syncQueue.ring)).ValidateAllArguments();
+    SyncQueue_Deinit(&syncQueue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_InitRing_RingInitFailed_ExpectFailure)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&syncQueue.ring, 16, true)).SetReturn(QUEUE_MEMORY_EXCEPTION).ValidateAllArguments();
+
+    int result = SyncQueue_InitRing(&syncQueue, true, 16);
+    ASSERT_ARE_NOT_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_RingBackend_ExpectNoLocking)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&syncQueue.ring, 16, true)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRing(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    void* pushedData = "abcde";
+    void* conditionParams = NULL;
+    void* data = NULL;
+    uint32_t dataSize = 0;
+    uint32_t size = 0;
+
+    STRICT_EXPECTED_CALL(RingQueue_PushBack(&syncQueue.ring, pushedData, 5)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingQueue_GetSize(&syncQueue.ring, &size)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingQueue_PopFrontIf(&syncQueue.ring, alwaysTrueCondition, &conditionParams, &data, &dataSize)).SetReturn(QUEUE_CONDITION_FAILED).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingQueue_PopFront(&syncQueue.ring, &data, &dataSize)).SetReturn(QUEUE_OK).ValidateAllArguments();
+
+    // test
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(&syncQueue, pushedData, 5));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_GetSize(&syncQueue, &size));
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, SyncQueue_PopFrontIf(&syncQueue, alwaysTrueCondition, &conditionParams, &data, &dataSize));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PopFront(&syncQueue, &data, &dataSize));
+    ASSERT_ARE_EQUAL(void_ptr, &syncQueue.ring.counter, SyncQueue_GetCounter(&syncQueue));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_PushBackWithNotifier_ExpectNotifiedOnSuccessOnly)
+{
+    SyncQueue syncQueue;
+    QueueNotifier notifier;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    SyncQueue_SetNotifier(&syncQueue, &notifier, true);
+
+    void* data = "abcde";
+    uint32_t dataSize = 5;
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_PushBack(&syncQueue.queue, data, dataSize)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(QueueNotifier_NotifyPush(&notifier, dataSize, true)).ValidateAllArguments();
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_PushBack(&syncQueue.queue, data, dataSize)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+
+    // test
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(&syncQueue, data, dataSize));
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, SyncQueue_PushBack(&syncQueue, data, dataSize));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_SetSpillLog_ExpectAttachedToListBackendOnly)
+{
+    SyncQueue syncQueue;
+    SpillLog spillLog;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_SetSpillLog(&syncQueue.queue, &spillLog)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+
+    // test
+    ASSERT_IS_TRUE(SyncQueue_SetSpillLog(&syncQueue, &spillLog));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&syncQueue);
+
+    SyncQueue ringQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&ringQueue.ring, 4, true)).SetReturn(QUEUE_OK);
+    result = SyncQueue_InitRing(&ringQueue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    ASSERT_IS_FALSE(SyncQueue_SetSpillLog(&ringQueue, &spillLog));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&ringQueue);
+}
+
+bool testEvict(void* evictParams, Queue* queue, QueuePriority priority) {
+    return false;
+}
+
+TEST_FUNCTION(SyncQueue_PushBackWithPriority_ExpectPriorityPassedUnderLock)
+{
+    SyncQueue syncQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    void* data = "abcde";
+    uint32_t dataSize = 5;
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_PushBackWithPriority(&syncQueue.queue, data, dataSize, QUEUE_PRIORITY_AGGREGATED)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+
+    // test
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBackWithPriority(&syncQueue, data, dataSize, QUEUE_PRIORITY_AGGREGATED));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_SetEvictionPolicyAndEvict_ExpectListBackendOnly)
+{
+    SyncQueue syncQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_SetEvictionPolicy(&syncQueue.queue, QUEUE_PRIORITY_LOW, testEvict, &syncQueue)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_EvictOldest(&syncQueue.queue, QUEUE_PRIORITY_LOW)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+
+    // test
+    ASSERT_IS_TRUE(SyncQueue_SetEvictionPolicy(&syncQueue, QUEUE_PRIORITY_LOW, testEvict, &syncQueue));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_EvictOldest(&syncQueue, QUEUE_PRIORITY_LOW));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&syncQueue);
+
+    SyncQueue ringQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&ringQueue.ring, 4, true)).SetReturn(QUEUE_OK);
+    result = SyncQueue_InitRing(&ringQueue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    ASSERT_IS_FALSE(SyncQueue_SetEvictionPolicy(&ringQueue, QUEUE_PRIORITY_LOW, testEvict, &ringQueue));
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, SyncQueue_EvictOldest(&ringQueue, QUEUE_PRIORITY_LOW));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&ringQueue);
+}
+
+TEST_FUNCTION(SyncQueue_SetMemoryBudget_ExpectListBackendOnly)
+{
+    SyncQueue syncQueue;
+    MemoryBudget budget;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(Queue_SetMemoryBudget(&syncQueue.queue, &budget));
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
+
+    // test
+    ASSERT_IS_TRUE(SyncQueue_SetMemoryBudget(&syncQueue, &budget));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&syncQueue);
+
+    SyncQueue ringQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&ringQueue.ring, 4, true)).SetReturn(QUEUE_OK);
+    result = SyncQueue_InitRing(&ringQueue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    ASSERT_IS_FALSE(SyncQueue_SetMemoryBudget(&ringQueue, &budget));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    SyncQueue_Deinit(&ringQueue);
+}
+
+TEST_FUNCTION(SyncQueue_GetCounter_ListBackend_ExpectQueueCounter)
+{
+    SyncQueue syncQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true));
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(void_ptr, &syncQueue.queue.counter, SyncQueue_GetCounter(&syncQueue));
+
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_PopBatchIf_ListBackend_ExpectSingleLock)
+{
+    SyncQueue syncQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true));
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    SyncQueueBatch batch;
+    void* conditionParams = NULL;
+    void* data = NULL;
+    uint32_t dataSize = 0;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Queue_PopBatchIf(&syncQueue.queue, alwaysTrueCondition, &conditionParams, 100, &batch.batch)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    // draining the batch does not touch the lock
+    STRICT_EXPECTED_CALL(Queue_BatchPopFront(&batch.batch, &data, &dataSize)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Queue_BatchPopFront(&batch.batch, &data, &dataSize)).SetReturn(QUEUE_IS_EMPTY).ValidateAllArguments();
+
+    // test
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PopBatchIf(&syncQueue, alwaysTrueCondition, &conditionParams, 100, &batch));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_BatchPopFront(&batch, &data, &dataSize));
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, SyncQueue_BatchPopFront(&batch, &data, &dataSize));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_PopBatchIf_RingBackend_ExpectBoundedBySizeAtCallTime)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingQueue_Init(&syncQueue.ring, 16, true)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRing(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    SyncQueueBatch batch;
+    void* data = NULL;
+    uint32_t dataSize = 0;
+    mockedRingSize = 2;
+    REGISTER_GLOBAL_MOCK_HOOK(RingQueue_GetSize, Mocked_RingQueue_GetSize);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(RingQueue_GetSize(&syncQueue.ring, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(RingQueue_PopFrontIf(&syncQueue.ring, IGNORED_PTR_ARG, &batch, &data, &dataSize)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingQueue_PopFrontIf(&syncQueue.ring, IGNORED_PTR_ARG, &batch, &data, &dataSize)).SetReturn(QUEUE_OK);
+
+    // test
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PopBatchIf(&syncQueue, NULL, NULL, UINT32_MAX, &batch));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_BatchPopFront(&batch, &data, &dataSize));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_BatchPopFront(&batch, &data, &dataSize));
+    // items pushed after the batch was taken belong to the next batch
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, SyncQueue_BatchPopFront(&batch, &data, &dataSize));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    REGISTER_GLOBAL_MOCK_HOOK(RingQueue_GetSize, NULL);
+    SyncQueue_Deinit(&syncQueue);
+}
+
 END_TEST_SUITE(sync_queue_ut)
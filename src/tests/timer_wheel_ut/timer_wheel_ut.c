@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "timer_wheel.h"
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_START_TICK 1000003
+#define TEST_MAX_FIRED 16
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+typedef struct _TestTimer {
+
+    TimerWheelTimer timer;
+    uint64_t firedAt[TEST_MAX_FIRED];
+    uint32_t fired;
+    // a periodic timer schedules itself again
+    uint64_t interval;
+
+} TestTimer;
+
+static TimerWheel wheel;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void OnExpired(void* context) {
+    TestTimer* testTimer = (TestTimer*)context;
+    if (testTimer->fired < TEST_MAX_FIRED) {
+        testTimer->firedAt[testTimer->fired] = wheel.now;
+    }
+    ++testTimer->fired;
+
+    if (testTimer->interval > 0) {
+        TimerWheel_Schedule(&wheel, &testTimer->timer, testTimer->timer.expiry + testTimer->interval);
+    }
+}
+
+static void InitTestTimer(TestTimer* testTimer, uint64_t interval) {
+    memset(testTimer, 0, sizeof(*testTimer));
+    testTimer->interval = interval;
+    TimerWheel_InitTimer(&testTimer->timer, OnExpired, testTimer);
+}
+
+BEGIN_TEST_SUITE(timer_wheel_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    TimerWheel_Init(&wheel, TEST_START_TICK);
+}
+
+TEST_FUNCTION(TimerWheel_AdvanceEveryTick_ExpectEachTimerExpiresOnItsTick)
+{
+    // every level of the wheel, the edges of the levels and the overflow
+    const uint64_t delays[] = { 1, 63, 64, 65, 4095, 4096, 4097, 262143, 262145, 16777215, 16777216, 16777300 };
+    const uint32_t count = sizeof(delays) / sizeof(delays[0]);
+    TestTimer timers[sizeof(delays) / sizeof(delays[0])];
+
+    for (uint32_t i = 0; i < count; ++i) {
+        InitTestTimer(&timers[i], 0);
+        TimerWheel_Schedule(&wheel, &timers[i].timer, TEST_START_TICK + delays[i]);
+        ASSERT_IS_TRUE(TimerWheel_IsScheduled(&timers[i].timer));
+    }
+    ASSERT_ARE_EQUAL(int, count, wheel.numberOfTimers);
+
+    for (uint64_t tick = TEST_START_TICK + 1; tick <= TEST_START_TICK + delays[count - 1]; ++tick) {
+        TimerWheel_Advance(&wheel, tick);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_ARE_EQUAL(int, 1, timers[i].fired);
+        ASSERT_IS_TRUE(timers[i].firedAt[0] == TEST_START_TICK + delays[i]);
+        ASSERT_IS_FALSE(TimerWheel_IsScheduled(&timers[i].timer));
+    }
+    ASSERT_ARE_EQUAL(int, 0, wheel.numberOfTimers);
+}
+
+TEST_FUNCTION(TimerWheel_AdvanceAtOnce_ExpectTimersExpireInOrder)
+{
+    TestTimer late;
+    TestTimer early;
+    InitTestTimer(&late, 0);
+    InitTestTimer(&early, 0);
+    TimerWheel_Schedule(&wheel, &late.timer, TEST_START_TICK + 5000);
+    TimerWheel_Schedule(&wheel, &early.timer, TEST_START_TICK + 70);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK + 10000);
+
+    ASSERT_ARE_EQUAL(int, 1, early.fired);
+    ASSERT_ARE_EQUAL(int, 1, late.fired);
+    ASSERT_IS_TRUE(early.firedAt[0] == TEST_START_TICK + 70);
+    ASSERT_IS_TRUE(late.firedAt[0] == TEST_START_TICK + 5000);
+    ASSERT_IS_TRUE(wheel.now == TEST_START_TICK + 10000);
+}
+
+TEST_FUNCTION(TimerWheel_ScheduleFromCallback_ExpectPeriodicExpiries)
+{
+    TestTimer periodic;
+    InitTestTimer(&periodic, 100);
+    TimerWheel_Schedule(&wheel, &periodic.timer, TEST_START_TICK + 30);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK + 330);
+
+    ASSERT_ARE_EQUAL(int, 4, periodic.fired);
+    for (uint32_t i = 0; i < periodic.fired; ++i) {
+        ASSERT_IS_TRUE(periodic.firedAt[i] == TEST_START_TICK + 30 + i * 100);
+    }
+    ASSERT_IS_TRUE(TimerWheel_IsScheduled(&periodic.timer));
+}
+
+TEST_FUNCTION(TimerWheel_Cancel_ExpectTimerNotExpired)
+{
+    TestTimer canceled;
+    TestTimer kept;
+    InitTestTimer(&canceled, 0);
+    InitTestTimer(&kept, 0);
+    TimerWheel_Schedule(&wheel, &canceled.timer, TEST_START_TICK + 10);
+    TimerWheel_Schedule(&wheel, &kept.timer, TEST_START_TICK + 10);
+
+    TimerWheel_Cancel(&wheel, &canceled.timer);
+    // a second cancel does nothing
+    TimerWheel_Cancel(&wheel, &canceled.timer);
+    ASSERT_ARE_EQUAL(int, 1, wheel.numberOfTimers);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK + 20);
+
+    ASSERT_ARE_EQUAL(int, 0, canceled.fired);
+    ASSERT_ARE_EQUAL(int, 1, kept.fired);
+}
+
+TEST_FUNCTION(TimerWheel_ScheduleScheduledTimer_ExpectTimerMoved)
+{
+    TestTimer moved;
+    InitTestTimer(&moved, 0);
+    TimerWheel_Schedule(&wheel, &moved.timer, TEST_START_TICK + 10);
+    TimerWheel_Schedule(&wheel, &moved.timer, TEST_START_TICK + 500);
+    ASSERT_ARE_EQUAL(int, 1, wheel.numberOfTimers);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK + 1000);
+
+    ASSERT_ARE_EQUAL(int, 1, moved.fired);
+    ASSERT_IS_TRUE(moved.firedAt[0] == TEST_START_TICK + 500);
+}
+
+TEST_FUNCTION(TimerWheel_SchedulePastExpiry_ExpectExpiredOnNextTick)
+{
+    TestTimer past;
+    InitTestTimer(&past, 0);
+    TimerWheel_Schedule(&wheel, &past.timer, TEST_START_TICK - 10);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK);
+    ASSERT_ARE_EQUAL(int, 0, past.fired);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK + 1);
+    ASSERT_ARE_EQUAL(int, 1, past.fired);
+}
+
+TEST_FUNCTION(TimerWheel_AdvanceBackwards_ExpectNothing)
+{
+    TestTimer timer;
+    InitTestTimer(&timer, 0);
+    TimerWheel_Schedule(&wheel, &timer.timer, TEST_START_TICK + 1);
+
+    TimerWheel_Advance(&wheel, TEST_START_TICK - 100);
+
+    ASSERT_ARE_EQUAL(int, 0, timer.fired);
+    ASSERT_IS_TRUE(wheel.now == TEST_START_TICK);
+}
+
+END_TEST_SUITE(timer_wheel_ut)
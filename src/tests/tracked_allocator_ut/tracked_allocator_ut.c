@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <malloc.h>
+#include <stdint.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+
+#define ENABLE_MOCKS
+#include "memory_monitor.h"
+#undef ENABLE_MOCKS
+
+#include "tracked_allocator.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static uint32_t mockedCurrentConsumption = 0;
+
+MemoryMonitorResultValues Mocked_MemoryMonitor_CurrentConsumption(uint32_t* sizeInBytes) {
+    *sizeInBytes = mockedCurrentConsumption;
+    return MEMORY_MONITOR_OK;
+}
+
+BEGIN_TEST_SUITE(tracked_allocator_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
+
+    REGISTER_GLOBAL_MOCK_RETURN(MemoryMonitor_Consume, MEMORY_MONITOR_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(MemoryMonitor_Release, MEMORY_MONITOR_OK);
+    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_CurrentConsumption, Mocked_MemoryMonitor_CurrentConsumption);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(TrackedAllocator_MallocBounded_ExpectUsableSizeAndHeaderCharged)
+{
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG));
+
+    void* ptr = TrackedAllocator_Malloc(ALLOCATION_TAG_BASELINE, 100);
+    ASSERT_IS_NOT_NULL(ptr);
+    uint32_t expectedSize = malloc_usable_size(ptr) + sizeof(size_t);
+    ASSERT_IS_TRUE(expectedSize >= 100 + sizeof(size_t));
+    ASSERT_ARE_EQUAL(int, expectedSize, TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(expectedSize));
+
+    TrackedAllocator_Free(ALLOCATION_TAG_BASELINE, ptr);
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(TrackedAllocator_MallocBoundedBeyondLimit_ExpectNull)
+{
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED);
+
+    ASSERT_IS_NULL(TrackedAllocator_Malloc(ALLOCATION_TAG_BASELINE, 100));
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_BASELINE));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(TrackedAllocator_MallocJson_ExpectForcedCharge)
+{
+    STRICT_EXPECTED_CALL(MemoryMonitor_ForceConsume(IGNORED_NUM_ARG));
+
+    void* ptr = TrackedAllocator_Malloc(ALLOCATION_TAG_JSON, 10);
+    ASSERT_IS_NOT_NULL(ptr);
+    ASSERT_ARE_EQUAL(int, malloc_usable_size(ptr) + sizeof(size_t), TrackedAllocator_GetUsage(ALLOCATION_TAG_JSON));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    TrackedAllocator_Free(ALLOCATION_TAG_JSON, ptr);
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_JSON));
+}
+
+TEST_FUNCTION(TrackedAllocator_DischargeMoreThanCharged_ExpectOnlyChargeReleased)
+{
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(64));
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(64));
+
+    ASSERT_IS_TRUE(TrackedAllocator_Charge(ALLOCATION_TAG_PROCESS_HASHES, 64));
+    TrackedAllocator_Discharge(ALLOCATION_TAG_PROCESS_HASHES, 100);
+    // nothing is left to release
+    TrackedAllocator_Discharge(ALLOCATION_TAG_PROCESS_HASHES, 100);
+
+    ASSERT_ARE_EQUAL(int, 0, TrackedAllocator_GetUsage(ALLOCATION_TAG_PROCESS_HASHES));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(TrackedAllocator_EstimateSize_ExpectHeaderAndAlignmentIncluded)
+{
+    ASSERT_ARE_EQUAL(int, 4 * sizeof(size_t), TrackedAllocator_EstimateSize(1));
+    ASSERT_ARE_EQUAL(int, 4 * sizeof(size_t), TrackedAllocator_EstimateSize(3 * sizeof(size_t)));
+    ASSERT_ARE_EQUAL(int, 6 * sizeof(size_t), TrackedAllocator_EstimateSize(3 * sizeof(size_t) + 1));
+}
+
+TEST_FUNCTION(TrackedAllocator_GetUntrackedConsumption_ExpectChargedTagsExcluded)
+{
+    ASSERT_IS_TRUE(TrackedAllocator_Charge(ALLOCATION_TAG_PROCESS_HASHES, 64));
+    ASSERT_IS_TRUE(TrackedAllocator_Charge(ALLOCATION_TAG_JSON, 36));
+
+    uint32_t untrackedConsumption = 0;
+    mockedCurrentConsumption = 1100;
+    ASSERT_IS_TRUE(TrackedAllocator_GetUntrackedConsumption(&untrackedConsumption));
+    ASSERT_ARE_EQUAL(int, 1000, untrackedConsumption);
+
+    // the monitor was read before a concurrent charge
+    mockedCurrentConsumption = 50;
+    ASSERT_IS_TRUE(TrackedAllocator_GetUntrackedConsumption(&untrackedConsumption));
+    ASSERT_ARE_EQUAL(int, 0, untrackedConsumption);
+
+    TrackedAllocator_Discharge(ALLOCATION_TAG_PROCESS_HASHES, 64);
+    TrackedAllocator_Discharge(ALLOCATION_TAG_JSON, 36);
+}
+
+END_TEST_SUITE(tracked_allocator_ut)
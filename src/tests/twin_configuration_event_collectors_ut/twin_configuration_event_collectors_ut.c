@@ -75,6 +75,10 @@ TwinConfigurationResult Mocked_TwinConfigurationUtils_GetConfigurationTimeValueF
         || strcmp(key, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY) == 0 )
     {
         *output = MILLISECONDS_IN_AN_HOUR;
+    } else if (strstr(key, "snapshotInterval") == key) {
+        *output = MILLISECONDS_IN_A_MINUTE;
+    } else if (strstr(key, "snapshotOffset") == key) {
+        *output = MILLISECONDS_IN_A_SECOND;
     }
     return JSON_READER_OK;
 }
@@ -140,6 +144,28 @@ static void ValidateMockedPriorities() {
     result = TwinConfigurationEventCollectors_GetAggregationInterval(EVENT_TYPE_CONNECTION_CREATE, &interval);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_AN_HOUR, interval);
+
+    TwinConfigurationSnapshotSchedule schedule;
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LISTENING_PORTS, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_MINUTE, schedule.interval);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_SECOND, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_FIREWALL_CONFIGURATION, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_MINUTE, schedule.interval);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_SECOND, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_BASELINE, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_MINUTE, schedule.interval);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_SECOND, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LOCAL_USERS, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_MINUTE, schedule.interval);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_SECOND, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_SYSTEM_INFORMATION, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_MINUTE, schedule.interval);
+    ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_A_SECOND, schedule.offset);
 }
 
 static void ValidateDefaultPriorities() {
@@ -199,6 +225,28 @@ static void ValidateDefaultPriorities() {
     result = TwinConfigurationEventCollectors_GetAggregationInterval(EVENT_TYPE_CONNECTION_CREATE, &interval);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_AN_HOUR, interval);
+
+    TwinConfigurationSnapshotSchedule schedule;
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LISTENING_PORTS, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, schedule.interval);
+    ASSERT_ARE_EQUAL(int, 0, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_FIREWALL_CONFIGURATION, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, schedule.interval);
+    ASSERT_ARE_EQUAL(int, 0, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_BASELINE, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, schedule.interval);
+    ASSERT_ARE_EQUAL(int, 0, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_LOCAL_USERS, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, schedule.interval);
+    ASSERT_ARE_EQUAL(int, 0, schedule.offset);
+    result = TwinConfigurationEventCollectors_GetSnapshotSchedule(EVENT_TYPE_SYSTEM_INFORMATION, &schedule);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, schedule.interval);
+    ASSERT_ARE_EQUAL(int, 0, schedule.offset);
 }
 
 static LOCK_HANDLE testLockHadnle = (LOCK_HANDLE)0x1;
@@ -306,6 +354,16 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_ExpectSuccess)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
     result = TwinConfigurationEventCollectors_Update(readerHandle);
@@ -337,6 +395,16 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_KeyMissing_ExpectSuccess)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
@@ -391,6 +459,26 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_GetPrioritiesJsonExpectSuccess){
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, true));
     STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_AN_HOUR, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_MINUTE, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_SECOND, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_MINUTE, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_SECOND, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_MINUTE, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, BASELINE_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_SECOND, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, BASELINE_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_MINUTE, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_SECOND, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_MINUTE, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_A_SECOND, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
     
@@ -460,6 +548,16 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_SetBackToDeafultValues_Exp
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
     result = TwinConfigurationEventCollectors_Update(readerHandle);
@@ -484,6 +582,16 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_SetBackToDeafultValues_Exp
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
     
@@ -517,6 +625,16 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_MalformedJson_ConfigStayIn
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LISTENING_PORTS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, FIREWALL_CONFIGURATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, BASELINE_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, LOCAL_USERS_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, SYSTEM_INFORMATION_SNAPSHOT_OFFSET_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
     result = TwinConfigurationEventCollectors_Update(readerHandle);
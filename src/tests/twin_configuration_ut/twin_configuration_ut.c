@@ -110,6 +110,18 @@ static void ValidateDefaultTwinConfigurationParameters() {
     result = TwinConfiguration_GetBaselineCustomChecksFileHash(&str);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH, str);
+
+    result = TwinConfiguration_GetMessageCompressionEnabled(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_MESSAGE_COMPRESSION_ENABLED, boolean);
+
+    result = TwinConfiguration_GetColumnarMessagesEnabled(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_COLUMNAR_MESSAGES_ENABLED, boolean);
+
+    result = TwinConfiguration_GetMaxInFlightMessages(&num);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_MAX_IN_FLIGHT_MESSAGES, num);
 }
 
 /**
@@ -128,6 +140,9 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     const bool mockBaselineCustomChecksEnabled = true;
     const char* mockBaselineCustomChecksFilePath = "/file/path";
     const char* mockBaselineCustomChecksFileHash = "#filehash!";
+    const bool mockMessageCompressionEnabled = true;
+    const bool mockColumnarMessagesEnabled = true;
+    const uint32_t mockMaxInFlightMessages = 8;
 
     TwinConfigurationResult result, expectedResult = TWIN_OK;
 
@@ -148,6 +163,9 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockBaselineCustomChecksEnabled, sizeof(mockBaselineCustomChecksEnabled));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockBaselineCustomChecksFilePath, sizeof(mockBaselineCustomChecksFilePath));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockBaselineCustomChecksFileHash, sizeof(mockBaselineCustomChecksFileHash));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, MESSAGE_COMPRESSION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockMessageCompressionEnabled, sizeof(mockMessageCompressionEnabled));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, COLUMNAR_MESSAGES_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockColumnarMessagesEnabled, sizeof(mockColumnarMessagesEnabled));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(mockedReader, MAX_IN_FLIGHT_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockMaxInFlightMessages, sizeof(mockMaxInFlightMessages));
 
     STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_Update(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
@@ -208,6 +226,21 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     result = TwinConfiguration_GetBaselineCustomChecksFileHash(&baseLineCustomChecksFileHash);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, mockBaselineCustomChecksFileHash, baseLineCustomChecksFileHash);
+
+    bool messageCompressionEnabled;
+    result = TwinConfiguration_GetMessageCompressionEnabled(&messageCompressionEnabled);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockMessageCompressionEnabled, messageCompressionEnabled);
+
+    bool columnarMessagesEnabled;
+    result = TwinConfiguration_GetColumnarMessagesEnabled(&columnarMessagesEnabled);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockColumnarMessagesEnabled, columnarMessagesEnabled);
+
+    uint32_t maxInFlightMessages;
+    result = TwinConfiguration_GetMaxInFlightMessages(&maxInFlightMessages);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockMaxInFlightMessages, maxInFlightMessages);
 }
 
 BEGIN_TEST_SUITE(twin_configuration_ut)
@@ -336,6 +369,9 @@ TEST_FUNCTION(TwinConfiguration_AllJsonKeysMissing_ExpectDefaultValuesFallback)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, MESSAGE_COMPRESSION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, COLUMNAR_MESSAGES_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(mockedReader, MAX_IN_FLIGHT_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_Update(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(0);
@@ -438,6 +474,39 @@ TEST_FUNCTION(TwinConfiguration_GetBaselineCustomChecksFileHashWithLockError_Exp
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(TwinConfiguration_GetMessageCompressionEnabledWithLockError_ExpectLockException)
+{
+    bool boolean;
+    int result;
+
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_ERROR).IgnoreAllArguments();
+    result = TwinConfiguration_GetMessageCompressionEnabled(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_LOCK_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(TwinConfiguration_GetColumnarMessagesEnabledWithLockError_ExpectLockException)
+{
+    bool boolean;
+    int result;
+
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_ERROR).IgnoreAllArguments();
+    result = TwinConfiguration_GetColumnarMessagesEnabled(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_LOCK_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(TwinConfiguration_GetMaxInFlightMessagesWithLockError_ExpectLockException)
+{
+    unsigned int num;
+    int result;
+
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_ERROR).IgnoreAllArguments();
+    result = TwinConfiguration_GetMaxInFlightMessages(&num);
+    ASSERT_ARE_EQUAL(int, TWIN_LOCK_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 TEST_FUNCTION(TwinConfiguration_UpdateWithLockError_ExpectLockException)
 {
     unsigned int num;
@@ -455,6 +524,9 @@ TEST_FUNCTION(TwinConfiguration_UpdateWithLockError_ExpectLockException)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, MESSAGE_COMPRESSION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, COLUMNAR_MESSAGES_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(mockedReader, MAX_IN_FLIGHT_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_ERROR).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(0);
     STRICT_EXPECTED_CALL(JsonObjectReader_Deinit(mockedReader));
@@ -485,6 +557,9 @@ TEST_FUNCTION(TwinConfiguration_GetLastTwinUpdateData_ExpectSuccess){
     ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.baselineCustomChecksEnabled);
     ASSERT_ARE_EQUAL(char_ptr, CONFIGURATION_OK, result.configurationBundleStatus.baselineCustomChecksFilePath);
     ASSERT_ARE_EQUAL(char_ptr, CONFIGURATION_OK, result.configurationBundleStatus.baselineCustomChecksFileHash);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.messageCompressionEnabled);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.columnarMessagesEnabled);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.maxInFlightMessages);
 }
 
 TEST_FUNCTION(TwinConfiguration_GetSerializedTwinConfiguration_ExpectSuccess) {
@@ -506,6 +581,9 @@ TEST_FUNCTION(TwinConfiguration_GetSerializedTwinConfiguration_ExpectSuccess) {
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, MESSAGE_COMPRESSION_ENABLED_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, COLUMNAR_MESSAGES_ENABLED_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteUintConfigurationToJson(IGNORED_PTR_ARG, MAX_IN_FLIGHT_MESSAGES_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPrioritiesJson(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, &out, &outSize));
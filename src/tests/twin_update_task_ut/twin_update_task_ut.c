@@ -9,6 +9,7 @@
 #include "umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
+#include "memory_monitor.h"
 #include "synchronized_queue.h"
 #include "twin_configuration.h"
 #include "iothub_adapter.h"
@@ -51,6 +52,13 @@ int Mocked_SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataS
     return mockedSyncQueuePopFrontReturnValue;
 }
 
+static const uint32_t MOCKED_MAX_LOCAL_CACHE_SIZE = 4096;
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetMaxLocalCacheSize(uint32_t* maxLocalCacheSize) {
+    *maxLocalCacheSize = MOCKED_MAX_LOCAL_CACHE_SIZE;
+    return TWIN_OK;
+}
+
 BEGIN_TEST_SUITE(twin_update_task_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -71,6 +79,7 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, Mocked_SyncQueue_GetSize);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, Mocked_SyncQueue_PopFront);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxLocalCacheSize, Mocked_TwinConfiguration_GetMaxLocalCacheSize);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -81,6 +90,7 @@ TEST_SUITE_CLEANUP(suite_cleanup)
 
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxLocalCacheSize, NULL);
 }
 
 TEST_FUNCTION_INITIALIZE(method_init)
@@ -131,6 +141,8 @@ TEST_FUNCTION(UpdateTwinTask_Execute_ExpectSuccess)
     STRICT_EXPECTED_CALL(SyncQueue_PopFront(&queue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     mockedSyncQueuePopFrontTwinState = TWIN_COMPLETE;
     STRICT_EXPECTED_CALL(TwinConfiguration_Update(DUMMY_JSON, true));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_SetLimit(MOCKED_MAX_LOCAL_CACHE_SIZE));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSerializedTwinConfiguration(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(IoTHubAdapter_SetReportedPropertiesAsync(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
 
@@ -156,6 +168,8 @@ TEST_FUNCTION(UpdateTwinTask_ExecutePartialTwin_ExpectSuccess)
     STRICT_EXPECTED_CALL(SyncQueue_PopFront(&queue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     mockedSyncQueuePopFrontTwinState = TWIN_PARTIAL;
     STRICT_EXPECTED_CALL(TwinConfiguration_Update(DUMMY_JSON, false));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_SetLimit(MOCKED_MAX_LOCAL_CACHE_SIZE));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSerializedTwinConfiguration(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(IoTHubAdapter_SetReportedPropertiesAsync(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
 
@@ -226,6 +240,32 @@ TEST_FUNCTION(UpdateTwinTask_ExecuteUpdateTwinFailed_ExpectFailure)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(UpdateTwinTask_ExecuteParseFailed_ExpectLimitPublished)
+{
+    UpdateTwinTask task;
+    SyncQueue queue;
+    IoTHubAdapter client;
+
+    bool result = UpdateTwinTask_Init(&task, &queue, &client);
+    ASSERT_IS_TRUE(result);
+
+    mockedSyncQueueGetSizeSize = 1;
+    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&queue, IGNORED_PTR_ARG));
+    mockedSyncQueuePopFrontReturnValue = QUEUE_OK;
+    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&queue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    mockedSyncQueuePopFrontTwinState = TWIN_COMPLETE;
+    STRICT_EXPECTED_CALL(TwinConfiguration_Update(DUMMY_JSON, true)).SetReturn(TWIN_PARSE_EXCEPTION);
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_SetLimit(MOCKED_MAX_LOCAL_CACHE_SIZE));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetSerializedTwinConfiguration(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SetReportedPropertiesAsync(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+
+    UpdateTwinTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 TEST_FUNCTION(UpdateTwinTask_InitUpdateTwinTaskItem_ExpectSuccess)
 {
     UpdateTwinTaskItem* twinTaskItem;
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "worker_pool.h"
+#include <stdint.h>
+#include <time.h>
+
+#define TEST_WAIT_ATTEMPTS 1000
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static WorkerPool pool;
+static volatile uint32_t runningJobs = 0;
+static volatile uint32_t finishedJobs = 0;
+static volatile uint32_t releaseJobs = 0;
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void Sleep1Millisecond() {
+    struct timespec duration = { 0, 1000000 };
+    nanosleep(&duration, NULL);
+}
+
+static bool WaitFor(volatile uint32_t* counter, uint32_t expected) {
+    for (int i = 0; i < TEST_WAIT_ATTEMPTS; ++i) {
+        if (__sync_fetch_and_add(counter, 0) >= expected) {
+            return true;
+        }
+        Sleep1Millisecond();
+    }
+    return false;
+}
+
+static void BlockingJob(void* context) {
+    __sync_fetch_and_add(&runningJobs, 1);
+    while (!__sync_fetch_and_add(&releaseJobs, 0)) {
+        Sleep1Millisecond();
+    }
+    __sync_fetch_and_add(&finishedJobs, 1);
+}
+
+BEGIN_TEST_SUITE(worker_pool_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    runningJobs = 0;
+    finishedJobs = 0;
+    releaseJobs = 0;
+}
+
+TEST_FUNCTION(WorkerPool_SubmitJobs_ExpectAllJobsRunInParallel)
+{
+    ASSERT_IS_TRUE(WorkerPool_Init(&pool, 2));
+    WorkerPoolJob first;
+    WorkerPoolJob second;
+    WorkerPool_InitJob(&first, BlockingJob, NULL);
+    WorkerPool_InitJob(&second, BlockingJob, NULL);
+
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_OK, WorkerPool_Submit(&pool, &first));
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_OK, WorkerPool_Submit(&pool, &second));
+
+    // both jobs block, so they only both run if they run on different threads
+    ASSERT_IS_TRUE(WaitFor(&runningJobs, 2));
+    releaseJobs = 1;
+    ASSERT_IS_TRUE(WaitFor(&finishedJobs, 2));
+
+    WorkerPool_Deinit(&pool);
+}
+
+TEST_FUNCTION(WorkerPool_SubmitBusyJob_ExpectJobBusyUntilItFinishes)
+{
+    ASSERT_IS_TRUE(WorkerPool_Init(&pool, 2));
+    WorkerPoolJob job;
+    WorkerPool_InitJob(&job, BlockingJob, NULL);
+
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_OK, WorkerPool_Submit(&pool, &job));
+    ASSERT_IS_TRUE(WaitFor(&runningJobs, 1));
+
+    // the second thread is idle, still the job does not run twice
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_JOB_BUSY, WorkerPool_Submit(&pool, &job));
+
+    releaseJobs = 1;
+    ASSERT_IS_TRUE(WaitFor(&finishedJobs, 1));
+    WorkerPool_Deinit(&pool);
+
+    ASSERT_ARE_EQUAL(int, 1, runningJobs);
+    ASSERT_IS_FALSE(job.busy);
+}
+
+TEST_FUNCTION(WorkerPool_DeinitWithQueuedJob_ExpectQueuedJobDropped)
+{
+    ASSERT_IS_TRUE(WorkerPool_Init(&pool, 1));
+    WorkerPoolJob running;
+    WorkerPoolJob queued;
+    WorkerPool_InitJob(&running, BlockingJob, NULL);
+    WorkerPool_InitJob(&queued, BlockingJob, NULL);
+
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_OK, WorkerPool_Submit(&pool, &running));
+    ASSERT_IS_TRUE(WaitFor(&runningJobs, 1));
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_OK, WorkerPool_Submit(&pool, &queued));
+
+    // the deinit waits for the running job
+    releaseJobs = 1;
+    WorkerPool_Deinit(&pool);
+
+    ASSERT_IS_TRUE(finishedJobs <= 2);
+    ASSERT_IS_FALSE(running.busy);
+    ASSERT_IS_FALSE(queued.busy);
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_EXCEPTION, WorkerPool_Submit(&pool, &queued));
+}
+
+TEST_FUNCTION(WorkerPool_InitInvalidNumberOfThreads_ExpectFailure)
+{
+    ASSERT_IS_FALSE(WorkerPool_Init(&pool, 0));
+    ASSERT_IS_FALSE(WorkerPool_Init(&pool, WORKER_POOL_MAX_THREADS + 1));
+}
+
+END_TEST_SUITE(worker_pool_ut)